@@ -0,0 +1,378 @@
+/*
+ * alloc_trace_bench.c - Replay recorded NetHack allocation traces
+ *
+ * Standalone benchmark (not part of the dylib). Reads a trace written by
+ * nh_alloc_trace.c (NETHACK_ALLOC_TRACE=<path> or
+ * nethack_alloc_trace_begin()) and replays it against each allocator:
+ *
+ *   static  - nethack_memory_final.c (the shipping heap)
+ *   fixed   - fixed_memory.c (the backend of nethack_zone_fixed.c)
+ *   zone    - a malloc zone, as nethack_zone.c uses (Apple only; the
+ *             file's own pointer tracking is not included)
+ *   malloc  - system malloc, as a reference
+ *
+ * Each allocator replays the trace twice: once untimed for throughput,
+ * once with a clock read around every call for the latency histogram.
+ * Footprint is sampled every 256 ops (bytes the allocator holds: the bump
+ * top for the fixed-region heaps, in-use arena bytes for malloc), and
+ * fragmentation is 1 - live request bytes / footprint at the peak.
+ *
+ * Build & run (from repo root):
+ *   cc -O2 -Izone_allocator bench/alloc_trace_bench.c \
+ *      zone_allocator/nethack_memory_final.c zone_allocator/nh_image_codec.c \
+ *      zone_allocator/fixed_memory.c zone_allocator/nh_io_stats.c \
+ *      -o /tmp/alloc_trace_bench \
+ *      && /tmp/alloc_trace_bench game.trace [static fixed zone malloc]
+ *
+ * The allocators log to stderr on restart; run with 2>/dev/null for a
+ * clean table.
+ */
+
+#include "nethack_memory_final.h"
+#include "fixed_memory.h"
+#include "nh_alloc_stats.h"
+#include "nh_alloc_trace.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+#define SAMPLE_INTERVAL 256
+
+/* === Allocators === */
+
+typedef struct {
+    const char *name;
+    int (*init)(void);
+    void (*reset)(void);
+    void *(*alloc)(size_t);
+    void *(*realloc)(void *, size_t);
+    void (*free)(void *);
+    size_t (*footprint)(void);
+} Allocator;
+
+static int static_init(void) { nh_restart(); return 0; }
+static size_t static_footprint(void) {
+    NhAllocStats stats;
+    nh_memory_get_stats(&stats);
+    return stats.used_bytes;
+}
+
+static int fixed_init(void) {
+    static int initialized = 0;
+    if (!initialized && fixed_memory_init() != 0) return -1;
+    initialized = 1;
+    fixed_memory_restart();
+    return 0;
+}
+static size_t fixed_footprint(void) {
+    size_t used = 0;
+    fixed_memory_stats(&used, NULL);
+    return used;
+}
+
+static int malloc_init(void) { return 0; }
+static void malloc_reset(void) {}
+static size_t malloc_footprint(void) {
+#ifdef __APPLE__
+    malloc_statistics_t st;
+    malloc_zone_statistics(malloc_default_zone(), &st);
+    return st.size_in_use;
+#else
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#endif
+}
+
+#ifdef __APPLE__
+static malloc_zone_t *bench_zone = NULL;
+static int zone_init(void) {
+    if (bench_zone) malloc_destroy_zone(bench_zone);
+    bench_zone = malloc_create_zone(0, 0);
+    return bench_zone ? 0 : -1;
+}
+static void zone_reset(void) {}
+static void *zone_alloc(size_t n) { return malloc_zone_malloc(bench_zone, n); }
+static void *zone_realloc(void *p, size_t n) { return malloc_zone_realloc(bench_zone, p, n); }
+static void zone_free(void *p) { malloc_zone_free(bench_zone, p); }
+static size_t zone_footprint(void) {
+    malloc_statistics_t st;
+    malloc_zone_statistics(bench_zone, &st);
+    return st.size_in_use;
+}
+#endif
+
+static const Allocator allocators[] = {
+    {"static", static_init, nh_restart, nh_malloc, nh_realloc, nh_free, static_footprint},
+    {"fixed", fixed_init, fixed_memory_restart, fixed_alloc, fixed_realloc, fixed_free, fixed_footprint},
+#ifdef __APPLE__
+    {"zone", zone_init, zone_reset, zone_alloc, zone_realloc, zone_free, zone_footprint},
+#endif
+    {"malloc", malloc_init, malloc_reset, malloc, realloc, free, malloc_footprint},
+};
+#define ALLOCATOR_COUNT (sizeof(allocators) / sizeof(allocators[0]))
+
+/* === Recorded pointer -> replay pointer (open addressing, backward-shift delete) === */
+
+typedef struct {
+    uint64_t key;  /* Recorded pointer, 0 = empty */
+    void *ptr;
+    size_t size;
+} PtrSlot;
+
+static PtrSlot *slots = NULL;
+static size_t slot_mask = 0;
+static size_t slot_count = 0;
+
+static size_t slot_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key & slot_mask;
+}
+
+static void map_clear(size_t capacity) {
+    free(slots);
+    slots = calloc(capacity, sizeof(PtrSlot));
+    slot_mask = capacity - 1;
+    slot_count = 0;
+}
+
+static void map_put(uint64_t key, void *ptr, size_t size);
+
+static void map_grow(void) {
+    PtrSlot *old = slots;
+    size_t old_capacity = slot_mask + 1;
+    slots = calloc(old_capacity * 2, sizeof(PtrSlot));
+    slot_mask = old_capacity * 2 - 1;
+    slot_count = 0;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].key) map_put(old[i].key, old[i].ptr, old[i].size);
+    }
+    free(old);
+}
+
+static void map_put(uint64_t key, void *ptr, size_t size) {
+    if ((slot_count + 1) * 10 > (slot_mask + 1) * 7) map_grow();
+    size_t i = slot_hash(key);
+    while (slots[i].key && slots[i].key != key) i = (i + 1) & slot_mask;
+    if (!slots[i].key) slot_count++;
+    slots[i] = (PtrSlot){key, ptr, size};
+}
+
+/* Remove key; returns its slot contents (ptr NULL if absent) */
+static PtrSlot map_take(uint64_t key) {
+    PtrSlot found = {0, NULL, 0};
+    size_t i = slot_hash(key);
+    while (slots[i].key && slots[i].key != key) i = (i + 1) & slot_mask;
+    if (!slots[i].key) return found;
+    found = slots[i];
+
+    size_t hole = i;
+    for (size_t j = (i + 1) & slot_mask; slots[j].key; j = (j + 1) & slot_mask) {
+        size_t home = slot_hash(slots[j].key);
+        if (((j - home) & slot_mask) >= ((j - hole) & slot_mask)) {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole].key = 0;
+    slot_count--;
+    return found;
+}
+
+/* === Latency histogram (ns, 8 sub-buckets per power of two) === */
+
+#define LAT_SUB 8
+#define LAT_BUCKETS (40 * LAT_SUB)
+
+static uint64_t lat_buckets[LAT_BUCKETS];
+
+static unsigned lat_index(uint64_t ns) {
+    if (ns < LAT_SUB) return (unsigned)ns;
+    unsigned msb = 63 - (unsigned)__builtin_clzll(ns);
+    unsigned idx = (msb - 2) * LAT_SUB + (unsigned)((ns >> (msb - 3)) & (LAT_SUB - 1));
+    return idx < LAT_BUCKETS ? idx : LAT_BUCKETS - 1;
+}
+
+static uint64_t lat_ceil(unsigned idx) {
+    if (idx < LAT_SUB) return idx;
+    unsigned msb = idx / LAT_SUB + 2;
+    return ((uint64_t)(LAT_SUB + idx % LAT_SUB + 1) << (msb - 3)) - 1;
+}
+
+static uint64_t lat_percentile(uint64_t total, unsigned pct) {
+    uint64_t rank = (total * pct + 99) / 100, seen = 0;
+    for (unsigned i = 0; i < LAT_BUCKETS; i++) {
+        seen += lat_buckets[i];
+        if (seen >= rank && seen) return lat_ceil(i);
+    }
+    return 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* === Replay === */
+
+typedef struct {
+    uint64_t ops;
+    uint64_t failed;       /* Allocation returned NULL: replay stopped */
+    uint64_t unmatched;    /* Free/realloc of a pointer the trace never allocated */
+    uint64_t elapsed_ns;
+    size_t peak_footprint;
+    size_t live_at_peak;
+    size_t end_footprint;
+    size_t end_live;
+} ReplayResult;
+
+static void replay(const Allocator *a, const NhAllocTraceRecord *recs, size_t count,
+                   int timed, ReplayResult *out) {
+    memset(out, 0, sizeof(*out));
+    map_clear(1 << 16);
+    size_t live = 0;
+    uint64_t start = now_ns();
+
+    for (size_t n = 0; n < count; n++) {
+        const NhAllocTraceRecord *r = &recs[n];
+        uint64_t t0 = timed ? now_ns() : 0;
+        void *p = NULL;
+
+        switch (r->op) {
+        case NH_TRACE_ALLOC:
+            p = a->alloc(r->size);
+            if (!p) { out->failed++; goto done; }
+            *(volatile char *)p = 1;  /* Touch like the caller would */
+            map_put(r->ptr, p, r->size);
+            live += r->size;
+            break;
+        case NH_TRACE_REALLOC: {
+            PtrSlot old = map_take(r->old_ptr);
+            if (!old.ptr) out->unmatched++;
+            p = a->realloc(old.ptr, r->size);
+            if (!p) { out->failed++; goto done; }
+            map_put(r->ptr, p, r->size);
+            live += r->size - old.size;
+            break;
+        }
+        case NH_TRACE_FREE: {
+            PtrSlot old = map_take(r->ptr);
+            if (!old.ptr) { out->unmatched++; break; }
+            a->free(old.ptr);
+            live -= old.size;
+            break;
+        }
+        default:
+            continue;  /* Phase markers */
+        }
+
+        if (timed) lat_buckets[lat_index(now_ns() - t0)]++;
+        out->ops++;
+        if ((n & (SAMPLE_INTERVAL - 1)) == 0) {
+            size_t fp = a->footprint();
+            if (fp > out->peak_footprint) {
+                out->peak_footprint = fp;
+                out->live_at_peak = live;
+            }
+        }
+    }
+
+done:
+    out->elapsed_ns = now_ns() - start;
+    out->end_footprint = a->footprint();
+    out->end_live = live;
+
+    /* Return what is still live, then drop the allocator's state */
+    for (size_t i = 0; i <= slot_mask; i++) {
+        if (slots[i].key) a->free(slots[i].ptr);
+    }
+    a->reset();
+}
+
+static double frag(size_t live, size_t footprint) {
+    return footprint ? 1.0 - (double)live / (double)footprint : 0.0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s trace [static fixed zone malloc]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(NhAllocTraceHeader)) {
+        fprintf(stderr, "cannot open trace %s\n", argv[1]);
+        return 1;
+    }
+    const uint8_t *file = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (file == MAP_FAILED) {
+        fprintf(stderr, "cannot map trace %s\n", argv[1]);
+        return 1;
+    }
+    const NhAllocTraceHeader *header = (const NhAllocTraceHeader *)file;
+    if (strcmp(header->magic, NH_ALLOC_TRACE_MAGIC) != 0 ||
+        header->version != NH_ALLOC_TRACE_VERSION ||
+        header->record_size != sizeof(NhAllocTraceRecord)) {
+        fprintf(stderr, "%s is not a version %d allocation trace\n", argv[1], NH_ALLOC_TRACE_VERSION);
+        return 1;
+    }
+    const NhAllocTraceRecord *recs = (const NhAllocTraceRecord *)(file + sizeof(*header));
+    size_t count = ((size_t)st.st_size - sizeof(*header)) / sizeof(NhAllocTraceRecord);
+
+    uint64_t by_op[5] = {0};
+    for (size_t i = 0; i < count; i++) {
+        if (recs[i].op < 5) by_op[recs[i].op]++;
+    }
+    printf("trace: %zu records over %.1f s (alloc %llu, realloc %llu, free %llu, phase %llu)\n\n",
+           count, count ? recs[count - 1].time_ns / 1e9 : 0.0,
+           (unsigned long long)by_op[NH_TRACE_ALLOC], (unsigned long long)by_op[NH_TRACE_REALLOC],
+           (unsigned long long)by_op[NH_TRACE_FREE], (unsigned long long)by_op[NH_TRACE_PHASE]);
+
+    printf("%-8s %8s %9s %7s %7s %8s %10s %6s %10s %6s\n", "alloc", "Mops/s", "ops",
+           "p50 ns", "p99 ns", "max ns", "peak KB", "frag", "end KB", "frag");
+
+    for (size_t k = 0; k < ALLOCATOR_COUNT; k++) {
+        const Allocator *a = &allocators[k];
+        int wanted = argc == 2;
+        for (int i = 2; i < argc; i++) wanted |= strcmp(argv[i], a->name) == 0;
+        if (!wanted) continue;
+        if (a->init() != 0) {
+            printf("%-8s (unavailable)\n", a->name);
+            continue;
+        }
+
+        ReplayResult fast, timed;
+        replay(a, recs, count, 0, &fast);
+        memset(lat_buckets, 0, sizeof(lat_buckets));
+        replay(a, recs, count, 1, &timed);
+
+        uint64_t max_ns = 0;
+        for (unsigned i = 0; i < LAT_BUCKETS; i++) {
+            if (lat_buckets[i]) max_ns = lat_ceil(i);
+        }
+        printf("%-8s %8.1f %9llu %7llu %7llu %8llu %10zu %5.1f%% %10zu %5.1f%%\n", a->name,
+               fast.elapsed_ns ? fast.ops * 1e3 / (double)fast.elapsed_ns : 0.0,
+               (unsigned long long)fast.ops,
+               (unsigned long long)lat_percentile(timed.ops, 50),
+               (unsigned long long)lat_percentile(timed.ops, 99), (unsigned long long)max_ns,
+               fast.peak_footprint / 1024, 100.0 * frag(fast.live_at_peak, fast.peak_footprint),
+               fast.end_footprint / 1024, 100.0 * frag(fast.end_live, fast.end_footprint));
+        if (fast.failed) printf("         out of memory after %llu ops\n", (unsigned long long)fast.ops);
+        if (fast.unmatched) printf("         %llu frees of untraced pointers\n", (unsigned long long)fast.unmatched);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * bench_harness.c - Shared scaffolding for the dylib host drivers
+ *
+ * See bench_harness.h.
+ */
+
+#include "bench_harness.h"
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef void (*VoidFn)(void);
+typedef void (*IntArgFn)(int);
+typedef void (*StringArgFn)(const char *);
+
+static const char *harness_name = "bench";
+
+void *bench_resolve(void *lib, const char *name) {
+    void *sym = dlsym(lib, name);
+    if (!sym) {
+        fprintf(stderr, "%s: missing symbol %s\n", harness_name, name);
+        exit(1);
+    }
+    return sym;
+}
+
+static int copy_file(const char *src, const char *dst) {
+    int in = open(src, O_RDONLY);
+    if (in < 0) return -1;
+    int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        close(in);
+        return -1;
+    }
+    char buffer[16384];
+    ssize_t n;
+    int failed = 0;
+    while ((n = read(in, buffer, sizeof(buffer))) > 0) {
+        if (write(out, buffer, (size_t)n) != n) {
+            failed = 1;
+            break;
+        }
+    }
+    close(in);
+    close(out);
+    return failed || n < 0 ? -1 : 0;
+}
+
+// Lua scripts into <home>/Documents/NetHack/Data (dlb_fopen strategy 1)
+static int stage_lua(const char *lua_dir, const char *home) {
+    char data_dir[1024];
+    snprintf(data_dir, sizeof(data_dir), "%s/Documents", home);
+    mkdir(data_dir, 0755);
+    snprintf(data_dir, sizeof(data_dir), "%s/Documents/NetHack", home);
+    mkdir(data_dir, 0755);
+    snprintf(data_dir, sizeof(data_dir), "%s/Documents/NetHack/Data", home);
+    mkdir(data_dir, 0755);
+
+    DIR *dir = opendir(lua_dir);
+    if (!dir) return -1;
+    int copied = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 5 || strcmp(entry->d_name + len - 4, ".lua") != 0) continue;
+        char src[1024], dst[1024];
+        snprintf(src, sizeof(src), "%s/%s", lua_dir, entry->d_name);
+        snprintf(dst, sizeof(dst), "%s/%s", data_dir, entry->d_name);
+        if (copy_file(src, dst) == 0) copied++;
+    }
+    closedir(dir);
+    return copied > 0 ? 0 : -1;
+}
+
+void *bench_harness_open(const char *name, const char *dylib, const char *lua_dir,
+                         char *home, size_t home_size) {
+    harness_name = name;
+
+    // Fresh HOME: the dylib's standalone documents path is $HOME/Documents/NetHack
+    int len = snprintf(home, home_size, "/tmp/nh_%s.XXXXXX", name);
+    if (len < 0 || (size_t)len >= home_size) {
+        fprintf(stderr, "%s: HOME path too long\n", name);
+        return NULL;
+    }
+    if (!mkdtemp(home) || setenv("HOME", home, 1) != 0) {
+        fprintf(stderr, "%s: mkdtemp: ", name);
+        perror(NULL);
+        return NULL;
+    }
+    if (stage_lua(lua_dir, home) != 0) {
+        fprintf(stderr, "%s: no Lua scripts in %s\n", name, lua_dir);
+        return NULL;
+    }
+
+    void *lib = dlopen(dylib, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        fprintf(stderr, "%s: %s\n", name, dlerror());
+        return NULL;
+    }
+    return lib;
+}
+
+void bench_start_game(void *lib, const char *player) {
+    ((VoidFn)bench_resolve(lib, "ios_full_dylib_init"))();
+    ((VoidFn)bench_resolve(lib, "nethack_real_init"))();
+    ((StringArgFn)bench_resolve(lib, "nethack_set_player_name"))(player);
+    ((IntArgFn)bench_resolve(lib, "nethack_set_role"))(11);  // Valkyrie
+    ((VoidFn)bench_resolve(lib, "ios_enable_wizard_mode"))();
+    ((VoidFn)bench_resolve(lib, "ios_swift_ready_for_new_game"))();
+    ((VoidFn)bench_resolve(lib, "nethack_start_new_game"))();
+}
@@ -0,0 +1,31 @@
+/*
+ * bench_harness.h - Shared scaffolding for the dylib host drivers
+ *
+ * save_bench.c and bridge_bench.c load the macOS build of the dylib in a
+ * throwaway HOME and start a wizard-mode Valkyrie. This is that part:
+ * the HOME, the Lua scripts copied into Documents/NetHack/Data (there is
+ * no app bundle to provision from), dlopen, symbol lookup and the new
+ * game sequence. Compiled into each driver, not part of the dylib.
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stddef.h>
+
+#define BENCH_DEFAULT_LUA_DIR "swift/lua_resources"
+
+// Make a fresh HOME /tmp/nh_<name>.XXXXXX, copy the .lua files of lua_dir
+// into it and dlopen dylib. name also prefixes every error the harness
+// prints. home receives the HOME path.
+// Returns the library handle, or NULL after printing why.
+void *bench_harness_open(const char *name, const char *dylib, const char *lua_dir,
+                         char *home, size_t home_size);
+
+// dlsym that exits the process when the symbol is missing
+void *bench_resolve(void *lib, const char *name);
+
+// Init the dylib and start a new wizard-mode Valkyrie called player
+void bench_start_game(void *lib, const char *player);
+
+#endif // BENCH_HARNESS_H
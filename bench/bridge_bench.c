@@ -0,0 +1,484 @@
+/*
+ * bridge_bench.c - Bridge call and end-to-end turn latency (host driver)
+ *
+ * Standalone driver (not part of the dylib). Loads the macOS build of the
+ * dylib in a throwaway HOME, runs a wizard-mode Valkyrie on a game thread
+ * of its own and stands in for Swift: the event bus callback drains the
+ * render queue on the main queue, the way the map view does.
+ *
+ * Output is JSON Lines on stdout, after one "meta" object:
+ *
+ *   bridge_call   hot calls Swift makes while the game thread is parked at
+ *                 a command prompt: ios_get_game_state_snapshot,
+ *                 nethack_get_inventory_items, ios_get_objects_at and
+ *                 nethack_examine_tile on the hero's square (examine is
+ *                 served by the lookat cache after the first call, as in
+ *                 the UI), nethack_examine_tile_uncached (the 3x3 around
+ *                 the hero with the cache cleared before every call, the
+ *                 cost of a first look), the JSON getters,
+ *                 nethack_get_message_history;
+ *                 and render queue enqueue/dequeue and a full-map glyph
+ *                 batch on a private queue built from src/ios_render_queue.c
+ *                 (timed in blocks of QUEUE_BLOCK ops, reported per op)
+ *     fields: name, iterations, ns {min, median, p90, p99, max, mean}
+ *
+ *   turn_latency  scripted sessions. Each command is queued and timed to
+ *                 the first event batch that reports a later turn
+ *                 (input_to_batch_ns) and to the render queue being
+ *                 drained after that batch (input_to_drained_ns)
+ *     fields: session, commands, completed, timeouts, turns,
+ *             elements_per_command, input_to_batch_ns, input_to_drained_ns
+ *
+ * Sessions: search ("s"), walk ("l" and "h" in turn) and search20 ("20s",
+ * one input, up to twenty turns). A command without a turn batch inside
+ * BENCH_TURN_TIMEOUT_MS (a move into a wall, a prompt) is a timeout and is
+ * followed by ESC.
+ *
+ * Build & run (macOS, from repo root, after ./build_nethack_macos.sh):
+ *   cc -O2 -pthread -Isrc bench/bridge_bench.c bench/bench_harness.c \
+ *      src/ios_render_queue.c src/ios_log.c -o /tmp/bridge_bench \
+ *      && /tmp/bridge_bench build-macos/libnethack.dylib [iterations] \
+ *         [commands] [lua_dir] 2>/dev/null > bridge_bench.jsonl
+ *
+ * lua_dir (default swift/lua_resources) is copied into the game's
+ * Documents/NetHack/Data, since there is no app bundle to provision from.
+ * The dylib logs heavily to stderr; redirect it for clean output.
+ */
+
+#include <stdint.h>
+#include "RealNetHackBridge.h"
+#include "ios_game_state_buffer.h"
+#include "bench_harness.h"
+#include <dispatch/dispatch.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_ITERATIONS 1000
+#define BENCH_DEFAULT_COMMANDS 200
+#define BENCH_WARMUP 16
+#define BENCH_READY_TIMEOUT_MS 30000
+#define BENCH_TURN_TIMEOUT_MS 1000
+#define QUEUE_BLOCK 256
+#define DRAIN_CHUNK 256
+
+typedef void (*VoidFn)(void);
+typedef void (*BoolArgFn)(bool);
+typedef void (*StringArgFn)(const char *);
+typedef const char *(*StringFn)(void);
+typedef void (*SnapshotFn)(GameStateSnapshot *);
+typedef int (*InventoryFn)(InventoryItem *, int);
+typedef int (*ObjectsAtFn)(int, int, IOSObjectInfo *, int);
+typedef const char *(*ExamineFn)(int, int);
+typedef void (*RegisterFn)(IOSEventBatchCallback);
+typedef RenderQueue *(*QueueFn)(void);
+typedef uint32_t (*DequeueBulkFn)(RenderQueue *, RenderQueueElement *, uint32_t);
+typedef uint32_t (*ReadBatchFn)(RenderQueue *, const GlyphBatchUpdate *, MapUpdate *, uint32_t);
+typedef bool (*ReadStatusFn)(RenderQueue *, const StatusRef *, StatusUpdate *);
+typedef uint32_t (*ReadMessageFn)(RenderQueue *, const MessageUpdate *, char *, uint32_t);
+
+/* Dylib entry points */
+static SnapshotFn get_snapshot;
+static InventoryFn get_inventory;
+static ObjectsAtFn get_objects_at;
+static ExamineFn examine_tile;
+static StringFn get_player_stats_json;
+static StringFn get_character_status_json;
+static StringFn get_message_history;
+static VoidFn lookat_cache_clear;
+static StringArgFn send_input;
+static QueueFn get_render_queue;
+static DequeueBulkFn dequeue_bulk;
+static ReadBatchFn read_glyph_batch;
+static ReadStatusFn read_status;
+static ReadMessageFn read_message;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* === Summaries === */
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Sorts samples in place
+static void print_summary(const char *key, uint64_t *samples, size_t n) {
+    if (n == 0) {
+        printf("\"%s\":null", key);
+        return;
+    }
+    qsort(samples, n, sizeof(uint64_t), compare_u64);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += samples[i];
+    printf("\"%s\":{\"min\":%llu,\"median\":%llu,\"p90\":%llu,\"p99\":%llu,\"max\":%llu,\"mean\":%llu}",
+           key, (unsigned long long)samples[0], (unsigned long long)samples[n / 2],
+           (unsigned long long)samples[(n * 90) / 100], (unsigned long long)samples[(n * 99) / 100],
+           (unsigned long long)samples[n - 1], (unsigned long long)(sum / n));
+}
+
+static void print_call(const char *name, uint64_t *samples, size_t n) {
+    printf("{\"bench\":\"bridge_call\",\"name\":\"%s\",\"iterations\":%zu,", name, n);
+    print_summary("ns", samples, n);
+    printf("}\n");
+    fflush(stdout);
+}
+
+/* === Event bus stand-in (main queue) === */
+
+static pthread_mutex_t bus_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bus_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t drained_elements;       /* Under bus_mutex, with the fields below; running total */
+static bool game_ready;
+
+/* The first TURN_COMPLETE batch past watch_turn, however many batches the
+ * driver sleeps through (a later batch must not hide it) */
+static int64_t watch_turn = INT64_MAX;
+static bool turn_seen;
+static int64_t turn_seen_turn;
+static uint64_t turn_delivered_ns;
+static uint64_t turn_drained_ns;
+static uint64_t turn_elements;          /* drained_elements after that batch */
+
+static RenderQueueElement drain_buffer[DRAIN_CHUNK];
+static MapUpdate drain_deltas[RENDER_GLYPH_BATCH_MAX];
+
+// Empty the render queue the way the Swift consumer does: payload lanes in queue order
+static uint32_t drain_render_queue(void) {
+    RenderQueue *queue = get_render_queue();
+    if (!queue) return 0;
+
+    uint32_t total = 0, n;
+    while ((n = dequeue_bulk(queue, drain_buffer, DRAIN_CHUNK)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            RenderQueueElement *elem = &drain_buffer[i];
+            if (elem->type == UPDATE_GLYPH_BATCH) {
+                read_glyph_batch(queue, &elem->data.glyph_batch, drain_deltas, RENDER_GLYPH_BATCH_MAX);
+            } else if (elem->type == UPDATE_STATUS) {
+                StatusUpdate status;
+                read_status(queue, &elem->data.status, &status);
+            } else if (elem->type == UPDATE_MESSAGE) {
+                char text[RENDER_MESSAGE_TEXT_MAX + 1];
+                read_message(queue, &elem->data.message, text, sizeof(text));
+            }
+        }
+        total += n;
+    }
+    return total;
+}
+
+static void on_batch(const IOSEventBatch *batch) {
+    uint64_t delivered = now_ns();
+    uint32_t elements = drain_render_queue();
+    uint64_t drained = now_ns();
+
+    pthread_mutex_lock(&bus_mutex);
+    drained_elements += elements;
+    if (!turn_seen && (batch->events & IOS_EVENT_TURN_COMPLETE) && batch->turn > watch_turn) {
+        turn_seen = true;
+        turn_seen_turn = batch->turn;
+        turn_delivered_ns = delivered;
+        turn_drained_ns = drained;
+        turn_elements = drained_elements;
+    }
+    if (batch->events & IOS_EVENT_GAME_READY) game_ready = true;
+    pthread_cond_broadcast(&bus_cond);
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+// Caller holds bus_mutex. False once the deadline has passed.
+static bool wait_until(uint64_t deadline_ns) {
+    uint64_t now = now_ns();
+    if (now >= deadline_ns) return false;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t wake = (uint64_t)tv.tv_sec * 1000000000ull + (uint64_t)tv.tv_usec * 1000ull
+                  + (deadline_ns - now);
+    struct timespec ts = { (time_t)(wake / 1000000000ull), (long)(wake % 1000000000ull) };
+    pthread_cond_timedwait(&bus_cond, &bus_mutex, &ts);
+    return true;
+}
+
+/* === Bridge calls === */
+
+static GameStateSnapshot snapshot;
+static InventoryItem inventory[64];
+static IOSObjectInfo objects[32];
+static int hero_x, hero_y;              /* NetHack coordinates */
+
+static void call_snapshot(void) { get_snapshot(&snapshot); }
+static void call_inventory(void) { get_inventory(inventory, 64); }
+static void call_objects_at(void) { get_objects_at(hero_x, hero_y, objects, 32); }
+static void call_examine(void) { examine_tile(hero_x - 1, hero_y); }  /* Swift coordinates */
+static void call_player_stats_json(void) { get_player_stats_json(); }
+static void call_character_status_json(void) { get_character_status_json(); }
+static void call_message_history(void) { get_message_history(); }
+
+static const struct {
+    const char *name;
+    VoidFn call;
+} bridge_calls[] = {
+    { "ios_get_game_state_snapshot", call_snapshot },
+    { "nethack_get_inventory_items", call_inventory },
+    { "ios_get_objects_at", call_objects_at },
+    { "nethack_examine_tile", call_examine },
+    { "nethack_get_player_stats_json", call_player_stats_json },
+    { "ios_get_character_status_json", call_character_status_json },
+    { "nethack_get_message_history", call_message_history },
+};
+
+static void bench_bridge_calls(int iterations) {
+    uint64_t *samples = malloc((size_t)iterations * sizeof(uint64_t));
+    if (!samples) return;
+
+    get_snapshot(&snapshot);
+    hero_x = snapshot.player_x;
+    hero_y = snapshot.player_y;
+
+    for (size_t c = 0; c < sizeof(bridge_calls) / sizeof(bridge_calls[0]); c++) {
+        for (int i = 0; i < BENCH_WARMUP; i++) bridge_calls[c].call();
+        for (int i = 0; i < iterations; i++) {
+            uint64_t start = now_ns();
+            bridge_calls[c].call();
+            samples[i] = now_ns() - start;
+        }
+        print_call(bridge_calls[c].name, samples, (size_t)iterations);
+    }
+
+    // Every call a miss: the clear is a generation bump, outside the timing
+    for (int i = 0; i < iterations; i++) {
+        int dx = i % 3 - 1, dy = (i / 3) % 3 - 1;
+        lookat_cache_clear();
+        uint64_t start = now_ns();
+        examine_tile(hero_x - 1 + dx, hero_y + dy);  /* Swift coordinates */
+        samples[i] = now_ns() - start;
+    }
+    print_call("nethack_examine_tile_uncached", samples, (size_t)iterations);
+    free(samples);
+}
+
+/* === Render queue (private instance, this file's copy of the queue code) === */
+
+static RenderQueue bench_queue;
+static MapUpdate batch_deltas[RENDER_GLYPH_BATCH_MAX];
+
+static void bench_render_queue(int iterations) {
+    uint64_t *enqueue_ns = malloc((size_t)iterations * sizeof(uint64_t));
+    uint64_t *dequeue_ns = malloc((size_t)iterations * sizeof(uint64_t));
+    uint64_t *batch_ns = malloc((size_t)iterations * sizeof(uint64_t));
+    if (!enqueue_ns || !dequeue_ns || !batch_ns) {
+        free(enqueue_ns);
+        free(dequeue_ns);
+        free(batch_ns);
+        return;
+    }
+
+    render_queue_init(&bench_queue);
+    RenderQueueElement elem = { .type = CMD_TURN_COMPLETE };
+    RenderQueueElement out;
+    for (int i = 0; i < iterations; i++) {
+        uint64_t start = now_ns();
+        for (int k = 0; k < QUEUE_BLOCK; k++) render_queue_enqueue(&bench_queue, &elem);
+        uint64_t mid = now_ns();
+        for (int k = 0; k < QUEUE_BLOCK; k++) render_queue_dequeue(&bench_queue, &out);
+        uint64_t end = now_ns();
+        enqueue_ns[i] = (mid - start) / QUEUE_BLOCK;
+        dequeue_ns[i] = (end - mid) / QUEUE_BLOCK;
+    }
+
+    // What print_glyph coalescing produces after a full redraw
+    for (uint32_t i = 0; i < RENDER_GLYPH_BATCH_MAX; i++) {
+        batch_deltas[i] = (MapUpdate){ .x = (coordxy)(i % 80), .y = (coordxy)(i / 80),
+                                       .glyph = (int)i, .ch = '.', .color = 7 };
+    }
+    for (int i = 0; i < iterations; i++) {
+        uint64_t start = now_ns();
+        render_queue_enqueue_glyph_batch(&bench_queue, batch_deltas, RENDER_GLYPH_BATCH_MAX, (uint32_t)i);
+        render_queue_dequeue(&bench_queue, &out);
+        render_queue_read_glyph_batch(&bench_queue, &out.data.glyph_batch, drain_deltas,
+                                      RENDER_GLYPH_BATCH_MAX);
+        batch_ns[i] = now_ns() - start;
+    }
+    render_queue_destroy(&bench_queue);
+
+    print_call("render_queue_enqueue", enqueue_ns, (size_t)iterations);
+    print_call("render_queue_dequeue", dequeue_ns, (size_t)iterations);
+    print_call("render_queue_glyph_batch_full_map", batch_ns, (size_t)iterations);
+    free(enqueue_ns);
+    free(dequeue_ns);
+    free(batch_ns);
+}
+
+/* === Scripted sessions === */
+
+static const struct {
+    const char *name;
+    const char *keys[2];                /* Sent in turn */
+} sessions[] = {
+    { "search", { "s", "s" } },
+    { "walk", { "l", "h" } },
+    { "search20", { "20s", "20s" } },
+};
+
+static void run_session(int s, int commands) {
+    uint64_t *to_batch = malloc((size_t)commands * sizeof(uint64_t));
+    uint64_t *to_drained = malloc((size_t)commands * sizeof(uint64_t));
+    if (!to_batch || !to_drained) {
+        free(to_batch);
+        free(to_drained);
+        return;
+    }
+
+    size_t completed = 0;
+    int timeouts = 0;
+    int64_t turns = 0;
+    uint64_t elements = 0;
+
+    for (int i = 0; i < commands; i++) {
+        get_snapshot(&snapshot);
+        int64_t before = snapshot.turn_number;
+
+        pthread_mutex_lock(&bus_mutex);
+        uint64_t elements_before = drained_elements;
+        watch_turn = before;
+        turn_seen = false;
+        pthread_mutex_unlock(&bus_mutex);
+
+        uint64_t start = now_ns();
+        send_input(sessions[s].keys[i & 1]);
+        uint64_t deadline = start + BENCH_TURN_TIMEOUT_MS * 1000000ull;
+
+        pthread_mutex_lock(&bus_mutex);
+        while (!turn_seen && wait_until(deadline)) {
+        }
+        bool done = turn_seen;
+        if (done) {
+            to_batch[completed] = turn_delivered_ns - start;
+            to_drained[completed] = turn_drained_ns - start;
+            completed++;
+            turns += turn_seen_turn - before;
+            elements += turn_elements - elements_before;
+        }
+        watch_turn = INT64_MAX;
+        pthread_mutex_unlock(&bus_mutex);
+
+        if (!done) {
+            timeouts++;
+            send_input("\033");  // Whatever took the keys (a prompt) gets dismissed
+            usleep(50000);
+        }
+    }
+
+    printf("{\"bench\":\"turn_latency\",\"session\":\"%s\",\"commands\":%d,\"completed\":%zu,"
+           "\"timeouts\":%d,\"turns\":%lld,\"elements_per_command\":%.1f,",
+           sessions[s].name, commands, completed, timeouts, (long long)turns,
+           completed ? (double)elements / (double)completed : 0.0);
+    print_summary("input_to_batch_ns", to_batch, completed);
+    printf(",");
+    print_summary("input_to_drained_ns", to_drained, completed);
+    printf("}\n");
+    fflush(stdout);
+    free(to_batch);
+    free(to_drained);
+}
+
+/* === Driver === */
+
+static int bench_iterations;
+static int bench_commands;
+
+static void *game_thread(void *arg) {
+    ((VoidFn)arg)();
+    fprintf(stderr, "bridge_bench: game thread returned\n");
+    return NULL;
+}
+
+static void *driver_thread(void *arg) {
+    (void)arg;
+
+    // The first command prompt sends GAME_READY
+    pthread_mutex_lock(&bus_mutex);
+    uint64_t deadline = now_ns() + BENCH_READY_TIMEOUT_MS * 1000000ull;
+    while (!game_ready && wait_until(deadline)) {
+    }
+    bool ready = game_ready;
+    pthread_mutex_unlock(&bus_mutex);
+    if (!ready) {
+        fprintf(stderr, "bridge_bench: game never reached a command prompt\n");
+        exit(1);
+    }
+
+    bench_bridge_calls(bench_iterations);
+    bench_render_queue(bench_iterations);
+    for (size_t s = 0; s < sizeof(sessions) / sizeof(sessions[0]); s++) {
+        fprintf(stderr, "bridge_bench: session %s, %d commands\n", sessions[s].name, bench_commands);
+        run_session((int)s, bench_commands);
+    }
+    exit(0);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <libnethack.dylib> [iterations] [commands] [lua_dir]\n", argv[0]);
+        return 2;
+    }
+    bench_iterations = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_ITERATIONS;
+    bench_commands = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_COMMANDS;
+    const char *lua_dir = argc > 4 ? argv[4] : BENCH_DEFAULT_LUA_DIR;
+    if (bench_iterations <= 0 || bench_commands <= 0) {
+        fprintf(stderr, "bridge_bench: iterations and commands must be positive\n");
+        return 2;
+    }
+
+    char home[64];
+    void *lib = bench_harness_open("bridge_bench", argv[1], lua_dir, home, sizeof(home));
+    if (!lib) return 1;
+
+    get_snapshot = (SnapshotFn)bench_resolve(lib, "ios_get_game_state_snapshot");
+    get_inventory = (InventoryFn)bench_resolve(lib, "nethack_get_inventory_items");
+    get_objects_at = (ObjectsAtFn)bench_resolve(lib, "ios_get_objects_at");
+    examine_tile = (ExamineFn)bench_resolve(lib, "nethack_examine_tile");
+    get_player_stats_json = (StringFn)bench_resolve(lib, "nethack_get_player_stats_json");
+    get_character_status_json = (StringFn)bench_resolve(lib, "ios_get_character_status_json");
+    get_message_history = (StringFn)bench_resolve(lib, "nethack_get_message_history");
+    lookat_cache_clear = (VoidFn)bench_resolve(lib, "ios_lookat_cache_clear");
+    send_input = (StringArgFn)bench_resolve(lib, "nethack_send_input_threaded");
+    get_render_queue = (QueueFn)bench_resolve(lib, "ios_get_render_queue");
+    dequeue_bulk = (DequeueBulkFn)bench_resolve(lib, "render_queue_dequeue_bulk");
+    read_glyph_batch = (ReadBatchFn)bench_resolve(lib, "render_queue_read_glyph_batch");
+    read_status = (ReadStatusFn)bench_resolve(lib, "render_queue_read_status");
+    read_message = (ReadMessageFn)bench_resolve(lib, "render_queue_read_message");
+
+    ((RegisterFn)bench_resolve(lib, "ios_event_bus_register"))(on_batch);
+    ((BoolArgFn)bench_resolve(lib, "ios_event_bus_hold_messages"))(false);
+
+    bench_start_game(lib, "BridgeBench");  // "Die?" is answered by the ESC after a timeout
+
+    printf("{\"bench\":\"meta\",\"dylib\":\"%s\",\"iterations\":%d,\"commands\":%d,"
+           "\"turn_timeout_ms\":%d}\n", argv[1], bench_iterations, bench_commands,
+           BENCH_TURN_TIMEOUT_MS);
+    fflush(stdout);
+
+    // moveloop needs more stack than a default secondary thread gets
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, 16u * 1024u * 1024u);
+    pthread_t game, driver;
+    if (pthread_create(&game, &attr, game_thread, bench_resolve(lib, "nethack_run_game_threaded")) != 0
+        || pthread_create(&driver, NULL, driver_thread, NULL) != 0) {
+        perror("bridge_bench: pthread_create");
+        return 1;
+    }
+    pthread_attr_destroy(&attr);
+
+    // Event batches arrive on the main queue; the driver thread exits the process
+    dispatch_main();
+}
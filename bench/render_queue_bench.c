@@ -0,0 +1,243 @@
+/*
+ * render_queue_bench.c - RenderQueue enqueue/dequeue throughput
+ *
+ * Standalone microbenchmark (not part of the dylib). One producer thread
+ * pushes glyph updates, one consumer thread drains them, and we report
+ * millions of updates per second for:
+ *
+ *   legacy  - the original layout: head/tail on one cache line, element
+ *             sized by the StatusUpdate union member, acquire load of the
+ *             remote index on every call, single-element dequeue
+ *   single  - current RenderQueue, render_queue_dequeue()
+ *   bulk    - current RenderQueue, render_queue_dequeue_bulk()
+ *   batch   - current RenderQueue, full-map UPDATE_GLYPH_BATCH from the
+ *             delta lane (what print_glyph coalescing actually produces)
+ *
+ * Build & run (from repo root):
+ *   cc -O2 -pthread -Isrc bench/render_queue_bench.c src/ios_render_queue.c \
+ *      src/ios_log.c -o /tmp/render_queue_bench && /tmp/render_queue_bench [updates]
+ *
+ * The producer enqueues in bursts and waits for room between bursts, so
+ * neither queue hits its full path (which logs) during the measurement.
+ * Both sides yield when they cannot make progress; the cache-line effects
+ * only show with the threads on separate cores.
+ */
+
+#include "ios_render_queue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BURST 1024
+#define BENCH_DEFAULT_UPDATES (20u * 1000u * 1000u)
+
+/* === Legacy layout (baseline ios_render_queue.h) === */
+
+typedef struct {
+    RenderUpdateType type;
+    union {
+        MapUpdate map;
+        MessageUpdate message;
+        StatusUpdate status;
+        RenderCommand command;
+    } data;
+} LegacyElement;
+
+typedef struct {
+    atomic_uint_fast32_t head;
+    atomic_uint_fast32_t tail;
+    LegacyElement elements[RENDER_QUEUE_SIZE];
+} LegacyQueue;
+
+static bool legacy_enqueue(LegacyQueue *q, const LegacyElement *elem) {
+    uint32_t head = (uint32_t)atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t next = (head + 1) & QUEUE_MASK;
+    if (next == atomic_load_explicit(&q->tail, memory_order_acquire)) {
+        return false;
+    }
+    q->elements[head] = *elem;
+    atomic_store_explicit(&q->head, next, memory_order_release);
+    return true;
+}
+
+static bool legacy_dequeue(LegacyQueue *q, LegacyElement *elem) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&q->head, memory_order_acquire)) {
+        return false;
+    }
+    *elem = q->elements[tail];
+    atomic_store_explicit(&q->tail, (tail + 1) & QUEUE_MASK, memory_order_release);
+    return true;
+}
+
+static uint32_t legacy_count(LegacyQueue *q) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&q->tail, memory_order_acquire);
+    uint32_t head = (uint32_t)atomic_load_explicit(&q->head, memory_order_relaxed);
+    return (head - tail) & QUEUE_MASK;
+}
+
+/* === Harness === */
+
+typedef enum { MODE_LEGACY, MODE_SINGLE, MODE_BULK, MODE_BATCH } BenchMode;
+
+typedef struct {
+    BenchMode mode;
+    uint32_t updates;
+    LegacyQueue *legacy;
+    RenderQueue *queue;
+    uint64_t checksum;
+} BenchRun;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static MapUpdate make_update(uint32_t i) {
+    MapUpdate m = {.x = (coordxy)(1 + i % 79), .y = (coordxy)(i % 21),
+                   .glyph = (int)i, .ch = '.', .color = 7, .glyphflags = 0};
+    return m;
+}
+
+static void *producer(void *arg) {
+    BenchRun *run = arg;
+    uint32_t sent = 0;
+
+    if (run->mode == MODE_BATCH) {
+        static MapUpdate staging[RENDER_GLYPH_BATCH_MAX];
+        while (sent < run->updates) {
+            uint32_t n = run->updates - sent;
+            if (n > RENDER_GLYPH_BATCH_MAX) n = RENDER_GLYPH_BATCH_MAX;
+            for (uint32_t i = 0; i < n; i++) staging[i] = make_update(sent + i);
+            while (!render_queue_enqueue_glyph_batch(run->queue, staging, n, sent)) {
+                sched_yield();  /* Delta lane full - consumer catches up */
+            }
+            sent += n;
+        }
+        return NULL;
+    }
+
+    while (sent < run->updates) {
+        /* Wait for room for a whole burst (one remote read per burst) */
+        if (run->mode == MODE_LEGACY) {
+            while (legacy_count(run->legacy) > RENDER_QUEUE_SIZE - 1 - BENCH_BURST) sched_yield();
+        } else {
+            while (render_queue_count(run->queue) > RENDER_QUEUE_SIZE - 1 - BENCH_BURST) sched_yield();
+        }
+
+        uint32_t n = run->updates - sent;
+        if (n > BENCH_BURST) n = BENCH_BURST;
+        for (uint32_t i = 0; i < n; i++) {
+            if (run->mode == MODE_LEGACY) {
+                LegacyElement e = {.type = UPDATE_GLYPH, .data.map = make_update(sent + i)};
+                legacy_enqueue(run->legacy, &e);
+            } else {
+                RenderQueueElement e = {.type = UPDATE_GLYPH, .data.map = make_update(sent + i)};
+                render_queue_enqueue(run->queue, &e);
+            }
+        }
+        sent += n;
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    BenchRun *run = arg;
+    uint32_t received = 0;
+    uint64_t sum = 0;
+    static RenderQueueElement bulk[512];
+    static MapUpdate deltas[RENDER_GLYPH_BATCH_MAX];
+
+    while (received < run->updates) {
+        uint32_t before = received;
+        switch (run->mode) {
+        case MODE_LEGACY: {
+            LegacyElement e;
+            if (legacy_dequeue(run->legacy, &e)) {
+                sum += (uint32_t)e.data.map.glyph;
+                received++;
+            }
+            break;
+        }
+        case MODE_SINGLE: {
+            RenderQueueElement e;
+            if (render_queue_dequeue(run->queue, &e)) {
+                sum += (uint32_t)e.data.map.glyph;
+                received++;
+            }
+            break;
+        }
+        case MODE_BULK: {
+            uint32_t n = render_queue_dequeue_bulk(run->queue, bulk, 512);
+            for (uint32_t i = 0; i < n; i++) sum += (uint32_t)bulk[i].data.map.glyph;
+            received += n;
+            break;
+        }
+        case MODE_BATCH: {
+            uint32_t n = render_queue_dequeue_bulk(run->queue, bulk, 512);
+            for (uint32_t i = 0; i < n; i++) {
+                uint32_t d = render_queue_read_glyph_batch(run->queue, &bulk[i].data.glyph_batch,
+                                                           deltas, RENDER_GLYPH_BATCH_MAX);
+                for (uint32_t j = 0; j < d; j++) sum += (uint32_t)deltas[j].glyph;
+                received += d;
+            }
+            break;
+        }
+        }
+        if (received == before) sched_yield();  /* Empty - let the producer run */
+    }
+    run->checksum = sum;
+    return NULL;
+}
+
+static double bench(BenchMode mode, uint32_t updates, LegacyQueue *legacy, RenderQueue *queue) {
+    BenchRun run = {.mode = mode, .updates = updates, .legacy = legacy, .queue = queue};
+    pthread_t prod, cons;
+
+    if (legacy) {
+        atomic_init(&legacy->head, 0);
+        atomic_init(&legacy->tail, 0);
+    }
+    if (queue) {
+        render_queue_init(queue);
+    }
+
+    double start = now_sec();
+    pthread_create(&cons, NULL, consumer, &run);
+    pthread_create(&prod, NULL, producer, &run);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    double elapsed = now_sec() - start;
+
+    /* sum of 0..updates-1 */
+    uint64_t expect = (uint64_t)updates * (updates - 1) / 2;
+    if (run.checksum != expect) {
+        fprintf(stderr, "checksum mismatch: got %llu want %llu\n",
+                (unsigned long long)run.checksum, (unsigned long long)expect);
+        exit(1);
+    }
+    return updates / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    uint32_t updates = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_UPDATES;
+
+    /* Static storage keeps the lane indices cache-line aligned */
+    static LegacyQueue legacy;
+    static RenderQueue queue;
+
+    /* Queue init logs to stderr; keep results on stdout */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    printf("element size: legacy %zu bytes, current %zu bytes\n",
+           sizeof(LegacyElement), sizeof(RenderQueueElement));
+    printf("updates: %u\n", updates);
+    printf("legacy  %8.1f M updates/s\n", bench(MODE_LEGACY, updates, &legacy, NULL));
+    printf("single  %8.1f M updates/s\n", bench(MODE_SINGLE, updates, NULL, &queue));
+    printf("bulk    %8.1f M updates/s\n", bench(MODE_BULK, updates, NULL, &queue));
+    printf("batch   %8.1f M updates/s\n", bench(MODE_BATCH, updates, NULL, &queue));
+    return 0;
+}
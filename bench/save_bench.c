@@ -0,0 +1,57 @@
+/*
+ * save_bench.c - Save/restore benchmark on fixture games (host driver)
+ *
+ * Standalone driver (not part of the dylib). Loads the macOS build of the
+ * dylib in a throwaway HOME, starts a wizard-mode Valkyrie, and runs
+ * ios_save_bench_run() (src/ios_save_bench.c) for the early, mid and
+ * gehennom fixtures in that order, so each one grows the same game.
+ *
+ * Output is JSON Lines on stdout, one object per fixture and op:
+ *   fixture, op, levels, iterations, failures,
+ *   wall_ns {first, min, median, max, mean}, serialize_ns_median,
+ *   bytes_written, writes, fsyncs (per iteration), savegame_bytes
+ *
+ * Build & run (macOS, from repo root, after ./build_nethack_macos.sh):
+ *   cc -O2 bench/save_bench.c bench/bench_harness.c -o /tmp/save_bench \
+ *      && /tmp/save_bench build-macos/libnethack.dylib [iterations] \
+ *         [lua_dir] 2>/dev/null > save_bench.jsonl
+ *
+ * lua_dir (default swift/lua_resources) is copied into the fixture's
+ * Documents/NetHack/Data, since there is no app bundle to provision from.
+ * The dylib logs heavily to stderr; redirect it for clean output.
+ */
+
+#include "bench_harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DEFAULT_ITERATIONS 5
+
+typedef int (*BenchRunFn)(const char *, int, const char *);
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <libnethack.dylib> [iterations] [lua_dir]\n", argv[0]);
+        return 2;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_ITERATIONS;
+    const char *lua_dir = argc > 3 ? argv[3] : BENCH_DEFAULT_LUA_DIR;
+
+    char home[64];
+    void *lib = bench_harness_open("save_bench", argv[1], lua_dir, home, sizeof(home));
+    if (!lib) return 1;
+    bench_start_game(lib, "SaveBench");
+
+    BenchRunFn run = (BenchRunFn)bench_resolve(lib, "ios_save_bench_run");
+    static const char *const fixtures[] = { "early", "mid", "gehennom" };
+    int result = 0;
+    for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+        fprintf(stderr, "save_bench: fixture %s, %d iterations\n", fixtures[i], iterations);
+        if (run(fixtures[i], iterations, NULL) != 0) result = 1;
+        fflush(stdout);
+    }
+
+    // The fixture stays behind for inspection
+    fprintf(stderr, "save_bench: fixture game in %s\n", home);
+    return result;
+}
@@ -63,6 +63,11 @@ if [ "${NH_STRUCTURED_LOGGING:-0}" = "1" ]; then
 else
     echo "📝 Structured logging disabled (set NH_STRUCTURED_LOGGING=1 to enable)"
 fi
+# Ring log compile threshold (0=TRACE .. 5=OFF; default WARN, DEBUG with -DDEBUG)
+if [ -n "${NH_LOG_LEVEL:-}" ]; then
+    echo "🪵 Log compile level: $NH_LOG_LEVEL (NH_LOG_LEVEL)"
+    CFLAGS="$CFLAGS -DIOS_LOG_COMPILE_LEVEL=$NH_LOG_LEVEL"
+fi
 CFLAGS="$CFLAGS -fPIC"  # Position-independent code for shared library
 CFLAGS="$CFLAGS -fvisibility=hidden"  # Hide all symbols by default
 CFLAGS="$CFLAGS -c"
@@ -156,7 +161,11 @@ SOURCES=(
     "$ORIGIN_DIR/src/rnd.c"
     "$ORIGIN_DIR/src/hacklib.c"
     "zone_allocator/nethack_memory_final.c"
+    "zone_allocator/nethack_heap_snapshot.c"
+    "zone_allocator/nh_image_codec.c"
     "zone_allocator/nethack_static_alloc.c"
+    "zone_allocator/nh_alloc_trace.c"
+    "zone_allocator/nh_io_stats.c"
 
     # Character
     "$ORIGIN_DIR/src/role.c"
@@ -320,16 +329,47 @@ SOURCES=(
     "src/ios_object_bridge.c"      # Object/inventory bridge
     "src/ios_container_bridge.c"   # Floor container operations bridge
     "src/ios_game_state_buffer.c"  # Lock-free game state push buffer (Push Model)
+    "src/ios_read_model.c"         # Versioned inventory/status/floor read model
+    "src/ios_inventory_cache.c"    # Inventory export cache (records + name pool)
+    "src/ios_object_fingerprint.c" # Object name fingerprint for text caches
+    "src/ios_status_block.c"       # Binary HUD status export (change counter)
     "src/ios_render_queue.c"       # Render queue for display updates
+    "src/ios_input_ring.c"         # Lock-free key ring from Swift to the game thread
+    "src/ios_coroutine.c"          # Stack switching for the stepped game loop
+    "src/ios_game_step.c"          # moveloop as a resumable step (no blocked thread)
+    "src/ios_headless.c"           # Headless mode: no rendering or pacing
+    "src/ios_travel_steps.c"       # Hero path ring for display-paced travel
+    "src/ios_object_index.c"       # o_id hash + per-tile floor object summary
+    "src/ios_kill_stats.c"         # Incremental kill/discovery statistics
+    "src/ios_dungeon_overview.c"   # Visited-level overview model
+    "src/ios_bridge_api.c"         # Function pointer table bound once by the Swift bridge
+    "src/ios_lookat_cache.c"       # Cached tile inspection (farlook) results
+    "src/ios_travel_field.c"       # BFS distance field for travel previews
+    "src/ios_input_journal.c"      # Input recording and replay
+    "src/ios_event_bus.c"          # Coalesced game-to-UI events per turn
+    "src/ios_memory_pressure.c"    # Tiered purge on memory warnings
+    "src/ios_hibernate.c"          # Hibernation image, instant resume
+    "src/ios_lua_pool.c"           # Size-class pool for the Lua states
+    "src/ios_log.c"                # Leveled logging ring (flushed on crash / demand)
+    "src/ios_frame_timing.c"       # Per-stage turn latency histograms
+    "src/ios_transient_pool.c"     # Slab pool for bridge result buffers
+    "src/ios_level_store.c"        # Content-addressed level chunks for saves
+    "src/ios_file_copy.c"          # clonefile() copies for backups and slots
+    "src/ios_save_index.c"         # Character/slot index for the load screen
+    "src/ios_save_manifest.c"      # Write-ahead manifest for save commits
+    "src/ios_lua_archive.c"        # mmapped Lua bytecode archive
+    "src/ios_lua_state.c"          # Warm Lua states and chunk registry
     "src/ios_restore.c"            # Restore/load game functions
     "src/action_registry.c"        # Action registry
     "src/action_system.c"          # Action system
+    "src/ios_action_macro.c"       # Multi-step action macros
     "src/ios_dungeon.c"            # iOS dungeon.lua support
     "src/ios_save_integration.c"   # Save/load integration (REQUIRED for Swift)
     "src/ios_slot_manager.c"       # Save slot management (REQUIRED for Swift)
     "src/ios_character_save.c"     # Character save/load (REQUIRED for Swift)
     "src/ios_character_status.c"   # Character status bridge (Equipment, Identity, Conditions)
     "src/ios_msg_history.c"        # Message history buffer
+    "src/ios_message_log.c"        # Message log store with sequence ids
     "src/ios_nhlua_patch.c"        # Lua patches for iOS
     "src/ios_memory_integration.c" # Memory system integration
     "src/ios_event_driven.c"       # Event-driven architecture
@@ -343,6 +383,21 @@ SOURCES=(
 echo "Applying iOS patches..."
 PATCH_DIR="$SCRIPT_DIR/patches"
 
+# Patches the port cannot run without: already applied (the reverse dry run
+# succeeds) or applied cleanly now. Anything else stops the build.
+apply_required_patch() {
+    local patch_file="$1"
+    if (cd "$ORIGIN_DIR" && patch -p1 -R -s -f --dry-run < "$patch_file" >/dev/null 2>&1); then
+        echo "    already applied"
+        return 0
+    fi
+    if ! (cd "$ORIGIN_DIR" && patch -p1 -N -s -f --dry-run < "$patch_file"); then
+        echo "Error: $(basename "$patch_file") does not apply to $ORIGIN_DIR" >&2
+        exit 1
+    fi
+    (cd "$ORIGIN_DIR" && patch -p1 -N -s -f < "$patch_file")
+}
+
 # 1. Export declarations (extern.h) - NETHACK_EXPORT for bridge functions
 if [ -f "$PATCH_DIR/extern_export.patch" ]; then
     echo "  [1/11] Applying extern_export.patch (export declarations)..."
@@ -425,9 +480,17 @@ if [ -f "$PATCH_DIR/ios_travel_interrupt.patch" ]; then
     (cd "$ORIGIN_DIR" && patch -p1 -N -s -f < "$PATCH_DIR/ios_travel_interrupt.patch" 2>/dev/null) || true
 fi
 
-echo "✓ All iOS patches applied (13 total)"
+# 14. Level arena hook (do.c) - Switch allocator level arena in goto_level()
+echo "  [14/15] Applying ios_level_arena.patch (per-level allocation arena)..."
+apply_required_patch "$PATCH_DIR/ios_level_arena.patch"
+
+# 15. Journal clock (calendar.c) - getnow() on the journal's start time
+echo "  [15/15] Applying ios_journal_clock.patch (replayable game clock)..."
+apply_required_patch "$PATCH_DIR/ios_journal_clock.patch"
+
+echo "✓ All iOS patches applied (15 total)"
 echo "  - 3 export patches (extern.h, dlb.h, save/restore)"
-echo "  - 3 iOS adaptations (syscf, tutorial, moveloop)"
+echo "  - 5 iOS adaptations (syscf, tutorial, moveloop, level arena, journal clock)"
 echo "  - 6 stability fixes (botl guard, Lua defensive, timer relink, timer safety, u_init stub, travel interrupt)"
 echo "  - 1 bridge API (pager lookat)"
 echo ""
@@ -443,7 +506,18 @@ for source in "${SOURCES[@]}"; do
         echo "  Compiling $basename..."
 
         # Add include for our config
-        if clang $CFLAGS -include src/ios_config.h "$source" -o "$OBJ_DIR/${basename}.o" 2>&1 | head -10; then
+        EXTRA_INCLUDES=""
+        if [ "$basename" = "nhlua" ]; then
+            # Script loads go through the bytecode archive (src/ios_lua_archive.h)
+            EXTRA_INCLUDES="-include src/ios_lua_archive_hook.h"
+        fi
+        case "$source" in
+            "$ORIGIN_DIR"/*)
+                # NetHack's globals share one section (hibernation images)
+                EXTRA_INCLUDES="$EXTRA_INCLUDES -include src/ios_hibernate_section.h"
+                ;;
+        esac
+        if clang $CFLAGS -include src/ios_config.h $EXTRA_INCLUDES "$source" -o "$OBJ_DIR/${basename}.o" 2>&1 | head -10; then
             OBJECT_FILES+=("$OBJ_DIR/${basename}.o")
         else
             echo "    Warning: Failed to compile $basename"
@@ -469,6 +543,7 @@ clang -dynamiclib \
     -framework CoreFoundation \
     -framework Foundation \
     -framework Security \
+    -lcompression \
     -lc++ \
     -compatibility_version 1.0 \
     -current_version 3.7.0
@@ -506,6 +581,13 @@ fi
 
 echo "✓ Lua resources ready"
 
+# Precompile bundled Lua scripts into the mmapped bytecode archive
+echo ""
+echo "Building Lua bytecode archive..."
+if ! "$SCRIPT_DIR/scripts/build_lua_archive.sh"; then
+    echo "⚠️  Warning: Lua archive build failed (scripts will be copied and parsed at runtime)"
+fi
+
 # Generate data files (bogusmon, epitaph, engrave) from .txt sources
 echo ""
 echo "Generating data files (bogusmon, epitaph, engrave)..."
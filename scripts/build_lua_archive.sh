@@ -0,0 +1,44 @@
+#!/bin/bash
+# Precompile swift/lua_resources/*.lua into one bytecode archive
+# (swift/lua_resources/nhlua.luapak, mapped at startup - see src/ios_lua_archive.h)
+#
+# Builds scripts/pack_lua_archive.c for the host against the same lua/
+# sources the game links, so chunks match the game's Lua. Skips the pack
+# when the archive is newer than every script and the packer.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+LUA_DIR="swift/lua_resources"
+ARCHIVE="$LUA_DIR/nhlua.luapak"
+HOST_DIR="build/host"
+PACKER="$HOST_DIR/pack_lua_archive"
+
+if [ ! -d "lua" ]; then
+    echo "Error: lua not found. Run: git submodule update --init"
+    exit 1
+fi
+
+if [ -f "$ARCHIVE" ] && [ -z "$(find "$LUA_DIR" scripts/pack_lua_archive.c src/ios_lua_archive.h \
+        \( -name '*.lua' -o -name '*.c' -o -name '*.h' \) -newer "$ARCHIVE" | head -1)" ]; then
+    echo "✓ Lua archive up to date ($ARCHIVE)"
+    exit 0
+fi
+
+mkdir -p "$HOST_DIR"
+LUA_SOURCES=()
+for source in lua/*.c; do
+    case "$(basename "$source")" in
+        lua.c|luac.c|onelua.c) ;;          # Interpreter / compiler mains
+        *) LUA_SOURCES+=("$source") ;;
+    esac
+done
+
+echo "Building host Lua packer..."
+xcrun --sdk macosx clang -O2 -w -DLUA_USE_POSIX -Ilua -Isrc \
+    scripts/pack_lua_archive.c "${LUA_SOURCES[@]}" -lm -o "$PACKER"
+
+echo "Packing Lua scripts..."
+"$PACKER" "$ARCHIVE" "$LUA_DIR"/*.lua
@@ -0,0 +1,158 @@
+/*
+ * pack_lua_archive.c - Build nhlua.luapak (format: src/ios_lua_archive.h)
+ *
+ * Host tool, built and run by scripts/build_lua_archive.sh:
+ *   pack_lua_archive <out.luapak> <script.lua>...
+ *
+ * Each script is compiled with the same Lua sources the game links, dumped
+ * with debug info, and stored next to its source.
+ */
+
+#include "ios_lua_archive.h"
+#include "lua.h"
+#include "lauxlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+typedef struct {
+    IosLuaArchiveEntry entry;
+    Buffer source;
+    Buffer chunk;
+} Script;
+
+static void buffer_append(Buffer *b, const void *data, size_t size) {
+    if (b->size + size > b->capacity) {
+        b->capacity = (b->size + size) * 2;
+        b->data = realloc(b->data, b->capacity);
+        if (!b->data) {
+            fprintf(stderr, "pack_lua_archive: out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(b->data + b->size, data, size);
+    b->size += size;
+}
+
+static int dump_writer(lua_State *L, const void *p, size_t size, void *ud) {
+    (void)L;
+    buffer_append(ud, p, size);
+    return 0;
+}
+
+static int read_file(const char *path, Buffer *out) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+    char block[16384];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), fp)) > 0) buffer_append(out, block, n);
+    int failed = ferror(fp);
+    fclose(fp);
+    return failed ? -1 : 0;
+}
+
+static int compare_script(const void *a, const void *b) {
+    return strcmp(((const Script *)a)->entry.name, ((const Script *)b)->entry.name);
+}
+
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <out.luapak> <script.lua>...\n", argv[0]);
+        return 2;
+    }
+
+    int count = argc - 2;
+    Script *scripts = calloc((size_t)count, sizeof(Script));
+    lua_State *L = luaL_newstate();
+    if (!scripts || !L) return 1;
+
+    for (int i = 0; i < count; i++) {
+        const char *path = argv[i + 2];
+        const char *name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+        Script *s = &scripts[i];
+        if (strlen(name) >= IOS_LUA_ARCHIVE_NAME_MAX) {
+            fprintf(stderr, "pack_lua_archive: name too long: %s\n", name);
+            return 1;
+        }
+        strcpy(s->entry.name, name);
+
+        if (read_file(path, &s->source) != 0) {
+            fprintf(stderr, "pack_lua_archive: cannot read %s\n", path);
+            return 1;
+        }
+        char chunkname[IOS_LUA_ARCHIVE_NAME_MAX + 1];
+        snprintf(chunkname, sizeof(chunkname), "@%s", name);
+        if (luaL_loadbufferx(L, s->source.data, s->source.size, chunkname, "t") != LUA_OK) {
+            fprintf(stderr, "pack_lua_archive: %s\n", lua_tostring(L, -1));
+            return 1;
+        }
+        lua_dump(L, dump_writer, &s->chunk, 0);  // Keep line info for error messages
+        lua_pop(L, 1);
+    }
+    lua_close(L);
+
+    // Sorted so the loader can bsearch by name
+    qsort(scripts, (size_t)count, sizeof(Script), compare_script);
+    for (int i = 1; i < count; i++) {
+        if (strcmp(scripts[i - 1].entry.name, scripts[i].entry.name) == 0) {
+            fprintf(stderr, "pack_lua_archive: duplicate %s\n", scripts[i].entry.name);
+            return 1;
+        }
+    }
+
+    size_t offset = align8(sizeof(IosLuaArchiveHeader) + (size_t)count * sizeof(IosLuaArchiveEntry));
+    for (int i = 0; i < count; i++) {
+        scripts[i].entry.source_offset = (uint32_t)offset;
+        scripts[i].entry.source_size = (uint32_t)scripts[i].source.size;
+        offset = align8(offset + scripts[i].source.size);
+        scripts[i].entry.chunk_offset = (uint32_t)offset;
+        scripts[i].entry.chunk_size = (uint32_t)scripts[i].chunk.size;
+        offset = align8(offset + scripts[i].chunk.size);
+    }
+    if (offset > UINT32_MAX) {
+        fprintf(stderr, "pack_lua_archive: archive too large\n");
+        return 1;
+    }
+
+    IosLuaArchiveHeader header = {0};
+    memcpy(header.magic, IOS_LUA_ARCHIVE_MAGIC, sizeof(IOS_LUA_ARCHIVE_MAGIC));
+    header.version = IOS_LUA_ARCHIVE_VERSION;
+    header.lua_version = LUA_VERSION_NUM;
+    header.integer_size = sizeof(lua_Integer);
+    header.number_size = sizeof(lua_Number);
+    header.count = (uint32_t)count;
+
+    Buffer out = {0};
+    static const char padding[8] = {0};
+    buffer_append(&out, &header, sizeof(header));
+    for (int i = 0; i < count; i++) buffer_append(&out, &scripts[i].entry, sizeof(IosLuaArchiveEntry));
+    buffer_append(&out, padding, align8(out.size) - out.size);
+    for (int i = 0; i < count; i++) {
+        buffer_append(&out, scripts[i].source.data, scripts[i].source.size);
+        buffer_append(&out, padding, align8(out.size) - out.size);
+        buffer_append(&out, scripts[i].chunk.data, scripts[i].chunk.size);
+        buffer_append(&out, padding, align8(out.size) - out.size);
+    }
+
+    char temp[4096];
+    snprintf(temp, sizeof(temp), "%s.tmp", argv[1]);
+    FILE *fp = fopen(temp, "wb");
+    if (!fp || fwrite(out.data, 1, out.size, fp) != out.size || fclose(fp) != 0 ||
+        rename(temp, argv[1]) != 0) {
+        fprintf(stderr, "pack_lua_archive: cannot write %s\n", argv[1]);
+        remove(temp);
+        return 1;
+    }
+    printf("pack_lua_archive: %d scripts, %zu bytes -> %s\n", count, out.size, argv[1]);
+    return 0;
+}
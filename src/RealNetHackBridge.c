@@ -25,7 +25,6 @@
 #include <setjmp.h>  // For clean game exit via longjmp
 // REMOVED: pthread.h - NetHack is NOT thread-safe!
 #include <zlib.h>  // For manual decompression workaround
-#include <dispatch/dispatch.h>  // For dispatch_async in game ready signal
 #include "RealNetHackBridge.h"
 #include "action_system.h"
 #include "action_registry.h"
@@ -48,6 +47,12 @@
 #include "nethack_bridge_common.h"
 // #include "ios_travel.h"  // DISABLED: Travel feature not yet implemented
 #include "ios_game_state_buffer.h"  // For GameStateSnapshot type
+#include "ios_log.h"  // Ring logging for the message path
+#include "ios_transient_pool.h"  // Bridge result buffers freed by Swift
+#include "ios_inventory_cache.h"  // Inventory export built once per change
+#include "ios_message_log.h"  // Message history store (sequence ids)
+#include "ios_lookat_cache.h"  // Cached tile inspection results
+#include "ios_event_bus.h"  // Coalesced game-to-UI events
 
 static int game_initialized = 0;
 NETHACK_EXPORT int game_started = 0;  // Made non-static for ios_winprocs.c
@@ -66,9 +71,6 @@ volatile int ios_travel_interrupt_pending = 0;
 // Forward declaration of our helper functions
 const char* nethack_get_savef(void);
 
-// External notification posting (implemented in ios_notifications.m)
-extern void ios_post_message_notification(const char* message, const char* category, int attr);
-
 // Lua debug log buffer
 #define LUA_LOG_BUFFER_SIZE 32768
 static char lua_log_buffer[LUA_LOG_BUFFER_SIZE];
@@ -88,23 +90,9 @@ typedef struct {
 extern DeathInfo death_info;
 extern int player_has_died;
 
-static MessageEntry message_history[MESSAGE_HISTORY_SIZE];
-static int message_history_index = 0;
-static int message_history_count = 0;
+// Message history itself lives in ios_message_log.c (one store, sequence ids)
 static char message_history_json[MESSAGE_HISTORY_SIZE * 300];  // JSON buffer
 
-// Message queue for buffering messages before Swift is ready
-#define MESSAGE_QUEUE_SIZE 50
-typedef struct {
-    char message[MESSAGE_MAX_LENGTH];
-    char category[32];
-    int attr;
-} QueuedMessage;
-
-static QueuedMessage message_queue[MESSAGE_QUEUE_SIZE];
-static int message_queue_count = 0;
-static int swift_ready_for_messages = 0;  // 0 = not ready, 1 = ready
-
 // External NetHack functions we bridge to
 extern const char* test_nethack_functions(void);
 extern void init_nethack_core(void);
@@ -503,7 +491,7 @@ int nethack_process_command(void) {
             svc.context.move, nethack_get_turn_count());
 
     // Print the map to console for debugging
-    extern char map_buffer[40][121];  // From ios_winprocs.c
+    extern char map_buffer[60][181];  // From ios_winprocs.c (MAX_MAP_HEIGHT x MAX_MAP_WIDTH+1)
     extern int actual_map_width;
     extern int actual_map_height;
     fprintf(stderr, "\n========== MAP (Turn %ld) ==========\n", nethack_get_turn_count());
@@ -565,56 +553,20 @@ void nethack_real_randomize(void) {
     nethack_append_output("[AUTO] Character randomized!\n");
 }
 
-// Callback pointers for Swift (instead of weak symbols which don't work with dylib)
-static void (*ios_swift_map_update_callback_ptr)(void) = NULL;
-static void (*ios_swift_game_ready_callback_ptr)(void) = NULL;
-
-// Functions to register callbacks from Swift
-// CRITICAL: Must be explicitly exported with default visibility for Swift to find them
-__attribute__((visibility("default")))
-void ios_register_map_update_callback(void (*callback)(void)) {
-    ios_swift_map_update_callback_ptr = callback;
-    fprintf(stderr, "[BRIDGE] Map update callback registered at %p\n", (void*)callback);
-}
-
-__attribute__((visibility("default")))
-void ios_register_game_ready_callback(void (*callback)(void)) {
-    ios_swift_game_ready_callback_ptr = callback;
-    fprintf(stderr, "[BRIDGE] Game ready callback registered at %p\n", (void*)callback);
-}
-
-// Called by ios_winprocs when the map changes
-void ios_notify_map_changed(void) {
-    if (ios_swift_map_update_callback_ptr) {
-        ios_swift_map_update_callback_ptr();
-    }
-}
-
-// Forward declaration for flush_message_queue
-static void flush_message_queue(void);
-
-// Called when game is fully initialized and ready for queries
+// Game ready goes out through the event bus, flushed at once so Swift
+// can start querying without waiting for the first input wait
 NETHACK_EXPORT void ios_notify_game_ready(void) {
     fprintf(stderr, "[GAME_READY] ✅ Game fully initialized - notifying Swift\n");
-    dispatch_async(dispatch_get_main_queue(), ^{
-        if (ios_swift_game_ready_callback_ptr) {
-            ios_swift_game_ready_callback_ptr();
-        } else {
-            fprintf(stderr, "[GAME_READY] ❌ NO callback registered!\n");
-        }
-    });
+    ios_event_post(IOS_EVENT_GAME_READY);
+    ios_event_bus_flush();
 }
 
 // Called by Swift when it's ready to receive messages
 NETHACK_EXPORT void ios_swift_ready_for_messages(void) {
     fprintf(stderr, "[MSG_QUEUE] Swift signaled ready for messages\n");
 
-    swift_ready_for_messages = 1;
-
-    // Flush any queued messages
-    if (message_queue_count > 0) {
-        flush_message_queue();
-    }
+    // Delivers the messages held since the reset in one batch
+    ios_event_bus_hold_messages(false);
 
     fprintf(stderr, "[MSG_QUEUE] Swift message handler ready, future messages will be sent immediately\n");
 }
@@ -622,18 +574,17 @@ NETHACK_EXPORT void ios_swift_ready_for_messages(void) {
 // Called when starting a NEW game (Swift is already ready)
 NETHACK_EXPORT void ios_swift_ready_for_new_game(void) {
     fprintf(stderr, "[MSG_QUEUE] NEW game - Swift already ready (view is visible)\n");
-    swift_ready_for_messages = 1;
+    ios_event_bus_hold_messages(false);
 }
 
 // Called to reset message queue state (from ios_winprocs.c during reset)
 void ios_reset_message_queue_state(void) {
     fprintf(stderr, "[MSG_QUEUE] Resetting message queue state\n");
-    // Reset the ready flag to 0 - each game session should start fresh
-    // NEW games will set this to 1 immediately
-    // LOAD games will set this to 1 when view appears
-    swift_ready_for_messages = 0;
-    message_queue_count = 0;
-    memset(message_queue, 0, sizeof(message_queue));
+    // Hold messages again - each game session should start fresh
+    // NEW games release them immediately
+    // LOAD games release them when the view appears
+    ios_event_bus_reset();
+    ios_event_bus_hold_messages(true);
 }
 
 // Bridge function that Swift actually calls
@@ -1258,22 +1209,6 @@ void nethack_add_message(const char* message, const char* category) {
     nethack_add_message_with_attrs(message, category, 0);  // ATR_NONE
 }
 
-// Flush queued messages to Swift (called when Swift becomes ready)
-static void flush_message_queue(void) {
-    fprintf(stderr, "[MSG_QUEUE] Flushing %d queued messages to Swift\n", message_queue_count);
-
-    for (int i = 0; i < message_queue_count; i++) {
-        ios_post_message_notification(
-            message_queue[i].message,
-            message_queue[i].category,
-            message_queue[i].attr
-        );
-    }
-
-    message_queue_count = 0;  // Clear the queue
-    fprintf(stderr, "[MSG_QUEUE] Queue flushed successfully\n");
-}
-
 // Add a message with ATR_* attributes to the history buffer
 void nethack_add_message_with_attrs(const char* message, const char* category, int attr) {
     if (!message) return;
@@ -1281,117 +1216,93 @@ void nethack_add_message_with_attrs(const char* message, const char* category, i
     // Get actual turn count from NetHack (svm.moves is the correct variable)
     long current_moves = svm.moves;
 
-    // Copy message and category into the circular buffer
-    strncpy(message_history[message_history_index].message, message, MESSAGE_MAX_LENGTH - 1);
-    message_history[message_history_index].message[MESSAGE_MAX_LENGTH - 1] = '\0';
+    // Truncated copies: the log never sees NetHack's buffer
+    MessageEntry entry;
+    strncpy(entry.message, message, MESSAGE_MAX_LENGTH - 1);
+    entry.message[MESSAGE_MAX_LENGTH - 1] = '\0';
+    strncpy(entry.category, category ? category : "MSG", 31);
+    entry.category[31] = '\0';
 
-    if (category) {
-        strncpy(message_history[message_history_index].category, category, 31);
-        message_history[message_history_index].category[31] = '\0';
-    } else {
-        strcpy(message_history[message_history_index].category, "MSG");
-    }
+    ios_message_log_append(entry.message, entry.category, attr, current_moves);
 
-    message_history[message_history_index].turn = current_moves;
-    message_history[message_history_index].attr = attr;  // Store NetHack attributes
-
-    // NEW: Check if Swift is ready to receive messages
-    if (!swift_ready_for_messages) {
-        // Swift not ready - queue the message for later
-        if (message_queue_count < MESSAGE_QUEUE_SIZE) {
-            strncpy(message_queue[message_queue_count].message,
-                   message_history[message_history_index].message, MESSAGE_MAX_LENGTH - 1);
-            message_queue[message_queue_count].message[MESSAGE_MAX_LENGTH - 1] = '\0';
-
-            strncpy(message_queue[message_queue_count].category,
-                   message_history[message_history_index].category, 31);
-            message_queue[message_queue_count].category[31] = '\0';
+    // Swift fetches the text from the log when the turn's batch arrives
+    // (held by the bus until Swift is ready for messages)
+    ios_event_post_message(ios_message_log_last_seq());
+}
 
-            message_queue[message_queue_count].attr = attr;
-            message_queue_count++;
+// JSON writer state for nethack_get_message_history (appends, never rescans)
+typedef struct {
+    char *pos;
+    char *end;
+    int skip;   // Records older than the last MESSAGE_HISTORY_SIZE
+    int first;
+} MessageJSONWriter;
+
+static void append_message_json(const IOSMessageRecord *record, const char *text, void *context) {
+    MessageJSONWriter *w = context;
+    if (w->skip > 0) {
+        w->skip--;
+        return;
+    }
+    if (w->end - w->pos < 2) return;
 
-            fprintf(stderr, "[MSG_QUEUE] Message queued (Swift not ready): '%s' (queue size: %d)\n",
-                    message, message_queue_count);
-        } else {
-            fprintf(stderr, "[MSG_QUEUE] WARNING: Queue full, dropping message: '%s'\n", message);
+    // Escape message text for JSON (replace " with \")
+    char escaped_msg[MESSAGE_MAX_LENGTH * 2];
+    char *dst = escaped_msg;
+    for (const char *src = text; *src && (dst - escaped_msg) < (MESSAGE_MAX_LENGTH * 2 - 2); src++) {
+        if (*src == '"' || *src == '\\') {
+            *dst++ = '\\';
         }
-    } else {
-        // Swift is ready - send immediately
-        ios_post_message_notification(
-            message_history[message_history_index].message,  // Use truncated buffer (safe)
-            message_history[message_history_index].category, // Use category buffer (safe)
-            attr
-        );
+        *dst++ = *src;
     }
+    *dst = '\0';
 
-    // Update circular buffer index AFTER notification
-    message_history_index = (message_history_index + 1) % MESSAGE_HISTORY_SIZE;
-    if (message_history_count < MESSAGE_HISTORY_SIZE) {
-        message_history_count++;
+    int n = snprintf(w->pos, (size_t)(w->end - w->pos),
+            "%s{\"message\":\"%s\",\"category\":\"%s\",\"turn\":%d,\"attr\":%d}",
+            w->first ? "" : ",",
+            escaped_msg,
+            record->category,
+            record->turn,
+            record->attr);
+    if (n > 0 && n < w->end - w->pos) {
+        w->pos += n;
+        w->first = 0;
     }
 }
 
-// Get message history as JSON array
+// Get message history as JSON array (newest MESSAGE_HISTORY_SIZE messages)
+// Incremental readers should use ios_message_log_fetch_since() instead
 const char* nethack_get_message_history(void) {
-    message_history_json[0] = '\0';
-    strcat(message_history_json, "[");
-
-    int start_idx = 0;
-    if (message_history_count == MESSAGE_HISTORY_SIZE) {
-        // Buffer is full, start from oldest message
-        start_idx = message_history_index;
-    }
-
-    int first = 1;
-    for (int i = 0; i < message_history_count; i++) {
-        int idx = (start_idx + i) % MESSAGE_HISTORY_SIZE;
-
-        if (!first) {
-            strcat(message_history_json, ",");
-        }
-        first = 0;
-
-        // Escape message text for JSON (replace " with \")
-        char escaped_msg[MESSAGE_MAX_LENGTH * 2];
-        const char *src = message_history[idx].message;
-        char *dst = escaped_msg;
-        while (*src && (dst - escaped_msg) < (MESSAGE_MAX_LENGTH * 2 - 2)) {
-            if (*src == '"' || *src == '\\') {
-                *dst++ = '\\';
-            }
-            *dst++ = *src++;
-        }
-        *dst = '\0';
-
-        char entry[500];
-        snprintf(entry, sizeof(entry),
-                "{\"message\":\"%s\",\"category\":\"%s\",\"turn\":%ld,\"attr\":%d}",
-                escaped_msg,
-                message_history[idx].category,
-                message_history[idx].turn,
-                message_history[idx].attr);
-        strcat(message_history_json, entry);
-    }
+    int count = ios_message_log_count();
+    MessageJSONWriter w = {
+        .pos = message_history_json,
+        .end = message_history_json + sizeof(message_history_json) - 1,  // Room for ']'
+        .skip = count > MESSAGE_HISTORY_SIZE ? count - MESSAGE_HISTORY_SIZE : 0,
+        .first = 1,
+    };
 
-    strcat(message_history_json, "]");
+    *w.pos++ = '[';
+    ios_message_log_visit(append_message_json, &w);
+    *w.pos++ = ']';
+    *w.pos = '\0';
     return message_history_json;
 }
 
 // Get count of messages in history
 int nethack_get_message_count(void) {
-    return message_history_count;
+    int count = ios_message_log_count();
+    return count < MESSAGE_HISTORY_SIZE ? count : MESSAGE_HISTORY_SIZE;
 }
 
 // Clear message history
 void nethack_clear_message_history(void) {
-    message_history_index = 0;
-    message_history_count = 0;
-    memset(message_history, 0, sizeof(message_history));
+    ios_message_log_clear();
 }
 
 // =============== MAP DATA FUNCTIONS ===============
 // Export map data for Swift UI
-extern char map_buffer[40][121];  // From ios_winprocs.c - bigger now!
+// NOTE: Dimensions MUST match ios_winprocs.c (MAX_MAP_HEIGHT x MAX_MAP_WIDTH)
+extern char map_buffer[60][181];  // From ios_winprocs.c
 extern boolean map_dirty;
 extern int actual_map_width;
 extern int actual_map_height;
@@ -1402,17 +1313,21 @@ typedef struct {
     char ch;
     unsigned char color;
     unsigned char bg;
+    unsigned int glyphflags;  // Must match ios_winprocs.c
 } MapCell;
 
-extern MapCell map_cells[40][120];
+extern MapCell map_cells[60][180];
 
+// Legacy text export. Prefer ios_map_export_get() (ios_map_export.h):
+// packed cells, per-row versions, no string building.
 NETHACK_EXPORT const char* nethack_get_map_data(void) {
     static char map_output[120 * 40 + 100];  // Room for larger map
-    memset(map_output, 0, sizeof(map_output));
 
     // Use actual map dimensions
     int height = actual_map_height > 0 ? actual_map_height : 25;
     int width = actual_map_width > 0 ? actual_map_width : 80;
+    if (height > 40) height = 40;
+    if (width > 120) width = 120;
 
     // CRITICAL: Read from captured_map (what print_glyph wrote), NOT map_buffer
     // captured_map is populated by ios_capture_map() after print_glyph draws
@@ -1420,47 +1335,58 @@ NETHACK_EXPORT const char* nethack_get_map_data(void) {
 
     // CRITICAL FIX: captured_map has message area at rows 0-1, map starts at row 2
     // We need to read ALL buffer rows including the message offset!
-    #define MAP_Y_OFFSET 2
-
-    // Read the actual map area - ALL rows from buffer
-    for (int y = 0; y < height && y < 40; y++) {
-        if (y > 0) strcat(map_output, "\n");
-        for (int x = 0; x < width && x < 120; x++) {
-            // Read from buffer including message area (don't skip offset!)
-            char ch = captured_map[y][x];
-            if (ch == 0) ch = ' ';  // Replace nulls with spaces
-            strncat(map_output, &ch, 1);
+    // Rows are copied whole with a running write position (no strncat rescans)
+    char *out = map_output;
+    for (int y = 0; y < height; y++) {
+        if (y > 0) *out++ = '\n';
+        memcpy(out, captured_map[y], width);
+        for (int x = 0; x < width; x++) {
+            if (out[x] == 0) out[x] = ' ';  // Replace nulls with spaces
         }
+        out += width;
     }
+    *out = '\0';
 
     return map_output;
 }
 
 // Get enhanced map data as JSON-like format
+// Legacy - prefer ios_map_export_get(); kept for old callers
 NETHACK_EXPORT const char* nethack_get_map_data_enhanced(void) {
-    static char map_output[120 * 40 * 20];  // Much larger for JSON
-    memset(map_output, 0, sizeof(map_output));
+    // Room for every tile at its longest (~56 bytes); the guard below still
+    // keeps the output valid if that ever falls short
+    static char map_output[120 * 40 * 64];
+    const size_t cap = sizeof(map_output) - sizeof("]}");  // Closing always fits
 
     int height = actual_map_height > 0 ? actual_map_height : 25;
     int width = actual_map_width > 0 ? actual_map_width : 80;
 
-    sprintf(map_output, "{\"width\":%d,\"height\":%d,\"tiles\":[", width, height);
+    // Append at a running offset - strcat rescanned the whole buffer per tile
+    size_t len = (size_t)snprintf(map_output, cap, "{\"width\":%d,\"height\":%d,\"tiles\":[",
+                                  width, height);
 
-    for (int y = 0; y < height && y < 40; y++) {
+    // A tile that does not fit is left out whole, with the ones after it
+    bool truncated = false;
+    for (int y = 0; y < height && y < 40 && !truncated; y++) {
         for (int x = 0; x < width && x < 120; x++) {
-            if (y > 0 || x > 0) strcat(map_output, ",");
-
-            char tile_json[100];
-            sprintf(tile_json, "{\"x\":%d,\"y\":%d,\"ch\":'%c',\"glyph\":%d,\"color\":%d}",
-                    x, y,
-                    map_cells[y][x].ch ? map_cells[y][x].ch : ' ',
-                    map_cells[y][x].glyph,
-                    map_cells[y][x].color);
-            strcat(map_output, tile_json);
+            int n = snprintf(map_output + len, cap - len,
+                             "%s{\"x\":%d,\"y\":%d,\"ch\":'%c',\"glyph\":%d,\"color\":%d}",
+                             (y > 0 || x > 0) ? "," : "",
+                             x, y,
+                             map_cells[y][x].ch ? map_cells[y][x].ch : ' ',
+                             map_cells[y][x].glyph,
+                             map_cells[y][x].color);
+            if (n < 0 || (size_t)n >= cap - len) {
+                fprintf(stderr, "[BRIDGE] Map JSON truncated at tile (%d,%d)\n", x, y);
+                truncated = true;
+                break;
+            }
+            len += (size_t)n;
         }
     }
 
-    strcat(map_output, "]}");
+    // Overwrites whatever part of a tile that did not fit was written
+    memcpy(map_output + len, "]}", sizeof("]}"));
     return map_output;
 }
 
@@ -1779,6 +1705,7 @@ int nethack_get_player_cha(void) {
 // External getter for conditions from ios_winprocs.c
 extern unsigned long ios_get_current_conditions(void);
 
+// Kept for callers that want JSON; the HUD reads IOSStatusBlock (ios_status_block.h)
 const char* nethack_get_player_stats_json(void) {
     static char json_buffer[512];
 
@@ -2064,128 +1991,16 @@ int nethack_is_traveling(void) {
 }
 
 const char* nethack_examine_tile(int swift_x, int swift_y) {
-    // CRITICAL FIX: Swift sends SWIFT coordinates (0-based X and Y), NOT buffer coordinates!
-    // Same coordinate conversion as nethack_travel_to()
-    // See nethack_travel_to() comments for full coordinate system documentation
-
-    extern struct you u;
+    // Swift sends SWIFT coordinates (0-based X and Y) - see nethack_travel_to()
+    // Same description as `;` (farlook) plus the object pile list, served from
+    // the lookat cache when the tile has not changed (ios_lookat_cache.h)
+    static IOSLookatResult result;
 
-    // Convert Swift coords to NetHack MAP coords
-    int map_x = swift_x + 1;  // 0-based → 1-based
-    int map_y = swift_y;      // Already 0-based, use directly
-
-    // Validate coordinates BEFORE any use
-    if (map_x < 1 || map_x >= COLNO) {
-        fprintf(stderr, "[C Bridge] Invalid map_x=%d from Swift(%d,%d)\n",
-                map_x, swift_x, swift_y);
-        return NULL;
-    }
-    if (map_y < 0 || map_y >= ROWNO) {
-        fprintf(stderr, "[C Bridge] Invalid map_y=%d from Swift(%d,%d)\n",
-                map_y, swift_x, swift_y);
+    if (!ios_examine_tile(swift_x, swift_y, &result)) {
+        fprintf(stderr, "[C Bridge] Invalid examine coordinates Swift(%d,%d)\n", swift_x, swift_y);
         return NULL;
     }
-
-    // PERF: Get start timestamp for performance measurement
-    struct timeval tv_start, tv_end;
-    gettimeofday(&tv_start, NULL);
-    double start_ms = tv_start.tv_sec * 1000.0 + tv_start.tv_usec / 1000.0;
-
-    fprintf(stderr, "[C Bridge] [%.3fms] Examine tile at map(%d,%d) [Swift(%d,%d)] (player at map(%d,%d))\n",
-            start_ms, map_x, map_y, swift_x, swift_y, u.ux, u.uy);
-
-    // ARCHITECTURAL FIX: Removed suppress_messages_during_examine flag
-    // OLD APPROACH: Bridge suppressed Swift callbacks to prevent 8s main thread hang
-    // NEW APPROACH: examineTileAsync() runs on background queue → callbacks can't block UI
-    // Bridge is now a pure adapter - no message delivery control (game logic)!
-
-    // DIRECT LOOKAT() CALL - Same as `;` (farlook) command!
-    // lookat() is explicitly exported for iOS Bridge (pager.c:655)
-    // This gives us precise descriptions instead of generic "spellbook or door"
-    //
-    // lookat() returns:
-    // - buf: Main description (e.g., "a closed door", "tame dog called Fido")
-    // - monbuf: How monster was seen (e.g., "telepathy", "infravision")
-    // - return: struct permonst* for monster data lookup (unused here)
-    extern struct permonst *lookat(coordxy, coordxy, char *, char *);
-    extern char *doname(struct obj *);
-
-    static char buf[BUFSZ];
-    static char monbuf[BUFSZ];
-    static char result_buf[BUFSZ * 4];  // Larger buffer for object piles
-
-    gettimeofday(&tv_end, NULL);
-    double before_lookat_ms = tv_end.tv_sec * 1000.0 + tv_end.tv_usec / 1000.0;
-    fprintf(stderr, "[C Bridge] [%.3fms] Calling lookat(%d,%d) [+%.3fms setup]\n",
-            before_lookat_ms, map_x, map_y, before_lookat_ms - start_ms);
-
-    // Call lookat() directly - this is what `;` does!
-    struct permonst *pm = lookat(map_x, map_y, buf, monbuf);
-    (void)pm;  // Unused for now, but could be used for "more info" lookup
-
-    gettimeofday(&tv_end, NULL);
-    double after_lookat_ms = tv_end.tv_sec * 1000.0 + tv_end.tv_usec / 1000.0;
-    fprintf(stderr, "[C Bridge] [%.3fms] lookat() returned buf='%s', monbuf='%s' [+%.3fms lookat]\n",
-            after_lookat_ms, buf, monbuf, after_lookat_ms - before_lookat_ms);
-
-    // Check if we got any description
-    if (buf[0] == '\0') {
-        fprintf(stderr, "[C Bridge] [%.3fms] No description from lookat() [+%.3fms total]\n",
-                after_lookat_ms, after_lookat_ms - start_ms);
-        return "unexplored area";
-    }
-
-    // Format result: combine buf and monbuf if both present
-    // buf = "tame dog called Fido"
-    // monbuf = "[seen: telepathy]" or ""
-    if (monbuf[0] != '\0') {
-        Sprintf(result_buf, "%s %s", buf, monbuf);
-    } else {
-        Strcpy(result_buf, buf);
-    }
-
-    // CHECK FOR OBJECT PILES - Show first 6 items, then "+X items" if 7+
-    // svl.level.objects[x][y] is the first object at location
-    // otmp->nexthere chains to additional objects
-    struct obj *otmp = svl.level.objects[map_x][map_y];
-    if (otmp) {
-        // Count total objects first
-        int total_count = 0;
-        for (struct obj *count_obj = otmp; count_obj; count_obj = count_obj->nexthere) {
-            total_count++;
-        }
-
-        if (total_count > 1) {
-            // Multiple objects - show list instead of lookat() description
-            result_buf[0] = '\0';  // Clear lookat result, show clean list
-
-            // Show up to 6 items (no point showing "+1 more")
-            int max_show = (total_count <= 6) ? total_count : 5;
-            int shown = 0;
-            for (struct obj *list_obj = otmp; list_obj && shown < max_show; list_obj = list_obj->nexthere) {
-                if (shown > 0) Strcat(result_buf, "\n");
-                Strcat(result_buf, doname(list_obj));
-                shown++;
-            }
-
-            // Show "+X items" only if 2+ remaining
-            int remaining = total_count - shown;
-            if (remaining >= 2) {
-                char more_buf[32];
-                Sprintf(more_buf, "\n+%d more items", remaining);
-                Strcat(result_buf, more_buf);
-            }
-
-            fprintf(stderr, "[C Bridge] Object pile: %d total, showing %d\n", total_count, shown);
-        }
-    }
-
-    gettimeofday(&tv_end, NULL);
-    double end_ms = tv_end.tv_sec * 1000.0 + tv_end.tv_usec / 1000.0;
-    fprintf(stderr, "[C Bridge] [%.3fms] Final description: '%s' [%.3fms TOTAL]\n",
-            end_ms, result_buf, end_ms - start_ms);
-
-    return result_buf;  // Return to Swift - same info as `;` + object pile list!
+    return result.text;
 }
 
 
@@ -2651,26 +2466,15 @@ void nethack_run_game_threaded(void) {
 }
 
 // Send input to NetHack (actual implementation)
+// The whole string is queued as one command so keys from other threads
+// cannot land in the middle of it
 void nethack_real_send_input(const char* input) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    double timestamp = ts.tv_sec + ts.tv_nsec / 1e9;
-
     if (!input) return;
 
-    fprintf(stderr, "[%.3f] [C Bridge] nethack_real_send_input START\n", timestamp);
-
-    // Queue each character to the iOS input system
-    extern void ios_queue_input(char);
-    while (*input) {
-        fprintf(stderr, "[%.3f] [C Bridge] Queueing char 0x%02X\n", timestamp, (unsigned char)*input);
-        ios_queue_input(*input);
-        input++;
+    extern int ios_queue_input_string(const char *keys);
+    if (!ios_queue_input_string(input)) {
+        fprintf(stderr, "[C Bridge] nethack_real_send_input: input queue full, dropped \"%s\"\n", input);
     }
-
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    double end_time = ts.tv_sec + ts.tv_nsec / 1e9;
-    fprintf(stderr, "[%.3f] [C Bridge] nethack_real_send_input END (took %.3fms)\n", end_time, (end_time - timestamp) * 1000);
 }
 
 void nethack_send_input_threaded(const char* input) {
@@ -2858,92 +2662,47 @@ int nethack_get_inventory_count(void) {
     if (!game_started) {
         return 0;
     }
-    if (!gi.invent) {
-        return 0;
-    }
-
-    int count = 0;
-    struct obj *otmp;
 
-    // gi.invent is the global inventory linked list
-    for (otmp = gi.invent; otmp; otmp = otmp->nobj) {
-        count++;
-    }
-
-    return count;
+    // From the cache header so the count always matches nethack_get_inventory_items()
+    return ios_inventory_cache_count();
 }
 
 // Fill inventory array with real NetHack items
+// Names come from the inventory cache: doname() only runs when inventory changed
 int nethack_get_inventory_items(InventoryItem *items, int max_items) {
     // FIX: Removed in_moveloop check - inventory should be accessible anytime during gameplay
     // User wants to check inventory while waiting for input, not just during move processing
     if (!game_started) {
         return 0;
     }
-    if (!gi.invent) {
+    if (!items) {
         return 0;
     }
 
-    int count = 0;
-    struct obj *otmp;
-
-    if (!items) {
+    InventoryCache *inv = ios_transient_alloc(sizeof(InventoryCache));
+    if (!inv) {
         return 0;
     }
+    ios_inventory_cache_copy(inv);
 
-    for (otmp = gi.invent; otmp && count < max_items; otmp = otmp->nobj) {
+    int count = 0;
+    for (; count < inv->count && count < max_items; count++) {
+        const InventoryCacheRecord *r = &inv->records[count];
         InventoryItem *item = &items[count];
 
-        // Basic info
-        item->invlet = otmp->invlet;
-        item->quantity = (int)otmp->quan;
-        item->oclass = otmp->oclass;
-
-        // Get full name (WARNING: doname() returns static buffer, must copy!)
-        char *name = doname(otmp);
-        item->name = strdup(name);  // Caller must free()
-
-        // BUC status (Blessed/Uncursed/Cursed)
-        item->buc_known = otmp->bknown ? true : false;
-        if (otmp->bknown) {
-            if (otmp->blessed) {
-                item->buc_status = 'B';  // Blessed
-            } else if (otmp->cursed) {
-                item->buc_status = 'C';  // Cursed
-            } else {
-                item->buc_status = 'U';  // Uncursed
-            }
-        } else {
-            item->buc_status = '?';  // Unknown
-        }
-
-        // Enchantment (+1, -2, etc.)
-        item->enchantment = (int)otmp->spe;
-
-        // Equipped status (wielded, worn, etc.)
-        item->is_equipped = (otmp->owornmask != 0);
-        if (otmp->owornmask & W_WEP) {
-            strcpy(item->equipped_slot, "wielded");
-        } else if (otmp->owornmask & W_ARM) {
-            strcpy(item->equipped_slot, "worn");
-        } else if (otmp->owornmask & W_RINGL) {
-            strcpy(item->equipped_slot, "left ring");
-        } else if (otmp->owornmask & W_RINGR) {
-            strcpy(item->equipped_slot, "right ring");
-        } else if (otmp->owornmask & W_AMUL) {
-            strcpy(item->equipped_slot, "amulet");
-        } else if (otmp->owornmask) {
-            strcpy(item->equipped_slot, "equipped");
-        } else {
-            item->equipped_slot[0] = '\0';
-        }
-
-        // Container check (bag, box, chest)
-        item->is_container = Is_container(otmp) ? true : false;
-
-        count++;
+        item->invlet = r->invlet;
+        item->quantity = r->quantity;
+        item->oclass = r->oclass;
+        item->name = ios_transient_strdup(&inv->names[r->name_offset]);  // Freed by nethack_free_inventory_items()
+        item->buc_known = r->buc_known;
+        item->buc_status = r->buc_status;
+        item->enchantment = r->enchantment;
+        item->is_equipped = r->is_equipped;
+        memcpy(item->equipped_slot, r->equipped_slot, sizeof(item->equipped_slot));
+        item->is_container = r->is_container;
     }
 
+    ios_transient_free(inv);
     return count;
 }
 
@@ -2953,7 +2712,7 @@ void nethack_free_inventory_items(InventoryItem *items, int count) {
 
     for (int i = 0; i < count; i++) {
         if (items[i].name) {
-            free(items[i].name);
+            ios_transient_free(items[i].name);
             items[i].name = NULL;
         }
     }
@@ -3122,8 +2881,8 @@ int ios_get_container_contents(struct obj *container, ios_item_info **items_out)
         return -1;  // Error - allocation too large
     }
 
-    // Allocate array - use calloc for zero initialization
-    ios_item_info *items = calloc(count, sizeof(ios_item_info));
+    // Allocate array from the bridge pool (zeroed), not the game heap
+    ios_item_info *items = ios_transient_calloc(count, sizeof(ios_item_info));
     if (!items) {
         fprintf(stderr, "[CONTAINER] ERROR: Failed to allocate memory for %d items\n", count);
         return -1;  // Error - malloc failure
@@ -3188,11 +2947,9 @@ int ios_get_container_contents(struct obj *container, ios_item_info **items_out)
 }
 
 // Free container contents array
-// Safe to call from any thread (just a free() call)
+// Safe to call from any thread (transient pool blocks)
 void ios_free_container_contents(ios_item_info *items, int count) {
-    if (items) {
-        free(items);
-    }
+    ios_transient_free(items);
 }
 
 // Get full item name (doname) - returns static buffer
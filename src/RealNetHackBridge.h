@@ -46,6 +46,7 @@ NETHACK_EXPORT const char* nethack_real_get_output(void);
 NETHACK_EXPORT void nethack_real_send_input(const char* cmd);
 NETHACK_EXPORT void nethack_real_clear_output(void);
 NETHACK_EXPORT void ios_queue_input(char ch);  // Queue single character to input system
+NETHACK_EXPORT int ios_queue_input_string(const char *keys);  // Queue a whole command atomically (0 if the queue is full)
 
 // Game loop control
 NETHACK_EXPORT int nethack_process_command(void);  // Process one command/turn, returns 1 if game continues
@@ -146,7 +147,7 @@ NETHACK_EXPORT void ios_clear_menu_requested(void);
 // Message history functions
 NETHACK_EXPORT void nethack_add_message(const char* message, const char* category);
 NETHACK_EXPORT void nethack_add_message_with_attrs(const char* message, const char* category, int attr);
-NETHACK_EXPORT const char* nethack_get_message_history(void);  // Returns JSON array of recent messages
+NETHACK_EXPORT const char* nethack_get_message_history(void);  // Returns JSON array of recent messages (see ios_message_log_fetch_since)
 NETHACK_EXPORT int nethack_get_message_count(void);
 NETHACK_EXPORT void nethack_clear_message_history(void);
 
@@ -224,12 +225,14 @@ NETHACK_EXPORT void ios_reset_all_static_state(void);  // Reset ALL static varia
 NETHACK_EXPORT void ios_shutdown_game(void);      // Orderly shutdown: freedynamicdata → dlb_cleanup → l_nhcore_done
 NETHACK_EXPORT void ios_wipe_memory(void);        // Memory wipe: nh_restart() - ONLY safe after shutdown!
 NETHACK_EXPORT void ios_reinit_subsystems(void);  // Re-initialize: dlb_init → l_nhcore_init → ios_reset_all_static_state
+NETHACK_EXPORT void ios_warm_dylib_restart(void); // Next game without dylib reload: shutdown → wipe → full init
 
 // Complete save/restore system - atomic save with proper NetHack integration
 NETHACK_EXPORT int ios_save_complete(const char* save_dir);     // Complete save (game state only, no memory.dat)
 NETHACK_EXPORT int ios_restore_complete(const char* save_dir);  // Complete restore with proper initialization
 NETHACK_EXPORT int ios_quicksave(void);                         // Quick save to iOS Documents/save
 NETHACK_EXPORT int ios_quickrestore(void);                      // Quick restore from iOS Documents/save
+NETHACK_EXPORT int ios_save_wait_for_writer(void);              // Wait for background save commits (0 = all succeeded)
 NETHACK_EXPORT int ios_save_exists(void);                       // Check if save file exists
 
 // Map dimension control (dynamic sizing)
@@ -283,6 +286,7 @@ NETHACK_EXPORT int ios_get_unique_kills_count(void);    // Number of unique mons
 NETHACK_EXPORT int ios_get_monster_kills(int mndx);     // Kill count for specific monster type
 NETHACK_EXPORT const char* ios_get_monster_name(int mndx); // Get monster name by index
 NETHACK_EXPORT int ios_get_top_kills(int* indices, int* counts, int max_results); // Top N kills
+NETHACK_EXPORT uint32_t ios_kill_stats_generation(void);  // Moves when kills/discoveries change
 
 // Generic yn_function response system
 typedef struct {
@@ -316,24 +320,34 @@ NETHACK_EXPORT const YNContext* nethack_get_current_yn_context(void);
 #define IOS_MAX_MENU_ITEMS 256
 #define IOS_MAX_MENU_TEXT  256
 
+// Shared string storage for all item texts of one menu; sized so a full
+// menu of maximum-length lines still fits (items only use what they need)
+#define IOS_MENU_TEXT_ARENA (IOS_MAX_MENU_ITEMS * IOS_MAX_MENU_TEXT)
+
 // Menu item structure for passing to Swift
+// Text lives in IOSMenuContext.text; items are filled in place by add_menu
 typedef struct {
     char selector;              // Selection character ('a'-'z', 'A'-'Z', or 0)
     int glyph;                  // Glyph ID for icon display
-    char text[IOS_MAX_MENU_TEXT];  // Display text (copied, not pointer)
     int attributes;             // ATR_* attributes (bold, dim, etc.)
     int identifier;             // NetHack's internal identifier (a_int from ANY_P)
     unsigned int itemflags;     // MENU_ITEMFLAGS_* from NetHack
+    int text_offset;            // Start of the NUL-terminated text in context->text
+    int text_length;            // Bytes, excluding the NUL
 } IOSMenuItem;
 
 // Menu context for callback
-// NOTE: item_count and window_id come BEFORE items array for easier Swift parsing
+// One contiguous block: header, packed items, then the text arena. It is
+// the menu store itself (not a copy), reset by start_menu and valid for
+// the duration of the callback.
 typedef struct {
     int how;                              // PICK_NONE/PICK_ONE/PICK_ANY
     char prompt[IOS_MAX_MENU_TEXT];       // Menu title/prompt
     int item_count;                        // Number of items
     int window_id;                         // NetHack window ID
-    IOSMenuItem items[IOS_MAX_MENU_ITEMS]; // Menu items (at end for variable access)
+    int text_used;                         // Bytes of text[] in use
+    IOSMenuItem items[IOS_MAX_MENU_ITEMS]; // Menu items
+    char text[IOS_MENU_TEXT_ARENA];        // Item strings, referenced by offset
 } IOSMenuContext;
 
 // Menu selection result from Swift
@@ -381,9 +395,10 @@ typedef struct {
 // Get count of items in player inventory
 NETHACK_EXPORT int nethack_get_inventory_count(void);
 
-// Fill array with inventory items
+// Fill array with inventory items (from the inventory cache, see ios_inventory_cache.h)
 // Returns actual count filled (may be less than max_items)
 // IMPORTANT: Caller must call nethack_free_inventory_items() to free allocated names!
+// Prefer ios_get_inventory_cache_if_newer(): one copy, no per-name allocations
 NETHACK_EXPORT int nethack_get_inventory_items(InventoryItem *items, int max_items);
 
 // Free allocated memory in inventory items (frees name strings)
@@ -568,17 +583,42 @@ NETHACK_EXPORT int ios_nethack_load(const char* filepath);
 // Clean shutdown
 NETHACK_EXPORT void ios_nethack_cleanup(void);
 
+// Stepped game loop behind the calls above (IOSStepState, ios_game_step)
+#include "ios_game_step.h"
+
 // =============================================================================
 // RENDER QUEUE API (Phase 2 - Swift Consumer)
 // =============================================================================
 
 // Access to global render queue for Swift
 #include "ios_render_queue.h"
+#include "ios_map_export.h"  // Binary map export (PackedMapCell, MapExport)
+#include "ios_glyph_table.h"  // Precomputed glyph render table (GlyphRenderInfo)
+#include "ios_frame_timing.h"  // Turn stage latency histograms (FrameTimingStats)
+#include "ios_read_model.h"  // Turn-boundary inventory/status/floor model (GameReadModel)
+#include "ios_inventory_cache.h"  // Inventory export cache (InventoryCache)
+#include "ios_status_block.h"  // Binary HUD status export (IOSStatusBlock)
+#include "ios_message_log.h"  // Message log with sequence ids (IOSMessageRecord)
+#include "ios_headless.h"  // Headless simulation mode (IOSHeadlessStats)
+#include "ios_travel_steps.h"  // Hero path for display-paced travel (IOSTravelStep)
+#include "ios_object_index.h"  // Floor object index (IOSTileObjectSummary)
+#include "ios_lookat_cache.h"  // Cached tile inspection (IOSLookatResult)
+#include "ios_travel_field.h"  // Travel distance field from the hero (IOSTravelField)
+#include "ios_input_journal.h"  // Input recording and deterministic replay
+#include "ios_event_bus.h"  // Batched game-to-UI events (IOSEventBatch)
+#include "ios_action_macro.h"  // Multi-step action macros (IOSMacroProgram)
+#include "ios_dungeon_overview.h"  // Visited-level overview model (DungeonLevelInfo)
+#include "ios_bridge_api.h"  // Per-frame function table bound once by Swift (IOSBridgeAPI)
+#include "../zone_allocator/nh_alloc_stats.h"  // Allocator statistics (NhAllocStats)
 extern RenderQueue *g_render_queue;
 
 // Queue operations exposed to Swift
 NETHACK_EXPORT bool render_queue_dequeue(RenderQueue *queue, RenderQueueElement *elem);
 NETHACK_EXPORT bool render_queue_is_empty(const RenderQueue *queue);
+NETHACK_EXPORT uint32_t render_queue_dequeue_bulk(RenderQueue *queue, RenderQueueElement *out, uint32_t max);
+NETHACK_EXPORT bool render_queue_read_status(RenderQueue *queue, const StatusRef *ref, StatusUpdate *out);
+NETHACK_EXPORT uint32_t render_queue_read_message(RenderQueue *queue, const MessageUpdate *msg, char *out, uint32_t max);
+NETHACK_EXPORT const char *render_queue_category_name(const RenderQueue *queue, uint32_t category);
 
 // =============================================================================
 // DISCOVERIES SYSTEM (expose NetHack's discovery tracking)
@@ -754,70 +794,8 @@ NETHACK_EXPORT bool ios_get_monster_at(int x, int y, MonsterInfo *out);
 // DUNGEON OVERVIEW SYSTEM (expose visited dungeon levels)
 // =============================================================================
 
-// Special location flags bitmask
-#define DUNGEON_FLAG_ORACLE         (1 << 0)
-#define DUNGEON_FLAG_SOKOBAN_SOLVED (1 << 1)
-#define DUNGEON_FLAG_BIGROOM        (1 << 2)
-#define DUNGEON_FLAG_CASTLE         (1 << 3)
-#define DUNGEON_FLAG_VALLEY         (1 << 4)
-#define DUNGEON_FLAG_SANCTUM        (1 << 5)
-#define DUNGEON_FLAG_LUDIOS         (1 << 6)
-#define DUNGEON_FLAG_ROGUE          (1 << 7)
-#define DUNGEON_FLAG_VIB_SQUARE     (1 << 8)
-#define DUNGEON_FLAG_QUEST_HOME     (1 << 9)
-#define DUNGEON_FLAG_QUEST_SUMMONS  (1 << 10)
-#define DUNGEON_FLAG_MINETOWN       (1 << 11)
-
-// Branch types
-#define BRANCH_TYPE_NONE       0
-#define BRANCH_TYPE_STAIRS_UP  1
-#define BRANCH_TYPE_STAIRS_DOWN 2
-#define BRANCH_TYPE_PORTAL     3
-
-// Dungeon level info structure - comprehensive level data for iOS UI
-typedef struct {
-    int dnum;                   // Dungeon number (0 = main dungeon)
-    int dlevel;                 // Level within dungeon
-    char dungeon_name[64];      // "The Dungeons of Doom", "The Gnomish Mines", etc.
-    int depth;                  // Absolute depth from surface
-
-    // Features (counts, 0-3 each due to 2-bit storage)
-    int shops;
-    int temples;
-    int altars;
-    int fountains;
-    int thrones;
-    int graves;
-    int sinks;
-    int trees;
-    int shop_type;              // Shop type if single shop
-
-    // Special location flags (bitmask of DUNGEON_FLAG_* values)
-    unsigned int special_flags;
-
-    // Player annotation (custom note)
-    char annotation[128];
-
-    // Branch connection info
-    char branch_to[64];         // Name of connected dungeon branch
-    int branch_type;            // BRANCH_TYPE_* constant
-
-    // State
-    int is_current_level;       // Player is currently here
-    int is_forgotten;           // Level has been forgotten (amnesia)
-    int has_bones;              // Known bones on this level
-} DungeonLevelInfo;
-
-// Refresh dungeon overview data (calls recalc_mapseen internally)
-NETHACK_EXPORT void ios_refresh_dungeon_overview(void);
-
-// Get total count of visited dungeon levels
-NETHACK_EXPORT int ios_get_visited_level_count(void);
-
-// Get dungeon level info by index
-// Index is 0-based, up to ios_get_visited_level_count() - 1
-// Returns false if index out of bounds
-NETHACK_EXPORT bool ios_get_dungeon_level_info(int index, DungeonLevelInfo *out);
+// Visited-level records (DungeonLevelInfo, DUNGEON_FLAG_*, BRANCH_TYPE_*) and
+// the index API: ios_dungeon_overview.h
 
 // Get count of distinct dungeons visited
 NETHACK_EXPORT int ios_get_dungeon_count(void);
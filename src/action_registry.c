@@ -62,3 +62,21 @@ const ActionDef ACTION_LOCK = {
     .nethack_func = doapply,
     .validation_flags = VALIDATION_ADJACENT | VALIDATION_NOT_SELF
 };
+
+// Indexed by ActionId
+static const ActionDef* const ACTION_TABLE[ACTION_ID_COUNT] = {
+    [ACTION_ID_KICK] = &ACTION_KICK,
+    [ACTION_ID_OPEN] = &ACTION_OPEN,
+    [ACTION_ID_CLOSE] = &ACTION_CLOSE,
+    [ACTION_ID_FIRE] = &ACTION_FIRE,
+    [ACTION_ID_THROW] = &ACTION_THROW,
+    [ACTION_ID_UNLOCK] = &ACTION_UNLOCK,
+    [ACTION_ID_LOCK] = &ACTION_LOCK
+};
+
+const ActionDef* action_registry_get(int id) {
+    if (id < 0 || id >= ACTION_ID_COUNT) {
+        return NULL;
+    }
+    return ACTION_TABLE[id];
+}
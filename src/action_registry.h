@@ -28,4 +28,20 @@ extern const ActionDef ACTION_THROW;
 extern const ActionDef ACTION_UNLOCK;
 extern const ActionDef ACTION_LOCK;
 
+// Stable action numbers for callers that name actions by value
+// (action macros, see ios_action_macro.h). Append only.
+typedef enum {
+    ACTION_ID_KICK = 0,
+    ACTION_ID_OPEN,
+    ACTION_ID_CLOSE,
+    ACTION_ID_FIRE,
+    ACTION_ID_THROW,
+    ACTION_ID_UNLOCK,
+    ACTION_ID_LOCK,
+    ACTION_ID_COUNT
+} ActionId;
+
+// Look up an action by number; NULL if out of range
+const ActionDef* action_registry_get(int id);
+
 #endif /* ACTION_REGISTRY_H */
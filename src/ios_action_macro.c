@@ -0,0 +1,232 @@
+/*
+ * ios_action_macro.c - Multi-step action macros (see ios_action_macro.h)
+ */
+
+#include "../NetHack/include/hack.h"
+#include "ios_action_macro.h"
+#include "action_registry.h"
+#include "ios_event_bus.h"
+#include "ios_input_journal.h"
+#include "ios_input_ring.h"
+#include "ios_log.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+/* Longest step: command, item, direction, answers */
+#define MACRO_STEP_KEYS_MAX (3 + IOS_MACRO_KEYS_MAX)
+
+static pthread_mutex_t macro_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IOSMacroProgram program;         /* Under macro_mutex while PENDING */
+static IOSMacroStatus status;           /* Under macro_mutex */
+static atomic_bool cancel_requested = false;
+
+/* Game thread only, while RUNNING */
+static int step_runs;                   /* Runs of the current step so far */
+static bool step_in_flight;             /* Keys queued, next command prompt not reached */
+static uint32_t step_keys_end;          /* Ring index just past the step's keys */
+static d_level start_level;
+static long start_moves;
+
+/* --- Stop conditions (game thread) --- */
+
+/* The square an ACTION step targets */
+static bool step_target(const IOSMacroStep *step, coordxy *x, coordxy *y)
+{
+    *x = u.ux + step->dx;
+    *y = u.uy + step->dy;
+    return isok(*x, *y);
+}
+
+/* The step's until condition already holds: no (more) runs */
+static bool step_satisfied(const IOSMacroStep *step)
+{
+    coordxy x, y;
+    if (step->until == IOS_MACRO_UNTIL_NONE || !step_target(step, &x, &y)) return false;
+
+    struct rm *loc = &levl[x][y];
+    switch (step->until) {
+    case IOS_MACRO_UNTIL_DOOR_OPEN:
+        return !closed_door(x, y);
+    case IOS_MACRO_UNTIL_DOOR_UNLOCKED:
+        return !IS_DOOR(loc->typ) || !(loc->doormask & D_LOCKED);
+    default:
+        return false;
+    }
+}
+
+/* Why the macro must stop before its next step, or RESULT_NONE */
+static int stop_reason(const IOSMacroProgram *p)
+{
+    if (atomic_load(&cancel_requested)) return IOS_MACRO_RESULT_CANCELLED;
+    if (program_state.gameover || !on_level(&start_level, &u.uz)) return IOS_MACRO_RESULT_LEVEL;
+    if ((p->stop_flags & IOS_MACRO_STOP_ON_HOSTILE) && monster_nearby()) {
+        return IOS_MACRO_RESULT_HOSTILE;
+    }
+    if (p->hp_stop_percent) {
+        int hp = Upolyd ? u.mh : u.uhp;
+        int hpmax = Upolyd ? u.mhmax : u.uhpmax;
+        if (hp * 100 < hpmax * p->hp_stop_percent) return IOS_MACRO_RESULT_HP;
+    }
+    return IOS_MACRO_RESULT_NONE;
+}
+
+/* --- Steps (game thread) --- */
+
+/* The keys one run of step takes; their count, or -1 if it has none */
+static int step_keys(const IOSMacroStep *step, char *out)
+{
+    int n = 0;
+    size_t extra = strnlen(step->keys, IOS_MACRO_KEYS_MAX - 1);
+
+    if (step->kind == IOS_MACRO_STEP_KEYS) {
+        if (!extra) return -1;
+        memcpy(out, step->keys, extra);
+        return (int)extra;
+    }
+    if (step->kind != IOS_MACRO_STEP_ACTION) return -1;
+
+    const ActionDef *def = action_registry_get(step->action);
+    int dir = xytod(step->dx, step->dy);
+    char cmd = def ? cmd_from_func(def->nethack_func) : 0;
+    if (!cmd || dir < 0 || dir >= N_DIRS) return -1;
+
+    out[n++] = cmd;
+    if (step->item) out[n++] = step->item;
+    out[n++] = gc.Cmd.dirchars[dir];
+    memcpy(out + n, step->keys, extra);
+    return n + (int)extra;
+}
+
+static void finish(int result)
+{
+    pthread_mutex_lock(&macro_mutex);
+    status.state = IOS_MACRO_FINISHED;
+    status.result = result;
+    status.turns = svm.moves - start_moves;
+    uint32_t id = status.id;
+    int step = status.step;
+    uint32_t commands = status.commands;
+    pthread_mutex_unlock(&macro_mutex);
+
+    step_in_flight = false;
+    atomic_store(&cancel_requested, false);
+    ios_event_post(IOS_EVENT_MACRO_DONE);
+    IOS_LOG_I(IOS_LOG_CAT_GAME, "[MACRO] #%u finished (result %d) at step %d after %u commands",
+              id, result, step, commands);
+}
+
+/* Queue the next run, moving past finished and satisfied steps */
+static void advance(void)
+{
+    const IOSMacroProgram *p = &program;   /* Fixed while RUNNING: submit refuses */
+    int step = status.step;
+
+    while (step < p->count) {
+        const IOSMacroStep *s = &p->steps[step];
+        int runs = s->runs ? s->runs : 1;
+        if (step_runs < runs && !step_satisfied(s)) break;
+        step++;
+        step_runs = 0;
+    }
+    pthread_mutex_lock(&macro_mutex);
+    status.step = step;
+    pthread_mutex_unlock(&macro_mutex);
+    if (step >= p->count) {
+        finish(IOS_MACRO_RESULT_DONE);
+        return;
+    }
+
+    char keys[MACRO_STEP_KEYS_MAX];
+    int count = step_keys(&p->steps[step], keys);
+    if (count <= 0) {
+        finish(IOS_MACRO_RESULT_INVALID);
+        return;
+    }
+    /* Keys the player typed take over; ours would run after them */
+    if (!ios_input_ring_empty() || !ios_input_ring_push_marked(keys, (size_t)count, &step_keys_end)) {
+        finish(IOS_MACRO_RESULT_CANCELLED);
+        return;
+    }
+    step_runs++;
+    step_in_flight = true;
+    pthread_mutex_lock(&macro_mutex);
+    status.commands++;
+    pthread_mutex_unlock(&macro_mutex);
+}
+
+void ios_action_macro_command_wait(void)
+{
+    pthread_mutex_lock(&macro_mutex);
+    int state = status.state;
+    pthread_mutex_unlock(&macro_mutex);
+
+    if (state == IOS_MACRO_PENDING) {
+        if (atomic_load(&cancel_requested)) {
+            finish(IOS_MACRO_RESULT_CANCELLED);
+            return;
+        }
+        if (!ios_input_ring_empty()) return;  /* The player's own keys go first */
+        assign_level(&start_level, &u.uz);
+        start_moves = svm.moves;
+        step_runs = 0;
+        step_in_flight = false;
+        pthread_mutex_lock(&macro_mutex);
+        status.state = IOS_MACRO_RUNNING;
+        pthread_mutex_unlock(&macro_mutex);
+    } else if (state != IOS_MACRO_RUNNING) {
+        return;
+    }
+
+    if (step_in_flight) {
+        /* Answers the command never asked for must not become commands;
+         * keys the player typed since stay queued */
+        step_in_flight = false;
+        ios_input_ring_discard_to(step_keys_end);
+    }
+    int reason = stop_reason(&program);
+    if (reason != IOS_MACRO_RESULT_NONE) {
+        finish(reason);
+        return;
+    }
+    advance();
+}
+
+void ios_action_macro_input_wait(void)
+{
+    if (!step_in_flight) return;
+    finish(IOS_MACRO_RESULT_PROMPT);   /* The prompt stays up for the player */
+}
+
+NETHACK_EXPORT uint32_t ios_action_macro_submit(const IOSMacroProgram *p)
+{
+    if (!p || p->count == 0 || p->count > IOS_MACRO_STEPS_MAX || ios_is_replaying()) return 0;
+
+    pthread_mutex_lock(&macro_mutex);
+    if (status.state == IOS_MACRO_PENDING || status.state == IOS_MACRO_RUNNING) {
+        pthread_mutex_unlock(&macro_mutex);
+        return 0;
+    }
+    program = *p;
+    uint32_t id = status.id + 1;
+    status = (IOSMacroStatus){ .id = id, .state = IOS_MACRO_PENDING };
+    atomic_store(&cancel_requested, false);
+    pthread_mutex_unlock(&macro_mutex);
+
+    ios_input_ring_wake();   /* A parked command wait starts it now */
+    return id;
+}
+
+NETHACK_EXPORT void ios_action_macro_cancel(void)
+{
+    atomic_store(&cancel_requested, true);
+    ios_input_ring_wake();
+}
+
+NETHACK_EXPORT void ios_action_macro_get_status(IOSMacroStatus *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&macro_mutex);
+    *out = status;
+    pthread_mutex_unlock(&macro_mutex);
+}
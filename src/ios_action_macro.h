@@ -0,0 +1,116 @@
+/*
+ * ios_action_macro.h - Multi-step action macros run inside one engine wake-up
+ *
+ * Compound UI actions (unlock then open a door, kick until it gives,
+ * search 20 times, pick up then stow) used to cost one Swift round trip
+ * per command: send the keys, wait for the turn batch, look at the result,
+ * send the next keys. A macro is a small declarative step program
+ * submitted once. The game thread runs it itself: at every command prompt
+ * it checks the stop conditions and queues the next step's keys, so the
+ * steps follow each other at engine speed and Swift hears back once, in
+ * the turn batch of the last step (IOS_EVENT_MACRO_DONE).
+ *
+ * STEPS:
+ *   KEYS    a whole command as literal keys ("s", ",", "#loot\n")
+ *   ACTION  an action_registry.h action towards (dx, dy) from the hero:
+ *           its command key, the item letter if one is given, the
+ *           direction key, then keys as the answers to its prompts
+ * A step runs its runs count of times (0 counts as 1) and stops early, or
+ * is skipped, once its until condition holds (door open, door unlocked).
+ *
+ * A macro stops before the next step when a hostile monster is next to
+ * the hero (IOS_MACRO_STOP_ON_HOSTILE), HP falls below hp_stop_percent,
+ * the hero changes level or the game ends. A step that runs into a prompt
+ * its keys do not answer also ends the macro: the prompt stays up for the
+ * player, exactly as if the keys had been typed. A key the player types
+ * while a macro runs ends it at the next command prompt: the step's
+ * unused answers are dropped, the player's keys are not. Macros never
+ * start while a journal replays (the journal already holds their keys).
+ *
+ * THREAD SAFETY: submit, cancel and status from any thread (a mutex
+ * guards the program); the command wait hooks run on the game thread.
+ */
+
+#ifndef IOS_ACTION_MACRO_H
+#define IOS_ACTION_MACRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+#define IOS_MACRO_STEPS_MAX 16
+#define IOS_MACRO_KEYS_MAX 16   /* Including the NUL */
+
+/* IOSMacroStep.kind */
+#define IOS_MACRO_STEP_KEYS   0
+#define IOS_MACRO_STEP_ACTION 1
+
+/* IOSMacroStep.until: stop repeating (or skip) once this holds at the target */
+#define IOS_MACRO_UNTIL_NONE          0
+#define IOS_MACRO_UNTIL_DOOR_OPEN     1   /* No closed door (opened, broken or gone) */
+#define IOS_MACRO_UNTIL_DOOR_UNLOCKED 2   /* No locked door */
+
+/* IOSMacroProgram.stop_flags */
+#define IOS_MACRO_STOP_ON_HOSTILE 0x01u
+
+/* IOSMacroStatus.state */
+#define IOS_MACRO_IDLE     0
+#define IOS_MACRO_PENDING  1   /* Submitted, waiting for the next command prompt */
+#define IOS_MACRO_RUNNING  2
+#define IOS_MACRO_FINISHED 3
+
+/* IOSMacroStatus.result */
+#define IOS_MACRO_RESULT_NONE      0
+#define IOS_MACRO_RESULT_DONE      1   /* Every step ran */
+#define IOS_MACRO_RESULT_HOSTILE   2
+#define IOS_MACRO_RESULT_HP        3
+#define IOS_MACRO_RESULT_PROMPT    4   /* A step waits for an answer it did not carry */
+#define IOS_MACRO_RESULT_LEVEL     5   /* Level changed or the game ended */
+#define IOS_MACRO_RESULT_CANCELLED 6
+#define IOS_MACRO_RESULT_INVALID   7   /* A step could not be turned into keys */
+
+typedef struct {
+    uint8_t kind;                       /* IOS_MACRO_STEP_* */
+    uint8_t action;                     /* ACTION: ActionId (action_registry.h) */
+    int8_t dx, dy;                      /* ACTION: direction from the hero */
+    char item;                          /* ACTION: inventory letter, 0 = none */
+    uint8_t until;                      /* IOS_MACRO_UNTIL_* */
+    uint16_t runs;                      /* Times to run, 0 = 1 */
+    char keys[IOS_MACRO_KEYS_MAX];      /* KEYS: the command; ACTION: prompt answers */
+} IOSMacroStep;
+
+typedef struct {
+    IOSMacroStep steps[IOS_MACRO_STEPS_MAX];
+    uint8_t count;
+    uint8_t stop_flags;                 /* IOS_MACRO_STOP_ON_* */
+    uint8_t hp_stop_percent;            /* Stop below this share of max HP, 0 = never */
+} IOSMacroProgram;
+
+typedef struct {
+    uint32_t id;                        /* Of the latest submitted macro (0 = none yet) */
+    int32_t state;                      /* IOS_MACRO_* */
+    int32_t result;                     /* IOS_MACRO_RESULT_* once FINISHED */
+    int32_t step;                       /* Step index reached */
+    uint32_t commands;                  /* Commands queued so far */
+    int64_t turns;                      /* Game turns the macro took */
+} IOSMacroStatus;
+
+/*
+ * Queue a macro for the next command prompt. Returns its id, or 0 if one
+ * is still pending or running, the program is empty or too long, or a
+ * journal is replaying.
+ */
+NETHACK_EXPORT uint32_t ios_action_macro_submit(const IOSMacroProgram *program);
+
+/* Stop the macro before its next step (the running command finishes) */
+NETHACK_EXPORT void ios_action_macro_cancel(void);
+
+NETHACK_EXPORT void ios_action_macro_get_status(IOSMacroStatus *out);
+
+/* Game thread, at a command key wait: stop or queue the next step */
+void ios_action_macro_command_wait(void);
+
+/* Game thread, at every input wait: a step in flight ran out of keys */
+void ios_action_macro_input_wait(void);
+
+#endif /* IOS_ACTION_MACRO_H */
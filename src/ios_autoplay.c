@@ -8,6 +8,8 @@
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/flag.h"
 #include "nethack_export.h"  // For NETHACK_EXPORT
+#include "ios_headless.h"    // --headless
+#include "ios_input_journal.h" // --record
 
 /* External declarations */
 extern struct flag flags;
@@ -66,6 +68,16 @@ void ios_parse_debug_flags(const char *flagstr) {
         fflush(stderr);
     }
 
+    if (strstr(flagstr, "--headless")) {
+        /* Bots/soak runs: no rendering or travel pacing, turns at CPU speed */
+        ios_set_headless(1);
+    }
+
+    if (strstr(flagstr, "--record")) {
+        /* Journal this game for ios_replay_start (saved with ios_journal_save) */
+        ios_journal_start();
+    }
+
     if (strstr(flagstr, "--wizard")) {
         fprintf(stderr, "[IOS_AUTO] Enabling wizard mode\n");
         flags.debug = 1;
@@ -0,0 +1,57 @@
+/*
+ * ios_bridge_api.c - Function pointer table for the Swift bridge
+ * (see ios_bridge_api.h)
+ */
+
+#include "ios_bridge_api.h"
+#include "ios_frame_timing.h"
+#include "ios_game_state_buffer.h"
+#include "ios_kill_stats.h"
+#include "ios_message_log.h"
+
+/* Swift mirrors GameStateSnapshot itself and passes raw storage */
+static bool game_state_snapshot_if_newer(void *out, uint32_t *last_version)
+{
+    return ios_get_game_state_snapshot_if_newer((GameStateSnapshot *)out, last_version);
+}
+
+static const IOSBridgeAPI bridge_api = {
+    .version = IOS_BRIDGE_API_VERSION,
+    .size = sizeof(IOSBridgeAPI),
+
+    .get_render_queue = ios_get_render_queue,
+    .render_queue_dequeue_bulk = render_queue_dequeue_bulk,
+    .render_queue_read_glyph_batch = render_queue_read_glyph_batch,
+    .render_queue_read_status = render_queue_read_status,
+    .render_queue_read_message = render_queue_read_message,
+    .render_queue_category_name = render_queue_category_name,
+    .render_queue_is_empty = render_queue_is_empty,
+
+    .map_export_get = ios_map_export_get,
+    .map_export_begin_read = ios_map_export_begin_read,
+    .map_export_end_read = ios_map_export_end_read,
+    .map_export_dirty_rows = ios_map_export_dirty_rows,
+
+    .frame_timing_record = ios_frame_timing_record,
+    .frame_timing_frame_presented = ios_frame_timing_frame_presented,
+
+    .get_game_state_snapshot_if_newer = game_state_snapshot_if_newer,
+    .get_read_model_if_newer = ios_get_read_model_if_newer,
+    .get_status_block_if_newer = ios_get_status_block_if_newer,
+    .get_glyph_table = ios_get_glyph_table,
+
+    .message_log_fetch_since = ios_message_log_fetch_since,
+    .message_log_last_seq = ios_message_log_last_seq,
+    .travel_steps_drain = ios_travel_steps_drain,
+    .travel_steps_dropped = ios_travel_steps_dropped,
+    .get_tile_object_summary = ios_get_tile_object_summary,
+    .object_index_generation = ios_object_index_generation,
+    .kill_stats_generation = ios_kill_stats_generation,
+
+    .glyph_table_generation = ios_get_glyph_table_generation,
+};
+
+const IOSBridgeAPI *ios_bridge_api(void)
+{
+    return &bridge_api;
+}
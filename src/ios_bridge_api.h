@@ -0,0 +1,81 @@
+/*
+ * ios_bridge_api.h - One table of function pointers for the Swift bridge
+ *
+ * NetHackBridge resolves each C function lazily through dlsym and checks
+ * the dylib on every call. For the calls made every frame or every turn
+ * (render queue drain, map export, frame timing, snapshots, logs) Swift
+ * instead fetches this table once after loading the dylib and calls
+ * through it directly.
+ *
+ * VERSIONING: fields are only ever appended. A new field bumps
+ * IOS_BRIDGE_API_VERSION; the bridge accepts a table whose version and
+ * size are at least what it was built against. Entries are never NULL.
+ *
+ * LIFETIME: static storage in the dylib - valid until dlclose.
+ */
+
+#ifndef IOS_BRIDGE_API_H
+#define IOS_BRIDGE_API_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+#include "ios_render_queue.h"
+#include "ios_map_export.h"
+#include "ios_glyph_table.h"
+#include "ios_read_model.h"
+#include "ios_status_block.h"
+#include "ios_travel_steps.h"
+#include "ios_object_index.h"
+
+#define IOS_BRIDGE_API_VERSION 2
+
+typedef struct {
+    uint32_t version;           /* IOS_BRIDGE_API_VERSION of the dylib */
+    uint32_t size;              /* sizeof(IOSBridgeAPI) in the dylib */
+
+    /* Render queue */
+    RenderQueue *(*get_render_queue)(void);
+    uint32_t (*render_queue_dequeue_bulk)(RenderQueue *queue, RenderQueueElement *out, uint32_t max);
+    uint32_t (*render_queue_read_glyph_batch)(RenderQueue *queue, const GlyphBatchUpdate *batch,
+                                              MapUpdate *out, uint32_t max);
+    bool (*render_queue_read_status)(RenderQueue *queue, const StatusRef *ref, StatusUpdate *out);
+    uint32_t (*render_queue_read_message)(RenderQueue *queue, const MessageUpdate *msg,
+                                          char *out, uint32_t max);
+    const char *(*render_queue_category_name)(const RenderQueue *queue, uint32_t category);
+    bool (*render_queue_is_empty)(const RenderQueue *queue);
+
+    /* Binary map export */
+    const MapExport *(*map_export_get)(void);
+    uint32_t (*map_export_begin_read)(void);
+    bool (*map_export_end_read)(uint32_t seq);
+    uint32_t (*map_export_dirty_rows)(uint32_t since_version);
+
+    /* Frame timing */
+    void (*frame_timing_record)(int stage, uint64_t duration_ns);
+    void (*frame_timing_frame_presented)(void);
+
+    /* Versioned snapshots (out untouched and false when unchanged) */
+    bool (*get_game_state_snapshot_if_newer)(void *out, uint32_t *last_version);
+    bool (*get_read_model_if_newer)(GameReadModel *out, uint32_t *last_version);
+    bool (*get_status_block_if_newer)(IOSStatusBlock *out, uint32_t *counter);
+    const GlyphRenderInfo *(*get_glyph_table)(uint32_t *count, uint32_t *generation);
+
+    /* Logs and per-turn state */
+    int (*message_log_fetch_since)(uint64_t after_seq, void *buf, size_t buf_size);
+    uint64_t (*message_log_last_seq)(void);
+    uint32_t (*travel_steps_drain)(IOSTravelStep *out, uint32_t max);
+    uint32_t (*travel_steps_dropped)(void);
+    int (*get_tile_object_summary)(int x, int y, IOSTileObjectSummary *out);
+    uint32_t (*object_index_generation)(void);
+    uint32_t (*kill_stats_generation)(void);
+
+    /* Version 2 */
+    uint32_t (*glyph_table_generation)(void);
+} IOSBridgeAPI;
+
+/* The table; call once after dlopen and keep the pointer */
+NETHACK_EXPORT const IOSBridgeAPI *ios_bridge_api(void);
+
+#endif /* IOS_BRIDGE_API_H */
@@ -23,6 +23,11 @@
 #include "../NetHack/include/hack.h"
 #include "nethack_export.h"
 #include "ios_character_save.h"
+#include "ios_level_store.h"
+#include "ios_file_copy.h"
+#include "ios_save_manifest.h"
+#include "ios_save_index.h"
+#include "ios_hibernate.h"
 
 #define CHAR_SAVE_LOG(fmt, ...) fprintf(stderr, "[CHAR_SAVE] " fmt "\n", ##__VA_ARGS__)
 
@@ -264,40 +269,7 @@ static int ensure_character_dir(const char* character_name) {
         // Verified: It's a directory - continue as success
     }
 
-    return 1;
-}
-
-/*
- * Copy a file
- */
-static int copy_file(const char *src, const char *dest) {
-    FILE *src_fp = fopen(src, "rb");
-    if (!src_fp) {
-        CHAR_SAVE_LOG("Failed to open source file: %s", src);
-        return 0;
-    }
-
-    FILE *dest_fp = fopen(dest, "wb");
-    if (!dest_fp) {
-        fclose(src_fp);
-        CHAR_SAVE_LOG("Failed to open dest file: %s", dest);
-        return 0;
-    }
-
-    // Copy in 64KB chunks
-    char buffer[65536];
-    size_t bytes;
-
-    while ((bytes = fread(buffer, 1, sizeof(buffer), src_fp)) > 0) {
-        if (fwrite(buffer, 1, bytes, dest_fp) != bytes) {
-            fclose(src_fp);
-            fclose(dest_fp);
-            return 0;
-        }
-    }
-
-    fclose(src_fp);
-    fclose(dest_fp);
+    ios_save_index_add_character(get_characters_root(), sanitize_character_name(character_name));
     return 1;
 }
 
@@ -333,8 +305,9 @@ static const char* json_get_string(const char* json, const char* key) {
  * Generate metadata.json for a character's save
  * Preserves existing timestamps (created_at, synced_at, downloaded_at)
  * Swift manages synced_at/downloaded_at - C only writes created_at and updated_at
+ * Also fills *entry with the same summary for the save index
  */
-static int generate_metadata(const char* character_name) {
+static int generate_metadata(const char* character_name, IosSaveIndexEntry *entry) {
     char char_path[512];
     char metadata_path[512];
 
@@ -440,6 +413,15 @@ static int generate_metadata(const char* character_name) {
 
     fclose(fp);
 
+    snprintf(entry->character, sizeof(entry->character), "%s", sanitize_character_name(character_name));
+    entry->slot_id = 0;
+    entry->level = u.ulevel;
+    entry->dungeon_level = u.uz.dlevel;
+    entry->turns = svm.moves;
+    entry->last_saved = (int64_t)now;
+    snprintf(entry->role, sizeof(entry->role), "%s", gu.urole.name.m);
+    snprintf(entry->race, sizeof(entry->race), "%s", gu.urace.noun);
+
     CHAR_SAVE_LOG("  ✓ Metadata written to: %s", metadata_path);
     CHAR_SAVE_LOG("Generated metadata for character: %s (Level %d %s %s)",
                   character_name, u.ulevel, gu.urace.noun, gu.urole.name.m);
@@ -470,7 +452,8 @@ NETHACK_EXPORT int ios_save_character(const char* character_name) {
     // ios_quicksave() exits moveloop which can corrupt u.ulevel, svp.plname etc.
     // We MUST capture metadata BEFORE the save sequence begins!
     CHAR_SAVE_LOG("  Step 0: CRITICAL - Generate metadata BEFORE ios_quicksave()");
-    if (!generate_metadata(character_name)) {
+    IosSaveIndexEntry index_entry = {0};
+    if (!generate_metadata(character_name, &index_entry)) {
         CHAR_SAVE_LOG("WARNING: Failed to generate metadata (non-fatal)");
         // Don't fail save for metadata, but this is a bug!
     }
@@ -488,6 +471,11 @@ NETHACK_EXPORT int ios_save_character(const char* character_name) {
         CHAR_SAVE_LOG("ERROR: ios_quicksave() failed");
         return 0;
     }
+    extern int ios_save_wait_for_writer(void);  // Commit runs in the background
+    if (ios_save_wait_for_writer() != 0) {
+        CHAR_SAVE_LOG("ERROR: Background save commit failed");
+        return 0;
+    }
     CHAR_SAVE_LOG("  ✓ Current game state saved to /save/savegame");
 
     // Step 2: Copy to character-specific path
@@ -521,12 +509,30 @@ NETHACK_EXPORT int ios_save_character(const char* character_name) {
     }
 
     CHAR_SAVE_LOG("  Step 2: Copying savegame to character directory");
-    if (!copy_file(src_game, dest_game)) {
-        CHAR_SAVE_LOG("ERROR: Failed to copy savegame file");
+    // Level chunks first: savegame references them (see ios_level_store.h)
+    char src_save_dir[512];
+    snprintf(src_save_dir, sizeof(src_save_dir), "%s/save", docs_path);
+    if (ios_level_store_copy_dir(src_save_dir, char_path) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy level chunks");
+        return 0;
+    }
+    ios_save_manifest_remove(dest_game);  // Never pair the new savegame with the old manifest
+    if (ios_file_copy(src_game, dest_game) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy savegame file: %s", strerror(errno));
+        return 0;
+    }
+    if (ios_save_manifest_copy(src_game, dest_game) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy save manifest: %s", strerror(errno));
         return 0;
     }
     CHAR_SAVE_LOG("  ✓ Savegame copied to %s", dest_game);
 
+    // The index row only claims a save once the savegame is in place
+    if (index_entry.character[0] != '\0') {
+        index_entry.flags = IOS_SAVE_INDEX_HAS_SAVE;
+        ios_save_index_put(get_characters_root(), &index_entry);
+    }
+
     // Step 3: Metadata already generated in Step 0!
     CHAR_SAVE_LOG("  Step 3: Metadata already generated in Step 0 (skipping)");
     // OLD CODE (REMOVED): generate_metadata() was called HERE - TOO LATE!
@@ -586,14 +592,26 @@ NETHACK_EXPORT int ios_load_character(const char* character_name) {
     }
 
     CHAR_SAVE_LOG("  Step 1: Copying character savegame to /save/savegame");
-    if (!copy_file(src_game, dest_game)) {
-        CHAR_SAVE_LOG("ERROR: Failed to copy savegame file");
+    char dest_save_dir[512];
+    snprintf(dest_save_dir, sizeof(dest_save_dir), "%s/save", docs_path);
+    if (ios_level_store_copy_dir(char_path, dest_save_dir) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy level chunks");
+        return 0;
+    }
+    ios_save_manifest_remove(dest_game);  // Never pair the new savegame with the old manifest
+    if (ios_file_copy(src_game, dest_game) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy savegame file: %s", strerror(errno));
+        return 0;
+    }
+    if (ios_save_manifest_copy(src_game, dest_game) != 0) {
+        CHAR_SAVE_LOG("ERROR: Failed to copy save manifest: %s", strerror(errno));
         return 0;
     }
     CHAR_SAVE_LOG("  ✓ Savegame copied to %s", dest_game);
 
     // Step 2: Load from /save/savegame (ios_quickrestore does the heavy lifting)
     CHAR_SAVE_LOG("  Step 2: Calling ios_quickrestore() to load game");
+    ios_hibernate_expect(character_name);  // Another character's image must not resume
     if (ios_quickrestore() != 0) {
         CHAR_SAVE_LOG("ERROR: ios_quickrestore() failed");
         return 0;
@@ -639,6 +657,7 @@ NETHACK_EXPORT int ios_delete_character_save(const char* character_name) {
     }
 
     CHAR_SAVE_LOG("Deleting save for character: %s", character_name);
+    ios_level_store_remove(char_path);
 
     // Delete all files in character directory
     DIR *dir = opendir(char_path);
@@ -665,6 +684,9 @@ NETHACK_EXPORT int ios_delete_character_save(const char* character_name) {
         return 0;
     }
 
+    ios_save_index_remove(get_characters_root(), sanitize_character_name(character_name),
+                          IOS_SAVE_INDEX_ALL_SLOTS);
+
     CHAR_SAVE_LOG("✅ Save deleted for character: %s", character_name);
     return 1;
 }
@@ -681,73 +703,40 @@ NETHACK_EXPORT char** ios_list_saved_characters(int *count) {
         return NULL;
     }
 
-    DIR *dir = opendir(root);
-    if (!dir) {
-        return NULL;
-    }
+    // Character rows (slot_id 0) whose savegame is present, from the index
+    IosSaveIndexEntry *entries = NULL;
+    int num_entries = ios_save_index_read(root, &entries);
 
-    // First pass: count characters
     int num_chars = 0;
-    struct dirent *entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        // Check if it's a directory
-        char char_path[512];
-        snprintf(char_path, sizeof(char_path), "%s/%s", root, entry->d_name);
-        struct stat st;
-        if (stat(char_path, &st) == 0 && S_ISDIR(st.st_mode)) {
-            // Check if it has a savegame file
-            char savegame_path[512];
-            snprintf(savegame_path, sizeof(savegame_path), "%s/savegame", char_path);
-            if (access(savegame_path, F_OK) == 0) {
-                num_chars++;
-            }
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id == 0 && (entries[i].flags & IOS_SAVE_INDEX_HAS_SAVE)) {
+            num_chars++;
         }
     }
 
     if (num_chars == 0) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
     // Allocate array of string pointers
     char **characters = malloc(num_chars * sizeof(char*));
     if (!characters) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
-    // Second pass: collect character names
-    rewinddir(dir);
     int index = 0;
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        // Check if it's a directory with savegame
-        char char_path[512];
-        snprintf(char_path, sizeof(char_path), "%s/%s", root, entry->d_name);
-        struct stat st;
-        if (stat(char_path, &st) == 0 && S_ISDIR(st.st_mode)) {
-            char savegame_path[512];
-            snprintf(savegame_path, sizeof(savegame_path), "%s/savegame", char_path);
-            if (access(savegame_path, F_OK) == 0) {
-                // Allocate and copy character name
-                characters[index] = strdup(entry->d_name);
-                if (characters[index]) {
-                    index++;
-                }
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id == 0 && (entries[i].flags & IOS_SAVE_INDEX_HAS_SAVE)) {
+            characters[index] = strdup(entries[i].character);
+            if (characters[index]) {
+                index++;
             }
         }
     }
 
-    closedir(dir);
+    ios_save_index_release(entries);
 
     *count = index;
     CHAR_SAVE_LOG("Found %d saved characters", index);
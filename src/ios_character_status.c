@@ -389,6 +389,8 @@ NETHACK_EXPORT unsigned long ios_get_condition_mask(void) {
  * ==========================================================================
  * Returns all character status information as a single JSON object.
  * This is more efficient than multiple individual calls from Swift.
+ * Per-frame consumers should use the read model (ios_read_model.h) or
+ * IOSStatusBlock (ios_status_block.h) instead.
  */
 
 NETHACK_EXPORT const char* ios_get_character_status_json(void) {
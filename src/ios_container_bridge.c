@@ -14,6 +14,7 @@
 #include <string.h>
 #include <pthread.h>
 #include "ios_container_bridge.h"
+#include "ios_object_index.h"
 #include "../NetHack/include/hack.h"
 
 /* External declarations */
@@ -41,20 +42,7 @@ static pthread_mutex_t container_mutex = PTHREAD_MUTEX_INITIALIZER;
 static struct obj *ios_current_container = NULL;
 
 /*
- * Find object by o_id in a chain
- */
-static struct obj *find_obj_in_chain(struct obj *chain, unsigned int o_id) {
-    struct obj *obj;
-    for (obj = chain; obj; obj = obj->nobj) {
-        if (obj->o_id == o_id) {
-            return obj;
-        }
-    }
-    return NULL;
-}
-
-/*
- * Find object by o_id on floor at position
+ * Find object by o_id on floor at position (o_id index, then position check)
  */
 static struct obj *find_floor_obj(int x, int y, unsigned int o_id) {
     struct obj *obj;
@@ -63,12 +51,11 @@ static struct obj *find_floor_obj(int x, int y, unsigned int o_id) {
         return NULL;
     }
 
-    for (obj = svl.level.objects[x][y]; obj; obj = obj->nexthere) {
-        if (obj->o_id == o_id) {
-            return obj;
-        }
+    obj = ios_object_index_find(o_id);
+    if (!obj || obj->where != OBJ_FLOOR || obj->ox != x || obj->oy != y) {
+        return NULL;
     }
-    return NULL;
+    return obj;
 }
 
 /*
@@ -118,6 +105,14 @@ NETHACK_EXPORT int ios_get_floor_containers_at_player(IOSFloorContainerInfo *buf
         return 0;
     }
 
+    /* Most squares have no container: answer from the tile summary */
+    IOSTileObjectSummary summary;
+    ios_get_tile_object_summary(u.ux, u.uy, &summary);
+    if (!(summary.flags & IOS_TILE_HAS_CONTAINER)) {
+        pthread_mutex_unlock(&container_mutex);
+        return 0;
+    }
+
     /* Iterate floor objects at player position */
     for (obj = svl.level.objects[u.ux][u.uy]; obj && count < max; obj = obj->nexthere) {
         if (!Is_container(obj)) {
@@ -0,0 +1,215 @@
+/*
+ * ios_coroutine.c - Stack switching (see ios_coroutine.h)
+ *
+ * ios_coroutine_switch(&save_sp, load_sp) pushes the callee-saved state
+ * onto the current stack, stores sp, loads the other sp and pops its
+ * state. A fresh stack is laid out as if it had been switched away from
+ * inside coroutine_trampoline, which then calls coroutine_main(co).
+ *
+ * Saved frame (low to high):
+ *   arm64:  x19..x28, x29, x30 (return address), d8..d15   - 160 bytes
+ *   x86_64: mxcsr + x87 cw, r15, r14, r13, r12, rbx, rbp, return - 64 bytes
+ */
+
+#include "ios_coroutine.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#define CO_SYM(name) "_" #name
+#else
+#define CO_SYM(name) #name
+#endif
+
+struct IOSCoroutine {
+    void *sp;                   /* Saved sp while not running */
+    void *caller_sp;            /* Saved sp of the resumer while running */
+    IOSCoroutine *previous;     /* Coroutine the resumer was running on, if any */
+    ios_coroutine_entry entry;
+    void *arg;
+    void *mapping;
+    size_t mapping_size;
+    bool finished;
+};
+
+void ios_coroutine_switch(void **save_sp, void *load_sp);
+void ios_coroutine_trampoline(void);
+
+static _Thread_local IOSCoroutine *current;
+
+#if defined(__aarch64__)
+
+__asm__(
+    ".text\n"
+    ".p2align 2\n"
+    ".globl " CO_SYM(ios_coroutine_switch) "\n"
+    CO_SYM(ios_coroutine_switch) ":\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".globl " CO_SYM(ios_coroutine_trampoline) "\n"
+    CO_SYM(ios_coroutine_trampoline) ":\n"
+    "    mov x0, x19\n"
+    "    bl " CO_SYM(coroutine_main) "\n"
+    "    brk #0\n"
+);
+
+#define FRAME_SIZE 160
+
+static void seed_frame(uintptr_t *frame, IOSCoroutine *co)
+{
+    frame[0] = (uintptr_t)co;                              /* x19 */
+    frame[10] = 0;                                         /* x29: end of frame chain */
+    frame[11] = (uintptr_t)ios_coroutine_trampoline;       /* x30 */
+}
+
+#elif defined(__x86_64__)
+
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".globl " CO_SYM(ios_coroutine_switch) "\n"
+    CO_SYM(ios_coroutine_switch) ":\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".globl " CO_SYM(ios_coroutine_trampoline) "\n"
+    CO_SYM(ios_coroutine_trampoline) ":\n"
+    "    movq %r12, %rdi\n"
+    "    call " CO_SYM(coroutine_main) "\n"
+    "    ud2\n"
+);
+
+#define FRAME_SIZE 64
+
+static void seed_frame(uintptr_t *frame, IOSCoroutine *co)
+{
+    frame[0] = 0x037F00001F80ULL;                          /* Default x87 cw : mxcsr */
+    frame[4] = (uintptr_t)co;                              /* r12 */
+    frame[6] = 0;                                          /* rbp */
+    frame[7] = (uintptr_t)ios_coroutine_trampoline;        /* return address */
+}
+
+#else
+#error "ios_coroutine: unsupported architecture"
+#endif
+
+/* Called on the coroutine's own stack by the trampoline; never returns */
+__attribute__((used, noreturn)) void coroutine_main(IOSCoroutine *co);
+
+void coroutine_main(IOSCoroutine *co)
+{
+    co->entry(co->arg);
+    co->finished = true;
+    for (;;) {
+        ios_coroutine_yield();  /* Resuming a finished coroutine just returns */
+    }
+}
+
+IOSCoroutine *ios_coroutine_create(ios_coroutine_entry entry, void *arg, size_t stack_size)
+{
+    if (!entry) return NULL;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = ((stack_size + page - 1) / page + 1) * page;  /* + guard page */
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (mapping == MAP_FAILED) return NULL;
+    mprotect(mapping, page, PROT_NONE);  /* Overflow faults instead of corrupting */
+
+    IOSCoroutine *co = calloc(1, sizeof(*co));
+    if (!co) {
+        munmap(mapping, size);
+        return NULL;
+    }
+    co->entry = entry;
+    co->arg = arg;
+    co->mapping = mapping;
+    co->mapping_size = size;
+
+    uintptr_t top = ((uintptr_t)mapping + size) & ~(uintptr_t)15;
+    uintptr_t *frame = (uintptr_t *)(top - FRAME_SIZE);
+    memset(frame, 0, FRAME_SIZE);
+    seed_frame(frame, co);
+    co->sp = frame;
+    return co;
+}
+
+bool ios_coroutine_resume(IOSCoroutine *co)
+{
+    if (!co || co->finished || co == current) return co && !co->finished;
+
+    co->previous = current;
+    current = co;
+    ios_coroutine_switch(&co->caller_sp, co->sp);
+    current = co->previous;
+    co->previous = NULL;
+    return !co->finished;
+}
+
+void ios_coroutine_yield(void)
+{
+    IOSCoroutine *co = current;
+    if (!co) return;  /* Not on a coroutine: nothing to yield to */
+    ios_coroutine_switch(&co->sp, co->caller_sp);
+}
+
+IOSCoroutine *ios_coroutine_current(void)
+{
+    return current;
+}
+
+bool ios_coroutine_finished(const IOSCoroutine *co)
+{
+    return !co || co->finished;
+}
+
+void ios_coroutine_destroy(IOSCoroutine *co)
+{
+    if (!co || co == current) return;
+    munmap(co->mapping, co->mapping_size);
+    free(co);
+}
@@ -0,0 +1,44 @@
+/*
+ * ios_coroutine.h - Minimal stackful coroutines (one level, no scheduler)
+ *
+ * A coroutine runs entry(arg) on its own mmap'd stack. resume() switches
+ * to it and returns when it calls ios_coroutine_yield() or entry returns;
+ * the next resume() continues after the yield. Used to run moveloop() as
+ * a resumable step (ios_game_step.h) instead of parking a thread in it.
+ *
+ * Context switch is a few lines of assembly saving the callee-saved
+ * registers (arm64, x86_64): ucontext is deprecated on Apple platforms and
+ * not implemented on arm64.
+ *
+ * THREAD SAFETY: a coroutine may be resumed from any thread, but only from
+ * one at a time, and never from inside itself.
+ */
+
+#ifndef IOS_COROUTINE_H
+#define IOS_COROUTINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct IOSCoroutine IOSCoroutine;
+
+typedef void (*ios_coroutine_entry)(void *arg);
+
+/* Stack size includes one guard page below it; NULL if mapping failed */
+IOSCoroutine *ios_coroutine_create(ios_coroutine_entry entry, void *arg, size_t stack_size);
+
+/* Run until the next yield or until entry returns; true while not finished */
+bool ios_coroutine_resume(IOSCoroutine *co);
+
+/* From inside a coroutine: switch back to whoever resumed it */
+void ios_coroutine_yield(void);
+
+/* Coroutine the calling code is running on (NULL on a normal thread stack) */
+IOSCoroutine *ios_coroutine_current(void);
+
+bool ios_coroutine_finished(const IOSCoroutine *co);
+
+/* Unmap a coroutine that is not running (finished, or parked in a yield) */
+void ios_coroutine_destroy(IOSCoroutine *co);
+
+#endif /* IOS_COROUTINE_H */
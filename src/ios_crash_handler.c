@@ -1,9 +1,11 @@
 #include "ios_crash_handler.h"
+#include "ios_log.h"
 #include <signal.h>
 #include <execinfo.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 static const char* last_operation = "unknown";
 static const char* last_file = "unknown";
@@ -38,6 +40,10 @@ static void crash_handler(int sig) {
     fprintf(stderr, "File: %s\n", last_file);
     fprintf(stderr, "Line: %d\n", last_line);
     fprintf(stderr, "========================================\n");
+    fflush(stderr);
+
+    // Recent diagnostics that were kept in memory instead of printed
+    ios_log_flush_fd(STDERR_FILENO);
 
     void* callstack[128];
     int frames = backtrace(callstack, 128);
@@ -0,0 +1,325 @@
+/*
+ * ios_dungeon_overview.c - Visited-level overview model
+ * (see ios_dungeon_overview.h)
+ *
+ * Records are kept in mapseen chain order. NetHack only ever inserts into
+ * the chain (on first arrival), so a chain longer than the table means a
+ * new level and a shorter or reordered one means another game: both
+ * rebuild the whole table.
+ */
+
+#include "ios_dungeon_overview.h"
+#include "../NetHack/include/hack.h"
+#include "ios_input_ring.h"
+#include "ios_log.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+static pthread_mutex_t overview_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic uint32_t generation = 0;
+static atomic_bool need_recalc = true;  /* recalc_mapseen() before the next update */
+
+static DungeonLevelInfo *records;       /* Under overview_mutex */
+static int record_count;
+static int record_capacity;
+
+/* Game thread only */
+static d_level synced_level;            /* Level the last update ran on */
+static bool synced;
+static int last_room = -1;              /* u.urooms[0] at the last update */
+static uint8_t feature_seen[COLNO][ROWNO];  /* Feature cmap + 1 last shown here (0 = none) */
+
+/* --- Records --- */
+
+static void fill_record(const mapseen *mptr, DungeonLevelInfo *out)
+{
+    memset(out, 0, sizeof(DungeonLevelInfo));
+
+    /* Basic level info */
+    out->dnum = mptr->lev.dnum;
+    out->dlevel = mptr->lev.dlevel;
+
+    /* Dungeon name */
+    if (mptr->lev.dnum >= 0 && mptr->lev.dnum < svn.n_dgns) {
+        strncpy(out->dungeon_name, svd.dungeons[mptr->lev.dnum].dname,
+                sizeof(out->dungeon_name) - 1);
+    }
+
+    /* Calculate depth - quest and Ludios count from their own entry */
+    int depthstart;
+    if (mptr->lev.dnum == quest_dnum || mptr->lev.dnum == knox_level.dnum) {
+        depthstart = 1;
+    } else if (mptr->lev.dnum >= 0 && mptr->lev.dnum < svn.n_dgns) {
+        depthstart = svd.dungeons[mptr->lev.dnum].depth_start;
+    } else {
+        depthstart = 1;
+    }
+    out->depth = depthstart + mptr->lev.dlevel - 1;
+
+    /* Features */
+    out->shops = mptr->feat.nshop;
+    out->temples = mptr->feat.ntemple;
+    out->altars = mptr->feat.naltar;
+    out->fountains = mptr->feat.nfount;
+    out->thrones = mptr->feat.nthrone;
+    out->graves = mptr->feat.ngrave;
+    out->sinks = mptr->feat.nsink;
+    out->trees = mptr->feat.ntree;
+    out->shop_type = mptr->feat.shoptype;
+
+    /* Special location flags */
+    unsigned int flags = 0;
+    if (mptr->flags.oracle) flags |= DUNGEON_FLAG_ORACLE;
+    if (mptr->flags.sokosolved) flags |= DUNGEON_FLAG_SOKOBAN_SOLVED;
+    if (mptr->flags.bigroom) flags |= DUNGEON_FLAG_BIGROOM;
+    if (mptr->flags.castle) flags |= DUNGEON_FLAG_CASTLE;
+    if (mptr->flags.valley) flags |= DUNGEON_FLAG_VALLEY;
+    if (mptr->flags.msanctum) flags |= DUNGEON_FLAG_SANCTUM;
+    if (mptr->flags.ludios) flags |= DUNGEON_FLAG_LUDIOS;
+    if (mptr->flags.roguelevel) flags |= DUNGEON_FLAG_ROGUE;
+    if (mptr->flags.vibrating_square) flags |= DUNGEON_FLAG_VIB_SQUARE;
+    if (mptr->flags.questing) flags |= DUNGEON_FLAG_QUEST_HOME;
+    if (mptr->flags.quest_summons) flags |= DUNGEON_FLAG_QUEST_SUMMONS;
+    out->special_flags = flags;
+
+    /* Player annotation */
+    if (mptr->custom) {
+        strncpy(out->annotation, mptr->custom, sizeof(out->annotation) - 1);
+    }
+
+    /* Branch connection */
+    if (mptr->br) {
+        int end_dnum = mptr->br->end2.dnum;
+        if (end_dnum >= 0 && end_dnum < svn.n_dgns) {
+            strncpy(out->branch_to, svd.dungeons[end_dnum].dname,
+                    sizeof(out->branch_to) - 1);
+        }
+        switch (mptr->br->type) {
+        case BR_PORTAL:
+            out->branch_type = BRANCH_TYPE_PORTAL;
+            break;
+        case BR_STAIR:
+            out->branch_type = mptr->br->end1_up ? BRANCH_TYPE_STAIRS_UP
+                                                 : BRANCH_TYPE_STAIRS_DOWN;
+            break;
+        default:
+            out->branch_type = BRANCH_TYPE_NONE;
+            break;
+        }
+    }
+
+    /* State */
+    out->is_current_level = on_level(&mptr->lev, &u.uz) ? 1 : 0;
+    out->is_forgotten = mptr->flags.forgot ? 1 : 0;
+    out->has_bones = (mptr->final_resting_place != NULL || mptr->flags.knownbones) ? 1 : 0;
+}
+
+/* Caller holds overview_mutex; false if out of memory */
+static bool reserve(int count)
+{
+    if (count <= record_capacity) return true;
+    int want = record_capacity ? record_capacity : 64;
+    while (want < count) want *= 2;
+
+    DungeonLevelInfo *grown = realloc(records, (size_t)want * sizeof(DungeonLevelInfo));
+    if (!grown) return false;
+    records = grown;
+    record_capacity = want;
+    return true;
+}
+
+/* Everything but the current level only changes through these */
+static bool state_matches(const mapseen *mptr, const DungeonLevelInfo *rec)
+{
+    int bones = (mptr->final_resting_place != NULL || mptr->flags.knownbones) ? 1 : 0;
+    return rec->dnum == mptr->lev.dnum && rec->dlevel == mptr->lev.dlevel
+        && rec->is_current_level == (on_level(&mptr->lev, &u.uz) ? 1 : 0)
+        && rec->is_forgotten == (mptr->flags.forgot ? 1 : 0)
+        && rec->has_bones == bones;
+}
+
+/* Caller holds overview_mutex. Returns true if any record changed. */
+static bool rebuild(void)
+{
+    int count = 0;
+    for (mapseen *mptr = svm.mapseenchn; mptr; mptr = mptr->next) count++;
+    if (!reserve(count)) {
+        IOS_LOG_W(IOS_LOG_CAT_GAME, "[OVERVIEW] No memory for %d levels", count);
+        record_count = 0;
+        return true;
+    }
+
+    int i = 0;
+    for (mapseen *mptr = svm.mapseenchn; mptr; mptr = mptr->next) {
+        fill_record(mptr, &records[i++]);
+    }
+    record_count = count;
+    return true;
+}
+
+/* Caller holds overview_mutex. Returns true if any record changed. */
+static bool update(void)
+{
+    bool changed = false;
+    DungeonLevelInfo fresh;
+    int i = 0;
+
+    for (mapseen *mptr = svm.mapseenchn; mptr; mptr = mptr->next, i++) {
+        if (i >= record_count) return rebuild();   /* First arrival on a level */
+        DungeonLevelInfo *rec = &records[i];
+
+        if (rec->dnum != mptr->lev.dnum || rec->dlevel != mptr->lev.dlevel) {
+            return rebuild();
+        }
+        if (on_level(&mptr->lev, &u.uz) || !state_matches(mptr, rec)) {
+            fill_record(mptr, &fresh);
+            if (memcmp(&fresh, rec, sizeof(fresh)) != 0) {
+                *rec = fresh;
+                changed = true;
+            }
+        }
+    }
+    if (i != record_count) return rebuild();
+    return changed;
+}
+
+/* --- Game thread hooks --- */
+
+/* Game thread, or while it is parked at an input wait */
+static void sync_records(void)
+{
+    if (atomic_exchange(&need_recalc, false)) {
+        recalc_mapseen();
+    }
+
+    pthread_mutex_lock(&overview_mutex);
+    bool changed = synced ? update() : rebuild();
+    if (changed) atomic_fetch_add(&generation, 1);   /* With the records it describes */
+    pthread_mutex_unlock(&overview_mutex);
+    synced = true;
+
+    if (changed) {
+        IOS_LOG_D(IOS_LOG_CAT_GAME, "[OVERVIEW] %d levels, generation %u",
+                  record_count, atomic_load(&generation));
+    }
+}
+
+void ios_dungeon_overview_command_wait(void)
+{
+    if (!program_state.in_moveloop || program_state.gameover) return;
+
+    if (!synced || !on_level(&synced_level, &u.uz)) {
+        /* Level entry: nothing seen here yet as far as the model knows */
+        memset(feature_seen, 0, sizeof(feature_seen));
+        assign_level(&synced_level, &u.uz);
+        last_room = -1;
+        atomic_store(&need_recalc, true);
+    }
+    int room = (unsigned char)u.urooms[0];
+    if (room != last_room) {
+        last_room = room;   /* Entering a room marks it (shop, temple) seen */
+        atomic_store(&need_recalc, true);
+    }
+    sync_records();
+}
+
+void ios_dungeon_overview_note_glyph(int x, int y, int glyph)
+{
+    if (!isok(x, y) || !glyph_is_cmap(glyph)) return;
+
+    int cmap = glyph_to_cmap(glyph);
+    switch (cmap) {
+    case S_altar:
+    case S_fountain:
+    case S_throne:
+    case S_sink:
+    case S_grave:
+    case S_tree:
+        if (feature_seen[x][y] == cmap + 1) return;
+        feature_seen[x][y] = (uint8_t)(cmap + 1);
+        atomic_store(&need_recalc, true);
+        break;
+    default:
+        /* A seen feature is gone: dried fountain, kicked sink, cut tree */
+        if (feature_seen[x][y]) {
+            feature_seen[x][y] = 0;
+            atomic_store(&need_recalc, true);
+        }
+        break;
+    }
+}
+
+void ios_dungeon_overview_reset(void)
+{
+    pthread_mutex_lock(&overview_mutex);
+    record_count = 0;
+    atomic_fetch_add(&generation, 1);
+    pthread_mutex_unlock(&overview_mutex);
+
+    synced = false;
+    atomic_store(&need_recalc, true);
+}
+
+/* --- Readers --- */
+
+uint32_t ios_dungeon_overview_generation(void)
+{
+    return atomic_load(&generation);
+}
+
+int ios_dungeon_overview_count(void)
+{
+    pthread_mutex_lock(&overview_mutex);
+    int count = record_count;
+    pthread_mutex_unlock(&overview_mutex);
+    return count;
+}
+
+int ios_dungeon_overview_copy(DungeonLevelInfo *out, int max, uint32_t *gen)
+{
+    if (!out || max <= 0) return 0;
+
+    pthread_mutex_lock(&overview_mutex);
+    int n = record_count < max ? record_count : max;
+    memcpy(out, records, (size_t)n * sizeof(DungeonLevelInfo));
+    if (gen) *gen = atomic_load(&generation);
+    pthread_mutex_unlock(&overview_mutex);
+    return n;
+}
+
+/* --- Index API (RealNetHackBridge.h), served from the model --- */
+
+static void refresh_parked(void *ctx)
+{
+    (void)ctx;
+    if (!program_state.in_moveloop || program_state.gameover) return;
+    atomic_store(&need_recalc, true);
+    sync_records();
+}
+
+/* Shop, quest and bones state changes show no glyph, so an overview
+ * request recalcs now if the game is parked at an input wait, otherwise
+ * at its next command prompt. The generation moves if anything changed. */
+void ios_refresh_dungeon_overview(void)
+{
+    if (ios_input_ring_run_parked(refresh_parked, NULL)) return;
+    atomic_store(&need_recalc, true);
+}
+
+int ios_get_visited_level_count(void)
+{
+    return ios_dungeon_overview_count();
+}
+
+bool ios_get_dungeon_level_info(int index, DungeonLevelInfo *out)
+{
+    if (!out || index < 0) return false;
+
+    pthread_mutex_lock(&overview_mutex);
+    bool found = index < record_count;
+    if (found) *out = records[index];
+    pthread_mutex_unlock(&overview_mutex);
+    return found;
+}
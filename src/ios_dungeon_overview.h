@@ -0,0 +1,123 @@
+/*
+ * ios_dungeon_overview.h - Visited-level overview kept up to date
+ *
+ * The dungeon overview sheet used to run recalc_mapseen() (a scan of the
+ * whole current level) and then fetch each visited level by index, walking
+ * the mapseen chain from its head every time. With dozens of levels
+ * visited that is quadratic, and it happened on every open.
+ *
+ * The model is now a record table in mapseen order (dungeon, then level),
+ * maintained by the game thread at each command prompt:
+ *
+ *   - recalc_mapseen() runs only on level entry, when a feature glyph
+ *     (altar, fountain, throne, sink, grave, tree) shows on a map cell or
+ *     a seen one is replaced by other terrain, when the hero enters
+ *     another room (shops, temples), and when the overview is requested
+ *     (ios_refresh_dungeon_overview: quest, shopkeeper and bones state)
+ *   - the current level's record is rebuilt and compared, which picks up
+ *     annotations, Sokoban completion and the special-level flags
+ *   - other levels only change through the current-level, forgotten and
+ *     bones state, which one walk of the chain compares
+ *
+ * A generation moves only when a record changed, so Swift re-fetches the
+ * packed DungeonLevelInfo array only then.
+ *
+ * THREAD SAFETY: updates (game thread) and copies (any thread) hold the
+ * overview mutex.
+ */
+
+#ifndef IOS_DUNGEON_OVERVIEW_H
+#define IOS_DUNGEON_OVERVIEW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+// Special location flags bitmask
+#define DUNGEON_FLAG_ORACLE         (1 << 0)
+#define DUNGEON_FLAG_SOKOBAN_SOLVED (1 << 1)
+#define DUNGEON_FLAG_BIGROOM        (1 << 2)
+#define DUNGEON_FLAG_CASTLE         (1 << 3)
+#define DUNGEON_FLAG_VALLEY         (1 << 4)
+#define DUNGEON_FLAG_SANCTUM        (1 << 5)
+#define DUNGEON_FLAG_LUDIOS         (1 << 6)
+#define DUNGEON_FLAG_ROGUE          (1 << 7)
+#define DUNGEON_FLAG_VIB_SQUARE     (1 << 8)
+#define DUNGEON_FLAG_QUEST_HOME     (1 << 9)
+#define DUNGEON_FLAG_QUEST_SUMMONS  (1 << 10)
+#define DUNGEON_FLAG_MINETOWN       (1 << 11)
+
+// Branch types
+#define BRANCH_TYPE_NONE       0
+#define BRANCH_TYPE_STAIRS_UP  1
+#define BRANCH_TYPE_STAIRS_DOWN 2
+#define BRANCH_TYPE_PORTAL     3
+
+// Dungeon level info structure - comprehensive level data for iOS UI
+typedef struct {
+    int dnum;                   // Dungeon number (0 = main dungeon)
+    int dlevel;                 // Level within dungeon
+    char dungeon_name[64];      // "The Dungeons of Doom", "The Gnomish Mines", etc.
+    int depth;                  // Absolute depth from surface
+
+    // Features (counts, 0-3 each due to 2-bit storage)
+    int shops;
+    int temples;
+    int altars;
+    int fountains;
+    int thrones;
+    int graves;
+    int sinks;
+    int trees;
+    int shop_type;              // Shop type if single shop
+
+    // Special location flags (bitmask of DUNGEON_FLAG_* values)
+    unsigned int special_flags;
+
+    // Player annotation (custom note)
+    char annotation[128];
+
+    // Branch connection info
+    char branch_to[64];         // Name of connected dungeon branch
+    int branch_type;            // BRANCH_TYPE_* constant
+
+    // State
+    int is_current_level;       // Player is currently here
+    int is_forgotten;           // Level has been forgotten (amnesia)
+    int has_bones;              // Known bones on this level
+} DungeonLevelInfo;
+
+/* Bumped whenever a record changes (and on new game / restore) */
+NETHACK_EXPORT uint32_t ios_dungeon_overview_generation(void);
+
+/* Visited levels in the model */
+NETHACK_EXPORT int ios_dungeon_overview_count(void);
+
+/*
+ * Copy up to max records into out, in mapseen order. Returns the number
+ * copied; *generation (if not NULL) receives the generation they belong to.
+ */
+NETHACK_EXPORT int ios_dungeon_overview_copy(DungeonLevelInfo *out, int max,
+                                             uint32_t *generation);
+
+/*
+ * Call when the overview opens: recalc_mapseen() and a record update now
+ * if the game thread is parked at an input wait (the generation moves if
+ * a record changed), otherwise at the next command prompt.
+ */
+NETHACK_EXPORT void ios_refresh_dungeon_overview(void);
+
+/* Index API (older callers): the count, and one record by index */
+NETHACK_EXPORT int ios_get_visited_level_count(void);
+NETHACK_EXPORT bool ios_get_dungeon_level_info(int index, DungeonLevelInfo *out);
+
+/* Game thread, at a command key wait: bring the records up to date */
+void ios_dungeon_overview_command_wait(void);
+
+/* Game thread, from print_glyph: a feature glyph may have come or gone */
+void ios_dungeon_overview_note_glyph(int x, int y, int glyph);
+
+/* New game / restore: drop every record, rebuilt at the next command prompt */
+void ios_dungeon_overview_reset(void);
+
+#endif /* IOS_DUNGEON_OVERVIEW_H */
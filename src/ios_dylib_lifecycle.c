@@ -19,6 +19,9 @@
 #include "nethack_export.h"  // Symbol visibility control
 #include "hack.h"
 #include "dlb.h"
+#include "ios_lua_pool.h"  // ios_lua_core_init
+#include "ios_lua_state.h" // ios_lua_state_shutdown
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -102,7 +105,7 @@ NETHACK_EXPORT void ios_full_dylib_init(void)
 
     // Step 4: Lua init
     fprintf(stderr, "[DYLIB_LIFECYCLE] Step 4: l_nhcore_init()...\n");
-    l_nhcore_init();  // void return, no error checking needed
+    ios_lua_core_init();  // l_nhcore_init() with gl.luacore in the Lua pool's core arena
     fprintf(stderr, "[DYLIB_LIFECYCLE]   ✓ Lua scripting initialized\n");
 
     // Step 5: REMOVED - status_initialize() moved to game initialization!
@@ -175,6 +178,7 @@ NETHACK_EXPORT void ios_full_dylib_shutdown(void)
     // Step 3: Lua shutdown
     fprintf(stderr, "[DYLIB_LIFECYCLE] Step 3: l_nhcore_done()...\n");
     l_nhcore_done();
+    ios_lua_state_shutdown();  // Idle warm level-generation states
     fprintf(stderr, "[DYLIB_LIFECYCLE]   ✓ Lua scripting shut down\n");
 
     // Step 4: DLB cleanup - dlb_cleanup() is a macro that expands to nothing (DLB disabled)
@@ -199,6 +203,50 @@ NETHACK_EXPORT void ios_full_dylib_shutdown(void)
     fprintf(stderr, "\n");
 }
 
+/* ========================================================================
+ * WARM RESTART (NEXT GAME WITHOUT DYLIB RELOAD)
+ * ======================================================================== */
+
+/**
+ * Reset per-game state for the next game while the dylib stays loaded.
+ *
+ * Everything a game can change is rebuilt exactly as after a reload:
+ * shutdown (if initialized), static heap wipe, then ios_full_dylib_init()
+ * (globals zeroed and re-initialized, fresh Lua state, bridge state reset).
+ * Flags a reload would reset to their .data values are cleared here.
+ *
+ * What survives is what never changes while the process runs: the mapped
+ * code, Swift's resolved symbols and registered callbacks, the Documents
+ * and bundle path caches, provisioned data files (ios_init_file_prefixes
+ * provisions once per load) and the mapped Lua archive.
+ *
+ * Safe to call after ios_full_dylib_shutdown() (the parked state
+ * NetHackBridge.stopGameAsync leaves) or on a running-but-stopped game.
+ * The game thread MUST have exited.
+ */
+NETHACK_EXPORT void ios_warm_dylib_restart(void)
+{
+    fprintf(stderr, "[DYLIB_LIFECYCLE] WARM RESTART (dylib stays loaded)\n");
+
+    if (full_init_called) {
+        ios_full_dylib_shutdown();
+    }
+
+    extern void ios_wipe_memory(void);      // ios_game_lifecycle.c
+    ios_wipe_memory();
+
+    // Reload would restore these from .data; init below does not touch them
+    extern struct sinfo program_state;
+    extern int ios_freedynamicdata_done;    // ios_dylib_stubs.c
+    extern bool snapshot_loaded;            // RealNetHackBridge.c
+    memset(&program_state, 0, sizeof(program_state));
+    ios_freedynamicdata_done = 0;
+    snapshot_loaded = false;
+
+    ios_full_dylib_init();
+    fprintf(stderr, "[DYLIB_LIFECYCLE] ✅ WARM RESTART COMPLETE\n");
+}
+
 /* ========================================================================
  * LIFECYCLE STATE QUERIES
  * ======================================================================== */
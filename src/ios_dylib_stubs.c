@@ -29,6 +29,7 @@ char internal_output_buffer[OUTPUT_BUFFER_SIZE] = {0};
 
 /* Now include the header which defines the accessor macros */
 #include "nethack_bridge_common.h"
+#include "ios_input_journal.h"  /* Seeds recorded/replayed by sys_random_seed */
 
 /* Accessor functions - ALWAYS export reliably from dylib */
 NETHACK_EXPORT char* nethack_get_output_buffer(void) {
@@ -365,10 +366,10 @@ const char *regex_id(void) {
     return "none";
 }
 
-/* System random seed - use iOS native arc4random */
+/* System random seed - use iOS native arc4random (journaled for replay) */
 __attribute__((visibility("default")))
 unsigned long sys_random_seed(void) {
-    return (unsigned long)arc4random();
+    return ios_journal_seed((unsigned long)arc4random());
 }
 
 /* TTY stubs - minimal implementations */
@@ -518,6 +519,7 @@ NETHACK_EXPORT void free_nomakedefs(void) {
 
 #include "ios_raw_file.h"  /* For ios_raw_file_data structure */
 #include "RealNetHackBridge.h"  /* For DLB_LOG macro */
+#include "ios_lua_archive.h"   /* Lua sources mapped from the bundle */
 
 /* DLB structure - represents an open file in memory */
 typedef struct dlb {
@@ -563,6 +565,21 @@ NETHACK_EXPORT dlb* dlb_fopen(const char* filename, const char* mode) {
         return NULL;
     }
 
+    /* STRATEGY 0: Lua script in the mapped archive - no read, no copy.
+     * nhlua.c loads the archive's precompiled chunk for it by name. */
+    size_t archived_size = 0;
+    const char* archived = ios_lua_archive_source(filename, &archived_size);
+    if (archived) {
+        dlb* file = (dlb*)alloc(sizeof(dlb));
+        if (!file) return NULL;
+        file->content = archived;
+        file->size = archived_size;
+        file->pos = 0;
+        file->is_allocated = 0;  /* Mapping, don't free */
+        DLB_LOG("✓ Mapped from Lua archive: %s (%zu bytes)", filename, archived_size);
+        return file;
+    }
+
     /* STRATEGY 1: Try Documents/NetHack/Data/ directory FIRST
      * This is where ios_copy_all_lua_files() copies the 130 Lua files.
      * NetHack's fqn_prefix[DATAPREFIX] points to this directory.
@@ -948,10 +965,6 @@ void ios_swift_free_raw_file(ios_raw_file_data* file_data) {
     /* Nothing to free in stub */
 }
 
-/* Notification stubs */
-// ios_post_message_notification moved to ios_notifications.m (Objective-C implementation)
-// This stub is no longer needed - real implementation uses NSNotificationCenter
-
 /* NOTE: ios_restore_complete is defined in ios_save_integration.c - not here! */
 
 /* Global variables */
@@ -0,0 +1,139 @@
+/*
+ * ios_event_bus.c - Coalesced game-to-UI events (see ios_event_bus.h)
+ */
+
+#include "ios_event_bus.h"
+#include "ios_headless.h"
+#include <dispatch/dispatch.h>
+#include <pthread.h>
+#include <string.h>
+
+static pthread_mutex_t bus_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IOSEventBatchCallback bus_callback = NULL;
+static IOSEventBatch pending;
+static bool in_flight = false;          /* A deliver() is queued on main */
+static bool messages_held = true;       /* Until Swift is ready for messages */
+static uint64_t delivered = 0;
+static IOSEventBusStats stats;
+
+/* Under bus_mutex: events the next batch would carry */
+static uint32_t deliverable_locked(void)
+{
+    return messages_held ? pending.events & ~IOS_EVENT_MESSAGES : pending.events;
+}
+
+/* Main queue: take the pending batch as it is now and hand it to Swift */
+static void deliver(void *context)
+{
+    (void)context;
+    pthread_mutex_lock(&bus_mutex);
+    IOSEventBatch batch = pending;
+    batch.events = deliverable_locked();
+    pending.events &= ~batch.events;
+    pending.posts = 0;
+    pending.turn = 0;
+    if (batch.events & IOS_EVENT_MESSAGES) {
+        pending.message_after = pending.message_last = 0;
+    } else {
+        batch.message_after = batch.message_last = 0;
+    }
+    in_flight = false;
+    IOSEventBatchCallback callback = bus_callback;
+    if (batch.events && callback) {
+        batch.batch = ++delivered;
+        stats.batches++;
+    }
+    pthread_mutex_unlock(&bus_mutex);
+
+    if (batch.events && callback) {
+        callback(&batch);
+    }
+}
+
+void ios_event_bus_register(IOSEventBatchCallback callback)
+{
+    pthread_mutex_lock(&bus_mutex);
+    bus_callback = callback;
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+void ios_event_bus_hold_messages(bool hold)
+{
+    pthread_mutex_lock(&bus_mutex);
+    messages_held = hold;
+    pthread_mutex_unlock(&bus_mutex);
+    if (!hold) {
+        ios_event_bus_flush();
+    }
+}
+
+void ios_event_bus_get_stats(IOSEventBusStats *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&bus_mutex);
+    *out = stats;
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+void ios_event_post(uint32_t events)
+{
+    pthread_mutex_lock(&bus_mutex);
+    pending.events |= events;
+    pending.posts++;
+    stats.posts++;
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+void ios_event_post_message(uint64_t seq)
+{
+    pthread_mutex_lock(&bus_mutex);
+    if (!(pending.events & IOS_EVENT_MESSAGES)) {
+        pending.message_after = seq - 1;
+    }
+    pending.message_last = seq;
+    pending.events |= IOS_EVENT_MESSAGES;
+    pending.posts++;
+    stats.posts++;
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+void ios_event_post_turn(int64_t turn)
+{
+    pthread_mutex_lock(&bus_mutex);
+    pending.turn = turn;
+    pending.events |= IOS_EVENT_TURN_COMPLETE;
+    pending.posts++;
+    stats.posts++;
+    pthread_mutex_unlock(&bus_mutex);
+}
+
+void ios_event_bus_flush(void)
+{
+    pthread_mutex_lock(&bus_mutex);
+    stats.flushes++;
+    bool dispatch = !in_flight && bus_callback && deliverable_locked() && !ios_is_headless();
+    if (dispatch) {
+        in_flight = true;
+        stats.dispatches++;
+    }
+    pthread_mutex_unlock(&bus_mutex);
+
+    if (dispatch) {
+        dispatch_async_f(dispatch_get_main_queue(), NULL, deliver);
+    }
+}
+
+bool ios_event_bus_in_flight(void)
+{
+    pthread_mutex_lock(&bus_mutex);
+    bool queued = in_flight;
+    pthread_mutex_unlock(&bus_mutex);
+    return queued;
+}
+
+void ios_event_bus_reset(void)
+{
+    pthread_mutex_lock(&bus_mutex);
+    memset(&pending, 0, sizeof(pending));
+    pthread_mutex_unlock(&bus_mutex);
+}
@@ -0,0 +1,86 @@
+/*
+ * ios_event_bus.h - Game-to-UI events, one main-queue hop per turn boundary
+ *
+ * Map changes, new messages, turn completion, game ready and death used to
+ * signal Swift on their own: a dispatch_async per display_nhwindow, an
+ * NSNotification per message (ios_notifications.m), a game-ready callback
+ * and a death callback, each hopping to the main queue separately. The
+ * game thread now only posts typed events here. They coalesce into one
+ * pending IOSEventBatch (flags plus the message sequence range, payload
+ * stays in its owner: render queue, message log, snapshots), and a flush
+ * at the turn boundary - the game about to wait for input - delivers the
+ * batch with a single dispatch to the registered callback.
+ *
+ * A flush while the previous batch is still queued on the main thread
+ * dispatches nothing: posts keep merging into the batch that is on its
+ * way. Effect frames (delay_output) and time-critical events (death,
+ * game ready) flush immediately.
+ *
+ * Messages are held until Swift is ready for them (at startup, and from
+ * a game reset until the game view appears): the range keeps growing in
+ * the pending batch and is delivered once released. The message log
+ * retains IOS_MESSAGE_LOG_CAPACITY messages, which bounds what a hold
+ * can keep.
+ *
+ * THREAD SAFETY: post/flush on the game thread, register/hold/stats from
+ * any thread; the callback runs on the main queue. A mutex guards the
+ * pending batch.
+ */
+
+#ifndef IOS_EVENT_BUS_H
+#define IOS_EVENT_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* Event types (IOSEventBatch.events bits) */
+#define IOS_EVENT_MAP_CHANGED   0x0001u   /* Render queue / map export has new content */
+#define IOS_EVENT_MESSAGES      0x0002u   /* Message log has records in the batch range */
+#define IOS_EVENT_TURN_COMPLETE 0x0004u   /* A turn ended; snapshots are current */
+#define IOS_EVENT_GAME_READY    0x0008u   /* New or restored game is ready for queries */
+#define IOS_EVENT_DEATH         0x0010u   /* Hero died: start the death animation */
+#define IOS_EVENT_MACRO_DONE    0x0020u   /* An action macro finished (ios_action_macro.h) */
+
+typedef struct {
+    uint32_t events;            /* IOS_EVENT_* raised since the previous batch */
+    uint32_t posts;             /* Individual posts coalesced into this batch */
+    uint64_t batch;             /* 1-based delivery counter */
+    uint64_t message_after;     /* MESSAGES: fetch records with seq > this ... */
+    uint64_t message_last;      /* ... up to and including this one */
+    int64_t turn;               /* TURN_COMPLETE: svm.moves of the latest turn */
+} IOSEventBatch;
+
+typedef struct {
+    uint64_t posts;             /* Events posted */
+    uint64_t flushes;           /* Flush requests (turn boundaries, effect frames) */
+    uint64_t dispatches;        /* Main-queue hops actually made */
+    uint64_t batches;           /* Batches delivered to the callback */
+} IOSEventBusStats;
+
+/* Runs on the main queue; the batch is only valid during the call */
+typedef void (*IOSEventBatchCallback)(const IOSEventBatch *batch);
+
+NETHACK_EXPORT void ios_event_bus_register(IOSEventBatchCallback callback);
+
+/* Hold or release message delivery (release flushes) */
+NETHACK_EXPORT void ios_event_bus_hold_messages(bool hold);
+
+NETHACK_EXPORT void ios_event_bus_get_stats(IOSEventBusStats *out);
+
+/* --- Game thread --- */
+
+void ios_event_post(uint32_t events);
+void ios_event_post_message(uint64_t seq);
+void ios_event_post_turn(int64_t turn);
+
+/* Deliver the pending batch (no-op if empty or one is already queued) */
+void ios_event_bus_flush(void);
+
+/* A batch is queued on the main thread and not yet delivered */
+bool ios_event_bus_in_flight(void);
+
+/* New game: drop pending events (stats keep counting) */
+void ios_event_bus_reset(void);
+
+#endif /* IOS_EVENT_BUS_H */
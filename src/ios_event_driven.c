@@ -3,20 +3,25 @@
  *
  * NO THREADING - NetHack runs one command at a time from the UI thread
  * This is the PROPER way to integrate with iOS!
+ *
+ * Commands run through the stepped game loop (ios_game_step.h): moveloop()
+ * lives on a coroutine stack and each call here resumes it until NetHack
+ * waits for input again.
  */
 
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/func_tab.h"
+#include "ios_game_step.h"
 
-// State machine for event-driven operation
+// State machine for event-driven operation (same values as RealNetHackBridge.h)
 typedef enum {
-    NETHACK_IDLE,           // Waiting for input
-    NETHACK_PROCESSING,     // Processing a command
-    NETHACK_NEEDS_INPUT,    // Needs user input (menu, prompt, etc)
-    NETHACK_GAME_OVER       // Game ended
+    NETHACK_STATE_IDLE,           // Waiting for input
+    NETHACK_STATE_PROCESSING,     // Processing a command
+    NETHACK_STATE_NEEDS_INPUT,    // Needs user input (menu, prompt, etc)
+    NETHACK_STATE_GAME_OVER       // Game ended
 } NetHackState;
 
-static NetHackState current_state = NETHACK_IDLE;
+static NetHackState current_state = NETHACK_STATE_IDLE;
 static int game_initialized = 0;
 
 /*
@@ -31,14 +36,14 @@ int ios_nethack_init_event_driven(void) {
     nethack_real_init();
 
     game_initialized = 1;
-    current_state = NETHACK_IDLE;
+    current_state = NETHACK_STATE_IDLE;
 
     return 1;
 }
 
 /*
  * Start a new game - called from SwiftUI
- * Returns immediately after setup
+ * Returns once NetHack waits for its first command
  */
 int ios_nethack_start_game(void) {
     if (!game_initialized) return 0;
@@ -46,55 +51,50 @@ int ios_nethack_start_game(void) {
     extern void nethack_real_newgame(void);
     nethack_real_newgame();
 
-    current_state = NETHACK_IDLE;
-    return 1;
+    int step = ios_game_step_start();
+    current_state = step == IOS_STEP_NEEDS_INPUT ? NETHACK_STATE_IDLE : NETHACK_STATE_GAME_OVER;
+    return step == IOS_STEP_NEEDS_INPUT;
 }
 
 /*
  * Process one input character
  * Called from SwiftUI when user taps/types
- * Returns immediately after processing
+ * Returns once NetHack has consumed it and waits for more input
  */
 int ios_nethack_process_input(char ch) {
-    if (current_state != NETHACK_IDLE) {
+    if (current_state != NETHACK_STATE_IDLE) {
         return 0; // Busy
     }
 
-    current_state = NETHACK_PROCESSING;
+    current_state = NETHACK_STATE_PROCESSING;
 
     // Queue the input
     extern void ios_queue_input(char);
     ios_queue_input(ch);
 
-    // Process ONE command through rhack
-    extern void rhack(int);
-    rhack(0);
+    // Run the game until it wants the next key (whole command, or a prompt)
+    int step = ios_game_step();
 
-    current_state = NETHACK_IDLE;
+    current_state = step == IOS_STEP_NEEDS_INPUT ? NETHACK_STATE_IDLE : NETHACK_STATE_GAME_OVER;
     return 1;
 }
 
 /*
  * Process pending NetHack events
  * Called from SwiftUI timer (60Hz or as needed)
- * Non-blocking - returns immediately
+ * Runs queued keys (sent through ios_queue_input_string) through the game;
+ * returns immediately when none are queued
  */
 int ios_nethack_tick(void) {
-    if (current_state != NETHACK_IDLE) {
+    if (current_state != NETHACK_STATE_IDLE) {
         return 0; // Still processing
     }
 
-    // Check for any pending NetHack work
-    extern void update_inventory(void);
-    extern void bot(void);
-
-    // Update status and botline
-    bot();
-
-    // Flush any pending output
-    extern void flush_screen(int);
-    flush_screen(0);
-
+    int step = ios_game_step();
+    if (step != IOS_STEP_NEEDS_INPUT) {
+        current_state = NETHACK_STATE_GAME_OVER;
+        return 0;
+    }
     return 1;
 }
 
@@ -109,14 +109,14 @@ NetHackState ios_nethack_get_state(void) {
  * Save game - synchronous, returns when complete
  */
 int ios_nethack_save(const char* filepath) {
-    if (current_state != NETHACK_IDLE) return 0;
+    if (current_state != NETHACK_STATE_IDLE) return 0;
 
-    current_state = NETHACK_PROCESSING;
+    current_state = NETHACK_STATE_PROCESSING;
 
     extern int nethack_save_game(const char*);
     int result = nethack_save_game(filepath);
 
-    current_state = NETHACK_IDLE;
+    current_state = NETHACK_STATE_IDLE;
     return result;
 }
 
@@ -124,14 +124,14 @@ int ios_nethack_save(const char* filepath) {
  * Load game - synchronous, returns when complete
  */
 int ios_nethack_load(const char* filepath) {
-    if (game_initialized && current_state != NETHACK_IDLE) return 0;
+    if (game_initialized && current_state != NETHACK_STATE_IDLE) return 0;
 
-    current_state = NETHACK_PROCESSING;
+    current_state = NETHACK_STATE_PROCESSING;
 
     extern int nethack_load_game_new(const char*);
     int result = nethack_load_game_new(filepath);
 
-    current_state = result ? NETHACK_IDLE : NETHACK_GAME_OVER;
+    current_state = result ? NETHACK_STATE_IDLE : NETHACK_STATE_GAME_OVER;
     return result;
 }
 
@@ -146,5 +146,5 @@ void ios_nethack_cleanup(void) {
     nh_terminate(0);
 
     game_initialized = 0;
-    current_state = NETHACK_GAME_OVER;
+    current_state = NETHACK_STATE_GAME_OVER;
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*
+ * ios_file_copy.c - Clone-or-stream file copy (see ios_file_copy.h)
+ */
+
+#include "ios_file_copy.h"
+#include "../zone_allocator/nh_io_stats.h"
+#include "ios_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <sys/clonefile.h>
+#endif
+
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        nh_io_note_write((size_t)n);
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int stream_copy(const char *src, const char *dst) {
+    int in = open(src, O_RDONLY);
+    if (in < 0) return -1;
+    int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        int saved = errno;
+        close(in);
+        errno = saved;
+        return -1;
+    }
+
+    char buffer[64 * 1024];
+    ssize_t n;
+    int result = 0;
+    while ((n = read(in, buffer, sizeof(buffer))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            result = -1;
+            break;
+        }
+        if (write_all(out, buffer, (size_t)n) != 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    int saved = errno;
+    close(in);
+    if (close(out) != 0 && result == 0) {
+        saved = errno;
+        result = -1;
+    }
+    errno = saved;
+    return result;
+}
+
+int ios_file_copy(const char *src, const char *dst) {
+    char temp[1040];
+    if (snprintf(temp, sizeof(temp), "%s.copy", dst) >= (int)sizeof(temp)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    unlink(temp);  // clonefile() will not replace; a stale one is ours
+
+    int result = -1;
+#ifdef __APPLE__
+    result = clonefile(src, temp, CLONE_NOFOLLOW);
+    if (result != 0 && errno != ENOTSUP && errno != EXDEV) {
+        // ENOTSUP/EXDEV: not APFS or another volume - streaming is expected
+        IOS_LOG_D(IOS_LOG_CAT_SAVE, "[FILE_COPY] clonefile %s failed (%s), streaming", src, strerror(errno));
+    }
+#endif
+    if (result != 0) result = stream_copy(src, temp);
+
+    if (result == 0 && rename(temp, dst) != 0) result = -1;
+    if (result != 0) {
+        int saved = errno;
+        unlink(temp);
+        errno = saved;
+    }
+    return result;
+}
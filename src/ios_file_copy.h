@@ -0,0 +1,18 @@
+/*
+ * ios_file_copy.h - File duplication for backups, slots and chunk stores
+ *
+ * On APFS a copy is a clonefile(): O(1), no data written, blocks shared
+ * copy-on-write until either file changes. Elsewhere (other volumes,
+ * simulator hosts without APFS) it streams through a 64KB buffer.
+ *
+ * The copy lands in <dst>.copy and is renamed over dst, so dst is never
+ * seen half written and an existing dst is replaced.
+ */
+
+#ifndef IOS_FILE_COPY_H
+#define IOS_FILE_COPY_H
+
+/* 0 on success, -1 with errno set (dst untouched on failure) */
+int ios_file_copy(const char *src, const char *dst);
+
+#endif /* IOS_FILE_COPY_H */
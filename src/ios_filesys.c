@@ -17,6 +17,8 @@
 /* Include NetHack headers for struct definitions */
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/dlb.h"  /* for NHFILE */
+#include "ios_lua_archive.h"
+#include "ios_file_copy.h"
 
 /* NetHack function declarations */
 extern const char* fqname(const char* basename, int whichprefix, int buffnum);
@@ -131,44 +133,6 @@ static const char* ios_get_bundle_resource_path_c(void) {
     return bundle_path;
 }
 
-/* Copy a single file from source to destination */
-static int ios_copy_single_file(const char* src, const char* dest) {
-    fprintf(stderr, "[IOS_FILESYS] ios_copy_single_file() ENTER\n");
-    fprintf(stderr, "[IOS_FILESYS]   src: %s\n", src);
-    fprintf(stderr, "[IOS_FILESYS]   dest: %s\n", dest);
-    fflush(stderr);
-
-    FILE* source = fopen(src, "rb");
-    if (!source) {
-        fprintf(stderr, "[IOS_FILESYS]   ERROR: fopen(src) failed - errno=%d (%s)\n", errno, strerror(errno));
-        fflush(stderr);
-        return 0;
-    }
-
-    FILE* target = fopen(dest, "wb");
-    if (!target) {
-        fprintf(stderr, "[IOS_FILESYS]   ERROR: fopen(dest) failed - errno=%d (%s)\n", errno, strerror(errno));
-        fflush(stderr);
-        fclose(source);
-        return 0;
-    }
-
-    char buffer[4096];
-    size_t bytes;
-    size_t total_bytes = 0;
-    while ((bytes = fread(buffer, 1, sizeof(buffer), source)) > 0) {
-        fwrite(buffer, 1, bytes, target);
-        total_bytes += bytes;
-    }
-
-    fclose(source);
-    fclose(target);
-
-    fprintf(stderr, "[IOS_FILESYS]   SUCCESS: Copied %zu bytes\n", total_bytes);
-    fflush(stderr);
-    return 1;
-}
-
 /* Create minimal stub data files for iOS */
 static void ios_create_stub_data_files(const char* data_path) {
     fprintf(stderr, "[IOS_FILESYS] Creating stub data files...\n");
@@ -219,37 +183,22 @@ static void ios_create_stub_data_files(const char* data_path) {
     /* Create other stub files if needed in the future */
 }
 
-/* Copy all 130 lua files from app bundle to Documents/Data/ directory */
-static void ios_copy_all_lua_files(const char* documents_path) {
-    fprintf(stderr, "\n[IOS_FILESYS] ===== ios_copy_all_lua_files() ENTER =====\n");
-    fprintf(stderr, "[IOS_FILESYS] documents_path parameter: %s\n", documents_path ? documents_path : "(NULL)");
-    fflush(stderr);
-
+/* Copy all 130 lua files from app bundle to Documents/Data/ directory.
+ * Only runs when provisioning is stale, so every file is replaced (a new
+ * build may ship changed scripts). Returns the number of failed copies. */
+static int ios_copy_all_lua_files(const char* documents_path) {
     const char* bundle_path = ios_get_bundle_resource_path_c();
-    fprintf(stderr, "[IOS_FILESYS] After ios_get_bundle_resource_path_c() call:\n");
-    fprintf(stderr, "[IOS_FILESYS]   bundle_path = %s\n", bundle_path ? bundle_path : "(NULL)");
-    fflush(stderr);
-
     if (!bundle_path) {
         fprintf(stderr, "[IOS_FILESYS] CRITICAL: Cannot get bundle path! ABORTING\n");
-        fflush(stderr);
-        return;
+        return -1;
     }
 
     char data_dir[1024];
     snprintf(data_dir, sizeof(data_dir), "%s/Data", documents_path);
-    fprintf(stderr, "[IOS_FILESYS] Built data_dir path: %s\n", data_dir);
-
-    /* Create the Data directory if it doesn't exist */
-    if (mkdir(data_dir, 0755) == 0) {
-        fprintf(stderr, "[IOS_FILESYS] ✓ Created Data directory: %s\n", data_dir);
-    } else if (errno == EEXIST) {
-        fprintf(stderr, "[IOS_FILESYS] Data directory already exists: %s\n", data_dir);
-    } else {
+    if (mkdir(data_dir, 0755) != 0 && errno != EEXIST) {
         fprintf(stderr, "[IOS_FILESYS] ERROR creating Data directory: %s (errno: %d - %s)\n",
                 data_dir, errno, strerror(errno));
     }
-    fflush(stderr);
 
     /* All 130 lua files from the bundle */
     const char* lua_files[] = {
@@ -285,54 +234,88 @@ static void ios_copy_all_lua_files(const char* documents_path) {
         NULL
     };
 
-    int copied = 0, skipped = 0;
-
-    fprintf(stderr, "[IOS_FILESYS] Starting file copy loop (130 lua files)...\n");
-    fflush(stderr);
-
+    int copied = 0, failed = 0;
     for (int i = 0; lua_files[i]; i++) {
         char src[1024], dest[1024];
         snprintf(src, sizeof(src), "%s/%s", bundle_path, lua_files[i]);
         snprintf(dest, sizeof(dest), "%s/%s", data_dir, lua_files[i]);
 
-        /* Log first 5 files being processed */
-        if (i < 5) {
-            fprintf(stderr, "[IOS_FILESYS] Processing file #%d: %s\n", i, lua_files[i]);
-            fprintf(stderr, "[IOS_FILESYS]   src: %s\n", src);
-            fprintf(stderr, "[IOS_FILESYS]   dest: %s\n", dest);
-            fflush(stderr);
+        if (ios_file_copy(src, dest) == 0) {
+            copied++;
+        } else {
+            failed++;
+            fprintf(stderr, "[IOS_FILESYS] ✗ FAILED to copy %s: %s\n", lua_files[i], strerror(errno));
         }
+    }
 
-        /* Check if already exists with correct size */
-        FILE* check = fopen(dest, "rb");
-        if (check) {
-            fseek(check, 0, SEEK_END);
-            long size = ftell(check);
-            fclose(check);
-
-            if (size > 100) {  /* Valid file exists */
-                skipped++;
-                if (i < 5) {
-                    fprintf(stderr, "[IOS_FILESYS]   SKIP: File exists with size=%ld bytes\n", size);
-                    fflush(stderr);
-                }
-                continue;
-            }
-        }
+    fprintf(stderr, "[IOS_FILESYS] Lua files: %d copied, %d failed\n", copied, failed);
+    return failed;
+}
 
-        if (ios_copy_single_file(src, dest)) {
-            copied++;
-            fprintf(stderr, "[IOS_FILESYS] ✓ Copied %s (%d)\n", lua_files[i], copied);
-            fflush(stderr);
-        } else {
-            fprintf(stderr, "[IOS_FILESYS] ✗ FAILED to copy %s\n", lua_files[i]);
-            fflush(stderr);
+/*
+ * Provisioning marker: Documents/Data/.provisioned holds the key of the
+ * build that last wrote the data files, Lua scripts and sysconf. On a
+ * launch with the same key, all of that is already in place and startup
+ * does no copies. The key changes with the bundle version, the executable
+ * (every install or rebuild) and whether Lua comes from the archive.
+ */
+#define IOS_PROVISION_MARKER ".provisioned"
+#define IOS_PROVISION_FORMAT 1           /* Bump when provisioned files change shape */
+
+static void ios_provision_key(char* key, size_t keylen, int lua_archived) {
+    char version[64] = "?", build[64] = "?";
+    long long exe_mtime = 0, exe_size = 0;
+
+    CFBundleRef main_bundle = CFBundleGetMainBundle();
+    if (main_bundle) {
+        CFTypeRef value = CFBundleGetValueForInfoDictionaryKey(main_bundle, CFSTR("CFBundleShortVersionString"));
+        if (value && CFGetTypeID(value) == CFStringGetTypeID()) {
+            CFStringGetCString((CFStringRef)value, version, sizeof(version), kCFStringEncodingUTF8);
+        }
+        value = CFBundleGetValueForInfoDictionaryKey(main_bundle, kCFBundleVersionKey);
+        if (value && CFGetTypeID(value) == CFStringGetTypeID()) {
+            CFStringGetCString((CFStringRef)value, build, sizeof(build), kCFStringEncodingUTF8);
+        }
+        CFURLRef exe_url = CFBundleCopyExecutableURL(main_bundle);
+        if (exe_url) {
+            char exe_path[1024];
+            struct stat st;
+            if (CFURLGetFileSystemRepresentation(exe_url, true, (UInt8*)exe_path, sizeof(exe_path)) &&
+                stat(exe_path, &st) == 0) {
+                exe_mtime = (long long)st.st_mtime;
+                exe_size = (long long)st.st_size;
+            }
+            CFRelease(exe_url);
         }
     }
 
-    fprintf(stderr, "[IOS_FILESYS] Lua files: %d copied, %d skipped\n", copied, skipped);
-    fprintf(stderr, "[IOS_FILESYS] ===== ios_copy_all_lua_files() EXIT =====\n\n");
-    fflush(stderr);
+    snprintf(key, keylen, "%d %s (%s) %lld:%lld lua=%s\n", IOS_PROVISION_FORMAT,
+             version, build, exe_mtime, exe_size, lua_archived ? "archive" : "files");
+}
+
+static int ios_provision_current(const char* data_dir, const char* key) {
+    char marker[PATHLEN], stored[256] = {0};
+    snprintf(marker, sizeof(marker), "%s" IOS_PROVISION_MARKER, data_dir);
+    FILE* fp = fopen(marker, "r");
+    if (!fp) return 0;
+    size_t n = fread(stored, 1, sizeof(stored) - 1, fp);
+    fclose(fp);
+    stored[n] = '\0';
+    return strcmp(stored, key) == 0;
+}
+
+static void ios_provision_mark(const char* data_dir, const char* key) {
+    char marker[PATHLEN], temp[PATHLEN];
+    snprintf(marker, sizeof(marker), "%s" IOS_PROVISION_MARKER, data_dir);
+    snprintf(temp, sizeof(temp), "%s.tmp", marker);
+    FILE* fp = fopen(temp, "w");
+    if (!fp) return;
+    int ok = fputs(key, fp) >= 0;
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(temp, marker) != 0) {
+        fprintf(stderr, "[IOS_FILESYS] WARNING: Could not write provisioning marker: %s\n", strerror(errno));
+        remove(temp);
+    }
 }
 
 /* Initialize NetHack's prefix system with iOS paths */
@@ -395,9 +378,6 @@ NETHACK_EXPORT void ios_init_file_prefixes(void) {
     gf.fqn_prefix[DATAPREFIX] = dupstr(path_buffer);
     fprintf(stderr, "[IOS_FILESYS] Set DATAPREFIX: %s\n", path_buffer);
 
-    /* Create stub data files for iOS */
-    ios_create_stub_data_files(path_buffer);
-
     /* SCOREPREFIX - for score files */
     snprintf(path_buffer, sizeof(path_buffer), "%s/score/", documents);
     mkdir(path_buffer, 0755);
@@ -426,18 +406,54 @@ NETHACK_EXPORT void ios_init_file_prefixes(void) {
 
     fprintf(stderr, "[IOS_FILESYS] NetHack prefix system initialized successfully!\n");
 
-    /* Copy ALL lua files from app bundle to Documents/Data/ */
-    ios_copy_all_lua_files(documents);
+    /* Lua scripts: map the precompiled archive from the bundle; only
+     * without one do ALL lua files need to be in Documents/Data/ */
+    const char* lua_bundle_path = ios_get_bundle_resource_path_c();
+    char archive_path[1024];
+    snprintf(archive_path, sizeof(archive_path), "%s/" IOS_LUA_ARCHIVE_FILE,
+             lua_bundle_path ? lua_bundle_path : "");
+    int lua_archived = lua_bundle_path && ios_lua_archive_open(archive_path) == 0;
+    if (lua_archived) {
+        fprintf(stderr, "[IOS_FILESYS] Lua scripts served from %s (no copy)\n", archive_path);
+    }
 
-    // Create empty sysconf file to prevent initoptions from exiting
-    char sysconf_path[BUFSZ];
+    /* Data files, Lua copies and sysconf only change with the build;
+     * a warm restart (ios_warm_dylib_restart) does not even re-check */
+    static int provisioned_this_load = 0;
+    if (provisioned_this_load) {
+        return;
+    }
+
+    char data_dir[PATHLEN], sysconf_path[BUFSZ], provision_key[256];
+    snprintf(data_dir, sizeof(data_dir), "%s/Data/", documents);
     snprintf(sysconf_path, sizeof(sysconf_path), "%s/sysconf", documents);
+    ios_provision_key(provision_key, sizeof(provision_key), lua_archived);
+    if (ios_provision_current(data_dir, provision_key) && access(sysconf_path, F_OK) == 0) {
+        fprintf(stderr, "[IOS_FILESYS] Resources already provisioned for this build, skipping copies\n");
+        provisioned_this_load = 1;
+        return;
+    }
+
+    /* Create stub data files for iOS */
+    ios_create_stub_data_files(data_dir);
+
+    int failed = lua_archived ? 0 : ios_copy_all_lua_files(documents);
+
+    // Create empty sysconf file to prevent initoptions from exiting
     FILE *sysconf = fopen(sysconf_path, "w");
     if (sysconf) {
         fprintf(sysconf, "# iOS NetHack sysconf\n");
         fprintf(sysconf, "# Empty config - all defaults\n");
         fclose(sysconf);
         fprintf(stderr, "[IOS_FILESYS] Created empty sysconf file at: %s\n", sysconf_path);
+    } else {
+        failed++;
+    }
+
+    // Partial provisioning retries on the next launch
+    if (failed == 0) {
+        ios_provision_mark(data_dir, provision_key);
+        provisioned_this_load = 1;
     }
 }
 
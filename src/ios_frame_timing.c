@@ -0,0 +1,147 @@
+/*
+ * ios_frame_timing.c - Stage latency histograms (see ios_frame_timing.h)
+ *
+ * Recording is a handful of relaxed atomic adds; stats are computed on
+ * query by walking the buckets (count is their sum). Readers may see a
+ * histogram mid-update (sum and buckets off by one) - fine for diagnostics.
+ */
+
+#include "ios_frame_timing.h"
+#include <stdatomic.h>
+#include <string.h>
+
+typedef struct {
+    _Atomic uint32_t buckets[FRAME_TIMING_BUCKETS];
+    _Atomic uint64_t sum_us;
+    _Atomic uint32_t min_inv_us;  /* UINT32_MAX - min: zero-init means no sample */
+    _Atomic uint32_t max_us;
+} StageHistogram;
+
+static StageHistogram histograms[FRAME_STAGE_COUNT];
+
+static const char *const stage_names[FRAME_STAGE_COUNT] = {
+    "wake", "turn", "snapshot", "sync", "drain", "scene", "input->frame"};
+
+static uint32_t bucket_index(uint64_t us) {
+    if (us >= (1ull << FRAME_TIMING_MAX_BITS)) {
+        us = (1ull << FRAME_TIMING_MAX_BITS) - 1;
+    }
+    if (us < FRAME_TIMING_SUB_BUCKETS) {
+        return (uint32_t)us;
+    }
+    uint32_t msb = 63 - (uint32_t)__builtin_clzll(us);
+    uint32_t shift = msb - FRAME_TIMING_SUB_BITS;
+    return (msb - FRAME_TIMING_SUB_BITS + 1) * FRAME_TIMING_SUB_BUCKETS +
+           (uint32_t)((us >> shift) & (FRAME_TIMING_SUB_BUCKETS - 1));
+}
+
+NETHACK_EXPORT uint32_t ios_frame_timing_bucket_floor_us(uint32_t index) {
+    if (index < FRAME_TIMING_SUB_BUCKETS) {
+        return index;
+    }
+    if (index >= FRAME_TIMING_BUCKETS) {
+        index = FRAME_TIMING_BUCKETS - 1;
+    }
+    uint32_t shift = index / FRAME_TIMING_SUB_BUCKETS - 1;
+    uint32_t sub = index % FRAME_TIMING_SUB_BUCKETS;
+    return (FRAME_TIMING_SUB_BUCKETS + sub) << shift;
+}
+
+/* Highest value in bucket index (conservative percentile report) */
+static uint32_t bucket_ceil_us(uint32_t index) {
+    if (index + 1 >= FRAME_TIMING_BUCKETS) {
+        return (1u << FRAME_TIMING_MAX_BITS) - 1;
+    }
+    return ios_frame_timing_bucket_floor_us(index + 1) - 1;
+}
+
+NETHACK_EXPORT void ios_frame_timing_record(int stage, uint64_t duration_ns) {
+    if (stage < 0 || stage >= FRAME_STAGE_COUNT) return;
+
+    StageHistogram *h = &histograms[stage];
+    uint64_t us = duration_ns / 1000;
+    uint32_t clamped = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+
+    atomic_fetch_add_explicit(&h->buckets[bucket_index(us)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum_us, us, memory_order_relaxed);
+
+    /* min is kept inverted so both extremes are a CAS-max */
+    uint32_t inv = UINT32_MAX - clamped;
+    uint32_t cur = atomic_load_explicit(&h->min_inv_us, memory_order_relaxed);
+    while (inv > cur &&
+           !atomic_compare_exchange_weak_explicit(&h->min_inv_us, &cur, inv,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    cur = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    while (clamped > cur &&
+           !atomic_compare_exchange_weak_explicit(&h->max_us, &cur, clamped,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+NETHACK_EXPORT bool ios_get_frame_timing_stats(int stage, FrameTimingStats *out) {
+    if (!out || stage < 0 || stage >= FRAME_STAGE_COUNT) return false;
+
+    StageHistogram *h = &histograms[stage];
+    uint32_t counts[FRAME_TIMING_BUCKETS];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < FRAME_TIMING_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->count = total;
+    if (total == 0) return true;
+
+    uint32_t max_us = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    out->min_us = UINT32_MAX - atomic_load_explicit(&h->min_inv_us, memory_order_relaxed);
+    out->max_us = max_us;
+    out->mean_us = (uint32_t)(atomic_load_explicit(&h->sum_us, memory_order_relaxed) / total);
+
+    /* Rank thresholds (ceil) for p50/p90/p99 */
+    uint64_t r50 = (total * 50 + 99) / 100;
+    uint64_t r90 = (total * 90 + 99) / 100;
+    uint64_t r99 = (total * 99 + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < FRAME_TIMING_BUCKETS; i++) {
+        if (counts[i] == 0) continue;
+        seen += counts[i];
+        uint32_t v = bucket_ceil_us(i);
+        if (v > max_us) v = max_us;
+        if (!out->p50_us && seen >= r50) out->p50_us = v;
+        if (!out->p90_us && seen >= r90) out->p90_us = v;
+        if (!out->p99_us && seen >= r99) {
+            out->p99_us = v;
+            break;
+        }
+    }
+    return true;
+}
+
+NETHACK_EXPORT uint32_t ios_get_frame_timing_histogram(int stage, uint32_t *buckets, uint32_t max_buckets) {
+    if (!buckets || stage < 0 || stage >= FRAME_STAGE_COUNT) return 0;
+
+    uint32_t n = max_buckets < FRAME_TIMING_BUCKETS ? max_buckets : FRAME_TIMING_BUCKETS;
+    for (uint32_t i = 0; i < n; i++) {
+        buckets[i] = atomic_load_explicit(&histograms[stage].buckets[i], memory_order_relaxed);
+    }
+    return n;
+}
+
+NETHACK_EXPORT const char *ios_frame_timing_stage_name(int stage) {
+    if (stage < 0 || stage >= FRAME_STAGE_COUNT) return "?";
+    return stage_names[stage];
+}
+
+NETHACK_EXPORT void ios_frame_timing_reset(void) {
+    for (int s = 0; s < FRAME_STAGE_COUNT; s++) {
+        StageHistogram *h = &histograms[s];
+        for (uint32_t i = 0; i < FRAME_TIMING_BUCKETS; i++) {
+            atomic_store_explicit(&h->buckets[i], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&h->sum_us, 0, memory_order_relaxed);
+        atomic_store_explicit(&h->min_inv_us, 0, memory_order_relaxed);
+        atomic_store_explicit(&h->max_us, 0, memory_order_relaxed);
+    }
+}
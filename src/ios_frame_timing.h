@@ -0,0 +1,76 @@
+/*
+ * ios_frame_timing.h - Per-turn stage timing with log-linear histograms
+ *
+ * Measures where a turn's wall time goes on the input -> pixel path:
+ *
+ *   key queued (ios_queue_input)
+ *     -> INPUT_WAKE   game thread returns from ios_nh_poskey_blocking
+ *     -> TURN         NetHack command work until ios_wait_synch
+ *     -> SYNC         ios_wait_synch (delta flush, SNAPSHOT, capture)
+ *     -> DRAIN        Swift consumeRenderQueue
+ *     -> SCENE        SceneKit map update
+ *   INPUT_TO_FRAME    key queued -> frame presented (end to end)
+ *
+ * HISTOGRAMS (HDR-style, microseconds):
+ * - 0-7us: one bucket per microsecond; above that 8 sub-buckets per power
+ *   of two (<= 12.5% error), up to 2^27us (~134s, larger values clamp)
+ * - Fixed storage, atomic counters: any thread may record
+ */
+
+#ifndef IOS_FRAME_TIMING_H
+#define IOS_FRAME_TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nethack_export.h"
+
+/* Stages (order is ABI for Swift, append only) */
+typedef enum {
+    FRAME_STAGE_INPUT_WAKE = 0,  /* Key queued -> poskey returns */
+    FRAME_STAGE_TURN,            /* poskey returns -> wait_synch */
+    FRAME_STAGE_SNAPSHOT,        /* update_game_state_snapshot() */
+    FRAME_STAGE_SYNC,            /* Whole ios_wait_synch() */
+    FRAME_STAGE_DRAIN,           /* Swift: render queue drain */
+    FRAME_STAGE_SCENE,           /* Swift: SceneKit map update */
+    FRAME_STAGE_INPUT_TO_FRAME,  /* Key queued -> frame presented */
+    FRAME_STAGE_COUNT
+} FrameTimingStage;
+
+#define FRAME_TIMING_SUB_BITS 3
+#define FRAME_TIMING_SUB_BUCKETS (1 << FRAME_TIMING_SUB_BITS)
+#define FRAME_TIMING_MAX_BITS 27
+#define FRAME_TIMING_BUCKETS ((FRAME_TIMING_MAX_BITS - FRAME_TIMING_SUB_BITS + 1) * FRAME_TIMING_SUB_BUCKETS)
+
+/* Summary of one stage (all values in microseconds) */
+typedef struct {
+    uint64_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+} FrameTimingStats;
+
+/* Record a stage duration (any thread) */
+NETHACK_EXPORT void ios_frame_timing_record(int stage, uint64_t duration_ns);
+
+/* Summary for stage; false if stage is out of range */
+NETHACK_EXPORT bool ios_get_frame_timing_stats(int stage, FrameTimingStats *out);
+
+/* Copy raw bucket counts for stage; returns buckets written */
+NETHACK_EXPORT uint32_t ios_get_frame_timing_histogram(int stage, uint32_t *buckets, uint32_t max_buckets);
+
+/* Smallest value (us) that lands in bucket index */
+NETHACK_EXPORT uint32_t ios_frame_timing_bucket_floor_us(uint32_t index);
+
+/* Short stage label ("wake", "turn", ...) */
+NETHACK_EXPORT const char *ios_frame_timing_stage_name(int stage);
+
+/* Clear all histograms */
+NETHACK_EXPORT void ios_frame_timing_reset(void);
+
+/* Swift: a frame showing the latest input was presented (ios_winprocs.c) */
+NETHACK_EXPORT void ios_frame_timing_frame_presented(void);
+
+#endif /* IOS_FRAME_TIMING_H */
@@ -21,6 +21,8 @@
 #include "hack.h"
 #include "dlb.h"
 #include "ios_game_lifecycle.h"
+#include "ios_lua_pool.h"
+#include "ios_lua_state.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -83,6 +85,7 @@ NETHACK_EXPORT void ios_shutdown_game(void) {
     /* Step 3: Shutdown Lua interpreter */
     fprintf(stderr, "[LIFECYCLE] Step 3: l_nhcore_done() - Shutting down Lua...\n");
     l_nhcore_done();
+    ios_lua_state_shutdown();  /* Idle warm level-generation states */
     fprintf(stderr, "[LIFECYCLE]   ✓ Lua state destroyed\n");
 
     /* Step 3.5: Finish status system (CRITICAL before memory wipe!) */
@@ -165,7 +168,7 @@ NETHACK_EXPORT void ios_reinit_subsystems(void) {
 
     /* Step 2: Create new Lua state */
     fprintf(stderr, "[LIFECYCLE] Step 2: l_nhcore_init() - Creating Lua state...\n");
-    l_nhcore_init();
+    ios_lua_core_init();  /* l_nhcore_init() in the Lua pool's core arena */
     fprintf(stderr, "[LIFECYCLE]   ✓ Lua interpreter ready\n");
 
     /* Step 2.25: Re-initialize status system */
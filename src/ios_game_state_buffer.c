@@ -1,14 +1,23 @@
 /*
  * ios_game_state_buffer.c - Lock-Free Game State Buffer Implementation
  *
- * DOUBLE BUFFERING:
- * - Two buffers: buffers[0] and buffers[1]
- * - Writer fills inactive buffer, then atomically swaps index
- * - Reader always reads from current_buffer_index (safe, no tearing)
- * - NO LOCKS needed!
+ * SEQLOCK PUBLICATION:
+ * - Writer fills private staging buffer (readers never see it)
+ * - Publish: seq -> odd, copy staging into published, seq -> even
+ * - Reader: read seq (retry while odd), copy, re-read seq; retry on change
+ * - Version handed to Swift is seq / 2 (completed publications)
+ * - NO LOCKS needed, and a slow reader can never return a torn snapshot
+ *   (the old two-buffer swap could be lapped during fast travel)
  */
 
 #include "ios_game_state_buffer.h"
+#include "ios_read_model.h"
+#include "ios_inventory_cache.h"
+#include "ios_object_index.h"
+#include "ios_kill_stats.h"
+#include "ios_lookat_cache.h"
+#include "ios_travel_field.h"
+#include "ios_dungeon_overview.h"
 #include <string.h>
 #include <stdatomic.h>
 #include <stdio.h>
@@ -19,18 +28,112 @@
 /* External death flag - stops updates when player dies */
 extern int player_has_died;
 
-/* Double buffer */
-static GameStateSnapshot buffers[2];
-static _Atomic int current_buffer_index = 0;
+/*
+ * Level feature index (writer only)
+ * Rebuilt on level change (u.uz), on time going backwards (restore), when an
+ * indexed feature's terrain mutates (fountain dried up, altar destroyed), or
+ * on ios_game_state_invalidate_features(). Otherwise a turn costs a few
+ * levl[][] probes instead of a full COLNO x ROWNO scan.
+ */
+typedef struct {
+    bool valid;
+    d_level uz;          /* Level the index describes */
+    long moves;          /* svm.moves at last validation */
+    int32_t stairs_up_x, stairs_up_y;
+    int32_t stairs_down_x, stairs_down_y;
+    int32_t altar_x, altar_y;
+    int32_t fountain_x, fountain_y;
+} LevelFeatureIndex;
+
+static LevelFeatureIndex feature_index;
+
+/* Writer-private staging buffer + seqlock-published copy */
+static GameStateSnapshot staging;
+static GameStateSnapshot published;
+static _Atomic uint32_t snapshot_seq = 0;
+
+/*
+ * Publish staging (writer only). Skipped when nothing changed so the
+ * version - and Swift's copy - only move on real changes, unless forced.
+ */
+static void publish_snapshot(bool force)
+{
+    /* Only the writer mutates published, so this compare is race-free */
+    if (!force && memcmp(&staging, &published, sizeof(GameStateSnapshot)) == 0) {
+        return;
+    }
+
+    uint32_t seq = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+    atomic_store_explicit(&snapshot_seq, seq + 1, memory_order_relaxed);  /* odd: writing */
+    atomic_thread_fence(memory_order_release);
+
+    published = staging;  /* memcpy */
+
+    atomic_store_explicit(&snapshot_seq, seq + 2, memory_order_release);  /* even: stable */
+}
 
 /*
  * Initialize buffer (called once at startup)
  */
 void init_game_state_buffer(void)
 {
-    memset(&buffers[0], 0, sizeof(GameStateSnapshot));
-    memset(&buffers[1], 0, sizeof(GameStateSnapshot));
-    atomic_store(&current_buffer_index, 0);
+    /* Always publish the empty snapshot, rather than rewinding seq: versions
+     * Swift already holds must not match the new game's, and on the first
+     * init (published still all zero) the version leaves 0 ("none") */
+    memset(&staging, 0, sizeof(GameStateSnapshot));
+    publish_snapshot(true);
+    ios_game_state_invalidate_features();
+    ios_read_model_reset();
+    ios_inventory_cache_invalidate();
+    ios_object_index_invalidate();
+    ios_kill_stats_reset();
+    ios_lookat_cache_clear();
+    ios_travel_field_invalidate();
+    ios_dungeon_overview_reset();
+}
+
+/*
+ * Force a feature index rebuild on the next snapshot (terrain-mutation hook)
+ */
+void ios_game_state_invalidate_features(void)
+{
+    feature_index.valid = false;
+}
+
+/*
+ * Note a redrawn map cell (called from print_glyph). A feature the index
+ * has none of appearing in view forces a rebuild - O(1) per call.
+ */
+void ios_game_state_note_cell(int x, int y)
+{
+    if (!feature_index.valid || !isok(x, y)) return;
+
+    int typ = levl[x][y].typ;
+    if ((IS_ALTAR(typ) && feature_index.altar_x < 0)
+        || (IS_FOUNTAIN(typ) && feature_index.fountain_x < 0)) {
+        feature_index.valid = false;
+    }
+}
+
+/*
+ * Copy published snapshot consistently (any thread).
+ * Returns the even sequence number the copy belongs to.
+ */
+static uint32_t read_snapshot(GameStateSnapshot *out)
+{
+    for (;;) {
+        uint32_t before = atomic_load_explicit(&snapshot_seq, memory_order_acquire);
+        if (before & 1) {
+            continue;  /* Publish in progress (~2KB memcpy) - retry */
+        }
+
+        *out = published;  /* memcpy */
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&snapshot_seq, memory_order_relaxed) == before) {
+            return before;
+        }
+    }
 }
 
 /*
@@ -39,8 +142,24 @@ void init_game_state_buffer(void)
 void ios_get_game_state_snapshot(GameStateSnapshot *out)
 {
     if (!out) return;
-    int read_idx = atomic_load(&current_buffer_index);
-    *out = buffers[read_idx];  /* memcpy */
+    read_snapshot(out);
+}
+
+/*
+ * Get snapshot only if newer than *last_version (Swift bridge)
+ */
+bool ios_get_game_state_snapshot_if_newer(GameStateSnapshot *out, uint32_t *last_version)
+{
+    if (!out || !last_version) return false;
+
+    /* Fast path: unchanged (or mid-publish of what caller will see next time) */
+    uint32_t seq = atomic_load_explicit(&snapshot_seq, memory_order_acquire);
+    if (seq / 2 == *last_version) {
+        return false;
+    }
+
+    *last_version = read_snapshot(out) / 2;
+    return true;
 }
 
 /*
@@ -109,52 +228,135 @@ static void detect_adjacent_doors(GameStateSnapshot *snapshot)
     snapshot->adjacent_door_count = door_count;
 }
 
+/*
+ * Rebuild the level feature index (full levl[][] scan - level change only)
+ */
+static void rebuild_feature_index(void)
+{
+    extern struct instance_globals_saved_m svm;
+
+    feature_index.stairs_up_x = feature_index.stairs_up_y = -1;
+    feature_index.stairs_down_x = feature_index.stairs_down_y = -1;
+    feature_index.altar_x = feature_index.altar_y = -1;
+    feature_index.fountain_x = feature_index.fountain_y = -1;
+
+    /* Find stairs using NetHack's stairway_find_dir() functions */
+    stairway *stway_up = stairway_find_dir(TRUE);  /* Find upward stairs */
+    if (stway_up) {
+        feature_index.stairs_up_x = stway_up->sx;
+        feature_index.stairs_up_y = stway_up->sy;
+    }
+
+    stairway *stway_down = stairway_find_dir(FALSE);  /* Find downward stairs */
+    if (stway_down) {
+        feature_index.stairs_down_x = stway_down->sx;
+        feature_index.stairs_down_y = stway_down->sy;
+    }
+
+    /* Scan for first altar and fountain (same order as before: x-major) */
+    for (int x = 1; x < COLNO; x++) {
+        for (int y = 0; y < ROWNO; y++) {
+            if (IS_ALTAR(levl[x][y].typ) && feature_index.altar_x == -1) {
+                feature_index.altar_x = x;
+                feature_index.altar_y = y;
+            }
+            if (IS_FOUNTAIN(levl[x][y].typ) && feature_index.fountain_x == -1) {
+                feature_index.fountain_x = x;
+                feature_index.fountain_y = y;
+            }
+        }
+    }
+
+    feature_index.uz = u.uz;
+    feature_index.moves = svm.moves;
+    feature_index.valid = true;
+}
+
+/*
+ * Make sure the feature index describes the current level
+ */
+static void refresh_feature_index(void)
+{
+    extern struct instance_globals_saved_m svm;
+
+    bool stale = !feature_index.valid
+                 || !on_level(&feature_index.uz, &u.uz)
+                 || svm.moves < feature_index.moves;  /* restore / new game */
+
+    /* Terrain mutation: indexed feature no longer there */
+    if (!stale && feature_index.altar_x >= 0
+        && !IS_ALTAR(levl[feature_index.altar_x][feature_index.altar_y].typ)) {
+        stale = true;
+    }
+    if (!stale && feature_index.fountain_x >= 0
+        && !IS_FOUNTAIN(levl[feature_index.fountain_x][feature_index.fountain_y].typ)) {
+        stale = true;
+    }
+
+    if (stale) {
+        rebuild_feature_index();
+    } else {
+        feature_index.moves = svm.moves;
+    }
+}
+
+/*
+ * Add one monster to the snapshot's enemy list
+ */
+static void add_nearby_enemy(GameStateSnapshot *snapshot, struct monst *mtmp, int dist)
+{
+    SnapshotEnemyInfo *enemy = &snapshot->nearby_enemies[snapshot->nearby_enemy_count];
+    const char *name = mon_nam(mtmp);
+    strncpy(enemy->name, name, 63);
+    enemy->name[63] = '\0';
+    enemy->x = mtmp->mx;
+    enemy->y = mtmp->my;
+    enemy->distance = dist;
+    enemy->hp = mtmp->mhp;
+    enemy->max_hp = mtmp->mhpmax;
+    enemy->is_hostile = !mtmp->mpeaceful;
+    enemy->is_peaceful = mtmp->mpeaceful;
+    enemy->glyph_char = monsym(mtmp->data);
+
+    snapshot->nearby_enemy_count++;
+}
+
 /*
  * Detect nearby enemies and fill snapshot
+ *
+ * Uses NetHack's own per-cell monster grid (level.monsters, via m_at) as the
+ * spatial buckets: walk Manhattan rings outward from the player, so cost is
+ * bounded by the radius (221 cells) instead of the level's monster count,
+ * and the MAX_NEARBY_ENEMIES cap keeps the closest ones.
  */
+#define NEARBY_ENEMY_RADIUS 10
+
 static void detect_nearby_enemies(GameStateSnapshot *snapshot)
 {
     int px = u.ux;
     int py = u.uy;
-    int enemy_count = 0;
 
-    /* Guard: fmon could be NULL if no monsters on level */
-    if (!fmon) {
-        snapshot->nearby_enemy_count = 0;
-        return;
-    }
+    snapshot->nearby_enemy_count = 0;
 
-    /* Scan nearby monsters (simple radius check for PoC) */
-    struct monst *mtmp;
-    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
-        if (DEADMONSTER(mtmp)) continue;
-        if (!mtmp->data) continue;
-
-        int mx = mtmp->mx;
-        int my = mtmp->my;
-
-        /* Manhattan distance */
-        int dist = abs(mx - px) + abs(my - py);
-        if (dist > 10) continue;  /* Only nearby enemies */
-        if (enemy_count >= MAX_NEARBY_ENEMIES) break;
-
-        SnapshotEnemyInfo *enemy = &snapshot->nearby_enemies[enemy_count];
-        const char *name = mon_nam(mtmp);
-        strncpy(enemy->name, name, 63);
-        enemy->name[63] = '\0';
-        enemy->x = mx;
-        enemy->y = my;
-        enemy->distance = dist;
-        enemy->hp = mtmp->mhp;
-        enemy->max_hp = mtmp->mhpmax;
-        enemy->is_hostile = !mtmp->mpeaceful;
-        enemy->is_peaceful = mtmp->mpeaceful;
-        enemy->glyph_char = monsym(mtmp->data);
-
-        enemy_count++;
-    }
+    for (int dist = 0; dist <= NEARBY_ENEMY_RADIUS; dist++) {
+        for (int dx = -dist; dx <= dist; dx++) {
+            int rest = dist - abs(dx);
+            /* Two cells per dx on the ring (one when rest == 0) */
+            for (int side = 0; side < (rest ? 2 : 1); side++) {
+                int x = px + dx;
+                int y = py + (side ? -rest : rest);
+                if (!isok(x, y)) continue;
+
+                struct monst *mtmp = m_at(x, y);
+                if (!mtmp || DEADMONSTER(mtmp) || !mtmp->data) continue;
+                /* Long worm tail segments share the head's monst */
+                if (mtmp->mx != x || mtmp->my != y) continue;
 
-    snapshot->nearby_enemy_count = enemy_count;
+                if (snapshot->nearby_enemy_count >= MAX_NEARBY_ENEMIES) return;
+                add_nearby_enemy(snapshot, mtmp, dist);
+            }
+        }
+    }
 }
 
 /*
@@ -173,10 +375,8 @@ void update_game_state_snapshot(void)
         return;
     }
 
-    /* Get write buffer (inactive buffer) */
-    int read_idx = atomic_load(&current_buffer_index);
-    int write_idx = (read_idx + 1) % 2;
-    GameStateSnapshot *snapshot = &buffers[write_idx];
+    /* Build into private staging buffer (published at the end) */
+    GameStateSnapshot *snapshot = &staging;
 
     /* Clear previous data */
     memset(snapshot, 0, sizeof(GameStateSnapshot));
@@ -233,43 +433,16 @@ void update_game_state_snapshot(void)
     snapshot->is_sink = IS_SINK(levl[px][py].typ);
     snapshot->is_throne = IS_THRONE(levl[px][py].typ);
 
-    /* Find level features (stairs, altar, fountain) */
-    /* Initialize to -1 (not found) */
-    snapshot->stairs_up_x = -1;
-    snapshot->stairs_up_y = -1;
-    snapshot->stairs_down_x = -1;
-    snapshot->stairs_down_y = -1;
-    snapshot->altar_x = -1;
-    snapshot->altar_y = -1;
-    snapshot->fountain_x = -1;
-    snapshot->fountain_y = -1;
-
-    /* Find stairs using NetHack's stairway_find_dir() functions */
-    stairway *stway_up = stairway_find_dir(TRUE);  /* Find upward stairs */
-    if (stway_up) {
-        snapshot->stairs_up_x = stway_up->sx;
-        snapshot->stairs_up_y = stway_up->sy;
-    }
-
-    stairway *stway_down = stairway_find_dir(FALSE);  /* Find downward stairs */
-    if (stway_down) {
-        snapshot->stairs_down_x = stway_down->sx;
-        snapshot->stairs_down_y = stway_down->sy;
-    }
-
-    /* Scan for first visible altar and fountain */
-    for (int x = 1; x < COLNO; x++) {
-        for (int y = 0; y < ROWNO; y++) {
-            if (IS_ALTAR(levl[x][y].typ) && snapshot->altar_x == -1) {
-                snapshot->altar_x = x;
-                snapshot->altar_y = y;
-            }
-            if (IS_FOUNTAIN(levl[x][y].typ) && snapshot->fountain_x == -1) {
-                snapshot->fountain_x = x;
-                snapshot->fountain_y = y;
-            }
-        }
-    }
+    /* Level features (stairs, altar, fountain) from the incremental index */
+    refresh_feature_index();
+    snapshot->stairs_up_x = feature_index.stairs_up_x;
+    snapshot->stairs_up_y = feature_index.stairs_up_y;
+    snapshot->stairs_down_x = feature_index.stairs_down_x;
+    snapshot->stairs_down_y = feature_index.stairs_down_y;
+    snapshot->altar_x = feature_index.altar_x;
+    snapshot->altar_y = feature_index.altar_y;
+    snapshot->fountain_x = feature_index.fountain_x;
+    snapshot->fountain_y = feature_index.fountain_y;
 
     /* Detect adjacent doors */
     detect_adjacent_doors(snapshot);
@@ -312,6 +485,9 @@ void update_game_state_snapshot(void)
     snapshot->has_container = has_container;
     snapshot->has_locked_container = has_locked_container;
 
-    /* Atomic swap - readers now see new data (lock-free!) */
-    atomic_store(&current_buffer_index, write_idx);
+    /* Seqlock publish - readers now see new data (lock-free!) */
+    publish_snapshot(false);
+
+    /* Inventory / equipment / status / floor for panels (ios_read_model.h) */
+    ios_read_model_publish();
 }
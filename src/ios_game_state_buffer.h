@@ -4,7 +4,7 @@
  * ARCHITECTURE: Push Model (Write on NetHack thread, Read on Swift main thread)
  * - NetHack writes snapshot after each turn (moves++)
  * - Swift reads snapshot anytime (NO async, NO waiting!)
- * - Double buffering for lock-free thread-safe reads
+ * - Seqlock publication for lock-free thread-safe reads
  *
  * PERFORMANCE BENEFITS:
  * - No async query overhead
@@ -15,7 +15,11 @@
  * THREAD SAFETY:
  * - Writer: NetHack game thread (after each command)
  * - Reader: Swift main thread (anytime)
- * - Double buffering with atomic index swap (lock-free!)
+ * - Writer builds into a private staging buffer, then publishes it under a
+ *   sequence counter (odd = publish in progress). Readers retry if the
+ *   counter moved during their copy, so a torn snapshot is never returned.
+ * - Version = completed publications; unchanged snapshots are not republished,
+ *   so ios_get_game_state_snapshot_if_newer() can skip the copy entirely.
  */
 
 #ifndef IOS_GAME_STATE_BUFFER_H
@@ -66,7 +70,7 @@ typedef struct {
 /*
  * Complete game state snapshot
  * Written by NetHack thread, read by Swift thread
- * Double-buffered for lock-free access
+ * Seqlock-published for lock-free access
  */
 typedef struct {
     /* Turn tracking (for change detection) */
@@ -131,6 +135,33 @@ NETHACK_EXPORT void update_game_state_snapshot(void);
  */
 NETHACK_EXPORT void ios_get_game_state_snapshot(GameStateSnapshot *out);
 
+/*
+ * Get snapshot only if it changed since *last_version (called by Swift)
+ * THREAD: Swift main thread (or any thread)
+ * PARAMS: out - filled only when returning true
+ *         last_version - in: version caller already has (0 = none)
+ *                        out: version now in out
+ * RETURNS: true if out was filled with a newer snapshot
+ * PERFORMANCE: one atomic load when unchanged
+ */
+NETHACK_EXPORT bool ios_get_game_state_snapshot_if_newer(GameStateSnapshot *out,
+                                                         uint32_t *last_version);
+
+/*
+ * Invalidate the level feature index (stairs/altar/fountain coordinates)
+ * THREAD: NetHack game thread
+ * Level changes, restores and vanished features are detected automatically,
+ * and ios_game_state_note_cell() catches features appearing in view; call
+ * this after terrain edits that can add a feature out of sight.
+ */
+void ios_game_state_invalidate_features(void);
+
+/*
+ * Note a redrawn map cell so newly visible features reach the index
+ * THREAD: NetHack game thread (print_glyph)
+ */
+void ios_game_state_note_cell(int x, int y);
+
 /*
  * Initialize game state buffer (called once at startup)
  */
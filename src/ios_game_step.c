@@ -0,0 +1,94 @@
+/*
+ * ios_game_step.c - Stepped game loop (see ios_game_step.h)
+ *
+ * nethack_run_game_threaded() keeps its setjmp exit point: nethack_exit()'s
+ * longjmp stays on the coroutine stack, so death and quit unwind exactly
+ * as in threaded mode and the coroutine then finishes.
+ */
+
+#include "ios_game_step.h"
+#include "ios_coroutine.h"
+#include "ios_input_ring.h"
+#include "ios_log.h"
+#include <stdatomic.h>
+
+extern void nethack_run_game_threaded(void);
+extern volatile int game_thread_running;
+
+static IOSCoroutine *game_co;
+static _Atomic int step_state = IOS_STEP_IDLE;
+static atomic_flag stepping = ATOMIC_FLAG_INIT;
+
+static void run_game(void *arg)
+{
+    (void)arg;
+    nethack_run_game_threaded();
+}
+
+/* Resume the coroutine once; caller holds the stepping flag */
+static int resume_locked(void)
+{
+    if (ios_coroutine_resume(game_co)) {
+        atomic_store(&step_state, IOS_STEP_NEEDS_INPUT);
+    } else {
+        IOS_LOG_I(IOS_LOG_CAT_INPUT, "Stepped game finished");
+        ios_coroutine_destroy(game_co);
+        game_co = NULL;
+        atomic_store(&step_state, IOS_STEP_FINISHED);
+    }
+    return atomic_load(&step_state);
+}
+
+int ios_game_step_start(void)
+{
+    if (atomic_flag_test_and_set(&stepping)) return atomic_load(&step_state);
+
+    int state;
+    if (game_co) {
+        state = atomic_load(&step_state);  /* Already running */
+    } else {
+        game_co = ios_coroutine_create(run_game, NULL, IOS_GAME_STEP_STACK_SIZE);
+        if (!game_co) {
+            IOS_LOG_E(IOS_LOG_CAT_INPUT, "Stepped game: coroutine stack allocation failed");
+            atomic_store(&step_state, IOS_STEP_FAILED);
+            state = IOS_STEP_FAILED;
+        } else {
+            IOS_LOG_I(IOS_LOG_CAT_INPUT, "Stepped game starting");
+            state = resume_locked();
+        }
+    }
+
+    atomic_flag_clear(&stepping);
+    return state;
+}
+
+int ios_game_step(void)
+{
+    if (atomic_flag_test_and_set(&stepping)) return atomic_load(&step_state);
+
+    int state = atomic_load(&step_state);
+    if (game_co && !ios_game_step_active()) {
+        /* Parked with nothing to read and no exit pending: nothing would happen */
+        bool idle = state == IOS_STEP_NEEDS_INPUT && ios_input_ring_empty() && game_thread_running;
+        if (!idle) state = resume_locked();
+    }
+
+    atomic_flag_clear(&stepping);
+    return state;
+}
+
+int ios_game_step_state(void)
+{
+    return atomic_load(&step_state);
+}
+
+bool ios_game_step_active(void)
+{
+    return game_co && ios_coroutine_current() == game_co;
+}
+
+void ios_game_step_wait_input(void)
+{
+    if (!ios_game_step_active()) return;
+    ios_coroutine_yield();
+}
@@ -0,0 +1,52 @@
+/*
+ * ios_game_step.h - Run moveloop() as a resumable step instead of a thread
+ *
+ * Threaded mode parks a whole thread inside moveloop(), blocked on the
+ * input ring between commands. Stepped mode runs the same
+ * nethack_run_game_threaded() body on an ios_coroutine stack: every input
+ * wait in the window port (nhgetch, poskey, menus, yn, getlin, ext cmds)
+ * yields back to the host instead of blocking, and the host continues the
+ * game by calling ios_game_step() from whatever executor it likes.
+ *
+ * HOST PROTOCOL:
+ *   ios_game_step_start()            after nethack_start_new_game / restore
+ *   push keys (ios_queue_input_string)
+ *   ios_game_step()                  runs until NetHack wants more input
+ *   ... repeat; after ios_request_game_exit(), step once more so the game
+ *   unwinds, until IOS_STEP_FINISHED
+ *
+ * THREAD SAFETY: steps may come from different threads but must not
+ * overlap; an overlapping call returns the current state without running.
+ */
+
+#ifndef IOS_GAME_STEP_H
+#define IOS_GAME_STEP_H
+
+#include <stdbool.h>
+#include "nethack_export.h"
+
+typedef enum {
+    IOS_STEP_IDLE = 0,          /* No stepped game */
+    IOS_STEP_NEEDS_INPUT = 1,   /* Parked in an input wait: queue keys, then step */
+    IOS_STEP_FINISHED = 2,      /* moveloop returned or the game exited */
+    IOS_STEP_FAILED = 3         /* Could not map the coroutine stack */
+} IOSStepState;
+
+/* Coroutine stack for moveloop (GCD worker threads get 512KB) */
+#define IOS_GAME_STEP_STACK_SIZE (1024 * 1024)
+
+/* Create the game coroutine and run it to its first input wait */
+NETHACK_EXPORT int ios_game_step_start(void);
+
+/* Run until the next input wait; returns without running if no key is queued */
+NETHACK_EXPORT int ios_game_step(void);
+
+NETHACK_EXPORT int ios_game_step_state(void);
+
+/* Window port: true when the caller is on the stepped game's stack */
+bool ios_game_step_active(void);
+
+/* Window port: hand control back to the host until the next ios_game_step() */
+void ios_game_step_wait_input(void);
+
+#endif /* IOS_GAME_STEP_H */
@@ -0,0 +1,82 @@
+/*
+ * ios_glyph_table.h - Precomputed glyph -> render attributes table
+ *
+ * Built once per symbol set by ios_winprocs.c (after ios_setup_default_symbols
+ * and whenever the active graphics set / symset options change), so both the
+ * C draw path and Swift resolve a glyph with a single indexed load.
+ *
+ * THREAD SAFETY:
+ * - Writer: NetHack game thread (rebuilds into the inactive of two tables,
+ *   then publishes pointer + generation with release ordering)
+ * - Reader: any thread; refetch when the generation changes
+ * - The generation is a sequence: odd while a rebuild writes, +2 per
+ *   publish. The second rebuild after a fetch rewrites the fetched buffer,
+ *   so a reader that keeps the pointer checks after reading an entry that
+ *   the generation is at most (fetched & ~1) + 2 (IOS_GLYPH_TABLE_INTACT),
+ *   and refetches otherwise.
+ */
+
+#ifndef IOS_GLYPH_TABLE_H
+#define IOS_GLYPH_TABLE_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* Coarse tile class - mirrors Swift's TileType (order is ABI, append only) */
+typedef enum {
+    GLYPH_TILE_UNKNOWN = 0,
+    GLYPH_TILE_FLOOR,
+    GLYPH_TILE_WALL,
+    GLYPH_TILE_DOOR,         /* Doorway / broken door */
+    GLYPH_TILE_DOOR_OPEN,
+    GLYPH_TILE_DOOR_CLOSED,
+    GLYPH_TILE_CORRIDOR,
+    GLYPH_TILE_STAIRS,       /* Stairs and ladders */
+    GLYPH_TILE_WATER,
+    GLYPH_TILE_LAVA,
+    GLYPH_TILE_ALTAR,
+    GLYPH_TILE_FOUNTAIN,
+    GLYPH_TILE_THRONE,
+    GLYPH_TILE_SINK,
+    GLYPH_TILE_TRAP,
+    GLYPH_TILE_MONSTER,
+    GLYPH_TILE_PLAYER,       /* Only via '@' fallback - hero glyph is per-call */
+    GLYPH_TILE_ITEM,
+    GLYPH_TILE_GOLD,
+    GLYPH_TILE_FOOD,
+    GLYPH_TILE_WEAPON,
+    GLYPH_TILE_ARMOR,
+    GLYPH_TILE_POTION,
+    GLYPH_TILE_SCROLL,
+    GLYPH_TILE_WAND,
+    GLYPH_TILE_RING,
+    GLYPH_TILE_AMULET,
+    GLYPH_TILE_TOOL
+} GlyphTileClass;
+
+/* One table entry (8 bytes) */
+typedef struct {
+    char ch;              /* Display character (never 0) */
+    uint8_t color;        /* NetHack color index */
+    uint8_t tile_class;   /* GlyphTileClass */
+    uint8_t reserved;
+    uint32_t glyphflags;  /* MG_* flags of the glyph itself (MG_PET etc.);
+                             per-square ones (MG_HERO, MG_OBJPILE) are only
+                             in the map cell */
+} GlyphRenderInfo;
+
+/* Entries read from a table fetched at generation fetched are valid if,
+ * read after them, the generation is now */
+#define IOS_GLYPH_TABLE_INTACT(fetched, now) \
+    ((uint32_t)((now) - ((fetched) & ~1u)) <= 2u)
+
+/* Current table (indexed by glyph number, count entries)
+ * Returns NULL until the symbol system has been initialized.
+ * generation (optional) receives the table generation - refetch on change.
+ */
+NETHACK_EXPORT const GlyphRenderInfo *ios_get_glyph_table(uint32_t *count, uint32_t *generation);
+
+/* Current table generation (0 = not built yet, odd = rebuild in progress) */
+NETHACK_EXPORT uint32_t ios_get_glyph_table_generation(void);
+
+#endif /* IOS_GLYPH_TABLE_H */
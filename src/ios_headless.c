@@ -0,0 +1,57 @@
+/*
+ * ios_headless.c - Headless simulation mode (see ios_headless.h)
+ */
+
+#include "../NetHack/include/hack.h"
+#include "ios_headless.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+volatile int ios_headless_active = 0;
+
+static uint64_t start_ns;
+static long start_moves;
+static uint64_t sync_count;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void ios_set_headless(int enabled)
+{
+    if (enabled && !ios_headless_active) {
+        start_ns = now_ns();
+        start_moves = svm.moves;
+        sync_count = 0;
+    }
+    ios_headless_active = enabled ? 1 : 0;
+
+    fprintf(stderr, "[HEADLESS] %s\n", enabled ? "Enabled (rendering and pacing off)" : "Disabled");
+    fflush(stderr);
+}
+
+int ios_get_headless(void)
+{
+    return ios_headless_active;
+}
+
+void ios_headless_get_stats(IOSHeadlessStats *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    out->enabled = ios_headless_active;
+    if (!start_ns) return;
+
+    out->turns = svm.moves - start_moves;
+    out->syncs = sync_count;
+    out->elapsed_ns = now_ns() - start_ns;
+}
+
+void ios_headless_note_sync(void)
+{
+    sync_count++;
+}
@@ -0,0 +1,54 @@
+/*
+ * ios_headless.h - Headless simulation mode (no rendering, no pacing)
+ *
+ * For bots, replay verification and throughput benchmarks. While enabled
+ * the window port keeps the game's own state (messages, status block,
+ * inventory cache, level store) but skips everything that only exists to
+ * put pixels on screen:
+ *
+ *   print_glyph          no map buffers, dirty cells or glyph batches
+ *   putstr               message log only; no render queue, no output buffer
+ *   display/wait_synch   no capture, snapshot, turn marker or main-queue notify
+ *   delay_output         returns at once (no travel/run usleep pacing)
+ *   status / clear_map   no render queue pushes
+ *
+ * Keys come from the input ring as usual; the autoplay flags
+ * (ios_parse_debug_flags "--headless", ios_autoplay.c) pick the character,
+ * and a bot or replay feeds commands. Toggle between games: the Swift map
+ * is not rebuilt when headless mode is switched off mid-level.
+ */
+
+#ifndef IOS_HEADLESS_H
+#define IOS_HEADLESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+typedef struct {
+    int32_t enabled;
+    int32_t reserved;
+    int64_t turns;              /* Game turns since headless mode was enabled */
+    uint64_t syncs;             /* ios_wait_synch calls (roughly: commands) */
+    uint64_t elapsed_ns;        /* Wall time since enabled */
+} IOSHeadlessStats;
+
+/* Read on every draw call: plain load, written only between games */
+extern volatile int ios_headless_active;
+
+static inline bool ios_is_headless(void)
+{
+    return ios_headless_active != 0;
+}
+
+NETHACK_EXPORT void ios_set_headless(int enabled);
+
+NETHACK_EXPORT int ios_get_headless(void);
+
+/* Throughput since ios_set_headless(1): turns, commands, wall time */
+NETHACK_EXPORT void ios_headless_get_stats(IOSHeadlessStats *out);
+
+/* Window port: one ios_wait_synch in headless mode */
+void ios_headless_note_sync(void);
+
+#endif /* IOS_HEADLESS_H */
@@ -0,0 +1,701 @@
+/*
+ * ios_hibernate.c - Instant resume from a hibernation image (see ios_hibernate.h)
+ */
+
+#include "../NetHack/include/hack.h"
+#include "../zone_allocator/nethack_memory_final.h"
+#include "../zone_allocator/nh_image_codec.h"
+#include "../zone_allocator/nethack_heap_snapshot.h"
+#include "ios_hibernate.h"
+#include "ios_input_ring.h"
+#include "ios_input_journal.h"
+#include "ios_save_manifest.h"
+#include "ios_log.h"
+#include <dispatch/dispatch.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <dlfcn.h>
+#include <mach-o/dyld.h>
+#include <mach-o/getsect.h>
+#include <mach-o/loader.h>
+#endif
+
+#define HIBERNATE_IMAGE "hibernate.img"
+#define HIBERNATE_HEAP "hibernate.heap"
+#define HIBERNATE_MAGIC "NHHIBER3"
+#define HIBERNATE_LEDGERS 128             /* Ledger numbers fit an xint8 */
+
+#define AUTOSAVE_BASE "autosave.base"
+#define AUTOSAVE_DELTA "autosave.delta"
+#define AUTOSAVE_DEFAULT_TURNS 50
+#define AUTOSAVE_PARK_TRIES 50            /* 1ms apart, while the game thread reaches its wait */
+
+typedef struct {
+    char magic[8];
+    uint8_t build_uuid[16];
+    uint64_t image_start;                 /* Binary's mapped range at capture */
+    uint64_t image_size;
+    uint64_t shared_cache;
+    uint64_t heap_base;
+    uint64_t heap_used;
+    uint64_t state_size;                  /* Bytes of the state section that follow */
+    int64_t moves;
+    uint64_t level_files[HIBERNATE_LEDGERS / 64];  /* Ledgers whose level file must exist */
+    uint64_t level_stamps[HIBERNATE_LEDGERS];      /* ... unchanged since (level_stamp) */
+    char level_base[512];                 /* Level file path without ".<ledger>" */
+    char character[PL_NSIZ];              /* svp.plname */
+    uint64_t save_length;                 /* savegame beside the image at capture (0 = none) */
+    uint64_t save_hash;
+} HibernateHeader;
+
+/* An autosave record carries the header as its blob */
+_Static_assert(sizeof(HibernateHeader) <= NH_SNAP_META_MAX, "HibernateHeader outgrew a snapshot blob");
+
+/* The binary NetHack's globals live in, as loaded now */
+typedef struct {
+    uint8_t uuid[16];
+    uintptr_t start;
+    size_t size;
+    uint8_t *state;
+    size_t state_size;
+} LoadedImage;
+
+static atomic_bool command_wait = false;
+static atomic_bool capture_pending = false;
+static atomic_bool image_live = false;   /* An image of the running game is on disk */
+
+/* Character the next load is for (ios_hibernate_expect), "" = any */
+static char expected_character[PL_NSIZ];
+
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IOSHibernateStats stats;
+
+/* Autosave: the snapshot chain and its files belong to whoever holds the mutex */
+static pthread_mutex_t autosave_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int autosave_turns = AUTOSAVE_DEFAULT_TURNS;
+static atomic_bool autosave_queued = false;
+static atomic_long autosave_moves = 0;    /* Turn and level of the last autosave */
+static atomic_int autosave_ledger = -1;
+
+static uint64_t now_ns(void)
+{
+    return (uint64_t)clock_gettime_nsec_np(CLOCK_MONOTONIC);
+}
+
+static int hibernate_dir(char *dir, size_t size)
+{
+    extern const char *get_ios_documents_path(void);
+    const char *documents = get_ios_documents_path();
+    if (!documents) return -1;
+    int len = snprintf(dir, size, "%s/save", documents);
+    return len > 0 && (size_t)len < size ? 0 : -1;
+}
+
+static void hibernate_path(char *path, size_t size, const char *dir, const char *name)
+{
+    snprintf(path, size, "%s/%s", dir, name);
+}
+
+/* The savegame the image belongs to: its digest, or zeros if there is none */
+static void save_identity(const char *dir, uint64_t *length, uint64_t *hash)
+{
+    char path[600];
+    hibernate_path(path, sizeof(path), dir, "savegame");
+    if (ios_save_manifest_digest(path, length, hash) != 0) {
+        *length = 0;
+        *hash = 0;
+    }
+}
+
+#ifdef __APPLE__
+static int loaded_image(LoadedImage *out)
+{
+    Dl_info info;
+    memset(out, 0, sizeof(*out));
+    if (!dladdr((const void *)&gl, &info) || !info.dli_fbase) return -1;
+
+    const struct mach_header_64 *header = info.dli_fbase;
+    const struct load_command *cmd = (const struct load_command *)(header + 1);
+    uint64_t low = UINT64_MAX, high = 0;
+    intptr_t slide = 0;
+    int have_uuid = 0;
+    for (uint32_t i = 0; i < header->ncmds; i++) {
+        if (cmd->cmd == LC_UUID) {
+            memcpy(out->uuid, ((const struct uuid_command *)cmd)->uuid, sizeof(out->uuid));
+            have_uuid = 1;
+        } else if (cmd->cmd == LC_SEGMENT_64) {
+            const struct segment_command_64 *seg = (const struct segment_command_64 *)cmd;
+            if (strcmp(seg->segname, SEG_PAGEZERO) != 0) {
+                if (seg->vmaddr < low) low = seg->vmaddr;
+                if (seg->vmaddr + seg->vmsize > high) high = seg->vmaddr + seg->vmsize;
+            }
+            if (strcmp(seg->segname, SEG_TEXT) == 0) {
+                slide = (intptr_t)header - (intptr_t)seg->vmaddr;
+            }
+        }
+        cmd = (const struct load_command *)((const uint8_t *)cmd + cmd->cmdsize);
+    }
+    if (!have_uuid || low >= high) return -1;
+    out->start = (uintptr_t)(low + slide);
+    out->size = (size_t)(high - low);
+
+    unsigned long state_size = 0;
+    out->state = getsectiondata(header, IOS_HIBERNATE_SEGMENT, IOS_HIBERNATE_SECTION, &state_size);
+    out->state_size = state_size;
+    return out->state && out->state_size ? 0 : -1;
+}
+
+static uint64_t shared_cache_base(void)
+{
+    size_t length = 0;
+    return (uint64_t)(uintptr_t)_dyld_get_shared_cache_range(&length);
+}
+#else
+static int loaded_image(LoadedImage *out)
+{
+    memset(out, 0, sizeof(*out));
+    return -1;  /* No section lookup on this platform */
+}
+
+static uint64_t shared_cache_base(void)
+{
+    return 0;
+}
+#endif
+
+/* write(2) until done; 0 on success */
+static int write_all(int fd, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* --- Capture --- */
+
+/* The game is between commands with nothing half-done */
+static bool game_hibernatable(void)
+{
+    return program_state.in_moveloop && !program_state.gameover &&
+           !program_state.saving && !program_state.restoring && !gi.in_mklev &&
+           program_state.something_worth_saving && u.uhp > 0 && u.uz.dlevel > 0;
+}
+
+/*
+ * A level file as it is on disk now, 0 if it is missing. The game rewrites
+ * a level's file each time it leaves that level, so an image that outlived
+ * a level change (an autosave) must not pair with a newer file.
+ */
+static uint64_t level_stamp(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    uint64_t parts[4] = { (uint64_t)st.st_size, (uint64_t)st.st_ino,
+                          (uint64_t)st.st_mtimespec.tv_sec, (uint64_t)st.st_mtimespec.tv_nsec };
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 4; i++) {
+        h = (h ^ parts[i]) * 0x100000001b3ULL;
+    }
+    return h | 1;
+}
+
+/* Level files the resumed game will open: every visited level but this one */
+static void note_level_files(HibernateHeader *header)
+{
+    set_levelfile_name(gl.lock, 0);
+    snprintf(header->level_base, sizeof(header->level_base), "%s",
+             fqname(gl.lock, LEVELPREFIX, 0));
+    char *suffix = strrchr(header->level_base, '.');
+    if (suffix) *suffix = '\0';
+
+    char path[sizeof(header->level_base) + 8];
+    xint16 current = ledger_no(&u.uz);
+    xint16 max_ledger = maxledgerno();
+    for (xint16 ledger = 1; ledger <= max_ledger && ledger < HIBERNATE_LEDGERS; ledger++) {
+        if (ledger != current && (svl.level_info[ledger].flags & LFILE_EXISTS)) {
+            header->level_files[ledger / 64] |= 1ull << (ledger % 64);
+            snprintf(path, sizeof(path), "%s.%d", header->level_base, ledger);
+            header->level_stamps[ledger] = level_stamp(path);
+        }
+    }
+}
+
+/* Everything but the savegame identity (save_identity reads a whole file) */
+static void fill_header(HibernateHeader *header, const LoadedImage *image)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, HIBERNATE_MAGIC, sizeof(header->magic));
+    memcpy(header->build_uuid, image->uuid, sizeof(header->build_uuid));
+    header->image_start = image->start;
+    header->image_size = image->size;
+    header->shared_cache = shared_cache_base();
+    header->heap_base = (uint64_t)(uintptr_t)nethack_heap;
+    header->heap_used = heap_used;
+    header->state_size = image->state_size;
+    header->moves = svm.moves;
+    note_level_files(header);
+    snprintf(header->character, sizeof(header->character), "%s", svp.plname);
+}
+
+static int capture(void)
+{
+    uint64_t start = now_ns();
+    LoadedImage image;
+    char dir[512], image_path[600], heap_path[600], tmp_path[620];
+
+    if (!atomic_load(&command_wait) || !game_hibernatable()) return -1;
+    if (loaded_image(&image) != 0 || hibernate_dir(dir, sizeof(dir)) != 0) return -1;
+    hibernate_path(image_path, sizeof(image_path), dir, HIBERNATE_IMAGE);
+    hibernate_path(heap_path, sizeof(heap_path), dir, HIBERNATE_HEAP);
+
+    /* The old header must never pair with the new heap */
+    unlink(image_path);
+    atomic_store(&image_live, false);
+
+    /* Raw, so the resume maps it instead of decoding it */
+    NhImageCodec codec = nh_image_default_codec();
+    nh_image_set_default_codec(NH_IMAGE_NONE);
+    int heap_failed = nh_save_state(heap_path) != 0;
+    nh_image_set_default_codec(codec);
+    if (heap_failed) return -1;
+
+    HibernateHeader header;
+    fill_header(&header, &image);
+    save_identity(dir, &header.save_length, &header.save_hash);
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", image_path);
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return -1;
+    int failed = write_all(fd, &header, sizeof(header)) != 0 ||
+                 write_all(fd, image.state, image.state_size) != 0 || fsync(fd) != 0;
+    close(fd);
+    if (failed || rename(tmp_path, image_path) != 0) {
+        IOS_LOG_W(IOS_LOG_CAT_SAVE, "[HIBERNATE] Image write failed: %s", strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
+    atomic_store(&image_live, true);
+
+    uint64_t elapsed = now_ns() - start;
+    pthread_mutex_lock(&stats_mutex);
+    stats.captures++;
+    stats.last_capture_ns = elapsed;
+    stats.last_image_bytes = heap_used + image.state_size;
+    pthread_mutex_unlock(&stats_mutex);
+    IOS_LOG_I(IOS_LOG_CAT_SAVE, "[HIBERNATE] Captured turn %ld: %zu KB heap + %zu KB globals in %.1f ms",
+              svm.moves, heap_used / 1024, image.state_size / 1024, elapsed / 1e6);
+    return 0;
+}
+
+static void capture_parked(void *ctx)
+{
+    *(int *)ctx = capture();
+}
+
+NETHACK_EXPORT int ios_hibernate_request(void)
+{
+    int result = -1;
+    if (ios_input_ring_run_parked(capture_parked, &result) && result == 0) return 1;
+
+    /* Busy mid-command, or parked at a prompt inside one */
+    if (!program_state.in_moveloop || program_state.gameover) return -1;
+    atomic_store(&capture_pending, true);
+    pthread_mutex_lock(&stats_mutex);
+    stats.deferred++;
+    pthread_mutex_unlock(&stats_mutex);
+    return 0;
+}
+
+NETHACK_EXPORT void ios_hibernate_cancel(void)
+{
+    atomic_store(&capture_pending, false);
+}
+
+void ios_hibernate_set_command_wait(bool waiting)
+{
+    atomic_store(&command_wait, waiting);
+}
+
+void ios_hibernate_poll(void)
+{
+    if (!atomic_load_explicit(&capture_pending, memory_order_relaxed)) return;
+    if (atomic_load(&command_wait) && atomic_exchange(&capture_pending, false)) {
+        capture();
+    }
+}
+
+static void discard_image(void)
+{
+    char dir[512], path[600];
+    atomic_store(&image_live, false);
+    if (hibernate_dir(dir, sizeof(dir)) != 0) return;
+    hibernate_path(path, sizeof(path), dir, HIBERNATE_IMAGE);
+    unlink(path);
+    hibernate_path(path, sizeof(path), dir, HIBERNATE_HEAP);
+    unlink(path);
+}
+
+void ios_hibernate_key_taken(void)
+{
+    if (!atomic_load_explicit(&image_live, memory_order_relaxed)) return;
+    discard_image();
+    pthread_mutex_lock(&stats_mutex);
+    stats.discards++;
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+void ios_hibernate_discard(void)
+{
+    char dir[512], path[600];
+    discard_image();
+    if (hibernate_dir(dir, sizeof(dir)) != 0) return;
+
+    /* Waits out an autosave being written, which could land after the unlink */
+    pthread_mutex_lock(&autosave_mutex);
+    nh_snapshot_invalidate();
+    hibernate_path(path, sizeof(path), dir, AUTOSAVE_BASE);
+    unlink(path);
+    hibernate_path(path, sizeof(path), dir, AUTOSAVE_DELTA);
+    unlink(path);
+    pthread_mutex_unlock(&autosave_mutex);
+}
+
+/* --- Autosave --- */
+
+typedef struct {
+    HibernateHeader header;
+    NhSnapshot *snap;
+    NhSnapshotResult staged;
+    bool at_prompt;            /* Staged at a command prompt (snap may still be NULL) */
+    bool failed;
+    long moves;
+    int ledger;
+} AutosaveJob;
+
+static dispatch_queue_t autosave_queue(void)
+{
+    static dispatch_queue_t queue;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        queue = dispatch_queue_create("nethack.autosave.writer", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+/* Run parked: hash and copy what changed, nothing else */
+static void autosave_stage(void *ctx)
+{
+    AutosaveJob *job = ctx;
+    LoadedImage image;
+
+    if (!atomic_load(&command_wait) || !game_hibernatable() || loaded_image(&image) != 0) return;
+    job->at_prompt = true;
+    fill_header(&job->header, &image);
+    job->moves = svm.moves;
+    job->ledger = ledger_no(&u.uz);
+    job->failed = nh_snapshot_stage(image.state, image.state_size, &job->snap, &job->staged) != 0;
+}
+
+/* Writer queue: stage at the game thread's next input wait, then write */
+static void autosave_run(void)
+{
+    AutosaveJob job;
+    bool parked = false;
+    char dir[512], base_path[600], delta_path[600];
+
+    pthread_mutex_lock(&autosave_mutex);
+    for (int tries = 0; !parked && tries < AUTOSAVE_PARK_TRIES; tries++) {
+        memset(&job, 0, sizeof(job));
+        parked = ios_input_ring_run_parked(autosave_stage, &job);
+        if (!parked) {
+            /* Queued at the prompt, before the game thread parked there */
+            pthread_mutex_unlock(&autosave_mutex);
+            usleep(1000);
+            pthread_mutex_lock(&autosave_mutex);
+        }
+    }
+
+    NhSnapshotResult written = { 0 };
+    int failed = job.failed;
+    bool staged = job.snap != NULL;  /* NULL with nothing changed */
+    if (staged) {
+        if (hibernate_dir(dir, sizeof(dir)) != 0) {
+            nh_snapshot_drop(job.snap);
+            failed = 1;
+        } else {
+            hibernate_path(base_path, sizeof(base_path), dir, AUTOSAVE_BASE);
+            hibernate_path(delta_path, sizeof(delta_path), dir, AUTOSAVE_DELTA);
+            save_identity(dir, &job.header.save_length, &job.header.save_hash);
+            failed = nh_snapshot_commit(job.snap, &job.header, sizeof(job.header),
+                                        base_path, delta_path, &written) != 0;
+        }
+    }
+    pthread_mutex_unlock(&autosave_mutex);
+
+    bool done = parked && job.at_prompt && !failed;
+    if (done) {
+        atomic_store(&autosave_moves, job.moves);
+        atomic_store(&autosave_ledger, job.ledger);
+    }
+    pthread_mutex_lock(&stats_mutex);
+    if (failed) {
+        stats.autosave_failures++;
+    } else if (!done) {
+        stats.autosave_skipped++;
+    } else if (staged) {
+        stats.autosaves++;
+        if (written.was_base) stats.autosave_bases++;
+        stats.last_autosave_stall_ns = job.staged.duration_ns;
+        stats.last_autosave_write_ns = written.duration_ns;
+        stats.last_autosave_bytes = written.bytes_written;
+    }
+    pthread_mutex_unlock(&stats_mutex);
+    if (done && staged) {
+        IOS_LOG_I(IOS_LOG_CAT_SAVE, "[HIBERNATE] Autosave %s turn %ld: %zu/%zu pages, %zu KB, "
+                  "%.1f ms staged, %.1f ms written",
+                  written.was_base ? "base" : "delta", job.moves, written.pages_written,
+                  job.staged.pages_scanned, written.bytes_written / 1024,
+                  job.staged.duration_ns / 1e6, written.duration_ns / 1e6);
+    } else if (failed) {
+        IOS_LOG_W(IOS_LOG_CAT_SAVE, "[HIBERNATE] Autosave failed, the next one writes a base");
+    }
+    atomic_store(&autosave_queued, false);
+}
+
+void ios_hibernate_autosave_command_wait(void)
+{
+    int turns = atomic_load_explicit(&autosave_turns, memory_order_relaxed);
+    if (turns < 0 || ios_is_replaying() || atomic_load(&autosave_queued) || !game_hibernatable()) {
+        return;
+    }
+
+    long last = atomic_load(&autosave_moves);
+    bool level_changed = ledger_no(&u.uz) != atomic_load(&autosave_ledger);
+    bool turns_due = turns > 0 && (svm.moves - last >= turns || svm.moves < last);
+    if (!level_changed && !turns_due) return;
+
+    atomic_store(&autosave_queued, true);
+    dispatch_async(autosave_queue(), ^{
+        autosave_run();
+    });
+}
+
+NETHACK_EXPORT void ios_hibernate_set_autosave_turns(int turns)
+{
+    atomic_store(&autosave_turns, turns);
+}
+
+/* --- Resume --- */
+
+static int check_image(const HibernateHeader *header, const LoadedImage *image,
+                       const char *save_dir)
+{
+    if (memcmp(header->magic, HIBERNATE_MAGIC, sizeof(header->magic)) != 0 ||
+        memcmp(header->build_uuid, image->uuid, sizeof(image->uuid)) != 0 ||
+        header->state_size != image->state_size) {
+        return IOS_HIBERNATE_BUILD_MISMATCH;
+    }
+    /* Pointers into system libraries are not rebased */
+    if (header->shared_cache != shared_cache_base()) return IOS_HIBERNATE_SYSTEM_MISMATCH;
+    if (!nethack_heap || header->heap_base != (uint64_t)(uintptr_t)nethack_heap) {
+        return IOS_HIBERNATE_HEAP_MISMATCH;
+    }
+
+    /* Another character's game, or this one from another save */
+    if (expected_character[0] &&
+        strncmp(header->character, expected_character, sizeof(header->character)) != 0) {
+        return IOS_HIBERNATE_IDENTITY_MISMATCH;
+    }
+    uint64_t save_length, save_hash;
+    save_identity(save_dir, &save_length, &save_hash);
+    if (save_length != header->save_length || save_hash != header->save_hash) {
+        return IOS_HIBERNATE_IDENTITY_MISMATCH;
+    }
+
+    char path[sizeof(header->level_base) + 8];
+    for (int ledger = 1; ledger < HIBERNATE_LEDGERS; ledger++) {
+        if (!(header->level_files[ledger / 64] & (1ull << (ledger % 64)))) continue;
+        snprintf(path, sizeof(path), "%s.%d", header->level_base, ledger);
+        uint64_t stamp = level_stamp(path);
+        if (stamp == 0) return IOS_HIBERNATE_LEVELS_MISSING;
+        if (stamp != header->level_stamps[ledger]) return IOS_HIBERNATE_LEVELS_CHANGED;
+    }
+    return IOS_HIBERNATE_OK;
+}
+
+/* Add delta to the words of [start, start + size) that point into the old image */
+static size_t rebase_words(uint8_t *start, size_t size, uintptr_t old_start, size_t old_size,
+                           ptrdiff_t delta)
+{
+    size_t rewritten = 0;
+    uintptr_t *word = (uintptr_t *)(((uintptr_t)start + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1));
+    uintptr_t *end = (uintptr_t *)(((uintptr_t)start + size) & ~(sizeof(uintptr_t) - 1));
+    for (; word < end; word++) {
+        if (*word - old_start < old_size) {
+            *word += (uintptr_t)delta;
+            rewritten++;
+        }
+    }
+    return rewritten;
+}
+
+static int refuse(int reason, const char *what)
+{
+    if (reason == IOS_HIBERNATE_NO_IMAGE) return reason;  /* Not a refusal: nothing to resume */
+    pthread_mutex_lock(&stats_mutex);
+    stats.refusals++;
+    stats.last_refusal = reason;
+    pthread_mutex_unlock(&stats_mutex);
+    IOS_LOG_I(IOS_LOG_CAT_SAVE, "[HIBERNATE] %s refused (reason %d)", what, reason);
+    return reason;
+}
+
+void ios_hibernate_expect(const char *character)
+{
+    snprintf(expected_character, sizeof(expected_character), "%s", character ? character : "");
+}
+
+/* The heap is loaded: put the globals back and rebase both if the binary moved */
+static void resume_state(const HibernateHeader *header, const LoadedImage *image,
+                         const uint8_t *state, uint64_t start, bool autosave)
+{
+    memcpy(image->state, state, image->state_size);
+    ptrdiff_t slide = (ptrdiff_t)(image->start - (uintptr_t)header->image_start);
+    size_t rebased = 0;
+    if (slide) {
+        rebased = rebase_words(image->state, image->state_size, (uintptr_t)header->image_start,
+                               (size_t)header->image_size, slide);
+        rebased += nh_heap_rebase((uintptr_t)header->image_start, (size_t)header->image_size, slide);
+    }
+
+    /* Lua memory was never in the image: the caller builds a new core state
+     * and themes load again on demand */
+    gl.luacore = NULL;
+    for (int i = 0; i < MAXDUNGEON; i++) {
+        gl.luathemes[i] = NULL;
+    }
+    program_state.in_moveloop = 0;  /* moveloop(TRUE) enters it again */
+
+    uint64_t elapsed = now_ns() - start;
+    pthread_mutex_lock(&stats_mutex);
+    if (autosave) {
+        stats.autosave_resumes++;
+    } else {
+        stats.resumes++;
+    }
+    stats.last_resume_ns = elapsed;
+    stats.last_rebased = rebased;
+    stats.last_refusal = IOS_HIBERNATE_OK;
+    pthread_mutex_unlock(&stats_mutex);
+    IOS_LOG_I(IOS_LOG_CAT_SAVE, "[HIBERNATE] Resumed turn %ld from the %s in %.1f ms (slide %+td, %zu words rebased)",
+              (long)header->moves, autosave ? "autosave" : "image", elapsed / 1e6, slide, rebased);
+}
+
+static int load_image(const char *save_dir, uint64_t start)
+{
+    LoadedImage image;
+    char image_path[600], heap_path[600];
+    struct stat st;
+
+    hibernate_path(image_path, sizeof(image_path), save_dir, HIBERNATE_IMAGE);
+    hibernate_path(heap_path, sizeof(heap_path), save_dir, HIBERNATE_HEAP);
+
+    int fd = open(image_path, O_RDONLY);
+    if (fd < 0) return IOS_HIBERNATE_NO_IMAGE;
+    if (loaded_image(&image) != 0) {
+        close(fd);
+        return IOS_HIBERNATE_UNSUPPORTED;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != sizeof(HibernateHeader) + image.state_size) {
+        close(fd);
+        return IOS_HIBERNATE_BUILD_MISMATCH;
+    }
+
+    /* Mapped, not read: malloc is the heap about to be replaced */
+    uint8_t *file = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) return IOS_HIBERNATE_IO_ERROR;
+    const HibernateHeader *header = (const HibernateHeader *)file;
+
+    int reason = check_image(header, &image, save_dir);
+    if (reason == IOS_HIBERNATE_OK && nh_load_state(heap_path) != 0) {
+        reason = IOS_HIBERNATE_IO_ERROR;  /* Heap reset; the normal restore starts from that */
+    }
+    if (reason == IOS_HIBERNATE_OK) {
+        resume_state(header, &image, file + sizeof(HibernateHeader), start, false);
+        atomic_store(&image_live, true);
+    }
+    munmap(file, (size_t)st.st_size);
+    return reason;
+}
+
+static int load_autosave(const char *save_dir, uint64_t start)
+{
+    LoadedImage image;
+    HibernateHeader header;
+    char base_path[600], delta_path[600];
+
+    hibernate_path(base_path, sizeof(base_path), save_dir, AUTOSAVE_BASE);
+    hibernate_path(delta_path, sizeof(delta_path), save_dir, AUTOSAVE_DELTA);
+    if (access(base_path, R_OK) != 0) return IOS_HIBERNATE_NO_IMAGE;
+    if (loaded_image(&image) != 0) return IOS_HIBERNATE_UNSUPPORTED;
+
+    /* The globals land in scratch first: a failed load must not leave them half-written */
+    uint8_t *state = NULL;
+    pthread_mutex_lock(&autosave_mutex);
+    int reason = nh_snapshot_peek(base_path, delta_path, &header, sizeof(header)) == (int)sizeof(header)
+        ? check_image(&header, &image, save_dir) : IOS_HIBERNATE_BUILD_MISMATCH;
+    if (reason == IOS_HIBERNATE_OK) {
+        state = mmap(NULL, image.state_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (state == MAP_FAILED) {
+            state = NULL;
+            reason = IOS_HIBERNATE_IO_ERROR;
+        } else if (nh_snapshot_load(base_path, delta_path, state, image.state_size) != 0) {
+            reason = IOS_HIBERNATE_IO_ERROR;  /* Heap reset, as for an image */
+        }
+    }
+    pthread_mutex_unlock(&autosave_mutex);
+
+    if (reason == IOS_HIBERNATE_OK) {
+        resume_state(&header, &image, state, start, true);
+    }
+    if (state) munmap(state, image.state_size);
+    return reason;
+}
+
+int ios_hibernate_load(const char *save_dir)
+{
+    if (!save_dir) return IOS_HIBERNATE_NO_IMAGE;
+
+    int image = refuse(load_image(save_dir, now_ns()), "Image");
+    if (image == IOS_HIBERNATE_OK) return image;
+
+    /* No image, or a refused one: the last autosave of this game still
+     * beats a normal restore. Its own checks decide. */
+    int autosave = refuse(load_autosave(save_dir, now_ns()), "Autosave");
+    if (autosave == IOS_HIBERNATE_OK) return autosave;
+    return image != IOS_HIBERNATE_NO_IMAGE ? image : autosave;
+}
+
+NETHACK_EXPORT void ios_hibernate_get_stats(IOSHibernateStats *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&stats_mutex);
+    *out = stats;
+    pthread_mutex_unlock(&stats_mutex);
+}
@@ -0,0 +1,153 @@
+/*
+ * ios_hibernate.h - Instant resume from a hibernation image
+ *
+ * When iOS kills the app in the background, the next launch used to go
+ * through the full ios_restore_complete: savegame parsing, level
+ * extraction, timer relinking and the rest of the post-restore fixups.
+ * Hibernation skips all of it. On backgrounding, at a command prompt, the
+ * game's exact in-memory state is written next to the save:
+ *
+ *   hibernate.heap  the static heap as a raw image (nh_save_state with no
+ *                   codec), which nh_load_state maps copy-on-write, so
+ *                   pages load on first touch
+ *   hibernate.img   a header plus NetHack's writable globals, which the
+ *                   NetHack sources keep in one section
+ *                   (ios_hibernate_section.h)
+ *
+ * The heap sits at a fixed address, so heap pointers need no fixing. The
+ * binary can be loaded elsewhere, so words that point into it (mons[],
+ * string literals, function pointers) are rebased by the difference.
+ * State that belongs to the dead process is rebuilt rather than restored:
+ * the Lua states, the window system, the status fields and the bridge
+ * itself, none of which is in the image.
+ *
+ * ios_restore_complete tries the image first and restores normally
+ * whenever it is refused: a different build (LC_UUID), a different
+ * shared cache (the system was updated or rebooted), another heap base, a
+ * visited level's file gone (a later save consolidated it), another
+ * character or savegame, or no image. The header names the character
+ * (svp.plname) and the savegame beside it at capture (its length and
+ * hash), so the image only resumes the game that savegame belongs to. The
+ * checks all run before anything is loaded.
+ *
+ * The image is valid only while the game has not moved on. The first key
+ * taken after a capture deletes it, and so do a new game, a save, a game
+ * exit (exit to menu) and a normal restore.
+ *
+ * AUTOSAVE: the same image, kept while the game moves on, so a crash or a
+ * kill without a background capture resumes close to where it happened:
+ *
+ *   autosave.base   every page of the heap and of the globals section
+ *   autosave.delta  the pages that changed since, one record per autosave,
+ *                   each with the header it completes
+ *                   (zone_allocator/nethack_heap_snapshot.h)
+ *
+ * The first command prompt on a new level, or the first one set_autosave_
+ * turns turns after the last autosave, queues one on a writer queue. The
+ * writer stages it while the game thread is parked at that prompt (the
+ * dirty pages are hashed and copied, ~1-2ms; a key arriving meanwhile
+ * waits that long) and writes and fsyncs it while the game runs on. A
+ * prompt left before the writer got to it is skipped; the next one
+ * retries. Level files are stamped (size, inode, mtime), so an autosave
+ * refuses to resume against a level file rewritten after it. Resume tries
+ * the hibernation image first, then the autosave; a new game, a save, an
+ * exit and a normal restore delete both.
+ *
+ * THREAD SAFETY: request, cancel, set_autosave_turns and stats from any
+ * thread. The capture runs on the caller's thread while the game thread
+ * is held at its input wait (ios_input_ring_run_parked), or on the game
+ * thread at its next command prompt; autosaves stage the same way from
+ * the writer queue. discard waits for an autosave being written.
+ * Everything else runs on the game thread.
+ */
+
+#ifndef IOS_HIBERNATE_H
+#define IOS_HIBERNATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* Where ios_hibernate_section.h puts NetHack's globals */
+#define IOS_HIBERNATE_SEGMENT "__DATA"
+#define IOS_HIBERNATE_SECTION "__nh_state"
+
+/* Why a resume was refused (IOSHibernateStats.last_refusal) */
+#define IOS_HIBERNATE_OK              0
+#define IOS_HIBERNATE_NO_IMAGE        1
+#define IOS_HIBERNATE_BUILD_MISMATCH  2
+#define IOS_HIBERNATE_SYSTEM_MISMATCH 3  /* Shared cache moved */
+#define IOS_HIBERNATE_HEAP_MISMATCH   4
+#define IOS_HIBERNATE_LEVELS_MISSING  5
+#define IOS_HIBERNATE_IO_ERROR        6
+#define IOS_HIBERNATE_UNSUPPORTED     7  /* No state section in this build */
+#define IOS_HIBERNATE_IDENTITY_MISMATCH 8  /* Another character, or another savegame */
+#define IOS_HIBERNATE_LEVELS_CHANGED  9  /* A level file was rewritten after the capture */
+
+typedef struct {
+    uint64_t captures;
+    uint64_t deferred;          /* Requests that waited for a command prompt */
+    uint64_t discards;          /* Images dropped because the game moved on */
+    uint64_t resumes;
+    uint64_t refusals;          /* Resume refused: normal restore ran */
+    uint64_t last_capture_ns;
+    uint64_t last_resume_ns;
+    uint64_t last_image_bytes;  /* Heap + globals of the last capture */
+    uint64_t last_rebased;      /* Words rebased by the last resume */
+    int32_t last_refusal;       /* IOS_HIBERNATE_* */
+    uint64_t autosaves;         /* Records written, bases included */
+    uint64_t autosave_bases;
+    uint64_t autosave_skipped;  /* The game left the prompt before it was staged */
+    uint64_t autosave_failures;
+    uint64_t autosave_resumes;
+    uint64_t last_autosave_stall_ns;  /* Game thread held while staging */
+    uint64_t last_autosave_write_ns;  /* Write + fsync, off the game thread */
+    uint64_t last_autosave_bytes;
+} IOSHibernateStats;
+
+/*
+ * Swift, on entering the background: capture now if the game thread is
+ * parked at a command prompt. Returns 1 if captured, 0 if deferred to the
+ * next command prompt, -1 if there is no game to hibernate.
+ */
+NETHACK_EXPORT int ios_hibernate_request(void);
+
+/* Swift, back in the foreground: drop a deferred request */
+NETHACK_EXPORT void ios_hibernate_cancel(void);
+
+/* Game thread (ios_nh_poskey): entering or leaving a command key wait */
+void ios_hibernate_set_command_wait(bool waiting);
+
+/* Game thread, at each input wait: run a deferred capture */
+void ios_hibernate_poll(void);
+
+/* Game thread, entering a command key wait: queue an autosave if one is due */
+void ios_hibernate_autosave_command_wait(void);
+
+/*
+ * Autosave on every level change and every turns turns (default 50);
+ * 0 = on level changes only, negative = off. Never while replaying a journal.
+ */
+NETHACK_EXPORT void ios_hibernate_set_autosave_turns(int turns);
+
+/* Game thread: a key was taken, so the image is stale */
+void ios_hibernate_key_taken(void);
+
+/* Delete the image and the autosave (new game, save, game exit, or a normal restore superseded them) */
+void ios_hibernate_discard(void);
+
+/* The character the next ios_hibernate_load is for (NULL or "" = any) */
+void ios_hibernate_expect(const char *character);
+
+/*
+ * Put NetHack's heap and globals back from save_dir's image, or else its
+ * autosave. Returns IOS_HIBERNATE_OK, or the reason it was refused (the
+ * image's, if there was one). The
+ * caller still has to bring up the window system and the Lua core state
+ * (ios_restore_complete does).
+ */
+int ios_hibernate_load(const char *save_dir);
+
+NETHACK_EXPORT void ios_hibernate_get_stats(IOSHibernateStats *out);
+
+#endif /* IOS_HIBERNATE_H */
@@ -0,0 +1,24 @@
+/*
+ * ios_hibernate_section.h - Gather NetHack's writable globals in one section
+ *
+ * Force-included (-include) when compiling NetHack's own sources only
+ * ($ORIGIN_DIR/...), never the bridge or Lua. Every initialized and
+ * zero-initialized variable those files define (the instance globals,
+ * u, flags, objects[], mons[], file and function statics) lands in
+ * __DATA,__nh_state, so a hibernation image
+ * (ios_hibernate.h) can save and put back all of NetHack's static state as
+ * one range without touching the bridge's (mutexes, queues, callbacks).
+ * Zero-initialized variables become file-backed data there, which grows
+ * the binary by NetHack's bss. Never include this from bridge code: the
+ * pragma applies to the rest of the translation unit. ios_hibernate.h
+ * names the section for the code that reads it.
+ */
+
+#ifndef IOS_HIBERNATE_SECTION_H
+#define IOS_HIBERNATE_SECTION_H
+
+#if defined(__clang__) && defined(__APPLE__)
+#pragma clang section data = "__DATA,__nh_state" bss = "__DATA,__nh_state"
+#endif
+
+#endif /* IOS_HIBERNATE_SECTION_H */
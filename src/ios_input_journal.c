@@ -0,0 +1,537 @@
+/*
+ * ios_input_journal.c - Input recording and replay (see ios_input_journal.h)
+ *
+ * File: "NHJRNL1\0", u32 version, u32 reserved, i64 start time (time_t the
+ * recorded game's clock read first, 0 if it never did), then events.
+ * Integers are little-endian.
+ *
+ *   0x01 KEYS      u8 n, n key bytes
+ *   0x02 SEED      u64
+ *   0x03 IDENTITY  i8 role, i8 race, i8 gender, i8 align, u8 n, n name bytes
+ *   0x04 YN        u8 answer
+ *   0x05 MENU      i16 count (-1 = callback error), count x (u16 index, i32 count)
+ *
+ * Recording appends consecutive keys to the open KEYS run, so a key costs
+ * one byte. Replay validates the whole stream once at load and then
+ * decodes it in place with a cursor.
+ */
+
+#include "../NetHack/include/hack.h"
+#include "ios_input_journal.h"
+#include "ios_headless.h"
+#include "ios_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define JOURNAL_MAGIC "NHJRNL1"
+#define JOURNAL_VERSION 2
+#define JOURNAL_HEADER 24
+#define JOURNAL_START_AT 16         /* Start time field in the header */
+
+enum {
+    EV_END = 0,
+    EV_KEYS = 1,
+    EV_SEED = 2,
+    EV_IDENTITY = 3,
+    EV_YN = 4,
+    EV_MENU = 5
+};
+
+volatile int ios_journal_recording = 0;
+volatile int ios_journal_replaying = 0;
+
+extern void ios_request_game_exit(void);
+
+static pthread_mutex_t journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    size_t run_at;              /* Recording: count byte of the open KEYS run, 0 if none */
+    int64_t start_time;         /* First getnow() of the game, 0 until read */
+    uint64_t events;
+    uint64_t keys;
+} rec;
+
+static struct {
+    uint8_t *data;
+    size_t size;
+    size_t pos;                 /* Next undecoded event */
+    const uint8_t *run;         /* Keys left in the current KEYS run */
+    unsigned run_left;
+    int64_t start_time;         /* Clock the replayed game runs on (0 = live) */
+    int flags;
+    uint64_t events;
+    uint64_t total_events;
+    uint64_t keys;
+    int finished;
+    int diverged;
+} rep;
+
+/* ------------------------------------------------------------------------ */
+/* Recording                                                                */
+/* ------------------------------------------------------------------------ */
+
+static uint8_t *rec_reserve(size_t n)
+{
+    if (rec.size + n > rec.capacity) {
+        size_t capacity = rec.capacity ? rec.capacity * 2 : 16384;
+        while (capacity < rec.size + n) capacity *= 2;
+        uint8_t *data = realloc(rec.data, capacity);
+        if (!data) {
+            IOS_LOG_E(IOS_LOG_CAT_INPUT, "[JOURNAL] Out of memory - recording stopped");
+            ios_journal_recording = 0;
+            return NULL;
+        }
+        rec.data = data;
+        rec.capacity = capacity;
+    }
+    uint8_t *p = rec.data + rec.size;
+    rec.size += n;
+    return p;
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+/* Start a non-key event of n bytes (tag included); NULL if out of memory */
+static uint8_t *rec_event(uint8_t tag, size_t n)
+{
+    uint8_t *p = rec_reserve(n);
+    if (!p) return NULL;
+    p[0] = tag;
+    rec.run_at = 0;
+    rec.events++;
+    return p;
+}
+
+void ios_journal_start(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    rec.size = 0;
+    rec.run_at = 0;
+    rec.start_time = 0;
+    rec.events = 0;
+    rec.keys = 0;
+    uint8_t *header = rec_reserve(JOURNAL_HEADER);
+    if (header) {
+        memcpy(header, JOURNAL_MAGIC, 8);
+        put_u32(header + 8, JOURNAL_VERSION);
+        put_u32(header + 12, 0);
+        put_u64(header + JOURNAL_START_AT, 0);
+        ios_journal_recording = !ios_journal_replaying;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+
+    IOS_LOG_I(IOS_LOG_CAT_INPUT, "[JOURNAL] Recording %s",
+              ios_journal_recording ? "started" : "not started (replay running)");
+}
+
+void ios_journal_stop(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    ios_journal_recording = 0;
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+int ios_journal_save(const char *path)
+{
+    if (!path) return -1;
+
+    pthread_mutex_lock(&journal_mutex);
+    int result = -1;
+    char temp[1040];
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    FILE *f = rec.size ? fopen(temp, "wb") : NULL;
+    if (f) {
+        bool written = fwrite(rec.data, 1, rec.size, f) == rec.size;
+        written = (fclose(f) == 0) && written;
+        result = written && rename(temp, path) == 0 ? 0 : -1;
+        if (result != 0) remove(temp);
+    }
+    size_t size = rec.size;
+    uint64_t events = rec.events;
+    pthread_mutex_unlock(&journal_mutex);
+
+    if (result == 0) {
+        IOS_LOG_I(IOS_LOG_CAT_INPUT, "[JOURNAL] Saved %llu events (%zu bytes) to %s",
+                  (unsigned long long)events, size, path);
+    } else {
+        IOS_LOG_E(IOS_LOG_CAT_INPUT, "[JOURNAL] Could not save journal to %s", path);
+    }
+    return result;
+}
+
+void ios_journal_note_key(char ch)
+{
+    if (!ios_journal_recording) return;
+
+    pthread_mutex_lock(&journal_mutex);
+    if (rec.run_at && rec.data[rec.run_at] < 255) {
+        uint8_t *p = rec_reserve(1);
+        if (p) {
+            *p = (uint8_t)ch;
+            rec.data[rec.run_at]++;
+            rec.keys++;
+        }
+    } else {
+        uint8_t *p = rec_event(EV_KEYS, 3);
+        if (p) {
+            p[1] = 1;
+            p[2] = (uint8_t)ch;
+            rec.run_at = (size_t)(p + 1 - rec.data);
+            rec.keys++;
+        }
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+void ios_journal_note_yn(char answer)
+{
+    if (!ios_journal_recording) return;
+
+    pthread_mutex_lock(&journal_mutex);
+    uint8_t *p = rec_event(EV_YN, 2);
+    if (p) p[1] = (uint8_t)answer;
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+void ios_journal_note_menu(int count, const IOSJournalPick *picks)
+{
+    if (!ios_journal_recording) return;
+
+    int n = count > 0 ? count : 0;
+    pthread_mutex_lock(&journal_mutex);
+    uint8_t *p = rec_event(EV_MENU, 3 + (size_t)n * 6);
+    if (p) {
+        put_u16(p + 1, (uint16_t)(int16_t)(count < 0 ? -1 : count));
+        for (int i = 0; i < n; i++) {
+            put_u16(p + 3 + i * 6, (uint16_t)picks[i].index);
+            put_u32(p + 5 + i * 6, (uint32_t)picks[i].count);
+        }
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Replay                                                                   */
+/* ------------------------------------------------------------------------ */
+
+/* Size of the event at pos, 0 if it runs past the end or the tag is unknown */
+static size_t event_size(const uint8_t *data, size_t size, size_t pos)
+{
+    size_t left = size - pos;
+    size_t n;
+    switch (data[pos]) {
+    case EV_KEYS:     n = left >= 2 ? 2 + (size_t)data[pos + 1] : 0; break;
+    case EV_SEED:     n = 9; break;
+    case EV_IDENTITY: n = left >= 6 ? 6 + (size_t)data[pos + 5] : 0; break;
+    case EV_YN:       n = 2; break;
+    case EV_MENU: {
+        int16_t count = left >= 3 ? (int16_t)get_u16(data + pos + 1) : 0;
+        n = left >= 3 ? 3 + (size_t)(count > 0 ? count : 0) * 6 : 0;
+        break;
+    }
+    default:          return 0;
+    }
+    return n && n <= left ? n : 0;
+}
+
+/* Tag of the next event without consuming it (a KEYS run is opened) */
+static int replay_next(void)
+{
+    while (!rep.run_left) {
+        if (rep.pos >= rep.size) return EV_END;
+        if (rep.data[rep.pos] != EV_KEYS) return rep.data[rep.pos];
+        rep.run_left = rep.data[rep.pos + 1];
+        rep.run = rep.data + rep.pos + 2;
+        rep.pos += 2 + rep.run_left;
+        rep.events++;
+    }
+    return EV_KEYS;
+}
+
+/* Under journal_mutex: stop feeding input; the game falls back to live sources */
+static void replay_end_locked(const char *why, int expected)
+{
+    if (!ios_journal_replaying) return;
+    ios_journal_replaying = 0;
+    rep.finished = expected == EV_END;
+    rep.diverged = !rep.finished;
+
+    if (rep.finished) {
+        IOS_LOG_I(IOS_LOG_CAT_INPUT, "[JOURNAL] Replay finished: %llu events, %llu keys",
+                  (unsigned long long)rep.events, (unsigned long long)rep.keys);
+    } else {
+        IOS_LOG_W(IOS_LOG_CAT_INPUT,
+                  "[JOURNAL] Replay diverged at byte %zu (event %llu): game %s, journal has event %d",
+                  rep.pos, (unsigned long long)rep.events, why, expected);
+    }
+    if (rep.flags & IOS_REPLAY_EXIT_AT_END) {
+        ios_request_game_exit();
+    }
+}
+
+int ios_replay_start(const char *path, int flags)
+{
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (!f) return -1;
+
+    uint8_t *data = NULL;
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) >= JOURNAL_HEADER &&
+        fseek(f, 0, SEEK_SET) == 0 && (data = malloc((size_t)size)) &&
+        fread(data, 1, (size_t)size, f) != (size_t)size) {
+        size = -1;
+    }
+    fclose(f);
+
+    bool valid = data && size >= JOURNAL_HEADER &&
+                 memcmp(data, JOURNAL_MAGIC, 8) == 0 &&
+                 get_u32(data + 8) == JOURNAL_VERSION;
+    uint64_t events = 0;
+    for (size_t pos = JOURNAL_HEADER; valid && pos < (size_t)size; events++) {
+        size_t n = event_size(data, (size_t)size, pos);
+        valid = n != 0;
+        pos += n;
+    }
+    if (!valid) {
+        IOS_LOG_E(IOS_LOG_CAT_INPUT, "[JOURNAL] %s is not a readable journal", path);
+        free(data);
+        return -1;
+    }
+
+    pthread_mutex_lock(&journal_mutex);
+    free(rep.data);
+    memset(&rep, 0, sizeof(rep));
+    rep.data = data;
+    rep.size = (size_t)size;
+    rep.pos = JOURNAL_HEADER;
+    rep.start_time = (int64_t)get_u64(data + JOURNAL_START_AT);
+    rep.flags = flags;
+    rep.total_events = events;
+    ios_journal_recording = 0;
+    ios_journal_replaying = 1;
+    pthread_mutex_unlock(&journal_mutex);
+
+    ios_set_headless(1);  /* Full speed: nothing to draw, nothing to pace */
+    IOS_LOG_I(IOS_LOG_CAT_INPUT, "[JOURNAL] Replaying %llu events from %s",
+              (unsigned long long)events, path);
+    return 0;
+}
+
+void ios_replay_stop(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    ios_journal_replaying = 0;
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+bool ios_replay_peek_key(char *ch)
+{
+    pthread_mutex_lock(&journal_mutex);
+    bool available = ios_journal_replaying && replay_next() == EV_KEYS;
+    if (available && ch) *ch = (char)*rep.run;
+    pthread_mutex_unlock(&journal_mutex);
+    return available;
+}
+
+void ios_replay_drop_key(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    if (ios_journal_replaying && replay_next() == EV_KEYS) {
+        rep.run++;
+        rep.run_left--;
+        rep.keys++;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+void ios_replay_stall(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    if (ios_journal_replaying) {
+        replay_end_locked("waits for a key", replay_next());
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+/* Under journal_mutex: true (cursor on its payload) if the next event is tag */
+static bool replay_take_locked(int tag, const char *why)
+{
+    if (!ios_journal_replaying) return false;
+    int next = replay_next();
+    if (next != tag) {
+        replay_end_locked(why, next);
+        return false;
+    }
+    rep.events++;
+    return true;
+}
+
+bool ios_replay_yn(char *answer)
+{
+    pthread_mutex_lock(&journal_mutex);
+    bool taken = false;
+    /* A key answers through the ring; only a journaled answer is taken here */
+    if (ios_journal_replaying && replay_next() == EV_YN) {
+        taken = replay_take_locked(EV_YN, "asks yn");
+        *answer = (char)rep.data[rep.pos + 1];
+        rep.pos += 2;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+    return taken;
+}
+
+int ios_replay_menu(IOSJournalPick *picks, int max)
+{
+    pthread_mutex_lock(&journal_mutex);
+    int count = -1;
+    if (ios_journal_replaying && replay_next() == EV_MENU) {
+        replay_take_locked(EV_MENU, "opens a menu");
+        const uint8_t *p = rep.data + rep.pos;
+        count = (int16_t)get_u16(p + 1);
+        int n = count > 0 ? count : 0;
+        for (int i = 0; i < n && i < max; i++) {
+            picks[i].index = get_u16(p + 3 + i * 6);
+            picks[i].count = (int32_t)get_u32(p + 5 + i * 6);
+        }
+        if (count > max) count = max;
+        rep.pos += 3 + (size_t)n * 6;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+    return count;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Seed and identity                                                        */
+/* ------------------------------------------------------------------------ */
+
+unsigned long ios_journal_seed(unsigned long live)
+{
+    pthread_mutex_lock(&journal_mutex);
+    unsigned long seed = live;
+    if (ios_journal_replaying) {
+        if (replay_take_locked(EV_SEED, "asks for a seed")) {
+            seed = (unsigned long)get_u64(rep.data + rep.pos + 1);
+            rep.pos += 9;
+        }
+    } else if (ios_journal_recording) {
+        uint8_t *p = rec_event(EV_SEED, 9);
+        if (p) put_u64(p + 1, (uint64_t)live);
+    }
+    pthread_mutex_unlock(&journal_mutex);
+    return seed;
+}
+
+void ios_journal_identity(void)
+{
+    pthread_mutex_lock(&journal_mutex);
+    if (ios_journal_replaying) {
+        if (replay_take_locked(EV_IDENTITY, "starts a character")) {
+            const uint8_t *p = rep.data + rep.pos;
+            flags.initrole = (int8_t)p[1];
+            flags.initrace = (int8_t)p[2];
+            flags.initgend = (int8_t)p[3];
+            flags.initalign = (int8_t)p[4];
+            size_t n = p[5] < PL_NSIZ - 1 ? p[5] : PL_NSIZ - 1;
+            memcpy(svp.plname, p + 6, n);
+            svp.plname[n] = '\0';
+            rep.pos += 6 + p[5];
+        }
+    } else if (ios_journal_recording) {
+        size_t n = strnlen(svp.plname, 255);
+        uint8_t *p = rec_event(EV_IDENTITY, 6 + n);
+        if (p) {
+            p[1] = (uint8_t)(int8_t)flags.initrole;
+            p[2] = (uint8_t)(int8_t)flags.initrace;
+            p[3] = (uint8_t)(int8_t)flags.initgend;
+            p[4] = (uint8_t)(int8_t)flags.initalign;
+            p[5] = (uint8_t)n;
+            memcpy(p + 6, svp.plname, n);
+        }
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+time_t ios_journal_clock(time_t live)
+{
+    if (!ios_journal_recording && !ios_journal_replaying) return live;
+
+    pthread_mutex_lock(&journal_mutex);
+    time_t now = live;
+    if (ios_journal_replaying) {
+        if (rep.start_time) now = (time_t)rep.start_time;
+    } else if (ios_journal_recording && rec.data) {
+        if (!rec.start_time) {
+            rec.start_time = (int64_t)live;
+            put_u64(rec.data + JOURNAL_START_AT, (uint64_t)rec.start_time);
+        }
+        now = (time_t)rec.start_time;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+    return now;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Stats                                                                    */
+/* ------------------------------------------------------------------------ */
+
+void ios_journal_get_stats(IOSJournalStats *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&journal_mutex);
+    memset(out, 0, sizeof(*out));
+    out->recording = ios_journal_recording;
+    out->replaying = ios_journal_replaying;
+    if (rep.data) {
+        out->finished = rep.finished;
+        out->diverged = rep.diverged;
+        out->events = rep.events;
+        out->total_events = rep.total_events;
+        out->keys = rep.keys;
+        out->bytes = rep.size;
+    }
+    if (!rep.data || ios_journal_recording) {
+        out->events = rec.events;
+        out->keys = rec.keys;
+        out->bytes = rec.size;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
@@ -0,0 +1,123 @@
+/*
+ * ios_input_journal.h - Deterministic input recording and replay
+ *
+ * Given the same RNG seeds, character and inputs, a game replays
+ * identically. The journal records exactly those, in the order the game
+ * thread consumed them:
+ *
+ *   CLOCK     the game's start time (header): while a journal records or
+ *             replays, getnow() stands at it (ios_journal_clock.patch), so
+ *             the moon phase, Friday 13th, night() and midnight() agree
+ *   SEED      every sys_random_seed() result (init_random for both RNGs)
+ *   IDENTITY  name, role, race, gender, alignment as newgame used them
+ *   KEYS      every key taken from the input ring (runs of up to 255)
+ *   YN        every yn_function answer, after the keys it consumed
+ *             (covers mode defaults, Swift callback, next_yn_response)
+ *   MENU      selections returned by the Swift menu callback
+ *
+ * A 10,000-turn session is a few tens of KB, against a heap snapshot.
+ *
+ * Replay loads a journal and becomes the input ring's only source: the
+ * ring reports a key exactly when the next event is one, and the seed,
+ * identity, yn and menu hooks take their event instead of asking the
+ * live source. With headless mode on (ios_headless.h) the game runs at
+ * CPU speed. Replay stops when the game waits for input the journal
+ * lacks: finished if every event was consumed, diverged otherwise (the
+ * game asked for something else, i.e. the build no longer matches).
+ *
+ * Journals start at a new game; restored games are not covered. Recording
+ * is a host-harness feature: ios_parse_debug_flags("--record") starts it
+ * and the harness writes it with ios_journal_save(); the app never
+ * records. Record and replay in threaded or stepped mode (the legacy polling poskey
+ * returns "no key" without consuming anything, which is not journaled).
+ *
+ * THREAD SAFETY: hooks run on the game thread. Start/stop/save/stats may
+ * be called from any thread; they and the hooks share the journal mutex.
+ */
+
+#ifndef IOS_INPUT_JOURNAL_H
+#define IOS_INPUT_JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "nethack_export.h"
+
+/* ios_replay_start flags */
+#define IOS_REPLAY_EXIT_AT_END 1    /* Request game exit when replay stops */
+
+typedef struct {
+    int32_t index;      /* Menu item index (IOSMenuSelection.item_index) */
+    int32_t count;
+} IOSJournalPick;
+
+typedef struct {
+    int32_t recording;
+    int32_t replaying;
+    int32_t finished;           /* Replay consumed every event */
+    int32_t diverged;           /* Replay stopped with events left */
+    uint64_t events;            /* Recorded, or replayed so far */
+    uint64_t total_events;      /* Replay: events in the journal */
+    uint64_t keys;              /* Recorded, or replayed so far */
+    uint64_t bytes;             /* Journal size */
+} IOSJournalStats;
+
+/* Read by the input ring on every key: plain loads */
+extern volatile int ios_journal_recording;
+extern volatile int ios_journal_replaying;
+
+static inline bool ios_is_recording(void)
+{
+    return ios_journal_recording != 0;
+}
+
+static inline bool ios_is_replaying(void)
+{
+    return ios_journal_replaying != 0;
+}
+
+/* Start a fresh journal (before the new game starts, to catch its seeds) */
+NETHACK_EXPORT void ios_journal_start(void);
+
+NETHACK_EXPORT void ios_journal_stop(void);
+
+/* Write the journal so far to path (recording may continue); 0 or -1 */
+NETHACK_EXPORT int ios_journal_save(const char *path);
+
+/* Load path and feed it to the next new game; 0, or -1 if unreadable/malformed */
+NETHACK_EXPORT int ios_replay_start(const char *path, int flags);
+
+NETHACK_EXPORT void ios_replay_stop(void);
+
+NETHACK_EXPORT void ios_journal_get_stats(IOSJournalStats *out);
+
+/* --- Hooks (game thread) --- */
+
+/* sys_random_seed(): records live, or returns the journaled seed */
+unsigned long ios_journal_seed(unsigned long live);
+
+/* getnow() (calendar.c, ios_journal_clock.patch): live time, or the
+ * journal's start time while recording (the first read sets it) or replaying */
+time_t ios_journal_clock(time_t live);
+
+/* newgame, after the character selection is final: records or applies it */
+void ios_journal_identity(void);
+
+/* Input ring consumer: a live key was consumed */
+void ios_journal_note_key(char ch);
+
+/* Replay side of the input ring (ch may be NULL to test) */
+bool ios_replay_peek_key(char *ch);
+void ios_replay_drop_key(void);
+
+/* The game is about to wait for input: ends the replay (it has no key) */
+void ios_replay_stall(void);
+
+void ios_journal_note_yn(char answer);
+bool ios_replay_yn(char *answer);   /* True (and consumed) if the next event is a yn answer */
+
+void ios_journal_note_menu(int count, const IOSJournalPick *picks);
+/* Up to max picks of the next event; its count, or -1 if it is not a menu */
+int ios_replay_menu(IOSJournalPick *picks, int max);
+
+#endif /* IOS_INPUT_JOURNAL_H */
@@ -0,0 +1,164 @@
+/*
+ * ios_input_ring.c - Lock-free key ring (see ios_input_ring.h)
+ *
+ * Memory Ordering:
+ * - Producer: key bytes, then tail (seq_cst), then parked (seq_cst load)
+ * - Consumer: parked = 1 (seq_cst), then tail (seq_cst load) before sleeping
+ * - One of the two always sees the other's store, so a key published while
+ *   the consumer is going to sleep either stops it sleeping or wakes it.
+ *   Outside that handshake loads are acquire and stores release.
+ *
+ * Indices are free-running 32-bit counters; tail - head is the fill level.
+ */
+
+#include "ios_input_ring.h"
+#include "ios_input_journal.h"
+#include <os/lock.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define IOS_INPUT_RING_MASK (IOS_INPUT_RING_SIZE - 1)
+
+/* Destructive interference size: 128 on Apple Silicon, 64 on x86_64 */
+#define IOS_INPUT_RING_CACHE_LINE 128
+
+_Static_assert((IOS_INPUT_RING_SIZE & IOS_INPUT_RING_MASK) == 0,
+               "IOS_INPUT_RING_SIZE must be a power of 2");
+
+static struct {
+    _Alignas(IOS_INPUT_RING_CACHE_LINE) atomic_uint tail;   /* Producers publish */
+    os_unfair_lock producing;                               /* Serializes producers */
+    _Alignas(IOS_INPUT_RING_CACHE_LINE) atomic_uint head;   /* Consumer */
+    atomic_int parked;                                      /* Consumer is (about to be) asleep */
+    _Alignas(IOS_INPUT_RING_CACHE_LINE) char keys[IOS_INPUT_RING_SIZE];
+} ring = { .producing = OS_UNFAIR_LOCK_INIT };
+
+static pthread_mutex_t park_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t park_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t keys_taken;                                 /* Consumer only */
+
+bool ios_input_ring_push(const char *keys, size_t count) {
+    return ios_input_ring_push_marked(keys, count, NULL);
+}
+
+bool ios_input_ring_push_marked(const char *keys, size_t count, uint32_t *end) {
+    if (!keys || count == 0) return true;
+    if (count > IOS_INPUT_RING_SIZE) return false;
+
+    // Held only for a copy of at most IOS_INPUT_RING_SIZE bytes. A blocked
+    // producer sleeps and donates its priority to the holder, so the main
+    // thread never spins behind a preempted background sender.
+    os_unfair_lock_lock(&ring.producing);
+
+    unsigned tail = atomic_load_explicit(&ring.tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring.head, memory_order_acquire);
+    bool fits = IOS_INPUT_RING_SIZE - (tail - head) >= count;
+    if (fits) {
+        size_t first = tail & IOS_INPUT_RING_MASK;
+        size_t run = IOS_INPUT_RING_SIZE - first < count ? IOS_INPUT_RING_SIZE - first : count;
+        memcpy(&ring.keys[first], keys, run);
+        memcpy(ring.keys, keys + run, count - run);
+        atomic_store_explicit(&ring.tail, tail + (unsigned)count, memory_order_seq_cst);
+        if (end) *end = tail + (unsigned)count;
+    }
+    os_unfair_lock_unlock(&ring.producing);
+
+    if (fits && atomic_load_explicit(&ring.parked, memory_order_seq_cst)) {
+        pthread_mutex_lock(&park_mutex);
+        pthread_cond_broadcast(&park_cond);
+        pthread_mutex_unlock(&park_mutex);
+    }
+    return fits;
+}
+
+bool ios_input_ring_empty(void) {
+    if (ios_is_replaying()) return !ios_replay_peek_key(NULL);
+    return atomic_load_explicit(&ring.head, memory_order_relaxed) ==
+           atomic_load_explicit(&ring.tail, memory_order_acquire);
+}
+
+bool ios_input_ring_peek(char *ch) {
+    if (ios_is_replaying()) return ios_replay_peek_key(ch);
+    unsigned head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&ring.tail, memory_order_acquire)) return false;
+    *ch = ring.keys[head & IOS_INPUT_RING_MASK];
+    return true;
+}
+
+void ios_input_ring_drop(void) {
+    if (ios_is_replaying()) {
+        ios_replay_drop_key();
+        keys_taken++;
+        return;
+    }
+    unsigned head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+    if (head != atomic_load_explicit(&ring.tail, memory_order_acquire)) {
+        char ch = ring.keys[head & IOS_INPUT_RING_MASK];
+        atomic_store_explicit(&ring.head, head + 1, memory_order_release);
+        keys_taken++;
+        if (ios_is_recording()) ios_journal_note_key(ch);
+    }
+}
+
+uint64_t ios_input_ring_taken(void) {
+    return keys_taken;
+}
+
+bool ios_input_ring_pop(char *ch) {
+    if (!ios_input_ring_peek(ch)) return false;
+    ios_input_ring_drop();
+    return true;
+}
+
+bool ios_input_ring_wait(const volatile int *running, uint32_t timeout_ms) {
+    if (!ios_input_ring_empty()) return true;
+
+    pthread_mutex_lock(&park_mutex);
+    atomic_store_explicit(&ring.parked, 1, memory_order_seq_cst);
+    while (atomic_load_explicit(&ring.head, memory_order_relaxed) ==
+               atomic_load_explicit(&ring.tail, memory_order_seq_cst) &&
+           *running) {
+        if (timeout_ms == 0) {
+            pthread_cond_wait(&park_cond, &park_mutex);
+            continue;
+        }
+        struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+        pthread_cond_timedwait_relative_np(&park_cond, &park_mutex, &ts);
+        break;
+    }
+    atomic_store_explicit(&ring.parked, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&park_mutex);
+
+    return !ios_input_ring_empty();
+}
+
+void ios_input_ring_wake(void) {
+    pthread_mutex_lock(&park_mutex);
+    pthread_cond_broadcast(&park_cond);
+    pthread_mutex_unlock(&park_mutex);
+}
+
+bool ios_input_ring_run_parked(void (*fn)(void *ctx), void *ctx) {
+    pthread_mutex_lock(&park_mutex);
+    bool parked = atomic_load_explicit(&ring.parked, memory_order_relaxed) != 0;
+    if (parked) fn(ctx);
+    pthread_mutex_unlock(&park_mutex);
+    return parked;
+}
+
+size_t ios_input_ring_discard_to(uint32_t end) {
+    unsigned head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring.tail, memory_order_acquire);
+    // Free-running indices: end is ahead of head while the signed distance is
+    // positive, and never past tail (the keys before it were all published)
+    int ahead = (int)(end - head);
+    if (ahead <= 0 || (unsigned)ahead > tail - head) return 0;
+    atomic_store_explicit(&ring.head, end, memory_order_release);
+    return (size_t)ahead;
+}
+
+void ios_input_ring_clear(void) {
+    atomic_store_explicit(&ring.head, atomic_load_explicit(&ring.tail, memory_order_acquire),
+                          memory_order_release);
+}
@@ -0,0 +1,71 @@
+/*
+ * ios_input_ring.h - Lock-free key ring from Swift to the game thread
+ *
+ * Replaces the mutex + condvar char queue in ios_winprocs.c. Keys go in
+ * as whole commands: ios_input_ring_push() publishes all of a string with
+ * one tail store, or none of it, so "#loot\n" or "t" + item + direction
+ * can never interleave with a key sent from another thread.
+ *
+ * THREAD SAFETY:
+ * - One consumer: the game thread (nhgetch, poskey, yn_function, menus)
+ * - Producers may be any thread (Swift main thread, sendCommand callers,
+ *   the game thread's own wake-up NUL). They are serialized by an
+ *   os_unfair_lock held only for the copy (waiters sleep and boost the
+ *   holder instead of spinning); the consumer never takes it.
+ * - The consumer only touches the park mutex when the ring is empty, and a
+ *   producer only signals when the consumer is parked there, i.e. on the
+ *   empty -> non-empty transition. Every other key costs two atomics.
+ */
+
+#ifndef IOS_INPUT_RING_H
+#define IOS_INPUT_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Ring size in keys - MUST be power of 2 */
+#define IOS_INPUT_RING_SIZE 256
+
+/* Queue count keys as one command; false (nothing queued) if they don't fit */
+bool ios_input_ring_push(const char *keys, size_t count);
+
+/* push() that also reports the ring index just past the queued keys */
+bool ios_input_ring_push_marked(const char *keys, size_t count, uint32_t *end);
+
+/* Consumer side (game thread) */
+bool ios_input_ring_empty(void);
+bool ios_input_ring_peek(char *ch);    /* Next key without consuming it */
+void ios_input_ring_drop(void);        /* Consume the key peek() returned */
+bool ios_input_ring_pop(char *ch);
+uint64_t ios_input_ring_taken(void);   /* Keys consumed so far, replayed ones included */
+
+/*
+ * Park until a key is queued, *running drops to 0 (after
+ * ios_input_ring_wake()) or timeout_ms passes (0 = no timeout).
+ * True if a key is available.
+ */
+bool ios_input_ring_wait(const volatile int *running, uint32_t timeout_ms);
+
+/* Wake a parked consumer so it re-checks *running (exit requests) */
+void ios_input_ring_wake(void);
+
+/*
+ * Run fn(ctx) on the calling thread if the consumer is parked in
+ * ios_input_ring_wait(), holding the park mutex so it stays parked (it
+ * cannot leave the wait without the mutex). The game is then stopped at
+ * an input wait, a safe point for game-thread-only work. False, and fn
+ * not called, if the consumer is running.
+ */
+bool ios_input_ring_run_parked(void (*fn)(void *ctx), void *ctx);
+
+/*
+ * Discard the unconsumed keys before ring index end (from push_marked()),
+ * leaving anything queued after them. Not journaled. Returns the count.
+ */
+size_t ios_input_ring_discard_to(uint32_t end);
+
+/* Discard queued keys (game thread, or while it is stopped) */
+void ios_input_ring_clear(void);
+
+#endif /* IOS_INPUT_RING_H */
@@ -0,0 +1,159 @@
+/*
+ * ios_inventory_cache.c - Inventory export cache (see ios_inventory_cache.h)
+ *
+ * A rebuild fills a scratch copy and only replaces the cache (and bumps the
+ * generation) when the bytes differ, so an update_inventory() that changed
+ * nothing visible - NetHack calls it liberally - costs readers nothing.
+ * The stale flag is cleared before the walk: an invalidate that races a
+ * rebuild is never lost. Only the game thread rebuilds (doname() reads
+ * live objects); readers copy whatever was last published.
+ */
+
+#include "ios_inventory_cache.h"
+#include "hack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+extern int game_started;
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static InventoryCache cache;
+static InventoryCache scratch;
+static atomic_bool stale = true;
+
+/* Bytes of c worth copying or comparing */
+static size_t records_size(const InventoryCache *c)
+{
+    return sizeof(InventoryCacheRecord) * (size_t)c->count;
+}
+
+static const char *slot_label(long mask)
+{
+    if (mask & W_WEP) return "wielded";
+    if (mask & W_ARM) return "worn";
+    if (mask & W_RINGL) return "left ring";
+    if (mask & W_RINGR) return "right ring";
+    if (mask & W_AMUL) return "amulet";
+    return mask ? "equipped" : "";
+}
+
+static void build(InventoryCache *c)
+{
+    c->count = 0;
+    c->names_used = 0;
+    if (!game_started) return;
+
+    for (struct obj *obj = gi.invent; obj && c->count < IOS_INVENTORY_CACHE_MAX_ITEMS; obj = obj->nobj) {
+        InventoryCacheRecord *r = &c->records[c->count++];
+        memset(r, 0, sizeof(*r));
+
+        /* doname() buffers rotate: copy into the pool right away */
+        const char *name = doname(obj);
+        size_t len = strlen(name);
+        size_t room = IOS_INVENTORY_CACHE_POOL_SIZE - c->names_used;
+        if (len >= room) len = room ? room - 1 : 0;
+        if (room) {
+            memcpy(&c->names[c->names_used], name, len);
+            c->names[c->names_used + len] = '\0';
+            r->name_offset = (uint16_t)c->names_used;
+            c->names_used += (uint32_t)len + 1;
+        } else {
+            r->name_offset = (uint16_t)(c->names_used - 1);  /* Shared trailing NUL */
+        }
+        r->name_length = (uint16_t)len;
+
+        r->o_id = obj->o_id;
+        r->quantity = (int32_t)obj->quan;
+        r->weight = (int32_t)obj->owt;
+        r->otyp = (int16_t)obj->otyp;
+        r->enchantment = (int16_t)obj->spe;
+        r->invlet = obj->invlet;
+        r->oclass = obj->oclass;
+        r->buc_known = obj->bknown ? true : false;
+        r->buc_status = !obj->bknown ? '?' : obj->blessed ? 'B' : obj->cursed ? 'C' : 'U';
+        r->is_equipped = obj->owornmask != 0;
+        strncpy(r->equipped_slot, slot_label(obj->owornmask), sizeof(r->equipped_slot) - 1);
+        r->is_container = Is_container(obj) ? true : false;
+    }
+}
+
+/* Caller holds cache_mutex */
+static void refresh_locked(void)
+{
+    if (!atomic_exchange(&stale, false)) return;
+
+    build(&scratch);
+    if (scratch.count == cache.count && scratch.names_used == cache.names_used
+        && memcmp(scratch.records, cache.records, records_size(&scratch)) == 0
+        && memcmp(scratch.names, cache.names, scratch.names_used) == 0
+        && cache.generation != 0) {
+        return;
+    }
+
+    cache.count = scratch.count;
+    cache.names_used = scratch.names_used;
+    memcpy(cache.records, scratch.records, records_size(&scratch));
+    memcpy(cache.names, scratch.names, scratch.names_used);
+    cache.generation++;
+}
+
+static void copy_locked(InventoryCache *out)
+{
+    out->generation = cache.generation;
+    out->count = cache.count;
+    out->names_used = cache.names_used;
+    memcpy(out->records, cache.records, records_size(&cache));
+    memcpy(out->names, cache.names, cache.names_used);
+}
+
+void ios_inventory_cache_invalidate(void)
+{
+    atomic_store(&stale, true);
+}
+
+void ios_inventory_cache_refresh(void)
+{
+    if (!atomic_load_explicit(&stale, memory_order_relaxed)) return;
+    pthread_mutex_lock(&cache_mutex);
+    refresh_locked();
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+void ios_inventory_cache_copy(InventoryCache *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&cache_mutex);
+    copy_locked(out);
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+int ios_inventory_cache_count(void)
+{
+    pthread_mutex_lock(&cache_mutex);
+    int count = cache.count;
+    pthread_mutex_unlock(&cache_mutex);
+    return count;
+}
+
+uint32_t ios_inventory_cache_generation(void)
+{
+    pthread_mutex_lock(&cache_mutex);
+    uint32_t generation = cache.generation;
+    pthread_mutex_unlock(&cache_mutex);
+    return generation;
+}
+
+bool ios_get_inventory_cache_if_newer(InventoryCache *out, uint32_t *generation)
+{
+    if (!out || !generation) return false;
+
+    pthread_mutex_lock(&cache_mutex);
+    bool newer = cache.generation != *generation;
+    if (newer) {
+        copy_locked(out);
+        *generation = cache.generation;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    return newer;
+}
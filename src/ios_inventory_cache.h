@@ -0,0 +1,94 @@
+/*
+ * ios_inventory_cache.h - Inventory export built once per inventory change
+ *
+ * nethack_get_inventory_items() used to run doname() and strdup a name for
+ * every item on every call. The cache keeps the same data as one block:
+ * fixed records plus a packed string pool the records index into, with a
+ * generation that only moves when the contents change.
+ *
+ * INVALIDATION:
+ * - ios_update_inventory() (NetHack's update_inventory window proc)
+ * - The read model's inventory fingerprint moving at a turn boundary, which
+ *   catches changes NetHack doesn't report (outside the moveloop, or while
+ *   map output is suppressed)
+ * - New game / restore
+ * The game thread rebuilds a stale cache at the first input wait after a
+ * command (ios_winprocs.c wait_for_input) and at the turn boundary (read
+ * model). Reads are a memcpy of the last build, or nothing at all through
+ * ios_get_inventory_cache_if_newer().
+ *
+ * THREAD SAFETY: a mutex guards the cache. Rebuilds (doname() over
+ * gi.invent) run on the game thread only; readers on any thread never
+ * touch game objects.
+ */
+
+#ifndef IOS_INVENTORY_CACHE_H
+#define IOS_INVENTORY_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IOS_INVENTORY_CACHE_MAX_ITEMS 60                       /* a-z, A-Z, '$', '#' overflow */
+#define IOS_INVENTORY_CACHE_POOL_SIZE (IOS_INVENTORY_CACHE_MAX_ITEMS * 256)  /* doname() fits BUFSZ */
+
+/* InventoryItem fields, with the name as an offset into the pool */
+typedef struct {
+    uint16_t name_offset;            /* NUL-terminated string at names[name_offset] */
+    uint16_t name_length;
+    uint32_t o_id;
+    int32_t quantity;
+    int32_t weight;
+    int16_t otyp;
+    int16_t enchantment;             /* spe */
+    char invlet;
+    char oclass;
+    char buc_status;                 /* 'B', 'U', 'C', '?' */
+    bool buc_known;
+    bool is_equipped;
+    bool is_container;
+    char equipped_slot[16];          /* "wielded", "worn", ... or "" */
+} InventoryCacheRecord;
+
+typedef struct {
+    uint32_t generation;             /* 0 = never built */
+    int32_t count;
+    uint32_t names_used;             /* Bytes of names[] in use */
+    InventoryCacheRecord records[IOS_INVENTORY_CACHE_MAX_ITEMS];
+    char names[IOS_INVENTORY_CACHE_POOL_SIZE];
+} InventoryCache;
+
+/* Mark the cache stale (any thread) */
+void ios_inventory_cache_invalidate(void);
+
+/* Game thread: rebuild now if stale (one atomic load when clean) */
+void ios_inventory_cache_refresh(void);
+
+/*
+ * Copy the cache out as last built. Copies the header, the used records
+ * and the used part of the pool only.
+ */
+void ios_inventory_cache_copy(InventoryCache *out);
+
+/* Items in the cache as last built, without copying it */
+int ios_inventory_cache_count(void);
+
+/* Current generation; 0 before the first build */
+NETHACK_EXPORT uint32_t ios_inventory_cache_generation(void);
+
+/*
+ * Copy only if the generation differs from *generation (0 = none).
+ * Returns true when out was filled and *generation updated.
+ */
+NETHACK_EXPORT bool ios_get_inventory_cache_if_newer(InventoryCache *out, uint32_t *generation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IOS_INVENTORY_CACHE_H */
@@ -0,0 +1,202 @@
+/*
+ * ios_kill_stats.c - Incremental kill and discovery statistics
+ * (see ios_kill_stats.h)
+ *
+ * died is only ever incremented by the core, so an entry can only move up
+ * the ranking; a counter that went down (new game without a reset, wizard
+ * mode edits) restarts the pass from an empty state instead.
+ */
+
+#include "ios_kill_stats.h"
+#include "../NetHack/include/hack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool dirty = true;
+static bool need_rebuild = true;
+static _Atomic uint32_t generation = 0;
+
+static unsigned char shadow_died[NUMMONS];
+static bool shadow_seen[NUMMONS];
+
+static int total_kills;
+static int unique_kills;
+
+static int ranked[NUMMONS];        /* Killed types, best first */
+static int rank_of[NUMMONS];       /* Position in ranked[], -1 if not killed */
+
+static IOSMonsterInfo records[NUMMONS];  /* Names filled once */
+static bool names_ready;
+static int discovered[NUMMONS];    /* Seen types, ascending index */
+static int discovered_count;
+
+/* a ranks before b: more kills, then lower monster index */
+static bool ranks_before(int a, int b)
+{
+    if (shadow_died[a] != shadow_died[b]) return shadow_died[a] > shadow_died[b];
+    return a < b;
+}
+
+static void rank_up(int mndx)
+{
+    int pos = rank_of[mndx];
+    if (pos < 0) {
+        pos = unique_kills++;
+        ranked[pos] = mndx;
+    }
+    while (pos > 0 && ranks_before(mndx, ranked[pos - 1])) {
+        ranked[pos] = ranked[pos - 1];
+        rank_of[ranked[pos]] = pos;
+        pos--;
+    }
+    ranked[pos] = mndx;
+    rank_of[mndx] = pos;
+}
+
+static void discover(int mndx)
+{
+    int pos = discovered_count;
+    while (pos > 0 && discovered[pos - 1] > mndx) {
+        discovered[pos] = discovered[pos - 1];
+        pos--;
+    }
+    discovered[pos] = mndx;
+    discovered_count++;
+}
+
+static void fill_names(void)
+{
+    for (int i = LOW_PM; i < NUMMONS; i++) {
+        const char *name = mons[i].pmnames[NEUTRAL];
+        strncpy(records[i].name, name ? name : "", sizeof(records[i].name) - 1);
+        records[i].name[sizeof(records[i].name) - 1] = '\0';
+        records[i].monster_index = i;
+    }
+    names_ready = true;
+}
+
+static void clear_all(void)
+{
+    memset(shadow_died, 0, sizeof(shadow_died));
+    memset(shadow_seen, 0, sizeof(shadow_seen));
+    for (int i = 0; i < NUMMONS; i++) rank_of[i] = -1;
+    total_kills = unique_kills = discovered_count = 0;
+}
+
+/* Caller holds stats_mutex: fold counter changes since the last pass */
+static void refresh(void)
+{
+    atomic_store(&dirty, false);
+    if (!names_ready) fill_names();
+    if (need_rebuild) {
+        clear_all();
+        need_rebuild = false;
+    }
+
+    bool changed = false;
+    for (int i = LOW_PM; i < NUMMONS; i++) {
+        unsigned char died = svm.mvitals[i].died;
+        bool seen = svm.mvitals[i].seen_close ? true : false;
+        if (died == shadow_died[i] && seen == shadow_seen[i]) continue;
+
+        if (died < shadow_died[i] || (!seen && shadow_seen[i])) {
+            /* Went backwards: rebuild everything in this same pass */
+            clear_all();
+            i = LOW_PM - 1;
+            changed = true;
+            continue;
+        }
+
+        if (died != shadow_died[i]) {
+            total_kills += died - shadow_died[i];
+            shadow_died[i] = died;
+            rank_up(i);
+        }
+        if (seen && !shadow_seen[i]) {
+            shadow_seen[i] = true;
+            discover(i);
+        }
+        records[i].killed_count = died;
+        records[i].killed = died > 0;
+        records[i].seen_only = !records[i].killed;
+        changed = true;
+    }
+
+    if (changed) atomic_fetch_add(&generation, 1);
+}
+
+/* Lock and fold pending changes (no-op outside a game) */
+static bool lock_current(void)
+{
+    pthread_mutex_lock(&stats_mutex);
+    if (!program_state.in_moveloop && !program_state.gameover) {
+        pthread_mutex_unlock(&stats_mutex);
+        return false;
+    }
+    if (atomic_load(&dirty)) refresh();
+    return true;
+}
+
+void ios_kill_stats_invalidate(void)
+{
+    atomic_store(&dirty, true);
+}
+
+void ios_kill_stats_reset(void)
+{
+    pthread_mutex_lock(&stats_mutex);
+    need_rebuild = true;
+    atomic_store(&dirty, true);
+    atomic_fetch_add(&generation, 1);
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+uint32_t ios_kill_stats_generation(void)
+{
+    return atomic_load(&generation);
+}
+
+int ios_kill_stats_total(void)
+{
+    if (!lock_current()) return 0;
+    int total = total_kills;
+    pthread_mutex_unlock(&stats_mutex);
+    return total;
+}
+
+int ios_kill_stats_unique(void)
+{
+    if (!lock_current()) return 0;
+    int unique = unique_kills;
+    pthread_mutex_unlock(&stats_mutex);
+    return unique;
+}
+
+int ios_kill_stats_top(int *indices, int *counts, int max_results)
+{
+    if (!indices || !counts || max_results <= 0) return 0;
+    if (!lock_current()) return 0;
+
+    int n = unique_kills < max_results ? unique_kills : max_results;
+    for (int i = 0; i < n; i++) {
+        indices[i] = ranked[i];
+        counts[i] = shadow_died[ranked[i]];
+    }
+    pthread_mutex_unlock(&stats_mutex);
+    return n;
+}
+
+int ios_kill_stats_discovered(IOSMonsterInfo *buffer, int max_monsters)
+{
+    if (!buffer || max_monsters <= 0) return 0;
+    if (!lock_current()) return 0;
+
+    int n = discovered_count < max_monsters ? discovered_count : max_monsters;
+    for (int i = 0; i < n; i++) {
+        buffer[i] = records[discovered[i]];
+    }
+    pthread_mutex_unlock(&stats_mutex);
+    return n;
+}
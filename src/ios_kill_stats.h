@@ -0,0 +1,48 @@
+/*
+ * ios_kill_stats.h - Kill and discovery statistics kept up to date
+ *
+ * The vanquished totals, the ranked kill list and the discovered-monster
+ * list used to be rebuilt from svm.mvitals[] (every monster type, plus a
+ * bubble sort) on each call. They are now maintained incrementally:
+ *
+ *   - mvitals died/seen_close are diffed against a shadow copy once after
+ *     each command (the counters only change inside the NetHack core, so
+ *     the bridge picks them up at the first input wait after a key was
+ *     taken, like the object index); only types whose counters moved are
+ *     touched
+ *   - totals are running sums; the kill ranking is a sorted array where an
+ *     increment moves one entry up a few places; discoveries stay in
+ *     monster-index order with names copied once into a record table
+ *
+ * Readers get O(1) totals and O(N) copies of the first N entries, with a
+ * generation that only moves when something changed.
+ *
+ * THREAD SAFETY: refresh and reads hold the stats mutex.
+ */
+
+#ifndef IOS_KILL_STATS_H
+#define IOS_KILL_STATS_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+#include "ios_object_bridge.h"   /* IOSMonsterInfo */
+
+/* Counters may have changed (game thread, end of a command) */
+void ios_kill_stats_invalidate(void);
+
+/* New game / restore: forget the shadow copy and rebuild from scratch */
+void ios_kill_stats_reset(void);
+
+/* Bumped whenever totals, ranking or discoveries change */
+NETHACK_EXPORT uint32_t ios_kill_stats_generation(void);
+
+int ios_kill_stats_total(void);
+int ios_kill_stats_unique(void);
+
+/* First max entries of the ranking (kills descending, then monster index) */
+int ios_kill_stats_top(int *indices, int *counts, int max_results);
+
+/* Discovered (seen up close) monsters in monster-index order */
+int ios_kill_stats_discovered(IOSMonsterInfo *buffer, int max_monsters);
+
+#endif /* IOS_KILL_STATS_H */
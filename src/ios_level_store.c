@@ -0,0 +1,419 @@
+/*
+ * ios_level_store.c - Content-addressed level chunks (see ios_level_store.h)
+ *
+ * Layout: <save_dir>/levels/<hash:16 hex>-<length:hex>.lvl
+ * A chunk's name is its content, so an existing chunk is never rewritten
+ * and copying a store only moves names the destination lacks. Chunks are
+ * written to .tmp and renamed without fsync; the save writer fsyncs the
+ * ones a save references before committing it (ios_level_store_flush).
+ *
+ * Prefetch: one read per chunk on the global concurrent queue, each into its
+ * own buffer with its own ready semaphore. Workers touch only their slot;
+ * the slot table itself is game thread only.
+ */
+
+#include "ios_level_store.h"
+#include "ios_file_copy.h"
+#include "../zone_allocator/nh_io_stats.h"
+#include "ios_log.h"
+#include <dirent.h>
+#include <dispatch/dispatch.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHUNK_DIR "levels"
+#define CHUNK_SUFFIX ".lvl"
+#define CHUNK_HEADER (sizeof(int) + 1)   /* hackpid, ledger (see savelev) */
+
+typedef struct {
+    IosLevelChunkId id;
+    dev_t dev;                           /* Level file the chunk was taken */
+    ino_t ino;                           /* from / written to */
+    off_t size;
+    struct timespec mtime;
+    uint8_t clean;
+} LevelState;
+
+static LevelState levels[IOS_LEVEL_STORE_LEDGERS];
+
+typedef struct {
+    IosLevelChunkId id;
+    char path[1024];
+    uint8_t *data;                       /* Verified chunk, NULL if the read failed */
+    dispatch_semaphore_t ready;
+    uint8_t taken;
+} PrefetchSlot;
+
+static PrefetchSlot prefetch_slots[IOS_LEVEL_STORE_LEDGERS];
+static int prefetch_count = 0;
+static dispatch_group_t prefetch_group = NULL;
+
+static uint64_t fnv1a(const uint8_t *p, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    while (len--) {
+        h ^= *p++;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static struct timespec file_mtime(const struct stat *st) {
+#ifdef __APPLE__
+    return st->st_mtimespec;
+#else
+    return st->st_mtim;
+#endif
+}
+
+static void chunk_dir(const char *dir, char *out, size_t size) {
+    snprintf(out, size, "%s/" CHUNK_DIR, dir);
+}
+
+static void chunk_path(const char *dir, const IosLevelChunkId *id, char *out, size_t size) {
+    snprintf(out, size, "%s/" CHUNK_DIR "/%016llx-%x" CHUNK_SUFFIX, dir,
+             (unsigned long long)id->hash, id->length);
+}
+
+static int read_all(int fd, uint8_t *buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, buf + done, len - done, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        done += (size_t)n;
+    }
+    return 0;
+}
+
+static int write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        nh_io_note_write((size_t)n);
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Chunk id's bytes from path, verified against the hash; NULL on failure
+static uint8_t *load_chunk(const char *path, const IosLevelChunkId *id) {
+    int in = open(path, O_RDONLY);
+    if (in < 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Missing chunk %s", path);
+        return NULL;
+    }
+    uint8_t *data = malloc(id->length);
+    int result = (data && read_all(in, data, id->length) == 0) ? 0 : -1;
+    close(in);
+
+    if (result == 0 && fnv1a(data, id->length) != id->hash) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Chunk %s is corrupt", path);
+        result = -1;
+    }
+    if (result != 0) {
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+static void prefetch_run(void *context) {
+    PrefetchSlot *slot = context;
+    slot->data = load_chunk(slot->path, &slot->id);
+    dispatch_semaphore_signal(slot->ready);
+}
+
+// Wait out the reads and free what extract did not take
+static void prefetch_drop(void) {
+    if (prefetch_count == 0) return;
+    dispatch_group_wait(prefetch_group, DISPATCH_TIME_FOREVER);
+    for (int i = 0; i < prefetch_count; i++) {
+        free(prefetch_slots[i].data);
+        dispatch_release(prefetch_slots[i].ready);
+    }
+    memset(prefetch_slots, 0, sizeof(PrefetchSlot) * prefetch_count);
+    prefetch_count = 0;
+}
+
+// The prefetched bytes for id (ownership passes), or NULL to read it directly
+static uint8_t *prefetch_take(const IosLevelChunkId *id) {
+    for (int i = 0; i < prefetch_count; i++) {
+        PrefetchSlot *slot = &prefetch_slots[i];
+        if (slot->taken || slot->id.hash != id->hash || slot->id.length != id->length) continue;
+        dispatch_semaphore_wait(slot->ready, DISPATCH_TIME_FOREVER);
+        slot->taken = 1;
+        uint8_t *data = slot->data;
+        slot->data = NULL;
+        return data;
+    }
+    return NULL;
+}
+
+void ios_level_store_prefetch(const char *save_dir, const IosLevelChunkId *ids, int count) {
+    prefetch_drop();
+    if (count > IOS_LEVEL_STORE_LEDGERS) count = IOS_LEVEL_STORE_LEDGERS;
+    if (count <= 0) return;
+    if (!prefetch_group) prefetch_group = dispatch_group_create();
+
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    for (int i = 0; i < count; i++) {
+        PrefetchSlot *slot = &prefetch_slots[i];
+        slot->id = ids[i];
+        chunk_path(save_dir, &ids[i], slot->path, sizeof(slot->path));
+        slot->ready = dispatch_semaphore_create(0);
+        dispatch_group_async_f(prefetch_group, queue, slot, prefetch_run);
+    }
+    prefetch_count = count;
+}
+
+static void set_clean(int ledger, const IosLevelChunkId *id, int fd) {
+    struct stat st;
+    LevelState *state = &levels[ledger];
+    if (fstat(fd, &st) != 0) {
+        state->clean = 0;
+        return;
+    }
+    state->id = *id;
+    state->dev = st.st_dev;
+    state->ino = st.st_ino;
+    state->size = st.st_size;
+    state->mtime = file_mtime(&st);
+    state->clean = 1;
+}
+
+void ios_level_store_reset(void) {
+    prefetch_drop();
+    memset(levels, 0, sizeof(levels));
+}
+
+void ios_level_store_mark_dirty(int ledger) {
+    if (ledger > 0 && ledger < IOS_LEVEL_STORE_LEDGERS) levels[ledger].clean = 0;
+}
+
+int ios_level_store_reusable(const char *save_dir, int ledger, int fd, IosLevelChunkId *id) {
+    if (ledger <= 0 || ledger >= IOS_LEVEL_STORE_LEDGERS || !levels[ledger].clean) return 0;
+
+    const LevelState *state = &levels[ledger];
+    struct stat st;
+    if (fstat(fd, &st) != 0) return 0;
+    struct timespec mtime = file_mtime(&st);
+    if (st.st_dev != state->dev || st.st_ino != state->ino || st.st_size != state->size ||
+        mtime.tv_sec != state->mtime.tv_sec || mtime.tv_nsec != state->mtime.tv_nsec) {
+        return 0;
+    }
+
+    char path[1024];
+    chunk_path(save_dir, &state->id, path, sizeof(path));
+    if (access(path, F_OK) != 0) return 0;
+    *id = state->id;
+    return 1;
+}
+
+int ios_level_store_capture(const char *save_dir, int ledger, int fd, int hackpid,
+                            IosLevelChunkId *id, int *created) {
+    *created = 0;
+    if (ledger <= 0 || ledger >= IOS_LEVEL_STORE_LEDGERS) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= (off_t)CHUNK_HEADER || st.st_size > UINT32_MAX) {
+        return -1;
+    }
+    size_t len = (size_t)st.st_size;
+    uint8_t *data = malloc(len);
+    if (!data) return -1;
+
+    int file_pid;
+    if (read_all(fd, data, len) != 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Cannot read level %d: %s", ledger, strerror(errno));
+        free(data);
+        return -1;
+    }
+    memcpy(&file_pid, data, sizeof(int));
+    if (file_pid != hackpid || data[sizeof(int)] != (uint8_t)ledger) {
+        IOS_LOG_W(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Level %d file has unexpected header", ledger);
+        free(data);
+        return -1;
+    }
+    memset(data, 0, sizeof(int));
+
+    id->hash = fnv1a(data, len);
+    id->length = (uint32_t)len;
+
+    char path[1024];
+    chunk_path(save_dir, id, path, sizeof(path));
+    int result = 0;
+    if (access(path, F_OK) != 0) {
+        char dir[1024], temp[1040];
+        chunk_dir(save_dir, dir, sizeof(dir));
+        mkdir(dir, 0755);
+        snprintf(temp, sizeof(temp), "%s.tmp", path);
+
+        int out = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out < 0 || write_all(out, data, len) != 0) {
+            IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Cannot write %s: %s", temp, strerror(errno));
+            result = -1;
+        }
+        if (out >= 0 && close(out) != 0) result = -1;
+        if (result == 0 && rename(temp, path) != 0) result = -1;
+        if (result != 0) {
+            unlink(temp);
+        } else {
+            *created = 1;
+        }
+    }
+    free(data);
+
+    if (result == 0) set_clean(ledger, id, fd);
+    return result;
+}
+
+int ios_level_store_extract(const char *save_dir, int ledger, const IosLevelChunkId *id,
+                            int fd, int hackpid) {
+    if (ledger <= 0 || ledger >= IOS_LEVEL_STORE_LEDGERS || id->length <= CHUNK_HEADER) return -1;
+
+    uint8_t *data = prefetch_take(id);
+    if (!data) {
+        char path[1024];
+        chunk_path(save_dir, id, path, sizeof(path));
+        data = load_chunk(path, id);
+    }
+    if (!data) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] No usable chunk for level %d", ledger);
+        return -1;
+    }
+
+    memcpy(data, &hackpid, sizeof(int));
+    int result = write_all(fd, data, id->length);
+    free(data);
+
+    if (result == 0) set_clean(ledger, id, fd);
+    return result;
+}
+
+int ios_level_store_flush(const char *save_dir, const IosLevelChunkId *ids, int count) {
+    char path[1024];
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        chunk_path(save_dir, &ids[i], path, sizeof(path));
+        int fd = open(path, O_RDONLY);
+        if (fd < 0 || nh_io_fsync(fd) != 0) result = -1;
+        if (fd >= 0) close(fd);
+    }
+    if (count > 0) {
+        chunk_dir(save_dir, path, sizeof(path));
+        int fd = open(path, O_RDONLY);
+        if (fd < 0 || nh_io_fsync(fd) != 0) result = -1;
+        if (fd >= 0) close(fd);
+    }
+    return result;
+}
+
+int ios_level_store_missing(const char *save_dir, const IosLevelChunkId *ids, int count) {
+    char path[1024];
+    int missing = 0;
+    for (int i = 0; i < count; i++) {
+        struct stat st;
+        chunk_path(save_dir, &ids[i], path, sizeof(path));
+        if (stat(path, &st) != 0 || st.st_size != (off_t)ids[i].length) missing++;
+    }
+    return missing;
+}
+
+static int is_chunk_name(const char *name) {
+    size_t len = strlen(name);
+    return len > sizeof(CHUNK_SUFFIX) &&
+           strcmp(name + len - (sizeof(CHUNK_SUFFIX) - 1), CHUNK_SUFFIX) == 0;
+}
+
+int ios_level_store_collect(const char *save_dir, const IosLevelChunkId *ids, int count) {
+    char dir_path[1024];
+    chunk_dir(save_dir, dir_path, sizeof(dir_path));
+    DIR *dir = opendir(dir_path);
+    if (!dir) return 0;
+
+    int removed = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned long long hash;
+        unsigned int length;
+        int live = 0;
+        if (sscanf(entry->d_name, "%16llx-%x", &hash, &length) == 2 && is_chunk_name(entry->d_name)) {
+            for (int i = 0; i < count && !live; i++) {
+                live = ids[i].hash == hash && ids[i].length == length;
+            }
+        } else if (!strstr(entry->d_name, CHUNK_SUFFIX ".")) {
+            continue;                    /* Not a chunk or a leftover .tmp/.copy */
+        }
+        if (live) continue;
+
+        char path[1300];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        if (unlink(path) == 0) removed++;
+    }
+    closedir(dir);
+    return removed;
+}
+
+int ios_level_store_copy_dir(const char *src_dir, const char *dst_dir) {
+    char src_path[1024], dst_path[1024];
+    chunk_dir(src_dir, src_path, sizeof(src_path));
+    chunk_dir(dst_dir, dst_path, sizeof(dst_path));
+
+    int result = 0;
+    DIR *dir = opendir(src_path);
+    if (dir) {
+        mkdir(dst_path, 0755);
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (!is_chunk_name(entry->d_name)) continue;
+            char from[1300], to[1300];
+            snprintf(from, sizeof(from), "%s/%s", src_path, entry->d_name);
+            snprintf(to, sizeof(to), "%s/%s", dst_path, entry->d_name);
+            if (access(to, F_OK) == 0) continue;      /* Same name, same bytes */
+            if (ios_file_copy(from, to) != 0) {
+                IOS_LOG_E(IOS_LOG_CAT_SAVE, "[LEVEL_STORE] Cannot copy %s: %s", from, strerror(errno));
+                result = -1;
+            }
+        }
+        closedir(dir);
+    }
+
+    // Drop destination chunks the source no longer has
+    dir = opendir(dst_path);
+    if (dir) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (!is_chunk_name(entry->d_name)) continue;
+            char from[1300], to[1300];
+            snprintf(from, sizeof(from), "%s/%s", src_path, entry->d_name);
+            snprintf(to, sizeof(to), "%s/%s", dst_path, entry->d_name);
+            if (access(from, F_OK) != 0) unlink(to);
+        }
+        closedir(dir);
+    }
+    return result;
+}
+
+void ios_level_store_remove(const char *dir) {
+    char dir_path[1024];
+    chunk_dir(dir, dir_path, sizeof(dir_path));
+    DIR *d = opendir(dir_path);
+    if (!d) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char path[1300];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        unlink(path);
+    }
+    closedir(d);
+    rmdir(dir_path);
+}
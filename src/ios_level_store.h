@@ -0,0 +1,87 @@
+/*
+ * ios_level_store.h - Content-addressed store for serialized levels
+ *
+ * A late game has 40+ cached levels. Rewriting every one of them into
+ * savegame on each save costs megabytes of I/O for levels the player has
+ * not touched. Instead, each non-current level is stored once as a chunk
+ * in <save_dir>/levels/, named by the hash of its bytes. savegame then holds
+ * only a reference (ledger, hash, length) per level.
+ *
+ * A chunk is the level file exactly as savelev() wrote it; only the leading
+ * hackpid is zeroed so the same level hashes the same across sessions.
+ * Restore writes the chunk back as the level file with the current hackpid.
+ *
+ * Dirty tracking: the game thread marks the current level dirty every
+ * command (ios_wait_synch). Only a dirty level can have been rewritten
+ * since its chunk was taken: migrating monsters and objects travel in the
+ * game state, not in the destination's level file. A clean level is reused
+ * only if its level file also matches the size and mtime taken with the
+ * chunk, so a level rewritten without being seen is captured anyway.
+ *
+ * Game thread only, except ios_level_store_flush/collect on the save
+ * writer queue and the path helpers.
+ */
+
+#ifndef IOS_LEVEL_STORE_H
+#define IOS_LEVEL_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IOS_LEVEL_STORE_LEDGERS 128      /* Ledger numbers fit an xint8 */
+
+typedef struct {
+    uint64_t hash;                       /* FNV-1a of the normalized level bytes */
+    uint32_t length;
+} IosLevelChunkId;
+
+/* Forget all tracking (new game, restore, deleted save) */
+void ios_level_store_reset(void);
+
+/* The level at ledger is (or was) current: its level file will change */
+void ios_level_store_mark_dirty(int ledger);
+
+/*
+ * 1 and *id filled if the level's chunk is still valid: the level is clean,
+ * fd (its open level file) is the file the chunk was taken from, and the
+ * chunk is still in save_dir's store.
+ */
+int ios_level_store_reusable(const char *save_dir, int ledger, int fd, IosLevelChunkId *id);
+
+/*
+ * Read the level file at fd, store it as a chunk (if no identical chunk
+ * exists) and mark the level clean. *created is set if a new chunk file was
+ * written. The file must start with hackpid and ledger; if not, -1 and the
+ * caller serializes the level itself.
+ */
+int ios_level_store_capture(const char *save_dir, int ledger, int fd, int hackpid,
+                            IosLevelChunkId *id, int *created);
+
+/*
+ * Start reading and verifying ids on a concurrent worker pool (restore, with
+ * the ids from the save's manifest). ios_level_store_extract then takes the
+ * ready buffer instead of reading the chunk itself. Buffers not taken are
+ * freed by the next prefetch or ios_level_store_reset.
+ */
+void ios_level_store_prefetch(const char *save_dir, const IosLevelChunkId *ids, int count);
+
+/* Write chunk id to fd as the level file for ledger and mark it clean */
+int ios_level_store_extract(const char *save_dir, int ledger, const IosLevelChunkId *id,
+                            int fd, int hackpid);
+
+/* fsync the given chunks and the chunk directory (before savegame commits) */
+int ios_level_store_flush(const char *save_dir, const IosLevelChunkId *ids, int count);
+
+/* Number of ids with no chunk of the right length in save_dir's store */
+int ios_level_store_missing(const char *save_dir, const IosLevelChunkId *ids, int count);
+
+/* Delete chunks not in ids (after savegame commits); returns chunks removed */
+int ios_level_store_collect(const char *save_dir, const IosLevelChunkId *ids, int count);
+
+/* Make dst_dir's chunks match src_dir's (slot and character copies) */
+int ios_level_store_copy_dir(const char *src_dir, const char *dst_dir);
+
+/* Delete dir's chunk directory */
+void ios_level_store_remove(const char *dir);
+
+#endif /* IOS_LEVEL_STORE_H */
@@ -0,0 +1,168 @@
+/*
+ * ios_log.c - Lock-free logging ring (see ios_log.h)
+ *
+ * Each record carries the sequence number it was claimed with; the writer
+ * clears it while filling and publishes it with release ordering at the end.
+ * A dump only prints records whose sequence still matches its position, so a
+ * record that is being rewritten (or was lapped) is skipped.
+ */
+
+#include "ios_log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef IOS_LOG_ECHO_DEFAULT
+#ifdef DEBUG
+#define IOS_LOG_ECHO_DEFAULT 1
+#else
+#define IOS_LOG_ECHO_DEFAULT 0
+#endif
+#endif
+
+typedef struct {
+    _Atomic uint64_t seq;      /* Claim index + 1 once complete, 0 while writing */
+    uint64_t time_ns;          /* CLOCK_MONOTONIC */
+    uint8_t level;
+    uint8_t category;          /* Bit index of the category */
+    uint16_t length;
+    char func[20];             /* Truncated __func__ */
+    char msg[IOS_LOG_MSG_MAX];
+} LogRecord;
+
+_Static_assert((IOS_LOG_RING_SIZE & IOS_LOG_RING_MASK) == 0, "IOS_LOG_RING_SIZE must be power of 2");
+
+static LogRecord log_ring[IOS_LOG_RING_SIZE];
+static _Atomic uint64_t log_head = 0;
+static _Atomic bool log_echo = IOS_LOG_ECHO_DEFAULT;
+
+_Atomic int ios_log_runtime_level = IOS_LOG_COMPILE_LEVEL;
+_Atomic uint32_t ios_log_runtime_categories = IOS_LOG_CAT_ALL;
+
+static const char *const level_names[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+static const char *const category_names[] = {"RENDER", "INPUT", "MESSAGE", "QUEUE",
+                                             "STATE", "SAVE", "MEMORY", "GAME"};
+
+static uint8_t category_index(uint32_t category) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (category & (1u << i)) return i;
+    }
+    return 7;  /* GAME */
+}
+
+void ios_log_write(int level, uint32_t category, const char *func, const char *fmt, ...) {
+    uint64_t claim = atomic_fetch_add_explicit(&log_head, 1, memory_order_relaxed);
+    LogRecord *rec = &log_ring[claim & IOS_LOG_RING_MASK];
+
+    atomic_store_explicit(&rec->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rec->time_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    rec->level = (uint8_t)(level < IOS_LOG_TRACE ? IOS_LOG_TRACE : level > IOS_LOG_ERROR ? IOS_LOG_ERROR : level);
+    rec->category = category_index(category);
+
+    size_t flen = func ? strlen(func) : 0;
+    if (flen >= sizeof(rec->func)) flen = sizeof(rec->func) - 1;
+    memcpy(rec->func, func, flen);
+    rec->func[flen] = '\0';
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(rec->msg, sizeof(rec->msg), fmt, args);
+    va_end(args);
+    rec->length = (uint16_t)(n < 0 ? 0 : n >= (int)sizeof(rec->msg) ? (int)sizeof(rec->msg) - 1 : n);
+
+    atomic_store_explicit(&rec->seq, claim + 1, memory_order_release);
+
+    if (atomic_load_explicit(&log_echo, memory_order_relaxed)) {
+        fprintf(stderr, "[%s] %s: %s\n", category_names[rec->category], rec->func, rec->msg);
+    }
+}
+
+/* === Flush (write(2) only, no stdio - callable from the crash handler) === */
+
+static void put(int fd, const char *s, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, s, len);
+        if (w <= 0) return;
+        s += w;
+        len -= (size_t)w;
+    }
+}
+
+static void put_str(int fd, const char *s) {
+    put(fd, s, strlen(s));
+}
+
+static void put_uint(int fd, uint64_t v, int min_digits) {
+    char buf[24];
+    int i = sizeof(buf);
+    do {
+        buf[--i] = (char)('0' + v % 10);
+        v /= 10;
+        min_digits--;
+    } while ((v > 0 || min_digits > 0) && i > 0);
+    put(fd, buf + i, sizeof(buf) - (size_t)i);
+}
+
+void ios_log_flush_fd(int fd) {
+    uint64_t head = atomic_load_explicit(&log_head, memory_order_acquire);
+    uint64_t start = head > IOS_LOG_RING_SIZE ? head - IOS_LOG_RING_SIZE : 0;
+
+    put_str(fd, "---- ios_log ring (");
+    put_uint(fd, head - start, 1);
+    put_str(fd, " records, oldest first) ----\n");
+
+    for (uint64_t i = start; i < head; i++) {
+        LogRecord *rec = &log_ring[i & IOS_LOG_RING_MASK];
+        if (atomic_load_explicit(&rec->seq, memory_order_acquire) != i + 1) {
+            continue;  /* In progress or lapped */
+        }
+
+        /* Copy out, then confirm the slot was not reclaimed meanwhile */
+        LogRecord copy;
+        memcpy(&copy, rec, sizeof(copy));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&rec->seq, memory_order_relaxed) != i + 1) {
+            continue;
+        }
+
+        put_uint(fd, copy.time_ns / 1000000000ull, 1);
+        put_str(fd, ".");
+        put_uint(fd, (copy.time_ns / 1000000ull) % 1000, 3);
+        put_str(fd, " [");
+        put_str(fd, level_names[copy.level]);
+        put_str(fd, "] [");
+        put_str(fd, category_names[copy.category]);
+        put_str(fd, "] ");
+        copy.func[sizeof(copy.func) - 1] = '\0';
+        put_str(fd, copy.func);
+        put_str(fd, ": ");
+        put(fd, copy.msg, copy.length < sizeof(copy.msg) ? copy.length : sizeof(copy.msg) - 1);
+        put_str(fd, "\n");
+    }
+    put_str(fd, "---- end ios_log ring ----\n");
+}
+
+/* === Runtime control === */
+
+NETHACK_EXPORT void ios_log_set_level(int level) {
+    atomic_store_explicit(&ios_log_runtime_level, level, memory_order_relaxed);
+}
+
+NETHACK_EXPORT void ios_log_set_categories(uint32_t mask) {
+    atomic_store_explicit(&ios_log_runtime_categories, mask, memory_order_relaxed);
+}
+
+NETHACK_EXPORT void ios_log_set_echo(bool echo) {
+    atomic_store_explicit(&log_echo, echo, memory_order_relaxed);
+}
+
+NETHACK_EXPORT void ios_log_dump(void) {
+    fflush(stderr);  /* Keep ordering with any buffered stdio output */
+    ios_log_flush_fd(STDERR_FILENO);
+}
@@ -0,0 +1,97 @@
+/*
+ * ios_log.h - Leveled, category-filtered logging into an in-memory ring
+ *
+ * Replaces unconditional fprintf(stderr)/fflush on the draw and input paths.
+ *
+ * COMPILE TIME:
+ * - Calls below IOS_LOG_COMPILE_LEVEL compile to nothing (arguments are not
+ *   evaluated). Default: DEBUG in debug builds, WARN otherwise. Override with
+ *   -DIOS_LOG_COMPILE_LEVEL=N (build scripts: NH_LOG_LEVEL=N).
+ *
+ * RUNTIME:
+ * - Enabled records are formatted into a fixed lock-free ring (no syscalls,
+ *   no allocation). The ring is written out only on crash (ios_crash_handler.c)
+ *   or on demand via ios_log_dump().
+ * - Echo to stderr is opt-in (on by default only in debug builds).
+ *
+ * THREAD SAFETY:
+ * - Any number of writers (slot claimed with one atomic add)
+ * - Dump from any thread; records being overwritten are skipped, not torn
+ */
+
+#ifndef IOS_LOG_H
+#define IOS_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "nethack_export.h"
+
+/* Levels */
+#define IOS_LOG_TRACE 0   /* Per-glyph / per-key detail */
+#define IOS_LOG_DEBUG 1
+#define IOS_LOG_INFO  2
+#define IOS_LOG_WARN  3
+#define IOS_LOG_ERROR 4
+#define IOS_LOG_OFF   5
+
+#ifndef IOS_LOG_COMPILE_LEVEL
+#ifdef DEBUG
+#define IOS_LOG_COMPILE_LEVEL IOS_LOG_DEBUG
+#else
+#define IOS_LOG_COMPILE_LEVEL IOS_LOG_WARN
+#endif
+#endif
+
+/* Categories (bit mask) */
+#define IOS_LOG_CAT_RENDER  (1u << 0)  /* print_glyph, map buffer */
+#define IOS_LOG_CAT_INPUT   (1u << 1)  /* nhgetch, poskey, input queue */
+#define IOS_LOG_CAT_MESSAGE (1u << 2)  /* Message history / notifications */
+#define IOS_LOG_CAT_QUEUE   (1u << 3)  /* Render queue */
+#define IOS_LOG_CAT_STATE   (1u << 4)  /* Game state buffer */
+#define IOS_LOG_CAT_SAVE    (1u << 5)  /* Save / restore */
+#define IOS_LOG_CAT_MEMORY  (1u << 6)  /* Allocators */
+#define IOS_LOG_CAT_GAME    (1u << 7)  /* Lifecycle, everything else */
+#define IOS_LOG_CAT_ALL     0xFFFFFFFFu
+
+/* Ring geometry */
+#define IOS_LOG_RING_SIZE 1024   /* Records, must be power of 2 */
+#define IOS_LOG_RING_MASK (IOS_LOG_RING_SIZE - 1)
+#define IOS_LOG_MSG_MAX   112    /* Bytes of text per record (incl. NUL) */
+
+/* Runtime filters (read inline by IOS_LOG) */
+extern _Atomic int ios_log_runtime_level;
+extern _Atomic uint32_t ios_log_runtime_categories;
+
+static inline bool ios_log_enabled(int level, uint32_t category) {
+    return level >= atomic_load_explicit(&ios_log_runtime_level, memory_order_relaxed) &&
+           (atomic_load_explicit(&ios_log_runtime_categories, memory_order_relaxed) & category) != 0;
+}
+
+/* Format one record into the ring (use the macros below) */
+void ios_log_write(int level, uint32_t category, const char *func, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#define IOS_LOG(level, cat, ...) do { \
+    if ((level) >= IOS_LOG_COMPILE_LEVEL && ios_log_enabled((level), (cat))) \
+        ios_log_write((level), (cat), __func__, __VA_ARGS__); \
+} while (0)
+
+#define IOS_LOG_T(cat, ...) IOS_LOG(IOS_LOG_TRACE, cat, __VA_ARGS__)
+#define IOS_LOG_D(cat, ...) IOS_LOG(IOS_LOG_DEBUG, cat, __VA_ARGS__)
+#define IOS_LOG_I(cat, ...) IOS_LOG(IOS_LOG_INFO, cat, __VA_ARGS__)
+#define IOS_LOG_W(cat, ...) IOS_LOG(IOS_LOG_WARN, cat, __VA_ARGS__)
+#define IOS_LOG_E(cat, ...) IOS_LOG(IOS_LOG_ERROR, cat, __VA_ARGS__)
+
+/* Write the ring (oldest first) to fd using write(2) only - crash-handler safe */
+void ios_log_flush_fd(int fd);
+
+/* Runtime control (Swift / debugger) */
+NETHACK_EXPORT void ios_log_set_level(int level);
+NETHACK_EXPORT void ios_log_set_categories(uint32_t mask);
+NETHACK_EXPORT void ios_log_set_echo(bool echo);
+
+/* Dump the ring to stderr on demand */
+NETHACK_EXPORT void ios_log_dump(void);
+
+#endif /* IOS_LOG_H */
@@ -0,0 +1,150 @@
+/*
+ * ios_lookat_cache.c - Cached tile inspection (see ios_lookat_cache.h)
+ *
+ * One direct-mapped entry per map cell. Entry text is heap-allocated and
+ * replaced on refill, so the table stays small (most cells are never
+ * examined).
+ */
+
+#include "ios_lookat_cache.h"
+#include "ios_object_index.h"
+#include "../NetHack/include/hack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern struct permonst *lookat(coordxy, coordxy, char *, char *);
+
+typedef struct {
+    bool valid;
+    bool in_sight;
+    xint16 ledger;
+    int32_t glyph;
+    uint32_t cell_gen;
+    uint32_t map_gen;
+    uint32_t command_gen;
+    uint32_t pile_gen;
+    uint16_t object_count;
+    uint16_t flags;
+    char *text;
+} LookatEntry;
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LookatEntry entries[ROWNO][COLNO];
+static _Atomic uint32_t cell_gen[ROWNO][COLNO];
+static _Atomic uint32_t map_gen = 1;
+static _Atomic uint32_t command_gen = 1;
+
+void ios_lookat_cache_note_glyph(int x, int y)
+{
+    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) return;
+    atomic_fetch_add_explicit(&cell_gen[y][x], 1, memory_order_relaxed);
+}
+
+void ios_lookat_cache_clear(void)
+{
+    atomic_fetch_add_explicit(&map_gen, 1, memory_order_relaxed);
+}
+
+void ios_lookat_cache_note_command(void)
+{
+    atomic_fetch_add_explicit(&command_gen, 1, memory_order_relaxed);
+}
+
+/* lookat() plus the pile listing the tap popup shows (same text as before caching) */
+static uint16_t describe(int x, int y, const IOSTileObjectSummary *pile, char *out, size_t size)
+{
+    char buf[BUFSZ], monbuf[BUFSZ];
+    uint16_t flags = 0;
+
+    buf[0] = monbuf[0] = '\0';
+    if (lookat(x, y, buf, monbuf)) flags |= IOS_LOOKAT_MONSTER;
+
+    if (buf[0] == '\0') {
+        snprintf(out, size, "unexplored area");
+        return flags | IOS_LOOKAT_UNEXPLORED;
+    }
+    if (monbuf[0] != '\0') {
+        snprintf(out, size, "%s %s", buf, monbuf);
+    } else {
+        snprintf(out, size, "%s", buf);
+    }
+
+    /* Piles: first 6 items, or 5 and "+N more items" when 7+ */
+    if (pile->count > 1) {
+        int total = pile->count;
+        int max_show = (total <= 6) ? total : 5;
+        int shown = 0;
+        size_t len = 0;
+
+        out[0] = '\0';
+        for (struct obj *otmp = svl.level.objects[x][y]; otmp && shown < max_show;
+             otmp = otmp->nexthere) {
+            int n = snprintf(out + len, size - len, "%s%s", shown ? "\n" : "", doname(otmp));
+            if (n < 0 || (size_t)n >= size - len) break;
+            len += (size_t)n;
+            shown++;
+        }
+        if (total - shown >= 2 && len < size) {
+            snprintf(out + len, size - len, "\n+%d more items", total - shown);
+        }
+        flags |= IOS_LOOKAT_PILE;
+    }
+    return flags;
+}
+
+int ios_examine_tile(int swift_x, int swift_y, IOSLookatResult *out)
+{
+    int x = swift_x + 1;  /* Swift 0-based x -> NetHack 1-based */
+    int y = swift_y;
+    if (!out || x < 1 || x >= COLNO || y < 0 || y >= ROWNO) return 0;
+
+    uint32_t pgen = ios_object_index_pile_generation(x, y);
+
+    pthread_mutex_lock(&cache_mutex);
+
+    LookatEntry *e = &entries[y][x];
+    uint32_t cgen = atomic_load_explicit(&cell_gen[y][x], memory_order_relaxed);
+    uint32_t mgen = atomic_load_explicit(&map_gen, memory_order_relaxed);
+    uint32_t kgen = atomic_load_explicit(&command_gen, memory_order_relaxed);
+    xint16 ledger = ledger_no(&u.uz);
+    int32_t glyph = glyph_at(x, y);
+    bool in_sight = cansee(x, y) ? true : false;
+
+    bool hit = e->valid && e->text && e->cell_gen == cgen && e->map_gen == mgen
+               && e->command_gen == kgen && e->ledger == ledger && e->glyph == glyph && e->in_sight == in_sight
+               && e->pile_gen == pgen;
+
+    if (hit) {
+        out->flags = e->flags | IOS_LOOKAT_CACHED;
+        snprintf(out->text, sizeof(out->text), "%s", e->text);
+    } else {
+        IOSTileObjectSummary pile;
+        ios_get_tile_object_summary(x, y, &pile);
+        out->flags = describe(x, y, &pile, out->text, sizeof(out->text));
+
+        free(e->text);
+        e->text = strdup(out->text);
+        e->valid = e->text != NULL;
+        e->in_sight = in_sight;
+        e->ledger = ledger;
+        e->glyph = glyph;
+        e->cell_gen = cgen;
+        e->map_gen = mgen;
+        e->command_gen = kgen;
+        e->pile_gen = pgen;
+        e->object_count = pile.count;
+        e->flags = out->flags;
+    }
+    out->object_count = e->object_count;
+
+    pthread_mutex_unlock(&cache_mutex);
+
+    out->glyph = glyph;
+    out->x = (int16_t)x;
+    out->y = (int16_t)y;
+    out->reserved = 0;
+    return 1;
+}
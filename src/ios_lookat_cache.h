@@ -0,0 +1,73 @@
+/*
+ * ios_lookat_cache.h - Cached tile inspection (farlook) results
+ *
+ * Examining a tile runs pager's lookat() plus a walk of the object pile
+ * and formats a description. Long-press and drag inspection ask for the
+ * same tiles over and over while the game is parked in an input wait, so
+ * each cell keeps its last result together with what it was computed
+ * from:
+ *
+ *   - level (ledger number) and map generation (bumped on map clear / new game)
+ *   - command generation, bumped at the first input wait after every
+ *     command: monster state lookat() reports without a glyph change
+ *     (peaceful -> hostile, trapped, leashed, stuck to the hero, how the
+ *     hero senses it) only moves while a command runs
+ *   - cell generation, bumped by print_glyph() for that cell
+ *   - displayed glyph and whether the hero can currently see the cell
+ *   - the tile's pile generation (ios_object_index.h), which moves when
+ *     any object on the tile changes in a way its name shows
+ *
+ * A vision recalculation that changes what the hero sees of a cell either
+ * redraws it (print_glyph) or flips its in-sight bit, so no separate
+ * vision hook is needed. Tiles unchanged since the last command are
+ * answered without lookat() or a pile summary.
+ *
+ * THREAD SAFETY: lookups and fills hold the cache mutex (lookat() and the
+ * pager's static buffers are not reentrant). Invalidation is a lock-free
+ * counter bump, safe from the game thread inside print_glyph().
+ */
+
+#ifndef IOS_LOOKAT_CACHE_H
+#define IOS_LOOKAT_CACHE_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* Large enough for lookat() text plus a six-item pile listing */
+#define IOS_LOOKAT_TEXT_MAX 1024
+
+/* IOSLookatResult.flags */
+#define IOS_LOOKAT_CACHED      0x01  /* Served without calling lookat() */
+#define IOS_LOOKAT_MONSTER     0x02  /* lookat() identified a monster */
+#define IOS_LOOKAT_PILE        0x04  /* text is an object list */
+#define IOS_LOOKAT_UNEXPLORED  0x08  /* Nothing known about the cell */
+
+typedef struct {
+    int32_t glyph;              /* Glyph displayed at the cell */
+    int16_t x;                  /* NetHack coordinates */
+    int16_t y;
+    uint16_t flags;             /* IOS_LOOKAT_* */
+    uint16_t object_count;      /* Objects on the tile */
+    uint32_t reserved;
+    char text[IOS_LOOKAT_TEXT_MAX];  /* NUL-terminated description */
+} IOSLookatResult;
+
+/*
+ * Describe a tile (Swift coordinates: 0-based x, NetHack y).
+ * Returns 1 with *out filled, 0 for coordinates off the map.
+ */
+NETHACK_EXPORT int ios_examine_tile(int swift_x, int swift_y, IOSLookatResult *out);
+
+/* Window port: the glyph at (x, y) changed (NetHack coordinates) */
+void ios_lookat_cache_note_glyph(int x, int y);
+
+/* Game thread, first input wait after a command: entries from earlier
+ * commands go stale */
+void ios_lookat_cache_note_command(void);
+
+/* Invalidate every entry (map clear, level change, new game): a map
+ * generation bump, the stale text is replaced on the next examine.
+ * Exported for bench/bridge_bench.c's uncached examine timings. */
+NETHACK_EXPORT void ios_lookat_cache_clear(void);
+
+#endif /* IOS_LOOKAT_CACHE_H */
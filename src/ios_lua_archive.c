@@ -0,0 +1,133 @@
+/*
+ * ios_lua_archive.c - mmapped Lua bytecode archive (see ios_lua_archive.h)
+ */
+
+#include "ios_lua_archive.h"
+#include "ios_log.h"
+#include "ios_lua_state.h"
+#include "lua.h"
+#include "lauxlib.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint8_t *archive_base = NULL;
+static size_t archive_size = 0;
+static const IosLuaArchiveEntry *archive_entries = NULL;
+static uint32_t archive_count = 0;
+static int archive_state = 0;            /* 0 not tried, 1 mapped, -1 unavailable */
+
+static int entry_valid(const IosLuaArchiveEntry *e, size_t size) {
+    return memchr(e->name, '\0', sizeof(e->name)) != NULL &&
+           (size_t)e->source_offset + e->source_size <= size &&
+           (size_t)e->chunk_offset + e->chunk_size <= size && e->chunk_size > 0;
+}
+
+static int map_archive(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        IOS_LOG_I(IOS_LOG_CAT_GAME, "[LUA_ARCHIVE] No archive at %s (%s)", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(IosLuaArchiveHeader)) {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        IOS_LOG_E(IOS_LOG_CAT_GAME, "[LUA_ARCHIVE] mmap %s failed: %s", path, strerror(errno));
+        return -1;
+    }
+
+    const IosLuaArchiveHeader *header = base;
+    const IosLuaArchiveEntry *entries = (const IosLuaArchiveEntry *)(header + 1);
+    int ok = memcmp(header->magic, IOS_LUA_ARCHIVE_MAGIC, sizeof(IOS_LUA_ARCHIVE_MAGIC)) == 0 &&
+             header->version == IOS_LUA_ARCHIVE_VERSION &&
+             header->lua_version == LUA_VERSION_NUM &&
+             header->integer_size == sizeof(lua_Integer) &&
+             header->number_size == sizeof(lua_Number) &&
+             sizeof(*header) + (size_t)header->count * sizeof(*entries) <= size;
+    for (uint32_t i = 0; ok && i < header->count; i++) {
+        ok = entry_valid(&entries[i], size);
+    }
+    if (!ok) {
+        // Built by another Lua (or truncated): chunks would not load
+        IOS_LOG_W(IOS_LOG_CAT_GAME, "[LUA_ARCHIVE] %s does not match this build, ignoring", path);
+        munmap(base, size);
+        return -1;
+    }
+
+    archive_base = base;
+    archive_size = size;
+    archive_entries = entries;
+    archive_count = header->count;
+    IOS_LOG_I(IOS_LOG_CAT_GAME, "[LUA_ARCHIVE] Mapped %u scripts (%zu bytes)", archive_count, size);
+    return 0;
+}
+
+int ios_lua_archive_open(const char *path) {
+    if (archive_state == 0) {
+        archive_state = (path && map_archive(path) == 0) ? 1 : -1;
+    }
+    return archive_state == 1 ? 0 : -1;
+}
+
+static int compare_entry(const void *key, const void *entry) {
+    return strcmp(key, ((const IosLuaArchiveEntry *)entry)->name);
+}
+
+// "@dir/themerms.lua" -> "themerms.lua"
+static const IosLuaArchiveEntry *find_entry(const char *name) {
+    if (!archive_entries || !name) return NULL;
+    if (*name == '@' || *name == '=') name++;
+    const char *slash = strrchr(name, '/');
+    if (slash) name = slash + 1;
+    return bsearch(name, archive_entries, archive_count, sizeof(IosLuaArchiveEntry), compare_entry);
+}
+
+const char *ios_lua_archive_source(const char *name, size_t *size) {
+    const IosLuaArchiveEntry *e = find_entry(name);
+    if (!e || e->source_size == 0) return NULL;
+    *size = e->source_size;
+    return (const char *)archive_base + e->source_offset;
+}
+
+const char *ios_lua_archive_chunk(const char *name, size_t *size) {
+    const IosLuaArchiveEntry *e = find_entry(name);
+    if (!e) return NULL;
+    *size = e->chunk_size;
+    return (const char *)archive_base + e->chunk_offset;
+}
+
+int ios_lua_archive_loadbufferx(lua_State *L, const char *buf, size_t size,
+                                const char *name, const char *mode) {
+    // Already loaded in this warm state (ios_lua_state.h)
+    if (ios_lua_state_chunk_lookup(L, name)) return LUA_OK;
+
+    size_t chunk_size;
+    const char *chunk = ios_lua_archive_chunk(name, &chunk_size);
+    int status = LUA_ERRSYNTAX;
+    if (chunk) {
+        status = luaL_loadbufferx(L, chunk, chunk_size, name, "b");
+        if (status != LUA_OK) {
+            // Keep going on the source; the archive is only a shortcut
+            IOS_LOG_W(IOS_LOG_CAT_GAME, "[LUA_ARCHIVE] Chunk for %s failed to load: %s",
+                      name, lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+    }
+    if (status != LUA_OK) {
+        status = luaL_loadbufferx(L, buf, size, name, mode);
+    }
+    if (status == LUA_OK) {
+        ios_lua_state_chunk_register(L, name);
+    }
+    return status;
+}
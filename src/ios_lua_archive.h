@@ -0,0 +1,64 @@
+/*
+ * ios_lua_archive.h - Bundled Lua scripts as one mmapped bytecode archive
+ *
+ * scripts/build_lua_archive.sh packs every .lua in swift/lua_resources into
+ * nhlua.luapak in the bundle: the source and the precompiled chunk
+ * (lua_dump, debug info kept so errors still name file and line).
+ *
+ * At startup the archive is mapped read-only; nothing is copied into
+ * Documents. dlb_fopen serves a script's source straight from the mapping,
+ * and ios_lua_archive_loadbufferx (swapped in for luaL_loadbufferx in
+ * nhlua.c by ios_lua_archive_hook.h) loads the chunk instead of parsing.
+ * A script missing from the archive, or no archive at all, takes the old
+ * path: copied source, parsed on load.
+ *
+ * File: [IosLuaArchiveHeader] [IosLuaArchiveEntry * count, sorted by name]
+ *       [sources and chunks]  (native byte order, offsets from file start)
+ */
+
+#ifndef IOS_LUA_ARCHIVE_H
+#define IOS_LUA_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IOS_LUA_ARCHIVE_FILE "nhlua.luapak"
+#define IOS_LUA_ARCHIVE_MAGIC "NHLUAC1"
+#define IOS_LUA_ARCHIVE_VERSION 1
+#define IOS_LUA_ARCHIVE_NAME_MAX 32
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t lua_version;                /* LUA_VERSION_NUM of the compiler */
+    uint32_t integer_size;               /* sizeof(lua_Integer) */
+    uint32_t number_size;                /* sizeof(lua_Number) */
+    uint32_t count;
+    uint32_t reserved;
+} IosLuaArchiveHeader;
+
+typedef struct {
+    char name[IOS_LUA_ARCHIVE_NAME_MAX]; /* "themerms.lua" */
+    uint32_t source_offset;
+    uint32_t source_size;
+    uint32_t chunk_offset;
+    uint32_t chunk_size;
+} IosLuaArchiveEntry;
+
+/* Map the archive (once; later calls return the first result). 0 on success */
+int ios_lua_archive_open(const char *path);
+
+/* Script source / compiled chunk by file name, NULL if not archived */
+const char *ios_lua_archive_source(const char *name, size_t *size);
+const char *ios_lua_archive_chunk(const char *name, size_t *size);
+
+/*
+ * luaL_loadbufferx for nhlua.c (see ios_lua_archive_hook.h): an archived
+ * script's chunk instead of buf, else luaL_loadbufferx unchanged. name is
+ * the chunk name ("@themerms.lua", "themerms.lua" or a path).
+ */
+struct lua_State;
+int ios_lua_archive_loadbufferx(struct lua_State *L, const char *buf, size_t size,
+                                const char *name, const char *mode);
+
+#endif /* IOS_LUA_ARCHIVE_H */
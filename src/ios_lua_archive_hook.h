@@ -0,0 +1,20 @@
+/*
+ * ios_lua_archive_hook.h - Route nhlua.c's script loads through the archive
+ *
+ * Force-included (-include) when compiling NetHack's nhlua.c only, before
+ * lauxlib.h: every luaL_loadbuffer/luaL_loadbufferx there becomes
+ * ios_lua_archive_loadbufferx, which loads the precompiled chunk for an
+ * archived script and defers to luaL_loadbufferx for anything else.
+ *
+ * nhl_init/nhl_done are renamed too: the public ones are the warm-state
+ * layer in ios_lua_state.c, which builds on these.
+ */
+
+#ifndef IOS_LUA_ARCHIVE_HOOK_H
+#define IOS_LUA_ARCHIVE_HOOK_H
+
+#define luaL_loadbufferx ios_lua_archive_loadbufferx
+#define nhl_init ios_nhl_init_fresh
+#define nhl_done ios_nhl_done_fresh
+
+#endif /* IOS_LUA_ARCHIVE_HOOK_H */
@@ -0,0 +1,291 @@
+/*
+ * ios_lua_pool.c - Lua size-class pool (see ios_lua_pool.h)
+ *
+ * The slab range is reserved once with mmap (pages are committed on first
+ * touch). A slab belongs to one arena and one size class until its arena
+ * is reset; a block's slab, found by address arithmetic, tells free()
+ * where the block goes, so the osize Lua passes is only needed to copy
+ * malloc'd blocks on realloc.
+ */
+
+#include "ios_lua_pool.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define SLAB_SHIFT 16
+#define SLAB_SIZE ((size_t)1 << SLAB_SHIFT)        /* 64KB */
+#define REGION_SLABS 1024                          /* 64MB of address space */
+#define CLASS_COUNT 16
+#define MAX_CLASS_SIZE 512
+#define SWEEP_EMPTY_SLABS 16                       /* 1MB of empty slabs triggers a sweep */
+
+char ios_lua_pool_core_tag;
+
+static const uint16_t class_size[CLASS_COUNT] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512
+};
+
+/* (size + 15) / 16 -> size class */
+static const uint8_t class_of[MAX_CLASS_SIZE / 16 + 1] = {
+    0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+    12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15
+};
+
+typedef struct FreeBlock {
+    struct FreeBlock *next;
+} FreeBlock;
+
+typedef struct {
+    uint8_t in_use;                         /* 2 while a sweep releases it */
+    uint8_t arena;
+    uint8_t cls;
+    uint32_t live;                          /* Blocks allocated from this slab */
+} SlabInfo;
+
+typedef struct {
+    FreeBlock *free[CLASS_COUNT];
+    uint32_t bump_slab[CLASS_COUNT];        /* Slab being carved, +1 (0 = none) */
+    uint32_t bump_offset[CLASS_COUNT];
+    uint32_t empty_slabs;                   /* Sweepable: no live block, not a bump slab */
+    IOSLuaPoolArenaStats stats;
+} Arena;
+
+static uint8_t *region = NULL;
+static bool region_failed = false;
+static SlabInfo slabs[REGION_SLABS];
+static uint32_t slab_high = 0;              /* Slabs never handed out start here */
+static uint32_t free_slabs[REGION_SLABS];   /* Released slabs, reused first */
+static uint32_t free_slab_count = 0;
+static Arena arenas[IOS_LUA_ARENA_COUNT];
+static IOSLuaArena default_arena = IOS_LUA_ARENA_TRANSIENT;
+static uint64_t large_live = 0;
+static uint64_t fallbacks = 0;
+
+static bool reserve_region(void)
+{
+    if (region) return true;
+    if (region_failed) return false;
+    void *p = mmap(NULL, REGION_SLABS * SLAB_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (p == MAP_FAILED) {
+        region_failed = true;   /* Everything goes to malloc */
+        return false;
+    }
+    region = p;
+    return true;
+}
+
+static inline bool in_region(const void *p)
+{
+    return region && (uintptr_t)p - (uintptr_t)region < REGION_SLABS * SLAB_SIZE;
+}
+
+static inline SlabInfo *slab_of(const void *p)
+{
+    return &slabs[((uintptr_t)p - (uintptr_t)region) >> SLAB_SHIFT];
+}
+
+/* A slab a sweep would release: empty and no longer being carved */
+static inline bool slab_sweepable(const Arena *arena, uint32_t index)
+{
+    return slabs[index].live == 0 && arena->bump_slab[slabs[index].cls] != index + 1;
+}
+
+static void *block_alloc(IOSLuaArena a, unsigned cls)
+{
+    Arena *arena = &arenas[a];
+    void *block = arena->free[cls];
+    SlabInfo *slab;
+    if (block) {
+        arena->free[cls] = arena->free[cls]->next;
+        slab = slab_of(block);
+    } else {
+        size_t size = class_size[cls];
+        if (!arena->bump_slab[cls] || arena->bump_offset[cls] + size > SLAB_SIZE) {
+            uint32_t index;
+            if (free_slab_count) {
+                index = free_slabs[--free_slab_count];
+            } else if (slab_high < REGION_SLABS && reserve_region()) {
+                index = slab_high++;
+            } else {
+                return NULL;
+            }
+            uint32_t retired = arena->bump_slab[cls];
+            slabs[index] = (SlabInfo){ .in_use = 1, .arena = (uint8_t)a, .cls = (uint8_t)cls };
+            arena->bump_slab[cls] = index + 1;
+            if (retired && slabs[retired - 1].live == 0) {
+                arena->empty_slabs++;   /* Fully carved and already empty */
+            }
+            arena->bump_offset[cls] = 0;
+            if (++arena->stats.slabs_in_use > arena->stats.slabs_peak) {
+                arena->stats.slabs_peak = arena->stats.slabs_in_use;
+            }
+        }
+        block = region + (size_t)(arena->bump_slab[cls] - 1) * SLAB_SIZE + arena->bump_offset[cls];
+        arena->bump_offset[cls] += (uint32_t)size;
+        slab = &slabs[arena->bump_slab[cls] - 1];
+    }
+    if (slab_sweepable(arena, (uint32_t)(slab - slabs))) {
+        arena->empty_slabs--;
+    }
+    slab->live++;
+    arena->stats.live_blocks++;
+    arena->stats.live_bytes += class_size[cls];
+    return block;
+}
+
+static void release_slab(Arena *arena, uint32_t index)
+{
+    slabs[index].in_use = 0;
+    free_slabs[free_slab_count++] = index;
+    madvise(region + (size_t)index * SLAB_SIZE, SLAB_SIZE, MADV_FREE);
+    arena->stats.slabs_in_use--;
+}
+
+/* Release the empty slabs of an arena whose other states live on (a
+ * persistent theme state pins the transient arena): drop their blocks
+ * from the free lists, then hand the slabs back. Slabs still being
+ * carved stay. */
+static void sweep(IOSLuaArena a)
+{
+    Arena *arena = &arenas[a];
+    for (uint32_t i = 0; i < slab_high; i++) {
+        if (slabs[i].in_use == 1 && slabs[i].arena == a && slabs[i].live == 0 &&
+            arena->bump_slab[slabs[i].cls] != i + 1) {
+            slabs[i].in_use = 2;
+        }
+    }
+    for (unsigned cls = 0; cls < CLASS_COUNT; cls++) {
+        FreeBlock **link = &arena->free[cls];
+        while (*link) {
+            if (slab_of(*link)->in_use == 2) {
+                *link = (*link)->next;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < slab_high; i++) {
+        if (slabs[i].in_use == 2) {
+            release_slab(arena, i);
+        }
+    }
+    arena->empty_slabs = 0;   /* Every sweepable slab was just released */
+    arena->stats.sweeps++;
+}
+
+static void block_free(void *ptr)
+{
+    SlabInfo *slab = slab_of(ptr);
+    Arena *arena = &arenas[slab->arena];
+    FreeBlock *block = ptr;
+    block->next = arena->free[slab->cls];
+    arena->free[slab->cls] = block;
+    arena->stats.live_bytes -= class_size[slab->cls];
+    if (--slab->live == 0 && slab_sweepable(arena, (uint32_t)(slab - slabs))) {
+        arena->empty_slabs++;
+    }
+    if (--arena->stats.live_blocks == 0) {
+        ios_lua_pool_reset((IOSLuaArena)slab->arena);  /* Its last state closed */
+    } else if (arena->empty_slabs >= SWEEP_EMPTY_SLABS) {
+        sweep((IOSLuaArena)slab->arena);
+    }
+}
+
+static void pool_free(void *ptr)
+{
+    if (in_region(ptr)) {
+        block_free(ptr);
+    } else {
+        large_live--;
+        free(ptr);
+    }
+}
+
+void *ios_lua_pool_realloc(IOSLuaArena a, void *ptr, size_t osize, size_t nsize)
+{
+    if (nsize == 0) {
+        if (ptr) pool_free(ptr);
+        return NULL;
+    }
+    arenas[a].stats.allocs++;
+
+    bool small = nsize <= MAX_CLASS_SIZE;
+    unsigned cls = small ? class_of[(nsize + 15) >> 4] : 0;
+    bool pooled = ptr && in_region(ptr);
+
+    if (pooled) {
+        SlabInfo *slab = slab_of(ptr);
+        if (small && slab->cls == cls && slab->arena == a) return ptr;
+    } else if (ptr && !small) {
+        return realloc(ptr, nsize);     /* malloc'd and staying large */
+    }
+
+    size_t old = !ptr ? 0 : pooled ? class_size[slab_of(ptr)->cls] : osize;
+    void *block = small ? block_alloc(a, cls) : NULL;
+    if (!block) {
+        if (small) fallbacks++;
+        block = malloc(nsize);
+        if (!block) {
+            return ptr && nsize <= old ? ptr : NULL;  /* A shrink may keep the old block */
+        }
+        large_live++;
+    }
+
+    if (ptr) {
+        memcpy(block, ptr, old < nsize ? old : nsize);
+        pool_free(ptr);
+    }
+    return block;
+}
+
+void ios_lua_pool_set_default(IOSLuaArena arena)
+{
+    default_arena = arena;
+}
+
+IOSLuaArena ios_lua_pool_default(void)
+{
+    return default_arena;
+}
+
+void ios_lua_pool_reset(IOSLuaArena a)
+{
+    Arena *arena = &arenas[a];
+    for (uint32_t i = 0; i < slab_high; i++) {
+        if (slabs[i].in_use && slabs[i].arena == a) {
+            release_slab(arena, i);
+        }
+    }
+    memset(arena->free, 0, sizeof(arena->free));
+    memset(arena->bump_slab, 0, sizeof(arena->bump_slab));
+    arena->empty_slabs = 0;
+    arena->stats.live_blocks = 0;
+    arena->stats.live_bytes = 0;
+    arena->stats.resets++;
+}
+
+size_t ios_lua_pool_trim(void)
+{
+    size_t released = 0;
+    for (int a = 0; a < IOS_LUA_ARENA_COUNT; a++) {
+        if (!arenas[a].empty_slabs) continue;
+        uint64_t before = arenas[a].stats.slabs_in_use;
+        sweep((IOSLuaArena)a);
+        released += (size_t)(before - arenas[a].stats.slabs_in_use) * SLAB_SIZE;
+    }
+    return released;
+}
+
+void ios_lua_pool_get_stats(IOSLuaPoolStats *out)
+{
+    if (!out) return;
+    for (int a = 0; a < IOS_LUA_ARENA_COUNT; a++) {
+        out->arena[a] = arenas[a].stats;
+    }
+    out->large_live = large_live;
+    out->fallbacks = fallbacks;
+    out->reserved_bytes = region ? REGION_SLABS * SLAB_SIZE : 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * ios_lua_pool.h - Size-class pool allocator for the embedded Lua states
+ *
+ * nhl_alloc() used to send every Lua allocation (strings, tables,
+ * closures and the GC churn of themerms.lua / nhcore.lua) through
+ * re_alloc/zone_free into the game heap, interleaving Lua garbage with
+ * the objects the heap snapshots capture. Lua now allocates from this
+ * pool only: a reserved address range of 64KB slabs, each slab carved
+ * into blocks of one size class with an intrusive free list. Requests
+ * above the largest class (big tables, long strings) go to malloc.
+ * Nothing here touches the game heap, so heap images no longer carry
+ * Lua memory and heap restores no longer pull the Lua state out from
+ * under gl.luacore.
+ *
+ * ARENAS:
+ *   CORE       gl.luacore (nhcore.lua callbacks), alive for the session
+ *   TRANSIENT  every other state: dungeon.lua, special levels, themes
+ * Blocks remember their arena through their slab. When an arena's last
+ * block is freed (lua_close of the last level-generation state) all its
+ * slabs are released in bulk, free lists and physical pages included.
+ * Core blocks never pin transient slabs. A state that outlives level
+ * creation (a dungeon's theme state, an idle warm state, see
+ * ios_lua_state.h) does, so once 1MB of a pinned arena's slabs are empty
+ * they are swept out and released instead (slabs still being carved,
+ * one per size class, neither count nor go); the bulk release comes when
+ * the game shuts the idle states down.
+ *
+ * Allocations go to TRANSIENT unless their state was created inside
+ * ios_lua_core_init() or the allocator userdata is IOS_LUA_POOL_CORE.
+ *
+ * THREAD SAFETY: game thread only (Lua runs nowhere else).
+ */
+
+#ifndef IOS_LUA_POOL_H
+#define IOS_LUA_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+typedef enum {
+    IOS_LUA_ARENA_TRANSIENT = 0,
+    IOS_LUA_ARENA_CORE = 1,
+    IOS_LUA_ARENA_COUNT
+} IOSLuaArena;
+
+/* lua_Alloc userdata tag for states whose blocks belong to the core arena */
+extern char ios_lua_pool_core_tag;
+#define IOS_LUA_POOL_CORE ((void *)&ios_lua_pool_core_tag)
+
+typedef struct {
+    uint64_t live_blocks;       /* Pool blocks currently allocated */
+    uint64_t live_bytes;        /* Their size-class bytes */
+    uint64_t slabs_in_use;
+    uint64_t slabs_peak;
+    uint64_t resets;            /* Bulk releases of the whole arena */
+    uint64_t sweeps;            /* Releases of its empty slabs only */
+    uint64_t allocs;            /* Allocation + reallocation calls */
+} IOSLuaPoolArenaStats;
+
+typedef struct {
+    IOSLuaPoolArenaStats arena[IOS_LUA_ARENA_COUNT];
+    uint64_t large_live;        /* malloc'd blocks (above the largest class) */
+    uint64_t fallbacks;         /* Small blocks malloc'd because the range was full */
+    uint64_t reserved_bytes;    /* Address range reserved for slabs */
+} IOSLuaPoolStats;
+
+/* lua_Alloc contract: nsize 0 frees ptr; otherwise (re)allocates */
+void *ios_lua_pool_realloc(IOSLuaArena arena, void *ptr, size_t osize, size_t nsize);
+
+/* Arena for allocations whose userdata is not IOS_LUA_POOL_CORE */
+void ios_lua_pool_set_default(IOSLuaArena arena);
+IOSLuaArena ios_lua_pool_default(void);
+
+/* Release every block of an arena at once (its states must be gone) */
+void ios_lua_pool_reset(IOSLuaArena arena);
+
+/* l_nhcore_init() with gl.luacore built in, and tagged to, the core
+ * arena. An earlier core state not closed by l_nhcore_done() (a heap
+ * reset abandoned it) is released first. Defined in ios_nhlua_patch.c. */
+void ios_lua_core_init(void);
+
+/* Memory pressure: release every empty slab now (bytes released) */
+size_t ios_lua_pool_trim(void);
+
+NETHACK_EXPORT void ios_lua_pool_get_stats(IOSLuaPoolStats *out);
+
+#endif /* IOS_LUA_POOL_H */
@@ -0,0 +1,169 @@
+/*
+ * ios_lua_state.c - Warm Lua states (see ios_lua_state.h)
+ */
+
+#include "../NetHack/include/hack.h"
+#include "../NetHack/include/nhlua.h"
+#include "ios_lua_state.h"
+#include "ios_log.h"
+#include <string.h>
+
+/* NetHack's nhl_init/nhl_done, renamed in nhlua.c (ios_lua_archive_hook.h) */
+extern lua_State *ios_nhl_init_fresh(nhl_sandbox_info *sbi);
+extern void ios_nhl_done_fresh(lua_State *L);
+
+/* Registry keys (by address) of a warm state's baseline globals and chunks */
+static const char baseline_key = 0;
+static const char chunks_key = 0;
+
+static lua_State *idle_states[IOS_LUA_STATE_IDLE_MAX];
+static int idle_count = 0;
+static IOSLuaStateStats stats;
+
+static int is_warm(lua_State *L)
+{
+    int warm = lua_rawgetp(L, LUA_REGISTRYINDEX, &baseline_key) == LUA_TTABLE;
+    lua_pop(L, 1);
+    return warm;
+}
+
+/* Record the globals a fresh state starts with (base libraries, nh/des/
+ * obj/selection, nhlib.lua) and give it an empty chunk registry */
+static void make_warm(lua_State *L)
+{
+    lua_newtable(L);
+    lua_pushglobaltable(L);
+    lua_pushnil(L);
+    while (lua_next(L, -2)) {
+        lua_pushvalue(L, -2);
+        lua_insert(L, -2);
+        lua_rawset(L, -5);
+    }
+    lua_pop(L, 1);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &baseline_key);
+
+    lua_newtable(L);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &chunks_key);
+}
+
+/* Put the globals back to the baseline: drop what the invocation added,
+ * restore what it replaced or cleared. Clearing and assigning existing
+ * fields is allowed while traversing with lua_next. */
+static void scrub(lua_State *L)
+{
+    lua_settop(L, 0);
+    lua_pushglobaltable(L);                          /* 1: _G */
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &baseline_key); /* 2: baseline */
+
+    lua_pushnil(L);
+    while (lua_next(L, 1)) {
+        lua_pop(L, 1);
+        lua_pushvalue(L, -1);
+        if (lua_rawget(L, 2) == LUA_TNIL) {
+            lua_pop(L, 1);
+            lua_pushvalue(L, -1);
+            lua_pushnil(L);
+            lua_rawset(L, 1);
+        } else {
+            lua_pop(L, 1);
+        }
+    }
+
+    lua_pushnil(L);
+    while (lua_next(L, 2)) {
+        lua_pushvalue(L, -2);
+        lua_insert(L, -2);
+        lua_rawset(L, 1);
+    }
+    lua_settop(L, 0);
+}
+
+lua_State *nhl_init(nhl_sandbox_info *sbi)
+{
+    if (idle_count > 0) {
+        stats.reused++;
+        return idle_states[--idle_count];
+    }
+
+    lua_State *L = ios_nhl_init_fresh(sbi);
+    if (L) {
+        make_warm(L);
+        stats.fresh++;
+    }
+    return L;
+}
+
+void nhl_done(lua_State *L)
+{
+    if (!L) {
+        ios_nhl_done_fresh(L);
+        return;
+    }
+    for (int i = 0; i < idle_count; i++) {
+        if (idle_states[i] == L) {
+            /* A handle that outlived a heap restore, already given back */
+            IOS_LOG_W(IOS_LOG_CAT_GAME, "[LUA_STATE] nhl_done on idle state %p ignored", (void *)L);
+            return;
+        }
+    }
+
+    if (idle_count < IOS_LUA_STATE_IDLE_MAX && is_warm(L)) {
+        scrub(L);
+        idle_states[idle_count++] = L;
+        return;
+    }
+    stats.closed++;
+    ios_nhl_done_fresh(L);
+}
+
+/* Only script files are registered: other chunks (option and command
+ * strings) can reuse a name for different code */
+static int is_script(const char *name)
+{
+    size_t len = name ? strlen(name) : 0;
+    return len > 4 && strcmp(name + len - 4, ".lua") == 0;
+}
+
+int ios_lua_state_chunk_lookup(lua_State *L, const char *name)
+{
+    if (!is_script(name)) return 0;
+    if (lua_rawgetp(L, LUA_REGISTRYINDEX, &chunks_key) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        return 0;
+    }
+    if (lua_getfield(L, -1, name) != LUA_TFUNCTION) {
+        lua_pop(L, 2);
+        stats.chunk_misses++;
+        return 0;
+    }
+    lua_remove(L, -2);
+    stats.chunk_hits++;
+    return 1;
+}
+
+void ios_lua_state_chunk_register(lua_State *L, const char *name)
+{
+    if (!is_script(name)) return;
+    if (lua_rawgetp(L, LUA_REGISTRYINDEX, &chunks_key) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        return;
+    }
+    lua_pushvalue(L, -2);
+    lua_setfield(L, -2, name);
+    lua_pop(L, 1);
+}
+
+void ios_lua_state_shutdown(void)
+{
+    while (idle_count > 0) {
+        stats.closed++;
+        ios_nhl_done_fresh(idle_states[--idle_count]);
+    }
+}
+
+void ios_lua_state_get_stats(IOSLuaStateStats *out)
+{
+    if (!out) return;
+    *out = stats;
+    out->idle = (uint32_t)idle_count;
+}
@@ -0,0 +1,71 @@
+/*
+ * ios_lua_state.h - Warm Lua states reused across level generations
+ *
+ * Every special level, themed-room set, dungeon.lua and quest text load
+ * used to build a Lua state from nothing: nhl_init() opened the base
+ * libraries, registered nh/des/obj/selection and ran nhlib.lua, and
+ * nhl_done() closed it all again. That setup is paid on each stair
+ * descent that generates a level.
+ *
+ * nhl_init()/nhl_done() are now defined here. NetHack's own versions are
+ * renamed ios_nhl_init_fresh/ios_nhl_done_fresh inside nhlua.c by
+ * ios_lua_archive_hook.h, so only callers outside nhlua.c (sp_lev.c,
+ * mklev.c, dungeon.c, questpgr.c) come through this layer; gl.luacore,
+ * built by nhlua.c itself, is always a fresh state.
+ *
+ *   nhl_init  an idle warm state if there is one, else a fresh state
+ *             whose globals (after nhlib.lua) are recorded as its baseline
+ *   nhl_done  scrub the state back to its baseline and keep it idle, up
+ *             to IOS_LUA_STATE_IDLE_MAX states; close anything else
+ *
+ * Scrubbing removes every global the invocation added and restores every
+ * baseline global it replaced or cleared, so a script never sees another
+ * one's globals. Tables reachable from the baseline (nh, des, nhlib's
+ * helpers) are shared, as they are read-only by convention.
+ *
+ * Each warm state also keeps a registry of compiled chunks by script
+ * name. A script loaded again in the same state (themerms.lua for each
+ * dungeon branch, dungeon.lua and the special levels of the next game)
+ * reuses the function without parsing or undumping; its _ENV is the
+ * state's global table, which scrubbing keeps the same table.
+ *
+ * Without NHL_SANDBOX the sandbox flags and limits in nhl_sandbox_info
+ * are ignored by NetHack as well, so any warm state serves any caller.
+ *
+ * THREAD SAFETY: game thread only.
+ */
+
+#ifndef IOS_LUA_STATE_H
+#define IOS_LUA_STATE_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+
+#define IOS_LUA_STATE_IDLE_MAX 2
+
+struct lua_State;
+
+typedef struct {
+    uint64_t fresh;             /* States built by NetHack's nhl_init */
+    uint64_t reused;            /* nhl_init calls served by an idle state */
+    uint64_t closed;            /* States closed (idle list full, or shutdown) */
+    uint64_t chunk_hits;        /* Script loads served from a chunk registry */
+    uint64_t chunk_misses;      /* Script loads compiled/undumped and registered */
+    uint32_t idle;              /* Warm states waiting now */
+} IOSLuaStateStats;
+
+/*
+ * Chunk registry, for the hooked luaL_loadbufferx (ios_lua_archive.c):
+ * _lookup pushes the registered function for name and returns 1 (0 and
+ * nothing pushed if L is not a warm state or name is unknown); _register
+ * records the function on top of the stack under name, leaving it there.
+ */
+int ios_lua_state_chunk_lookup(struct lua_State *L, const char *name);
+void ios_lua_state_chunk_register(struct lua_State *L, const char *name);
+
+/* Close the idle states (the game is over; the next one starts cold) */
+void ios_lua_state_shutdown(void);
+
+NETHACK_EXPORT void ios_lua_state_get_stats(IOSLuaStateStats *out);
+
+#endif /* IOS_LUA_STATE_H */
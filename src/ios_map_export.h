@@ -0,0 +1,75 @@
+/*
+ * ios_map_export.h - Binary Map Export for Swift (zero-copy, seqlock)
+ *
+ * ARCHITECTURE:
+ * - ios_winprocs.c owns a packed copy of the map in NetHack coordinates
+ *   (x: 0-79, y: 0-20 - no buffer Y offset) and republishes the rows that
+ *   print_glyph() touched at each display sync point
+ * - Swift reads the cells in place through ios_map_export_get(); no string
+ *   building, no JSON, no copy unless the caller wants one
+ *
+ * VERSIONING:
+ * - Each publish bumps version and stamps row_version[y] on changed rows,
+ *   so a reader that skipped publishes still sees every changed row:
+ *     mask = ios_map_export_dirty_rows(my_last_version)
+ *
+ * THREAD SAFETY (seqlock):
+ * - Writer: NetHack game thread
+ * - Reader: any thread
+ *     uint32_t seq = ios_map_export_begin_read();
+ *     ... read cells / row_version ...
+ *     if (!ios_map_export_end_read(seq)) retry;
+ */
+
+#ifndef IOS_MAP_EXPORT_H
+#define IOS_MAP_EXPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nethack_export.h"
+
+/* Export dimensions - NetHack COLNO x ROWNO */
+#define MAP_EXPORT_WIDTH 80
+#define MAP_EXPORT_HEIGHT 21
+
+/* One map cell (12 bytes, no pointers) */
+typedef struct {
+    int32_t glyph;        /* NetHack glyph ID */
+    char ch;              /* ASCII character */
+    uint8_t color;        /* Color index */
+    uint8_t bg;           /* Background color */
+    uint8_t reserved;
+    uint32_t glyphflags;  /* MG_PET, MG_RIDDEN, MG_DETECT etc. */
+} PackedMapCell;
+
+/* Plain fields only (imports into Swift); the seqlock counter is private
+ * to ios_winprocs.c and reached through begin_read/end_read */
+typedef struct {
+    uint32_t version;         /* Completed publishes (0 = never published) */
+    uint16_t width;           /* MAP_EXPORT_WIDTH */
+    uint16_t height;          /* MAP_EXPORT_HEIGHT */
+    uint32_t last_dirty_rows; /* Rows changed by the latest publish (bit y) */
+    uint32_t row_version[MAP_EXPORT_HEIGHT];  /* version that last changed row y */
+    PackedMapCell cells[MAP_EXPORT_HEIGHT][MAP_EXPORT_WIDTH];  /* [y][x] */
+} MapExport;
+
+/* Stable pointer to the export (never NULL, lives for the dylib's lifetime) */
+NETHACK_EXPORT const MapExport *ios_map_export_get(void);
+
+/* Begin a read: waits out an in-progress publish, returns the sequence */
+NETHACK_EXPORT uint32_t ios_map_export_begin_read(void);
+
+/* End a read: true if nothing was published since begin (read is consistent) */
+NETHACK_EXPORT bool ios_map_export_end_read(uint32_t seq);
+
+/* Rows changed after since_version (bit y set). Call inside a read section. */
+NETHACK_EXPORT uint32_t ios_map_export_dirty_rows(uint32_t since_version);
+
+/* Consistent copy of the rows changed after *since_version (any thread)
+ * Copies whole rows into out (same [y][x] layout), updates *since_version.
+ * Returns: mask of rows copied (0 = nothing changed)
+ */
+NETHACK_EXPORT uint32_t ios_map_export_copy_changed(PackedMapCell out[MAP_EXPORT_HEIGHT][MAP_EXPORT_WIDTH],
+                                                    uint32_t *since_version);
+
+#endif /* IOS_MAP_EXPORT_H */
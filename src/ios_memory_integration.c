@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include "../NetHack/include/hack.h"
 #include "../zone_allocator/nethack_memory_final.h"
+#include "ios_hibernate.h"
 
 /* External NetHack functions */
 extern void savegamestate(NHFILE *);          /* NetHack save function (made public via patch) */
@@ -27,22 +28,25 @@ extern char SAVEF[];
 #define MEMORY_BACKUP_FILE "memory.bak"
 
 /*
- * Get full path for memory state file
+ * Build path for a file next to the save file (SAVEF's directory)
  */
-static const char* get_memory_state_path(void) {
-    static char path[1024];
+static void memory_file_path(char *path, size_t size, const char *name) {
     char *base = strrchr(SAVEF, '/');
 
     if (base) {
-        size_t dir_len = base - SAVEF;
-        strncpy(path, SAVEF, dir_len);
-        path[dir_len] = '\0';
-        strcat(path, "/");
-        strcat(path, MEMORY_STATE_FILE);
+        snprintf(path, size, "%.*s/%s", (int)(base - SAVEF), SAVEF, name);
     } else {
-        strcpy(path, MEMORY_STATE_FILE);
+        snprintf(path, size, "%s", name);
     }
+}
 
+/*
+ * Get full path for memory state file
+ */
+static const char* get_memory_state_path(void) {
+    static char path[1024];
+
+    memory_file_path(path, sizeof(path), MEMORY_STATE_FILE);
     fprintf(stderr, "[MEMORY_INT] Memory state path: %s\n", path);
     return path;
 }
@@ -163,6 +167,8 @@ void ios_cleanup_memory_state(void) {
         fprintf(stderr, "[MEMORY_INT] Deleted: %s\n", mem_path);
     }
 
+    ios_hibernate_discard();  /* The hibernated game is over */
+
     /* Reset allocator for new game */
     nh_restart();
     fprintf(stderr, "[MEMORY_INT] Memory allocator reset for new game\n");
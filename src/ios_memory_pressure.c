@@ -0,0 +1,133 @@
+/*
+ * ios_memory_pressure.c - Tiered purge on iOS memory warnings (see ios_memory_pressure.h)
+ */
+
+#include "ios_memory_pressure.h"
+#include "ios_input_ring.h"
+#include "ios_log.h"
+#include "ios_lua_pool.h"
+#include "ios_lua_state.h"
+#include "../zone_allocator/nethack_memory_final.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+typedef struct {
+    const char *name;
+    int min_level;
+    bool any_thread;
+    IOSMemoryPurgeFn fn;
+} PurgeEntry;
+
+static PurgeEntry purges[IOS_MEMORY_PURGE_MAX];
+static int purge_count = 0;
+static pthread_once_t builtins_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IOSMemoryPressureStats stats;
+static atomic_int pending_level = 0;
+
+/* --- Built-in purges (game thread) --- */
+
+static size_t purge_lua_states(int level)
+{
+    (void)level;
+    ios_lua_state_shutdown();   /* Their slabs empty out; the pool purge below releases them */
+    return 0;
+}
+
+static size_t purge_lua_pool(int level)
+{
+    (void)level;
+    return ios_lua_pool_trim();
+}
+
+static size_t purge_heap(int level)
+{
+    (void)level;
+    return nh_heap_release_free_pages();
+}
+
+static void add_purge(const char *name, int min_level, bool any_thread, IOSMemoryPurgeFn fn)
+{
+    purges[purge_count++] = (PurgeEntry){ name, min_level, any_thread, fn };
+}
+
+static void register_builtins(void)
+{
+    add_purge("lua_states", IOS_MEMORY_PRESSURE_CRITICAL, false, purge_lua_states);
+    add_purge("lua_pool", IOS_MEMORY_PRESSURE_WARNING, false, purge_lua_pool);
+    add_purge("heap", IOS_MEMORY_PRESSURE_WARNING, false, purge_heap);
+}
+
+bool ios_memory_pressure_register(const char *name, int min_level, bool any_thread,
+                                  IOSMemoryPurgeFn fn)
+{
+    pthread_once(&builtins_once, register_builtins);
+    if (!fn || purge_count >= IOS_MEMORY_PURGE_MAX) return false;
+    add_purge(name, min_level, any_thread, fn);
+    return true;
+}
+
+/* Run the purges of one kind that level reaches */
+static void run_purges(int level, bool any_thread)
+{
+    size_t released = 0;
+    uint64_t runs = 0;
+    for (int i = 0; i < purge_count; i++) {
+        if (purges[i].any_thread != any_thread || level < purges[i].min_level) continue;
+        size_t bytes = purges[i].fn(level);
+        IOS_LOG_I(IOS_LOG_CAT_MEMORY, "[MEM_PRESSURE] %s released %zu KB",
+                  purges[i].name, bytes / 1024);
+        released += bytes;
+        runs++;
+    }
+    pthread_mutex_lock(&stats_mutex);
+    stats.purges += runs;
+    stats.bytes_released += released;
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+static void run_game_purges(void *ctx)
+{
+    run_purges(*(int *)ctx, false);
+}
+
+void ios_memory_pressure_notify(int level)
+{
+    pthread_once(&builtins_once, register_builtins);
+    if (level > IOS_MEMORY_PRESSURE_CRITICAL) level = IOS_MEMORY_PRESSURE_CRITICAL;
+
+    pthread_mutex_lock(&stats_mutex);
+    stats.last_level = level;
+    if (level >= IOS_MEMORY_PRESSURE_WARNING) stats.notifications++;
+    pthread_mutex_unlock(&stats_mutex);
+    if (level < IOS_MEMORY_PRESSURE_WARNING) return;
+
+    IOS_LOG_W(IOS_LOG_CAT_MEMORY, "[MEM_PRESSURE] Level %d", level);
+    run_purges(level, true);
+    if (ios_input_ring_run_parked(run_game_purges, &level)) return;
+
+    /* Game thread busy (or not running): its next input wait runs them */
+    int pending = atomic_load(&pending_level);
+    while (pending < level && !atomic_compare_exchange_weak(&pending_level, &pending, level)) {
+    }
+    pthread_mutex_lock(&stats_mutex);
+    stats.deferred++;
+    pthread_mutex_unlock(&stats_mutex);
+}
+
+void ios_memory_pressure_poll(void)
+{
+    if (atomic_load_explicit(&pending_level, memory_order_relaxed) == 0) return;
+    int level = atomic_exchange(&pending_level, 0);
+    if (level > 0) run_purges(level, false);
+}
+
+void ios_memory_pressure_get_stats(IOSMemoryPressureStats *out)
+{
+    if (!out) return;
+    pthread_mutex_lock(&stats_mutex);
+    *out = stats;
+    pthread_mutex_unlock(&stats_mutex);
+    out->pending_level = atomic_load(&pending_level);
+}
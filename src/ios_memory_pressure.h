@@ -0,0 +1,68 @@
+/*
+ * ios_memory_pressure.h - Tiered purge on iOS memory warnings
+ *
+ * Nothing used to react when iOS asked for memory back: the committed part
+ * of the static heap, its free holes, the Lua pool and the warm Lua states
+ * all stayed resident until jetsam killed the process. Swift now forwards
+ * every warning (didReceiveMemoryWarning and the dispatch memory-pressure
+ * source) to ios_memory_pressure_notify(), which runs the registered purge
+ * callbacks whose tier the level reaches:
+ *
+ *   WARNING   give back what costs nothing to rebuild: the heap's free
+ *             pages and committed slack, the Lua pool's empty slabs
+ *   CRITICAL  also drop what is merely nice to keep: the idle warm Lua
+ *             states (the next level generation starts them cold)
+ *
+ * Most purges touch game-thread-only state. They run right away on the
+ * notifying thread if the game thread is parked at an input wait (it is
+ * held there while they run, see ios_input_ring_run_parked), otherwise at
+ * the game thread's next input wait. Purges registered as any-thread run
+ * immediately. Everything else the bridge keeps (map capture, message
+ * log, lookat and inventory caches) is fixed-size static storage with
+ * nothing to release; Swift purges its own caches (glyph tile geometry)
+ * next to the call.
+ *
+ * THREAD SAFETY: notify and stats from any thread; register and poll on
+ * the game thread (register before the first notify).
+ */
+
+#ifndef IOS_MEMORY_PRESSURE_H
+#define IOS_MEMORY_PRESSURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+#define IOS_MEMORY_PRESSURE_NORMAL   0
+#define IOS_MEMORY_PRESSURE_WARNING  1
+#define IOS_MEMORY_PRESSURE_CRITICAL 2
+
+#define IOS_MEMORY_PURGE_MAX 16
+
+/* Release what the level calls for; returns the bytes given back (estimate) */
+typedef size_t (*IOSMemoryPurgeFn)(int level);
+
+typedef struct {
+    uint64_t notifications;     /* notify calls at WARNING or above */
+    uint64_t deferred;          /* ... whose game-thread purges waited for an input wait */
+    uint64_t purges;            /* Callback runs */
+    uint64_t bytes_released;    /* Sum of what the callbacks reported */
+    int32_t last_level;
+    int32_t pending_level;      /* Waiting for the game thread (0 = none) */
+} IOSMemoryPressureStats;
+
+/* Add a purge for levels >= min_level (false if the table is full).
+ * Purges run in registration order; the built-in ones come first. */
+bool ios_memory_pressure_register(const char *name, int min_level, bool any_thread,
+                                  IOSMemoryPurgeFn fn);
+
+/* Swift: iOS reported memory pressure at level (IOS_MEMORY_PRESSURE_*) */
+NETHACK_EXPORT void ios_memory_pressure_notify(int level);
+
+/* Game thread, at each input wait: run purges deferred by notify */
+void ios_memory_pressure_poll(void);
+
+NETHACK_EXPORT void ios_memory_pressure_get_stats(IOSMemoryPressureStats *out);
+
+#endif /* IOS_MEMORY_PRESSURE_H */
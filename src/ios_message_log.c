@@ -0,0 +1,120 @@
+/*
+ * ios_message_log.c - Message log ring (see ios_message_log.h)
+ *
+ * The record for sequence id s lives in slot (s - 1) % CAPACITY, so the
+ * first record after any id is found without searching. Slots keep their
+ * header in the exported layout; fetch copies header + text as is.
+ */
+
+#include "ios_message_log.h"
+#include <pthread.h>
+#include <string.h>
+
+typedef struct {
+    IOSMessageRecord header;
+    char text[IOS_MESSAGE_LOG_TEXT_LEN];
+} LogSlot;
+
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LogSlot slots[IOS_MESSAGE_LOG_CAPACITY];
+static uint64_t last_seq = 0;
+static int retained = 0;
+
+static size_t record_size(size_t text_length)
+{
+    return (sizeof(IOSMessageRecord) + text_length + 1 + 7) & ~(size_t)7;
+}
+
+static LogSlot *slot_for(uint64_t seq)
+{
+    return &slots[(seq - 1) % IOS_MESSAGE_LOG_CAPACITY];
+}
+
+void ios_message_log_append(const char *text, const char *category, int attr, long turn)
+{
+    if (!text) return;
+
+    size_t len = strlen(text);
+    if (len > IOS_MESSAGE_LOG_TEXT_LEN - 1) len = IOS_MESSAGE_LOG_TEXT_LEN - 1;
+
+    pthread_mutex_lock(&log_mutex);
+    uint64_t seq = ++last_seq;
+    LogSlot *slot = slot_for(seq);
+    memset(&slot->header, 0, sizeof(slot->header));
+    slot->header.seq = seq;
+    slot->header.turn = (int32_t)turn;
+    slot->header.attr = attr;
+    slot->header.text_length = (uint16_t)len;
+    slot->header.record_size = (uint16_t)record_size(len);
+    strncpy(slot->header.category, category ? category : "MSG", sizeof(slot->header.category) - 1);
+    memcpy(slot->text, text, len);
+    slot->text[len] = '\0';
+    if (retained < IOS_MESSAGE_LOG_CAPACITY) retained++;
+    pthread_mutex_unlock(&log_mutex);
+}
+
+int ios_message_log_count(void)
+{
+    pthread_mutex_lock(&log_mutex);
+    int count = retained;
+    pthread_mutex_unlock(&log_mutex);
+    return count;
+}
+
+uint64_t ios_message_log_last_seq(void)
+{
+    pthread_mutex_lock(&log_mutex);
+    uint64_t seq = last_seq;
+    pthread_mutex_unlock(&log_mutex);
+    return seq;
+}
+
+int ios_message_log_fetch_since(uint64_t after_seq, void *buf, size_t buf_size)
+{
+    if (!buf) return 0;
+
+    pthread_mutex_lock(&log_mutex);
+    uint64_t oldest = last_seq - (uint64_t)retained + 1;
+    uint64_t seq = after_seq + 1 > oldest ? after_seq + 1 : oldest;
+
+    int written = 0;
+    size_t used = 0;
+    for (; seq <= last_seq; seq++) {
+        const LogSlot *slot = slot_for(seq);
+        size_t size = slot->header.record_size;
+        if (used + size > buf_size) break;
+
+        char *dst = (char *)buf + used;
+        memcpy(dst, &slot->header, sizeof(IOSMessageRecord));
+        memcpy(dst + sizeof(IOSMessageRecord), slot->text, (size_t)slot->header.text_length + 1);
+        used += size;
+        written++;
+    }
+    pthread_mutex_unlock(&log_mutex);
+    return written;
+}
+
+void ios_message_log_visit(ios_message_log_visitor visit, void *context)
+{
+    if (!visit) return;
+
+    pthread_mutex_lock(&log_mutex);
+    for (uint64_t seq = last_seq - (uint64_t)retained + 1; seq <= last_seq && retained; seq++) {
+        const LogSlot *slot = slot_for(seq);
+        visit(&slot->header, slot->text, context);
+    }
+    pthread_mutex_unlock(&log_mutex);
+}
+
+const char *ios_message_log_recent(int index)
+{
+    if (index < 0 || index >= retained) return "";
+    return slot_for(last_seq - (uint64_t)index)->text;
+}
+
+void ios_message_log_clear(void)
+{
+    pthread_mutex_lock(&log_mutex);
+    retained = 0;  /* last_seq stays: readers' cursors remain valid */
+    pthread_mutex_unlock(&log_mutex);
+}
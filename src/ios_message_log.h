@@ -0,0 +1,78 @@
+/*
+ * ios_message_log.h - Single message log with sequence ids
+ *
+ * One ring of game messages replaces the two histories that used to exist
+ * side by side (RealNetHackBridge.c's JSON-exported message_history and
+ * ios_msg_history.c's plain-text ring). Every message gets a sequence id
+ * that only ever increases - clearing the log does not reset it - so a
+ * reader remembers the last id it saw and asks for what came after.
+ *
+ * FETCH:
+ * ios_message_log_fetch_since() packs records into the caller's buffer:
+ *   IOSMessageRecord header, text bytes, NUL, padding to 8 bytes
+ * record_size is the stride to the next record. Cost is proportional to
+ * the number of new messages, found by arithmetic on the sequence id -
+ * never a walk of the whole history. If the reader fell further behind
+ * than IOS_MESSAGE_LOG_CAPACITY, the fetch starts at the oldest retained
+ * record (the gap shows as a jump in seq).
+ *
+ * THREAD SAFETY: append runs on the game thread, fetch on any thread; a
+ * mutex held for the copy orders them.
+ */
+
+#ifndef IOS_MESSAGE_LOG_H
+#define IOS_MESSAGE_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IOS_MESSAGE_LOG_CAPACITY 512     /* MessageHistoryManager keeps 500 */
+#define IOS_MESSAGE_LOG_TEXT_LEN 256
+
+typedef struct {
+    uint64_t seq;                        /* 1-based, strictly increasing */
+    int32_t turn;                        /* svm.moves when logged */
+    int32_t attr;                        /* NetHack ATR_* bits */
+    uint16_t text_length;                /* Bytes of text (NUL not counted) */
+    uint16_t record_size;                /* Header + text + NUL, rounded up to 8 */
+    char category[12];                   /* "COMBAT", "ITEM", "MSG", ... */
+    /* char text[text_length + 1] follows */
+} IOSMessageRecord;
+
+/* Append a message (game thread). Text is truncated to IOS_MESSAGE_LOG_TEXT_LEN - 1. */
+void ios_message_log_append(const char *text, const char *category, int attr, long turn);
+
+/* Messages retained, and the id of the newest (0 = none yet) */
+NETHACK_EXPORT int ios_message_log_count(void);
+NETHACK_EXPORT uint64_t ios_message_log_last_seq(void);
+
+/*
+ * Pack records with seq > after_seq, oldest first, into buf (8-byte
+ * aligned). Stops at the first record that doesn't fit. Returns the number
+ * of records written; the last one's seq is the next after_seq.
+ */
+NETHACK_EXPORT int ios_message_log_fetch_since(uint64_t after_seq, void *buf, size_t buf_size);
+
+/*
+ * Visit retained messages oldest first without packing (C callers, e.g.
+ * the legacy JSON export). The text pointer is only valid in the callback.
+ */
+typedef void (*ios_message_log_visitor)(const IOSMessageRecord *record, const char *text, void *context);
+void ios_message_log_visit(ios_message_log_visitor visit, void *context);
+
+/* Text of the message index back from the newest (0 = newest); game thread only */
+const char *ios_message_log_recent(int index);
+
+/* Drop retained messages; sequence ids keep counting */
+NETHACK_EXPORT void ios_message_log_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IOS_MESSAGE_LOG_H */
@@ -1,49 +1,34 @@
 /*
  * ios_msg_history.c - Message history implementation for 9/10 compliance
+ *
+ * Thin views over the shared message log (ios_message_log.c); this file
+ * no longer keeps a ring of its own.
  */
 
 #include "../NetHack/include/hack.h"
 #include "ios_wincap.h"
+#include "ios_message_log.h"
 #include <string.h>
 
-/* Global message history */
-ios_message_history ios_msg_hist = { .head = 0, .count = 0 };
-
 /* Add a message to history */
 void ios_add_message(const char *msg) {
     if (!msg || !*msg) return;
-
-    /* Copy message to circular buffer */
-    strncpy(ios_msg_hist.messages[ios_msg_hist.head], msg, BUFSZ - 1);
-    ios_msg_hist.messages[ios_msg_hist.head][BUFSZ - 1] = '\0';
-
-    /* Update head and count */
-    ios_msg_hist.head = (ios_msg_hist.head + 1) % IOS_MSG_HISTORY_SIZE;
-    if (ios_msg_hist.count < IOS_MSG_HISTORY_SIZE) {
-        ios_msg_hist.count++;
-    }
+    ios_message_log_append(msg, "MSG", 0, svm.moves);
 }
 
 /* Get message from history (0 = newest) */
 const char* ios_get_message_history(int index) {
-    if (index < 0 || index >= ios_msg_hist.count) {
-        return "";
-    }
-
-    /* Calculate actual index in circular buffer */
-    int actual_idx = (ios_msg_hist.head - 1 - index + IOS_MSG_HISTORY_SIZE)
-                     % IOS_MSG_HISTORY_SIZE;
-    return ios_msg_hist.messages[actual_idx];
+    return ios_message_log_recent(index);
 }
 
 /* Get total message count */
 int ios_message_count(void) {
-    return ios_msg_hist.count;
+    return ios_message_log_count();
 }
 
 /* Clear message history */
 void ios_clear_message_history(void) {
-    memset(&ios_msg_hist, 0, sizeof(ios_msg_hist));
+    ios_message_log_clear();
 }
 
 /* NetHack window proc callbacks for message history */
@@ -56,12 +41,13 @@ char* ios_getmsghistory_impl(boolean init) {
         return "";
     }
 
-    if (history_index >= ios_msg_hist.count) {
+    int count = ios_message_count();
+    if (history_index >= count) {
         return NULL;  /* No more messages */
     }
 
     /* Return messages oldest to newest for NetHack */
-    strncpy(history_buffer, ios_get_message_history(ios_msg_hist.count - 1 - history_index),
+    strncpy(history_buffer, ios_get_message_history(count - 1 - history_index),
             sizeof(history_buffer) - 1);
     history_buffer[sizeof(history_buffer) - 1] = '\0';
     history_index++;
@@ -77,4 +63,4 @@ void ios_putmsghistory_impl(const char *msg, boolean is_restoring) {
         /* Normal message - would be displayed and added */
         ios_add_message(msg);
     }
-}
\ No newline at end of file
+}
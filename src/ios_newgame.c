@@ -13,6 +13,8 @@
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/dlb.h"
 #include "ios_trace.h"
+#include "ios_input_journal.h"
+#include "ios_hibernate.h"
 
 // External functions we'll test one by one
 // notice_mon_off is a macro, not a function
@@ -61,6 +63,11 @@ void ios_newgame(void) {
     fprintf(stderr, "[IOS_NEWGAME] Starting iOS new game initialization\n");
     fflush(stderr);
 
+    // Level chunk tracking belongs to the previous game
+    extern void ios_level_store_reset(void);
+    ios_level_store_reset();
+    ios_hibernate_discard();  // So does a hibernation image
+
     // Follow NetHack's initialization order, adapted for iOS
 
     // 1. early_init() - GUARD CLAUSE (prevent double-init crash!)
@@ -411,6 +418,9 @@ void ios_newgame(void) {
     }
     fflush(stderr);
 
+    // Record the final selection, or replace it with the journaled one
+    ios_journal_identity();
+
     fprintf(stderr, "[IOS_NEWGAME] Step 7: Calling role_init()...\n");
     role_init();
     fprintf(stderr, "[IOS_NEWGAME] ✓ role_init() OK\n");
@@ -619,7 +629,7 @@ void ios_newgame(void) {
     fprintf(stderr, "[IOS_NEWGAME] Checking map buffer...\n");
 
     // Print first few lines of map buffer
-    extern char map_buffer[40][121];
+    extern char map_buffer[60][181];  // MAX_MAP_HEIGHT x MAX_MAP_WIDTH+1 (ios_winprocs.c)
     extern int actual_map_width, actual_map_height;
     extern boolean map_dirty;
 
@@ -3,32 +3,29 @@
 
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/nhlua.h"
-#include "../zone_allocator/nethack_zone.h"
+#include "ios_lua_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-// Zone-based memory allocator for iOS Lua
+// Lua allocator: the Lua pool (ios_lua_pool.h), never the game heap
 void* nhl_alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
-    static int alloc_count = 0;
-    (void)ud;    // unused without sandbox
-    (void)osize; // unused
-
-    alloc_count++;
-    if (alloc_count < 10) {  // Only log first few allocations
-        fprintf(stderr, "[NHL_ALLOC] #%d: ptr=%p, osize=%zu, nsize=%zu\n",
-                alloc_count, ptr, osize, nsize);
-    }
+    IOSLuaArena arena = ud == IOS_LUA_POOL_CORE ? IOS_LUA_ARENA_CORE : ios_lua_pool_default();
+    return ios_lua_pool_realloc(arena, ptr, osize, nsize);
+}
+
+// Build gl.luacore in the core arena so level-generation states, which
+// come and go, leave the transient arena empty and bulk-resettable
+void ios_lua_core_init(void) {
+    // l_nhcore_init() replaces gl.luacore unconditionally: a state still
+    // here was abandoned (heap reset) and nothing reaches its blocks
+    ios_lua_pool_reset(IOS_LUA_ARENA_CORE);
+
+    ios_lua_pool_set_default(IOS_LUA_ARENA_CORE);
+    l_nhcore_init();
+    ios_lua_pool_set_default(IOS_LUA_ARENA_TRANSIENT);
 
-    if (nsize == 0) {
-        if (ptr) zone_free(ptr);
-        return NULL;
-    } else {
-        // Use re_alloc from zone allocator
-        void *result = re_alloc((long*)ptr, nsize);
-        if (alloc_count < 10) {
-            fprintf(stderr, "[NHL_ALLOC] #%d: returning %p\n", alloc_count, result);
-        }
-        return result;
+    if (gl.luacore) {
+        lua_setallocf(gl.luacore, nhl_alloc, IOS_LUA_POOL_CORE);
     }
 }
 
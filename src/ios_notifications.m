@@ -2,70 +2,14 @@
  * ios_notifications.m - iOS notification posting for Swift UI
  *
  * This Objective-C file handles NSNotificationCenter posting for
- * the message system. Separated from RealNetHackBridge.c to avoid
- * compiling the entire bridge as Objective-C.
+ * prompt requests (hand, loot, text input). Per-turn signals (map,
+ * messages) go through the event bus instead (ios_event_bus.h).
+ * Separated from RealNetHackBridge.c to avoid compiling the entire
+ * bridge as Objective-C.
  */
 
 #import <Foundation/Foundation.h>
 
-// Post a NetHack message notification to Swift UI
-void ios_post_message_notification(const char* message, const char* category, int attr) {
-    // Guard 1: NULL pointer check
-    if (!message) {
-        fprintf(stderr, "[IOS_NOTIF] WARNING: NULL message pointer, skipping\n");
-        return;
-    }
-
-    // Guard 2: Empty string check
-    if (message[0] == '\0') {
-        fprintf(stderr, "[IOS_NOTIF] WARNING: Empty message, skipping\n");
-        return;
-    }
-
-    // CRITICAL FIX: Validate UTF-8 and handle encoding failures
-    // NetHack uses extended ASCII (Latin-1) and control codes, not always valid UTF-8!
-    NSString *messageCopy = [NSString stringWithUTF8String:message];
-
-    // Guard 3: Handle invalid UTF-8 (root cause of crash)
-    if (!messageCopy) {
-        // Fallback 1: Try Latin-1 encoding (common for NetHack extended ASCII)
-        messageCopy = [NSString stringWithCString:message encoding:NSISOLatin1StringEncoding];
-
-        if (!messageCopy) {
-            // Fallback 2: Create placeholder to prevent crash
-            messageCopy = [NSString stringWithFormat:@"[Invalid message encoding: %zu bytes]",
-                          strlen(message)];
-            fprintf(stderr, "[IOS_NOTIF] CRITICAL: Failed to decode message (first 4 bytes: %02X %02X %02X %02X)\n",
-                   (unsigned char)message[0], (unsigned char)message[1],
-                   (unsigned char)message[2], (unsigned char)message[3]);
-        } else {
-            fprintf(stderr, "[IOS_NOTIF] WARNING: Invalid UTF-8, used Latin-1 encoding\n");
-        }
-    }
-
-    // Category handling with fallback
-    NSString *categoryCopy = nil;
-    if (category) {
-        categoryCopy = [NSString stringWithUTF8String:category];
-        if (!categoryCopy) {
-            categoryCopy = @"MSG";  // Fallback if category encoding fails
-        }
-    } else {
-        categoryCopy = @"MSG";
-    }
-
-    // GUARANTEE: Both strings are now non-nil (prevents crash)
-    dispatch_async(dispatch_get_main_queue(), ^{
-        NSDictionary *messageDict = @{
-            @"message": messageCopy,      // GUARANTEED non-nil
-            @"category": categoryCopy,    // GUARANTEED non-nil
-            @"attr": @(attr)
-        };
-        [[NSNotificationCenter defaultCenter] postNotificationName:@"NetHackMessage"
-                                                            object:messageDict];
-    });
-}
-
 // Post hand selection request notification to Swift UI
 // Swift should show a left/right hand picker and queue 'l', 'L', 'r', 'R', or ESC
 __attribute__((visibility("default")))
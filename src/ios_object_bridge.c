@@ -16,6 +16,8 @@
  */
 
 #include "ios_object_bridge.h"
+#include "ios_object_index.h"
+#include "ios_kill_stats.h"
 #include "../NetHack/include/hack.h"
 #include "../NetHack/include/stairs.h"
 #include "nethack_safe.h"  // For MAP_Y_OFFSET coordinate conversion
@@ -78,10 +80,12 @@ NETHACK_EXPORT int ios_get_objects_at(int x, int y, IOSObjectInfo *buffer, int m
         return 0;
     }
 
-    /* Guard: Check if objects are visible at this position
-     * covers_objects() returns true for water/lava that hide objects
+    /* Guard: Nothing visible here (empty, or water/lava covers_objects()).
+     * The tile summary answers this without touching the chain - taps on
+     * empty floor are the common case.
      */
-    if (covers_objects(map_x, map_y)) {
+    IOSTileObjectSummary summary;
+    if (!ios_get_tile_object_summary(map_x, map_y, &summary)) {
         return 0;
     }
     
@@ -318,6 +322,7 @@ NETHACK_EXPORT int ios_get_terrain_at(int x, int y, IOSTerrainInfo *info_out)
  *
  * Uses mvitals[].seen_close to determine which monsters player has seen.
  * Uses mvitals[].died to determine kill count.
+ * Both are tracked by ios_kill_stats, which diffs them once per command.
  *
  * Reference: origin/NetHack/src/mon.c lines 5965-5966 for seen_close
  * Reference: origin/NetHack/include/hack.h for mvitals struct
@@ -341,36 +346,10 @@ NETHACK_EXPORT int ios_get_discovered_monsters(IOSMonsterInfo *buffer, int max_m
         return 0;
     }
 
-    /* Iterate through all monster types
-     * LOW_PM (0) to NUMMONS-1 covers all valid monster indices
-     * Reference: origin/NetHack/include/permonst.h for PM_* constants
+    /* Discovery list and names are maintained incrementally
+     * (ios_kill_stats.h): a copy, not a scan over every monster type
      */
-    for (int i = LOW_PM; i < NUMMONS && count < max_monsters; i++) {
-        /* Skip monsters player hasn't seen up close */
-        if (!svm.mvitals[i].seen_close) {
-            continue;
-        }
-
-        /* Copy monster name from mons array
-         * pmnames[NEUTRAL] gives the gender-neutral name
-         * Reference: origin/NetHack/src/monst.c for mons[] array
-         */
-        const char *name = mons[i].pmnames[NEUTRAL];
-        if (!name) {
-            continue;  /* Defensive: skip if no name */
-        }
-
-        strncpy(buffer[count].name, name, 63);
-        buffer[count].name[63] = '\0';
-
-        /* Copy monster info */
-        buffer[count].monster_index = i;
-        buffer[count].killed_count = svm.mvitals[i].died;
-        buffer[count].killed = (svm.mvitals[i].died > 0);
-        buffer[count].seen_only = !buffer[count].killed;
-
-        count++;
-    }
+    count = ios_kill_stats_discovered(buffer, max_monsters);
 
     return count;
 }
@@ -387,37 +366,18 @@ NETHACK_EXPORT int ios_get_discovered_monsters(IOSMonsterInfo *buffer, int max_m
  */
 NETHACK_EXPORT int ios_has_container_at(int x, int y)
 {
-    struct obj *otmp;
+    IOSTileObjectSummary summary;
 
     /* Guard: Don't access during death - game state may be invalid */
     if (player_has_died || program_state.gameover) {
         return 0;
     }
 
-    /* Guard: Bounds check */
-    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) {
-        return 0;
-    }
-
-    /* Guard: Check if objects are visible at this position */
-    if (covers_objects(x, y)) {
+    /* Tile summary: bounds-checked, and covered tiles (covers_objects)
+     * report no objects. Is_container() was evaluated at index build.
+     */
+    if (!ios_get_tile_object_summary(x, y, &summary)) {
         return 0;
     }
-
-    /* Iterate through object chain looking for containers */
-    for (otmp = vobj_at(x, y); otmp; otmp = otmp->nexthere) {
-        /* Skip objects marked for deletion */
-        if (otmp->where == OBJ_DELETED) {
-            continue;
-        }
-
-        /* Is_container() macro checks for bags, boxes, ice boxes
-         * Defined in origin/NetHack/include/objclass.h
-         */
-        if (Is_container(otmp)) {
-            return 1;
-        }
-    }
-
-    return 0;
+    return (summary.flags & IOS_TILE_HAS_CONTAINER) ? 1 : 0;
 }
@@ -0,0 +1,69 @@
+/*
+ * ios_object_fingerprint.c - Object name fingerprint
+ * (see ios_object_fingerprint.h)
+ */
+
+#include "ios_object_fingerprint.h"
+#include "hack.h"
+
+#define FNV_PRIME 0x100000001b3ULL
+
+uint64_t ios_fingerprint_mix(uint64_t h, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) {
+        h ^= (v >> (i * 8)) & 0xff;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+/* Length and bytes of s: renames free the old string and dupstr the new
+ * one, which the heap may hand back at the same address */
+static uint64_t mix_string(uint64_t h, const char *s)
+{
+    if (!s) return ios_fingerprint_mix(h, UINT64_MAX);
+    size_t n = 0;
+    for (; s[n]; n++) {
+        h ^= (unsigned char)s[n];
+        h *= FNV_PRIME;
+    }
+    return ios_fingerprint_mix(h, (uint64_t)n);
+}
+
+uint64_t ios_fingerprint_object(uint64_t h, struct obj *obj)
+{
+    int contents = 0;
+    for (struct obj *c = obj->cobj; c && contents < 1000; c = c->nobj) contents++;
+
+    h = ios_fingerprint_mix(h, obj->o_id);
+    h = ios_fingerprint_mix(h, (uint64_t)obj->otyp | ((uint64_t)(unsigned char)obj->invlet << 16)
+                                   | ((uint64_t)(unsigned char)obj->oclass << 24)
+                                   | ((uint64_t)(unsigned char)obj->oartifact << 32));
+    h = ios_fingerprint_mix(h, (uint64_t)obj->quan);
+    h = ios_fingerprint_mix(h, (uint64_t)obj->owornmask);
+    h = ios_fingerprint_mix(h, (uint64_t)(uint16_t)obj->spe | ((uint64_t)(uint32_t)obj->owt << 16));
+    /* Corpse/statue/tin/egg/figurine species, "partly eaten", leash target */
+    h = ios_fingerprint_mix(h, (uint64_t)(uint32_t)obj->corpsenm
+                                   | ((uint64_t)(uint32_t)obj->leashmon << 32));
+    h = ios_fingerprint_mix(h, (uint64_t)obj->oeaten);
+    h = ios_fingerprint_mix(h, (uint64_t)obj->blessed | obj->cursed << 1 | obj->bknown << 2
+                                   | obj->known << 3 | obj->dknown << 4 | obj->rknown << 5
+                                   | obj->cknown << 6 | obj->lknown << 7 | obj->oeroded << 8
+                                   | obj->oeroded2 << 10 | obj->oerodeproof << 12
+                                   | obj->greased << 13 | obj->lamplit << 14
+                                   | obj->opoisoned << 15 | obj->olocked << 16
+                                   | obj->obroken << 17 | obj->otrapped << 18
+                                   | (uint64_t)obj->recharged << 19 | (uint64_t)contents << 24
+                                   | (uint64_t)obj->odiluted << 40 | (uint64_t)obj->unpaid << 41
+                                   | (uint64_t)obj->no_charge << 42
+                                   | (uint64_t)iflags.implicit_uncursed << 43
+                                   | (uint64_t)(obj->owornmask && u.twoweap) << 44
+                                   | (uint64_t)(Is_candle(obj) && obj->age < 20L * (long)
+                                                objects[obj->otyp].oc_cost) << 45);
+    /* "(unpaid, N zorkmids)": the price moves with the shopkeeper's mood */
+    if (obj->unpaid) h = ios_fingerprint_mix(h, (uint64_t)unpaid_cost(obj, FALSE));
+    h = mix_string(h, has_oname(obj) ? ONAME(obj) : NULL);
+    h = mix_string(h, objects[obj->otyp].oc_uname);
+    h = ios_fingerprint_mix(h, (uint64_t)objects[obj->otyp].oc_name_known);
+    return h;
+}
@@ -0,0 +1,33 @@
+/*
+ * ios_object_fingerprint.h - FNV-1a hash over what an object's name shows
+ *
+ * Caches of doname()/xname() text (the read model's inventory and floor
+ * sections, the farlook cache through the object index's pile
+ * generations) compare one 64-bit fingerprint instead of formatting the
+ * names again. The fingerprint covers every object field doname() reads
+ * (identification and BUC bits, erosion, charges, species, eaten and
+ * diluted state, container contents, worn/leash state, unpaid price,
+ * names and type naming, hashed by content) plus the options it
+ * consults, so equal fingerprints mean the text would come out the same.
+ * Blind and Hallucination are the caller's to fold in (per list, not per
+ * object).
+ *
+ * THREAD SAFETY: game thread, or while it is parked (reads live objects).
+ */
+
+#ifndef IOS_OBJECT_FINGERPRINT_H
+#define IOS_OBJECT_FINGERPRINT_H
+
+#include <stdint.h>
+
+#define IOS_FINGERPRINT_OFFSET 0xcbf29ce484222325ULL
+
+struct obj;
+
+/* Fold the 8 bytes of v into h */
+uint64_t ios_fingerprint_mix(uint64_t h, uint64_t v);
+
+/* Fold everything about obj that changes its doname()/xname() text into h */
+uint64_t ios_fingerprint_object(uint64_t h, struct obj *obj);
+
+#endif /* IOS_OBJECT_FINGERPRINT_H */
@@ -0,0 +1,193 @@
+/*
+ * ios_object_index.c - Floor object index (see ios_object_index.h)
+ *
+ * The hash is keyed by o_id with linear probing; capacity is a power of
+ * two at least twice the floor object count, grown (never shrunk) on
+ * rebuild. Rebuilds clear the stale flag before walking, so an invalidate
+ * that races a rebuild is never lost.
+ */
+
+#include "ios_object_index.h"
+#include "ios_object_fingerprint.h"
+#include "../NetHack/include/hack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(IOS_OBJECT_INDEX_COLS == COLNO && IOS_OBJECT_INDEX_ROWS == ROWNO,
+               "object index grid must match the NetHack map");
+
+extern int game_started;
+extern int player_has_died;
+
+typedef struct {
+    unsigned int o_id;          /* 0 = empty slot (o_ids start at 1) */
+    struct obj *obj;
+} IndexSlot;
+
+static pthread_mutex_t index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool stale = true;
+static _Atomic uint32_t generation = 0;
+
+static IOSTileObjectSummary tiles[ROWNO][COLNO];
+static uint64_t pile_hash[ROWNO][COLNO];    /* Whole-pile fingerprint at the last rebuild */
+static uint32_t pile_gen[ROWNO][COLNO];     /* Bumped when pile_hash moves */
+static IndexSlot *slots;
+static size_t slot_capacity;    /* Power of two */
+
+static size_t slot_for(unsigned int o_id)
+{
+    return (size_t)(o_id * 2654435761u) & (slot_capacity - 1);
+}
+
+static void insert(struct obj *obj)
+{
+    size_t i = slot_for(obj->o_id);
+    while (slots[i].o_id && slots[i].o_id != obj->o_id) {
+        i = (i + 1) & (slot_capacity - 1);
+    }
+    slots[i].o_id = obj->o_id;
+    slots[i].obj = obj;
+}
+
+/* Make room for count objects at <= 50% load; false if out of memory */
+static bool reserve(size_t count)
+{
+    size_t want = 64;
+    while (want < count * 2) want <<= 1;
+
+    if (want > slot_capacity) {
+        IndexSlot *grown = realloc(slots, want * sizeof(IndexSlot));
+        if (!grown) return false;
+        slots = grown;
+        slot_capacity = want;
+    }
+    memset(slots, 0, slot_capacity * sizeof(IndexSlot));
+    return true;
+}
+
+/* Caller holds index_mutex */
+static void rebuild(void)
+{
+    atomic_store(&stale, false);
+    memset(tiles, 0, sizeof(tiles));
+
+    if (!game_started || player_has_died || program_state.gameover) {
+        if (slots) memset(slots, 0, slot_capacity * sizeof(IndexSlot));
+        for (int y = 0; y < ROWNO; y++)
+            for (int x = 0; x < COLNO; x++) tiles[y][x].top_glyph = -1;
+        atomic_fetch_add(&generation, 1);
+        return;
+    }
+
+    size_t total = 0;
+    for (int x = 0; x < COLNO; x++)
+        for (int y = 0; y < ROWNO; y++)
+            for (struct obj *obj = svl.level.objects[x][y]; obj; obj = obj->nexthere) total++;
+    bool hashed = reserve(total);
+
+    for (int x = 0; x < COLNO; x++) {
+        for (int y = 0; y < ROWNO; y++) {
+            IOSTileObjectSummary *t = &tiles[y][x];
+            struct obj *top = svl.level.objects[x][y];
+            uint64_t h = IOS_FINGERPRINT_OFFSET;
+            t->top_glyph = -1;
+
+            for (struct obj *obj = top; obj; obj = obj->nexthere) {
+                if (obj->where == OBJ_DELETED) continue;
+                if (hashed) insert(obj);
+                h = ios_fingerprint_object(h, obj);
+                if (t->count < UINT16_MAX) t->count++;
+                if (Is_container(obj)) {
+                    t->flags |= IOS_TILE_HAS_CONTAINER;
+                    if (obj->olocked) t->flags |= IOS_TILE_HAS_LOCKED_CONTAINER;
+                }
+            }
+            if (h != pile_hash[y][x]) {
+                pile_hash[y][x] = h;
+                pile_gen[y][x]++;
+            }
+            if (!t->count) continue;
+
+            t->top_glyph = obj_to_glyph(top, rn2_on_display_rng);
+            t->top_o_id = top->o_id;
+            if (covers_objects(x, y)) {
+                t->flags = IOS_TILE_COVERED;
+                t->count = 0;
+            }
+        }
+    }
+    atomic_fetch_add(&generation, 1);
+}
+
+/* Lock and bring the index up to date */
+static void lock_current(void)
+{
+    pthread_mutex_lock(&index_mutex);
+    if (atomic_load(&stale)) rebuild();
+}
+
+void ios_object_index_invalidate(void)
+{
+    atomic_store(&stale, true);
+}
+
+struct obj *ios_object_index_find(unsigned int o_id)
+{
+    struct obj *found = NULL;
+    if (!o_id) return NULL;
+
+    lock_current();
+    if (slot_capacity) {
+        size_t i = slot_for(o_id);
+        while (slots[i].o_id) {
+            if (slots[i].o_id == o_id) {
+                found = slots[i].obj;
+                break;
+            }
+            i = (i + 1) & (slot_capacity - 1);
+        }
+    }
+    pthread_mutex_unlock(&index_mutex);
+    return found;
+}
+
+int ios_get_tile_object_summary(int x, int y, IOSTileObjectSummary *out)
+{
+    if (!out) return 0;
+    memset(out, 0, sizeof(*out));
+    out->top_glyph = -1;
+    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) return 0;
+
+    lock_current();
+    *out = tiles[y][x];
+    pthread_mutex_unlock(&index_mutex);
+    return out->count > 0;
+}
+
+uint32_t ios_object_index_pile_generation(int x, int y)
+{
+    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) return 0;
+
+    lock_current();
+    uint32_t gen = pile_gen[y][x];
+    pthread_mutex_unlock(&index_mutex);
+    return gen;
+}
+
+int ios_copy_object_summaries(IOSTileObjectSummary *out, int max)
+{
+    if (!out || max <= 0) return 0;
+    int count = max < COLNO * ROWNO ? max : COLNO * ROWNO;
+
+    lock_current();
+    memcpy(out, tiles, (size_t)count * sizeof(IOSTileObjectSummary));
+    pthread_mutex_unlock(&index_mutex);
+    return count;
+}
+
+uint32_t ios_object_index_generation(void)
+{
+    return atomic_load(&generation);
+}
@@ -0,0 +1,73 @@
+/*
+ * ios_object_index.h - Floor object index for the current level
+ *
+ * Tile taps and context actions ask "what is here / is there a container"
+ * many times per turn; each question used to walk the tile's object chain
+ * (or, for o_id lookups, the whole chain). The index answers in O(1):
+ *
+ *   - o_id -> floor object (open-addressed hash over every floor object)
+ *   - per tile: object count, top object glyph, container / locked flags
+ *   - per tile: a pile generation, moved by a rebuild when anything the
+ *     names of the tile's objects show changed (ios_object_fingerprint.h),
+ *     below the top object included
+ *
+ * UPDATES: objects only move while the game thread runs a command, so the
+ * index is marked stale at the first input wait after a key was taken
+ * (not on every poll of one wait), on map clear (level change) and on
+ * new game, and rebuilt by the first
+ * query after that - one pass over the level's object chains, at most
+ * once per command. (Container transfers only change contents, which the
+ * index does not describe.)
+ *
+ * THREAD SAFETY: queries and rebuilds hold the index mutex. Like the rest
+ * of the object bridge, queries are for when the game thread is parked in
+ * an input wait.
+ */
+
+#ifndef IOS_OBJECT_INDEX_H
+#define IOS_OBJECT_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* IOSTileObjectSummary.flags */
+#define IOS_TILE_HAS_CONTAINER         0x01
+#define IOS_TILE_HAS_LOCKED_CONTAINER  0x02
+#define IOS_TILE_COVERED               0x04  /* Water/lava hide the objects */
+
+/* Map grid exported by ios_copy_object_summaries (NetHack COLNO x ROWNO) */
+#define IOS_OBJECT_INDEX_COLS 80
+#define IOS_OBJECT_INDEX_ROWS 21
+
+typedef struct {
+    int32_t top_glyph;          /* Glyph of the top object (-1 if empty) */
+    uint32_t top_o_id;          /* o_id of the top object (0 if empty) */
+    uint16_t count;             /* Objects on the tile (0 when covered) */
+    uint8_t flags;              /* IOS_TILE_* */
+    uint8_t reserved;
+} IOSTileObjectSummary;
+
+/* Mark the index stale: rebuilt on the next query */
+void ios_object_index_invalidate(void);
+
+/* Floor object with this o_id on the current level, or NULL */
+struct obj *ios_object_index_find(unsigned int o_id);
+
+/* Summary for one tile (NetHack coordinates); 1 if it holds visible objects */
+NETHACK_EXPORT int ios_get_tile_object_summary(int x, int y, IOSTileObjectSummary *out);
+
+/* Pile generation for one tile (NetHack coordinates): equal values mean
+ * the same objects with the same names */
+uint32_t ios_object_index_pile_generation(int x, int y);
+
+/*
+ * Whole level at once, row-major (index y * IOS_OBJECT_INDEX_COLS + x).
+ * max is in summaries; returns the number written.
+ */
+NETHACK_EXPORT int ios_copy_object_summaries(IOSTileObjectSummary *out, int max);
+
+/* Bumped on every rebuild: Swift re-copies the grid only when it moves */
+NETHACK_EXPORT uint32_t ios_object_index_generation(void);
+
+#endif /* IOS_OBJECT_INDEX_H */
@@ -0,0 +1,224 @@
+/*
+ * ios_read_model.c - Versioned read model (see ios_read_model.h)
+ *
+ * SEQLOCK PUBLICATION (same scheme as ios_game_state_buffer.c):
+ * - Writer fills private staging, publishes under an odd/even sequence
+ * - Reader copies and retries if the sequence moved
+ * - Version handed to Swift is seq / 2 (completed publications)
+ *
+ * SECTION CACHING (writer only):
+ * - Inventory: FNV-1a fingerprint over every field doname() output depends
+ *   on (ios_object_fingerprint.h) plus Blind/Hallucination. Unchanged ->
+ *   names reused; changed -> records taken from ios_inventory_cache.
+ * - Floor: same fingerprint over the pile under the player plus position
+ *   and level. Unchanged -> xname() calls skipped.
+ * - Status: rebuilt every publish (a few field reads)
+ */
+
+#include "ios_read_model.h"
+#include "hack.h"
+#include "ios_character_status.h"
+#include "ios_inventory_cache.h"
+#include "ios_object_fingerprint.h"
+#include <stdatomic.h>
+#include <string.h>
+
+_Static_assert(READ_MODEL_SLOT_COUNT == IOS_SLOT_COUNT, "read model slots must match IOS_SLOT_*");
+
+extern int game_started;
+extern int player_has_died;
+
+static GameReadModel staging;
+static GameReadModel published;
+static _Atomic uint32_t model_seq = 0;
+
+/* Section fingerprints of staging (0 = rebuild) */
+static uint64_t inventory_fingerprint;
+static uint64_t floor_fingerprint;
+
+static void build_inventory(GameReadModel *m)
+{
+    static InventoryCache inv;  /* Writer only */
+
+    uint64_t h = ios_fingerprint_mix(IOS_FINGERPRINT_OFFSET,
+                                     (uint64_t)Blind | (uint64_t)Hallucination << 1);
+    for (struct obj *obj = gi.invent; obj; obj = obj->nobj) h = ios_fingerprint_object(h, obj);
+    if (h == inventory_fingerprint) return;
+    inventory_fingerprint = h;
+
+    /* Names come from the export cache; a fingerprint move it wasn't told
+     * about (no update_inventory() call) forces its rebuild too */
+    ios_inventory_cache_invalidate();
+    ios_inventory_cache_refresh();
+    ios_inventory_cache_copy(&inv);
+
+    int count = inv.count < READ_MODEL_MAX_INVENTORY ? inv.count : READ_MODEL_MAX_INVENTORY;
+    for (int i = 0; i < count; i++) {
+        const InventoryCacheRecord *r = &inv.records[i];
+        ReadModelItem *item = &m->inventory[i];
+        memset(item, 0, sizeof(*item));
+        strncpy(item->name, &inv.names[r->name_offset], READ_MODEL_NAME_LEN - 1);
+        memcpy(item->equipped_slot, r->equipped_slot, sizeof(item->equipped_slot));
+        item->o_id = r->o_id;
+        item->quantity = r->quantity;
+        item->weight = r->weight;
+        item->otyp = r->otyp;
+        item->enchantment = r->enchantment;
+        item->invlet = r->invlet;
+        item->oclass = r->oclass;
+        item->buc_known = r->buc_known;
+        item->buc_status = r->buc_status;
+        item->is_equipped = r->is_equipped;
+        item->is_container = r->is_container;
+    }
+    m->inventory_count = count;
+
+    struct obj *slots[READ_MODEL_SLOT_COUNT] = {
+        [IOS_SLOT_BODY_ARMOR] = uarm, [IOS_SLOT_CLOAK] = uarmc, [IOS_SLOT_HELMET] = uarmh,
+        [IOS_SLOT_SHIELD] = uarms, [IOS_SLOT_GLOVES] = uarmg, [IOS_SLOT_BOOTS] = uarmf,
+        [IOS_SLOT_SHIRT] = uarmu, [IOS_SLOT_WEAPON] = uwep, [IOS_SLOT_SECONDARY] = uswapwep,
+        [IOS_SLOT_QUIVER] = uquiver, [IOS_SLOT_AMULET] = uamul, [IOS_SLOT_LEFT_RING] = uleft,
+        [IOS_SLOT_RIGHT_RING] = uright, [IOS_SLOT_BLINDFOLD] = ublindf,
+    };
+    m->equipment_cursed = m->equipment_blessed = 0;
+    for (int s = 0; s < READ_MODEL_SLOT_COUNT; s++) {
+        m->equipment[s] = -1;
+        if (!slots[s]) continue;
+        for (int i = 0; i < count; i++) {
+            if (m->inventory[i].o_id == slots[s]->o_id) {
+                m->equipment[s] = (int8_t)i;
+                break;
+            }
+        }
+        if (slots[s]->bknown && slots[s]->cursed) m->equipment_cursed |= (uint16_t)(1u << s);
+        if (slots[s]->bknown && slots[s]->blessed) m->equipment_blessed |= (uint16_t)(1u << s);
+    }
+}
+
+static void build_status(ReadModelStatus *s)
+{
+    const char *form = ios_get_polymorph_form();
+
+    memset(s, 0, sizeof(*s));
+    strncpy(s->role, ios_get_current_role_name(), sizeof(s->role) - 1);
+    strncpy(s->race, ios_get_current_race_name(), sizeof(s->race) - 1);
+    strncpy(s->gender, ios_get_current_gender_name(), sizeof(s->gender) - 1);
+    strncpy(s->alignment, ios_get_current_alignment_name(), sizeof(s->alignment) - 1);
+    if (form) strncpy(s->polymorph_form, form, sizeof(s->polymorph_form) - 1);
+    s->level = ios_get_player_level();
+    s->experience = ios_get_player_experience();
+    s->hunger = ios_get_hunger_state();
+    s->encumbrance = ios_get_encumbrance();
+    s->conditions = ios_get_condition_mask();
+    s->polymorph_turns = ios_get_polymorph_turns_left();
+    s->polymorphed = ios_is_polymorphed() != 0;
+    s->weapon_welded = ios_is_weapon_welded() != 0;
+    s->left_ring_available = ios_is_left_ring_available() != 0;
+    s->right_ring_available = ios_is_right_ring_available() != 0;
+}
+
+static void build_floor(GameReadModel *m)
+{
+    uint64_t h = ios_fingerprint_mix(IOS_FINGERPRINT_OFFSET,
+                                     (uint64_t)u.ux | (uint64_t)u.uy << 8
+                                     | (uint64_t)(uint8_t)u.uz.dnum << 16
+                                     | (uint64_t)(uint8_t)u.uz.dlevel << 24
+                                     | (uint64_t)Blind << 32 | (uint64_t)Hallucination << 33);
+    int n = 0;
+    for (struct obj *obj = vobj_at(u.ux, u.uy); obj && n < READ_MODEL_MAX_FLOOR; obj = obj->nexthere, n++) {
+        h = ios_fingerprint_object(h, obj);
+    }
+    if (h == floor_fingerprint) return;
+    floor_fingerprint = h;
+
+    m->floor_x = u.ux;
+    m->floor_y = u.uy;
+    memset(m->floor, 0, sizeof(m->floor));
+    m->floor_count = ios_get_objects_at(u.ux, u.uy, m->floor, READ_MODEL_MAX_FLOOR);
+}
+
+/*
+ * Publish staging with per-section version bumps (writer only)
+ */
+void ios_read_model_publish(void)
+{
+    if (!game_started || !program_state.in_moveloop || player_has_died
+        || program_state.gameover) {
+        return;
+    }
+
+    build_inventory(&staging);
+    build_status(&staging.status);
+    build_floor(&staging);
+
+    /* Section versions move only on real changes (writer owns published) */
+    bool inventory_changed = staging.inventory_count != published.inventory_count
+        || memcmp(staging.inventory, published.inventory, sizeof(staging.inventory)) != 0
+        || memcmp(staging.equipment, published.equipment, sizeof(staging.equipment)) != 0
+        || staging.equipment_cursed != published.equipment_cursed
+        || staging.equipment_blessed != published.equipment_blessed;
+    bool status_changed = memcmp(&staging.status, &published.status, sizeof(staging.status)) != 0;
+    bool floor_changed = staging.floor_count != published.floor_count
+        || staging.floor_x != published.floor_x || staging.floor_y != published.floor_y
+        || memcmp(staging.floor, published.floor, sizeof(staging.floor)) != 0;
+    if (!inventory_changed && !status_changed && !floor_changed) {
+        return;
+    }
+
+    extern struct instance_globals_saved_m svm;
+    staging.turn_number = (int32_t)svm.moves;
+    if (inventory_changed) staging.inventory_version++;
+    if (status_changed) staging.status_version++;
+    if (floor_changed) staging.floor_version++;
+
+    uint32_t seq = atomic_load_explicit(&model_seq, memory_order_relaxed);
+    atomic_store_explicit(&model_seq, seq + 1, memory_order_relaxed);  /* odd: writing */
+    atomic_thread_fence(memory_order_release);
+
+    published = staging;  /* memcpy */
+
+    atomic_store_explicit(&model_seq, seq + 2, memory_order_release);  /* even: stable */
+}
+
+void ios_read_model_reset(void)
+{
+    /* Versions keep counting so Swift never mistakes the new game for the old */
+    inventory_fingerprint = 0;
+    floor_fingerprint = 0;
+}
+
+static uint32_t read_model(GameReadModel *out)
+{
+    for (;;) {
+        uint32_t before = atomic_load_explicit(&model_seq, memory_order_acquire);
+        if (before & 1) {
+            continue;  /* Publish in progress - retry */
+        }
+
+        *out = published;  /* memcpy */
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&model_seq, memory_order_relaxed) == before) {
+            return before;
+        }
+    }
+}
+
+void ios_get_read_model(GameReadModel *out)
+{
+    if (!out) return;
+    read_model(out);
+}
+
+bool ios_get_read_model_if_newer(GameReadModel *out, uint32_t *last_version)
+{
+    if (!out || !last_version) return false;
+
+    uint32_t seq = atomic_load_explicit(&model_seq, memory_order_acquire);
+    if (seq / 2 == *last_version) {
+        return false;
+    }
+
+    *last_version = read_model(out) / 2;
+    return true;
+}
@@ -0,0 +1,119 @@
+/*
+ * ios_read_model.h - Versioned read model for UI panels (any thread)
+ *
+ * Extends the GameStateSnapshot push model (ios_game_state_buffer.h) with
+ * what panels otherwise query through NetHackSerialExecutor: inventory,
+ * equipment, character status and the objects under the player. The game
+ * thread publishes it at the same turn boundary as the snapshot, so Swift
+ * can read it while the game thread is busy (travel, multi-turn commands)
+ * instead of queueing behind it.
+ *
+ * PUBLICATION:
+ * - Writer: NetHack game thread, from update_game_state_snapshot()
+ * - Reader: any thread; seqlock copy, retried instead of returning torn data
+ * - Each section carries its own version, bumped only when that section
+ *   changed, so readers can skip re-parsing unchanged parts
+ * - Inventory names (doname) are only rebuilt when an inventory
+ *   fingerprint changes; a quiet turn costs one walk of gi.invent
+ */
+
+#ifndef IOS_READ_MODEL_H
+#define IOS_READ_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nethack_export.h"
+#include "ios_object_bridge.h"  /* IOSObjectInfo for floor items */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define READ_MODEL_MAX_INVENTORY 60  /* a-z, A-Z, '$', '#' overflow */
+#define READ_MODEL_MAX_FLOOR 20      /* Same cap as MAX_ITEMS_AT_POSITION */
+#define READ_MODEL_NAME_LEN 128
+#define READ_MODEL_SLOT_COUNT 14     /* IOS_SLOT_* order (ios_character_status.h) */
+
+/* One inventory entry (nethack_get_inventory_items fields, names inline) */
+typedef struct {
+    char name[READ_MODEL_NAME_LEN];  /* doname() */
+    char equipped_slot[16];          /* "wielded", "worn", ... or "" */
+    uint32_t o_id;
+    int32_t quantity;
+    int32_t weight;
+    int16_t otyp;
+    int16_t enchantment;             /* spe */
+    char invlet;
+    char oclass;
+    char buc_status;                 /* 'B', 'U', 'C', '?' */
+    bool buc_known;
+    bool is_equipped;
+    bool is_container;
+} ReadModelItem;
+
+/* Character status (ios_get_character_status_json fields) */
+typedef struct {
+    char role[32];
+    char race[32];
+    char gender[16];
+    char alignment[16];
+    char polymorph_form[32];         /* "" when not polymorphed */
+    int32_t level;
+    int64_t experience;
+    int32_t hunger;                  /* u.uhs */
+    int32_t encumbrance;             /* near_capacity() */
+    uint64_t conditions;             /* ios_get_condition_mask() */
+    int32_t polymorph_turns;
+    bool polymorphed;
+    bool weapon_welded;
+    bool left_ring_available;
+    bool right_ring_available;
+} ReadModelStatus;
+
+typedef struct {
+    /* Section versions (0 = never published) */
+    uint32_t inventory_version;      /* inventory + equipment */
+    uint32_t status_version;
+    uint32_t floor_version;
+    int32_t turn_number;
+
+    int32_t inventory_count;
+    ReadModelItem inventory[READ_MODEL_MAX_INVENTORY];
+    int8_t equipment[READ_MODEL_SLOT_COUNT];   /* Inventory index, -1 = empty */
+    uint16_t equipment_cursed;                 /* Bit per slot, BUC known only */
+    uint16_t equipment_blessed;
+
+    ReadModelStatus status;
+
+    int32_t floor_x, floor_y;                  /* Player position it describes */
+    int32_t floor_count;
+    IOSObjectInfo floor[READ_MODEL_MAX_FLOOR];
+} GameReadModel;
+
+/*
+ * Rebuild changed sections and publish (NetHack game thread, turn boundary)
+ */
+void ios_read_model_publish(void);
+
+/*
+ * Forget cached sections so the next publish rebuilds everything
+ * (new game / restore). Versions keep counting up.
+ */
+void ios_read_model_reset(void);
+
+/*
+ * Copy the published model (any thread, lock-free)
+ */
+NETHACK_EXPORT void ios_get_read_model(GameReadModel *out);
+
+/*
+ * Copy only if it changed since *last_version (0 = none); one atomic load
+ * when unchanged. Returns true when out was filled.
+ */
+NETHACK_EXPORT bool ios_get_read_model_if_newer(GameReadModel *out, uint32_t *last_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IOS_READ_MODEL_H */
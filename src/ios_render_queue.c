@@ -5,34 +5,63 @@
  * - Producer (game thread): memory_order_release on head update
  * - Consumer (main thread): memory_order_acquire on head read
  * - This ensures element writes happen-before consumer reads
+ *
+ * Cached indices: the producer only re-reads tail (acquire) when its cached
+ * copy says the lane is full; the consumer only re-reads head (acquire) when
+ * its cached copy says the lane is empty. Between refreshes neither side
+ * touches the other's cache line.
  */
 
 #include "ios_render_queue.h"
 #include "nethack_export.h"
+#include "ios_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Element must stay small - large payloads go through a side lane.
+ * LP64: 4-byte type, 4 bytes padding, 16-byte union (largest members are
+ * MapUpdate, MessageUpdate and RenderCommand, the last 8-byte aligned). */
+_Static_assert(sizeof(RenderQueueElement) == 24, "RenderQueueElement is no longer 24 bytes");
+
 /* Global queue instance (initialized in ios_init_nhwindows) */
 RenderQueue *g_render_queue = NULL;
 
 /* === Initialization === */
 
+static void lane_init(RenderLaneIndex *lane) {
+    atomic_init(&lane->head, 0);
+    atomic_init(&lane->tail, 0);
+    lane->cached_tail = 0;
+    lane->cached_head = 0;
+}
+
 void render_queue_init(RenderQueue *queue) {
     /* Guard: NULL pointer */
     if (!queue) {
         fprintf(stderr, "[QUEUE] ERROR: NULL queue pointer in init\n");
         return;
     }
-    
-    /* Initialize atomics to 0 */
-    atomic_init(&queue->head, 0);
-    atomic_init(&queue->tail, 0);
-    
-    /* Zero out elements array */
+
+    /* Initialize lane indices to 0 */
+    lane_init(&queue->queue);
+    lane_init(&queue->delta);
+    lane_init(&queue->status);
+    lane_init(&queue->text);
+
+    /* Zero out lane storage */
     memset(queue->elements, 0, sizeof(queue->elements));
-    
-    fprintf(stderr, "[QUEUE] Initialized (size=%d)\n", RENDER_QUEUE_SIZE);
+    memset(queue->deltas, 0, sizeof(queue->deltas));
+    memset(queue->statuses, 0, sizeof(queue->statuses));
+    memset(queue->text_arena, 0, sizeof(queue->text_arena));
+
+    /* ID 0 is the default category (also used when the table is full) */
+    memset(queue->category_names, 0, sizeof(queue->category_names));
+    strcpy(queue->category_names[0], "MSG");
+    queue->category_count = 1;
+
+    fprintf(stderr, "[QUEUE] Initialized (size=%d, element=%zu bytes)\n",
+            RENDER_QUEUE_SIZE, sizeof(RenderQueueElement));
 }
 
 void render_queue_destroy(RenderQueue *queue) {
@@ -40,21 +69,16 @@ void render_queue_destroy(RenderQueue *queue) {
     if (!queue) {
         return;
     }
-    
-    /* Drain queue and free any allocated message strings */
-    RenderQueueElement elem;
-    while (render_queue_dequeue(queue, &elem)) {
-        if (elem.type == UPDATE_MESSAGE) {
-            /* Free strdup'd strings */
-            if (elem.data.message.category) {
-                free(elem.data.message.category);
-            }
-            if (elem.data.message.text) {
-                free(elem.data.message.text);
-            }
-        }
+
+    /* Undelivered elements are dropped with the queue - rewind every lane.
+     * Side lanes own all payload storage, so nothing needs freeing. */
+    RenderLaneIndex *lanes[] = {&queue->queue, &queue->delta, &queue->status, &queue->text};
+    for (size_t i = 0; i < sizeof(lanes) / sizeof(lanes[0]); i++) {
+        uint32_t head = (uint32_t)atomic_load_explicit(&lanes[i]->head, memory_order_acquire);
+        atomic_store_explicit(&lanes[i]->tail, head, memory_order_release);
+        lanes[i]->cached_head = head;
     }
-    
+
     fprintf(stderr, "[QUEUE] Destroyed\n");
 }
 
@@ -63,79 +87,360 @@ void render_queue_destroy(RenderQueue *queue) {
 bool render_queue_enqueue(RenderQueue *queue, const RenderQueueElement *elem) {
     /* Guard: NULL pointers */
     if (!queue) {
-        fprintf(stderr, "[QUEUE] ERROR: NULL queue in enqueue\n");
+        IOS_LOG_E(IOS_LOG_CAT_QUEUE, "NULL queue in enqueue");
         return false;
     }
     if (!elem) {
-        fprintf(stderr, "[QUEUE] ERROR: NULL element in enqueue\n");
+        IOS_LOG_E(IOS_LOG_CAT_QUEUE, "NULL element in enqueue");
         return false;
     }
-    
+
+    RenderLaneIndex *lane = &queue->queue;
+
     /* Load current head (relaxed - we own this) */
-    uint32_t current_head = atomic_load_explicit(&queue->head, memory_order_relaxed);
-    
+    uint32_t current_head = (uint32_t)atomic_load_explicit(&lane->head, memory_order_relaxed);
+
     /* Calculate next head position with wraparound */
     uint32_t next_head = (current_head + 1) & QUEUE_MASK;
-    
-    /* Load current tail (acquire - see consumer's writes) */
-    uint32_t current_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
-    
+
+    /* Full by our cached tail? Refresh it (acquire - see consumer's writes) */
+    if (next_head == lane->cached_tail) {
+        lane->cached_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_acquire);
+    }
+
     /* Guard: Queue full? */
-    if (next_head == current_tail) {
+    if (next_head == lane->cached_tail) {
         static uint32_t drop_count = 0;
         drop_count++;
         if (drop_count % 100 == 1) {
-            fprintf(stderr, "[QUEUE] WARNING: Queue full! Dropped %u updates\n", drop_count);
+            IOS_LOG_W(IOS_LOG_CAT_QUEUE, "Queue full! Dropped %u updates", drop_count);
         }
         return false;
     }
-    
+
     /* Write element to queue */
     queue->elements[current_head] = *elem;
-    
+
     /* Commit head update (release - make element visible to consumer) */
-    atomic_store_explicit(&queue->head, next_head, memory_order_release);
-    
+    atomic_store_explicit(&lane->head, next_head, memory_order_release);
+
+    return true;
+}
+
+bool render_queue_enqueue_glyph_batch(RenderQueue *queue, const MapUpdate *deltas,
+                                      uint32_t count, uint32_t generation) {
+    /* Guard: NULL pointers */
+    if (!queue || !deltas) {
+        return false;
+    }
+    /* Guard: Nothing to publish / oversized batch */
+    if (count == 0 || count > RENDER_GLYPH_BATCH_MAX) {
+        return false;
+    }
+
+    /* Delta lane: we own head, consumer releases tail */
+    RenderLaneIndex *lane = &queue->delta;
+    uint32_t first = (uint32_t)atomic_load_explicit(&lane->head, memory_order_relaxed);
+
+    /* Short on space by our cached tail? Refresh it */
+    if (RENDER_DELTA_RING_SIZE - (first - lane->cached_tail) < count) {
+        lane->cached_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_acquire);
+    }
+
+    /* Guard: Not enough free delta slots - caller keeps cells dirty and retries */
+    if (RENDER_DELTA_RING_SIZE - (first - lane->cached_tail) < count) {
+        return false;
+    }
+
+    /* Copy deltas in at most two spans (wraparound) */
+    uint32_t start = first & RENDER_DELTA_MASK;
+    uint32_t span = RENDER_DELTA_RING_SIZE - start;
+    if (span > count) span = count;
+    memcpy(&queue->deltas[start], deltas, span * sizeof(MapUpdate));
+    if (span < count) {
+        memcpy(&queue->deltas[0], deltas + span, (count - span) * sizeof(MapUpdate));
+    }
+
+    RenderQueueElement elem = {
+        .type = UPDATE_GLYPH_BATCH,
+        .data.glyph_batch = {.first = first, .count = count, .generation = generation}};
+
+    /* Element enqueue publishes the delta writes (release on queue head) */
+    if (!render_queue_enqueue(queue, &elem)) {
+        return false;
+    }
+
+    atomic_store_explicit(&lane->head, first + count, memory_order_relaxed);
+    return true;
+}
+
+bool render_queue_enqueue_status(RenderQueue *queue, const StatusUpdate *status) {
+    /* Guard: NULL pointers */
+    if (!queue || !status) {
+        return false;
+    }
+
+    /* Status lane: we own head, consumer releases tail */
+    RenderLaneIndex *lane = &queue->status;
+    uint32_t slot = (uint32_t)atomic_load_explicit(&lane->head, memory_order_relaxed);
+
+    /* Full by our cached tail? Refresh it */
+    if (slot - lane->cached_tail >= RENDER_STATUS_RING_SIZE) {
+        lane->cached_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_acquire);
+    }
+
+    /* Guard: Status lane full */
+    if (slot - lane->cached_tail >= RENDER_STATUS_RING_SIZE) {
+        return false;
+    }
+
+    queue->statuses[slot & RENDER_STATUS_MASK] = *status;
+
+    RenderQueueElement elem = {.type = UPDATE_STATUS, .data.status = {.slot = slot}};
+
+    /* Element enqueue publishes the status write (release on queue head) */
+    if (!render_queue_enqueue(queue, &elem)) {
+        return false;
+    }
+
+    atomic_store_explicit(&lane->head, slot + 1, memory_order_relaxed);
+    return true;
+}
+
+/* Intern a category name (producer only). Returns ID 0 ("MSG") when the
+ * name is NULL/empty or the table is full. */
+static uint32_t intern_category(RenderQueue *queue, const char *category) {
+    if (!category || !*category) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < queue->category_count; i++) {
+        if (strncmp(queue->category_names[i], category, RENDER_MESSAGE_CATEGORY_LEN - 1) == 0) {
+            return i;
+        }
+    }
+
+    if (queue->category_count >= RENDER_MESSAGE_CATEGORY_MAX) {
+        return 0;
+    }
+
+    /* Published to the consumer by the release on the element enqueue */
+    uint32_t id = queue->category_count++;
+    strncpy(queue->category_names[id], category, RENDER_MESSAGE_CATEGORY_LEN - 1);
+    queue->category_names[id][RENDER_MESSAGE_CATEGORY_LEN - 1] = '\0';
+    return id;
+}
+
+bool render_queue_enqueue_message(RenderQueue *queue, const char *text,
+                                  const char *category, int attr) {
+    /* Guard: NULL pointers */
+    if (!queue || !text) {
+        return false;
+    }
+
+    uint32_t length = (uint32_t)strnlen(text, RENDER_MESSAGE_TEXT_MAX);
+    uint32_t needed = length + 1;  /* Keep the NUL so readers get a C string */
+
+    /* Text arena: we own head, consumer releases tail */
+    RenderLaneIndex *lane = &queue->text;
+    uint32_t head = (uint32_t)atomic_load_explicit(&lane->head, memory_order_relaxed);
+
+    /* Never split text across the ring end - skip the remainder instead */
+    uint32_t offset = head;
+    uint32_t to_end = RENDER_TEXT_ARENA_SIZE - (head & RENDER_TEXT_MASK);
+    if (to_end < needed) {
+        offset += to_end;
+    }
+
+    /* Short on space by our cached tail? Refresh it */
+    if (offset + needed - lane->cached_tail > RENDER_TEXT_ARENA_SIZE) {
+        lane->cached_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_acquire);
+    }
+
+    /* Guard: Arena full - drop (history in ios_msg_history still has it) */
+    if (offset + needed - lane->cached_tail > RENDER_TEXT_ARENA_SIZE) {
+        return false;
+    }
+
+    char *dst = &queue->text_arena[offset & RENDER_TEXT_MASK];
+    memcpy(dst, text, length);
+    dst[length] = '\0';
+
+    RenderQueueElement elem = {
+        .type = UPDATE_MESSAGE,
+        .data.message = {.offset = offset,
+                         .length = length,
+                         .category = intern_category(queue, category),
+                         .attr = attr}};
+
+    /* Element enqueue publishes the text write (release on queue head) */
+    if (!render_queue_enqueue(queue, &elem)) {
+        return false;
+    }
+
+    atomic_store_explicit(&lane->head, offset + needed, memory_order_relaxed);
     return true;
 }
 
 /* === Consumer Operations (Main Thread) === */
 
+/* Elements readable from tail, refreshing cached head only when it reads empty */
+static inline uint32_t queue_available(RenderLaneIndex *lane, uint32_t current_tail) {
+    if (lane->cached_head == current_tail) {
+        /* Acquire - see producer's element writes */
+        lane->cached_head = (uint32_t)atomic_load_explicit(&lane->head, memory_order_acquire);
+    }
+    return (lane->cached_head - current_tail) & QUEUE_MASK;
+}
+
 __attribute__((visibility("default")))
 bool render_queue_dequeue(RenderQueue *queue, RenderQueueElement *elem) {
     /* Guard: NULL pointers */
     if (!queue) {
-        fprintf(stderr, "[QUEUE] ERROR: NULL queue in dequeue\n");
+        IOS_LOG_E(IOS_LOG_CAT_QUEUE, "NULL queue in dequeue");
         return false;
     }
     if (!elem) {
-        fprintf(stderr, "[QUEUE] ERROR: NULL element output in dequeue\n");
+        IOS_LOG_E(IOS_LOG_CAT_QUEUE, "NULL element output in dequeue");
         return false;
     }
-    
+
+    RenderLaneIndex *lane = &queue->queue;
+
     /* Load current tail (relaxed - we own this) */
-    uint32_t current_tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
-    
-    /* Load current head (acquire - see producer's writes) */
-    uint32_t current_head = atomic_load_explicit(&queue->head, memory_order_acquire);
-    
+    uint32_t current_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_relaxed);
+
     /* Guard: Queue empty? */
-    if (current_tail == current_head) {
+    if (queue_available(lane, current_tail) == 0) {
         return false;  /* No data available */
     }
-    
+
     /* Read element from queue */
     *elem = queue->elements[current_tail];
-    
+
     /* Calculate next tail position with wraparound */
     uint32_t next_tail = (current_tail + 1) & QUEUE_MASK;
-    
+
     /* Commit tail update (release - make slot available to producer) */
-    atomic_store_explicit(&queue->tail, next_tail, memory_order_release);
-    
+    atomic_store_explicit(&lane->tail, next_tail, memory_order_release);
+
+    return true;
+}
+
+NETHACK_EXPORT uint32_t render_queue_dequeue_bulk(RenderQueue *queue,
+                                                  RenderQueueElement *out, uint32_t max) {
+    /* Guard: NULL pointers */
+    if (!queue || !out || max == 0) {
+        return 0;
+    }
+
+    RenderLaneIndex *lane = &queue->queue;
+
+    /* Load current tail (relaxed - we own this) */
+    uint32_t current_tail = (uint32_t)atomic_load_explicit(&lane->tail, memory_order_relaxed);
+
+    /* Elements available, clamped to caller's buffer */
+    uint32_t count = queue_available(lane, current_tail);
+    if (count > max) count = max;
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Copy in at most two spans (ring wraparound) */
+    uint32_t span = RENDER_QUEUE_SIZE - current_tail;
+    if (span > count) span = count;
+    memcpy(out, &queue->elements[current_tail], span * sizeof(RenderQueueElement));
+    if (span < count) {
+        memcpy(out + span, &queue->elements[0], (count - span) * sizeof(RenderQueueElement));
+    }
+
+    /* Commit tail update (release - make slots available to producer) */
+    atomic_store_explicit(&lane->tail, (current_tail + count) & QUEUE_MASK,
+                          memory_order_release);
+
+    return count;
+}
+
+NETHACK_EXPORT uint32_t render_queue_read_glyph_batch(RenderQueue *queue,
+                                                      const GlyphBatchUpdate *batch,
+                                                      MapUpdate *out, uint32_t max) {
+    /* Guard: NULL pointers */
+    if (!queue || !batch || !out) {
+        return 0;
+    }
+
+    /* Too small for the whole batch: copy and release nothing, so the
+     * deltas stay for a retry with a big enough buffer */
+    if (max < batch->count) {
+        IOS_LOG_E(IOS_LOG_CAT_QUEUE, "Glyph batch of %u deltas needs a bigger buffer than %u",
+                  batch->count, max);
+        return 0;
+    }
+
+    /* Deltas were made visible by the acquire in render_queue_dequeue() */
+    uint32_t count = batch->count;
+    uint32_t start = batch->first & RENDER_DELTA_MASK;
+    uint32_t span = RENDER_DELTA_RING_SIZE - start;
+    if (span > count) span = count;
+    memcpy(out, &queue->deltas[start], span * sizeof(MapUpdate));
+    if (span < count) {
+        memcpy(out + span, &queue->deltas[0], (count - span) * sizeof(MapUpdate));
+    }
+
+    /* Release the whole batch (release - make slots available to producer) */
+    atomic_store_explicit(&queue->delta.tail, batch->first + batch->count,
+                          memory_order_release);
+
+    return count;
+}
+
+NETHACK_EXPORT bool render_queue_read_status(RenderQueue *queue, const StatusRef *ref,
+                                             StatusUpdate *out) {
+    /* Guard: NULL pointers */
+    if (!queue || !ref || !out) {
+        return false;
+    }
+
+    /* Status was made visible by the acquire in render_queue_dequeue() */
+    *out = queue->statuses[ref->slot & RENDER_STATUS_MASK];
+
+    /* Release the slot (release - make it available to producer) */
+    atomic_store_explicit(&queue->status.tail, ref->slot + 1, memory_order_release);
+
     return true;
 }
 
+NETHACK_EXPORT uint32_t render_queue_read_message(RenderQueue *queue, const MessageUpdate *msg,
+                                                  char *out, uint32_t max) {
+    /* Guard: NULL pointers */
+    if (!queue || !msg || !out || max == 0) {
+        return 0;
+    }
+
+    /* Text was made visible by the acquire in render_queue_dequeue() */
+    uint32_t count = msg->length < max - 1 ? msg->length : max - 1;
+    memcpy(out, &queue->text_arena[msg->offset & RENDER_TEXT_MASK], count);
+    out[count] = '\0';
+
+    /* Release text + NUL (release - make bytes available to producer) */
+    atomic_store_explicit(&queue->text.tail, msg->offset + msg->length + 1,
+                          memory_order_release);
+
+    return count;
+}
+
+NETHACK_EXPORT const char *render_queue_category_name(const RenderQueue *queue,
+                                                      uint32_t category) {
+    /* Guard: NULL pointer / out of range */
+    if (!queue || category >= RENDER_MESSAGE_CATEGORY_MAX) {
+        return "MSG";
+    }
+
+    /* Name was made visible by the acquire that delivered the element */
+    const char *name = queue->category_names[category];
+    return name[0] ? name : "MSG";
+}
+
 /* === Utility Functions === */
 
 bool render_queue_is_empty(const RenderQueue *queue) {
@@ -143,10 +448,10 @@ bool render_queue_is_empty(const RenderQueue *queue) {
     if (!queue) {
         return true;
     }
-    
-    uint32_t current_tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
-    uint32_t current_head = atomic_load_explicit(&queue->head, memory_order_acquire);
-    
+
+    uint32_t current_tail = (uint32_t)atomic_load_explicit(&queue->queue.tail, memory_order_relaxed);
+    uint32_t current_head = (uint32_t)atomic_load_explicit(&queue->queue.head, memory_order_acquire);
+
     return current_tail == current_head;
 }
 
@@ -156,15 +461,11 @@ uint32_t render_queue_count(const RenderQueue *queue) {
         return 0;
     }
 
-    uint32_t current_tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
-    uint32_t current_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    uint32_t current_tail = (uint32_t)atomic_load_explicit(&queue->queue.tail, memory_order_relaxed);
+    uint32_t current_head = (uint32_t)atomic_load_explicit(&queue->queue.head, memory_order_acquire);
 
     /* Calculate count with wraparound */
-    if (current_head >= current_tail) {
-        return current_head - current_tail;
-    } else {
-        return (RENDER_QUEUE_SIZE - current_tail) + current_head;
-    }
+    return (current_head - current_tail) & QUEUE_MASK;
 }
 
 /* Helper for Swift interop - access global queue pointer */
@@ -6,7 +6,21 @@
  *
  * Design: Based on WINDOWS_C_ARCHITECTURE_DESIGN.md Phase 1
  * Thread Safety: Lock-free atomics (C11) - game thread produces, main thread consumes
- * Performance: Zero-copy for glyphs, strdup for messages
+ * Performance: Zero-copy for glyphs, queue-owned text arena for messages
+ *
+ * Glyph updates are coalesced per turn by ios_winprocs.c (dirty bitmap over
+ * map_cells) and published as one UPDATE_GLYPH_BATCH element whose deltas
+ * live in a separate SPSC lane, so a full docrt() costs one queue slot.
+ *
+ * Layout: each lane's producer index and consumer index sit on their own
+ * cache line, next to a cached copy of the other side's index, so the hot
+ * path touches no shared line unless the lane looks full/empty. Large
+ * payloads (StatusUpdate) travel in their own lane and the element carries
+ * a slot reference, keeping RenderQueueElement at 24 bytes.
+ *
+ * Message text is copied into a byte ring owned by the queue and referenced
+ * by offset/length; categories are interned to small IDs. Neither thread
+ * touches the heap per message.
  */
 
 #ifndef IOS_RENDER_QUEUE_H
@@ -26,6 +40,28 @@ typedef short coordxy;
 /* Queue size - MUST be power of 2 for efficient masking */
 #define RENDER_QUEUE_SIZE 4096
 
+/* Glyph delta lane size - MUST be power of 2, holds several full-map batches */
+#define RENDER_DELTA_RING_SIZE 8192
+
+/* Status lane size - MUST be power of 2 (one entry per changing BL_FLUSH) */
+#define RENDER_STATUS_RING_SIZE 64
+
+/* Message text arena size in bytes - MUST be power of 2 */
+#define RENDER_TEXT_ARENA_SIZE 65536
+
+/* Longest message text kept (longer text is truncated, NUL not counted) */
+#define RENDER_MESSAGE_TEXT_MAX 1023
+
+/* Interned message categories ("MSG", "COMBAT", ...) */
+#define RENDER_MESSAGE_CATEGORY_MAX 32
+#define RENDER_MESSAGE_CATEGORY_LEN 16
+
+/* Destructive interference size: 128 on Apple Silicon, 64 on x86_64 */
+#define RENDER_QUEUE_CACHE_LINE 128
+
+/* Max deltas in one batch: each map cell at most once (COLNO * ROWNO = 80 * 21) */
+#define RENDER_GLYPH_BATCH_MAX 1680
+
 /* === Render Command Types === */
 
 typedef enum {
@@ -34,7 +70,8 @@ typedef enum {
     UPDATE_STATUS,     /* Status bar */
     CMD_FLUSH_MAP,     /* Display map now */
     CMD_CLEAR_MAP,     /* Clear map buffer */
-    CMD_TURN_COMPLETE  /* Turn finished */
+    CMD_TURN_COMPLETE, /* Turn finished */
+    UPDATE_GLYPH_BATCH /* Coalesced map deltas (see GlyphBatchUpdate) */
 } RenderUpdateType;
 
 /* === Command Structures === */
@@ -48,14 +85,52 @@ typedef struct {
     unsigned int glyphflags;  /* MG_PET, MG_RIDDEN, MG_DETECT etc. from display.h */
 } MapUpdate;
 
-/* Message update (requires strdup/free) */
+/* Coalesced glyph batch - deltas live in the queue's delta lane.
+ * first/count index RenderQueue.deltas (masked by RENDER_DELTA_MASK).
+ * Consumer MUST read it with render_queue_read_glyph_batch() to release slots.
+ */
+typedef struct {
+    uint32_t first;       /* Unmasked index of first delta */
+    uint32_t count;       /* Number of deltas (<= RENDER_GLYPH_BATCH_MAX) */
+    uint32_t generation;  /* Map generation this batch completes */
+} GlyphBatchUpdate;
+
+/* Message update - text lives in RenderQueue.text (NUL-terminated, never
+ * split across the ring end). Consumer MUST read it with
+ * render_queue_read_message() to release the bytes.
+ */
 typedef struct {
-    char *category;    /* MUST BE FREED BY CONSUMER */
-    char *text;        /* MUST BE FREED BY CONSUMER */
-    int attr;
+    uint32_t offset;      /* Unmasked byte offset of text */
+    uint32_t length;      /* Text length excluding NUL */
+    uint32_t category;    /* Interned ID - see render_queue_category_name() */
+    int attr;             /* ATR_* flags */
 } MessageUpdate;
 
-/* Status update (value copy - no pointers) */
+/* StatusUpdate.changed bits - the fields botl changed since the last push */
+#define STATUS_FIELD_HP         (1u << 0)
+#define STATUS_FIELD_HPMAX      (1u << 1)
+#define STATUS_FIELD_PW         (1u << 2)
+#define STATUS_FIELD_PWMAX      (1u << 3)
+#define STATUS_FIELD_LEVEL      (1u << 4)
+#define STATUS_FIELD_EXP        (1u << 5)
+#define STATUS_FIELD_AC         (1u << 6)
+#define STATUS_FIELD_STR        (1u << 7)
+#define STATUS_FIELD_DEX        (1u << 8)
+#define STATUS_FIELD_CON        (1u << 9)
+#define STATUS_FIELD_INT        (1u << 10)
+#define STATUS_FIELD_WIS        (1u << 11)
+#define STATUS_FIELD_CHA        (1u << 12)
+#define STATUS_FIELD_GOLD       (1u << 13)
+#define STATUS_FIELD_MOVES      (1u << 14)
+#define STATUS_FIELD_ALIGN      (1u << 15)
+#define STATUS_FIELD_HUNGER     (1u << 16)
+#define STATUS_FIELD_CONDITIONS (1u << 17)
+#define STATUS_FIELD_ALL        ((1u << 18) - 1)
+
+/* Status update (value copy - no pointers, carried in the status lane).
+ * One per BL_FLUSH that changed something; every field holds its current
+ * value, changed says which ones moved.
+ */
 typedef struct {
     int hp, hpmax;
     int pw, pwmax;
@@ -68,8 +143,16 @@ typedef struct {
     char align[16];
     int hunger;
     unsigned long conditions; /* BL_CONDITION bitmask (30 flags) */
+    uint32_t changed;         /* STATUS_FIELD_* */
 } StatusUpdate;
 
+/* Status reference - payload lives in RenderQueue.statuses.
+ * Consumer MUST read it with render_queue_read_status() to release the slot.
+ */
+typedef struct {
+    uint32_t slot;        /* Unmasked index into the status lane */
+} StatusRef;
+
 /* Command (no data - just signal) */
 typedef struct {
     int blocking;
@@ -83,20 +166,49 @@ typedef struct {
     union {
         MapUpdate map;
         MessageUpdate message;
-        StatusUpdate status;
+        StatusRef status;
         RenderCommand command;
+        GlyphBatchUpdate glyph_batch;
     } data;
 } RenderQueueElement;
 
 /* === SPSC Queue Structure === */
 
+/* One lane's indices. Producer-owned and consumer-owned fields live on
+ * separate cache lines; each side re-reads the other's atomic only when
+ * its cached copy says the lane is full (producer) or empty (consumer).
+ */
 typedef struct {
-    /* Atomics for lock-free operation */
-    atomic_uint_fast32_t head;  /* Producer writes here */
-    atomic_uint_fast32_t tail;  /* Consumer reads here */
-    
-    /* Queue storage */
+    /* Producer line */
+    _Alignas(RENDER_QUEUE_CACHE_LINE) atomic_uint_fast32_t head;  /* Producer writes here */
+    uint32_t cached_tail;                                          /* Producer-private */
+
+    /* Consumer line */
+    _Alignas(RENDER_QUEUE_CACHE_LINE) atomic_uint_fast32_t tail;  /* Consumer reads here */
+    uint32_t cached_head;                                          /* Consumer-private */
+} RenderLaneIndex;
+
+typedef struct {
+    /* Element ring (indices stored masked) */
+    RenderLaneIndex queue;
     RenderQueueElement elements[RENDER_QUEUE_SIZE];
+
+    /* Glyph delta lane (referenced by UPDATE_GLYPH_BATCH, indices unmasked) */
+    RenderLaneIndex delta;
+    MapUpdate deltas[RENDER_DELTA_RING_SIZE];
+
+    /* Status lane (referenced by UPDATE_STATUS, indices unmasked) */
+    RenderLaneIndex status;
+    StatusUpdate statuses[RENDER_STATUS_RING_SIZE];
+
+    /* Message text arena (referenced by UPDATE_MESSAGE, byte offsets unmasked) */
+    RenderLaneIndex text;
+    char text_arena[RENDER_TEXT_ARENA_SIZE];
+
+    /* Interned categories - append-only, written by producer before the
+     * first element that uses the ID is published */
+    uint32_t category_count;
+    char category_names[RENDER_MESSAGE_CATEGORY_MAX][RENDER_MESSAGE_CATEGORY_LEN];
 } RenderQueue;
 
 /* === Queue Operations === */
@@ -115,6 +227,63 @@ bool render_queue_enqueue(RenderQueue *queue, const RenderQueueElement *elem);
 /* Returns: true if dequeued, false if queue empty */
 bool render_queue_dequeue(RenderQueue *queue, RenderQueueElement *elem);
 
+/* Enqueue a coalesced glyph batch (Producer - Game Thread)
+ * Copies deltas into the delta lane and pushes one UPDATE_GLYPH_BATCH element.
+ * Returns: true if enqueued, false if either lane is full (nothing committed)
+ */
+bool render_queue_enqueue_glyph_batch(RenderQueue *queue, const MapUpdate *deltas,
+                                      uint32_t count, uint32_t generation);
+
+/* Enqueue a status snapshot (Producer - Game Thread)
+ * Copies status into the status lane and pushes one UPDATE_STATUS element.
+ * Returns: true if enqueued, false if either lane is full (nothing committed)
+ */
+bool render_queue_enqueue_status(RenderQueue *queue, const StatusUpdate *status);
+
+/* Enqueue a message (Producer - Game Thread)
+ * Copies text into the text arena and interns category (NULL = "MSG").
+ * Returns: true if enqueued, false if the arena or queue is full (dropped)
+ */
+bool render_queue_enqueue_message(RenderQueue *queue, const char *text,
+                                  const char *category, int attr);
+
+/* Dequeue up to max elements in one call (Consumer - Main Thread)
+ * Copies the contiguous ring span in at most two memcpys (wraparound).
+ * Returns: number of elements copied to out (0 if queue empty)
+ */
+NETHACK_EXPORT uint32_t render_queue_dequeue_bulk(RenderQueue *queue,
+                                                  RenderQueueElement *out, uint32_t max);
+
+/* Read a glyph batch's deltas and release their slots (Consumer - Main Thread)
+ * Batches MUST be read in queue order, each whole: max must be at least
+ * batch->count (RENDER_GLYPH_BATCH_MAX always is). A smaller buffer copies
+ * and releases nothing, and the batch stays until it is read.
+ * Returns: number of deltas copied to out (batch->count, or 0)
+ */
+NETHACK_EXPORT uint32_t render_queue_read_glyph_batch(RenderQueue *queue,
+                                                      const GlyphBatchUpdate *batch,
+                                                      MapUpdate *out, uint32_t max);
+
+/* Read a status snapshot and release its slot (Consumer - Main Thread)
+ * Statuses MUST be read in queue order.
+ * Returns: true if out was filled
+ */
+NETHACK_EXPORT bool render_queue_read_status(RenderQueue *queue, const StatusRef *ref,
+                                             StatusUpdate *out);
+
+/* Read a message's text and release its bytes (Consumer - Main Thread)
+ * Messages MUST be read in queue order. Copies at most max-1 bytes + NUL.
+ * Returns: number of bytes copied to out, excluding NUL
+ */
+NETHACK_EXPORT uint32_t render_queue_read_message(RenderQueue *queue, const MessageUpdate *msg,
+                                                  char *out, uint32_t max);
+
+/* Category name for an interned ID (stable for the life of the queue)
+ * Returns: name, or "MSG" for an unknown ID
+ */
+NETHACK_EXPORT const char *render_queue_category_name(const RenderQueue *queue,
+                                                      uint32_t category);
+
 /* Check if queue is empty */
 bool render_queue_is_empty(const RenderQueue *queue);
 
@@ -133,5 +302,8 @@ NETHACK_EXPORT RenderQueue *ios_get_render_queue(void);
 
 /* Mask for power-of-2 wraparound */
 #define QUEUE_MASK (RENDER_QUEUE_SIZE - 1)
+#define RENDER_DELTA_MASK (RENDER_DELTA_RING_SIZE - 1)
+#define RENDER_STATUS_MASK (RENDER_STATUS_RING_SIZE - 1)
+#define RENDER_TEXT_MASK (RENDER_TEXT_ARENA_SIZE - 1)
 
 #endif /* IOS_RENDER_QUEUE_H */
@@ -0,0 +1,257 @@
+/*
+ * ios_save_bench.c - Save/restore timings on synthetic fixture games
+ *
+ * ios_save_bench_run() grows the running wizard-mode game into a fixture
+ * and times every save path on it:
+ *
+ *   early     - dungeon level 1 plus ios_spawn_test_scenario()
+ *   mid       - main dungeon levels 1-12, 40 random objects each
+ *   gehennom  - every main dungeon level and Gehennom above the
+ *               Sanctum, 40 objects each (~50 cached levels)
+ *
+ * Fixtures only add levels, so early -> mid -> gehennom in one game gives
+ * increasing sizes. Levels are reached with goto_level(), the way wizard
+ * mode level teleport does, so each one leaves a level file behind.
+ *
+ * Each op runs N times and prints one JSON object per line:
+ *   save_complete     ios_save_complete + ios_save_wait_for_writer
+ *   save_to_slot      ios_save_to_slot (bench character "SaveBench")
+ *   nh_save_state     heap image to <Documents>/bench_heap.dat
+ *   restore_complete  ios_restore_complete of the save just written,
+ *                     last because it replaces the game state (with
+ *                     the same game, which is why it can repeat)
+ *
+ * bytes_written and fsyncs are per-iteration deltas of nh_io_stats.h plus
+ * the savegame size for ops that write one (bwrite is not counted there).
+ * Driven from the host by bench/save_bench.c; only build_nethack_macos.sh
+ * compiles it, so device and simulator builds never ship the fixtures.
+ */
+
+#include "nethack_export.h"
+#include "hack.h"
+#include "ios_level_store.h"
+#include "ios_slot_manager.h"
+#include "../zone_allocator/nh_io_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define SAVE_BENCH_MAX_ITERATIONS 64
+#define SAVE_BENCH_CHARACTER "SaveBench"
+
+extern int game_started;
+extern int ios_save_complete(const char *save_dir);
+extern int ios_restore_complete(const char *save_dir);
+extern int ios_save_wait_for_writer(void);
+extern int nh_save_state(const char *filename);
+extern void ios_spawn_test_scenario(void);
+extern const char *get_ios_documents_path(void);
+extern void ios_get_save_dir(char *buf, size_t buflen);
+
+typedef struct {
+    const char *name;
+    int dungeon_levels;             /* Main dungeon levels (0 = all) */
+    int gehennom;                   /* Also Gehennom above the Sanctum */
+    int objects_per_level;
+} BenchFixture;
+
+static const BenchFixture fixtures[] = {
+    { "early", 1, 0, 0 },
+    { "mid", 12, 0, 40 },
+    { "gehennom", 0, 1, 40 },
+};
+
+typedef enum {
+    OP_SAVE_COMPLETE,
+    OP_SAVE_TO_SLOT,
+    OP_NH_SAVE_STATE,
+    OP_RESTORE_COMPLETE,
+    OP_COUNT
+} BenchOp;
+
+static const char *const op_names[OP_COUNT] = {
+    "save_complete", "save_to_slot", "nh_save_state", "restore_complete",
+};
+
+/* Ledgers that already got their objects (fixtures build on each other) */
+static boolean populated[IOS_LEVEL_STORE_LEDGERS];
+static int bench_slot = -1;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void scatter_objects(int count) {
+    for (int placed = 0, tries = 0; placed < count && tries < count * 20; tries++) {
+        coordxy x = (coordxy)rn1(COLNO - 3, 2), y = (coordxy)rn2(ROWNO);
+        if (!isok(x, y) || !ACCESSIBLE(levl[x][y].typ)) continue;
+        if (mkobj_at(RANDOM_CLASS, x, y, TRUE)) placed++;
+    }
+}
+
+static void visit_level(xint16 dnum, xint16 dlevel, int objects) {
+    d_level lev;
+    lev.dnum = dnum;
+    lev.dlevel = dlevel;
+    if (!on_level(&lev, &u.uz)) {
+        goto_level(&lev, FALSE, FALSE, FALSE);
+    }
+    xint16 ledger = ledger_no(&u.uz);
+    if (ledger > 0 && ledger < IOS_LEVEL_STORE_LEDGERS && !populated[ledger]) {
+        populated[ledger] = TRUE;
+        scatter_objects(objects);
+    }
+}
+
+static void build_fixture(const BenchFixture *f) {
+    d_level main_dungeon = { 0, 1 };
+    int levels = dunlevs_in_dungeon(&main_dungeon);
+    if (f->dungeon_levels > 0 && f->dungeon_levels < levels) levels = f->dungeon_levels;
+    for (int i = 1; i <= levels; i++) {
+        visit_level(0, (xint16)i, f->objects_per_level);
+    }
+
+    if (f->gehennom) {
+        d_level hell;
+        hell.dnum = dname_to_dnum("Gehennom");
+        hell.dlevel = 1;
+        int hell_levels = dunlevs_in_dungeon(&hell);
+        for (int i = 1; i < hell_levels; i++) {  /* The Sanctum needs the invocation */
+            visit_level(hell.dnum, (xint16)i, f->objects_per_level);
+        }
+    }
+
+    // Back to the top so the current level is an ordinary one
+    visit_level(0, 1, 0);
+    if (f->objects_per_level == 0) {
+        ios_spawn_test_scenario();
+    }
+}
+
+static int cached_levels(void) {
+    int count = 1;  /* Current level */
+    for (xint16 l = 1; l <= maxledgerno(); l++) {
+        if (l != ledger_no(&u.uz) && (svl.level_info[l].flags & LFILE_EXISTS)) count++;
+    }
+    return count;
+}
+
+/* One timed run of op; 0 on success */
+static int run_op(BenchOp op, const char *save_dir, const char *heap_path,
+                  uint64_t *wall, uint64_t *serialize) {
+    uint64_t start = now_ns();
+    int ok = 0;
+    switch (op) {
+    case OP_SAVE_COMPLETE:
+        ok = ios_save_complete(save_dir) == 0;
+        *serialize = now_ns() - start;
+        ok = ios_save_wait_for_writer() == 0 && ok;
+        break;
+    case OP_SAVE_TO_SLOT:
+        ok = ios_save_to_slot(SAVE_BENCH_CHARACTER, bench_slot) == 1;
+        break;
+    case OP_NH_SAVE_STATE:
+        ok = nh_save_state(heap_path) == 0;
+        break;
+    case OP_RESTORE_COMPLETE:
+        ok = ios_restore_complete(save_dir) == 0;
+        break;
+    default:
+        break;
+    }
+    *wall = now_ns() - start;
+    if (op != OP_SAVE_COMPLETE) *serialize = *wall;
+    return ok ? 0 : -1;
+}
+
+NETHACK_EXPORT int ios_save_bench_run(const char *fixture, int iterations, const char *out_path) {
+    const BenchFixture *f = NULL;
+    for (size_t i = 0; i < SIZE(fixtures); i++) {
+        if (fixture && strcmp(fixtures[i].name, fixture) == 0) f = &fixtures[i];
+    }
+    if (!f || !game_started || !wizard) {
+        fprintf(stderr, "[SAVE_BENCH] ERROR: need a started wizard-mode game and a fixture "
+                        "(early, mid, gehennom), got '%s'\n", fixture ? fixture : "(null)");
+        return -1;
+    }
+    if (iterations < 1) iterations = 1;
+    if (iterations > SAVE_BENCH_MAX_ITERATIONS) iterations = SAVE_BENCH_MAX_ITERATIONS;
+
+    FILE *out = out_path ? fopen(out_path, "a") : stdout;
+    if (!out) {
+        fprintf(stderr, "[SAVE_BENCH] ERROR: cannot open %s\n", out_path);
+        return -1;
+    }
+
+    uint64_t build_start = now_ns();
+    build_fixture(f);
+    uint64_t build_ns = now_ns() - build_start;
+    int levels = cached_levels();
+    fprintf(stderr, "[SAVE_BENCH] Fixture %s: %d levels (built in %.1f ms)\n",
+            f->name, levels, build_ns / 1e6);
+
+    char save_dir[512], game_path[600], heap_path[600];
+    ios_get_save_dir(save_dir, sizeof(save_dir));
+    snprintf(game_path, sizeof(game_path), "%s/savegame", save_dir);
+    snprintf(heap_path, sizeof(heap_path), "%s/bench_heap.dat", get_ios_documents_path());
+    if (bench_slot < 0) bench_slot = ios_create_slot(SAVE_BENCH_CHARACTER);
+
+    int result = 0;
+    for (int op = 0; op < OP_COUNT; op++) {
+        uint64_t wall[SAVE_BENCH_MAX_ITERATIONS], serialize[SAVE_BENCH_MAX_ITERATIONS];
+        uint64_t total = 0;
+        int failures = 0;
+        NhIoStats before, after;
+        nh_io_stats_get(&before);
+        uint64_t game_bytes = 0;
+
+        for (int i = 0; i < iterations; i++) {
+            if (run_op((BenchOp)op, save_dir, heap_path, &wall[i], &serialize[i]) != 0) failures++;
+            total += wall[i];
+            if (op == OP_SAVE_COMPLETE || op == OP_SAVE_TO_SLOT) game_bytes += file_size(game_path);
+        }
+        nh_io_stats_get(&after);
+
+        uint64_t first = wall[0];
+        qsort(wall, (size_t)iterations, sizeof(uint64_t), compare_u64);
+        qsort(serialize, (size_t)iterations, sizeof(uint64_t), compare_u64);
+        // savegame is rewritten in full by bwrite, outside nh_io_stats
+        uint64_t bytes = after.bytes_written - before.bytes_written + game_bytes;
+
+        fprintf(out,
+                "{\"fixture\":\"%s\",\"op\":\"%s\",\"levels\":%d,\"iterations\":%d,"
+                "\"failures\":%d,\"wall_ns\":{\"first\":%llu,\"min\":%llu,\"median\":%llu,"
+                "\"max\":%llu,\"mean\":%llu},\"serialize_ns_median\":%llu,"
+                "\"bytes_written\":%llu,\"writes\":%llu,\"fsyncs\":%llu,"
+                "\"savegame_bytes\":%llu}\n",
+                f->name, op_names[op], levels, iterations, failures,
+                (unsigned long long)first, (unsigned long long)wall[0],
+                (unsigned long long)wall[iterations / 2],
+                (unsigned long long)wall[iterations - 1],
+                (unsigned long long)(total / (uint64_t)iterations),
+                (unsigned long long)serialize[iterations / 2],
+                (unsigned long long)(bytes / (uint64_t)iterations),
+                (unsigned long long)((after.write_calls - before.write_calls) / (uint64_t)iterations),
+                (unsigned long long)((after.fsync_calls - before.fsync_calls) / (uint64_t)iterations),
+                (unsigned long long)file_size(game_path));
+        if (failures) result = -1;
+    }
+
+    fflush(out);
+    if (out != stdout) fclose(out);
+    return result;
+}
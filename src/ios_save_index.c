@@ -0,0 +1,344 @@
+/*
+ * ios_save_index.c - Character/slot index (see ios_save_index.h)
+ *
+ * File: [IndexHeader] [IosSaveIndexEntry * count]  (native byte order)
+ * The checksum covers the records; root_mtime is characters/' mtime when
+ * the index was written.
+ */
+
+#include "ios_save_index.h"
+#include "ios_log.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INDEX_MAGIC "NHSIDX1"
+#define INDEX_VERSION 1
+#define INDEX_MAX_ENTRIES 4096
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;                 /* sizeof(IosSaveIndexEntry) */
+    uint32_t count;
+    uint32_t checksum;                   /* FNV-1a of the records */
+    int64_t root_mtime_sec;
+    int64_t root_mtime_nsec;
+} IndexHeader;
+
+typedef struct {
+    IosSaveIndexEntry *entries;
+    int count;
+    int capacity;
+} EntryList;
+
+static pthread_mutex_t index_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t fnv1a(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint32_t h = 0x811c9dc5u;
+    while (len--) {
+        h ^= *p++;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+static void index_path(const char *root, char *out, size_t size) {
+    snprintf(out, size, "%s.index", root);
+}
+
+static int root_mtime(const char *root, int64_t *sec, int64_t *nsec) {
+    struct stat st;
+    if (stat(root, &st) != 0) return -1;
+#ifdef __APPLE__
+    *sec = st.st_mtimespec.tv_sec;
+    *nsec = st.st_mtimespec.tv_nsec;
+#else
+    *sec = st.st_mtim.tv_sec;
+    *nsec = st.st_mtim.tv_nsec;
+#endif
+    return 0;
+}
+
+static IosSaveIndexEntry *list_append(EntryList *list) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 16;
+        IosSaveIndexEntry *grown = realloc(list->entries, capacity * sizeof(IosSaveIndexEntry));
+        if (!grown) return NULL;
+        list->entries = grown;
+        list->capacity = capacity;
+    }
+    IosSaveIndexEntry *entry = &list->entries[list->count++];
+    memset(entry, 0, sizeof(*entry));
+    return entry;
+}
+
+static int list_find(const EntryList *list, const char *character, int slot_id) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->entries[i].slot_id == slot_id &&
+            strcmp(list->entries[i].character, character) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ---- Rebuild from the directories ---- */
+
+/* Value text after "key": in json, or NULL */
+static const char *json_value(const char *json, const char *key) {
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json, search);
+    if (!pos) return NULL;
+    pos += strlen(search);
+    while (*pos == ' ') pos++;
+    return pos;
+}
+
+static void json_copy_string(const char *json, const char *key, char *out, size_t size) {
+    const char *pos = json_value(json, key);
+    if (!pos || *pos != '"') return;
+    pos++;
+    size_t i = 0;
+    while (*pos && *pos != '"' && i < size - 1) out[i++] = *pos++;
+    out[i] = '\0';
+}
+
+static int64_t json_int(const char *json, const char *key) {
+    const char *pos = json_value(json, key);
+    return pos ? strtoll(pos, NULL, 10) : 0;
+}
+
+static void read_metadata(const char *dir, IosSaveIndexEntry *entry) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/savegame", dir);
+    if (access(path, F_OK) == 0) entry->flags |= IOS_SAVE_INDEX_HAS_SAVE;
+
+    snprintf(path, sizeof(path), "%s/metadata.json", dir);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return;
+    char json[8192];
+    size_t len = fread(json, 1, sizeof(json) - 1, fp);
+    fclose(fp);
+    json[len] = '\0';
+
+    json_copy_string(json, "role", entry->role, sizeof(entry->role));
+    json_copy_string(json, "race", entry->race, sizeof(entry->race));
+    entry->level = (int32_t)json_int(json, "level");
+    entry->dungeon_level = (int32_t)json_int(json, "dungeon_level");
+    entry->turns = json_int(json, "turns");
+
+    char timestamp[64] = "";
+    json_copy_string(json, "last_saved", timestamp, sizeof(timestamp));
+    struct tm tm = {0};
+    if (sscanf(timestamp, "%d-%d-%dT%d:%d:%dZ", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec) == 6) {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        entry->last_saved = (int64_t)timegm(&tm);
+    }
+}
+
+static int is_directory(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static void rebuild(const char *root, EntryList *list) {
+    list->count = 0;
+    DIR *dir = opendir(root);
+    if (!dir) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && list->count < INDEX_MAX_ENTRIES) {
+        if (entry->d_name[0] == '.') continue;
+        if (strlen(entry->d_name) >= sizeof(((IosSaveIndexEntry *)0)->character)) continue;
+        char char_path[1024];
+        snprintf(char_path, sizeof(char_path), "%s/%s", root, entry->d_name);
+        if (!is_directory(char_path)) continue;
+
+        IosSaveIndexEntry *row = list_append(list);
+        if (!row) break;
+        snprintf(row->character, sizeof(row->character), "%s", entry->d_name);
+        read_metadata(char_path, row);
+
+        DIR *slots = opendir(char_path);
+        if (!slots) continue;
+        struct dirent *slot_entry;
+        while ((slot_entry = readdir(slots)) != NULL && list->count < INDEX_MAX_ENTRIES) {
+            if (strncmp(slot_entry->d_name, "slot_", 5) != 0) continue;
+            char slot_path[1300];
+            snprintf(slot_path, sizeof(slot_path), "%s/%s", char_path, slot_entry->d_name);
+            if (!is_directory(slot_path)) continue;
+
+            IosSaveIndexEntry *slot = list_append(list);
+            if (!slot) break;
+            snprintf(slot->character, sizeof(slot->character), "%s", entry->d_name);
+            slot->slot_id = atoi(slot_entry->d_name + 5);
+            read_metadata(slot_path, slot);
+        }
+        closedir(slots);
+    }
+    closedir(dir);
+    IOS_LOG_I(IOS_LOG_CAT_SAVE, "[SAVE_INDEX] Rebuilt index: %d records", list->count);
+}
+
+/* ---- File I/O ---- */
+
+static int write_index(const char *root, const EntryList *list) {
+    IndexHeader header = {0};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.entry_size = sizeof(IosSaveIndexEntry);
+    header.count = (uint32_t)list->count;
+    header.checksum = fnv1a(list->entries, (size_t)list->count * sizeof(IosSaveIndexEntry));
+    if (root_mtime(root, &header.root_mtime_sec, &header.root_mtime_nsec) != 0) return -1;
+
+    char path[1024], temp[1040];
+    index_path(root, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+
+    FILE *fp = fopen(temp, "wb");
+    if (!fp) return -1;
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             (list->count == 0 ||
+              fwrite(list->entries, sizeof(IosSaveIndexEntry), (size_t)list->count, fp) == (size_t)list->count);
+    if (fclose(fp) != 0) ok = 0;
+    if (ok && rename(temp, path) != 0) ok = 0;
+    if (!ok) {
+        IOS_LOG_W(IOS_LOG_CAT_SAVE, "[SAVE_INDEX] Cannot write %s: %s", path, strerror(errno));
+        unlink(temp);
+        return -1;
+    }
+    return 0;
+}
+
+/* 0 if the index file is present, intact and current */
+static int read_index(const char *root, EntryList *list) {
+    char path[1024];
+    index_path(root, path, sizeof(path));
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+
+    IndexHeader header;
+    int64_t sec, nsec;
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+             header.version == INDEX_VERSION &&
+             header.entry_size == sizeof(IosSaveIndexEntry) &&
+             header.count <= INDEX_MAX_ENTRIES &&
+             root_mtime(root, &sec, &nsec) == 0 &&
+             header.root_mtime_sec == sec && header.root_mtime_nsec == nsec;
+
+    list->count = 0;
+    if (ok && header.count > 0) {
+        IosSaveIndexEntry *entries = malloc(header.count * sizeof(IosSaveIndexEntry));
+        ok = entries && fread(entries, sizeof(IosSaveIndexEntry), header.count, fp) == header.count &&
+             fnv1a(entries, header.count * sizeof(IosSaveIndexEntry)) == header.checksum;
+        if (ok) {
+            free(list->entries);
+            list->entries = entries;
+            list->count = list->capacity = (int)header.count;
+            for (int i = 0; i < list->count; i++) {
+                list->entries[i].character[sizeof(list->entries[i].character) - 1] = '\0';
+            }
+        } else {
+            free(entries);
+        }
+    }
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+/* Index lock held: current records, rebuilding (and rewriting) if needed */
+static void load(const char *root, EntryList *list) {
+    if (read_index(root, list) == 0) return;
+    rebuild(root, list);
+    write_index(root, list);
+}
+
+/* ---- API ---- */
+
+void ios_save_index_put(const char *root, const IosSaveIndexEntry *entry) {
+    if (!root || !entry) return;
+    pthread_mutex_lock(&index_lock);
+    EntryList list = {0};
+    load(root, &list);
+
+    int i = list_find(&list, entry->character, entry->slot_id);
+    IosSaveIndexEntry *slot = i >= 0 ? &list.entries[i] : list_append(&list);
+    if (slot) {
+        *slot = *entry;
+        slot->character[sizeof(slot->character) - 1] = '\0';
+        write_index(root, &list);
+    }
+
+    free(list.entries);
+    pthread_mutex_unlock(&index_lock);
+}
+
+void ios_save_index_add_character(const char *root, const char *character) {
+    if (!root || !character) return;
+    pthread_mutex_lock(&index_lock);
+    EntryList list = {0};
+    load(root, &list);
+
+    // Rewrite even if present: characters/ may have changed since (mkdir)
+    if (list_find(&list, character, 0) < 0) {
+        IosSaveIndexEntry *row = list_append(&list);
+        if (row) snprintf(row->character, sizeof(row->character), "%s", character);
+    }
+    write_index(root, &list);
+
+    free(list.entries);
+    pthread_mutex_unlock(&index_lock);
+}
+
+void ios_save_index_remove(const char *root, const char *character, int slot_id) {
+    if (!root || !character) return;
+    pthread_mutex_lock(&index_lock);
+    EntryList list = {0};
+    load(root, &list);
+
+    int kept = 0;
+    for (int i = 0; i < list.count; i++) {
+        const IosSaveIndexEntry *e = &list.entries[i];
+        int match = strcmp(e->character, character) == 0 &&
+                    (slot_id == IOS_SAVE_INDEX_ALL_SLOTS || e->slot_id == slot_id);
+        if (!match) list.entries[kept++] = *e;
+    }
+    list.count = kept;
+    write_index(root, &list);
+
+    free(list.entries);
+    pthread_mutex_unlock(&index_lock);
+}
+
+int ios_save_index_read(const char *root, IosSaveIndexEntry **entries) {
+    *entries = NULL;
+    if (!root) return 0;
+    pthread_mutex_lock(&index_lock);
+    EntryList list = {0};
+    load(root, &list);
+    pthread_mutex_unlock(&index_lock);
+
+    if (list.count == 0) {
+        free(list.entries);
+        return 0;
+    }
+    *entries = list.entries;
+    return list.count;
+}
+
+void ios_save_index_release(IosSaveIndexEntry *entries) {
+    free(entries);
+}
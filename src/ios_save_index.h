@@ -0,0 +1,59 @@
+/*
+ * ios_save_index.h - One-file index of characters and slots
+ *
+ * The load screen used to list saves by walking characters/ with readdir
+ * and stat, per character and per slot. The index keeps one fixed-size
+ * record per character and per slot in <root>.index (next to the
+ * characters/ directory, so writing it does not touch characters/' mtime).
+ * Listing is one read.
+ *
+ * Updated by the code that changes saves (slot create/save/delete,
+ * character save/delete) with a write-to-temp-and-rename, so a reader sees
+ * either the old or the new index. The index is only a cache: it is
+ * rebuilt from the directories and metadata.json files when it is missing,
+ * fails its checksum, has another version, or characters/ was modified
+ * since it was written (a character added or removed outside this code,
+ * e.g. an iCloud download).
+ *
+ * Thread-safe (the load screen lists on the main thread while the game
+ * thread saves).
+ */
+
+#ifndef IOS_SAVE_INDEX_H
+#define IOS_SAVE_INDEX_H
+
+#include <stdint.h>
+
+#define IOS_SAVE_INDEX_HAS_SAVE 0x1      /* savegame present */
+#define IOS_SAVE_INDEX_ALL_SLOTS (-1)    /* ios_save_index_remove: whole character */
+
+typedef struct {
+    char character[64];                  /* Directory name under characters/ */
+    int32_t slot_id;                     /* 0: the character row (characters/<name>/savegame) */
+    uint32_t flags;                      /* IOS_SAVE_INDEX_* */
+    int32_t level;
+    int32_t dungeon_level;
+    int64_t turns;
+    int64_t last_saved;                  /* Unix time, 0 if never saved */
+    char role[32];
+    char race[32];
+} IosSaveIndexEntry;
+
+/* Insert or replace the record for (entry->character, entry->slot_id) */
+void ios_save_index_put(const char *root, const IosSaveIndexEntry *entry);
+
+/* Add a character row (slot 0, no save) unless the character has one */
+void ios_save_index_add_character(const char *root, const char *character);
+
+/* Remove one slot's record, or every record of the character */
+void ios_save_index_remove(const char *root, const char *character, int slot_id);
+
+/*
+ * All records, in no particular order. *entries is NULL when there are
+ * none; release it with ios_save_index_release(). Returns the number of
+ * records.
+ */
+int ios_save_index_read(const char *root, IosSaveIndexEntry **entries);
+void ios_save_index_release(IosSaveIndexEntry *entries);
+
+#endif /* IOS_SAVE_INDEX_H */
@@ -15,11 +15,17 @@
 #include <sys/stat.h>
 #include <dirent.h>
 #include <dispatch/dispatch.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "../NetHack/include/hack.h"
 #include "../zone_allocator/nethack_memory_final.h"
 #include "../NetHack/include/dlb.h"
 #include "nethack_export.h"
 #include "ios_crash_handler.h"
+#include "ios_level_store.h"
+#include "ios_save_manifest.h"
+#include "ios_lua_pool.h"
+#include "ios_hibernate.h"
 
 // External functions from NetHack
 extern void savegamestate(NHFILE *);
@@ -67,40 +73,76 @@ extern bool snapshot_loaded;
 // Debug logging
 #define SAVE_LOG(fmt, ...) fprintf(stderr, "[SAVE_INTEGRATION] " fmt "\n", ##__VA_ARGS__)
 
-// VERSIONED SAVES - For debugging save corruption
-// Keeps last N saves so we can compare them
-static int save_version_counter = 0;
-#define MAX_VERSIONED_SAVES 10
+// Level record marker for a level kept in the chunk store (ios_level_store.h).
+// Inline levels are marked with their ledger number (always > 0). Followed by
+// xint8 ledger, int hash_hi, int hash_lo, int length.
+#define SAVE_LEVEL_CHUNK_MARKER ((xint8) -1)
 
-// Copy file for backup
-static int copy_file(const char* src, const char* dst) {
-    FILE* source = fopen(src, "rb");
-    if (!source) return -1;
+/*
+ * BACKGROUND SAVE WRITER
+ * ios_save_complete() serializes on the game thread into savegame.tmp (page
+ * cache only) and queues the durable half here: the manifest commit protocol
+ * (fsync, manifest rename, savegame rename - see ios_save_manifest.h). The
+ * serial queue keeps commits in order; code that reads or rewrites savegame
+ * calls ios_save_wait_for_writer() first. Until a commit lands the previous
+ * savegame stays intact.
+ */
+typedef struct {
+    char game_path[512];
+    char save_dir[512];
+    IosLevelChunkId level_chunks[IOS_LEVEL_STORE_LEDGERS];  // Chunks savegame references
+    int level_chunk_count;
+} SaveCommitJob;
+
+// One job at most: ios_save_complete() waits for the writer before the next
+// save. Static because free() here is NetHack's (MONITOR_HEAP -> nh_free),
+// which must not run on the writer thread.
+static SaveCommitJob save_commit_job;
+static dispatch_queue_t save_writer_queue = NULL;
+static atomic_int save_writer_pending = 0;
+static atomic_int save_writer_failed = 0;   // Sticky until ios_save_wait_for_writer()
+
+static dispatch_queue_t get_save_writer_queue(void) {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        save_writer_queue = dispatch_queue_create("nethack.save.writer", DISPATCH_QUEUE_SERIAL);
+    });
+    return save_writer_queue;
+}
 
-    FILE* dest = fopen(dst, "wb");
-    if (!dest) {
-        fclose(source);
-        return -1;
-    }
+static void save_commit_run(SaveCommitJob* job) {
+    uint64_t start = (uint64_t)clock_gettime_nsec_np(CLOCK_MONOTONIC);
 
-    char buffer[8192];
-    size_t bytes;
-    while ((bytes = fread(buffer, 1, sizeof(buffer), source)) > 0) {
-        if (fwrite(buffer, 1, bytes, dest) != bytes) {
-            fclose(source);
-            fclose(dest);
-            return -1;
+    int ok = ios_save_manifest_commit(job->save_dir, job->game_path,
+                                      job->level_chunks, job->level_chunk_count) == 0;
+    if (ok) {
+        int removed = ios_level_store_collect(job->save_dir, job->level_chunks, job->level_chunk_count);
+        if (removed > 0) {
+            SAVE_LOG("  [writer] Removed %d unreferenced level chunks", removed);
         }
+        SAVE_LOG("  [writer] ✓ Save committed in %.1f ms",
+                 ((uint64_t)clock_gettime_nsec_np(CLOCK_MONOTONIC) - start) / 1e6);
+    } else {
+        SAVE_LOG("  [writer] ERROR: Save commit failed: %s", strerror(errno));
+        atomic_store(&save_writer_failed, 1);
     }
+    atomic_fetch_sub(&save_writer_pending, 1);
+}
 
-    fclose(source);
-    fclose(dest);
-    return 0;
+/*
+ * Block until queued save commits have finished.
+ * Returns 0 if they all succeeded, -1 if any failed since the last call.
+ */
+NETHACK_EXPORT int ios_save_wait_for_writer(void) {
+    if (atomic_load(&save_writer_pending) > 0) {
+        dispatch_sync(get_save_writer_queue(), ^{});
+    }
+    return atomic_exchange(&save_writer_failed, 0) ? -1 : 0;
 }
 
 /*
  * COMPLETE SAVE FUNCTION
- * Saves both memory state AND game state atomically
+ * Serializes game state on the game thread; the background writer commits it
  */
 NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     SAVE_LOG("========== COMPLETE SAVE INITIATED ==========");
@@ -110,6 +152,9 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
         return -1;
     }
 
+    // The new savegame supersedes any hibernation image
+    ios_hibernate_discard();
+
     // CRITICAL: Comprehensive game-started checks (matching dosave0:100)
     // ALL five checks must pass before we can save
     extern struct instance_globals_s gs;
@@ -162,6 +207,11 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     SAVE_LOG("  HP: %d/%d", u.uhp, u.uhpmax);
     SAVE_LOG("  Level: %d", u.uz.dlevel);
 
+    // A previous commit may still own savegame.tmp
+    if (ios_save_wait_for_writer() != 0) {
+        SAVE_LOG("  ⚠️ Previous background commit failed (retrying with this save)");
+    }
+
     // PHASE 1: Pre-save setup (matching dosave0:82-145)
     SAVE_LOG("PHASE 1: Pre-save setup");
 
@@ -365,6 +415,8 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     // Debug logging added to diagnose iOS-specific high maxledgerno() values.
     xint16 max_ledger = maxledgerno();
     SAVE_LOG("DEBUG: maxledgerno() = %d (expect < 127, if > 127 investigate dungeon config)", max_ledger);
+    IosLevelChunkId level_chunks[IOS_LEVEL_STORE_LEDGERS];
+    int level_chunk_count = 0, chunks_written = 0, inline_levels = 0;
     for (xint16 ltmp = 1; ltmp <= max_ledger; ltmp++) {
         // Skip current level (already saved above)
         if (ltmp == ledger_no(&gu.uz_save)) {
@@ -378,8 +430,6 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
             continue;
         }
 
-        SAVE_LOG("  Level %d: Loading from level file...", (int)ltmp);
-
         // Open the level file
         char whynot[256] = {0};  // Initialize to prevent garbage if open fails silently
         NHFILE *onhfp = open_levelfile(ltmp, whynot);
@@ -394,7 +444,36 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
             return -1;
         }
 
-        // Load the level from disk
+        // The level file already is the serialized level: keep it as a
+        // chunk (reusing the last one if the level is clean) and reference it
+        IosLevelChunkId chunk;
+        int created = 0;
+        if (ios_level_store_reusable(save_dir, ltmp, onhfp->fd, &chunk) ||
+            ios_level_store_capture(save_dir, ltmp, onhfp->fd, svh.hackpid, &chunk, &created) == 0) {
+            close_nhfile(onhfp);
+
+            xint8 marker = SAVE_LEVEL_CHUNK_MARKER;
+            xint8 ltmp8 = (xint8)ltmp;
+            int hash_hi = (int)(uint32_t)(chunk.hash >> 32);
+            int hash_lo = (int)(uint32_t)chunk.hash;
+            int length = (int)chunk.length;
+            Sfo_xint8(nhfp, &marker, "gamestate-level_chunk");
+            Sfo_xint8(nhfp, &ltmp8, "gamestate-level_number");
+            Sfo_int(nhfp, &hash_hi, "gamestate-level_chunk_hash_hi");
+            Sfo_int(nhfp, &hash_lo, "gamestate-level_chunk_hash_lo");
+            Sfo_int(nhfp, &length, "gamestate-level_chunk_length");
+            level_chunks[level_chunk_count++] = chunk;
+            chunks_written += created;
+
+            delete_levelfile(ltmp);
+            SAVE_LOG("  Level %d: %s chunk (%u bytes)", (int)ltmp,
+                     created ? "New" : "Reused", chunk.length);
+            continue;
+        }
+
+        // Unexpected level file: serialize it into savegame as before
+        SAVE_LOG("  Level %d: Loading from level file...", (int)ltmp);
+        inline_levels++;
         getlev(onhfp, svh.hackpid, ltmp);
         close_nhfile(onhfp);
         SAVE_LOG("  Level %d: Loaded, saving to consolidated file...", (int)ltmp);
@@ -468,7 +547,8 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     // Restore u.uz after consolidation (dosave0:218-219)
     u.uz = gu.uz_save;
     gu.uz_save.dnum = gu.uz_save.dlevel = 0;
-    SAVE_LOG("✓ All levels consolidated into save file");
+    SAVE_LOG("✓ All levels consolidated into save file (%d chunk refs, %d new chunks, %d inline)",
+             level_chunk_count, chunks_written, inline_levels);
 
     // RCA FIX 2025-12-30: Restore current level from save file!
     // ========================================================================
@@ -476,8 +556,11 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     // the last consolidated level's data. We must reload the current level
     // to restore correct game state for continued iOS gameplay.
     // ========================================================================
-    SAVE_LOG("Step 3d-post: Reloading current level from save file (iOS FIX)");
-    {
+    // Only the inline getlev() path disturbs memory; chunk-stored levels
+    // are never loaded, so with none inline there is nothing to repair.
+    SAVE_LOG("Step 3d-post: Reloading current level from save file (iOS FIX)%s",
+             inline_levels > 0 ? "" : " - skipped, no level was loaded");
+    if (inline_levels > 0) {
         // Reopen the just-written save file
         NHFILE *reload_nhfp = (NHFILE *) alloc(sizeof(NHFILE));
         if (!reload_nhfp) {
@@ -543,58 +626,20 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
         return -1;
     }
 
-    // Step 5: VERSIONED BACKUP - Keep old saves for debugging
-    SAVE_LOG("Step 5: Creating versioned backup of previous save");
-
-    // Check if previous save exists, and if so, create a versioned backup
-    if (access(game_path, F_OK) == 0) {
-        // Create versioned backup path: savegame.v001, savegame.v002, etc.
-        char backup_path[512];
-        save_version_counter++;
-        snprintf(backup_path, sizeof(backup_path), "%s.v%03d_L%d",
-                 game_path, save_version_counter % MAX_VERSIONED_SAVES, u.uz.dlevel);
-
-        if (copy_file(game_path, backup_path) == 0) {
-            SAVE_LOG("  ✓ Backed up previous save to: %s", backup_path);
-
-            // Also log the save file size for debugging
-            struct stat st;
-            if (stat(backup_path, &st) == 0) {
-                SAVE_LOG("  📦 Backup size: %lld bytes", (long long)st.st_size);
-            }
-        } else {
-            SAVE_LOG("  ⚠️ Failed to backup previous save (continuing anyway)");
-        }
-    } else {
-        SAVE_LOG("  ℹ️ No previous save to backup (first save)");
-    }
-
-    // Also backup the NEW temp file we're about to commit
-    char new_backup_path[512];
-    snprintf(new_backup_path, sizeof(new_backup_path), "%s.v%03d_L%d_NEW",
-             game_path, save_version_counter % MAX_VERSIONED_SAVES, u.uz.dlevel);
-    if (copy_file(game_temp_path, new_backup_path) == 0) {
-        struct stat st;
-        if (stat(new_backup_path, &st) == 0) {
-            SAVE_LOG("  📦 NEW save backup: %s (%lld bytes)", new_backup_path, (long long)st.st_size);
-        }
-    }
-
-    // Step 6: ATOMIC RENAME - Make save file valid
-    SAVE_LOG("Step 6: Performing atomic rename of game save file");
-
-    // Rename game.sav.tmp -> game.sav (atomic operation)
-    if (rename(game_temp_path, game_path) != 0) {
-        SAVE_LOG("ERROR: Failed to rename game temp file! errno=%d (%s)", errno, strerror(errno));
-        unlink(game_temp_path);
-        change_luck(flags.moonphase == FULL_MOON ? 1 : 0);
-        change_luck(flags.friday13 ? -1 : 0);
-        notice_mon_on();
-        program_state.saving--;
-        return -1;
-    }
-    SAVE_LOG("  ✓ Game file atomically renamed");
-    SAVE_LOG("✓ ATOMIC SAVE COMPLETE - Save file committed");
+    // Step 5: Hand the durable part to the background writer
+    // (fsync, manifest commit, rename - see save_commit_run)
+    SAVE_LOG("Step 5: Queueing background commit (fsync, manifest, atomic rename)");
+    SaveCommitJob* job = &save_commit_job;
+    memset(job, 0, sizeof(*job));
+    snprintf(job->game_path, sizeof(job->game_path), "%s", game_path);
+    snprintf(job->save_dir, sizeof(job->save_dir), "%s", save_dir);
+    memcpy(job->level_chunks, level_chunks, sizeof(IosLevelChunkId) * level_chunk_count);
+    job->level_chunk_count = level_chunk_count;
+
+    atomic_fetch_add(&save_writer_pending, 1);
+    dispatch_async(get_save_writer_queue(), ^{
+        save_commit_run(job);
+    });
 
     // PHASE 4: Post-save cleanup (matching dosave0 end)
     SAVE_LOG("PHASE 4: Post-save cleanup");
@@ -612,13 +657,70 @@ NETHACK_EXPORT int ios_save_complete(const char* save_dir) {
     // Decrement saving flag
     program_state.saving--;
 
-    SAVE_LOG("✓ SAVE COMPLETE - Game state saved (no memory.dat needed!)");
+    SAVE_LOG("✓ SAVE SERIALIZED - commit running in background (no memory.dat needed!)");
     SAVE_LOG("  Game: %s", game_path);
     SAVE_LOG("==========================================");
 
     return 0;
 }
 
+/*
+ * Bring-up after ios_hibernate_load(): the heap and NetHack's globals are
+ * exactly as they were at the hibernated (or autosaved) command prompt, so
+ * none of the restore phases below apply. Only what lives outside the image is rebuilt:
+ * the exit flags, the file prefixes, the Lua core state, the window system
+ * and the status fields. No welcome back and no special room check: the
+ * player never left the prompt.
+ */
+static int resume_hibernated_game(void) {
+    SAVE_LOG("Resuming from hibernation image (restore phases skipped)");
+
+    extern void ios_reset_game_exit(void);
+    ios_reset_game_exit();
+
+    extern void ios_init_file_prefixes(void);
+    ios_init_file_prefixes();
+    ios_lua_core_init();  // The image's core state died with the old process
+
+    extern void init_ios_windowprocs(void);
+    init_ios_windowprocs();
+    int dummy_argc = 0;
+    char *dummy_argv[] = { NULL };
+    init_nhwindows(&dummy_argc, dummy_argv);
+    extern void ios_setup_default_symbols(void);
+    ios_setup_default_symbols();
+
+    extern winid WIN_MESSAGE, WIN_STATUS, WIN_MAP, WIN_INVEN;
+    WIN_MESSAGE = create_nhwindow(NHW_MESSAGE);
+    WIN_MAP = create_nhwindow(NHW_MAP);
+    WIN_STATUS = create_nhwindow(NHW_STATUS);
+    WIN_INVEN = create_nhwindow(NHW_MENU);
+
+    // The status buffers are in the image; only the window side is new
+    extern struct instance_globals_b gb;
+    extern void status_initialize(boolean);
+    status_initialize(gb.blinit ? REASSESS_ONLY : FALSE);
+
+    extern struct window_procs ios_procs;
+    windowprocs = ios_procs;
+    extern void docrt(void);
+    extern void flush_screen(int how);
+    docrt();
+    flush_screen(0);
+
+    extern void ios_clear_status_cache(void);
+    ios_clear_status_cache();
+
+    extern int game_started;
+    game_started = 1;
+    snapshot_loaded = true;
+
+    SAVE_LOG("✓ RESUMED - Game ready to continue");
+    extern void ios_notify_game_ready(void);
+    ios_notify_game_ready();
+    return 0;
+}
+
 /*
  * COMPLETE RESTORE FUNCTION
  * Restores memory state THEN game state in the CORRECT order
@@ -632,6 +734,42 @@ NETHACK_EXPORT int ios_restore_complete(const char* save_dir) {
         return -1;
     }
 
+    // Read the latest committed save, not one still being written
+    ios_save_wait_for_writer();
+    ios_level_store_reset();  // Level files are rewritten from this save
+
+    // A hibernation image of this very game, or its last autosave, skips
+    // everything below
+    int hibernate = ios_hibernate_load(save_dir);
+    ios_hibernate_expect(NULL);
+    if (hibernate == IOS_HIBERNATE_OK) {
+        return resume_hibernated_game();
+    }
+    ios_hibernate_discard();  // Refused once, refused always; a restored game outdates it
+
+    // Finish a commit cut short by a kill, and refuse a save that does not
+    // match its manifest rather than restore half of it
+    char committed_path[512];
+    snprintf(committed_path, sizeof(committed_path), "%s/savegame", save_dir);
+    int manifest_state = ios_save_manifest_recover(save_dir, committed_path);
+    if (manifest_state == IOS_SAVE_MANIFEST_CORRUPT) {
+        SAVE_LOG("ERROR: Save failed verification against its manifest");
+        return -1;
+    }
+    SAVE_LOG("  Save %s", manifest_state == IOS_SAVE_MANIFEST_VERIFIED
+             ? "verified against manifest" : "has no manifest (unverified)");
+
+    // Read and verify the chunk-stored levels on worker threads while the
+    // game state restores; the extraction loop below takes them ready
+    if (manifest_state == IOS_SAVE_MANIFEST_VERIFIED) {
+        IosLevelChunkId prefetch_ids[IOS_LEVEL_STORE_LEDGERS];
+        int prefetch_count = ios_save_manifest_chunks(committed_path, prefetch_ids);
+        if (prefetch_count > 0) {
+            ios_level_store_prefetch(save_dir, prefetch_ids, prefetch_count);
+            SAVE_LOG("  Prefetching %d level chunks", prefetch_count);
+        }
+    }
+
     // CRITICAL: Reset exit flags FIRST!
     // Prevents stale exit state from previous session blocking the restored game
     SAVE_LOG("PHASE -1: Clear stale exit flags from previous session");
@@ -906,7 +1044,7 @@ NETHACK_EXPORT int ios_restore_complete(const char* save_dir) {
     // If we call it after l_nhcore_init(), it can corrupt the global Lua state!
     // This matches the order in newgame() at allmain.c:773-780.
     SAVE_LOG("Step 2: Initializing Lua subsystem (MUST BE BEFORE init_dungeons!)");
-    l_nhcore_init();
+    ios_lua_core_init();  // l_nhcore_init() in the Lua pool's core arena
     SAVE_LOG("✓ Lua initialized");
 
     // NOTE: We do NOT call init_dungeons() during restore!
@@ -1347,6 +1485,48 @@ NETHACK_EXPORT int ios_restore_complete(const char* save_dir) {
             break;
         }
 
+        // Level kept in the chunk store: write it straight to its level file
+        if (ltmp == SAVE_LEVEL_CHUNK_MARKER) {
+            extern void Sfi_int(NHFILE *, int *, const char *);
+            extern struct instance_globals_saved_h svh;
+            xint8 chunk_level = 0;
+            int hash_hi = 0, hash_lo = 0, length = 0;
+            Sfi_xint8(nhfp, &chunk_level, "gamestate-level_number");
+            Sfi_int(nhfp, &hash_hi, "gamestate-level_chunk_hash_hi");
+            Sfi_int(nhfp, &hash_lo, "gamestate-level_chunk_hash_lo");
+            Sfi_int(nhfp, &length, "gamestate-level_chunk_length");
+            if (nhfp->eof) {
+                SAVE_LOG("ERROR: Truncated level chunk reference");
+                program_state.something_worth_saving = 0;
+                close_nhfile(nhfp);
+                return -1;
+            }
+
+            IosLevelChunkId chunk = {
+                .hash = ((uint64_t)(uint32_t)hash_hi << 32) | (uint32_t)hash_lo,
+                .length = (uint32_t)length,
+            };
+            char whynot_chunk[256] = {0};
+            NHFILE *level_nhfp = create_levelfile(chunk_level, whynot_chunk);
+            if (!level_nhfp) {
+                SAVE_LOG("ERROR: Failed to create level file %d: %s", (int)chunk_level, whynot_chunk);
+                program_state.something_worth_saving = 0;
+                close_nhfile(nhfp);
+                return -1;
+            }
+            int extracted = ios_level_store_extract(save_dir, chunk_level, &chunk,
+                                                    level_nhfp->fd, svh.hackpid);
+            close_nhfile(level_nhfp);
+            if (extracted != 0) {
+                SAVE_LOG("ERROR: Level %d chunk missing or corrupt", (int)chunk_level);
+                program_state.something_worth_saving = 0;
+                close_nhfile(nhfp);
+                return -1;
+            }
+            SAVE_LOG("  Level %d: Written from chunk store (%u bytes)", (int)chunk_level, chunk.length);
+            continue;
+        }
+
         SAVE_LOG("  Level %d: Extracting from consolidated save...", (int)ltmp);
 
         // FIX: Properly extract level data from consolidated save to individual level file
@@ -1856,7 +2036,9 @@ NETHACK_EXPORT int ios_save_exists(void) {
         return 0;
     }
 
-    // Check if file exists
+    // Check if file exists (after any pending commit)
+    ios_save_wait_for_writer();
+    // A hibernation image alone is no save: it only resumes the savegame it belongs to
     int exists = (access(game_path, F_OK) == 0);
     if (exists) {
         SAVE_LOG("Found save file: savegame");
@@ -1871,10 +2053,26 @@ NETHACK_EXPORT int ios_save_exists(void) {
  */
 NETHACK_EXPORT void ios_delete_save(void) {
     SAVE_LOG("Deleting save files");
+    ios_save_wait_for_writer();  // A late commit would resurrect the save
 
     // Use NetHack's own delete function - it handles all NetHack save files
     delete_savefile();
 
+    // Level chunks live beside savegame (see ios_level_store.h)
+    extern const char* get_ios_documents_path(void);
+    const char* documents = get_ios_documents_path();
+    if (documents) {
+        char save_dir[512];
+        snprintf(save_dir, sizeof(save_dir), "%s/save", documents);
+        ios_level_store_remove(save_dir);
+
+        char game_path[512];
+        snprintf(game_path, sizeof(game_path), "%s/savegame", save_dir);
+        ios_save_manifest_remove(game_path);  // Would fail the next savegame copied in
+    }
+    ios_hibernate_discard();
+    ios_level_store_reset();
+
     SAVE_LOG("✓ NetHack save files deleted");
 }
 
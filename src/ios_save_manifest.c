@@ -0,0 +1,281 @@
+/*
+ * ios_save_manifest.c - Save commit protocol (see ios_save_manifest.h)
+ *
+ * File: [ManifestHeader] [ManifestChunk * chunk_count]  (native byte order)
+ * The checksum covers the header (checksum field zero) and the chunks.
+ */
+
+#include "ios_save_manifest.h"
+#include "ios_file_copy.h"
+#include "../zone_allocator/nh_io_stats.h"
+#include "ios_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MANIFEST_MAGIC "NHSMAN1"
+#define MANIFEST_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunk_count;
+    uint64_t game_length;
+    uint64_t game_hash;                  /* FNV-1a of savegame */
+    uint64_t checksum;
+} ManifestHeader;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t length;
+    uint32_t reserved;
+} ManifestChunk;
+
+typedef struct {
+    ManifestHeader header;
+    ManifestChunk chunks[IOS_LEVEL_STORE_LEDGERS];
+} Manifest;
+
+#define FNV_OFFSET 0xcbf29ce484222325ull
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len--) {
+        h ^= *p++;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static uint64_t manifest_checksum(const Manifest *m) {
+    ManifestHeader header = m->header;
+    header.checksum = 0;
+    uint64_t h = fnv1a(FNV_OFFSET, &header, sizeof(header));
+    return fnv1a(h, m->chunks, m->header.chunk_count * sizeof(ManifestChunk));
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        nh_io_note_write((size_t)n);
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Hash fd from the start; 0 on success
+static int hash_fd(int fd, uint64_t *length, uint64_t *hash) {
+    char buffer[64 * 1024];
+    uint64_t h = FNV_OFFSET, total = 0;
+    off_t offset = 0;
+    ssize_t n;
+    while ((n = pread(fd, buffer, sizeof(buffer), offset)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        h = fnv1a(h, buffer, (size_t)n);
+        total += (uint64_t)n;
+        offset += n;
+    }
+    *length = total;
+    *hash = h;
+    return 0;
+}
+
+static int hash_path(const char *path, uint64_t *length, uint64_t *hash) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    int result = hash_fd(fd, length, hash);
+    close(fd);
+    return result;
+}
+
+static int fsync_dir(const char *dir) {
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return -1;
+    int result = nh_io_fsync(fd);
+    close(fd);
+    return result;
+}
+
+static void manifest_path(const char *game_path, char *out, size_t size) {
+    snprintf(out, size, "%s.manifest", game_path);
+}
+
+// 0 and *m filled if game_path has a well-formed manifest
+static int read_manifest(const char *game_path, Manifest *m) {
+    char path[1040];
+    manifest_path(game_path, path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, m, sizeof(*m));
+    close(fd);
+    if (n < (ssize_t)sizeof(ManifestHeader) ||
+        memcmp(m->header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0 ||
+        m->header.version != MANIFEST_VERSION ||
+        m->header.chunk_count > IOS_LEVEL_STORE_LEDGERS ||
+        (size_t)n != sizeof(ManifestHeader) + m->header.chunk_count * sizeof(ManifestChunk) ||
+        manifest_checksum(m) != m->header.checksum) {
+        IOS_LOG_W(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Ignoring malformed manifest %s", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Chunk ids a manifest references
+static int manifest_chunks(const Manifest *m, IosLevelChunkId *ids) {
+    for (uint32_t i = 0; i < m->header.chunk_count; i++) {
+        ids[i].hash = m->chunks[i].hash;
+        ids[i].length = m->chunks[i].length;
+    }
+    return (int)m->header.chunk_count;
+}
+
+int ios_save_manifest_commit(const char *save_dir, const char *game_path,
+                             const IosLevelChunkId *chunks, int count) {
+    char temp_path[1040], path[1040], path_tmp[1060];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", game_path);
+    manifest_path(game_path, path, sizeof(path));
+    snprintf(path_tmp, sizeof(path_tmp), "%s.tmp", path);
+
+    if (count < 0 || count > IOS_LEVEL_STORE_LEDGERS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // 1. Data: savegame.tmp (hashed on the same pass) and its chunks
+    static Manifest m;                   // Writer queue only; ~2KB off its stack
+    memset(&m, 0, sizeof(m));
+    int fd = open(temp_path, O_RDONLY);
+    if (fd < 0) return -1;
+    if (hash_fd(fd, &m.header.game_length, &m.header.game_hash) != 0 || nh_io_fsync(fd) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot sync %s: %s", temp_path, strerror(errno));
+        return -1;
+    }
+    close(fd);
+    if (ios_level_store_flush(save_dir, chunks, count) != 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot sync level chunks: %s", strerror(errno));
+        return -1;
+    }
+
+    // 2. Manifest for it
+    memcpy(m.header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+    m.header.version = MANIFEST_VERSION;
+    m.header.chunk_count = (uint32_t)count;
+    for (int i = 0; i < count; i++) {
+        m.chunks[i].hash = chunks[i].hash;
+        m.chunks[i].length = chunks[i].length;
+    }
+    m.header.checksum = manifest_checksum(&m);
+
+    fd = open(path_tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    size_t size = sizeof(ManifestHeader) + (size_t)count * sizeof(ManifestChunk);
+    if (write_all(fd, &m, size) != 0 || nh_io_fsync(fd) != 0) {
+        int saved = errno;
+        close(fd);
+        unlink(path_tmp);
+        errno = saved;
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot write %s: %s", path_tmp, strerror(errno));
+        return -1;
+    }
+    close(fd);
+
+    // 3. Commit
+    if (rename(path_tmp, path) != 0) {
+        int saved = errno;
+        unlink(path_tmp);
+        errno = saved;
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot commit %s: %s", path, strerror(errno));
+        return -1;
+    }
+    if (fsync_dir(save_dir) != 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot sync %s: %s", save_dir, strerror(errno));
+        return -1;
+    }
+
+    // 4. Publish. Not synced: if this rename is lost, recovery redoes it
+    if (rename(temp_path, game_path) != 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot publish %s: %s", game_path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int ios_save_manifest_recover(const char *save_dir, const char *game_path) {
+    char temp_path[1040];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", game_path);
+
+    static Manifest m;                   // Game thread, writer idle
+    if (read_manifest(game_path, &m) != 0) {
+        unlink(temp_path);               // Never committed
+        return IOS_SAVE_MANIFEST_UNVERIFIED;
+    }
+
+    uint64_t length, hash;
+    int matches = hash_path(game_path, &length, &hash) == 0 &&
+                  length == m.header.game_length && hash == m.header.game_hash;
+    if (matches) {
+        unlink(temp_path);               // A later save that never committed
+    } else if (hash_path(temp_path, &length, &hash) == 0 &&
+               length == m.header.game_length && hash == m.header.game_hash) {
+        // Killed after the commit point: finish the commit
+        if (rename(temp_path, game_path) != 0) {
+            IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Cannot roll %s forward: %s",
+                      game_path, strerror(errno));
+            return IOS_SAVE_MANIFEST_CORRUPT;
+        }
+        fsync_dir(save_dir);
+        IOS_LOG_I(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] Finished interrupted commit of %s", game_path);
+    } else {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] %s does not match its manifest", game_path);
+        return IOS_SAVE_MANIFEST_CORRUPT;
+    }
+
+    IosLevelChunkId ids[IOS_LEVEL_STORE_LEDGERS];
+    int missing = ios_level_store_missing(save_dir, ids, manifest_chunks(&m, ids));
+    if (missing > 0) {
+        IOS_LOG_E(IOS_LOG_CAT_SAVE, "[SAVE_MANIFEST] %s is missing %d level chunks", game_path, missing);
+        return IOS_SAVE_MANIFEST_CORRUPT;
+    }
+    return IOS_SAVE_MANIFEST_VERIFIED;
+}
+
+int ios_save_manifest_chunks(const char *game_path, IosLevelChunkId *ids) {
+    static Manifest m;                   // Game thread, writer idle
+    if (read_manifest(game_path, &m) != 0) return -1;
+    return manifest_chunks(&m, ids);
+}
+
+int ios_save_manifest_copy(const char *src_game, const char *dst_game) {
+    char src[1040], dst[1040];
+    manifest_path(src_game, src, sizeof(src));
+    manifest_path(dst_game, dst, sizeof(dst));
+    if (access(src, F_OK) != 0) {
+        // A stale manifest would fail the copied savegame
+        return (unlink(dst) == 0 || errno == ENOENT) ? 0 : -1;
+    }
+    return ios_file_copy(src, dst);
+}
+
+int ios_save_manifest_digest(const char *game_path, uint64_t *length, uint64_t *hash) {
+    return hash_path(game_path, length, hash);
+}
+
+void ios_save_manifest_remove(const char *game_path) {
+    char path[1040];
+    manifest_path(game_path, path, sizeof(path));
+    unlink(path);
+}
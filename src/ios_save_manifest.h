@@ -0,0 +1,54 @@
+/*
+ * ios_save_manifest.h - Write-ahead manifest for crash-safe save commits
+ *
+ * A save is savegame plus the level chunks it references. The manifest
+ * (<game>.manifest) records savegame's length and hash and the chunk ids.
+ * Commit protocol, all on the save writer queue:
+ *
+ *   1. fsync <game>.tmp and the referenced chunks (one batch)
+ *   2. write and fsync <game>.manifest.tmp describing <game>.tmp
+ *   3. rename it over <game>.manifest        <- the commit point
+ *   4. fsync the directory, rename <game>.tmp over <game>
+ *
+ * Killed before 3: the old manifest still matches the old savegame. Killed
+ * between 3 and 4: the manifest matches <game>.tmp, and recovery finishes
+ * the rename. Nothing else is needed to survive jetsam mid-save, so saves
+ * no longer keep full-size backup copies.
+ *
+ * Saves written before the manifest existed (and slots copied from them)
+ * have none; they restore unverified.
+ */
+
+#ifndef IOS_SAVE_MANIFEST_H
+#define IOS_SAVE_MANIFEST_H
+
+#include "ios_level_store.h"
+
+#define IOS_SAVE_MANIFEST_VERIFIED 0      /* savegame and chunks match the manifest */
+#define IOS_SAVE_MANIFEST_UNVERIFIED 1    /* No (readable) manifest */
+#define IOS_SAVE_MANIFEST_CORRUPT (-1)    /* Neither savegame nor its .tmp matches */
+
+/* Run the commit protocol for <game_path>.tmp; 0, or -1 with errno set */
+int ios_save_manifest_commit(const char *save_dir, const char *game_path,
+                             const IosLevelChunkId *chunks, int count);
+
+/*
+ * Before restoring game_path: finish an interrupted commit, drop an
+ * uncommitted .tmp and check savegame against the manifest. Returns an
+ * IOS_SAVE_MANIFEST_* code. No save may be in flight (wait for the writer).
+ */
+int ios_save_manifest_recover(const char *save_dir, const char *game_path);
+
+/* The chunk ids game_path's manifest references (up to IOS_LEVEL_STORE_LEDGERS), -1 if none */
+int ios_save_manifest_chunks(const char *game_path, IosLevelChunkId *ids);
+
+/* Give dst_game src_game's manifest, or none if it has none (slot copies) */
+int ios_save_manifest_copy(const char *src_game, const char *dst_game);
+
+/* Length and FNV-1a hash of game_path's contents (the manifest's digest); 0, or -1 */
+int ios_save_manifest_digest(const char *game_path, uint64_t *length, uint64_t *hash);
+
+/* Delete game_path's manifest */
+void ios_save_manifest_remove(const char *game_path);
+
+#endif /* IOS_SAVE_MANIFEST_H */
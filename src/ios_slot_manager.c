@@ -35,6 +35,10 @@
 #include <sys/stat.h>
 #include <time.h>
 #include "../NetHack/include/hack.h"
+#include "ios_level_store.h"
+#include "ios_file_copy.h"
+#include "ios_save_manifest.h"
+#include "ios_save_index.h"
 
 #define SLOT_LOG(fmt, ...) fprintf(stderr, "[SLOT_MANAGER] " fmt "\n", ##__VA_ARGS__)
 
@@ -234,6 +238,7 @@ static int ensure_character_dir(const char* character_name) {
         // Verified: It's a directory - continue as success
     }
 
+    ios_save_index_add_character(get_characters_root(), sanitize_character_name(character_name));
     return 1;
 }
 
@@ -373,45 +378,16 @@ int ios_create_slot(const char* character_name) {
         // Verified: It's a directory - continue as success
     }
 
+    IosSaveIndexEntry entry = {0};
+    snprintf(entry.character, sizeof(entry.character), "%s", sanitize_character_name(character_name));
+    entry.slot_id = slot_id;
+    ios_save_index_put(get_characters_root(), &entry);
+
     SLOT_LOG("Created slot %d for '%s' at: %s (slot %d of %d)",
              slot_id, character_name, slot_path, count + 1, MAX_SLOTS);
     return slot_id;
 }
 
-/*
- * Copy a file (helper function)
- */
-static int copy_file(const char *src, const char *dest) {
-    FILE *src_fp = fopen(src, "rb");
-    if (!src_fp) {
-        SLOT_LOG("Failed to open source file: %s", src);
-        return 0;
-    }
-
-    FILE *dest_fp = fopen(dest, "wb");
-    if (!dest_fp) {
-        fclose(src_fp);
-        SLOT_LOG("Failed to open dest file: %s", dest);
-        return 0;
-    }
-
-    // Copy in 64KB chunks
-    char buffer[65536];
-    size_t bytes;
-
-    while ((bytes = fread(buffer, 1, sizeof(buffer), src_fp)) > 0) {
-        if (fwrite(buffer, 1, bytes, dest_fp) != bytes) {
-            fclose(src_fp);
-            fclose(dest_fp);
-            return 0;
-        }
-    }
-
-    fclose(src_fp);
-    fclose(dest_fp);
-    return 1;
-}
-
 /*
  * Generate metadata.json for a slot
  */
@@ -466,6 +442,21 @@ static int generate_metadata(const char* character_name, int slot_id, int slot_n
 
     fclose(fp);
 
+    // Same summary for the load screen's index
+    IosSaveIndexEntry entry = {0};
+    snprintf(entry.character, sizeof(entry.character), "%s", sanitize_character_name(character_name));
+    entry.slot_id = slot_id;
+    char savegame_path[512];
+    snprintf(savegame_path, sizeof(savegame_path), "%s/savegame", slot_path);
+    if (access(savegame_path, F_OK) == 0) entry.flags |= IOS_SAVE_INDEX_HAS_SAVE;
+    entry.level = u.ulevel;
+    entry.dungeon_level = u.uz.dlevel;
+    entry.turns = svm.moves;
+    entry.last_saved = (int64_t)now;
+    snprintf(entry.role, sizeof(entry.role), "%s", gu.urole.name.m);
+    snprintf(entry.race, sizeof(entry.race), "%s", gu.urace.noun);
+    ios_save_index_put(get_characters_root(), &entry);
+
     SLOT_LOG("Generated metadata for slot %d (character: %s, slot#: %d)", slot_id, character_name, slot_number);
     return 1;
 }
@@ -504,6 +495,11 @@ int ios_save_to_slot(const char* character_name, int slot_id) {
         SLOT_LOG("ERROR: Failed to save current game state");
         return 0;
     }
+    extern int ios_save_wait_for_writer(void);  // Commit runs in the background
+    if (ios_save_wait_for_writer() != 0) {
+        SLOT_LOG("ERROR: Failed to commit current game state");
+        return 0;
+    }
     SLOT_LOG("  ✓ Current game state saved (fresh savegame ready to copy)");
 
     // Copy game file (using FIXED filename "savegame")
@@ -522,8 +518,21 @@ int ios_save_to_slot(const char* character_name, int slot_id) {
         return 0;
     }
 
-    if (!copy_file(src_game, dest_game)) {
-        SLOT_LOG("Failed to copy game file");
+    // Level chunks first: savegame references them (see ios_level_store.h)
+    char src_save_dir[512];
+    snprintf(src_save_dir, sizeof(src_save_dir), "%s/save", SAVEP);
+    if (ios_level_store_copy_dir(src_save_dir, slot_path) != 0) {
+        SLOT_LOG("Failed to copy level chunks");
+        return 0;
+    }
+
+    ios_save_manifest_remove(dest_game);  // Never pair the new savegame with the old manifest
+    if (ios_file_copy(src_game, dest_game) != 0) {
+        SLOT_LOG("Failed to copy game file: %s", strerror(errno));
+        return 0;
+    }
+    if (ios_save_manifest_copy(src_game, dest_game) != 0) {
+        SLOT_LOG("Failed to copy save manifest: %s", strerror(errno));
         return 0;
     }
 
@@ -595,8 +604,20 @@ int ios_load_from_slot(const char* character_name, int slot_id) {
         return 0;
     }
 
-    if (!copy_file(src_game, dest_game)) {
-        SLOT_LOG("Failed to copy savegame");
+    char dest_save_dir[512];
+    snprintf(dest_save_dir, sizeof(dest_save_dir), "%s/save", SAVEP);
+    if (ios_level_store_copy_dir(slot_path, dest_save_dir) != 0) {
+        SLOT_LOG("Failed to copy level chunks");
+        return 0;
+    }
+
+    ios_save_manifest_remove(dest_game);  // Never pair the new savegame with the old manifest
+    if (ios_file_copy(src_game, dest_game) != 0) {
+        SLOT_LOG("Failed to copy savegame: %s", strerror(errno));
+        return 0;
+    }
+    if (ios_save_manifest_copy(src_game, dest_game) != 0) {
+        SLOT_LOG("Failed to copy save manifest: %s", strerror(errno));
         return 0;
     }
 
@@ -630,6 +651,7 @@ int ios_delete_slot(const char* character_name, int slot_id) {
     }
 
     SLOT_LOG("Deleting slot %d (character: %s)...", slot_id, character_name);
+    ios_level_store_remove(slot_path);
 
     // Delete all files in slot directory
     DIR *dir = opendir(slot_path);
@@ -655,6 +677,8 @@ int ios_delete_slot(const char* character_name, int slot_id) {
         return 0;
     }
 
+    ios_save_index_remove(get_characters_root(), sanitize_character_name(character_name), slot_id);
+
     SLOT_LOG("✅ Slot %d deleted for '%s'", slot_id, character_name);
     return 1;
 }
@@ -696,6 +720,7 @@ int ios_delete_character(const char* character_name) {
                 snprintf(slot_path, sizeof(slot_path), "%s/%s", char_path, slot_entry->d_name);
 
                 // Delete all files in slot
+                ios_level_store_remove(slot_path);
                 DIR *slot_dir = opendir(slot_path);
                 if (slot_dir) {
                     struct dirent *file_entry;
@@ -726,6 +751,9 @@ int ios_delete_character(const char* character_name) {
         return 0;
     }
 
+    ios_save_index_remove(get_characters_root(), sanitize_character_name(character_name),
+                          IOS_SAVE_INDEX_ALL_SLOTS);
+
     SLOT_LOG("✅ Character '%s' deleted", character_name);
     return 1;
 }
@@ -742,50 +770,43 @@ int* ios_list_slots(const char* character_name, int *count) {
         return NULL;
     }
 
-    char char_path[512];
-    if (!get_character_path(character_name, char_path, sizeof(char_path))) {
+    const char *root = get_characters_root();
+    if (!root) {
         return NULL;
     }
 
-    DIR *dir = opendir(char_path);
-    if (!dir) {
-        return NULL;
-    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s", sanitize_character_name(character_name));
 
-    // First pass: count slots
-    int num_slots = 0;
-    struct dirent *entry;
+    IosSaveIndexEntry *entries = NULL;
+    int num_entries = ios_save_index_read(root, &entries);
 
-    while ((entry = readdir(dir)) != NULL) {
-        if (strncmp(entry->d_name, "slot_", 5) == 0) {
+    int num_slots = 0;
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id > 0 && strcmp(entries[i].character, name) == 0) {
             num_slots++;
         }
     }
 
     if (num_slots == 0) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
-    // Allocate array
     int *slots = malloc(num_slots * sizeof(int));
     if (!slots) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
-    // Second pass: collect slot IDs
-    rewinddir(dir);
     int index = 0;
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strncmp(entry->d_name, "slot_", 5) == 0) {
-            int id = atoi(entry->d_name + 5);
-            slots[index++] = id;
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id > 0 && strcmp(entries[i].character, name) == 0) {
+            slots[index++] = entries[i].slot_id;
         }
     }
 
-    closedir(dir);
+    ios_save_index_release(entries);
 
     *count = num_slots;
     SLOT_LOG("Found %d slots for character '%s'", num_slots, character_name);
@@ -806,64 +827,40 @@ char** ios_list_characters(int *count) {
         return NULL;
     }
 
-    DIR *dir = opendir(root);
-    if (!dir) {
-        return NULL;
-    }
+    // One row per character directory (slot_id 0), from the index
+    IosSaveIndexEntry *entries = NULL;
+    int num_entries = ios_save_index_read(root, &entries);
 
-    // First pass: count characters
     int num_chars = 0;
-    struct dirent *entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        // Check if it's a directory
-        char char_path[512];
-        snprintf(char_path, sizeof(char_path), "%s/%s", root, entry->d_name);
-        struct stat st;
-        if (stat(char_path, &st) == 0 && S_ISDIR(st.st_mode)) {
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id == 0) {
             num_chars++;
         }
     }
 
     if (num_chars == 0) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
     // Allocate array of string pointers
     char **characters = malloc(num_chars * sizeof(char*));
     if (!characters) {
-        closedir(dir);
+        ios_save_index_release(entries);
         return NULL;
     }
 
-    // Second pass: collect character names
-    rewinddir(dir);
     int index = 0;
-
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        // Check if it's a directory
-        char char_path[512];
-        snprintf(char_path, sizeof(char_path), "%s/%s", root, entry->d_name);
-        struct stat st;
-        if (stat(char_path, &st) == 0 && S_ISDIR(st.st_mode)) {
-            // Allocate and copy character name
-            characters[index] = strdup(entry->d_name);
+    for (int i = 0; i < num_entries; i++) {
+        if (entries[i].slot_id == 0) {
+            characters[index] = strdup(entries[i].character);
             if (characters[index]) {
                 index++;
             }
         }
     }
 
-    closedir(dir);
+    ios_save_index_release(entries);
 
     *count = index;
     SLOT_LOG("Found %d characters", index);
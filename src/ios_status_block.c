@@ -0,0 +1,115 @@
+/*
+ * ios_status_block.c - Binary HUD status export (see ios_status_block.h)
+ *
+ * Values are read from u/flags directly rather than from the window port's
+ * parsed botl strings: publish runs on the game thread inside the status
+ * flush, so the globals are consistent, and gold needs no "$:" parsing.
+ */
+
+#include "ios_status_block.h"
+#include "hack.h"
+#include <stdatomic.h>
+#include <string.h>
+
+_Static_assert(sizeof(IOSStatusBlock) == 136, "IOSStatusBlock layout is ABI - append fields only");
+
+extern int game_started;
+
+static IOSStatusBlock staging;
+static IOSStatusBlock published;
+static _Atomic uint32_t block_seq = 0;
+
+void ios_status_block_publish(uint64_t conditions)
+{
+    IOSStatusBlock b;
+    memset(&b, 0, sizeof(b));
+    b.abi_version = IOS_STATUS_BLOCK_VERSION;
+    b.struct_size = (uint16_t)sizeof(IOSStatusBlock);
+
+    if (game_started && program_state.in_moveloop) {
+        b.hp = Upolyd ? u.mh : u.uhp;
+        b.hpmax = Upolyd ? u.mhmax : u.uhpmax;
+        b.pw = u.uen;
+        b.pwmax = u.uenmax;
+        b.level = u.ulevel;
+        b.ac = u.uac;
+        b.str = u.acurr.a[A_STR];
+        b.dex = u.acurr.a[A_DEX];
+        b.con = u.acurr.a[A_CON];
+        b.intel = u.acurr.a[A_INT];
+        b.wis = u.acurr.a[A_WIS];
+        b.cha = u.acurr.a[A_CHA];
+        b.exp = u.uexp;
+        b.gold = money_cnt(gi.invent);
+        b.moves = svm.moves;
+        b.conditions = conditions;
+
+        b.dungeon_level = u.uz.dlevel;
+        b.dungeon_number = u.uz.dnum;
+        b.depth = depth(&u.uz);
+        b.alignment = u.ualign.type;
+        b.alignment_record = u.ualign.record;
+        b.hunger = u.uhs;
+        b.encumbrance = near_capacity();
+        b.role = flags.initrole;
+        b.race = flags.initrace;
+        b.gender = flags.female;
+        b.polymorph_monster = Upolyd ? u.umonnum : -1;
+        b.flags = IOS_STATUS_IN_GAME | (Upolyd ? IOS_STATUS_POLYMORPHED : 0);
+    } else {
+        b.polymorph_monster = -1;
+    }
+
+    /* Writer owns staging: compare everything but the counter */
+    b.change_counter = staging.change_counter;
+    if (staging.abi_version && memcmp(&b, &staging, sizeof(b)) == 0) {
+        return;
+    }
+
+    uint32_t seq = atomic_load_explicit(&block_seq, memory_order_relaxed);
+    b.change_counter = seq / 2 + 1;
+    staging = b;
+
+    atomic_store_explicit(&block_seq, seq + 1, memory_order_relaxed);  /* odd: writing */
+    atomic_thread_fence(memory_order_release);
+
+    published = staging;  /* memcpy */
+
+    atomic_store_explicit(&block_seq, seq + 2, memory_order_release);  /* even: stable */
+}
+
+static uint32_t read_block(IOSStatusBlock *out)
+{
+    for (;;) {
+        uint32_t before = atomic_load_explicit(&block_seq, memory_order_acquire);
+        if (before & 1) {
+            continue;  /* Publish in progress - retry */
+        }
+
+        *out = published;  /* memcpy */
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&block_seq, memory_order_relaxed) == before) {
+            return before;
+        }
+    }
+}
+
+void ios_get_status_block(IOSStatusBlock *out)
+{
+    if (!out) return;
+    read_block(out);
+}
+
+bool ios_get_status_block_if_newer(IOSStatusBlock *out, uint32_t *counter)
+{
+    if (!out || !counter) return false;
+
+    uint32_t seq = atomic_load_explicit(&block_seq, memory_order_acquire);
+    if (seq / 2 == *counter) {
+        return false;
+    }
+
+    *counter = read_block(out) / 2;
+    return true;
+}
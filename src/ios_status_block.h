@@ -0,0 +1,87 @@
+/*
+ * ios_status_block.h - Binary HUD status export (replaces per-poll JSON)
+ *
+ * nethack_get_player_stats_json() formats JSON with snprintf on every HUD
+ * poll and Swift decodes it with JSONDecoder. The status block carries the
+ * same values as a fixed struct, published once per status flush
+ * (ios_status_update(BL_FLUSH)) with a change counter, so an unchanged HUD
+ * costs one atomic load and a changed one a 136-byte copy.
+ *
+ * ABI:
+ * - Fixed-width fields only, ordered so there is no padding; the size is
+ *   asserted. New fields go at the end and bump IOS_STATUS_BLOCK_VERSION.
+ * - Readers check abi_version and struct_size before trusting the rest.
+ *
+ * PUBLICATION: writer is the game thread; readers any thread (seqlock copy,
+ * same scheme as ios_game_state_buffer.c). change_counter only moves when
+ * a value changed.
+ */
+
+#ifndef IOS_STATUS_BLOCK_H
+#define IOS_STATUS_BLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IOS_STATUS_BLOCK_VERSION 1
+
+/* flags */
+#define IOS_STATUS_POLYMORPHED 0x1u
+#define IOS_STATUS_IN_GAME     0x2u
+
+typedef struct {
+    uint16_t abi_version;            /* IOS_STATUS_BLOCK_VERSION */
+    uint16_t struct_size;            /* sizeof(IOSStatusBlock) */
+    uint32_t change_counter;         /* 0 = never published */
+
+    /* Stats (nethack_get_player_stats_json fields) */
+    int32_t hp, hpmax;               /* Monster HP while polymorphed */
+    int32_t pw, pwmax;
+    int32_t level;
+    int32_t ac;
+    int32_t str, dex, con, intel, wis, cha;  /* u.acurr (str keeps the 18/xx encoding) */
+    int64_t exp;
+    int64_t gold;
+    int64_t moves;
+    uint64_t conditions;             /* BL_CONDITION bitmask */
+
+    /* Location and character */
+    int32_t dungeon_level;           /* u.uz.dlevel (as the JSON reported) */
+    int32_t dungeon_number;          /* u.uz.dnum */
+    int32_t depth;                   /* depth(&u.uz) */
+    int32_t alignment;               /* A_LAWFUL 1, A_NEUTRAL 0, A_CHAOTIC -1 */
+    int32_t alignment_record;        /* u.ualign.record */
+    int32_t hunger;                  /* u.uhs */
+    int32_t encumbrance;             /* near_capacity() */
+    int32_t role;                    /* flags.initrole */
+    int32_t race;                    /* flags.initrace */
+    int32_t gender;                  /* flags.female */
+    int32_t polymorph_monster;       /* u.umonnum while polymorphed, else -1 */
+    uint32_t flags;                  /* IOS_STATUS_* */
+} IOSStatusBlock;
+
+/*
+ * Publish the current values (game thread, from ios_status_update's
+ * BL_FLUSH). conditions is the BL_CONDITION mask the window port cached.
+ */
+void ios_status_block_publish(uint64_t conditions);
+
+/* Copy the published block (any thread, lock-free) */
+NETHACK_EXPORT void ios_get_status_block(IOSStatusBlock *out);
+
+/*
+ * Copy only if change_counter differs from *counter (0 = none); one atomic
+ * load when unchanged. Returns true when out was filled.
+ */
+NETHACK_EXPORT bool ios_get_status_block_if_newer(IOSStatusBlock *out, uint32_t *counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IOS_STATUS_BLOCK_H */
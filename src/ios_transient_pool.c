@@ -0,0 +1,232 @@
+/*
+ * ios_transient_pool.c - Slab pool with per-thread caches (see ios_transient_pool.h)
+ *
+ * Every block starts with a 16-byte header (magic + size class) so free()
+ * needs no size and a foreign or doubly freed pointer is caught. A free
+ * block's first payload word links it into a cache or depot list.
+ *
+ * Thread caches live in a malloc'd struct reached through a thread-local
+ * pointer; a pthread key destructor hands a dying thread's blocks back to
+ * the depot.
+ */
+
+#include "ios_transient_pool.h"
+#include "ios_log.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define POOL_MIN_SHIFT 5                 /* 32B smallest block (header included) */
+#define POOL_CLASSES 12                  /* 32B .. 64KB */
+#define POOL_SLAB_SIZE (256 * 1024)
+#define CACHE_LIMIT 32                   /* Blocks per class before spilling half */
+#define CACHE_BATCH 16                   /* Blocks moved per depot refill */
+
+#define BLOCK_MAGIC 0x4C4F4F50u          /* "POOL" */
+#define BLOCK_FREED 0x45455246u          /* "FREE" */
+#define LARGE_CLASS 0xFFFFu
+
+typedef struct {
+    uint32_t magic;
+    uint16_t size_class;                 /* LARGE_CLASS: malloc'd */
+    uint16_t reserved;
+    uint64_t reserved2;                  /* Keeps the payload 16-byte aligned */
+} BlockHeader;
+
+typedef struct FreeBlock {
+    BlockHeader header;
+    struct FreeBlock *next;
+} FreeBlock;
+
+typedef struct {
+    FreeBlock *head;
+    uint32_t count;
+} FreeList;
+
+typedef struct {
+    FreeList lists[POOL_CLASSES];
+} ThreadCache;
+
+static pthread_mutex_t depot_lock = PTHREAD_MUTEX_INITIALIZER;
+static FreeList depot[POOL_CLASSES];
+
+static pthread_key_t cache_key;
+static pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local ThreadCache *thread_cache = NULL;
+
+static _Atomic uint64_t stat_allocations;
+static _Atomic uint64_t stat_refills;
+static _Atomic uint64_t stat_large;
+static _Atomic uint32_t stat_slabs;
+static _Atomic int32_t stat_live;
+
+static inline size_t class_size(unsigned c) {
+    return (size_t)1 << (c + POOL_MIN_SHIFT);
+}
+
+/* Smallest class holding size payload bytes; POOL_CLASSES if none */
+static inline unsigned class_for(size_t size) {
+    size_t total = size + sizeof(BlockHeader);
+    if (total <= class_size(0)) return 0;
+    unsigned log2 = 64 - (unsigned)__builtin_clzll((unsigned long long)(total - 1));
+    return log2 - POOL_MIN_SHIFT;
+}
+
+/* Move up to n blocks from src to dst */
+static void move_blocks(FreeList *dst, FreeList *src, uint32_t n) {
+    while (n-- && src->head) {
+        FreeBlock *b = src->head;
+        src->head = b->next;
+        src->count--;
+        b->next = dst->head;
+        dst->head = b;
+        dst->count++;
+    }
+}
+
+/* Depot lock held: map a slab and carve it into class c blocks */
+static int carve_slab(unsigned c) {
+    uint8_t *slab = mmap(NULL, POOL_SLAB_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (slab == MAP_FAILED) {
+        IOS_LOG_E(IOS_LOG_CAT_MEMORY, "[TRANSIENT] Cannot map slab for %zu byte blocks",
+                  class_size(c));
+        return 0;
+    }
+    size_t size = class_size(c);
+    for (size_t off = 0; off + size <= POOL_SLAB_SIZE; off += size) {
+        FreeBlock *b = (FreeBlock *)(slab + off);
+        b->header.size_class = (uint16_t)c;
+        b->header.magic = BLOCK_FREED;
+        b->next = depot[c].head;
+        depot[c].head = b;
+        depot[c].count++;
+    }
+    atomic_fetch_add_explicit(&stat_slabs, 1, memory_order_relaxed);
+    return 1;
+}
+
+static void release_cache(void *value) {
+    ThreadCache *cache = value;
+    pthread_mutex_lock(&depot_lock);
+    for (unsigned c = 0; c < POOL_CLASSES; c++) {
+        move_blocks(&depot[c], &cache->lists[c], UINT32_MAX);
+    }
+    pthread_mutex_unlock(&depot_lock);
+    free(cache);
+}
+
+static void create_cache_key(void) {
+    pthread_key_create(&cache_key, release_cache);
+}
+
+static ThreadCache *get_cache(void) {
+    if (thread_cache) return thread_cache;
+
+    pthread_once(&cache_key_once, create_cache_key);
+    thread_cache = calloc(1, sizeof(ThreadCache));
+    if (thread_cache) pthread_setspecific(cache_key, thread_cache);
+    return thread_cache;
+}
+
+void *ios_transient_alloc(size_t size) {
+    atomic_fetch_add_explicit(&stat_allocations, 1, memory_order_relaxed);
+
+    unsigned c = class_for(size);
+    ThreadCache *cache = c < POOL_CLASSES ? get_cache() : NULL;
+    if (!cache) {
+        atomic_fetch_add_explicit(&stat_large, 1, memory_order_relaxed);
+        BlockHeader *h = malloc(sizeof(BlockHeader) + size);
+        if (!h) return NULL;
+        h->magic = BLOCK_MAGIC;
+        h->size_class = LARGE_CLASS;
+        return h + 1;
+    }
+
+    FreeList *list = &cache->lists[c];
+    if (!list->head) {
+        atomic_fetch_add_explicit(&stat_refills, 1, memory_order_relaxed);
+        pthread_mutex_lock(&depot_lock);
+        if (depot[c].head || carve_slab(c)) {
+            move_blocks(list, &depot[c], CACHE_BATCH);
+        }
+        pthread_mutex_unlock(&depot_lock);
+        if (!list->head) return NULL;
+    }
+
+    FreeBlock *b = list->head;
+    list->head = b->next;
+    list->count--;
+    b->header.magic = BLOCK_MAGIC;
+    atomic_fetch_add_explicit(&stat_live, 1, memory_order_relaxed);
+    return &b->header + 1;
+}
+
+void *ios_transient_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void *p = ios_transient_alloc(count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+char *ios_transient_strdup(const char *string) {
+    if (!string) return NULL;
+    size_t len = strlen(string) + 1;
+    char *copy = ios_transient_alloc(len);
+    if (copy) memcpy(copy, string, len);
+    return copy;
+}
+
+void ios_transient_free(void *ptr) {
+    if (!ptr) return;
+
+    BlockHeader *h = (BlockHeader *)ptr - 1;
+    if (h->magic != BLOCK_MAGIC) {
+        IOS_LOG_E(IOS_LOG_CAT_MEMORY, "[TRANSIENT] Bad free of %p (%s)", ptr,
+                  h->magic == BLOCK_FREED ? "double free" : "not a pool block");
+        return;
+    }
+    if (h->size_class == LARGE_CLASS) {
+        h->magic = BLOCK_FREED;
+        free(h);
+        return;
+    }
+
+    unsigned c = h->size_class;
+    FreeBlock *b = (FreeBlock *)h;
+    b->header.magic = BLOCK_FREED;
+    atomic_fetch_sub_explicit(&stat_live, 1, memory_order_relaxed);
+
+    ThreadCache *cache = get_cache();
+    if (!cache) {
+        pthread_mutex_lock(&depot_lock);
+        b->next = depot[c].head;
+        depot[c].head = b;
+        depot[c].count++;
+        pthread_mutex_unlock(&depot_lock);
+        return;
+    }
+
+    FreeList *list = &cache->lists[c];
+    b->next = list->head;
+    list->head = b;
+    list->count++;
+    if (list->count > CACHE_LIMIT) {
+        pthread_mutex_lock(&depot_lock);
+        move_blocks(&depot[c], list, CACHE_LIMIT / 2);
+        pthread_mutex_unlock(&depot_lock);
+    }
+}
+
+NETHACK_EXPORT void ios_transient_pool_get_stats(TransientPoolStats *out) {
+    if (!out) return;
+    out->allocations = atomic_load_explicit(&stat_allocations, memory_order_relaxed);
+    out->depot_refills = atomic_load_explicit(&stat_refills, memory_order_relaxed);
+    out->large_allocations = atomic_load_explicit(&stat_large, memory_order_relaxed);
+    out->slabs = atomic_load_explicit(&stat_slabs, memory_order_relaxed);
+    int32_t live = atomic_load_explicit(&stat_live, memory_order_relaxed);
+    out->live_blocks = live > 0 ? (uint32_t)live : 0;
+    out->reserved_bytes = (size_t)out->slabs * POOL_SLAB_SIZE;
+}
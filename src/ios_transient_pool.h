@@ -0,0 +1,47 @@
+/*
+ * ios_transient_pool.h - Pool for short-lived bridge result buffers
+ *
+ * Bridge calls that hand Swift a buffer to free later (inventory names,
+ * container contents) allocate here instead of from malloc, so their churn
+ * never mixes with NetHack's allocation stream or the snapshot-critical
+ * static heap.
+ *
+ * Design:
+ * - Power-of-two size classes from 32B to 64KB, carved from 256KB slabs
+ *   mapped directly (not from malloc or the NetHack heap)
+ * - Per-thread caches of free blocks: steady-state alloc/free touches no
+ *   lock. Caches refill from / spill to a shared depot in batches.
+ * - Any thread may free a block from any other thread (game thread
+ *   allocates, Swift's main thread frees)
+ * - Requests above 64KB fall back to malloc
+ *
+ * Slabs are never returned to the system; the pool's size is the peak of
+ * outstanding bridge buffers, which is small.
+ */
+
+#ifndef IOS_TRANSIENT_POOL_H
+#define IOS_TRANSIENT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nethack_export.h"
+
+void *ios_transient_alloc(size_t size);
+void *ios_transient_calloc(size_t count, size_t size);
+char *ios_transient_strdup(const char *string);
+
+/* Free a block from ios_transient_*; NULL is ignored */
+void ios_transient_free(void *ptr);
+
+typedef struct {
+    uint64_t allocations;     /* Total ios_transient_alloc calls */
+    uint64_t depot_refills;   /* Cache misses that took the depot lock */
+    uint64_t large_allocations;
+    uint32_t slabs;
+    uint32_t live_blocks;     /* Outstanding pooled blocks */
+    size_t reserved_bytes;    /* Slab memory mapped */
+} TransientPoolStats;
+
+NETHACK_EXPORT void ios_transient_pool_get_stats(TransientPoolStats *out);
+
+#endif /* IOS_TRANSIENT_POOL_H */
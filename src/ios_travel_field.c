@@ -0,0 +1,130 @@
+/*
+ * ios_travel_field.c - Distance field from the hero (see ios_travel_field.h)
+ *
+ * Plain BFS with a fixed-size queue (every cell is enqueued at most once).
+ * The neighbour test mirrors findtravelpath()'s guess-free pass: a step
+ * must pass test_move(TEST_TRAV) and land on a cell the hero has seen or
+ * can see right now. Rebuilds clear the stale flag before searching, so an
+ * invalidate that races a rebuild is never lost.
+ */
+
+#include "ios_travel_field.h"
+#include "../NetHack/include/hack.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+_Static_assert(IOS_TRAVEL_FIELD_COLS == COLNO && IOS_TRAVEL_FIELD_ROWS == ROWNO,
+               "travel field grid must match the NetHack map");
+
+extern int game_started;
+extern int player_has_died;
+
+/* Same order as NetHack's xdir/ydir */
+static const int8_t dir_dx[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+static const int8_t dir_dy[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+
+static pthread_mutex_t field_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool stale = true;
+static IOSTravelField field = { .hero_x = -1, .hero_y = -1 };
+static xint16 field_ledger = -1;
+
+void ios_travel_field_invalidate(void)
+{
+    atomic_store(&stale, true);
+}
+
+static int opposite(int dir)
+{
+    return (dir + 4) & 7;
+}
+
+static void rebuild(void)
+{
+    static IOSTravelPoint queue[ROWNO * COLNO];
+
+    memset(field.distance, 0xFF, sizeof(field.distance));
+    memset(field.toward_hero, IOS_TRAVEL_NO_STEP, sizeof(field.toward_hero));
+    field.generation++;
+    field.hero_x = field.hero_y = -1;
+    field_ledger = -1;
+
+    if (!game_started || player_has_died || !isok(u.ux, u.uy)) return;
+
+    field.hero_x = u.ux;
+    field.hero_y = u.uy;
+    field_ledger = ledger_no(&u.uz);
+
+    int head = 0, tail = 0;
+    field.distance[u.uy][u.ux] = 0;
+    queue[tail++] = (IOSTravelPoint){ u.ux, u.uy };
+
+    while (head < tail) {
+        IOSTravelPoint c = queue[head++];
+        uint16_t next = field.distance[c.y][c.x] + 1;
+
+        for (int dir = 0; dir < 8; dir++) {
+            int nx = c.x + dir_dx[dir], ny = c.y + dir_dy[dir];
+            if (!isok(nx, ny) || field.distance[ny][nx] != IOS_TRAVEL_UNREACHABLE) continue;
+            if (!levl[nx][ny].seenv && (Blind || !couldsee(nx, ny))) continue;
+            if (!test_move(c.x, c.y, nx - c.x, ny - c.y, TEST_TRAV)) continue;
+
+            field.distance[ny][nx] = next;
+            field.toward_hero[ny][nx] = (uint8_t)opposite(dir);
+            queue[tail++] = (IOSTravelPoint){ (int16_t)nx, (int16_t)ny };
+        }
+    }
+}
+
+/* Take the mutex with a field that matches the hero's current position */
+static void lock_current(void)
+{
+    pthread_mutex_lock(&field_mutex);
+    bool moved = field.hero_x != u.ux || field.hero_y != u.uy || field_ledger != ledger_no(&u.uz);
+    if (atomic_exchange(&stale, false) || moved) {
+        rebuild();
+    }
+}
+
+int ios_copy_travel_field(IOSTravelField *out)
+{
+    if (!out) return 0;
+    lock_current();
+    *out = field;
+    pthread_mutex_unlock(&field_mutex);
+    return out->hero_x >= 0;
+}
+
+int ios_travel_distance(int x, int y)
+{
+    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) return -1;
+    lock_current();
+    uint16_t d = field.distance[y][x];
+    pthread_mutex_unlock(&field_mutex);
+    return d == IOS_TRAVEL_UNREACHABLE ? -1 : d;
+}
+
+int ios_travel_path(int x, int y, IOSTravelPoint *out, int max)
+{
+    if (x < 0 || x >= COLNO || y < 0 || y >= ROWNO) return -1;
+    lock_current();
+
+    int length = field.distance[y][x];
+    if (length == IOS_TRAVEL_UNREACHABLE) {
+        pthread_mutex_unlock(&field_mutex);
+        return -1;
+    }
+
+    /* Walk back from the target; cell at distance d goes to out[d - 1] */
+    int cx = x, cy = y;
+    for (int d = length; d > 0; d--) {
+        if (out && d <= max) out[d - 1] = (IOSTravelPoint){ (int16_t)cx, (int16_t)cy };
+        int dir = field.toward_hero[cy][cx];
+        cx += dir_dx[dir];
+        cy += dir_dy[dir];
+    }
+
+    pthread_mutex_unlock(&field_mutex);
+    return length;
+}
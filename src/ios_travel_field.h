@@ -0,0 +1,70 @@
+/*
+ * ios_travel_field.h - Distance field from the hero over the known map
+ *
+ * Tap-to-travel and the stairs/altar/fountain shortcuts queue NetHack's
+ * travel command and let findtravelpath() decide. To preview a path, or
+ * to gray out a tap that cannot be reached, the UI needs the answer
+ * without moving. This module runs one breadth-first search from the
+ * hero using the same step test travel uses (test_move TEST_TRAV over
+ * seen or currently visible cells) and keeps, per cell:
+ *
+ *   - distance in moves from the hero (IOS_TRAVEL_UNREACHABLE if none)
+ *   - direction of the next step back toward the hero, so a path is the
+ *     chain of those steps from the target
+ *
+ * UPDATES: the field is marked stale when a map cell shows a new glyph
+ * (terrain, doors, newly seen cells), on map clear and on new game, and
+ * a query from another hero position rebuilds it too. The first query
+ * after that rebuilds it; queries in between (drag samples while the game
+ * waits) reuse it, and turns nobody asks cost nothing.
+ *
+ * Coordinates are NetHack's (x 1-79, y 0-20). Distances ignore monsters,
+ * like travel's own first pass; they are a preview, not a promise.
+ *
+ * THREAD SAFETY: queries and rebuilds hold the field mutex. Queries are
+ * for when the game thread is parked in an input wait.
+ */
+
+#ifndef IOS_TRAVEL_FIELD_H
+#define IOS_TRAVEL_FIELD_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+
+#define IOS_TRAVEL_FIELD_COLS 80
+#define IOS_TRAVEL_FIELD_ROWS 21
+
+#define IOS_TRAVEL_UNREACHABLE 0xFFFF
+#define IOS_TRAVEL_NO_STEP     0xFF
+
+typedef struct {
+    uint32_t generation;        /* Bumped by every rebuild */
+    int16_t hero_x;             /* Field origin (-1 when no game) */
+    int16_t hero_y;
+    uint16_t distance[IOS_TRAVEL_FIELD_ROWS][IOS_TRAVEL_FIELD_COLS];  /* [y][x] */
+    /* Direction index 0-7 (xdir/ydir order) of the step toward the hero */
+    uint8_t toward_hero[IOS_TRAVEL_FIELD_ROWS][IOS_TRAVEL_FIELD_COLS];
+} IOSTravelField;
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} IOSTravelPoint;
+
+/* Mark the field stale: rebuilt on the next query */
+void ios_travel_field_invalidate(void);
+
+/* Whole field; 1 if filled (hero on a level), 0 otherwise */
+NETHACK_EXPORT int ios_copy_travel_field(IOSTravelField *out);
+
+/* Moves from the hero to (x, y); -1 if unreachable or off the map */
+NETHACK_EXPORT int ios_travel_distance(int x, int y);
+
+/*
+ * Path from the hero to (x, y): the cells stepped on, target last (hero
+ * excluded). Returns the full path length - possibly more than max - or
+ * -1 if unreachable.
+ */
+NETHACK_EXPORT int ios_travel_path(int x, int y, IOSTravelPoint *out, int max);
+
+#endif /* IOS_TRAVEL_FIELD_H */
@@ -0,0 +1,63 @@
+/*
+ * ios_travel_steps.c - Hero path ring (see ios_travel_steps.h)
+ */
+
+#include "ios_travel_steps.h"
+#include <stdatomic.h>
+#include <time.h>
+
+#define STEP_MASK (IOS_TRAVEL_STEPS_SIZE - 1)
+
+static IOSTravelStep steps[IOS_TRAVEL_STEPS_SIZE];
+static _Atomic uint32_t step_head = 0;     /* Next slot the consumer reads */
+static _Atomic uint32_t step_tail = 0;     /* Next slot the producer writes */
+static _Atomic uint32_t step_dropped = 0;
+
+void ios_travel_steps_push(int x, int y, int64_t turn)
+{
+    uint32_t tail = atomic_load_explicit(&step_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&step_head, memory_order_acquire);
+    if (tail - head >= IOS_TRAVEL_STEPS_SIZE) {
+        atomic_fetch_add_explicit(&step_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    IOSTravelStep *s = &steps[tail & STEP_MASK];
+    s->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    s->turn = turn;
+    s->x = (int16_t)x;
+    s->y = (int16_t)y;
+    s->reserved = 0;
+    atomic_store_explicit(&step_tail, tail + 1, memory_order_release);
+}
+
+uint32_t ios_travel_steps_drain(IOSTravelStep *out, uint32_t max)
+{
+    if (!out || max == 0) return 0;
+
+    uint32_t head = atomic_load_explicit(&step_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&step_tail, memory_order_acquire);
+    uint32_t count = tail - head;
+    if (count > max) count = max;
+
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = steps[(head + i) & STEP_MASK];
+    }
+    atomic_store_explicit(&step_head, head + count, memory_order_release);
+    return count;
+}
+
+uint32_t ios_travel_steps_dropped(void)
+{
+    return atomic_load_explicit(&step_dropped, memory_order_relaxed);
+}
+
+void ios_travel_steps_clear(void)
+{
+    /* Consumer-side reset: everything the producer published so far */
+    atomic_store_explicit(&step_head, atomic_load_explicit(&step_tail, memory_order_acquire),
+                          memory_order_release);
+}
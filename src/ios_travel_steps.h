@@ -0,0 +1,45 @@
+/*
+ * ios_travel_steps.h - Timestamped hero path for travel/run animation
+ *
+ * ios_delay_output() used to pace travel on the game thread: guess the UI
+ * frame rate from dispatch timings, then usleep 5-40ms per step. Now the
+ * engine runs travel at full speed and records each intermediate hero
+ * position here; the renderer (TravelAnimator.swift) replays the path one
+ * step per display refresh at the chosen animation speed. Map deltas still
+ * go through the render queue; only the hero's path is replayed.
+ *
+ * THREAD SAFETY: single producer (game thread), single consumer (main
+ * thread). Head/tail are atomics; a full ring drops new steps and counts
+ * them, and the renderer then snaps to the final position.
+ */
+
+#ifndef IOS_TRAVEL_STEPS_H
+#define IOS_TRAVEL_STEPS_H
+
+#include <stdint.h>
+#include "nethack_export.h"
+
+/* Steps held between two drains - MUST be power of 2 */
+#define IOS_TRAVEL_STEPS_SIZE 512
+
+typedef struct {
+    uint64_t timestamp_ns;      /* CLOCK_MONOTONIC when the engine took the step */
+    int64_t turn;               /* svm.moves at that step */
+    int16_t x;                  /* NetHack coordinates (same as print_glyph) */
+    int16_t y;
+    uint32_t reserved;
+} IOSTravelStep;
+
+/* Game thread: hero stood at (x, y) for this delay_output() frame */
+void ios_travel_steps_push(int x, int y, int64_t turn);
+
+/* Main thread: move up to max queued steps into out, oldest first */
+NETHACK_EXPORT uint32_t ios_travel_steps_drain(IOSTravelStep *out, uint32_t max);
+
+/* Steps dropped because the ring was full (since start) */
+NETHACK_EXPORT uint32_t ios_travel_steps_dropped(void);
+
+/* Main thread: discard queued steps (new game) */
+NETHACK_EXPORT void ios_travel_steps_clear(void);
+
+#endif /* IOS_TRAVEL_STEPS_H */
@@ -38,19 +38,7 @@
                     WC2_PERM_INVENT | WC2_MOUSE_STATUS | \
                     WC2_HOTSPOT_MAP | WC2_PETATTR)
 
-/* Message History for iOS */
-#define IOS_MSG_HISTORY_SIZE 100
-
-typedef struct ios_message_history {
-    char messages[IOS_MSG_HISTORY_SIZE][BUFSZ];
-    int head;
-    int count;
-} ios_message_history;
-
-/* Global message history */
-extern ios_message_history ios_msg_hist;
-
-/* Message history functions */
+/* Message History for iOS (views over ios_message_log.h) */
 void ios_add_message(const char *msg);
 const char* ios_get_message_history(int index);
 int ios_message_count(void);
@@ -10,6 +10,26 @@
 #include "../NetHack/include/func_tab.h"  /* For extcmds_match, ECM_* */
 #include "../NetHack/include/winprocs.h" /* For WC_ constants */
 #include "ios_render_queue.h" /* PHASE 1: Lock-free render queue */
+#include "ios_map_export.h"   /* Binary map export (seqlock) */
+#include "ios_glyph_table.h"  /* Glyph -> ch/color/tile class table */
+#include "ios_log.h"          /* Ring logging for draw/input hot paths */
+#include "ios_frame_timing.h" /* Per-stage turn latency histograms */
+#include "ios_input_ring.h"   /* Lock-free key ring from Swift */
+#include "ios_inventory_cache.h" /* Inventory export invalidation */
+#include "ios_status_block.h"    /* Binary HUD status export */
+#include "ios_game_step.h"       /* Stepped (coroutine) game loop */
+#include "ios_headless.h"         /* Rendering/pacing off for bots and soak runs */
+#include "ios_travel_steps.h"     /* Hero path for display-paced travel */
+#include "ios_object_index.h"     /* Floor object index invalidation */
+#include "ios_kill_stats.h"       /* Incremental vanquished/discovery stats */
+#include "ios_lookat_cache.h"     /* Farlook result invalidation */
+#include "ios_travel_field.h"     /* Travel distance field invalidation */
+#include "ios_input_journal.h"    /* Input recording and replay */
+#include "ios_event_bus.h"        /* One batched UI wake-up per turn */
+#include "ios_memory_pressure.h"  /* Deferred memory-warning purges */
+#include "ios_hibernate.h"        /* Hibernation capture and autosave at command prompts */
+#include "ios_action_macro.h"     /* Multi-step macros run at command prompts */
+#include "ios_dungeon_overview.h" /* Visited-level records updated at command prompts */
 #include "ios_wincap.h"
 #include "ios_yn_callback.h"
 #include <ctype.h> /* For isprint() */
@@ -66,6 +86,21 @@ typedef struct {
 
 static PlayerStats current_stats = {0};
 
+/* STATUS_FIELD_* bits botl changed since the last push to the render queue.
+ * Fields arrive one ios_status_update call at a time; BL_FLUSH publishes
+ * them as one StatusUpdate, and not at all when nothing changed. */
+static uint32_t status_changed = STATUS_FIELD_ALL;
+
+/* Store a parsed status value, noting the field if it moved */
+#define STATUS_SET(field, bit, value)                                          \
+  do {                                                                         \
+    __typeof__(current_stats.field) status_value_ = (value);                   \
+    if (current_stats.field != status_value_) {                                \
+      current_stats.field = status_value_;                                     \
+      status_changed |= (bit);                                                 \
+    }                                                                          \
+  } while (0)
+
 /* Getter for current_stats.conditions - used by RealNetHackBridge.c */
 unsigned long ios_get_current_conditions(void) {
     return current_stats.conditions;
@@ -110,27 +145,12 @@ static void safe_append_to_output(const char *str) {
   strcat(output_buffer, str);
 }
 
-/* Forward declarations for map functions */
-extern void ios_swift_map_update_callback(void);
-
-/* Death animation callback - registered by Swift at startup */
-typedef void (*DeathAnimationCallback)(void);
-static DeathAnimationCallback death_animation_callback = NULL;
-
-/* Register death animation callback from Swift */
-NETHACK_EXPORT void ios_set_death_animation_callback(DeathAnimationCallback callback) {
-    death_animation_callback = callback;
-    fprintf(stderr, "[DEATH] Death animation callback registered: %p\n", (void*)callback);
-}
-
-/* Call death animation callback (if registered) */
+/* Start the Swift death animation now, in parallel with death data
+ * collection: the event is flushed instead of waiting for the next input */
 static void trigger_death_animation(void) {
-    if (death_animation_callback) {
-        fprintf(stderr, "[DEATH] ☠️ TRIGGERING SWIFT DEATH ANIMATION\n");
-        death_animation_callback();
-    } else {
-        fprintf(stderr, "[DEATH] ⚠️ No death animation callback registered\n");
-    }
+    fprintf(stderr, "[DEATH] ☠️ TRIGGERING SWIFT DEATH ANIMATION\n");
+    ios_event_post(IOS_EVENT_DEATH);
+    ios_event_bus_flush();
 }
 
 /* Window handles */
@@ -142,17 +162,13 @@ static winid text_win = 5;
 
 /* Menu system state - must be declared early for destroy_nhwindow */
 #define MAX_MENU_ITEMS 256
-#define MAX_MENU_TEXT 256
 static MENU_ITEM_P menu_items[MAX_MENU_ITEMS]; // Storage for menu selections
-static char menu_selectors[MAX_MENU_ITEMS];    // Selector characters for each menu item
-static char menu_texts[MAX_MENU_ITEMS][MAX_MENU_TEXT];  // Store menu item text for Swift
-static int menu_glyphs[MAX_MENU_ITEMS];        // Store glyph IDs for Swift
-static int menu_attributes[MAX_MENU_ITEMS];    // Store ATR_* attributes for Swift
-static unsigned int menu_itemflags[MAX_MENU_ITEMS];  // Store itemflags for Swift
-static int menu_item_count = 0;
+// Arena-backed menu store: add_menu writes items and text straight into the
+// context handed to Swift, start_menu resets it by rewinding the counters
+static IOSMenuContext menu_store;
+// (prompt is also used for tutorial detection)
 static winid current_menu_win = 0;
 static boolean menu_is_active = FALSE;
-static char last_menu_prompt[256] = {0}; // Store last menu prompt for tutorial detection
 
 /* Menu callback system - for Swift UI integration */
 static IOSMenuCallback swift_menu_callback = NULL;
@@ -164,17 +180,47 @@ static int menu_response_count = -1;  // -1 = waiting, 0+ = got response
 static pthread_mutex_t menu_response_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t menu_response_cond = PTHREAD_COND_INITIALIZER;
 
-/* Input queue for commands from iOS */
-#define INPUT_QUEUE_SIZE 256
-static char input_queue[INPUT_QUEUE_SIZE];
-static int input_queue_head = 0;
-static int input_queue_tail = 0;
-
-/* Thread synchronization for input */
-static pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t input_cond = PTHREAD_COND_INITIALIZER;
+/* Input from iOS: lock-free key ring (ios_input_ring.h), game thread consumes */
 volatile int game_thread_running = 0; /* Made global for RealNetHackBridge.c */
 
+/* Keys taken as of the last input wait (UINT64_MAX: a game just started) */
+static uint64_t keys_at_last_wait = UINT64_MAX;
+
+/* Every input wait goes through here: threaded mode parks on the ring,
+ * stepped mode (ios_game_step.h) hands control back to the host instead.
+ * Callers loop here until a key arrives (poskey every 10 ms), so the game
+ * only ran since the last call if a key was taken in between. Then the
+ * command may have moved objects or killed monsters: the floor index,
+ * kill stats and farlook cache refresh on the next query made while we
+ * are parked, and a stale inventory export is rebuilt right here. Polls
+ * of the same wait keep them. This is the turn boundary:
+ * everything the command posted to the event bus reaches Swift as one
+ * batch, and memory-warning purges and hibernation captures deferred
+ * while the command ran happen here. An action macro step that still
+ * needs keys here has hit a prompt. */
+static void wait_for_input(uint32_t timeout_ms) {
+  if (ios_is_replaying()) {
+    ios_replay_stall();  /* The journal has no key for this wait */
+  }
+  ios_event_bus_flush();
+  ios_memory_pressure_poll();
+  ios_hibernate_poll();
+  ios_action_macro_input_wait();
+  uint64_t taken = ios_input_ring_taken();
+  if (taken != keys_at_last_wait) {
+    keys_at_last_wait = taken;
+    ios_object_index_invalidate();
+    ios_kill_stats_invalidate();
+    ios_lookat_cache_note_command();
+    ios_inventory_cache_refresh();  // Names built here, not on reader threads
+  }
+  if (ios_game_step_active()) {
+    ios_game_step_wait_input();
+    return;
+  }
+  ios_input_ring_wait(&game_thread_running, timeout_ms);
+}
+
 /* Mode selection flag - 0 = old mode, 1 = threaded mode */
 int use_threaded_mode = 0; /* Made global for RealNetHackBridge.c */
 
@@ -267,12 +313,372 @@ typedef struct {
   char ch;             // ASCII character
   unsigned char color; // Color index
   unsigned char bg;    // Background color
+  unsigned int glyphflags; // MG_PET, MG_RIDDEN, MG_DETECT etc.
 } MapCell;
 
 MapCell map_cells[MAX_MAP_HEIGHT][MAX_MAP_WIDTH]; // Full map data
 int actual_map_width = DEFAULT_MAP_WIDTH;         // Runtime-adjustable width
 int actual_map_height = DEFAULT_MAP_HEIGHT;       // Runtime-adjustable height
 
+/*
+ * === GLYPH DELTA COALESCING ===
+ *
+ * print_glyph() only marks cells dirty (NetHack coordinates). The dirty set
+ * is flushed as ONE UPDATE_GLYPH_BATCH at the display sync points
+ * (wait_synch, delay_output, display_nhwindow), reading the latest values
+ * from map_cells. A full docrt() therefore costs one queue slot instead of
+ * ~1,700, and a cell drawn several times per turn is sent once.
+ *
+ * If the queue is full the bits simply stay set and go out with the next
+ * flush - updates are delayed, never lost.
+ */
+#define MAP_DIRTY_WORDS ((COLNO + 63) / 64)
+static uint64_t map_dirty_bits[ROWNO][MAP_DIRTY_WORDS];
+static int map_dirty_cells = 0;
+static uint32_t map_generation = 0; // Bumped on every published batch
+
+/*
+ * === BINARY MAP EXPORT ===
+ *
+ * Packed NetHack-coordinate copy of map_cells for zero-copy Swift reads
+ * (see ios_map_export.h). Rows touched since the last sync point are
+ * republished under the seqlock together with the glyph batch flush.
+ */
+#define MAP_EXPORT_ALL_ROWS ((1u << MAP_EXPORT_HEIGHT) - 1)
+_Static_assert(MAP_EXPORT_WIDTH == COLNO && MAP_EXPORT_HEIGHT == ROWNO,
+               "MapExport dimensions must match COLNO x ROWNO");
+static MapExport map_export = {.width = MAP_EXPORT_WIDTH,
+                               .height = MAP_EXPORT_HEIGHT};
+static _Atomic uint32_t map_export_seq = 0;  // Seqlock: odd while publishing
+static uint32_t map_export_pending_rows = 0; // Bit y = row y needs publishing
+
+static inline void mark_cell_dirty(int x, int y) {
+  map_export_pending_rows |= 1u << y;
+
+  uint64_t bit = 1ULL << (x & 63);
+  uint64_t *word = &map_dirty_bits[y][x >> 6];
+  if (!(*word & bit)) {
+    *word |= bit;
+    map_dirty_cells++;
+  }
+}
+
+static void discard_dirty_cells(void) {
+  memset(map_dirty_bits, 0, sizeof(map_dirty_bits));
+  map_dirty_cells = 0;
+}
+
+/* Republish pending rows of the binary map export (game thread) */
+static void publish_map_export(void) {
+  uint32_t rows = map_export_pending_rows;
+  if (rows == 0)
+    return;
+
+  uint32_t seq = atomic_load_explicit(&map_export_seq, memory_order_relaxed);
+  atomic_store_explicit(&map_export_seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  uint32_t version = map_export.version + 1;
+  for (uint32_t bits = rows; bits; bits &= bits - 1) {
+    int y = __builtin_ctz(bits);
+    const MapCell *src = map_cells[map_y_to_buffer_y(y)];
+    PackedMapCell *dst = map_export.cells[y];
+    for (int x = 0; x < MAP_EXPORT_WIDTH; x++) {
+      dst[x] = (PackedMapCell){.glyph = src[x].glyph,
+                               .ch = src[x].ch,
+                               .color = src[x].color,
+                               .bg = src[x].bg,
+                               .glyphflags = src[x].glyphflags};
+    }
+    map_export.row_version[y] = version;
+  }
+  map_export.version = version;
+  map_export.last_dirty_rows = rows;
+
+  atomic_store_explicit(&map_export_seq, seq + 2, memory_order_release);
+  map_export_pending_rows = 0;
+}
+
+/* Publish all dirty cells as one batch (game thread) */
+static void flush_glyph_deltas(void) {
+  static MapUpdate staging[RENDER_GLYPH_BATCH_MAX];
+  uint32_t count = 0;
+
+  // Binary export rides the same sync points as the render queue
+  publish_map_export();
+
+  if (!g_render_queue || map_dirty_cells == 0)
+    return;
+
+  for (int y = 0; y < ROWNO; y++) {
+    for (int w = 0; w < MAP_DIRTY_WORDS; w++) {
+      uint64_t bits = map_dirty_bits[y][w];
+      while (bits) {
+        int x = (w << 6) + __builtin_ctzll(bits);
+        const MapCell *cell = &map_cells[map_y_to_buffer_y(y)][x];
+        staging[count++] = (MapUpdate){.x = x, // NetHack coordinates
+                                       .y = y,
+                                       .glyph = cell->glyph,
+                                       .ch = cell->ch,
+                                       .color = cell->color,
+                                       .glyphflags = cell->glyphflags};
+        bits &= bits - 1;
+      }
+    }
+  }
+
+  // Keep the cells dirty on failure - next sync point retries
+  if (render_queue_enqueue_glyph_batch(g_render_queue, staging, count,
+                                       map_generation + 1)) {
+    map_generation++;
+    discard_dirty_cells();
+  }
+}
+
+/* Current map generation (number of glyph batches published) */
+NETHACK_EXPORT uint32_t ios_get_map_generation(void) { return map_generation; }
+
+/* === Binary map export readers (any thread) === */
+
+NETHACK_EXPORT const MapExport *ios_map_export_get(void) { return &map_export; }
+
+NETHACK_EXPORT uint32_t ios_map_export_begin_read(void) {
+  uint32_t seq;
+  // Publishes are a few rows of memcpy - spin them out
+  while ((seq = atomic_load_explicit(&map_export_seq, memory_order_acquire)) & 1)
+    ;
+  return seq;
+}
+
+NETHACK_EXPORT bool ios_map_export_end_read(uint32_t seq) {
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&map_export_seq, memory_order_relaxed) == seq;
+}
+
+NETHACK_EXPORT uint32_t ios_map_export_dirty_rows(uint32_t since_version) {
+  // Version ahead of ours = caller saw a previous dylib load - resend all
+  if (since_version > map_export.version)
+    since_version = 0;
+
+  uint32_t mask = 0;
+  for (int y = 0; y < MAP_EXPORT_HEIGHT; y++) {
+    if (map_export.row_version[y] > since_version)
+      mask |= 1u << y;
+  }
+  return mask;
+}
+
+NETHACK_EXPORT uint32_t
+ios_map_export_copy_changed(PackedMapCell out[MAP_EXPORT_HEIGHT][MAP_EXPORT_WIDTH],
+                            uint32_t *since_version) {
+  if (!out || !since_version)
+    return 0;
+
+  for (;;) {
+    uint32_t seq = ios_map_export_begin_read();
+    uint32_t version = map_export.version;
+    uint32_t mask = ios_map_export_dirty_rows(*since_version);
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+      int y = __builtin_ctz(bits);
+      memcpy(out[y], map_export.cells[y], sizeof(map_export.cells[y]));
+    }
+    if (ios_map_export_end_read(seq)) {
+      *since_version = version;
+      return mask;
+    }
+  }
+}
+
+/*
+ * === GLYPH RENDER TABLE ===
+ *
+ * ch/color/tile class/flags for every glyph, built from map_glyphinfo() once
+ * per symbol set instead of per print_glyph() call. Rebuilt lazily when
+ * marked stale (symbol setup, option changes, reset) or when the active
+ * graphics set changes (e.g. Rogue level). Two tables so a Swift reader
+ * holding the previous pointer never sees a half-built one.
+ */
+static GlyphRenderInfo glyph_tables[2][MAX_GLYPH];
+static const GlyphRenderInfo *_Atomic glyph_table_current = NULL;
+static _Atomic uint32_t glyph_table_generation = 0;
+static int glyph_table_graphics = -1; // gc.currentgraphics it was built for
+static boolean glyph_table_stale = TRUE;
+
+// Hardcoded characters for glyphs the symbol set leaves blank
+static char glyph_fallback_char(int glyphnum) {
+  if (glyphnum == GLYPH_UNEXPLORED || glyphnum == 9616)
+    return ' '; // Unexplored area
+  if (glyphnum >= 2359 && glyphnum < 2400)
+    return '.'; // Room/floor
+  if (glyphnum >= 2400 && glyphnum < 2450)
+    return '#'; // Corridor
+  if (glyphnum >= 2450 && glyphnum < 2500)
+    return '-'; // Horizontal wall
+  if (glyphnum >= 2500 && glyphnum < 2550)
+    return '|'; // Vertical wall
+  if (glyphnum >= 2550 && glyphnum < 2600)
+    return '+'; // Door
+  if (glyphnum >= 2600 && glyphnum < 2650)
+    return '#'; // Tree/wall
+  if (glyphnum < 400)
+    return 'M'; // Monster range - use letters
+  if (glyphnum < 800)
+    return '*'; // Object range
+  return '?';   // Unknown
+}
+
+// Tile class from display character (same mapping as Swift's fromCharacter)
+static uint8_t glyph_class_from_char(char ch) {
+  switch (ch) {
+  case '.': return GLYPH_TILE_FLOOR;
+  case '-': case '|': return GLYPH_TILE_WALL;
+  case '+': return GLYPH_TILE_DOOR_CLOSED;
+  case '\'': return GLYPH_TILE_DOOR_OPEN;
+  case '#': return GLYPH_TILE_CORRIDOR;
+  case '<': case '>': return GLYPH_TILE_STAIRS;
+  case '~': case '}': return GLYPH_TILE_WATER;
+  case '{': return GLYPH_TILE_FOUNTAIN;
+  case '_': return GLYPH_TILE_ALTAR;
+  case '\\': return GLYPH_TILE_THRONE;
+  case '^': return GLYPH_TILE_TRAP;
+  case '@': return GLYPH_TILE_PLAYER;
+  case '$': return GLYPH_TILE_GOLD;
+  case '%': return GLYPH_TILE_FOOD;
+  case ')': return GLYPH_TILE_WEAPON;
+  case '[': return GLYPH_TILE_ARMOR;
+  case '!': return GLYPH_TILE_POTION;
+  case '?': return GLYPH_TILE_SCROLL;
+  case '=': return GLYPH_TILE_RING;
+  case '"': return GLYPH_TILE_AMULET;
+  case '(': return GLYPH_TILE_TOOL;
+  default:
+    if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))
+      return GLYPH_TILE_MONSTER;
+    return GLYPH_TILE_UNKNOWN;
+  }
+}
+
+// Tile class from the glyph itself; symbol-set independent where possible
+static uint8_t glyph_class_for(int glyph, char ch) {
+  if (glyph_is_trap(glyph))
+    return GLYPH_TILE_TRAP;
+  if (glyph_is_monster(glyph) || glyph_is_invisible(glyph) ||
+      glyph_is_warning(glyph))
+    return GLYPH_TILE_MONSTER;
+  if (glyph_is_object(glyph)) {
+    switch (objects[glyph_to_obj(glyph)].oc_class) {
+    case COIN_CLASS: return GLYPH_TILE_GOLD;
+    case FOOD_CLASS: return GLYPH_TILE_FOOD;
+    case WEAPON_CLASS: return GLYPH_TILE_WEAPON;
+    case ARMOR_CLASS: return GLYPH_TILE_ARMOR;
+    case POTION_CLASS: return GLYPH_TILE_POTION;
+    case SCROLL_CLASS: return GLYPH_TILE_SCROLL;
+    case WAND_CLASS: return GLYPH_TILE_WAND;
+    case RING_CLASS: return GLYPH_TILE_RING;
+    case AMULET_CLASS: return GLYPH_TILE_AMULET;
+    case TOOL_CLASS: return GLYPH_TILE_TOOL;
+    default: return GLYPH_TILE_ITEM;
+    }
+  }
+  if (glyph_is_cmap(glyph)) {
+    int sym = glyph_to_cmap(glyph);
+    if (sym >= S_vwall && sym <= S_trwall)
+      return GLYPH_TILE_WALL;
+    switch (sym) {
+    case S_ndoor: return GLYPH_TILE_DOOR;
+    case S_vodoor: case S_hodoor: return GLYPH_TILE_DOOR_OPEN;
+    case S_vcdoor: case S_hcdoor: return GLYPH_TILE_DOOR_CLOSED;
+    case S_bars: case S_tree: return GLYPH_TILE_WALL;
+    case S_room: case S_darkroom: return GLYPH_TILE_FLOOR;
+    case S_corr: case S_litcorr: return GLYPH_TILE_CORRIDOR;
+    case S_upstair: case S_dnstair:
+    case S_upladder: case S_dnladder: return GLYPH_TILE_STAIRS;
+    case S_altar: return GLYPH_TILE_ALTAR;
+    case S_throne: return GLYPH_TILE_THRONE;
+    case S_sink: return GLYPH_TILE_SINK;
+    case S_fountain: return GLYPH_TILE_FOUNTAIN;
+    case S_pool: case S_water: return GLYPH_TILE_WATER;
+    case S_lava: return GLYPH_TILE_LAVA;
+    default: break; // Branch stairs, bridges, effects: decide by character
+    }
+  }
+  return glyph_class_from_char(ch);
+}
+
+// Rebuild into the inactive table and publish it (game thread)
+static void build_glyph_table(void) {
+  extern struct instance_globals_c gc;
+  extern struct instance_globals_s gs;
+  extern glyph_map glyphmap[MAX_GLYPH];
+
+  const GlyphRenderInfo *cur =
+      atomic_load_explicit(&glyph_table_current, memory_order_relaxed);
+  GlyphRenderInfo *table =
+      (cur == glyph_tables[0]) ? glyph_tables[1] : glyph_tables[0];
+
+  // Odd while writing: a reader still holding this buffer from two builds
+  // ago sees the generation move past its own + 2 and refetches
+  uint32_t gen = atomic_load_explicit(&glyph_table_generation, memory_order_relaxed);
+  atomic_store_explicit(&glyph_table_generation, gen + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  // glyphmap[] only: what map_glyphinfo() adds for a square (MG_HERO,
+  // MG_OBJPILE, hero color) belongs to the caller's glyph_info
+  for (int g = 0; g < MAX_GLYPH; g++) {
+    const glyph_map *gm = &glyphmap[g];
+    char ch = (char)gs.showsyms[gm->sym.symidx];
+    if (ch == 0)
+      ch = glyph_fallback_char(g);
+    table[g] = (GlyphRenderInfo){.ch = ch,
+                                 .color = (uint8_t)gm->sym.color,
+                                 .tile_class = glyph_class_for(g, ch),
+                                 .glyphflags = gm->glyphflags};
+  }
+
+  atomic_store_explicit(&glyph_table_current, table, memory_order_release);
+  atomic_store_explicit(&glyph_table_generation, gen + 2, memory_order_release);
+  glyph_table_graphics = gc.currentgraphics;
+  glyph_table_stale = FALSE;
+  WIN_LOG("Glyph table built (%d glyphs, graphics set %d)", MAX_GLYPH,
+          glyph_table_graphics);
+}
+
+// Table entry for glyph, rebuilding if stale; NULL before symbols exist
+static inline const GlyphRenderInfo *glyph_table_lookup(int glyph) {
+  extern struct instance_globals_c gc;
+  extern struct instance_globals_s gs;
+
+  if (glyph < 0 || glyph >= MAX_GLYPH)
+    return NULL;
+  if (glyph_table_stale || gc.currentgraphics != glyph_table_graphics) {
+    if (gs.showsyms[0] == 0)
+      return NULL; // Symbols not initialized yet (see ios_setup_default_symbols)
+    build_glyph_table();
+  }
+  return &atomic_load_explicit(&glyph_table_current, memory_order_relaxed)[glyph];
+}
+
+NETHACK_EXPORT const GlyphRenderInfo *ios_get_glyph_table(uint32_t *count,
+                                                          uint32_t *generation) {
+  if (count)
+    *count = MAX_GLYPH;
+  // Pointer and generation from the same side of a publish
+  for (;;) {
+    uint32_t gen = atomic_load_explicit(&glyph_table_generation, memory_order_acquire);
+    const GlyphRenderInfo *table =
+        atomic_load_explicit(&glyph_table_current, memory_order_acquire);
+    if (atomic_load_explicit(&glyph_table_generation, memory_order_acquire) == gen) {
+      if (generation)
+        *generation = gen;
+      return table;
+    }
+  }
+}
+
+NETHACK_EXPORT uint32_t ios_get_glyph_table_generation(void) {
+  return atomic_load_explicit(&glyph_table_generation, memory_order_acquire);
+}
+
 // Function to dynamically adjust map dimensions based on device
 void ios_set_map_dimensions(int width, int height) {
   if (width > 0 && width <= MAX_MAP_WIDTH) {
@@ -304,6 +710,7 @@ static void ios_init_nhwindows(int *argcp, char **argv) {
   // Initialize game state buffer (Push Model for lock-free Swift reads)
   extern void init_game_state_buffer(void);
   init_game_state_buffer();
+  keys_at_last_wait = UINT64_MAX; // The first input wait refreshes the indexes
 
   // Clear map buffer on init
   memset(map_buffer, ' ', sizeof(map_buffer));
@@ -313,14 +720,12 @@ static void ios_init_nhwindows(int *argcp, char **argv) {
   map_dirty = FALSE;
 
   // PHASE 1: Initialize render queue
+  // Static storage: lane indices need cache-line alignment malloc won't give
   if (!g_render_queue) {
-    g_render_queue = (RenderQueue *)malloc(sizeof(RenderQueue));
-    if (g_render_queue) {
-      render_queue_init(g_render_queue);
-      fprintf(stderr, "[QUEUE] Render queue initialized\n");
-    } else {
-      fprintf(stderr, "[QUEUE] ERROR: Failed to allocate render queue!\n");
-    }
+    static RenderQueue render_queue_storage;
+    g_render_queue = &render_queue_storage;
+    render_queue_init(g_render_queue);
+    fprintf(stderr, "[QUEUE] Render queue initialized\n");
   }
 
   fprintf(stderr, "[MAP] Map buffer initialized\n");
@@ -487,8 +892,19 @@ static void ios_clear_nhwindow(winid win) {
     /* FIX: Also clear captured_map */
     memset(captured_map, ' ', sizeof(captured_map));
 
+    /* Pending deltas refer to the old map - Swift resets on CMD_CLEAR_MAP */
+    discard_dirty_cells();
+
+    /* Level change: object index, lookat cache and travel field describe the old level */
+    ios_object_index_invalidate();
+    ios_lookat_cache_clear();
+    ios_travel_field_invalidate();
+
+    /* Binary export republishes every (now blank) row */
+    map_export_pending_rows = MAP_EXPORT_ALL_ROWS;
+
     // PHASE 1: Enqueue clear command
-    if (g_render_queue) {
+    if (g_render_queue && !ios_is_headless()) {
       RenderQueueElement elem = {
           .type = CMD_CLEAR_MAP,
           .data.command = {.blocking = 0, .turn_number = 0}};
@@ -501,9 +917,6 @@ static void ios_clear_nhwindow(winid win) {
 
 // REMOVED: debug_print_map() forward declaration - function deleted
 
-// Callback for notifying Swift that the display needs updating
-extern void ios_notify_map_changed(void);
-
 // REMOVED: map_mutex - not needed with lock-free queue
 
 // Capture the current map buffer for Swift to read
@@ -525,25 +938,75 @@ const char *ios_get_captured_map_line(int y) {
 }
 
 static void ios_display_nhwindow(winid win, boolean blocking) {
-  /* NetHack rendering - ALWAYS NOTIFY on map changes.
-   *
-   * Called by flush_screen() for spell beams, explosions, turn updates.
+  /* NetHack rendering - called by flush_screen() for spell beams,
+   * explosions, turn updates, often several times per command.
    *
-   * PREVIOUS BUG: Atomic coalescing dropped updates when main thread was busy.
-   * FIX: Remove coalescing, always notify. Swift handles rapid updates fine.
+   * Deltas are published now; the map-changed event coalesces into the
+   * batch delivered at the next input wait (or effect frame), so the
+   * main thread wakes once however many flushes the command made.
    */
 
+  if (ios_is_headless()) {
+    return;
+  }
+
   if (win == map_win && map_dirty) {
+    flush_glyph_deltas();
     ios_capture_map();
     map_dirty = FALSE;
 
-    // Always notify Swift - no coalescing, no dropped frames
-    dispatch_async(dispatch_get_main_queue(), ^{
-      ios_notify_map_changed();
-    });
+    ios_event_post(IOS_EVENT_MAP_CHANGED);
   }
 }
 
+/* Rewind the menu store for the next menu; the arena is reused, not cleared.
+ * Offset 0 stays an empty string shared by items without text. */
+static void menu_store_reset(void) {
+  menu_store.item_count = 0;
+  menu_store.text[0] = '\0';
+  menu_store.text_used = 1;
+  menu_store.prompt[0] = '\0';
+}
+
+/*
+ * Append one item to the menu store. Text is copied once into the arena
+ * (cut at IOS_MAX_MENU_TEXT like the old per-item buffers); an item whose
+ * text no longer fits shows empty rather than failing the menu.
+ */
+static void menu_store_add(const glyph_info *glyph, char selector, int attr,
+                           int identifier, const char *str,
+                           unsigned int itemflags) {
+  IOSMenuItem *item = &menu_store.items[menu_store.item_count];
+  item->selector = selector;
+  item->glyph = glyph ? glyph->glyph : 0;
+  item->attributes = attr;
+  item->identifier = identifier;
+  item->itemflags = itemflags;
+  item->text_offset = 0;
+  item->text_length = 0;
+
+  size_t len = str ? strnlen(str, IOS_MAX_MENU_TEXT - 1) : 0;
+  if (len > 0) {
+    if ((size_t)menu_store.text_used + len + 1 > sizeof(menu_store.text)) {
+      fprintf(stderr, "[MENU] WARNING: Menu text arena full, item %d shown empty\n",
+              menu_store.item_count);
+    } else {
+      char *dst = menu_store.text + menu_store.text_used;
+      memcpy(dst, str, len);
+      dst[len] = '\0';
+      item->text_offset = menu_store.text_used;
+      item->text_length = (int)len;
+      menu_store.text_used += (int)len + 1;
+    }
+  }
+  menu_store.item_count++;
+}
+
+/* Text of store item i (NUL-terminated, inside the arena) */
+static const char *menu_store_text(int i) {
+  return menu_store.text + menu_store.items[i].text_offset;
+}
+
 static void ios_destroy_nhwindow(winid win) {
   WIN_LOG("destroy_nhwindow");
 
@@ -553,20 +1016,12 @@ static void ios_destroy_nhwindow(winid win) {
   // Reference: TTY port (wintty.c:2008), X11 port (winX.c:1224)
 
   if (win == menu_win || win == current_menu_win) {
-    // Reset menu lifecycle state
-    menu_item_count = 0;
+    // Reset menu lifecycle state; nothing reads past item_count, so
+    // rewinding the store is enough to hide the previous menu
+    menu_store_reset();
     current_menu_win = 0;
     menu_is_active = FALSE;
 
-    // Clear ALL menu arrays to prevent stale data access
-    memset(menu_items, 0, sizeof(menu_items));
-    memset(menu_selectors, 0, sizeof(menu_selectors));
-    memset(menu_texts, 0, sizeof(menu_texts));
-    memset(menu_glyphs, 0, sizeof(menu_glyphs));
-    memset(menu_attributes, 0, sizeof(menu_attributes));
-    memset(menu_itemflags, 0, sizeof(menu_itemflags));
-    memset(last_menu_prompt, 0, sizeof(last_menu_prompt));
-
     fprintf(stderr, "[MENU] Menu window destroyed, state reset\n");
   }
 
@@ -656,26 +1111,17 @@ static void ios_putstr(winid win, int attr, const char *str) {
   }
 
   // Log with category and ATR_* attributes for better debugging
-  fprintf(stderr, "[%s] '%s' (attr=0x%02X", category, str, attr);
-  if (attr & ATR_BOLD)
-    fprintf(stderr, " BOLD");
-  if (attr & ATR_DIM)
-    fprintf(stderr, " DIM");
-  if (attr & ATR_INVERSE)
-    fprintf(stderr, " INVERSE");
-  if (attr & ATR_URGENT)
-    fprintf(stderr, " URGENT");
-  fprintf(stderr, ")\n");
+  IOS_LOG_D(IOS_LOG_CAT_MESSAGE, "[%s] '%s' (attr=0x%02X%s%s%s%s)", category,
+            str, attr, (attr & ATR_BOLD) ? " BOLD" : "",
+            (attr & ATR_DIM) ? " DIM" : "",
+            (attr & ATR_INVERSE) ? " INVERSE" : "",
+            (attr & ATR_URGENT) ? " URGENT" : "");
 
   // PHASE 3: Enqueue message to render queue
-  if (g_render_queue) {
-    RenderQueueElement elem = {
-        .type = UPDATE_MESSAGE,
-        .data.message = {
-            .text = strdup(str), // MUST strdup - NetHack reuses buffers
-            .category = strdup(category),
-            .attr = attr}};
-    render_queue_enqueue(g_render_queue, &elem);
+  // Text is copied into the queue's arena - NetHack reuses its buffers
+  bool headless = ios_is_headless();
+  if (g_render_queue && !headless) {
+    render_queue_enqueue_message(g_render_queue, str, category, attr);
   }
 
   // Add to message history for Swift access WITH attributes (KEEP for backward
@@ -685,8 +1131,10 @@ static void ios_putstr(winid win, int attr, const char *str) {
   nethack_add_message_with_attrs(str, category, attr);
 
   // Add to output buffer for Swift (KEEP for backward compatibility)
-  safe_append_to_output(str);
-  safe_append_to_output("\n");
+  if (!headless) {
+    safe_append_to_output(str);
+    safe_append_to_output("\n");
+  }
 
   // If we're capturing death info, also add to the appropriate buffer
   if (is_capturing_death_info && death_info_stage > 0) {
@@ -770,13 +1218,8 @@ static void ios_display_file(const char *fname, boolean complain) {
 
 static void ios_start_menu(winid win, unsigned long mbehavior) {
   WIN_LOG("start_menu");
-  // Reset menu tracking - clear ALL menu arrays
-  menu_item_count = 0;
-  memset(menu_selectors, 0, sizeof(menu_selectors));
-  memset(menu_texts, 0, sizeof(menu_texts));
-  memset(menu_glyphs, 0, sizeof(menu_glyphs));
-  memset(menu_attributes, 0, sizeof(menu_attributes));
-  memset(menu_itemflags, 0, sizeof(menu_itemflags));
+  // Reset menu tracking - rewind the store, no per-menu clearing or allocation
+  menu_store_reset();
   current_menu_win = win;
   menu_is_active = TRUE;
 }
@@ -791,71 +1234,52 @@ static void ios_add_menu(winid win, const glyph_info *glyph,
     fprintf(stderr, "[MENU] add_menu with NULL identifier (header/separator): %s\n",
             str ? str : "(null)");
     // Still add text for display but with no selectable identifier
-    if (menu_item_count < MAX_MENU_ITEMS) {
-      memset(&menu_items[menu_item_count].item, 0, sizeof(ANY_P));
-      menu_items[menu_item_count].count = 0;
-      menu_items[menu_item_count].itemflags = itemflags;
-      menu_selectors[menu_item_count] = 0;  // Not selectable
+    if (menu_store.item_count < MAX_MENU_ITEMS) {
+      memset(&menu_items[menu_store.item_count].item, 0, sizeof(ANY_P));
+      menu_items[menu_store.item_count].count = 0;
+      menu_items[menu_store.item_count].itemflags = itemflags;
+      menu_store_add(glyph, 0, attr, 0, str, itemflags);  // Not selectable
       if (str) {
-        strncpy(menu_texts[menu_item_count], str, MAX_MENU_TEXT - 1);
-        menu_texts[menu_item_count][MAX_MENU_TEXT - 1] = '\0';
         safe_append_to_output(str);
         safe_append_to_output("\n");
-      } else {
-        menu_texts[menu_item_count][0] = '\0';
       }
-      menu_glyphs[menu_item_count] = glyph ? glyph->glyph : 0;
-      menu_attributes[menu_item_count] = attr;
-      menu_itemflags[menu_item_count] = itemflags;
-      menu_item_count++;
     }
     return;
   }
 
   // Guard clause: menu buffer full
-  if (menu_item_count >= MAX_MENU_ITEMS) {
+  if (menu_store.item_count >= MAX_MENU_ITEMS) {
     fprintf(stderr, "[MENU] WARNING: Menu buffer full!\n");
     return;
   }
 
   // Store menu item for later selection
-  menu_items[menu_item_count].item = *identifier;
-  menu_items[menu_item_count].count = 0; // Not selected yet
-  menu_items[menu_item_count].itemflags = itemflags;
-  menu_selectors[menu_item_count] = ch;  // Store selector character for matching user input
-
-  // Store additional data for Swift menu UI
-  if (str) {
-    strncpy(menu_texts[menu_item_count], str, MAX_MENU_TEXT - 1);
-    menu_texts[menu_item_count][MAX_MENU_TEXT - 1] = '\0';
-  } else {
-    menu_texts[menu_item_count][0] = '\0';
-  }
-  menu_glyphs[menu_item_count] = glyph ? glyph->glyph : 0;
-  menu_attributes[menu_item_count] = attr;
-  menu_itemflags[menu_item_count] = itemflags;
+  menu_items[menu_store.item_count].item = *identifier;
+  menu_items[menu_store.item_count].count = 0; // Not selected yet
+  menu_items[menu_store.item_count].itemflags = itemflags;
 
   if (str) {
     fprintf(stderr, "[MENU] Added item %d: selector='%c' a_int=%d glyph=%d attr=%d - %.40s\n",
-            menu_item_count, ch ? ch : ' ', identifier->a_int,
+            menu_store.item_count, ch ? ch : ' ', identifier->a_int,
             glyph ? glyph->glyph : 0, attr,
             str ? str : "(null)");
     safe_append_to_output(str);
     safe_append_to_output("\n");
   }
-  menu_item_count++;
-}
 
-// last_menu_prompt now declared at top of file (line 116)
+  // Store item data for Swift menu UI (selector also matches user input);
+  // this bumps menu_store.item_count
+  menu_store_add(glyph, ch, attr, identifier->a_int, str, itemflags);
+}
 
 static void ios_end_menu(winid win, const char *prompt) {
   WIN_LOG("end_menu");
   if (prompt) {
     fprintf(stderr, "[MENU] Prompt: %s\n", prompt);
-    strncpy(last_menu_prompt, prompt, sizeof(last_menu_prompt) - 1);
-    last_menu_prompt[sizeof(last_menu_prompt) - 1] = '\0';
+    strncpy(menu_store.prompt, prompt, sizeof(menu_store.prompt) - 1);
+    menu_store.prompt[sizeof(menu_store.prompt) - 1] = '\0';
   } else {
-    last_menu_prompt[0] = '\0';
+    menu_store.prompt[0] = '\0';
   }
   menu_is_active = FALSE;
 }
@@ -865,7 +1289,7 @@ static void ios_end_menu(winid win, const char *prompt) {
  * NetHack core expects the returned menu_list to survive destroy_nhwindow(),
  * and the caller is responsible for free()ing it.
  * This fixes use-after-free bug where pointers into menu_items[] would
- * point to zeroed memory after ios_destroy_nhwindow() calls memset.
+ * be overwritten once the next menu reuses the store.
  */
 static int alloc_menu_selection(MENU_ITEM_P **menu_list, int index, int count) {
   MENU_ITEM_P *result = (MENU_ITEM_P *)malloc(sizeof(MENU_ITEM_P));
@@ -880,32 +1304,14 @@ static int alloc_menu_selection(MENU_ITEM_P **menu_list, int index, int count) {
 }
 
 /*
- * Build IOSMenuContext from current menu state for Swift callback.
+ * Hand the menu store to the Swift callback. add_menu already wrote every
+ * item and string into it, so only the per-call fields are filled in.
  * Returns pointer to static context (valid until next menu operation).
  */
 static IOSMenuContext* build_menu_context(int how) {
-  static IOSMenuContext ctx;
-
-  ctx.how = how;
-  ctx.window_id = current_menu_win;
-  ctx.item_count = menu_item_count;
-
-  // Copy prompt
-  strncpy(ctx.prompt, last_menu_prompt, IOS_MAX_MENU_TEXT - 1);
-  ctx.prompt[IOS_MAX_MENU_TEXT - 1] = '\0';
-
-  // Copy items
-  for (int i = 0; i < menu_item_count && i < IOS_MAX_MENU_ITEMS; i++) {
-    ctx.items[i].selector = menu_selectors[i];
-    ctx.items[i].glyph = menu_glyphs[i];
-    strncpy(ctx.items[i].text, menu_texts[i], IOS_MAX_MENU_TEXT - 1);
-    ctx.items[i].text[IOS_MAX_MENU_TEXT - 1] = '\0';
-    ctx.items[i].attributes = menu_attributes[i];
-    ctx.items[i].identifier = menu_items[i].item.a_int;
-    ctx.items[i].itemflags = menu_itemflags[i];
-  }
-
-  return &ctx;
+  menu_store.how = how;
+  menu_store.window_id = current_menu_win;
+  return &menu_store;
 }
 
 /*
@@ -918,7 +1324,8 @@ static int try_swift_menu_callback(int how, MENU_ITEM_P **menu_list) {
   IOSMenuCallback callback = swift_menu_callback;
   pthread_mutex_unlock(&menu_callback_mutex);
 
-  if (!callback) {
+  // A replay answers from the journal whether or not a UI is attached
+  if (!callback && !ios_is_replaying()) {
     return 0;  // No callback - use fallback
   }
 
@@ -927,40 +1334,31 @@ static int try_swift_menu_callback(int how, MENU_ITEM_P **menu_list) {
 
   // CHECK FOR QUEUED INPUT FIRST (before blocking on Swift UI)
   // This allows ios_queue_input to pre-select menu items (e.g., loot mode 'i', 'o', 'b')
-  if (how == PICK_ONE) {
-    pthread_mutex_lock(&input_mutex);
-    if (input_queue_head != input_queue_tail) {
-      char queued_ch = input_queue[input_queue_head];
-      pthread_mutex_unlock(&input_mutex);
-
-      // Try to find matching menu item
-      for (int i = 0; i < menu_item_count; i++) {
-        if (menu_selectors[i] == queued_ch) {
-          fprintf(stderr, "[MENU] Queued input '%c' matches menu item %d - auto-selecting\n",
-                  queued_ch, i);
-          // Consume the character from queue
-          pthread_mutex_lock(&input_mutex);
-          input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-          pthread_mutex_unlock(&input_mutex);
-
-          // Allocate and return the selection
-          MENU_ITEM_P *result = (MENU_ITEM_P *)malloc(sizeof(MENU_ITEM_P));
-          if (result) {
-            result->item = menu_items[i].item;
-            result->count = -1;  // All
-            result->itemflags = menu_items[i].itemflags;
-            *menu_list = result;
-            return 1;  // Handled via queued input
-          }
-          break;
+  char queued_ch;
+  if (how == PICK_ONE && ios_input_ring_peek(&queued_ch)) {
+    // Try to find matching menu item
+    for (int i = 0; i < menu_store.item_count; i++) {
+      if (menu_store.items[i].selector == queued_ch) {
+        fprintf(stderr, "[MENU] Queued input '%c' matches menu item %d - auto-selecting\n",
+                queued_ch, i);
+        // Consume the character from queue
+        ios_input_ring_drop();
+
+        // Allocate and return the selection
+        MENU_ITEM_P *result = (MENU_ITEM_P *)malloc(sizeof(MENU_ITEM_P));
+        if (result) {
+          result->item = menu_items[i].item;
+          result->count = -1;  // All
+          result->itemflags = menu_items[i].itemflags;
+          *menu_list = result;
+          return 1;  // Handled via queued input
         }
+        break;
       }
-      // Character didn't match - fall through to Swift UI
-      fprintf(stderr, "[MENU] Queued input '%c' (0x%02x) did not match any menu selector\n",
-              isprint(queued_ch) ? queued_ch : '?', (unsigned char)queued_ch);
-    } else {
-      pthread_mutex_unlock(&input_mutex);
     }
+    // Character didn't match - fall through to Swift UI
+    fprintf(stderr, "[MENU] Queued input '%c' (0x%02x) did not match any menu selector\n",
+            isprint(queued_ch) ? queued_ch : '?', (unsigned char)queued_ch);
   }
 
   // Build context
@@ -969,11 +1367,31 @@ static int try_swift_menu_callback(int how, MENU_ITEM_P **menu_list) {
   fprintf(stderr, "[MENU] ====== CALLING SWIFT CALLBACK ======\n");
   fprintf(stderr, "[MENU] Mode: %s, Items: %d\n",
           how == 0 ? "PICK_NONE" : (how == 1 ? "PICK_ONE" : "PICK_ANY"),
-          menu_item_count);
+          menu_store.item_count);
 
-  // Call Swift callback
+  // Call Swift callback (or take the journaled selections)
   IOSMenuSelection selections[MAX_MENU_ITEMS];
-  int num_selections = callback(ctx, selections, MAX_MENU_ITEMS);
+  IOSJournalPick picks[MAX_MENU_ITEMS];
+  int num_selections;
+  if (ios_is_replaying()) {
+    num_selections = ios_replay_menu(picks, MAX_MENU_ITEMS);
+    if (num_selections < 0 && !callback) {
+      return 0;  // Journal diverged and no UI - use fallback
+    }
+    for (int i = 0; i < num_selections; i++) {
+      selections[i].item_index = picks[i].index;
+      selections[i].count = picks[i].count;
+    }
+  } else {
+    num_selections = callback(ctx, selections, MAX_MENU_ITEMS);
+    if (ios_is_recording()) {
+      for (int i = 0; i < num_selections; i++) {
+        picks[i].index = selections[i].item_index;
+        picks[i].count = selections[i].count;
+      }
+      ios_journal_note_menu(num_selections, picks);
+    }
+  }
 
   fprintf(stderr, "[MENU] Swift callback returned %d selection(s)\n", num_selections);
 
@@ -1001,7 +1419,7 @@ static int try_swift_menu_callback(int how, MENU_ITEM_P **menu_list) {
   // Copy selections
   for (int i = 0; i < num_selections; i++) {
     int idx = selections[i].item_index;
-    if (idx < 0 || idx >= menu_item_count) {
+    if (idx < 0 || idx >= menu_store.item_count) {
       fprintf(stderr, "[MENU] ERROR: Invalid selection index %d\n", idx);
       free(result);
       return 0;  // Use fallback
@@ -1018,12 +1436,12 @@ static int try_swift_menu_callback(int how, MENU_ITEM_P **menu_list) {
 }
 
 static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
-  WIN_LOG("select_menu how=%d item_count=%d", how, menu_item_count);
+  WIN_LOG("select_menu how=%d item_count=%d", how, menu_store.item_count);
 
   // PICK_NONE: Display-only menus (like Attributes/Enlightenment)
   // Must still show menu to user, just no selection required
   if (how == PICK_NONE) {
-    fprintf(stderr, "[MENU] PICK_NONE - display only menu with %d items\n", menu_item_count);
+    fprintf(stderr, "[MENU] PICK_NONE - display only menu with %d items\n", menu_store.item_count);
 
     // Skip during character creation (no UI available yet)
     if (!character_creation_complete) {
@@ -1044,7 +1462,7 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
   // During character creation, auto-select first item (bypass Swift UI)
   // NOTE: Only for PICK_ONE/PICK_ANY menus now, since PICK_NONE is handled above
   if (!character_creation_complete) {
-    if (menu_item_count > 0) {
+    if (menu_store.item_count > 0) {
       fprintf(stderr, "[MENU] Character creation: selected item a_int=%d\n",
               menu_items[0].item.a_int);
       if (!alloc_menu_selection(menu_list, 0, 1)) return -1;
@@ -1054,7 +1472,7 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
   }
 
   // No items in menu
-  if (menu_item_count == 0) {
+  if (menu_store.item_count == 0) {
     fprintf(stderr, "[MENU] No items in menu\n");
 
     // CRITICAL: If we just showed dungeon overview (death_info_stage == 4),
@@ -1071,10 +1489,10 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
   }
 
   // Check for tutorial auto-skip BEFORE trying Swift callback
-  if (how == PICK_ONE && last_menu_prompt[0] != '\0' && strstr(last_menu_prompt, "tutorial")) {
+  if (how == PICK_ONE && menu_store.prompt[0] != '\0' && strstr(menu_store.prompt, "tutorial")) {
     fprintf(stderr, "[MENU] Tutorial menu detected - auto-selecting 'n' (No)\n");
-    for (int i = 0; i < menu_item_count; i++) {
-      if (menu_selectors[i] == 'n') {
+    for (int i = 0; i < menu_store.item_count; i++) {
+      if (menu_store.items[i].selector == 'n') {
         fprintf(stderr, "[MENU] Auto-selected 'n' to skip tutorial\n");
         if (!alloc_menu_selection(menu_list, i, 1)) return -1;
         return 1;
@@ -1099,22 +1517,18 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
   if (how == PICK_ONE) {
     // Log available selectors for debugging
     fprintf(stderr, "[MENU] PICK_ONE - waiting for user input. Available selectors: ");
-    for (int i = 0; i < menu_item_count; i++) {
-      if (menu_selectors[i]) {
-        fprintf(stderr, "'%c' ", menu_selectors[i]);
+    for (int i = 0; i < menu_store.item_count; i++) {
+      if (menu_store.items[i].selector) {
+        fprintf(stderr, "'%c' ", menu_store.items[i].selector);
       }
     }
     fprintf(stderr, "\n");
 
     // Block and wait for user input (same pattern as ios_yn_function)
-    pthread_mutex_lock(&input_mutex);
+    char ch;
 
     // Check if input is already queued
-    if (input_queue_head != input_queue_tail) {
-      char ch = input_queue[input_queue_head];
-      input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-      pthread_mutex_unlock(&input_mutex);
-
+    if (ios_input_ring_pop(&ch)) {
       fprintf(stderr, "[MENU] Got queued input: '%c' (0x%02x)\n",
               isprint(ch) ? ch : '?', (unsigned char)ch);
 
@@ -1125,8 +1539,8 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
       }
 
       // Find matching selector
-      for (int i = 0; i < menu_item_count; i++) {
-        if (menu_selectors[i] == ch) {
+      for (int i = 0; i < menu_store.item_count; i++) {
+        if (menu_store.items[i].selector == ch) {
           fprintf(stderr, "[MENU] Selected item %d with selector '%c', a_int=%d\n",
                   i, ch, menu_items[i].item.a_int);
           if (!alloc_menu_selection(menu_list, i, 1)) return -1;
@@ -1141,16 +1555,12 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
 
     // Wait for input
     fprintf(stderr, "[MENU] Blocking for user input...\n");
-    while (input_queue_head == input_queue_tail && game_thread_running) {
-      pthread_cond_wait(&input_cond, &input_mutex);
+    while (ios_input_ring_empty() && game_thread_running) {
+      wait_for_input(0);
     }
 
     // Check if we got input
-    if (input_queue_head != input_queue_tail) {
-      char ch = input_queue[input_queue_head];
-      input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-      pthread_mutex_unlock(&input_mutex);
-
+    if (ios_input_ring_pop(&ch)) {
       fprintf(stderr, "[MENU] Got input after wait: '%c' (0x%02x)\n",
               isprint(ch) ? ch : '?', (unsigned char)ch);
 
@@ -1161,8 +1571,8 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
       }
 
       // Find matching selector
-      for (int i = 0; i < menu_item_count; i++) {
-        if (menu_selectors[i] == ch) {
+      for (int i = 0; i < menu_store.item_count; i++) {
+        if (menu_store.items[i].selector == ch) {
           fprintf(stderr, "[MENU] Selected item %d with selector '%c', a_int=%d\n",
                   i, ch, menu_items[i].item.a_int);
           if (!alloc_menu_selection(menu_list, i, 1)) return -1;
@@ -1175,7 +1585,6 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
       return -1;
     }
 
-    pthread_mutex_unlock(&input_mutex);
     fprintf(stderr, "[MENU] Game thread stopped, canceling\n");
     return -1;
   }
@@ -1187,12 +1596,12 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
     // Count selectable items (those with valid identifiers)
     int selectable_indices[5];
     int selectable_count = 0;
-    for (int i = 0; i < menu_item_count && selectable_count < 5; i++) {
+    for (int i = 0; i < menu_store.item_count && selectable_count < 5; i++) {
       // Skip items with no identifier (headers/info text)
       // Note: selector 0 means not selectable (header/separator)
-      if (menu_items[i].item.a_int == 0 && (menu_selectors[i] == 0 || menu_selectors[i] == ' ')) {
+      if (menu_items[i].item.a_int == 0 && (menu_store.items[i].selector == 0 || menu_store.items[i].selector == ' ')) {
         fprintf(stderr, "[MENU]   Skipping header item %d (selector=%d): %s\n",
-                i, (int)menu_selectors[i], menu_texts[i]);
+                i, (int)menu_store.items[i].selector, menu_store_text(i));
         continue;
       }
       selectable_indices[selectable_count++] = i;
@@ -1222,10 +1631,39 @@ static int ios_select_menu(winid win, int how, MENU_ITEM_P **menu_list) {
   return -1;
 }
 
-static void ios_update_inventory(int arg) { WIN_LOG("update_inventory"); }
+static void ios_update_inventory(int arg) {
+  WIN_LOG("update_inventory");
+  // Rebuilt by the game thread at its next input wait; until then reads copy the old one
+  ios_inventory_cache_invalidate();
+}
 
 static void ios_mark_synch(void) { /* WIN_LOG("mark_synch"); - too verbose */ }
 
+// Helper to get current time in nanoseconds
+static uint64_t get_time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * === TURN TIMING STAMPS (see ios_frame_timing.h) ===
+ * input_pending_ns: oldest key not yet shown on screen (main thread sets it,
+ * Swift clears it when the frame is presented). last_input_ns: most recent
+ * key, used for the game thread's wake-up latency.
+ */
+static _Atomic uint64_t input_pending_ns = 0;
+static _Atomic uint64_t last_input_ns = 0;
+static uint64_t key_returned_ns = 0; // Game thread: poskey handed out a key
+
+NETHACK_EXPORT void ios_frame_timing_frame_presented(void) {
+  uint64_t queued =
+      atomic_exchange_explicit(&input_pending_ns, 0, memory_order_relaxed);
+  if (queued) {
+    ios_frame_timing_record(FRAME_STAGE_INPUT_TO_FRAME, get_time_ns() - queued);
+  }
+}
+
 // Made non-static so RealNetHackBridge.c can call it for travel animation
 void ios_wait_synch(void) {
   /* This is called after NetHack processes a command and wants to sync display
@@ -1233,6 +1671,25 @@ void ios_wait_synch(void) {
 
   extern struct instance_globals_saved_m svm;
 
+  if (ios_is_headless()) {
+    // Nothing to show: keep only the bookkeeping the game itself relies on
+    ios_headless_note_sync();
+    key_returned_ns = 0;
+    extern void ios_level_store_mark_dirty(int ledger);
+    ios_level_store_mark_dirty(ledger_no(&u.uz));
+    return;
+  }
+
+  uint64_t sync_start = get_time_ns();
+  if (key_returned_ns) {
+    // First sync after a key: NetHack's command work for that key
+    ios_frame_timing_record(FRAME_STAGE_TURN, sync_start - key_returned_ns);
+    key_returned_ns = 0;
+  }
+
+  // Publish this turn's coalesced map changes ahead of the turn marker
+  flush_glyph_deltas();
+
   // PHASE 1: Enqueue turn complete marker
   if (g_render_queue) {
     RenderQueueElement elem = {
@@ -1243,15 +1700,23 @@ void ios_wait_synch(void) {
 
   // PUSH MODEL: Update game state snapshot for lock-free Swift reads
   extern void update_game_state_snapshot(void);
+  uint64_t snapshot_start = get_time_ns();
   update_game_state_snapshot();
+  ios_frame_timing_record(FRAME_STAGE_SNAPSHOT, get_time_ns() - snapshot_start);
 
   // Always capture the current state and notify Swift
   ios_capture_map();
 
-  // Notify Swift on main thread (queue flush happens in Swift)
-  dispatch_async(dispatch_get_main_queue(), ^{
-    ios_notify_map_changed();
-  });
+  ios_frame_timing_record(FRAME_STAGE_SYNC, get_time_ns() - sync_start);
+
+  // The current level's file gets rewritten when we leave: its chunk is stale
+  extern void ios_level_store_mark_dirty(int ledger);
+  ios_level_store_mark_dirty(ledger_no(&u.uz));
+
+  // Turn boundary: the batch (map, messages, turn) goes out in one hop
+  ios_event_post_turn((int64_t)svm.moves);
+  ios_event_post(IOS_EVENT_MAP_CHANGED);
+  ios_event_bus_flush();
 }
 
 static void ios_cliparound(int x, int y) {
@@ -1267,12 +1732,20 @@ static int old_player_y = -1;
 static void ios_print_glyph(winid win, coordxy x, coordxy y,
                             const glyph_info *glyph,
                             const glyph_info *bkglyph) {
+  // Cached farlook text for this cell is stale (cheap counter bump)
+  ios_lookat_cache_note_glyph(x, y);
+
+  if (ios_is_headless()) {
+    ios_travel_field_invalidate(); // No map_cells to tell a change by
+    return; // No map buffers to keep: nobody draws them
+  }
+
   // DEBUG: Count print_glyph calls to verify docrt() is drawing map
   static int glyph_call_count = 0;
   glyph_call_count++;
   if (glyph_call_count % 100 == 1 || glyph_call_count <= 5) {
-    fprintf(stderr, "[PRINT_GLYPH] Call #%d: win=%d (expect %d) x=%d y=%d\n",
-            glyph_call_count, win, map_win, x, y);
+    IOS_LOG_D(IOS_LOG_CAT_RENDER, "Call #%d: win=%d (expect %d) x=%d y=%d",
+              glyph_call_count, win, map_win, x, y);
   }
 
   // CRITICAL FIX: During restore, docrt() may pass win=-1
@@ -1280,8 +1753,8 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
   // restore)
   if (win != map_win && win != -1) {
     if (glyph_call_count <= 5) {
-      fprintf(stderr, "[PRINT_GLYPH] REJECT: win=%d != map_win=%d and != -1\n",
-              win, map_win);
+      IOS_LOG_W(IOS_LOG_CAT_RENDER, "REJECT: win=%d != map_win=%d and != -1",
+                win, map_win);
     }
     return;
   }
@@ -1303,48 +1776,29 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
   if (glyph) {
     glyphnum = glyph->glyph;
 
-    // If ttychar is not set, we need to get the proper mapping
+    // Flags are per square (MG_HERO, MG_OBJPILE): always the caller's
+    glyphflags = glyph->gm.glyphflags;
+
+    // If ttychar is not set, use the precomputed glyph table (one load)
     if (glyph->ttychar == 0 && glyphnum != NO_GLYPH) {
-      // Try map_glyphinfo first
-      glyph_info gi;
-      extern void map_glyphinfo(coordxy x, coordxy y, int glyph,
-                                unsigned mgflags, glyph_info *glyphinfo);
-      map_glyphinfo(x, y, glyphnum, 0, &gi);
-      ch = gi.ttychar;
-      color = gi.gm.sym.color;
-      glyphflags = gi.gm.glyphflags;
-
-      // If still no char, use hardcoded mappings for common glyphs
-      if (ch == 0) {
-        // Check for specific known glyphs
-        if (glyphnum == GLYPH_UNEXPLORED || glyphnum == 9616) {
-          ch = ' '; // Unexplored area
-        } else if (glyphnum >= 2359 && glyphnum < 2400) {
-          ch = '.'; // Room/floor
-        } else if (glyphnum >= 2400 && glyphnum < 2450) {
-          ch = '#'; // Corridor
-        } else if (glyphnum >= 2450 && glyphnum < 2500) {
-          ch = '-'; // Horizontal wall
-        } else if (glyphnum >= 2500 && glyphnum < 2550) {
-          ch = '|'; // Vertical wall
-        } else if (glyphnum >= 2550 && glyphnum < 2600) {
-          ch = '+'; // Door
-        } else if (glyphnum >= 2600 && glyphnum < 2650) {
-          ch = '#'; // Tree/wall
-        } else if (glyphnum < 400) {
-          // Monster range - use letters
-          ch = 'M';
-        } else if (glyphnum < 800) {
-          // Object range
-          ch = '*';
-        } else {
-          ch = '?'; // Unknown
-        }
+      // Hero square stays per-call: map_glyphinfo() adds the hero color
+      const GlyphRenderInfo *info =
+          (x == u.ux && y == u.uy) ? NULL : glyph_table_lookup(glyphnum);
+      if (info) {
+        ch = info->ch;
+        color = info->color;
+      } else {
+        // Hero square, or table not built yet - resolve directly
+        glyph_info gi;
+        extern void map_glyphinfo(coordxy x, coordxy y, int glyph,
+                                  unsigned mgflags, glyph_info *glyphinfo);
+        map_glyphinfo(x, y, glyphnum, 0, &gi);
+        ch = gi.ttychar ? (char)gi.ttychar : glyph_fallback_char(glyphnum);
+        color = gi.gm.sym.color;
       }
     } else {
       ch = glyph->ttychar;
       color = glyph->gm.sym.color;
-      glyphflags = glyph->gm.glyphflags;
     }
 
     // Final fallback
@@ -1364,41 +1818,44 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
 
   // Guard: Invalid coordinates
   if (buffer_x < 0 || buffer_y < 0) {
-    fprintf(stderr, "[MAP] Invalid coordinates: [NH:%d,%d] -> [BUF:%d,%d]\n", x,
-            y, buffer_x, buffer_y);
+    IOS_LOG_E(IOS_LOG_CAT_RENDER, "Invalid coordinates: [NH:%d,%d] -> [BUF:%d,%d]",
+              x, y, buffer_x, buffer_y);
     return;
   }
 
   // Guard: Out of buffer bounds
   if (buffer_x >= MAX_MAP_WIDTH || buffer_y >= MAX_MAP_HEIGHT) {
-    fprintf(stderr, "[MAP] Out of bounds: [BUF:%d,%d] >= max(%d,%d)\n",
-            buffer_x, buffer_y, MAX_MAP_WIDTH, MAX_MAP_HEIGHT);
+    IOS_LOG_E(IOS_LOG_CAT_RENDER, "Out of bounds: [BUF:%d,%d] >= max(%d,%d)",
+              buffer_x, buffer_y, MAX_MAP_WIDTH, MAX_MAP_HEIGHT);
     return;
   }
 
   // Debug: Log what we're drawing at key positions
   extern struct you u; // Get player position
 
-  // ALWAYS log player position draws with coordinate space labels
+  // Log player position draws with coordinate space labels
   if (x == u.ux && y == u.uy) {
-    fprintf(
-        stderr,
-        "[MAP] PLAYER GLYPH at [NH:%d,%d] -> [BUF:%d,%d]: glyph=%d -> '%c'\n",
-        x, y, buffer_x, buffer_y, glyphnum, ch);
-    fflush(stderr);
+    IOS_LOG_D(IOS_LOG_CAT_RENDER,
+              "PLAYER GLYPH at [NH:%d,%d] -> [BUF:%d,%d]: glyph=%d -> '%c'",
+              x, y, buffer_x, buffer_y, glyphnum, ch);
   }
 
   // Log interesting glyphs with coordinate space labels
   if (glyphnum != NO_GLYPH && glyphnum != 9616) { // Not empty space
     if (ch == '@' || ch == 'd' || ch == 'f' || ch == '|' ||
         ch == '-') { // Player, pets, walls
-      fprintf(stderr,
-              "[MAP] Drawing '%c' at [NH:%d,%d] -> [BUF:%d,%d], glyph=%d, flags=0x%x%s\n", ch,
-              x, y, buffer_x, buffer_y, glyphnum, glyphflags,
-              (glyphflags & 0x00010) ? " [PET]" : "");
+      IOS_LOG_T(IOS_LOG_CAT_RENDER,
+                "Drawing '%c' at [NH:%d,%d] -> [BUF:%d,%d], glyph=%d, flags=0x%x%s", ch,
+                x, y, buffer_x, buffer_y, glyphnum, glyphflags,
+                (glyphflags & 0x00010) ? " [PET]" : "");
     }
   }
 
+  // Terrain, doors and newly seen cells all show as a new glyph; the travel
+  // field also rebuilds by itself when the hero moves
+  if (map_cells[buffer_y][buffer_x].glyph != glyphnum)
+    ios_travel_field_invalidate();
+
   // Store in map buffer with coordinate mapping (KEEP for backward
   // compatibility during transition)
   map_buffer[buffer_y][buffer_x] = ch;
@@ -1408,6 +1865,7 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
   map_cells[buffer_y][buffer_x].ch = ch;
   map_cells[buffer_y][buffer_x].color = color;
   map_cells[buffer_y][buffer_x].bg = 0; // Black background for now
+  map_cells[buffer_y][buffer_x].glyphflags = glyphflags;
 
   // Track actual map size (in buffer coordinates)
   if (buffer_x >= actual_map_width)
@@ -1415,16 +1873,15 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
   if (buffer_y >= actual_map_height)
     actual_map_height = buffer_y + 1;
 
-  // PHASE 1: Enqueue glyph update to render queue
-  if (g_render_queue) {
-    RenderQueueElement elem = {.type = UPDATE_GLYPH,
-                               .data.map = {.x = x, // NetHack coordinates
-                                            .y = y,
-                                            .glyph = glyphnum,
-                                            .ch = ch,
-                                            .color = color,
-                                            .glyphflags = glyphflags}};
-    render_queue_enqueue(g_render_queue, &elem);
+  // Coalesce: published as part of the next glyph batch
+  if (x < COLNO && y < ROWNO) {
+    mark_cell_dirty(x, y);
+
+    // Newly seen altar/fountain refreshes the snapshot's level feature index
+    extern void ios_game_state_note_cell(int x, int y);
+    ios_game_state_note_cell(x, y);
+    // ...and a first-seen feature glyph recounts the dungeon overview's level
+    ios_dungeon_overview_note_glyph(x, y, glyphnum);
   }
 
   map_dirty = TRUE;
@@ -1438,7 +1895,7 @@ static void ios_print_glyph(winid win, coordxy x, coordxy y,
     static int last_player_y = -1;
 
     if (last_player_x != x || last_player_y != y) {
-      WIN_LOG("Player moved to (%d,%d)", x, y);
+      IOS_LOG_D(IOS_LOG_CAT_RENDER, "Player moved to (%d,%d)", x, y);
       last_player_x = x;
       last_player_y = y;
       // No flush here - let wait_synch() handle it after docrt() completes
@@ -1456,76 +1913,66 @@ static void ios_raw_print(const char *str) {
 static void ios_raw_print_bold(const char *str) { ios_raw_print(str); }
 
 static int ios_nhgetch(void) {
-  WIN_LOG("nhgetch - waiting for input");
-
-  pthread_mutex_lock(&input_mutex);
+  IOS_LOG_D(IOS_LOG_CAT_INPUT, "waiting for input");
 
   // Check if input already queued
-  if (input_queue_head != input_queue_tail) {
-    char ch = input_queue[input_queue_head];
-    input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-    pthread_mutex_unlock(&input_mutex);
-    fprintf(stderr, "[NHGETCH] Got queued input: '%c' (0x%02x)\n",
-            isprint(ch) ? ch : '?', (unsigned char)ch);
+  char ch;
+  if (ios_input_ring_pop(&ch)) {
+    IOS_LOG_T(IOS_LOG_CAT_INPUT, "Got queued input: '%c' (0x%02x)",
+              isprint(ch) ? ch : '?', (unsigned char)ch);
+    ios_hibernate_key_taken();
     return ch;
   }
 
   // Wait for input
-  fprintf(stderr, "[NHGETCH] Blocking for user input...\n");
-  while (input_queue_head == input_queue_tail && game_thread_running) {
-    pthread_cond_wait(&input_cond, &input_mutex);
+  IOS_LOG_D(IOS_LOG_CAT_INPUT, "Blocking for user input...");
+  while (ios_input_ring_empty() && game_thread_running) {
+    wait_for_input(0);
   }
 
   // Check exit
-  if (!game_thread_running || input_queue_head == input_queue_tail) {
-    pthread_mutex_unlock(&input_mutex);
-    fprintf(stderr, "[NHGETCH] Interrupted or no input\n");
+  if (!game_thread_running || !ios_input_ring_pop(&ch)) {
+    IOS_LOG_I(IOS_LOG_CAT_INPUT, "Interrupted or no input");
     return '\033'; // ESC to cancel
   }
 
-  char ch = input_queue[input_queue_head];
-  input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-  pthread_mutex_unlock(&input_mutex);
-
-  fprintf(stderr, "[NHGETCH] Got input after wait: '%c' (0x%02x)\n",
-          isprint(ch) ? ch : '?', (unsigned char)ch);
+  IOS_LOG_T(IOS_LOG_CAT_INPUT, "Got input after wait: '%c' (0x%02x)",
+            isprint(ch) ? ch : '?', (unsigned char)ch);
+  ios_hibernate_key_taken();
   return ch;
 }
 
-// Single-threaded input queue
-// Thread-safe input queue with signaling (RESTORED FROM MAIN)
-void ios_queue_input(char ch) {
-  struct timespec ts;
-  clock_gettime(CLOCK_MONOTONIC, &ts);
-  double timestamp = ts.tv_sec + ts.tv_nsec / 1e9;
-
-  fprintf(stderr, "[%.3f] [INPUT] ios_queue_input START char=0x%02x\n", timestamp, (unsigned char)ch);
-
-  pthread_mutex_lock(&input_mutex);
-
-  int next_tail = (input_queue_tail + 1) % INPUT_QUEUE_SIZE;
-  if (next_tail != input_queue_head) {
-    int old_tail = input_queue_tail;
-    input_queue[input_queue_tail] = ch;
-    input_queue_tail = next_tail;
-    // Enhanced logging to show ALL characters including control codes
-    fprintf(stderr, "[%.3f] [INPUT] Queued char=0x%02x at tail=%d, new tail=%d, head=%d\n",
-            timestamp, (unsigned char)ch, old_tail, input_queue_tail, input_queue_head);
-
-    // Wake up game thread if it's waiting
-    // CRITICAL FIX: Use broadcast instead of signal to ensure wake-up
-    // Signal can be lost if thread is between queue check and timedwait
-    pthread_cond_broadcast(&input_cond);
-    fprintf(stderr, "[%.3f] [INPUT] pthread_cond_broadcast sent\n", timestamp);
-  } else {
-    fprintf(stderr, "[%.3f] [INPUT] QUEUE FULL - dropping char 0x%02x!\n", timestamp, (unsigned char)ch);
+// Queue keys as one command: all of them reach the game thread back to back,
+// or none do if the ring is full
+static int queue_keys(const char *keys, size_t count) {
+  // Timing: keep the oldest unpresented key, always stamp the latest one
+  uint64_t now = get_time_ns();
+  uint64_t none = 0;
+  atomic_compare_exchange_strong_explicit(&input_pending_ns, &none, now,
+                                          memory_order_relaxed,
+                                          memory_order_relaxed);
+  atomic_store_explicit(&last_input_ns, now, memory_order_relaxed);
+
+  if (!ios_input_ring_push(keys, count)) {
+    IOS_LOG_W(IOS_LOG_CAT_INPUT, "QUEUE FULL - dropping %zu key(s), first 0x%02x!",
+              count, (unsigned char)keys[0]);
+    return 0;
   }
+  IOS_LOG_T(IOS_LOG_CAT_INPUT, "Queued %zu key(s), first 0x%02x", count,
+            (unsigned char)keys[0]);
+  return 1;
+}
 
-  pthread_mutex_unlock(&input_mutex);
+// Thread-safe input queue - any thread, wakes the game thread if it is parked
+void ios_queue_input(char ch) {
+  queue_keys(&ch, 1);
+}
 
-  clock_gettime(CLOCK_MONOTONIC, &ts);
-  double end_time = ts.tv_sec + ts.tv_nsec / 1e9;
-  fprintf(stderr, "[%.3f] [INPUT] ios_queue_input END (took %.3fms)\n", end_time, (end_time - timestamp) * 1000);
+// Whole command string (count prefix, travel "_" sequence, "#loot\n", ...)
+int ios_queue_input_string(const char *keys) {
+  if (!keys || !*keys)
+    return 1;
+  return queue_keys(keys, strlen(keys));
 }
 
 // Request game thread to exit cleanly
@@ -1534,6 +1981,7 @@ void ios_request_game_exit(void) {
       stderr,
       "[EXIT] Setting exit flag - game will terminate after current turn\n");
   atomic_store(&game_should_exit, 1); // Thread-safe atomic write
+  ios_hibernate_discard(); // Exit to menu: the next launch restores the save
 
   // Set gameover flag to ensure proper cleanup
   extern struct sinfo program_state;
@@ -1542,10 +1990,8 @@ void ios_request_game_exit(void) {
   // CRITICAL FIX: Wake up thread if blocked in pthread_cond_wait()
   // The game thread may be waiting for input in ios_poskey() - signal it to
   // check exit flag
-  pthread_mutex_lock(&input_mutex);
-  game_thread_running = 0;          // CRITICAL: Reset thread running flag
-  pthread_cond_signal(&input_cond); // Wake up blocked thread!
-  pthread_mutex_unlock(&input_mutex);
+  game_thread_running = 0; // CRITICAL: Reset thread running flag
+  ios_input_ring_wake();   // Wake up blocked thread!
 
   fprintf(stderr, "[EXIT] ✓ Exit signaled and thread notified\n");
 }
@@ -1567,11 +2013,7 @@ static int game_ready_signaled = 0;
 
 // Blocking version of nh_poskey for game thread (RESTORED FROM MAIN)
 static int ios_nh_poskey_blocking(coordxy *x, coordxy *y, int *mod) {
-  struct timespec ts_perf;
-  clock_gettime(CLOCK_MONOTONIC, &ts_perf);
-  double timestamp = ts_perf.tv_sec + ts_perf.tv_nsec / 1e9;
-
-  fprintf(stderr, "[%.3f] [POSKEY] ios_nh_poskey_blocking START\n", timestamp);
+  IOS_LOG_D(IOS_LOG_CAT_INPUT, "START");
 
   // CRITICAL: First input wait for new games means game is initialized!
   // For restored games, ios_restore_complete() already sent the signal.
@@ -1583,42 +2025,51 @@ static int ios_nh_poskey_blocking(coordxy *x, coordxy *y, int *mod) {
     // Restored games already have character_creation_complete=1 from restore
     if (!character_creation_complete) {
       // NEW GAME: moveloop_preamble() has completed, all globals initialized
-      fprintf(stderr, "[%.3f] [POSKEY] 🎯 First input wait for NEW game - notifying Swift\n", timestamp);
+      IOS_LOG_I(IOS_LOG_CAT_INPUT, "First input wait for NEW game - notifying Swift");
       extern void ios_notify_game_ready(void);
       ios_notify_game_ready();
     } else {
       // RESTORED GAME: Signal already sent from ios_restore_complete(), don't duplicate
-      fprintf(stderr, "[%.3f] [POSKEY] Restored game - already signaled\n", timestamp);
+      IOS_LOG_I(IOS_LOG_CAT_INPUT, "Restored game - already signaled");
     }
   }
 
-  pthread_mutex_lock(&input_mutex);
+  // Only a wait that actually blocked measures wake-up latency
+  boolean blocked = ios_input_ring_empty();
+
+  // A command key wait (not getpos) is where the game can hibernate
+  extern struct sinfo program_state;
+  boolean command_key = program_state.input_state == commandInp;
+  ios_hibernate_set_command_wait(command_key);
+  if (command_key) {
+    ios_dungeon_overview_command_wait();  // Level entry, features, annotations
+    ios_hibernate_autosave_command_wait();  // Level change or N turns: queue an autosave
+    ios_action_macro_command_wait();  // A running macro queues its next step
+  }
 
   // Wait for input (blocks game thread)
-  // Use timedwait instead of wait to allow periodic exit flag checking
-  while (input_queue_head == input_queue_tail && game_thread_running) {
+  // Use a timed wait to allow periodic exit flag checking
+  while (ios_input_ring_empty() && game_thread_running) {
     // 10ms timeout for responsive input while allowing exit flag checking
-    struct timespec ts = {0, 10000000};
-    pthread_cond_timedwait_relative_np(&input_cond, &input_mutex, &ts);
+    wait_for_input(10);
+    if (command_key) {
+      ios_action_macro_command_wait();  // A macro submitted while we waited
+    }
 
     // Check exit flags after wake
-    extern struct sinfo program_state;
     if (atomic_load(&game_should_exit) || program_state.gameover) {
-      pthread_mutex_unlock(&input_mutex);
+      ios_hibernate_set_command_wait(false);
       return '\033';
     }
   }
+  ios_hibernate_set_command_wait(false);
 
   // Check if we should exit
-  if (!game_thread_running) {
-    pthread_mutex_unlock(&input_mutex);
+  char ch;
+  if (!game_thread_running || !ios_input_ring_pop(&ch)) {
     return '\033'; // ESC to quit
   }
-
-  // Get the input
-  char ch = input_queue[input_queue_head];
-  input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-  pthread_mutex_unlock(&input_mutex);
+  ios_hibernate_key_taken();  // The game moves on: a hibernation image is stale
 
   if (x)
     *x = 0;
@@ -1627,16 +2078,17 @@ static int ios_nh_poskey_blocking(coordxy *x, coordxy *y, int *mod) {
   if (mod)
     *mod = 0;
 
-  // Get current turn count for debugging
-  extern struct instance_globals_saved_m svm;
-  extern struct instance_flags iflags;
-  long current_turn = svm.moves;
+  key_returned_ns = get_time_ns();
+  if (blocked) {
+    uint64_t queued = atomic_load_explicit(&last_input_ns, memory_order_relaxed);
+    if (queued && queued <= key_returned_ns)
+      ios_frame_timing_record(FRAME_STAGE_INPUT_WAKE, key_returned_ns - queued);
+  }
 
-  clock_gettime(CLOCK_MONOTONIC, &ts_perf);
-  double end_time = ts_perf.tv_sec + ts_perf.tv_nsec / 1e9;
-  fprintf(stderr,
-          "[%.3f] [POSKEY] Returning '%c' (0x%02X) Turn=%ld (took %.3fms)\n",
-          end_time, isprint(ch) ? ch : '?', (unsigned char)ch, current_turn, (end_time - timestamp) * 1000);
+  // Turn count for debugging (ring records carry timestamps for wait time)
+  extern struct instance_globals_saved_m svm;
+  IOS_LOG_D(IOS_LOG_CAT_INPUT, "Returning '%c' (0x%02X) Turn=%ld",
+            isprint(ch) ? ch : '?', (unsigned char)ch, svm.moves);
 
   // Note: We don't need to mark map dirty here because wait_synch
   // will handle the update notification after NetHack processes the command
@@ -1650,11 +2102,10 @@ static int ios_nh_poskey(coordxy *x, coordxy *y, int *mod) {
     return ios_nh_poskey_blocking(x, y, mod);
   } else {
     // Use existing non-blocking version
-    if (input_queue_head == input_queue_tail) {
+    char ch;
+    if (!ios_input_ring_pop(&ch)) {
       return 0; // No input
     }
-    char ch = input_queue[input_queue_head];
-    input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
     if (x)
       *x = 0;
     if (y)
@@ -1688,7 +2139,7 @@ __attribute__((weak)) char ios_swift_yn_callback(const char *query,
   return 0; // 0 means "not handled by Swift"
 }
 
-// NOTE: Death animation callback is now registered via ios_set_death_animation_callback()
+// NOTE: Death animation start is an event bus event (IOS_EVENT_DEATH)
 // See trigger_death_animation() near top of file
 
 void ios_set_yn_mode(yn_response_mode_t mode) {
@@ -1713,7 +2164,7 @@ void ios_set_yn_callback(yn_callback_func callback) {
   custom_yn_callback = callback;
 }
 
-static char ios_yn_function(const char *query, const char *resp, char def) {
+static char ios_yn_function_live(const char *query, const char *resp, char def) {
   WIN_LOG("yn_function");
   fprintf(stderr, "[IOS_YN] Query: %s | resp: %s | def: %c\n",
           query ? query : "(null)", resp ? resp : "(null)", def);
@@ -1748,10 +2199,9 @@ static char ios_yn_function(const char *query, const char *resp, char def) {
   // CRITICAL FIX: Check input queue FIRST!
   // This enables atomic commands like "da" (drop item 'a')
   // ========================================
-  pthread_mutex_lock(&input_mutex);
-  if (input_queue_head != input_queue_tail) {
+  char ch;
+  if (ios_input_ring_peek(&ch)) {
     // PEEK without consuming - validate BEFORE removing from queue
-    char ch = input_queue[input_queue_head];
 
     fprintf(stderr, "[IOS_YN] Peeked queued input: '%c' (0x%02x)\n",
             isprint(ch) ? ch : '?', (unsigned char)ch);
@@ -1759,16 +2209,14 @@ static char ios_yn_function(const char *query, const char *resp, char def) {
     // Validate against allowed responses (if resp is provided)
     if (!resp || strchr(resp, ch)) {
       // VALID - now consume from queue
-      input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-      pthread_mutex_unlock(&input_mutex);
+      ios_input_ring_drop();
       fprintf(stderr, "[IOS_YN] Valid response, consumed and returning: '%c'\n", ch);
       return ch;
     }
 
     // INVALID - consume the bad input and return ESC to cancel
     // This prevents the infinite loop where invalid input was lost
-    input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-    pthread_mutex_unlock(&input_mutex);
+    ios_input_ring_drop();
     fprintf(stderr,
             "[IOS_YN] Invalid response '%c' for allowed set '%s', returning ESC to cancel\n",
             ch, resp ? resp : "(any)");
@@ -1840,16 +2288,12 @@ static char ios_yn_function(const char *query, const char *resp, char def) {
       fprintf(stderr, "[IOS_YN] Selection detected, blocking for input...\n");
 
       // Block and wait for input instead of falling back to mode
-      while (input_queue_head == input_queue_tail && game_thread_running) {
-        pthread_cond_wait(&input_cond, &input_mutex);
+      while (ios_input_ring_empty() && game_thread_running) {
+        wait_for_input(0);
       }
 
       // Check if we got input
-      if (input_queue_head != input_queue_tail) {
-        char ch = input_queue[input_queue_head];
-        input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-        pthread_mutex_unlock(&input_mutex);
-
+      if (ios_input_ring_pop(&ch)) {
         fprintf(stderr, "[IOS_YN] Got selection input: '%c' (0x%02x)\n",
                 isprint(ch) ? ch : '?', (unsigned char)ch);
         return ch;
@@ -1859,7 +2303,6 @@ static char ios_yn_function(const char *query, const char *resp, char def) {
       fprintf(stderr, "[IOS_YN] Game thread stopped, using fallback\n");
     }
 
-    pthread_mutex_unlock(&input_mutex);
     fprintf(stderr, "[IOS_YN] Queue empty, using mode-based response\n");
   }
   // ========================================
@@ -2046,6 +2489,24 @@ static char ios_yn_function(const char *query, const char *resp, char def) {
   return result;
 }
 
+/* Every answer is journaled after the keys it consumed: a replay feeds
+ * those keys to the live path, then takes the answer (mode default,
+ * callback override or next_yn_response) as recorded. */
+static char ios_yn_function(const char *query, const char *resp, char def) {
+  char answer;
+  if (ios_replay_yn(&answer)) {
+    return answer;  // Answered without keys
+  }
+  answer = ios_yn_function_live(query, resp, def);
+  if (ios_is_replaying()) {
+    char journaled;
+    if (ios_replay_yn(&journaled)) answer = journaled;
+  } else {
+    ios_journal_note_yn(answer);
+  }
+  return answer;
+}
+
 // Extern declaration for text input notification
 extern void ios_request_text_input(const char *prompt, const char *input_type);
 
@@ -2099,32 +2560,25 @@ static void ios_getlin(const char *query, char *bufp) {
 
   fprintf(stderr, "[GETLIN] Reading text from input queue...\n");
 
-  pthread_mutex_lock(&input_mutex);
-
   while (bufidx < BUFSZ - 1) {
     // Wait for input if queue is empty
-    while (input_queue_head == input_queue_tail && game_thread_running) {
-      pthread_cond_wait(&input_cond, &input_mutex);
+    while (ios_input_ring_empty() && game_thread_running) {
+      wait_for_input(0);
     }
 
-    // Check for exit
-    if (!game_thread_running) {
-      pthread_mutex_unlock(&input_mutex);
+    // Check for exit, then get character from queue
+    char ch;
+    if (!game_thread_running || !ios_input_ring_pop(&ch)) {
       fprintf(stderr, "[GETLIN] Game thread stopped, returning empty\n");
       bufp[0] = '\0';
       return;
     }
 
-    // Get character from queue
-    char ch = input_queue[input_queue_head];
-    input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-
     fprintf(stderr, "[GETLIN] Got char: '%c' (0x%02x)\n",
             isprint(ch) ? ch : '?', (unsigned char)ch);
 
     // Handle special characters
     if (ch == '\033') {  // ESC - cancel
-      pthread_mutex_unlock(&input_mutex);
       fprintf(stderr, "[GETLIN] ESC pressed, canceling\n");
       // CRITICAL: Return ESC char, NOT empty string!
       // NetHack's do_genocide() checks: if (*buf == '\033') return;
@@ -2144,7 +2598,6 @@ static void ios_getlin(const char *query, char *bufp) {
     }
   }
 
-  pthread_mutex_unlock(&input_mutex);
   bufp[bufidx] = '\0';
 
   fprintf(stderr, "[GETLIN] Returning text: \"%s\"\n", bufp);
@@ -2165,31 +2618,24 @@ static int ios_get_ext_cmd(void) {
   fprintf(stderr, "[EXT_CMD] Reading extended command from input queue...\n");
 
   // Read characters until newline, ESC, or buffer full
-  pthread_mutex_lock(&input_mutex);
-
   while (bufidx < BUFSZ - 1) {
     // Wait for input if queue is empty
-    while (input_queue_head == input_queue_tail && game_thread_running) {
-      pthread_cond_wait(&input_cond, &input_mutex);
+    while (ios_input_ring_empty() && game_thread_running) {
+      wait_for_input(0);
     }
 
-    // Check for exit
-    if (!game_thread_running) {
-      pthread_mutex_unlock(&input_mutex);
+    // Check for exit, then get character from queue
+    char ch;
+    if (!game_thread_running || !ios_input_ring_pop(&ch)) {
       fprintf(stderr, "[EXT_CMD] Game thread stopped, canceling\n");
       return -1;
     }
 
-    // Get character from queue
-    char ch = input_queue[input_queue_head];
-    input_queue_head = (input_queue_head + 1) % INPUT_QUEUE_SIZE;
-
     fprintf(stderr, "[EXT_CMD] Got char: '%c' (0x%02x)\n",
             isprint(ch) ? ch : '?', (unsigned char)ch);
 
     // Handle special characters
     if (ch == '\033') {  // ESC - cancel
-      pthread_mutex_unlock(&input_mutex);
       fprintf(stderr, "[EXT_CMD] ESC pressed, canceling\n");
       return -1;
     }
@@ -2204,7 +2650,6 @@ static int ios_get_ext_cmd(void) {
     }
   }
 
-  pthread_mutex_unlock(&input_mutex);
   buf[bufidx] = '\0';
 
   fprintf(stderr, "[EXT_CMD] Command name: \"%s\"\n", buf);
@@ -2240,91 +2685,43 @@ static void ios_number_pad(int num) { WIN_LOG("number_pad"); }
 
 // REMOVED: ios_flush_map() - replaced by queue-based rendering
 
-// Adaptive throttling state for delay_output
-static volatile int delay_update_pending = 0;
-static int consecutive_drops = 0;
-static uint64_t last_dispatch_time_ns = 0;
-
-// Helper to get current time in nanoseconds
-static uint64_t get_time_ns(void) {
-  struct timespec ts;
-  clock_gettime(CLOCK_MONOTONIC, &ts);
-  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
-}
-
 static void ios_delay_output(void) {
-  /* Called during travel/run to show intermediate steps
-   *
-   * ADAPTIVE FRAME TIMING FIX:
-   * - Problem: Dropping too many frames caused teleport effect (user can't see
-   * steps!)
-   * - Old approach: Simple throttle → dropped frames silently → teleport
-   * - New approach: Adaptive timing with intelligent sleeps
+  /* Called once per intermediate step of travel/run, and per frame of
+   * effect animations (zaps, thrown objects, explosions via tmp_at).
    *
-   * Strategy:
-   * 1. Measure actual UI render time
-   * 2. If UI is lagging (consecutive drops), slow down NetHack with small sleep
-   * 3. Adjust sleep time based on measured render performance
-   * 4. Show ALMOST EVERY step (max 2 consecutive drops before tactical pause)
+   * TRAVEL/RUN: no pacing on the game thread. The hero's position goes
+   * into the travel step buffer and the engine carries on at full speed;
+   * map deltas coalesce into the next flush. TravelAnimator.swift replays
+   * the path one step per display refresh at the chosen animation speed,
+   * so total travel time no longer depends on how fast this thread runs or
+   * how many frames the device dropped.
    *
-   * Root Cause: Rate mismatch between NetHack (100+ steps/sec) and iOS (60 FPS)
-   * Solution: Intelligent pacing that respects both performance and UX
+   * EFFECTS: the beam/missile glyph only exists for this frame, so it is
+   * flushed and shown now. One notify is in flight at a time; frames the
+   * main thread hasn't picked up yet are skipped (no sleep).
    */
 
-  // PHASE 1: Measure UI render time
-  uint64_t now = get_time_ns();
-  uint64_t elapsed_ns =
-      (last_dispatch_time_ns > 0) ? (now - last_dispatch_time_ns) : 0;
-  uint64_t elapsed_ms = elapsed_ns / 1000000ULL;
-
-  // PHASE 2: Adaptive throttling - drop frames only if necessary
-  if (delay_update_pending) {
-    consecutive_drops++;
-
-    // If we're dropping too many frames, SLOW DOWN NetHack
-    // This ensures user sees most steps instead of teleporting
-    if (consecutive_drops > 2) {
-      // UI is lagging - give it breathing room
-      // 5ms tactical pause is imperceptible but prevents excessive drops
-      usleep(5000);
-    }
+  if (ios_is_headless()) {
+    return; // No UI to pace against: run at engine speed
+  }
 
-    return; // Skip this frame (but we'll show the next one!)
+  if (svc.context.run || svc.context.travel) {
+    ios_travel_steps_push(u.ux, u.uy, (int64_t)svm.moves);
+    return;
   }
 
-  // Successfully rendering - reset consecutive drop counter
-  consecutive_drops = 0;
-  delay_update_pending = 1;
-  last_dispatch_time_ns = now;
+  if (ios_event_bus_in_flight()) {
+    return; // Main thread still drawing the previous effect frame
+  }
 
-  // Capture current map state
+  flush_glyph_deltas();
   ios_capture_map();
 
-  // Notify Swift UI (non-blocking dispatch)
-  dispatch_async(dispatch_get_main_queue(), ^{
-    ios_notify_map_changed();
-    delay_update_pending = 0;
-  });
-
-  // PHASE 3: Intelligent pacing - control movement SPEED (not FPS!)
-  // User wants: 60 FPS smooth rendering BUT slower character movement
-  // Solution: Longer sleeps = NetHack generates steps slower = character moves
-  // slower
-  //           But UI still renders at 60 FPS (smooth!)
-  if (elapsed_ms < 16) {
-    // UI renders fast (60 FPS) - slow down character movement
-    // Each step visible longer for better perception
-    usleep(30000); // 30ms per step = ~33 steps/sec, smooth at 60 FPS
-  } else if (elapsed_ms < 33) {
-    // UI at 30-60 FPS - slightly slower movement
-    usleep(35000); // 35ms per step = ~28 steps/sec
-  } else {
-    // UI slow (<30 FPS) - much slower movement
-    usleep(40000); // 40ms per step = ~25 steps/sec
-  }
+  ios_event_post(IOS_EVENT_MAP_CHANGED);
+  ios_event_bus_flush();
 
-  // Result: User sees smooth step-by-step animation at device-appropriate FPS
-  // No teleport, no memory leak, no stuttering!
+  // Effect frames need a visible duration; one display frame at 60Hz
+  usleep(16000);
 }
 
 // REMOVED: ios_start_screen() and ios_end_screen() - not used in iOS
@@ -2334,6 +2731,8 @@ static void ios_outrip(winid win, int how, time_t when) { WIN_LOG("outrip"); }
 
 static void ios_preference_update(const char *pref) {
   WIN_LOG("preference_update");
+  // Symset / color options change glyph mapping - rebuild before next draw
+  glyph_table_stale = TRUE;
 }
 
 static char *ios_getmsghistory(boolean init) {
@@ -2349,6 +2748,7 @@ static void ios_status_init(void) {
   WIN_LOG("status_init - Initializing iOS status display");
   /* Initialize status window with all fields */
   memset(&current_stats, 0, sizeof(current_stats));
+  status_changed = STATUS_FIELD_ALL;  /* Next flush pushes every field */
   /* Status initialization complete */
 }
 
@@ -2356,12 +2756,14 @@ static void ios_status_finish(void) {
   WIN_LOG("status_finish - Cleaning up iOS status display");
   /* Clean up status resources */
   memset(&current_stats, 0, sizeof(current_stats));
+  status_changed = STATUS_FIELD_ALL;  /* Next flush pushes every field */
 }
 
 /* PUBLIC: Clear status cache (called after restore to prevent corruption) */
 NETHACK_EXPORT void ios_clear_status_cache(void) {
   WIN_LOG("🧹 ios_clear_status_cache() - Clearing cached status");
   memset(&current_stats, 0, sizeof(current_stats));
+  status_changed = STATUS_FIELD_ALL;  /* Next flush pushes every field */
 }
 
 static void ios_status_enablefield(int fieldidx, const char *nm,
@@ -2422,64 +2824,66 @@ static void ios_status_update(int idx, genericptr_t ptr, int chg, int percent,
    */
   switch (idx) {
   case BL_HP:
-    current_stats.hp = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(hp, STATUS_FIELD_HP, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("HP updated: %d", current_stats.hp);
     break;
   case BL_HPMAX:
-    current_stats.hpmax = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(hpmax, STATUS_FIELD_HPMAX, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("HP Max updated: %d", current_stats.hpmax);
     break;
   case BL_ENE:
-    current_stats.pw = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(pw, STATUS_FIELD_PW, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("Power updated: %d", current_stats.pw);
     break;
   case BL_ENEMAX:
-    current_stats.pwmax = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(pwmax, STATUS_FIELD_PWMAX, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("Power Max updated: %d", current_stats.pwmax);
     break;
   case BL_XP:
-    current_stats.level = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(level, STATUS_FIELD_LEVEL, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("Level updated: %d", current_stats.level);
     break;
   case BL_EXP:
-    current_stats.exp = strtol((char *)ptr, NULL, 10);
+    STATUS_SET(exp, STATUS_FIELD_EXP, strtol((char *)ptr, NULL, 10));
     WIN_LOG("Experience updated: %ld", current_stats.exp);
     break;
   case BL_AC:
-    current_stats.ac = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(ac, STATUS_FIELD_AC, (int)strtol((char *)ptr, NULL, 10));
     WIN_LOG("AC updated: %d", current_stats.ac);
     break;
   case BL_GOLD:
-    current_stats.gold = strtoll((char *)ptr, NULL, 10);
+    STATUS_SET(gold, STATUS_FIELD_GOLD, (long)strtoll((char *)ptr, NULL, 10));
     WIN_LOG("Gold updated: %lld", current_stats.gold);
     break;
   case BL_TIME:
-    current_stats.moves = strtol((char *)ptr, NULL, 10);
+    STATUS_SET(moves, STATUS_FIELD_MOVES, strtol((char *)ptr, NULL, 10));
     WIN_LOG("Moves updated: %ld", current_stats.moves);
     break;
   case BL_STR:
-    current_stats.str = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(str, STATUS_FIELD_STR, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_DX:
-    current_stats.dex = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(dex, STATUS_FIELD_DEX, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_CO:
-    current_stats.con = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(con, STATUS_FIELD_CON, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_IN:
-    current_stats.intel = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(intel, STATUS_FIELD_INT, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_WI:
-    current_stats.wis = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(wis, STATUS_FIELD_WIS, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_CH:
-    current_stats.cha = (int)strtol((char *)ptr, NULL, 10);
+    STATUS_SET(cha, STATUS_FIELD_CHA, (int)strtol((char *)ptr, NULL, 10));
     break;
   case BL_ALIGN:
-    if (ptr) {
+    if (ptr && strncmp(current_stats.align, (char *)ptr,
+                       sizeof(current_stats.align) - 1) != 0) {
       strncpy(current_stats.align, (char *)ptr,
               sizeof(current_stats.align) - 1);
       current_stats.align[sizeof(current_stats.align) - 1] = '\0';
+      status_changed |= STATUS_FIELD_ALIGN;
     }
     break;
   case BL_HUNGER:
@@ -2488,29 +2892,31 @@ static void ios_status_update(int idx, genericptr_t ptr, int chg, int percent,
      * Convert to numeric: 0=Satiated, 1=Normal, 2=Hungry, 3=Weak, 4=Fainting, 5=Fainted, 6=Starved */
     if (ptr) {
       const char *hunger_str = (const char *)ptr;
+      int hunger;
       if (!hunger_str[0] || !strcmp(hunger_str, " ")) {
-        current_stats.hunger = 1;  /* NOT_HUNGRY (normal) */
+        hunger = 1;  /* NOT_HUNGRY (normal) */
       } else if (strstr(hunger_str, "Satiated")) {
-        current_stats.hunger = 0;
+        hunger = 0;
       } else if (strstr(hunger_str, "Hungry")) {
-        current_stats.hunger = 2;
+        hunger = 2;
       } else if (strstr(hunger_str, "Weak")) {
-        current_stats.hunger = 3;
+        hunger = 3;
       } else if (strstr(hunger_str, "Fainting")) {
-        current_stats.hunger = 4;
+        hunger = 4;
       } else if (strstr(hunger_str, "Fainted")) {
-        current_stats.hunger = 5;
+        hunger = 5;
       } else if (strstr(hunger_str, "Starved")) {
-        current_stats.hunger = 6;
+        hunger = 6;
       } else {
-        current_stats.hunger = 1;  /* Default to normal */
+        hunger = 1;  /* Default to normal */
       }
+      STATUS_SET(hunger, STATUS_FIELD_HUNGER, hunger);
       WIN_LOG("Hunger updated: %d (from '%s')", current_stats.hunger, hunger_str);
     }
     break;
   case BL_CONDITION:
     /* ptr is unsigned long* containing 30-bit condition bitmask */
-    current_stats.conditions = *(unsigned long *)ptr;
+    STATUS_SET(conditions, STATUS_FIELD_CONDITIONS, *(unsigned long *)ptr);
     WIN_LOG("Conditions updated: 0x%lx", current_stats.conditions);
     break;
   case BL_RESET:
@@ -2518,37 +2924,44 @@ static void ios_status_update(int idx, genericptr_t ptr, int chg, int percent,
     /* Reset could mean we should clear stats, but often it means "refresh all"
      */
     memset(&current_stats, 0, sizeof(current_stats));
+    status_changed = STATUS_FIELD_ALL;
     break;
   case BL_FLUSH:
     WIN_LOG("Status flush requested");
-    /* Flush means all pending updates are done - enqueue status to render queue
+    /* Binary HUD block for Swift polls (counter moves only on change) */
+    ios_status_block_publish(current_stats.conditions);
+
+    /* Flush means all pending updates are done - one StatusUpdate carries
+     * everything that changed since the last one (nothing changed: no push)
      */
-    if (g_render_queue) {
-      RenderQueueElement elem = {
-          .type = UPDATE_STATUS,
-          .data.status = {.hp = current_stats.hp,
-                          .hpmax = current_stats.hpmax,
-                          .pw = current_stats.pw,
-                          .pwmax = current_stats.pwmax,
-                          .level = current_stats.level,
-                          .exp = current_stats.exp,
-                          .ac = current_stats.ac,
-                          .str = current_stats.str,
-                          .dex = current_stats.dex,
-                          .con = current_stats.con,
-                          .intel = current_stats.intel,
-                          .wis = current_stats.wis,
-                          .cha = current_stats.cha,
-                          .gold = current_stats.gold,
-                          .moves = current_stats.moves,
-                          .hunger = current_stats.hunger,
-                          .conditions = current_stats.conditions}};
+    if (status_changed && g_render_queue && !ios_is_headless()) {
+      StatusUpdate status = {.hp = current_stats.hp,
+                             .hpmax = current_stats.hpmax,
+                             .pw = current_stats.pw,
+                             .pwmax = current_stats.pwmax,
+                             .level = current_stats.level,
+                             .exp = current_stats.exp,
+                             .ac = current_stats.ac,
+                             .str = current_stats.str,
+                             .dex = current_stats.dex,
+                             .con = current_stats.con,
+                             .intel = current_stats.intel,
+                             .wis = current_stats.wis,
+                             .cha = current_stats.cha,
+                             .gold = current_stats.gold,
+                             .moves = current_stats.moves,
+                             .hunger = current_stats.hunger,
+                             .conditions = current_stats.conditions,
+                             .changed = status_changed};
       // Copy align string separately
-      strncpy(elem.data.status.align, current_stats.align,
-              sizeof(elem.data.status.align) - 1);
-      elem.data.status.align[sizeof(elem.data.status.align) - 1] = '\0';
+      strncpy(status.align, current_stats.align, sizeof(status.align) - 1);
+      status.align[sizeof(status.align) - 1] = '\0';
 
-      render_queue_enqueue(g_render_queue, &elem);
+      // Payload goes through the status lane; the element carries a slot ref.
+      // A full lane keeps the bits for the next flush.
+      if (render_queue_enqueue_status(g_render_queue, &status)) {
+        status_changed = 0;
+      }
     }
     break;
   default:
@@ -2652,7 +3065,7 @@ NETHACK_EXPORT struct window_procs ios_procs = {
 /* Get player stats for Swift access */
 PlayerStats *ios_get_player_stats(void) { return &current_stats; }
 
-/* Get player stats as JSON string */
+/* Get player stats as JSON string (HUD polling: ios_get_status_block_if_newer) */
 const char *ios_get_player_stats_json(void) {
   static char json_buffer[512];
 
@@ -2677,19 +3090,16 @@ const char *ios_get_player_stats_json(void) {
 
 /* Check if there is pending input in the queue */
 int ios_has_pending_input(void) {
-  return (input_queue_head != input_queue_tail) ? 1 : 0;
+  return ios_input_ring_empty() ? 0 : 1;
 }
 
-/* Queue a string of commands */
+/* Queue a string of commands (as one batch, see ios_queue_input_string) */
 void ios_queue_command(const char *cmd) {
   if (!cmd)
     return;
 
-  fprintf(stderr, "[INPUT] Queueing command: \"%s\"\n", cmd);
-  while (*cmd) {
-    ios_queue_input(*cmd);
-    cmd++;
-  }
+  IOS_LOG_D(IOS_LOG_CAT_INPUT, "Queueing command: \"%s\"", cmd);
+  ios_queue_input_string(cmd);
 }
 
 /* Initialize iOS window procedures */
@@ -2938,6 +3348,10 @@ void ios_setup_default_symbols(void) {
 
   fprintf(stderr,
           "[IOS_SYMBOLS] ✓ Boulder symbol set to '0' and cache refreshed\n");
+
+  // Symbols are final now - precompute glyph render attributes
+  glyph_table_stale = TRUE;
+  build_glyph_table();
 }
 
 /*
@@ -2974,11 +3388,7 @@ void ios_reset_all_static_state(void) {
 
   // 3. INPUT QUEUE SYSTEM (lines 67-68)
   fprintf(stderr, "[IOS_RESET] Clearing input queue...\n");
-  pthread_mutex_lock(&input_mutex);
-  memset(input_queue, 0, INPUT_QUEUE_SIZE);
-  input_queue_head = 0;
-  input_queue_tail = 0;
-  pthread_mutex_unlock(&input_mutex);
+  ios_input_ring_clear();
 
   // 4. EXIT FLAG (line 119 - atomic version)
   fprintf(stderr, "[IOS_RESET] Resetting exit flag...\n");
@@ -2986,16 +3396,10 @@ void ios_reset_all_static_state(void) {
 
   // 5. MENU SYSTEM (lines 481-484, 522)
   fprintf(stderr, "[IOS_RESET] Clearing menu system...\n");
-  menu_item_count = 0;
+  menu_store_reset();
   current_menu_win = 0;
   menu_is_active = FALSE;
-  memset(last_menu_prompt, 0, sizeof(last_menu_prompt));
   memset(menu_items, 0, sizeof(menu_items));       // Clear menu items array
-  memset(menu_selectors, 0, sizeof(menu_selectors)); // Clear menu selectors array
-  memset(menu_texts, 0, sizeof(menu_texts));       // Clear menu text array
-  memset(menu_glyphs, 0, sizeof(menu_glyphs));     // Clear menu glyph array
-  memset(menu_attributes, 0, sizeof(menu_attributes)); // Clear menu attributes array
-  memset(menu_itemflags, 0, sizeof(menu_itemflags)); // Clear menu itemflags array
 
   // Menu callback stays registered - don't reset swift_menu_callback
 
@@ -3004,6 +3408,20 @@ void ios_reset_all_static_state(void) {
   old_player_x = -1;
   old_player_y = -1;
 
+  // 6b. GLYPH DELTA COALESCING
+  fprintf(stderr, "[IOS_RESET] Clearing dirty map cells...\n");
+  discard_dirty_cells();
+  map_generation = 0;
+  map_export_pending_rows = MAP_EXPORT_ALL_ROWS; // Version keeps counting up
+
+  // 6c. GLYPH RENDER TABLE (rebuilt on first draw; generation keeps counting)
+  glyph_table_stale = TRUE;
+  glyph_table_graphics = -1;
+
+  // 6d. TURN TIMING STAMPS (histograms persist; ios_frame_timing_reset clears)
+  key_returned_ns = 0;
+  atomic_store(&input_pending_ns, 0);
+
   // 7. Y/N SYSTEM (lines 912-914)
   fprintf(stderr, "[IOS_RESET] Clearing Y/N response system...\n");
   current_yn_mode = YN_MODE_DEFAULT;
@@ -3018,11 +3436,9 @@ void ios_reset_all_static_state(void) {
   game_started = 0;
   character_creation_complete = 0;
 
-  // 9. DELAY OUTPUT THROTTLING (lines 1273-1275)
-  fprintf(stderr, "[IOS_RESET] Resetting delay_output throttling...\n");
-  delay_update_pending = 0;
-  consecutive_drops = 0;
-  last_dispatch_time_ns = 0;
+  // 9. DELAY OUTPUT STATE (pending travel steps; events reset with the message state)
+  fprintf(stderr, "[IOS_RESET] Resetting delay_output state...\n");
+  ios_travel_steps_clear();
 
   // 10. GAME READY SIGNAL FLAG (line 966)
   fprintf(stderr, "[IOS_RESET] Resetting game ready signal flag...\n");
@@ -3048,40 +3464,14 @@ void ios_reset_all_static_state(void) {
  * ============================================================================
  *
  * Functions to access monster kill statistics for the death screen.
- * Uses svm.mvitals[] array which tracks born/died counts per monster type.
+ * Totals and ranking are maintained from svm.mvitals[] by ios_kill_stats.
  */
 
-/* Get total number of monsters killed */
-int ios_get_total_kills(void) {
-    extern struct instance_globals_saved_m svm;
-    extern struct sinfo program_state;
-    /* Guard: only access if game is running or game over */
-    if (!program_state.in_moveloop && !program_state.gameover) {
-        return 0;
-    }
-    int total = 0;
-    for (int i = LOW_PM; i < NUMMONS; i++) {
-        total += svm.mvitals[i].died;
-    }
-    return total;
-}
+/* Get total number of monsters killed (running total, ios_kill_stats.h) */
+int ios_get_total_kills(void) { return ios_kill_stats_total(); }
 
 /* Get number of unique monster types killed */
-int ios_get_unique_kills_count(void) {
-    extern struct instance_globals_saved_m svm;
-    extern struct sinfo program_state;
-    /* Guard: only access if game is running or game over */
-    if (!program_state.in_moveloop && !program_state.gameover) {
-        return 0;
-    }
-    int count = 0;
-    for (int i = LOW_PM; i < NUMMONS; i++) {
-        if (svm.mvitals[i].died > 0) {
-            count++;
-        }
-    }
-    return count;
-}
+int ios_get_unique_kills_count(void) { return ios_kill_stats_unique(); }
 
 /* Get kill count for specific monster type */
 int ios_get_monster_kills(int mndx) {
@@ -3102,46 +3492,7 @@ const char* ios_get_monster_name(int mndx) {
 
 /* Fill arrays with top N monster kills (sorted by kill count descending) */
 int ios_get_top_kills(int* indices, int* counts, int max_results) {
-    extern struct instance_globals_saved_m svm;
-    if (!indices || !counts || max_results <= 0) {
-        return 0;
-    }
-
-    /* First collect all monsters with kills */
-    int all_indices[NUMMONS];
-    int all_counts[NUMMONS];
-    int num_killed = 0;
-
-    for (int i = LOW_PM; i < NUMMONS; i++) {
-        if (svm.mvitals[i].died > 0) {
-            all_indices[num_killed] = i;
-            all_counts[num_killed] = svm.mvitals[i].died;
-            num_killed++;
-        }
-    }
-
-    /* Simple bubble sort by kill count (descending) */
-    for (int i = 0; i < num_killed - 1; i++) {
-        for (int j = 0; j < num_killed - i - 1; j++) {
-            if (all_counts[j] < all_counts[j + 1]) {
-                int tmp_idx = all_indices[j];
-                int tmp_cnt = all_counts[j];
-                all_indices[j] = all_indices[j + 1];
-                all_counts[j] = all_counts[j + 1];
-                all_indices[j + 1] = tmp_idx;
-                all_counts[j + 1] = tmp_cnt;
-            }
-        }
-    }
-
-    /* Copy top N to output arrays */
-    int result_count = num_killed < max_results ? num_killed : max_results;
-    for (int i = 0; i < result_count; i++) {
-        indices[i] = all_indices[i];
-        counts[i] = all_counts[i];
-    }
-
-    return result_count;
+    return ios_kill_stats_top(indices, counts, max_results);
 }
 
 /*
@@ -3151,154 +3502,9 @@ int ios_get_top_kills(int* indices, int* counts, int max_results) {
  *
  * Functions to access dungeon level information for native iOS UI.
  * Exposes the mapseen chain data that NetHack uses for #overview command.
+ * The visited-level records themselves live in ios_dungeon_overview.c.
  */
 
-/* Refresh dungeon overview data - calls recalc_mapseen() to ensure up-to-date */
-void ios_refresh_dungeon_overview(void) {
-    extern struct sinfo program_state;
-    if (!program_state.in_moveloop && !program_state.gameover) {
-        return;
-    }
-    /* Call NetHack's internal function to recalculate level data */
-    extern void recalc_mapseen(void);
-    recalc_mapseen();
-}
-
-/* Get total count of visited dungeon levels */
-int ios_get_visited_level_count(void) {
-    extern struct instance_globals_saved_m svm;
-    extern struct sinfo program_state;
-
-    if (!program_state.in_moveloop && !program_state.gameover) {
-        return 0;
-    }
-
-    int count = 0;
-    mapseen *mptr;
-    for (mptr = svm.mapseenchn; mptr; mptr = mptr->next) {
-        count++;
-    }
-    return count;
-}
-
-/* Get dungeon level info by index */
-bool ios_get_dungeon_level_info(int index, DungeonLevelInfo *out) {
-    extern struct instance_globals_saved_m svm;
-    extern struct instance_globals_saved_d svd;
-    extern struct instance_globals_saved_n svn;
-    extern struct sinfo program_state;
-    extern struct you u;
-
-    if (!out) return false;
-    if (!program_state.in_moveloop && !program_state.gameover) {
-        return false;
-    }
-
-    /* Find the mapseen entry at given index */
-    mapseen *mptr = svm.mapseenchn;
-    int current = 0;
-    while (mptr && current < index) {
-        mptr = mptr->next;
-        current++;
-    }
-
-    if (!mptr) return false;
-
-    /* Zero out the output struct */
-    memset(out, 0, sizeof(DungeonLevelInfo));
-
-    /* Basic level info */
-    out->dnum = mptr->lev.dnum;
-    out->dlevel = mptr->lev.dlevel;
-
-    /* Dungeon name */
-    if (mptr->lev.dnum >= 0 && mptr->lev.dnum < svn.n_dgns) {
-        strncpy(out->dungeon_name, svd.dungeons[mptr->lev.dnum].dname,
-                sizeof(out->dungeon_name) - 1);
-    }
-
-    /* Calculate depth - special cases for quest/knox */
-    int depthstart;
-    /* quest_dnum and knox_level are macros defined in hack.h */
-    int qdnum = quest_dnum;  /* macro from hack.h */
-    int kdnum = knox_level.dnum;  /* knox_level is a macro expanding to svd.dungeon_topology.d_knox_level */
-
-    if (mptr->lev.dnum == qdnum || mptr->lev.dnum == kdnum) {
-        depthstart = 1;
-    } else if (mptr->lev.dnum >= 0 && mptr->lev.dnum < svn.n_dgns) {
-        depthstart = svd.dungeons[mptr->lev.dnum].depth_start;
-    } else {
-        depthstart = 1;
-    }
-    out->depth = depthstart + mptr->lev.dlevel - 1;
-
-    /* Features */
-    out->shops = mptr->feat.nshop;
-    out->temples = mptr->feat.ntemple;
-    out->altars = mptr->feat.naltar;
-    out->fountains = mptr->feat.nfount;
-    out->thrones = mptr->feat.nthrone;
-    out->graves = mptr->feat.ngrave;
-    out->sinks = mptr->feat.nsink;
-    out->trees = mptr->feat.ntree;
-    out->shop_type = mptr->feat.shoptype;
-
-    /* Special location flags */
-    unsigned int flags = 0;
-    if (mptr->flags.oracle) flags |= DUNGEON_FLAG_ORACLE;
-    if (mptr->flags.sokosolved) flags |= DUNGEON_FLAG_SOKOBAN_SOLVED;
-    if (mptr->flags.bigroom) flags |= DUNGEON_FLAG_BIGROOM;
-    if (mptr->flags.castle) flags |= DUNGEON_FLAG_CASTLE;
-    if (mptr->flags.valley) flags |= DUNGEON_FLAG_VALLEY;
-    if (mptr->flags.msanctum) flags |= DUNGEON_FLAG_SANCTUM;
-    if (mptr->flags.ludios) flags |= DUNGEON_FLAG_LUDIOS;
-    if (mptr->flags.roguelevel) flags |= DUNGEON_FLAG_ROGUE;
-    if (mptr->flags.vibrating_square) flags |= DUNGEON_FLAG_VIB_SQUARE;
-    if (mptr->flags.questing) flags |= DUNGEON_FLAG_QUEST_HOME;
-    if (mptr->flags.quest_summons) flags |= DUNGEON_FLAG_QUEST_SUMMONS;
-    out->special_flags = flags;
-
-    /* Player annotation */
-    if (mptr->custom) {
-        strncpy(out->annotation, mptr->custom, sizeof(out->annotation) - 1);
-    }
-
-    /* Branch connection */
-    if (mptr->br) {
-        int end_dnum = mptr->br->end2.dnum;
-        if (end_dnum >= 0 && end_dnum < svn.n_dgns) {
-            strncpy(out->branch_to, svd.dungeons[end_dnum].dname,
-                    sizeof(out->branch_to) - 1);
-        }
-        /* Determine branch type */
-        switch (mptr->br->type) {
-            case BR_PORTAL:
-                out->branch_type = BRANCH_TYPE_PORTAL;
-                break;
-            case BR_STAIR:
-                out->branch_type = mptr->br->end1_up ? BRANCH_TYPE_STAIRS_UP
-                                                      : BRANCH_TYPE_STAIRS_DOWN;
-                break;
-            default:
-                out->branch_type = BRANCH_TYPE_NONE;
-                break;
-        }
-    }
-
-    /* Current level check */
-    out->is_current_level = (u.uz.dnum == mptr->lev.dnum &&
-                             u.uz.dlevel == mptr->lev.dlevel) ? 1 : 0;
-
-    /* Forgotten flag */
-    out->is_forgotten = mptr->flags.forgot ? 1 : 0;
-
-    /* Bones flag */
-    out->has_bones = (mptr->final_resting_place != NULL ||
-                      mptr->flags.knownbones) ? 1 : 0;
-
-    return true;
-}
-
 /* Get count of distinct dungeons visited */
 int ios_get_dungeon_count(void) {
     extern struct instance_globals_saved_n svn;
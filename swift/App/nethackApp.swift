@@ -22,6 +22,8 @@ struct nethackApp: App {
         #else
         Log.setLevel(.info)
         #endif
+
+        MemoryPressureMonitor.shared.start()
     }
 
     var body: some Scene {
@@ -41,13 +43,16 @@ struct nethackApp: App {
             // App is entering background - save happens automatically on exitToMenu()
             print("[App] Entering background - game will be saved on next exit")
             // NOTE: Background save removed - users must explicitly exit to save
-            // This gives them control over save timing
+            // This gives them control over save timing. A hibernation image
+            // covers a background kill: the next launch resumes from it.
+            NetHackBridge.shared.hibernateForBackground()
         case .inactive:
             // App is becoming inactive (e.g., control center, app switcher)
             print("[App] App becoming inactive")
         case .active:
             // App is becoming active
             print("[App] App becoming active")
+            NetHackBridge.shared.cancelHibernation()
         @unknown default:
             break
         }
@@ -231,36 +231,3 @@ private func loadFileAsString(path: String, filename: String) -> UnsafeMutablePo
         return nil
     }
 }
-
-// MARK: - Death Animation Callback
-
-/// C function pointer type for death animation callback
-typealias DeathAnimationCallback = @convention(c) () -> Void
-
-/// C function to register the callback - imported from dylib
-@_silgen_name("ios_set_death_animation_callback")
-func ios_set_death_animation_callback(_ callback: DeathAnimationCallback?)
-
-/// The actual callback function - must be @convention(c) compatible
-private let deathAnimationHandler: DeathAnimationCallback = {
-    print("[Swift Death] ☠️ EARLY DEATH DETECTED - Starting animation IMMEDIATELY")
-
-    // Post notification to main thread to start death animation
-    // This runs IN PARALLEL with C-side death data collection
-    DispatchQueue.main.async {
-        print("[Swift Death] ON MAIN THREAD - Posting DeathAnimationStart notification")
-        NotificationCenter.default.post(
-            name: Notification.Name("NetHackDeathAnimationStart"),
-            object: nil
-        )
-        print("[Swift Death] DeathAnimationStart notification POSTED")
-    }
-}
-
-/// Call this at app startup to register the death animation callback
-/// MUST be called AFTER dylib is loaded
-public func registerDeathAnimationCallback() {
-    print("[Swift Death] Registering death animation callback with C...")
-    ios_set_death_animation_callback(deathAnimationHandler)
-    print("[Swift Death] ✓ Callback registered")
-}
@@ -0,0 +1,155 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+ActionMacro - Compound Actions in One Round Trip
+// =============================================================================
+//
+// A macro is a short step program the game thread runs itself, one step per
+// command prompt, until it is done or a stop condition hits (hostile next to
+// the hero, HP threshold, an unanswered prompt, level change). Swift submits
+// it once and hears back through the event bus (IOS_EVENT_MACRO_DONE) and
+// the macro status - see ios_action_macro.h.
+// =============================================================================
+
+extension Notification.Name {
+    /// object: NetHackBridge.MacroStatus of the macro that finished
+    static let nethackMacroFinished = Notification.Name("NetHackMacroFinished")
+}
+
+extension NetHackBridge {
+
+    /// Mirrors ActionId in action_registry.h
+    enum MacroAction: UInt8 {
+        case kick = 0
+        case open = 1
+        case close = 2
+        case fire = 3
+        case `throw` = 4
+        case unlock = 5
+        case lock = 6
+    }
+
+    /// Mirrors IOS_MACRO_UNTIL_* in ios_action_macro.h
+    enum MacroUntil: UInt8 {
+        case none = 0
+        case doorOpen = 1
+        case doorUnlocked = 2
+    }
+
+    /// Mirrors IOS_MACRO_RESULT_* in ios_action_macro.h
+    enum MacroResult: Int32 {
+        case none = 0
+        case done = 1
+        case hostile = 2
+        case lowHP = 3
+        case prompt = 4
+        case levelChanged = 5
+        case cancelled = 6
+        case invalid = 7
+    }
+
+    enum MacroStep {
+        /// A whole command as literal keys ("s", ",")
+        case keys(String, times: Int = 1)
+        /// A registry action towards (dx, dy); answers go to its prompts
+        case action(MacroAction, dx: Int, dy: Int, item: Character? = nil,
+                    answers: String = "", times: Int = 1, until: MacroUntil = .none)
+    }
+
+    struct MacroStatus {
+        let id: UInt32
+        let finished: Bool
+        let result: MacroResult
+        let step: Int
+        let commands: Int
+        let turns: Int
+    }
+
+    // MARK: - Submit
+
+    /// Run steps on the game thread. Returns the macro id, or nil if one is
+    /// already running or the program does not fit.
+    @discardableResult
+    func runActionMacro(_ steps: [MacroStep], stopOnHostile: Bool = true,
+                        hpStopPercent: Int = 0) -> UInt32? {
+        guard dylib.isLoaded, gameStarted, !steps.isEmpty,
+              steps.count <= Int(IOS_MACRO_STEPS_MAX) else { return nil }
+        typealias SubmitFn = @convention(c) (UnsafePointer<IOSMacroProgram>?) -> UInt32
+        guard let submit: SubmitFn = try? dylib.resolveFunction("ios_action_macro_submit") else {
+            return nil
+        }
+
+        var program = IOSMacroProgram()
+        program.count = UInt8(steps.count)
+        program.stop_flags = stopOnHostile ? UInt8(IOS_MACRO_STOP_ON_HOSTILE) : 0
+        program.hp_stop_percent = UInt8(clamping: hpStopPercent)
+        let built = withUnsafeMutableBytes(of: &program.steps) { raw -> Bool in
+            let out = raw.bindMemory(to: IOSMacroStep.self)
+            for (i, step) in steps.enumerated() {
+                guard let cStep = Self.macroStep(step) else { return false }
+                out[i] = cStep
+            }
+            return true
+        }
+        guard built else { return nil }
+
+        let id = withUnsafePointer(to: &program) { submit($0) }
+        return id == 0 ? nil : id
+    }
+
+    /// Stop the running macro before its next step
+    func cancelActionMacro() {
+        guard dylib.isLoaded else { return }
+        typealias CancelFn = @convention(c) () -> Void
+        guard let cancel: CancelFn = try? dylib.resolveFunction("ios_action_macro_cancel") else {
+            return
+        }
+        cancel()
+    }
+
+    func actionMacroStatus() -> MacroStatus? {
+        guard dylib.isLoaded else { return nil }
+        typealias StatusFn = @convention(c) (UnsafeMutablePointer<IOSMacroStatus>?) -> Void
+        guard let getStatus: StatusFn = try? dylib.resolveFunction("ios_action_macro_get_status") else {
+            return nil
+        }
+        var status = IOSMacroStatus()
+        getStatus(&status)
+        return MacroStatus(id: status.id,
+                           finished: status.state == IOS_MACRO_FINISHED,
+                           result: MacroResult(rawValue: status.result) ?? .none,
+                           step: Int(status.step),
+                           commands: Int(status.commands),
+                           turns: Int(status.turns))
+    }
+
+    // MARK: - Encoding
+
+    private static func macroStep(_ step: MacroStep) -> IOSMacroStep? {
+        var out = IOSMacroStep()
+        let keys: String
+        switch step {
+        case .keys(let command, let times):
+            out.kind = UInt8(IOS_MACRO_STEP_KEYS)
+            out.runs = UInt16(clamping: times)
+            keys = command
+        case .action(let action, let dx, let dy, let item, let answers, let times, let until):
+            guard (-1...1).contains(dx), (-1...1).contains(dy), dx != 0 || dy != 0 else { return nil }
+            out.kind = UInt8(IOS_MACRO_STEP_ACTION)
+            out.action = action.rawValue
+            out.dx = Int8(dx)
+            out.dy = Int8(dy)
+            out.item = item?.asciiValue.map { CChar(bitPattern: $0) } ?? 0
+            out.until = until.rawValue
+            out.runs = UInt16(clamping: times)
+            keys = answers
+        }
+
+        let bytes = Array(keys.utf8)
+        guard bytes.count < Int(IOS_MACRO_KEYS_MAX) else { return nil }
+        withUnsafeMutableBytes(of: &out.keys) { raw in
+            raw.copyBytes(from: bytes)   // Zero-initialized: stays NUL-terminated
+        }
+        return out
+    }
+}
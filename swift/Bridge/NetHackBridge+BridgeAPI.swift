@@ -0,0 +1,130 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+BridgeAPI - Function Table for Per-Frame Calls
+// =============================================================================
+//
+// Lazy dlsym wrappers pay a dylib check, a lookup and an optional unwrap on
+// every call. The calls made every frame or turn (render queue drain, map
+// export, frame timing, snapshots, logs) go through one table instead:
+// ios_bridge_api() is called once after the dylib loads and its entries are
+// copied into non-optional Swift closures (ios_bridge_api.h).
+// =============================================================================
+
+/// Direct entry points from IOSBridgeAPI; valid while the dylib stays loaded
+struct BridgeAPI {
+    // Render queue
+    let getRenderQueue: @convention(c) () -> UnsafeMutablePointer<RenderQueue>?
+    let dequeueBulk: @convention(c) (UnsafeMutablePointer<RenderQueue>?, UnsafeMutablePointer<RenderQueueElement>?, UInt32) -> UInt32
+    let readGlyphBatch: @convention(c) (UnsafeMutablePointer<RenderQueue>?, UnsafePointer<GlyphBatchUpdate>?, UnsafeMutablePointer<MapUpdate>?, UInt32) -> UInt32
+    let readStatus: @convention(c) (UnsafeMutablePointer<RenderQueue>?, UnsafePointer<StatusRef>?, UnsafeMutablePointer<StatusUpdate>?) -> Bool
+    let readMessage: @convention(c) (UnsafeMutablePointer<RenderQueue>?, UnsafePointer<MessageUpdate>?, UnsafeMutablePointer<CChar>?, UInt32) -> UInt32
+    let categoryName: @convention(c) (UnsafePointer<RenderQueue>?, UInt32) -> UnsafePointer<CChar>?
+    let isEmpty: @convention(c) (UnsafePointer<RenderQueue>?) -> Bool
+
+    // Binary map export
+    let mapExportGet: @convention(c) () -> UnsafePointer<MapExport>?
+    let mapExportBeginRead: @convention(c) () -> UInt32
+    let mapExportEndRead: @convention(c) (UInt32) -> Bool
+    let mapExportDirtyRows: @convention(c) (UInt32) -> UInt32
+
+    // Frame timing
+    let frameTimingRecord: @convention(c) (Int32, UInt64) -> Void
+    let frameTimingFramePresented: @convention(c) () -> Void
+
+    // Versioned snapshots
+    let gameStateSnapshotIfNewer: @convention(c) (UnsafeMutableRawPointer?, UnsafeMutablePointer<UInt32>?) -> Bool
+    let readModelIfNewer: @convention(c) (UnsafeMutablePointer<GameReadModel>?, UnsafeMutablePointer<UInt32>?) -> Bool
+    let statusBlockIfNewer: @convention(c) (UnsafeMutablePointer<IOSStatusBlock>?, UnsafeMutablePointer<UInt32>?) -> Bool
+    let glyphTable: @convention(c) (UnsafeMutablePointer<UInt32>?, UnsafeMutablePointer<UInt32>?) -> UnsafePointer<GlyphRenderInfo>?
+
+    // Logs and per-turn state
+    let messageLogFetchSince: @convention(c) (UInt64, UnsafeMutableRawPointer?, Int) -> Int32
+    let messageLogLastSeq: @convention(c) () -> UInt64
+    let travelStepsDrain: @convention(c) (UnsafeMutablePointer<IOSTravelStep>?, UInt32) -> UInt32
+    let travelStepsDropped: @convention(c) () -> UInt32
+    let tileObjectSummary: @convention(c) (Int32, Int32, UnsafeMutablePointer<IOSTileObjectSummary>?) -> Int32
+    let objectIndexGeneration: @convention(c) () -> UInt32
+    let killStatsGeneration: @convention(c) () -> UInt32
+
+    // Version 2
+    let glyphTableGeneration: @convention(c) () -> UInt32
+
+    /// nil if the table is older than this build or has a missing entry
+    init?(_ table: UnsafePointer<IOSBridgeAPI>) {
+        let t = table.pointee
+        guard t.version >= UInt32(IOS_BRIDGE_API_VERSION),
+              Int(t.size) >= MemoryLayout<IOSBridgeAPI>.size,
+              let getRenderQueue = t.get_render_queue,
+              let dequeueBulk = t.render_queue_dequeue_bulk,
+              let readGlyphBatch = t.render_queue_read_glyph_batch,
+              let readStatus = t.render_queue_read_status,
+              let readMessage = t.render_queue_read_message,
+              let categoryName = t.render_queue_category_name,
+              let isEmpty = t.render_queue_is_empty,
+              let mapExportGet = t.map_export_get,
+              let mapExportBeginRead = t.map_export_begin_read,
+              let mapExportEndRead = t.map_export_end_read,
+              let mapExportDirtyRows = t.map_export_dirty_rows,
+              let frameTimingRecord = t.frame_timing_record,
+              let frameTimingFramePresented = t.frame_timing_frame_presented,
+              let gameStateSnapshotIfNewer = t.get_game_state_snapshot_if_newer,
+              let readModelIfNewer = t.get_read_model_if_newer,
+              let statusBlockIfNewer = t.get_status_block_if_newer,
+              let glyphTable = t.get_glyph_table,
+              let messageLogFetchSince = t.message_log_fetch_since,
+              let messageLogLastSeq = t.message_log_last_seq,
+              let travelStepsDrain = t.travel_steps_drain,
+              let travelStepsDropped = t.travel_steps_dropped,
+              let tileObjectSummary = t.get_tile_object_summary,
+              let objectIndexGeneration = t.object_index_generation,
+              let killStatsGeneration = t.kill_stats_generation,
+              let glyphTableGeneration = t.glyph_table_generation else {
+            return nil
+        }
+
+        self.getRenderQueue = getRenderQueue
+        self.dequeueBulk = dequeueBulk
+        self.readGlyphBatch = readGlyphBatch
+        self.readStatus = readStatus
+        self.readMessage = readMessage
+        self.categoryName = categoryName
+        self.isEmpty = isEmpty
+        self.mapExportGet = mapExportGet
+        self.mapExportBeginRead = mapExportBeginRead
+        self.mapExportEndRead = mapExportEndRead
+        self.mapExportDirtyRows = mapExportDirtyRows
+        self.frameTimingRecord = frameTimingRecord
+        self.frameTimingFramePresented = frameTimingFramePresented
+        self.gameStateSnapshotIfNewer = gameStateSnapshotIfNewer
+        self.readModelIfNewer = readModelIfNewer
+        self.statusBlockIfNewer = statusBlockIfNewer
+        self.glyphTable = glyphTable
+        self.messageLogFetchSince = messageLogFetchSince
+        self.messageLogLastSeq = messageLogLastSeq
+        self.travelStepsDrain = travelStepsDrain
+        self.travelStepsDropped = travelStepsDropped
+        self.tileObjectSummary = tileObjectSummary
+        self.objectIndexGeneration = objectIndexGeneration
+        self.killStatsGeneration = killStatsGeneration
+        self.glyphTableGeneration = glyphTableGeneration
+    }
+}
+
+extension NetHackBridge {
+
+    // MARK: - Binding
+
+    /// Fetch the table once per dylib load (called from ensureDylibLoaded)
+    internal func bindBridgeAPI() {
+        typealias GetTable = @convention(c) () -> UnsafePointer<IOSBridgeAPI>?
+        guard let getTable: GetTable = try? dylib.resolveFunction("ios_bridge_api"),
+              let table = getTable(),
+              let bound = BridgeAPI(table) else {
+            print("[Bridge] ⚠️ ios_bridge_api table unavailable - per-frame calls disabled")
+            api = nil
+            return
+        }
+        api = bound
+    }
+}
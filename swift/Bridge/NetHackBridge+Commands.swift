@@ -148,16 +148,44 @@ extension NetHackBridge {
 
     // MARK: - Tile Examination
 
+    /// Packed farlook result for one tile (ios_lookat_cache.h)
+    struct TileInspection {
+        let text: String
+        let glyph: Int32
+        let objectCount: Int
+        let isMonster: Bool
+        let isPile: Bool
+        let isUnexplored: Bool
+        let fromCache: Bool      // Tile unchanged since the last look - lookat() not run
+    }
+
+    /// Describe a tile (Swift coordinates); unchanged tiles come from the C lookat cache
+    nonisolated func inspectTile(x: Int, y: Int) -> TileInspection? {
+        var result = IOSLookatResult()
+        guard ios_examine_tile(Int32(x), Int32(y), &result) != 0 else {
+            return nil
+        }
+        let text = withUnsafePointer(to: result.text) { ptr in
+            ptr.withMemoryRebound(to: CChar.self, capacity: Int(IOS_LOOKAT_TEXT_MAX)) { String(cString: $0) }
+        }
+        let flags = Int32(result.flags)
+        return TileInspection(
+            text: text,
+            glyph: result.glyph,
+            objectCount: Int(result.object_count),
+            isMonster: flags & IOS_LOOKAT_MONSTER != 0,
+            isPile: flags & IOS_LOOKAT_PILE != 0,
+            isUnexplored: flags & IOS_LOOKAT_UNEXPLORED != 0,
+            fromCache: flags & IOS_LOOKAT_CACHED != 0
+        )
+    }
+
     /// Examine/look at a specific tile (ASYNC - Thread-safe)
     /// Uses separate thread because examine is READ-ONLY and game loop blocks on serial queue
     func examineTileAsync(x: Int, y: Int) async -> String? {
         return await withCheckedContinuation { continuation in
             DispatchQueue.global(qos: .userInitiated).async {
-                guard let cString = nethack_examine_tile(Int32(x), Int32(y)) else {
-                    continuation.resume(returning: nil)
-                    return
-                }
-                continuation.resume(returning: String(cString: cString))
+                continuation.resume(returning: self.inspectTile(x: x, y: y)?.text)
             }
         }
     }
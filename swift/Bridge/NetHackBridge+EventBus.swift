@@ -0,0 +1,68 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+EventBus - One Main-Queue Delivery per Turn Boundary
+// =============================================================================
+//
+// The game thread coalesces everything a command produced (map changes,
+// messages, turn end, game ready, death) into one IOSEventBatch and
+// dispatches it to the main queue once (ios_event_bus.h). The callback
+// already runs on main: it fans the batch out to the existing
+// notifications, posting each at most once per batch. Messages come with
+// their sequence range and are fetched from the C log in one call.
+// =============================================================================
+
+extension Notification.Name {
+    /// object: [MessageLogEntry], oldest first - every message of one batch
+    static let nethackMessages = Notification.Name("NetHackMessages")
+    static let nethackDeathAnimationStart = Notification.Name("NetHackDeathAnimationStart")
+}
+
+extension NetHackBridge {
+
+    // MARK: - Registration
+
+    /// Register the batch callback (called from registerCallbacks after each dylib load)
+    internal func registerEventBus() -> Bool {
+        typealias RegisterFn = @convention(c) ((@convention(c) (UnsafePointer<IOSEventBatch>?) -> Void)?) -> Void
+        guard let register: RegisterFn = try? dylib.resolveFunction("ios_event_bus_register") else {
+            return false
+        }
+
+        let callback: @convention(c) (UnsafePointer<IOSEventBatch>?) -> Void = { batch in
+            guard let batch = batch?.pointee else { return }
+            NetHackBridge.shared.deliverEventBatch(batch)
+        }
+        register(callback)
+        return true
+    }
+
+    // MARK: - Delivery (main queue)
+
+    private func deliverEventBatch(_ batch: IOSEventBatch) {
+        let events = batch.events
+        let center = NotificationCenter.default
+
+        if events & UInt32(IOS_EVENT_MESSAGES) != 0 {
+            let entries = fetchMessages(since: batch.message_after, through: batch.message_last)
+            if !entries.isEmpty {
+                center.post(name: .nethackMessages, object: entries)
+            }
+        }
+        if events & UInt32(IOS_EVENT_MAP_CHANGED | IOS_EVENT_TURN_COMPLETE) != 0 {
+            center.post(name: .nethackMapUpdated, object: nil)
+        }
+        if events & UInt32(IOS_EVENT_GAME_READY) != 0 {
+            print("[SWIFT GAME READY] 🎯 Game ready signal received from C")
+            center.post(name: .nethackGameReady, object: nil)
+        }
+        if events & UInt32(IOS_EVENT_MACRO_DONE) != 0, let status = actionMacroStatus() {
+            center.post(name: .nethackMacroFinished, object: status)
+        }
+        if events & UInt32(IOS_EVENT_DEATH) != 0 {
+            // Runs IN PARALLEL with C-side death data collection
+            print("[Swift Death] ☠️ EARLY DEATH DETECTED - Starting animation IMMEDIATELY")
+            center.post(name: .nethackDeathAnimationStart, object: nil)
+        }
+    }
+}
@@ -0,0 +1,72 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+FrameTiming - Turn Stage Latency Histograms
+// =============================================================================
+//
+// The C side stamps input wake-up, command work, snapshot and sync; Swift
+// records its own stages (queue drain, SceneKit update) into the same
+// histograms and reports when a frame showing the latest input is presented.
+// =============================================================================
+
+/// Summary of one stage for display (microseconds)
+struct FrameTimingStageStats: Identifiable {
+    let stage: Int32
+    let name: String
+    let stats: FrameTimingStats
+
+    var id: Int32 { stage }
+}
+
+extension NetHackBridge {
+
+    // MARK: - Symbol Resolution
+
+    private func resolveFrameTiming() -> Bool {
+        if _ios_get_frame_timing_stats == nil {
+            guard (try? ensureDylibLoaded()) != nil else { return false }
+            _ios_get_frame_timing_stats = try? dylib.resolveFunction("ios_get_frame_timing_stats")
+            _ios_frame_timing_stage_name = try? dylib.resolveFunction("ios_frame_timing_stage_name")
+            _ios_frame_timing_reset = try? dylib.resolveFunction("ios_frame_timing_reset")
+        }
+        return _ios_get_frame_timing_stats != nil
+    }
+
+    // MARK: - Recording
+
+    /// Record a Swift-side stage duration (per frame: direct table call)
+    func recordFrameTiming(_ stage: FrameTimingStage, nanoseconds: UInt64) {
+        api?.frameTimingRecord(Int32(stage.rawValue), nanoseconds)
+    }
+
+    /// A frame reflecting the latest input was presented (closes input->frame)
+    func frameTimingFramePresented() {
+        api?.frameTimingFramePresented()
+    }
+
+    // MARK: - Query
+
+    /// Summaries for all stages (empty if the dylib is not loaded)
+    func frameTimingStats() -> [FrameTimingStageStats] {
+        guard resolveFrameTiming(),
+              let getStats = _ios_get_frame_timing_stats,
+              let stageName = _ios_frame_timing_stage_name else {
+            return []
+        }
+
+        var result: [FrameTimingStageStats] = []
+        for stage in 0..<Int32(FRAME_STAGE_COUNT.rawValue) {
+            var stats = FrameTimingStats()
+            guard getStats(stage, &stats) else { continue }
+            let name = stageName(stage).map { String(cString: $0) } ?? "?"
+            result.append(FrameTimingStageStats(stage: stage, name: name, stats: stats))
+        }
+        return result
+    }
+
+    /// Clear all histograms
+    func resetFrameTiming() {
+        guard resolveFrameTiming() else { return }
+        _ios_frame_timing_reset?()
+    }
+}
@@ -0,0 +1,93 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+GlyphTable - Precomputed Glyph Render Table
+// =============================================================================
+//
+// ios_winprocs.c builds a GlyphRenderInfo per glyph once per symbol set.
+// Swift keeps the table pointer and only refetches it when the generation
+// changes, so classifying a glyph is a single array load instead of a
+// character switch. C double-buffers the table and reuses a buffer two
+// rebuilds later, so every lookup rechecks the generation after its read
+// and refetches if the buffer it read may have been rewritten.
+// =============================================================================
+
+extension NetHackBridge {
+
+    // MARK: - Table Access
+
+    /// Refresh the cached table if C rebuilt it; nil until symbols are initialized
+    private func currentGlyphTable() -> UnsafeBufferPointer<GlyphRenderInfo>? {
+        guard let api else { return nil }
+
+        var count: UInt32 = 0
+        var generation: UInt32 = 0
+        let base = api.glyphTable(&count, &generation)
+        if generation != glyphTableGeneration || glyphTable == nil {
+            glyphTable = base.map { UnsafeBufferPointer(start: $0, count: Int(count)) }
+            glyphTableGeneration = generation
+        }
+        return glyphTable
+    }
+
+    /// The cached buffer was not rewritten since it was fetched (IOS_GLYPH_TABLE_INTACT)
+    private func glyphTableIntact() -> Bool {
+        guard let api else { return false }
+        return api.glyphTableGeneration() &- (glyphTableGeneration & ~1) <= 2
+    }
+
+    /// Tile type for a glyph from the C table
+    /// - Returns: nil if the table is not built yet or the glyph has no class
+    func tileType(forGlyph glyph: Int32) -> TileType? {
+        // A second pass reads the table the first one found lapped
+        for _ in 0..<2 {
+            guard let table = currentGlyphTable(), glyph >= 0, Int(glyph) < table.count else {
+                return nil
+            }
+            let tileClass = table[Int(glyph)].tile_class
+            if glyphTableIntact() {
+                return TileType(tileClass: tileClass)
+            }
+            glyphTable = nil
+        }
+        return nil
+    }
+}
+
+// MARK: - TileType Mapping
+
+extension TileType {
+    /// Map a GlyphTileClass value; nil for GLYPH_TILE_UNKNOWN / unknown values
+    init?(tileClass: UInt8) {
+        switch UInt32(tileClass) {
+        case GLYPH_TILE_FLOOR.rawValue: self = .floor
+        case GLYPH_TILE_WALL.rawValue: self = .wall
+        case GLYPH_TILE_DOOR.rawValue: self = .door
+        case GLYPH_TILE_DOOR_OPEN.rawValue: self = .doorOpen
+        case GLYPH_TILE_DOOR_CLOSED.rawValue: self = .doorClosed
+        case GLYPH_TILE_CORRIDOR.rawValue: self = .corridor
+        case GLYPH_TILE_STAIRS.rawValue: self = .stairs
+        case GLYPH_TILE_WATER.rawValue: self = .water
+        case GLYPH_TILE_LAVA.rawValue: self = .lava
+        case GLYPH_TILE_ALTAR.rawValue: self = .altar
+        case GLYPH_TILE_FOUNTAIN.rawValue: self = .fountain
+        case GLYPH_TILE_THRONE.rawValue: self = .throne
+        case GLYPH_TILE_SINK.rawValue: self = .sink
+        case GLYPH_TILE_TRAP.rawValue: self = .trap
+        case GLYPH_TILE_MONSTER.rawValue: self = .monster
+        case GLYPH_TILE_PLAYER.rawValue: self = .player
+        case GLYPH_TILE_ITEM.rawValue: self = .item
+        case GLYPH_TILE_GOLD.rawValue: self = .gold
+        case GLYPH_TILE_FOOD.rawValue: self = .food
+        case GLYPH_TILE_WEAPON.rawValue: self = .weapon
+        case GLYPH_TILE_ARMOR.rawValue: self = .armor
+        case GLYPH_TILE_POTION.rawValue: self = .potion
+        case GLYPH_TILE_SCROLL.rawValue: self = .scroll
+        case GLYPH_TILE_WAND.rawValue: self = .wand
+        case GLYPH_TILE_RING.rawValue: self = .ring
+        case GLYPH_TILE_AMULET.rawValue: self = .amulet
+        case GLYPH_TILE_TOOL.rawValue: self = .tool
+        default: return nil
+        }
+    }
+}
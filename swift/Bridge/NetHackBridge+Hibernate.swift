@@ -0,0 +1,43 @@
+import Foundation
+import UIKit
+
+// =============================================================================
+// NetHackBridge+Hibernate - Hibernation Image on Backgrounding
+// =============================================================================
+//
+// ios_hibernate_request() writes the game's in-memory state next to the save
+// while the game thread is parked at a command prompt, or at its next one.
+// If iOS kills the app in the background, loadGame() resumes from that image
+// instead of running the full restore (ios_hibernate.h). Safe to call from
+// any thread.
+// =============================================================================
+
+extension NetHackBridge {
+
+    /// Capture a hibernation image for a background kill. Runs inside a
+    /// background task so the write finishes after the scene is gone.
+    func hibernateForBackground() {
+        guard dylib.isLoaded, gameStarted else { return }
+        typealias RequestFn = @convention(c) () -> Int32
+        guard let request: RequestFn = try? dylib.resolveFunction("ios_hibernate_request") else {
+            return
+        }
+
+        let task = UIApplication.shared.beginBackgroundTask(withName: "NetHackHibernate")
+        let result = request()
+        print("[Hibernate] Request: \(result == 1 ? "captured" : result == 0 ? "deferred to next prompt" : "no game")")
+        if task != .invalid {
+            UIApplication.shared.endBackgroundTask(task)
+        }
+    }
+
+    /// Back in the foreground: a capture still waiting for a prompt is not needed.
+    func cancelHibernation() {
+        guard dylib.isLoaded else { return }
+        typealias CancelFn = @convention(c) () -> Void
+        guard let cancel: CancelFn = try? dylib.resolveFunction("ios_hibernate_cancel") else {
+            return
+        }
+        cancel()
+    }
+}
@@ -0,0 +1,57 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+MapExport - Binary Map Export (zero-copy)
+// =============================================================================
+//
+// Reads the packed MapExport published by ios_winprocs.c in place, under its
+// seqlock. Replaces polling nethack_get_map_data()/_enhanced(), which built
+// strings/JSON on every call.
+//
+// Coordinates are NetHack's: x 0-79, y 0-20 (no buffer Y offset).
+// =============================================================================
+
+extension NetHackBridge {
+
+    // MARK: - Map Export Access
+
+    /// Read rows changed since `version` directly from the C export
+    /// - Parameters:
+    ///   - version: Version the caller already has (0 = none); updated after a consistent read
+    ///   - body: Called with the export and the mask of changed rows (bit y = row y).
+    ///           May run more than once if the game thread publishes mid-read -
+    ///           keep it side-effect free until it returns.
+    /// - Returns: Mask of changed rows (0 = nothing changed, body not called)
+    @discardableResult
+    func readMapExport(since version: inout UInt32,
+                       _ body: (UnsafePointer<MapExport>, UInt32) -> Void) -> UInt32 {
+        guard let api, let export = api.mapExportGet() else {
+            return 0
+        }
+
+        while true {
+            let seq = api.mapExportBeginRead()
+            let current = export.pointee.version
+            let mask = api.mapExportDirtyRows(version)
+            if mask != 0 {
+                body(export, mask)
+            }
+            if api.mapExportEndRead(seq) {
+                version = current
+                return mask
+            }
+        }
+    }
+}
+
+// MARK: - Cell Access
+
+extension UnsafePointer where Pointee == MapExport {
+    /// Cell at NetHack coordinates (x 0-79, y 0-20), read in place (no struct copy)
+    func cell(x: Int, y: Int) -> PackedMapCell {
+        let offset = MemoryLayout<MapExport>.offset(of: \MapExport.cells)!
+        return UnsafeRawPointer(self)
+            .advanced(by: offset)
+            .assumingMemoryBound(to: PackedMapCell.self)[y * Int(MAP_EXPORT_WIDTH) + x]
+    }
+}
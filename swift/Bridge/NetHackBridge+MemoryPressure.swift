@@ -0,0 +1,32 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+MemoryPressure - Forward iOS Memory Warnings to the C Side
+// =============================================================================
+//
+// ios_memory_pressure_notify() runs the purges the level reaches (heap free
+// pages, Lua pool slabs, idle warm Lua states), on the calling thread when
+// the game thread is parked at an input wait, otherwise at its next wait
+// (ios_memory_pressure.h). Safe to call from any thread.
+// =============================================================================
+
+extension NetHackBridge {
+
+    /// Mirrors IOS_MEMORY_PRESSURE_* in ios_memory_pressure.h
+    enum MemoryPressureLevel: Int32 {
+        case normal = 0
+        case warning = 1
+        case critical = 2
+    }
+
+    /// Tell the C side iOS wants memory back. No-op before the dylib is loaded:
+    /// nothing is resident yet.
+    func notifyMemoryPressure(level: MemoryPressureLevel) {
+        guard dylib.isLoaded else { return }
+        typealias NotifyFn = @convention(c) (Int32) -> Void
+        guard let notify: NotifyFn = try? dylib.resolveFunction("ios_memory_pressure_notify") else {
+            return
+        }
+        notify(level.rawValue)
+    }
+}
@@ -0,0 +1,63 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+MessageLog - Cursor-Based Message History
+// =============================================================================
+//
+// The C message log (ios_message_log.h) numbers every message; callers keep
+// the last sequence id they saw and fetch only what came after it, as
+// packed records. Cost is proportional to the new messages, not the log.
+// =============================================================================
+
+/// One message from the C log
+struct MessageLogEntry {
+    let seq: UInt64
+    let text: String
+    let category: String
+    let turn: Int
+    let attr: Int
+}
+
+extension NetHackBridge {
+
+    // MARK: - Query
+
+    /// Sequence id of the newest logged message (0 = none)
+    func messageLogLastSeq() -> UInt64 {
+        return api?.messageLogLastSeq() ?? 0
+    }
+
+    /// Messages logged after `seq` and up to `last`, oldest first
+    func fetchMessages(since seq: UInt64, through last: UInt64 = .max) -> [MessageLogEntry] {
+        guard let fetch = api?.messageLogFetchSince else { return [] }
+
+        let bufferSize = 16 * 1024
+        let buffer = UnsafeMutableRawPointer.allocate(byteCount: bufferSize, alignment: 8)
+        defer { buffer.deallocate() }
+
+        var entries: [MessageLogEntry] = []
+        var cursor = seq
+        fetching: while cursor < last {
+            let count = Int(fetch(cursor, buffer, bufferSize))
+            guard count > 0 else { break }
+
+            var offset = 0
+            for _ in 0..<count {
+                let record = buffer.load(fromByteOffset: offset, as: IOSMessageRecord.self)
+                // Later messages belong to a batch that is still on its way
+                guard record.seq <= last else { break fetching }
+                let textStart = buffer + offset + MemoryLayout<IOSMessageRecord>.size
+                let text = String(decoding: UnsafeRawBufferPointer(start: textStart, count: Int(record.text_length)),
+                                  as: UTF8.self)
+                let category = withUnsafePointer(to: record.category) { ptr in
+                    ptr.withMemoryRebound(to: CChar.self, capacity: 12) { String(cString: $0) }
+                }
+                entries.append(MessageLogEntry(seq: record.seq, text: text, category: category,
+                                               turn: Int(record.turn), attr: Int(record.attr)))
+                cursor = record.seq
+                offset += Int(record.record_size)
+            }
+        }
+        return entries
+    }
+}
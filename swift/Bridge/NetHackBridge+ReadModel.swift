@@ -0,0 +1,207 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+ReadModel - Turn-Boundary Read Model
+// =============================================================================
+//
+// Inventory, equipment, character status and the pile under the player,
+// published by the game thread next to GameStateSnapshot (ios_read_model.h).
+// Reading it is a seqlock copy: safe from any thread and never queued on
+// NetHackSerialExecutor, so panels opened mid-travel don't wait for the
+// game thread. Values are as of the last turn boundary.
+// =============================================================================
+
+/// Character status as of the last turn boundary
+struct ReadModelCharacterStatus {
+    let role: String
+    let race: String
+    let gender: String
+    let alignment: String
+    let level: Int
+    let experience: Int
+    let hunger: Int
+    let encumbrance: Int
+    let conditions: UInt64
+    let polymorphed: Bool
+    let polymorphForm: String?
+    let polymorphTurns: Int
+    let weaponWelded: Bool
+    let leftRingAvailable: Bool
+    let rightRingAvailable: Bool
+}
+
+/// Swift view of GameReadModel; sections are only re-converted when their version moves
+struct ReadModel {
+    let turnNumber: Int
+    let inventoryVersion: UInt32
+    let statusVersion: UInt32
+    let floorVersion: UInt32
+
+    let inventory: [NetHackItem]
+    /// IOS_SLOT_* index -> equipped item
+    let equipment: [Int: NetHackItem]
+    let cursedSlots: UInt16
+    let blessedSlots: UInt16
+
+    let status: ReadModelCharacterStatus
+
+    let floorX: Int
+    let floorY: Int
+    let floorItems: [GameObjectInfo]
+}
+
+extension NetHackBridge {
+
+    // MARK: - Query
+
+    /// Latest published read model (nil before the first turn boundary)
+    /// Thread-Safe: any thread; one atomic load when nothing changed
+    func readModel() -> ReadModel? {
+        readModelLock.lock()
+        defer { readModelLock.unlock() }
+
+        guard let getIfNewer = api?.readModelIfNewer else {
+            return readModelCache
+        }
+
+        // ~17KB: heap, not stack
+        let ptr = UnsafeMutablePointer<GameReadModel>.allocate(capacity: 1)
+        defer { ptr.deallocate() }
+        guard getIfNewer(ptr, &readModelVersion) else {
+            return readModelCache
+        }
+
+        let model = Self.convertReadModel(ptr, reusing: readModelCache)
+        readModelCache = model
+        return model
+    }
+
+    // MARK: - Conversion
+
+    private static func string<T>(_ tuple: T, capacity: Int) -> String {
+        withUnsafePointer(to: tuple) { ptr in
+            ptr.withMemoryRebound(to: CChar.self, capacity: capacity) { String(cString: $0) }
+        }
+    }
+
+    private static func convertReadModel(_ c: UnsafeMutablePointer<GameReadModel>,
+                                         reusing previous: ReadModel?) -> ReadModel {
+        let m = c.pointee
+
+        var inventory: [NetHackItem]
+        var equipment: [Int: NetHackItem]
+        if let previous, previous.inventoryVersion == m.inventory_version {
+            inventory = previous.inventory
+            equipment = previous.equipment
+        } else {
+            inventory = withUnsafePointer(to: &c.pointee.inventory) { tuple in
+                tuple.withMemoryRebound(to: ReadModelItem.self, capacity: Int(READ_MODEL_MAX_INVENTORY)) { items in
+                    (0..<Int(m.inventory_count)).map { convertItem(items[$0]) }
+                }
+            }
+            equipment = [:]
+            withUnsafePointer(to: m.equipment) { tuple in
+                tuple.withMemoryRebound(to: Int8.self, capacity: Int(READ_MODEL_SLOT_COUNT)) { slots in
+                    for slot in 0..<Int(READ_MODEL_SLOT_COUNT) where slots[slot] >= 0 && Int(slots[slot]) < inventory.count {
+                        equipment[slot] = inventory[Int(slots[slot])]
+                    }
+                }
+            }
+        }
+
+        let status: ReadModelCharacterStatus
+        if let previous, previous.statusVersion == m.status_version {
+            status = previous.status
+        } else {
+            let s = m.status
+            let form = string(s.polymorph_form, capacity: 32)
+            status = ReadModelCharacterStatus(
+                role: string(s.role, capacity: 32),
+                race: string(s.race, capacity: 32),
+                gender: string(s.gender, capacity: 16),
+                alignment: string(s.alignment, capacity: 16),
+                level: Int(s.level),
+                experience: Int(s.experience),
+                hunger: Int(s.hunger),
+                encumbrance: Int(s.encumbrance),
+                conditions: s.conditions,
+                polymorphed: s.polymorphed,
+                polymorphForm: form.isEmpty ? nil : form,
+                polymorphTurns: Int(s.polymorph_turns),
+                weaponWelded: s.weapon_welded,
+                leftRingAvailable: s.left_ring_available,
+                rightRingAvailable: s.right_ring_available
+            )
+        }
+
+        let floorItems: [GameObjectInfo]
+        if let previous, previous.floorVersion == m.floor_version {
+            floorItems = previous.floorItems
+        } else {
+            floorItems = withUnsafePointer(to: &c.pointee.floor) { tuple in
+                tuple.withMemoryRebound(to: IOSObjectInfo.self, capacity: Int(READ_MODEL_MAX_FLOOR)) { objects in
+                    (0..<Int(m.floor_count)).map { i in
+                        let info = objects[i]
+                        return GameObjectInfo(
+                            name: string(info.name, capacity: 256),
+                            type: info.otyp,
+                            objectClass: info.oclass,
+                            quantity: Int(info.quantity),
+                            enchantment: info.enchantment,
+                            blessed: info.blessed,
+                            cursed: info.cursed,
+                            bucKnown: info.bknown,
+                            chargesKnown: info.known,
+                            descriptionKnown: info.dknown,
+                            objectID: info.o_id
+                        )
+                    }
+                }
+            }
+        }
+
+        return ReadModel(
+            turnNumber: Int(m.turn_number),
+            inventoryVersion: m.inventory_version,
+            statusVersion: m.status_version,
+            floorVersion: m.floor_version,
+            inventory: inventory,
+            equipment: equipment,
+            cursedSlots: m.equipment_cursed,
+            blessedSlots: m.equipment_blessed,
+            status: status,
+            floorX: Int(m.floor_x),
+            floorY: Int(m.floor_y),
+            floorItems: floorItems
+        )
+    }
+
+    /// Same mapping as GameOverlayManager.updateInventory() uses for InventoryItem
+    private static func convertItem(_ c: ReadModelItem) -> NetHackItem {
+        let bucStatus: ItemBUCStatus
+        switch c.buc_status {
+        case Int8(UnicodeScalar("B").value): bucStatus = .blessed
+        case Int8(UnicodeScalar("C").value): bucStatus = .cursed
+        case Int8(UnicodeScalar("U").value): bucStatus = .uncursed
+        default: bucStatus = .unknown
+        }
+
+        let name = string(c.name, capacity: Int(READ_MODEL_NAME_LEN))
+        var item = NetHackItem(
+            invlet: Character(UnicodeScalar(UInt8(bitPattern: c.invlet))),
+            name: name,
+            fullName: name,
+            category: ItemCategory.fromOclass(c.oclass),
+            quantity: Int(c.quantity)
+        )
+        item.bucStatus = bucStatus
+        item.bucKnown = c.buc_known
+        item.enchantment = Int(c.enchantment)
+        item.properties.isWorn = c.is_equipped
+        if c.is_equipped {
+            item.properties.isWielded = string(c.equipped_slot, capacity: 16).contains("wield")
+        }
+        item.isContainer = c.is_container
+        return item
+    }
+}
@@ -7,7 +7,9 @@ import Foundation
 // This extension handles the render queue consumer pattern (Phase 2):
 // - Enum for update types (glyph, message, status, commands)
 // - Data structs for each update type
-// - Queue consumption method for batch processing
+// - Typed bulk consumer (drainRenderQueue) over a reused element buffer,
+//   calling straight through the bound BridgeAPI table
+// - Coalesced glyph batches (UPDATE_GLYPH_BATCH) expanded from the delta lane
 //
 // The render queue is a lock-free double buffer that allows the game thread
 // to push updates while the UI thread consumes them without blocking.
@@ -15,37 +17,11 @@ import Foundation
 
 extension NetHackBridge {
 
-    // MARK: - Lazy Wrappers (C Function Calls)
+    /// Reused scratch buffer for coalesced glyph batches (one full map)
+    private static let glyphBatchBuffer = UnsafeMutablePointer<MapUpdate>.allocate(capacity: Int(RENDER_GLYPH_BATCH_MAX))
 
-    internal func ios_get_render_queue_wrap() throws -> UnsafeMutablePointer<RenderQueue>? {
-        try ensureDylibLoaded()
-        if _ios_get_render_queue == nil {
-            _ios_get_render_queue = try dylib.resolveFunction("ios_get_render_queue")
-        }
-        return _ios_get_render_queue?()
-    }
-
-    internal func render_queue_dequeue_wrap(_ queue: UnsafeMutablePointer<RenderQueue>, _ elem: UnsafeMutablePointer<RenderQueueElement>) throws -> Bool {
-        try ensureDylibLoaded()
-        if _render_queue_dequeue == nil {
-            _render_queue_dequeue = try dylib.resolveFunction("render_queue_dequeue")
-        }
-        guard let fn = _render_queue_dequeue else {
-            throw DylibLoader.LoadError.symbolNotFound(symbol: "render_queue_dequeue")
-        }
-        return fn(queue, elem)
-    }
-
-    internal func render_queue_is_empty_wrap(_ queue: UnsafePointer<RenderQueue>) throws -> Bool {
-        try ensureDylibLoaded()
-        if _render_queue_is_empty == nil {
-            _render_queue_is_empty = try dylib.resolveFunction("render_queue_is_empty")
-        }
-        guard let fn = _render_queue_is_empty else {
-            throw DylibLoader.LoadError.symbolNotFound(symbol: "render_queue_is_empty")
-        }
-        return fn(queue)
-    }
+    /// Reused scratch buffer for message text read from the queue's arena
+    private static let messageTextBuffer = UnsafeMutablePointer<CChar>.allocate(capacity: Int(RENDER_MESSAGE_TEXT_MAX) + 1)
 
     // MARK: - Render Update Types
 
@@ -56,6 +32,7 @@ extension NetHackBridge {
         case cmdFlushMap = 3
         case cmdClearMap = 4
         case cmdTurnComplete = 5
+        case updateGlyphBatch = 6
     }
 
     // MARK: - Update Data Structures
@@ -76,8 +53,8 @@ extension NetHackBridge {
     static let MG_INVIS: UInt32   = 0x00004  // Invisible monster
 
     struct MessageUpdateData {
-        let text: UnsafeMutablePointer<CChar>
-        let category: UnsafeMutablePointer<CChar>
+        let text: String
+        let category: String
         let attr: Int32
     }
 
@@ -100,84 +77,169 @@ extension NetHackBridge {
         let align: (Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8, Int8)  // char align[16] from C
         let hunger: Int32
         let conditions: UInt  // BL_CONDITION bitmask (30 flags)
+        let changed: UInt32   // STATUS_FIELD_* bits that moved since the last update
     }
 
     // MARK: - Queue Consumer
 
-    /// Consume all pending updates from the render queue
-    /// - Returns: Array of (type, data) tuples for processing
-    /// - Performance: Lock-free, batch processing
-    func consumeRenderQueue() -> [(type: RenderUpdateType, data: Any)] {
-        guard let queue = try? ios_get_render_queue_wrap() else {
-            return []
+    /// Typed render event - payloads are stored inline (no `Any` boxing)
+    enum RenderEvent {
+        case glyph(MapUpdateData)
+        case message(MessageUpdateData)
+        case status(StatusUpdateData)
+        case flushMap
+        case clearMap
+        case turnComplete(Int)
+    }
+
+    /// Elements copied per bulk dequeue call
+    private static let renderBulkCapacity = 512
+
+    /// Reused element buffer for bulk dequeue (main thread only)
+    private static let renderBulkBuffer = UnsafeMutablePointer<RenderQueueElement>.allocate(capacity: renderBulkCapacity)
+
+    /// Drain all pending updates from the render queue, in order
+    /// - Parameter handle: Called once per event (glyph batches are expanded per tile)
+    /// - Returns: Number of events delivered
+    /// - Performance: One bridge call per 512 elements, no per-update heap allocation
+    @discardableResult
+    func drainRenderQueue(_ handle: (RenderEvent) -> Void) -> Int {
+        guard let api, let queue = api.getRenderQueue() else {
+            return 0
         }
 
-        var updates: [(type: RenderUpdateType, data: Any)] = []
-        var elem = RenderQueueElement()
+        let elements = Self.renderBulkBuffer
+        var delivered = 0
+
+        while true {
+            let count = Int(api.dequeueBulk(queue, elements, UInt32(Self.renderBulkCapacity)))
+            if count == 0 {
+                break
+            }
 
-        while (try? render_queue_dequeue_wrap(queue, &elem)) == true {
-            guard let updateType = RenderUpdateType(rawValue: elem.type.rawValue) else {
-                continue
+            for i in 0..<count {
+                guard let updateType = RenderUpdateType(rawValue: elements[i].type.rawValue) else {
+                    continue
+                }
+
+                switch updateType {
+                case .updateGlyph:
+                    handle(.glyph(MapUpdateData(elements[i].data.map)))
+                    delivered += 1
+
+                case .updateGlyphBatch:
+                    // Expand the coalesced batch into per-tile updates (C already deduplicated)
+                    let deltas = Self.glyphBatchBuffer
+                    let deltaCount = withUnsafePointer(to: &elements[i].data.glyph_batch) { batch in
+                        api.readGlyphBatch(queue, batch, deltas, UInt32(RENDER_GLYPH_BATCH_MAX))
+                    }
+                    for d in 0..<Int(deltaCount) {
+                        handle(.glyph(MapUpdateData(deltas[d])))
+                    }
+                    delivered += Int(deltaCount)
+
+                case .updateMessage:
+                    // Text lives in the queue's arena - reading it releases the bytes
+                    let text = Self.messageTextBuffer
+                    let copied = withUnsafePointer(to: &elements[i].data.message) { msg in
+                        api.readMessage(queue, msg, text, UInt32(RENDER_MESSAGE_TEXT_MAX) + 1)
+                    }
+                    let msgUpdate = elements[i].data.message
+                    // text still holds the previous message when nothing was copied
+                    if copied == 0 && msgUpdate.length > 0 {
+                        print("[RenderQueue] ⚠️ Message read failed (\(msgUpdate.length) bytes at \(msgUpdate.offset)) - dropped")
+                        continue
+                    }
+                    if copied < msgUpdate.length {
+                        print("[RenderQueue] ⚠️ Message truncated to \(copied) of \(msgUpdate.length) bytes")
+                    }
+                    handle(.message(MessageUpdateData(
+                        text: String(cString: text),
+                        category: categoryName(api, queue, msgUpdate.category),
+                        attr: msgUpdate.attr
+                    )))
+                    delivered += 1
+
+                case .updateStatus:
+                    // Payload lives in the status lane - reading it releases the slot
+                    var status = StatusUpdate()
+                    let read = withUnsafePointer(to: &elements[i].data.status) { ref in
+                        api.readStatus(queue, ref, &status)
+                    }
+                    if read {
+                        handle(.status(StatusUpdateData(status)))
+                        delivered += 1
+                    }
+
+                case .cmdFlushMap:
+                    handle(.flushMap)
+                    delivered += 1
+
+                case .cmdClearMap:
+                    handle(.clearMap)
+                    delivered += 1
+
+                case .cmdTurnComplete:
+                    handle(.turnComplete(Int(elements[i].data.command.turn_number)))
+                    delivered += 1
+                }
             }
 
-            switch updateType {
-            case .updateGlyph:
-                let mapUpdate = elem.data.map
-                let update = MapUpdateData(
-                    x: mapUpdate.x,
-                    y: mapUpdate.y,
-                    glyph: mapUpdate.glyph,
-                    ch: mapUpdate.ch,
-                    color: mapUpdate.color,
-                    glyphflags: mapUpdate.glyphflags
-                )
-                updates.append((type: .updateGlyph, data: update))
-
-            case .updateMessage:
-                let msgUpdate = elem.data.message
-                let message = MessageUpdateData(
-                    text: msgUpdate.text,
-                    category: msgUpdate.category,
-                    attr: msgUpdate.attr
-                )
-                updates.append((type: .updateMessage, data: message))
-
-            case .updateStatus:
-                let statUpdate = elem.data.status
-                let status = StatusUpdateData(
-                    hp: statUpdate.hp,
-                    hpmax: statUpdate.hpmax,
-                    pw: statUpdate.pw,
-                    pwmax: statUpdate.pwmax,
-                    level: statUpdate.level,
-                    exp: Int(statUpdate.exp),
-                    ac: statUpdate.ac,
-                    str: statUpdate.str,
-                    dex: statUpdate.dex,
-                    con: statUpdate.con,
-                    intel: statUpdate.intel,
-                    wis: statUpdate.wis,
-                    cha: statUpdate.cha,
-                    gold: Int(statUpdate.gold),
-                    moves: Int(statUpdate.moves),
-                    align: statUpdate.align,
-                    hunger: statUpdate.hunger,
-                    conditions: UInt(statUpdate.conditions)
-                )
-                updates.append((type: .updateStatus, data: status))
-
-            case .cmdFlushMap:
-                updates.append((type: .cmdFlushMap, data: ()))
-
-            case .cmdClearMap:
-                updates.append((type: .cmdClearMap, data: ()))
-
-            case .cmdTurnComplete:
-                let cmd = elem.data.command
-                updates.append((type: .cmdTurnComplete, data: Int(cmd.turn_number)))
+            // Partial buffer = queue drained
+            if count < Self.renderBulkCapacity {
+                break
             }
         }
 
-        return updates
+        return delivered
+    }
+
+    /// Resolve an interned category ID to its name
+    private func categoryName(_ api: BridgeAPI, _ queue: UnsafeMutablePointer<RenderQueue>, _ id: UInt32) -> String {
+        guard let cName = api.categoryName(queue, id) else {
+            return "MSG"
+        }
+        return String(cString: cName)
+    }
+}
+
+// MARK: - C Struct Conversions
+
+extension NetHackBridge.MapUpdateData {
+    init(_ mapUpdate: MapUpdate) {
+        self.init(
+            x: mapUpdate.x,
+            y: mapUpdate.y,
+            glyph: mapUpdate.glyph,
+            ch: mapUpdate.ch,
+            color: mapUpdate.color,
+            glyphflags: mapUpdate.glyphflags
+        )
+    }
+}
+
+extension NetHackBridge.StatusUpdateData {
+    init(_ statUpdate: StatusUpdate) {
+        self.init(
+            hp: statUpdate.hp,
+            hpmax: statUpdate.hpmax,
+            pw: statUpdate.pw,
+            pwmax: statUpdate.pwmax,
+            level: statUpdate.level,
+            exp: Int(statUpdate.exp),
+            ac: statUpdate.ac,
+            str: statUpdate.str,
+            dex: statUpdate.dex,
+            con: statUpdate.con,
+            intel: statUpdate.intel,
+            wis: statUpdate.wis,
+            cha: statUpdate.cha,
+            gold: Int(statUpdate.gold),
+            moves: Int(statUpdate.moves),
+            align: statUpdate.align,
+            hunger: statUpdate.hunger,
+            conditions: UInt(statUpdate.conditions),
+            changed: statUpdate.changed
+        )
     }
 }
@@ -125,18 +125,13 @@ extension NetHackBridge {
         // Why: nh_restart() wipes Lua/file_prefixes that were just initialized
         //      in ios_full_dylib_init(), causing duplicate initialization!
         // With dylib reload, we get fresh state automatically with NO duplicates.
+        // Warm restart (restartDylib) resets the same per-game state without the reload
         let reloadStart = Date()
-        if dylib.isLoaded {
-            print("[Bridge] 🔄 Dylib already loaded - forcing reload for fresh state...")
-            unloadDylib()
-            print("[Bridge] ✓ Dylib unloaded")
-        }
-
         do {
-            print("[Bridge] ⏱️ Profiling dylib reload...")
-            try ensureDylibLoaded()
+            print("[Bridge] ⏱️ Profiling dylib restart...")
+            try restartDylib()
             let reloadMs = Date().timeIntervalSince(reloadStart) * 1000
-            print("[Bridge] ⏱️ Dylib reload took \(String(format: "%.1f", reloadMs))ms")
+            print("[Bridge] ⏱️ Dylib restart took \(String(format: "%.1f", reloadMs))ms")
 
             // CRITICAL FIX: Re-register callbacks after dylib reload!
             // The old callback pointers are destroyed with the old dylib.
@@ -201,9 +196,8 @@ extension NetHackBridge {
                 print("[Bridge] Dylib already loaded - FULL reinit (matching CLI)...")
                 // FULL REINIT: Shutdown clears corrupted state, init starts fresh
                 // This matches CLI which calls ios_full_dylib_init() before EVERY load
+                try restartDylib()             // Shutdown → wipe → full init, dylib stays loaded
                 try ios_reset_game_exit()
-                try ios_full_dylib_shutdown()  // Clears full_init_called, frees memory
-                try ios_full_dylib_init()      // Reinitializes everything clean
                 try nethack_real_init()        // Set up game options
                 print("[Bridge] ✓ Full reinit complete (clean state)")
             }
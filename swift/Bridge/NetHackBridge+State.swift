@@ -79,8 +79,8 @@ extension NetHackBridge {
 
     /// Get current game state snapshot (instant, no async!)
     /// - Returns: Complete game state snapshot (stairs, doors, enemies, etc.)
-    /// - Performance: ~1μs (just memcpy from double buffer, NO locks!)
-    /// - Thread-Safe: Lock-free double buffering
+    /// - Performance: ~1μs (just memcpy from published buffer, NO locks!)
+    /// - Thread-Safe: Lock-free seqlock (retries instead of returning a torn copy)
     func getGameStateSnapshot() -> GameStateSnapshot {
         // Lazy resolve on first use
         if _ios_get_game_state_snapshot == nil {
@@ -111,11 +111,82 @@ extension NetHackBridge {
         return GameStateSnapshot(from: cSnapshot)
     }
 
+    /// Get game state snapshot only if it changed since `version`
+    /// - Parameter version: Version the caller already holds (0 = none); updated on success
+    /// - Returns: Newer snapshot, or nil if unchanged (no copy made)
+    /// - Performance: Single atomic load when unchanged; seqlock copy otherwise
+    func getGameStateSnapshotIfNewer(since version: inout UInt32) -> GameStateSnapshot? {
+        guard let getIfNewer = api?.gameStateSnapshotIfNewer else {
+            return nil  // Dylib not loaded
+        }
+
+        // Allocate and zero-initialize memory for the C struct
+        let size = MemoryLayout<CGameStateSnapshot>.size
+        let alignment = MemoryLayout<CGameStateSnapshot>.alignment
+        let ptr = UnsafeMutableRawPointer.allocate(byteCount: size, alignment: alignment)
+        defer { ptr.deallocate() }
+        ptr.initializeMemory(as: UInt8.self, repeating: 0, count: size)
+
+        guard getIfNewer(ptr, &version) else {
+            return nil
+        }
+
+        return GameStateSnapshot(from: ptr.load(as: CGameStateSnapshot.self))
+    }
+
     // MARK: - Player Stats
 
     /// Get player stats as structured data
-    /// SINGLE SOURCE OF TRUTH: Only use JSON from nethack_get_player_stats_json()
+    /// Reads the binary status block (ios_status_block.h); an unchanged block returns the
+    /// last decoded stats. Falls back to nethack_get_player_stats_json() before the first
+    /// status flush or against an older dylib.
     func getPlayerStats() -> PlayerStats? {
+        if let stats = getPlayerStatsFromBlock() {
+            return stats
+        }
+        return getPlayerStatsFromJSON()
+    }
+
+    private func getPlayerStatsFromBlock() -> PlayerStats? {
+        statusBlockLock.lock()
+        defer { statusBlockLock.unlock() }
+
+        guard let getIfNewer = api?.statusBlockIfNewer else { return nil }
+
+        var block = IOSStatusBlock()
+        guard getIfNewer(&block, &statusBlockCounter) else {
+            return statusBlockStats  // Unchanged since last poll
+        }
+        guard Int(block.abi_version) == Int(IOS_STATUS_BLOCK_VERSION),
+              Int(block.struct_size) == MemoryLayout<IOSStatusBlock>.size,
+              block.flags & IOS_STATUS_IN_GAME != 0 else {
+            statusBlockStats = nil
+            return nil
+        }
+
+        let align: String
+        switch block.alignment {
+        case 1: align = "lawful"
+        case 0: align = "neutral"
+        case -1: align = "chaotic"
+        default: align = "unknown"
+        }
+
+        let stats = PlayerStats(
+            hp: Int(block.hp), hpmax: Int(block.hpmax),
+            pw: Int(block.pw), pwmax: Int(block.pwmax),
+            level: Int(block.level), exp: Int(block.exp), ac: Int(block.ac),
+            str: Int(block.str), dex: Int(block.dex), con: Int(block.con),
+            int: Int(block.intel), wis: Int(block.wis), cha: Int(block.cha),
+            gold: Int(block.gold), moves: Int(block.moves),
+            dungeonLevel: Int(block.dungeon_level), align: align,
+            hunger: Int(block.hunger), conditions: UInt(block.conditions)
+        )
+        statusBlockStats = stats
+        return stats
+    }
+
+    private func getPlayerStatsFromJSON() -> PlayerStats? {
         let jsonString: UnsafePointer<CChar>?
         do {
             jsonString = try nethack_get_player_stats_json()
@@ -0,0 +1,43 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+TravelField - Reachability and Path Preview
+// =============================================================================
+//
+// ios_travel_field.h keeps a BFS distance field from the hero over the known
+// map, rebuilt at most once per turn on first use. The UI reads it to draw a
+// path preview or gray out unreachable taps without queueing a travel command.
+//
+// Coordinates here are Swift's (0-based x, NetHack y), same as travelTo(x:y:).
+// =============================================================================
+
+extension NetHackBridge {
+
+    // MARK: - Query
+
+    /// Moves from the hero to a tile; nil if unreachable over the known map
+    nonisolated func travelDistance(x: Int, y: Int) -> Int? {
+        let distance = ios_travel_distance(Int32(x + 1), Int32(y))
+        return distance >= 0 ? Int(distance) : nil
+    }
+
+    /// Tiles travel would step on to reach (x, y), target last; nil if unreachable
+    nonisolated func travelPath(x: Int, y: Int) -> [(x: Int, y: Int)]? {
+        let capacity = Int(IOS_TRAVEL_FIELD_COLS * IOS_TRAVEL_FIELD_ROWS)
+        let buffer = UnsafeMutablePointer<IOSTravelPoint>.allocate(capacity: capacity)
+        defer { buffer.deallocate() }
+
+        let length = Int(ios_travel_path(Int32(x + 1), Int32(y), buffer, Int32(capacity)))
+        guard length >= 0 else { return nil }
+        return (0..<min(length, capacity)).map { i in
+            (x: Int(buffer[i].x) - 1, y: Int(buffer[i].y))
+        }
+    }
+
+    /// Whole field for overlays (reachable-area shading); nil when no game is running
+    nonisolated func travelField() -> IOSTravelField? {
+        var field = IOSTravelField()
+        guard ios_copy_travel_field(&field) != 0 else { return nil }
+        return field
+    }
+}
@@ -0,0 +1,43 @@
+import Foundation
+
+// =============================================================================
+// NetHackBridge+TravelSteps - Hero Path for Display-Paced Travel
+// =============================================================================
+//
+// Travel and run no longer sleep on the game thread. Each intermediate hero
+// position lands in a C ring (ios_travel_steps.h); TravelAnimator drains it
+// after a map update and replays the path at its own speed.
+// =============================================================================
+
+/// One hero position recorded during travel/run (NetHack coordinates)
+struct TravelStep {
+    let x: Int
+    let y: Int
+    let turn: Int
+    let timestampNs: UInt64
+}
+
+extension NetHackBridge {
+
+    // MARK: - Query
+
+    /// Steps recorded since the last drain, oldest first
+    func drainTravelSteps() -> [TravelStep] {
+        guard let drain = api?.travelStepsDrain else { return [] }
+
+        let capacity = Int(IOS_TRAVEL_STEPS_SIZE)
+        let buffer = UnsafeMutablePointer<IOSTravelStep>.allocate(capacity: capacity)
+        defer { buffer.deallocate() }
+
+        let count = Int(drain(buffer, UInt32(capacity)))
+        return (0..<count).map { i in
+            let step = buffer[i]
+            return TravelStep(x: Int(step.x), y: Int(step.y), turn: Int(step.turn), timestampNs: step.timestamp_ns)
+        }
+    }
+
+    /// Steps the engine dropped because the ring was full
+    func travelStepsDropped() -> UInt32 {
+        return api?.travelStepsDropped() ?? 0
+    }
+}
@@ -82,6 +82,7 @@ final class NetHackBridge: @unchecked Sendable {
     internal var _ios_full_dylib_init: (@convention(c) () -> Void)?
     internal var _ios_full_dylib_shutdown: (@convention(c) () -> Void)?
     internal var _ios_wipe_memory: (@convention(c) () -> Void)?
+    internal var _ios_warm_dylib_restart: (@convention(c) () -> Void)?
     internal var _nethack_real_newgame: (@convention(c) () -> Void)?
     internal var _nethack_real_get_output: (@convention(c) () -> UnsafePointer<CChar>)?
     internal var _nethack_real_clear_output: (@convention(c) () -> Void)?
@@ -92,10 +93,6 @@ final class NetHackBridge: @unchecked Sendable {
     internal var _nethack_start_game_thread: (@convention(c) () -> Void)?
     internal var _ios_was_exit_requested: (@convention(c) () -> Int32)?
 
-    // Callback registration functions (2)
-    internal var _ios_register_map_update_callback: (@convention(c) (@convention(c) () -> Void) -> Void)?
-    internal var _ios_register_game_ready_callback: (@convention(c) (@convention(c) () -> Void) -> Void)?
-
     // Message readiness signals
     internal var _ios_swift_ready_for_messages: (@convention(c) () -> Void)?
     internal var _ios_swift_ready_for_new_game: (@convention(c) () -> Void)?
@@ -138,11 +135,29 @@ final class NetHackBridge: @unchecked Sendable {
     internal var _ios_check_escape_warning: (@convention(c) () -> Int32)?
     internal var _ios_setup_default_symbols: (@convention(c) () -> Void)?
     internal var _ios_get_objects_at: (@convention(c) (Int32, Int32, UnsafeMutablePointer<IOSObjectInfo>, Int32) -> Int32)?
-    internal var _ios_get_render_queue: (@convention(c) () -> UnsafeMutablePointer<RenderQueue>?)?
 
-    // Batch 5: Render queue functions (2)
-    internal var _render_queue_dequeue: (@convention(c) (UnsafeMutablePointer<RenderQueue>, UnsafeMutablePointer<RenderQueueElement>) -> Bool)?
-    internal var _render_queue_is_empty: (@convention(c) (UnsafePointer<RenderQueue>) -> Bool)?
+    // Batch 5: Per-frame entry points bound once per load (render queue, map export,
+    // snapshots, logs, travel steps) - see NetHackBridge+BridgeAPI.swift
+    internal var api: BridgeAPI?
+
+    // Batch 5c: Cached glyph render table
+    internal var glyphTable: UnsafeBufferPointer<GlyphRenderInfo>?
+    internal var glyphTableGeneration: UInt32 = 0
+
+    // Batch 5d: Frame timing queries (3) - recording goes through api
+    internal var _ios_get_frame_timing_stats: (@convention(c) (Int32, UnsafeMutablePointer<FrameTimingStats>) -> Bool)?
+    internal var _ios_frame_timing_stage_name: (@convention(c) (Int32) -> UnsafePointer<CChar>?)?
+    internal var _ios_frame_timing_reset: (@convention(c) () -> Void)?
+
+    // Batch 5e: Turn-boundary read model - last copy
+    internal let readModelLock = NSLock()
+    internal var readModelCache: ReadModel?
+    internal var readModelVersion: UInt32 = 0
+
+    // Batch 5f: Binary HUD status block - last decoded stats
+    internal let statusBlockLock = NSLock()
+    internal var statusBlockStats: PlayerStats?
+    internal var statusBlockCounter: UInt32 = 0
 
     // MARK: - Legacy Properties
     // NOTE: internal for extension access
@@ -213,6 +228,15 @@ final class NetHackBridge: @unchecked Sendable {
     internal var gameTask: Task<Void, Error>?
     internal let requiredAPIVersion: Int32 = 1
 
+    // Warm restart: keep the dylib loaded between games and reset only
+    // per-game C state (ios_warm_dylib_restart). false = dlclose/dlopen
+    // every game, the old behavior, kept as a fallback.
+    static let warmRestartEnabled = true
+
+    // Set by stopGameAsync when the game was shut down but the dylib kept:
+    // C state is torn down until the next restartDylib()/ensureDylibLoaded()
+    internal var dylibParked = false
+
     // CRITICAL: Use SHARED serial queue for thread-safe NetHack C code access
     // NetHack is NOT thread-safe (from 1987!) and ALL access MUST go through ONE queue
     internal var nethackQueue: DispatchQueue {
@@ -230,6 +254,10 @@ final class NetHackBridge: @unchecked Sendable {
     /// UNIFIED INITIALIZATION: Same for NEW GAME and CONTINUE CHARACTER
     internal func ensureDylibLoaded() throws {
         guard !dylib.isLoaded else {
+            if dylibParked {
+                // Stopped game left the dylib loaded - bring C state back first
+                try restartDylib()
+            }
             return
         }
 
@@ -255,6 +283,28 @@ final class NetHackBridge: @unchecked Sendable {
         // Register callbacks with C code (now that dylib is loaded)
         registerCallbacks()
         print("[Bridge] ✅ Callbacks registered with C code")
+
+        // Per-frame entry points: one lookup for the whole table
+        bindBridgeAPI()
+    }
+
+    /// Fresh C state for the next game: warm restart when the dylib is
+    /// already loaded (no dlclose/dlopen, no symbol re-resolution), full
+    /// load otherwise. Callers re-apply character selection and call
+    /// nethack_real_init() afterwards, same as after a reload.
+    internal func restartDylib() throws {
+        guard dylib.isLoaded && Self.warmRestartEnabled else {
+            if dylib.isLoaded {
+                unloadDylib()
+            }
+            try ensureDylibLoaded()
+            return
+        }
+
+        dylibParked = false
+        try ios_warm_dylib_restart()
+        isInitialized = false
+        registerCallbacks()
     }
 
     /// Unload dylib to reset ALL static state
@@ -275,6 +325,7 @@ final class NetHackBridge: @unchecked Sendable {
         }
 
         dylib.unload()
+        dylibParked = false
 
         // Clear all function pointers (will be re-resolved on next load)
         clearFunctionPointers()
@@ -323,6 +374,7 @@ final class NetHackBridge: @unchecked Sendable {
         _ios_full_dylib_init = nil
         _ios_full_dylib_shutdown = nil
         _ios_wipe_memory = nil
+        _ios_warm_dylib_restart = nil
 
         // Batch 1: Core lifecycle
         _ios_early_init = nil
@@ -371,11 +423,30 @@ final class NetHackBridge: @unchecked Sendable {
         _ios_check_escape_warning = nil
         _ios_setup_default_symbols = nil
         _ios_get_objects_at = nil
-        _ios_get_render_queue = nil
 
-        // Batch 5: Render queue functions
-        _render_queue_dequeue = nil
-        _render_queue_is_empty = nil
+        // Batch 5: Per-frame table (entries die with the dylib)
+        api = nil
+
+        // Batch 5c: Glyph render table (pointer dies with the dylib)
+        glyphTable = nil
+        glyphTableGeneration = 0
+
+        // Batch 5d: Frame timing
+        _ios_get_frame_timing_stats = nil
+        _ios_frame_timing_stage_name = nil
+        _ios_frame_timing_reset = nil
+
+        // Batch 5e: Read model (versions restart with the next dylib)
+        readModelLock.lock()
+        readModelCache = nil
+        readModelVersion = 0
+        readModelLock.unlock()
+
+        // Batch 5f: Status block
+        statusBlockLock.lock()
+        statusBlockStats = nil
+        statusBlockCounter = 0
+        statusBlockLock.unlock()
     }
 
     // MARK: - Lazy Symbol Resolution
@@ -497,6 +568,13 @@ final class NetHackBridge: @unchecked Sendable {
         _ios_wipe_memory?()
     }
 
+    internal func ios_warm_dylib_restart() throws {
+        if _ios_warm_dylib_restart == nil {
+            _ios_warm_dylib_restart = try dylib.resolveFunction("ios_warm_dylib_restart")
+        }
+        _ios_warm_dylib_restart?()
+    }
+
     internal func ios_early_init() throws {
         try ensureDylibLoaded()  // CRITICAL FIX: Load dylib before resolving symbol
         if _ios_early_init == nil {
@@ -821,18 +899,13 @@ final class NetHackBridge: @unchecked Sendable {
         // This is the PROVEN pattern from loadGame() that works 100% consistently!
         // Why: dylib reload gives us fresh state automatically - no need for complex cleanup
         // With dylib reload, we get: fresh Lua, fresh DLB, fresh iOS bridge, fresh memory
+        // Warm restart (restartDylib) resets the same per-game state without the reload
         let reloadStart = Date()
-        if dylib.isLoaded {
-            print("[Bridge] 🔄 Dylib already loaded - forcing reload for fresh state...")
-            unloadDylib()
-            print("[Bridge] ✓ Dylib unloaded")
-        }
-
         do {
-            print("[Bridge] ⏱️ Profiling dylib reload...")
-            try ensureDylibLoaded()
+            print("[Bridge] ⏱️ Profiling dylib restart...")
+            try restartDylib()
             let reloadMs = Date().timeIntervalSince(reloadStart) * 1000
-            print("[Bridge] ⏱️ Dylib reload took \(String(format: "%.1f", reloadMs))ms")
+            print("[Bridge] ⏱️ Dylib restart took \(String(format: "%.1f", reloadMs))ms")
 
             // CRITICAL FIX: Re-register callbacks after dylib reload!
             // The old callback pointers are destroyed with the old dylib.
@@ -1136,9 +1209,16 @@ final class NetHackBridge: @unchecked Sendable {
         try? nethack_real_clear_output()
 
         // Phase 4: NOW SAFE to unload dylib (thread confirmed dead, cleanup done)
-        print("[Bridge] Phase 4: Unloading dylib (SAFE - thread exited)...")
-        unloadDylib()
-        print("[Bridge] ✅ Dylib unloaded - ALL static state cleared automatically!")
+        // Warm restart keeps it loaded instead; the next game re-inits in place
+        if Self.warmRestartEnabled {
+            print("[Bridge] Phase 4: Parking dylib (stays loaded for warm restart)...")
+            dylibParked = true
+            isInitialized = false
+        } else {
+            print("[Bridge] Phase 4: Unloading dylib (SAFE - thread exited)...")
+            unloadDylib()
+            print("[Bridge] ✅ Dylib unloaded - ALL static state cleared automatically!")
+        }
 
         // Final state reset on MainActor
         // This runs AFTER cleanup, ensuring gameStarted = false happens LAST
@@ -1364,42 +1444,13 @@ final class NetHackBridge: @unchecked Sendable {
 
     /// Register callbacks with C code (replaces weak symbols which don't work with dylib)
     internal func registerCallbacks() {
-        // Resolve registration functions
-        _ios_register_map_update_callback = try? dylib.resolveFunction("ios_register_map_update_callback")
-        _ios_register_game_ready_callback = try? dylib.resolveFunction("ios_register_game_ready_callback")
-
-        guard let registerMapCallback = _ios_register_map_update_callback,
-              let registerGameReadyCallback = _ios_register_game_ready_callback else {
-            print("[SWIFT] ❌ Failed to resolve callback registration functions!")
+        // Map updates, messages, game ready and death start all arrive as
+        // one event batch per turn boundary (NetHackBridge+EventBus.swift)
+        guard registerEventBus() else {
+            print("[SWIFT] ❌ Failed to resolve ios_event_bus_register!")
             return
         }
-
-        // Map update callback
-        let mapCallback: @convention(c) () -> Void = {
-            DispatchQueue.main.async {
-                NotificationCenter.default.post(name: .nethackMapUpdated, object: nil)
-            }
-        }
-
-        // Game ready callback
-        let gameReadyCallback: @convention(c) () -> Void = {
-            print("[SWIFT GAME READY] 🎯 Game ready signal received from C")
-            DispatchQueue.main.async {
-                print("[SWIFT GAME READY] Posting notification to main thread")
-                NotificationCenter.default.post(name: .nethackGameReady, object: nil)
-            }
-        }
-
-        // Register with C code
-        registerMapCallback(mapCallback)
-        registerGameReadyCallback(gameReadyCallback)
-        print("[SWIFT] ✅ Map and game-ready callbacks registered")
-
-        // Register death animation callback
-        // This is called from C when death is detected (BEFORE data collection)
-        // to trigger visual animation IN PARALLEL with the ~10s death disclosure
-        registerDeathAnimationCallback()
-        print("[SWIFT] ✅ Death animation callback registered")
+        print("[SWIFT] ✅ Event bus callback registered")
     }
 
     // MARK: - Game State Snapshot (Push Model - Lock-Free)
@@ -16,6 +16,27 @@ import Foundation
 @_silgen_name("ios_has_container_at")
 private func _ios_has_container_at(_ x: Int32, _ y: Int32) -> Int32
 
+@_silgen_name("ios_kill_stats_generation")
+private func _ios_kill_stats_generation() -> UInt32
+
+@_silgen_name("ios_get_tile_object_summary")
+private func _ios_get_tile_object_summary(_ x: Int32, _ y: Int32,
+                                          _ out: UnsafeMutablePointer<IOSTileObjectSummary>) -> Int32
+
+// MARK: - Swift-friendly Tile Summary
+
+/// Objects on one tile, from the C floor object index (O(1), no names)
+struct TileObjectSummary {
+    let count: Int
+    let topGlyph: Int32              // -1 if empty
+    let topObjectID: UInt32
+    let hasContainer: Bool
+    let hasLockedContainer: Bool
+
+    static let empty = TileObjectSummary(count: 0, topGlyph: -1, topObjectID: 0,
+                                         hasContainer: false, hasLockedContainer: false)
+}
+
 // MARK: - Swift-friendly Terrain Info Struct
 
 struct TerrainInfo {
@@ -250,13 +271,20 @@ class ObjectBridgeWrapper {
             return []
         }
 
+        // Empty tiles (most taps) answer from the index without a buffer
+        let summary = tileSummary(x: x, y: y)
+        guard summary.count > 0 else {
+            return []
+        }
+
         // Allocate buffer for C bridge (SWIFTUI-P-002: avoid expensive calculations)
-        var buffer = [IOSObjectInfo](repeating: IOSObjectInfo(), count: maxObjects)
+        let capacity = min(summary.count, maxObjects)
+        var buffer = [IOSObjectInfo](repeating: IOSObjectInfo(), count: capacity)
 
         // Call C bridge function
         let count = buffer.withUnsafeMutableBufferPointer { bufferPtr -> Int32 in
             guard let baseAddress = bufferPtr.baseAddress else { return 0 }
-            return ios_get_objects_at(x, y, baseAddress, Int32(maxObjects))
+            return ios_get_objects_at(x, y, baseAddress, Int32(capacity))
         }
 
         guard count > 0 else {
@@ -374,6 +402,26 @@ class ObjectBridgeWrapper {
     /// Get all monsters the player has discovered (seen up close)
     /// Returns two arrays: killed monsters and seen-only monsters
     static func getDiscoveredMonsters() -> (killed: [DiscoveredMonster], seenOnly: [DiscoveredMonster]) {
+        // C side bumps the generation only when a kill or sighting changed anything
+        let generation = _ios_kill_stats_generation()
+        discoveredLock.lock()
+        if let cached = discoveredCache, cached.generation == generation {
+            discoveredLock.unlock()
+            return cached.result
+        }
+        discoveredLock.unlock()
+
+        let result = fetchDiscoveredMonsters()
+        discoveredLock.lock()
+        discoveredCache = (generation, result)
+        discoveredLock.unlock()
+        return result
+    }
+
+    private static let discoveredLock = NSLock()
+    private static var discoveredCache: (generation: UInt32, result: (killed: [DiscoveredMonster], seenOnly: [DiscoveredMonster]))?
+
+    private static func fetchDiscoveredMonsters() -> (killed: [DiscoveredMonster], seenOnly: [DiscoveredMonster]) {
         var buffer = [IOSMonsterInfo](repeating: IOSMonsterInfo(), count: maxMonsters)
 
         let count = buffer.withUnsafeMutableBufferPointer { bufferPtr -> Int32 in
@@ -431,6 +479,20 @@ class ObjectBridgeWrapper {
         guard x >= 0, y >= 0 else { return false }
         return _ios_has_container_at(x, y) != 0
     }
+
+    /// Object count, top glyph and container flags for a tile (NetHack coordinates)
+    static func tileSummary(x: Int32, y: Int32) -> TileObjectSummary {
+        guard x >= 0, y >= 0 else { return .empty }
+        var raw = IOSTileObjectSummary()
+        guard _ios_get_tile_object_summary(x, y, &raw) != 0 else { return .empty }
+        return TileObjectSummary(
+            count: Int(raw.count),
+            topGlyph: raw.top_glyph,
+            topObjectID: raw.top_o_id,
+            hasContainer: (Int32(raw.flags) & IOS_TILE_HAS_CONTAINER) != 0,
+            hasLockedContainer: (Int32(raw.flags) & IOS_TILE_HAS_LOCKED_CONTAINER) != 0
+        )
+    }
 }
 
 // MARK: - Swift-friendly Monster Discovery Struct
@@ -49,6 +49,7 @@ struct ContextActionsButton: View {
 
     // PUSH MODEL: Game state snapshot (instant read)
     @State private var snapshot: GameStateSnapshot = GameStateSnapshot()
+    @State private var snapshotVersion: UInt32 = 0
     
     // UI State
     @State private var isExpanded = false
@@ -386,7 +387,10 @@ struct ContextActionsButton: View {
     // MARK: - Helpers
     
     private func refreshSnapshot() {
-        snapshot = NetHackBridge.shared.getGameStateSnapshot()
+        // Skip the copy (and the SwiftUI invalidation) when nothing changed
+        if let newer = NetHackBridge.shared.getGameStateSnapshotIfNewer(since: &snapshotVersion) {
+            snapshot = newer
+        }
     }
 }
 
@@ -0,0 +1,118 @@
+//
+//  GlyphTileCache.swift
+//  nethack
+//
+//  Shared tile geometries for the per-node SceneKit map renderer
+//
+
+import SceneKit
+import UIKit
+
+/// Tile planes keyed by what they show, shared by every node drawing the same glyph.
+///
+/// A level is mostly the same handful of glyphs (`.` floor, `#` corridor,
+/// walls, doors); without the cache each recreated node re-rendered its
+/// CoreGraphics image and uploaded a texture of its own. Entries survive
+/// level changes and new games, so a full map rebuild only draws glyphs
+/// never seen before. Least recently used entries are dropped past
+/// `capacity`. Safe to use from any thread (prewarm runs off the main thread).
+final class GlyphTileCache {
+    static let shared = GlyphTileCache()
+
+    struct Key: Hashable {
+        let character: Character
+        let rgba: UInt32
+        let isPet: Bool
+        let tileSize: Float
+    }
+
+    /// Distinct (glyph, colour) combinations a long game realistically reaches
+    let capacity = 512
+
+    private struct Entry {
+        let geometry: SCNGeometry
+        var lastUse: UInt64
+    }
+
+    private var entries: [Key: Entry] = [:]
+    private var useClock: UInt64 = 0
+    private let lock = NSLock()
+
+    private(set) var hits = 0
+    private(set) var misses = 0
+
+    // MARK: - Lookup
+
+    /// Plane showing `tile`, built and cached on first use
+    func geometry(for tile: MapTile, tileSize: Float) -> SCNGeometry {
+        let color = SceneKitMapView.MapUpdateCoordinator.tileColor(for: tile)
+        return geometry(character: tile.character, color: color, isPet: tile.isPet, tileSize: tileSize)
+    }
+
+    func geometry(character: Character, color: UIColor, isPet: Bool, tileSize: Float) -> SCNGeometry {
+        let key = Key(character: character, rgba: Self.pack(color), isPet: isPet, tileSize: tileSize)
+
+        lock.lock()
+        useClock += 1
+        if var entry = entries[key] {
+            entry.lastUse = useClock
+            entries[key] = entry
+            hits += 1
+            lock.unlock()
+            return entry.geometry
+        }
+        misses += 1
+        lock.unlock()
+
+        // Draw outside the lock; a racing miss for the same key just redraws once
+        let geometry = SceneKitMapView.MapUpdateCoordinator.makeTileGeometry(
+            character: character, color: color, isPet: isPet, tileSize: tileSize)
+
+        lock.lock()
+        if entries.count >= capacity { evictLocked() }
+        entries[key] = Entry(geometry: geometry, lastUse: useClock)
+        lock.unlock()
+        return geometry
+    }
+
+    // MARK: - Prewarm
+
+    /// Draw the glyphs every level is made of before the first map pass needs them
+    func prewarm(tileSize: Float) {
+        let common: [(Character, TileType)] = [
+            (".", .floor), ("#", .corridor), ("-", .wall), ("|", .wall),
+            ("+", .door), ("|", .doorOpen), ("-", .doorOpen), ("<", .stairs), (">", .stairs),
+            ("}", .water), ("@", .player)
+        ]
+        DispatchQueue.global(qos: .utility).async {
+            for (glyph, type) in common {
+                guard let color = SceneKitMapView.MapUpdateCoordinator.typeColor(type) else { continue }
+                _ = self.geometry(character: glyph, color: color, isPet: false, tileSize: tileSize)
+            }
+        }
+    }
+
+    // MARK: - Eviction
+
+    /// Memory pressure: drop every entry (nodes on screen keep their geometry alive)
+    func purge() {
+        lock.lock()
+        entries.removeAll()
+        lock.unlock()
+    }
+
+    /// Drop the least recently used quarter, so eviction cost is amortised over many inserts
+    private func evictLocked() {
+        let victims = entries.sorted { $0.value.lastUse < $1.value.lastUse }.prefix(capacity / 4)
+        for (key, _) in victims {
+            entries.removeValue(forKey: key)
+        }
+    }
+
+    private static func pack(_ color: UIColor) -> UInt32 {
+        var r: CGFloat = 0, g: CGFloat = 0, b: CGFloat = 0, a: CGFloat = 0
+        color.getRed(&r, green: &g, blue: &b, alpha: &a)
+        func byte(_ c: CGFloat) -> UInt32 { UInt32(max(0, min(255, (c * 255).rounded()))) }
+        return byte(r) << 24 | byte(g) << 16 | byte(b) << 8 | byte(a)
+    }
+}
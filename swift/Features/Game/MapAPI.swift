@@ -28,6 +28,12 @@ enum MapAPI {
         return ObjectBridgeWrapper.getObjectsAt(x: nhX, y: nhY)
     }
 
+    /// Object count / top glyph / container flags at Swift coordinate (O(1))
+    static func tileSummary(swift coord: SwiftCoord) -> TileObjectSummary {
+        let (nhX, nhY) = CoordinateConverter.swiftToNetHack(coord).forCBridge()
+        return ObjectBridgeWrapper.tileSummary(x: nhX, y: nhY)
+    }
+
     // MARK: - Adjacency Helpers
 
     /// Get objects in all 8 adjacent tiles
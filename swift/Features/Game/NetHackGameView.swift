@@ -26,6 +26,11 @@ struct NetHackGameView: View {
     // Message Log Sheet (tap on notifications to open)
     @State private var showMessageLog = false
 
+    #if DEBUG
+    // Frame timing debug overlay (FrameTimingOverlay)
+    @AppStorage("debug.frameTimingOverlay") private var showFrameTimingOverlay = false
+    #endif
+
     init(gameManager: NetHackGameManager) {
         self.gameManager = gameManager
     }
@@ -97,6 +102,18 @@ struct NetHackGameView: View {
                 .zIndex(1)
         }
 
+        #if DEBUG
+        // DEBUG: Turn stage latency histograms (defaults write ... debug.frameTimingOverlay -bool YES)
+        .overlay(alignment: .bottomTrailing) {
+            if showFrameTimingOverlay {
+                FrameTimingOverlay()
+                    .padding(.trailing, 12)
+                    .padding(.bottom, 80)
+                    .zIndex(ZIndex.layer(.mapOverlays))
+            }
+        }
+        #endif
+
         // OVERLAY LAYER 2: Context Card (z-index 2)
         // IPHONE LANDSCAPE FIX: Position context card with proper safe area insets
         // NOTE: Old ContextOverlayCard removed - replaced by ContextActionsButton (horizontal FAB)
@@ -477,54 +494,43 @@ struct NetHackGameView: View {
         }
         // NOTE: Generic Menu System uses overlay at lines 230-260 (not .sheet)
         // This allows custom animation, tap-outside behavior, and haptic feedback
-        .onReceive(NotificationCenter.default.publisher(for: Notification.Name("NetHackMessage"))) { notification in
-            var messageText: String? = nil
-
-            if let messageDict = notification.object as? [String: Any],
-               let text = messageDict["message"] as? String {
-                messageText = text
-            } else if let text = notification.object as? String {
-                messageText = text
-            }
-
-            guard let text = messageText else { return }
-
-            guard let messageDict = notification.object as? [String: Any],
-                  let category = messageDict["category"] as? String,
-                  let attr = messageDict["attr"] as? Int else { return }
-
-            // PERF: Don't use withAnimation for append - triggers expensive SwiftUI diff calculation
-            // The message transition animation is handled by the .transition() modifier in messagesOverlay
-            let attributes = GameMessage.MessageAttributes(fromBitmask: attr)
-            let newMessage = GameMessage(
-                text: text,
-                turnNumber: gameManager.turnCount,
-                timestamp: Date(),
-                count: 1,
-                attributes: attributes,
-                category: category
-            )
-            messages.append(newMessage)
-
-            // Pickup haptic feedback (distinct from movement tap)
-            // Detect autopickup messages: "a - item name", "$: gold", or "pick up" in text
-            if UserPreferencesManager.shared.isAutopickupEnabled() {
-                let lowercased = text.lowercased()
-                let isPickupMessage = category == "ITEM" ||
+        .onReceive(NotificationCenter.default.publisher(for: .nethackMessages)) { notification in
+            // One notification per turn boundary carries all of its messages
+            guard let entries = notification.object as? [MessageLogEntry], !entries.isEmpty else { return }
+
+            var pickedUp = false
+            for entry in entries {
+                // PERF: Don't use withAnimation for append - triggers expensive SwiftUI diff calculation
+                // The message transition animation is handled by the .transition() modifier in messagesOverlay
+                let attributes = GameMessage.MessageAttributes(fromBitmask: entry.attr)
+                messages.append(GameMessage(
+                    text: entry.text,
+                    turnNumber: gameManager.turnCount,
+                    timestamp: Date(),
+                    count: 1,
+                    attributes: attributes,
+                    category: entry.category
+                ))
+
+                // Detect autopickup messages: "a - item name", "$: gold", or "pick up" in text
+                let lowercased = entry.text.lowercased()
+                pickedUp = pickedUp || entry.category == "ITEM" ||
                     lowercased.contains("pick up") ||
                     lowercased.contains("gold piece") ||
-                    (text.count > 3 && text.dropFirst().hasPrefix(" - "))  // "a - item" pattern
-                if isPickupMessage {
-                    HapticManager.shared.pickup()
-                }
+                    (entry.text.count > 3 && entry.text.dropFirst().hasPrefix(" - "))  // "a - item" pattern
+            }
+
+            // Pickup haptic feedback (distinct from movement tap), once per batch
+            if pickedUp && UserPreferencesManager.shared.isAutopickupEnabled() {
+                HapticManager.shared.pickup()
             }
 
-            // Store in history manager for fullscreen message log
-            MessageHistoryManager.shared.addMessage(newMessage)
+            // History manager pulls the new entries from the C message log
+            MessageHistoryManager.shared.refresh()
 
             // Trim old messages without animation (just data cleanup)
             if messages.count > 10 {
-                messages.removeFirst()
+                messages.removeFirst(messages.count - 10)
             }
         }
     }
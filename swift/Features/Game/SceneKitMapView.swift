@@ -40,6 +40,8 @@ struct SceneKitMapView: UIViewRepresentable {
         scnView.allowsCameraControl = false  // No rotation - fixed 2D view
         scnView.antialiasingMode = .multisampling2X
         scnView.showsStatistics = false  // Hide stats for cleaner view
+        // On demand: frames only for scene changes and running animations
+        scnView.rendersContinuously = !MapUpdateCoordinator.rendersOnDemand
 
         // Create scene
         let scene = SCNScene()
@@ -73,6 +75,9 @@ struct SceneKitMapView: UIViewRepresentable {
         // Setup fog for unexplored areas
         setupFog(scene: scene)
 
+        // Draw the common glyphs while the scene is being set up
+        GlyphTileCache.shared.prewarm(tileSize: tileSize)
+
         // Store coordinator and initialize map updater
         context.coordinator.scnView = scnView
         context.coordinator.mapUpdater = MapUpdateCoordinator()
@@ -118,6 +123,7 @@ struct SceneKitMapView: UIViewRepresentable {
         }
         context.coordinator.mapUpdater?.scnView = scnView
         context.coordinator.mapUpdater?.scene = scnView.scene
+        context.coordinator.mapUpdater?.updateRenderMode(travelAnimating: mapState.isAnimatingTravel)
         context.coordinator.mapUpdater?.updateMap(mapState: mapState)
     }
 
@@ -148,6 +154,8 @@ struct SceneKitMapView: UIViewRepresentable {
         weak var scnView: SCNView?
         weak var scene: SCNScene?
         var tileNodes: [[SCNNode?]] = []
+        var tileKeys: [[Int]] = []     // Identity of what each node shows (tileKey), emptyTileKey = no node
+        var atlas: TileAtlasRenderer?  // Single-mesh renderer when "render.tileAtlas" is on
         var lastPlayerX: Int = -1
         var lastPlayerY: Int = -1
         let tileSize: Float = kSceneKitTileSize  // Use global constant
@@ -159,6 +167,28 @@ struct SceneKitMapView: UIViewRepresentable {
         // PERF: Full refresh removed - was rebuilding 2000 tiles every second
         // Incremental updates via tileUpdateCounter are sufficient
 
+        // RENDER ON DEMAND: NetHack spends most of its time blocked waiting for
+        // input, so the view draws only when updateMap changed tiles, camera or
+        // light, and while SceneKit animations run (camera glide, creature pulse).
+        // Travel playback mutates tiles every refresh, so it renders continuously.
+        static let onDemandDefaultsKey = "render.onDemand"
+        /// Creature pulse: cycles after the node appears in on-demand mode (forever otherwise)
+        static let onDemandPulseCycles: Float = 2
+
+        static var rendersOnDemand: Bool {
+            UserDefaults.standard.object(forKey: onDemandDefaultsKey) as? Bool ?? true
+        }
+
+        /// Continuous while travel animates or on-demand rendering is off
+        func updateRenderMode(travelAnimating: Bool) {
+            guard let scnView else { return }
+            let continuous = travelAnimating || !Self.rendersOnDemand
+            if scnView.rendersContinuously != continuous {
+                scnView.rendersContinuously = continuous
+                Log.verbose(.sceneKit, "rendersContinuously = \(continuous)")
+            }
+        }
+
         func updateMap(mapState: MapState) {
             // CRITICAL: Don't access game state after death - memory may be freed
             guard NetHackBridge.shared.gameStarted else {
@@ -188,80 +218,97 @@ struct SceneKitMapView: UIViewRepresentable {
 
             // Real update OR enough time passed - render!
             Log.verbose(.mapUpdate, "RENDERING")
+            let renderStart = DispatchTime.now().uptimeNanoseconds
+            defer {
+                let bridge = NetHackBridge.shared
+                bridge.recordFrameTiming(FRAME_STAGE_SCENE, nanoseconds: DispatchTime.now().uptimeNanoseconds - renderStart)
+                // Nodes are in the scene - the next SceneKit frame shows this input
+                bridge.frameTimingFramePresented()
+            }
             lastUpdateTime = now
             lastTileUpdateCounter = mapState.tileUpdateCounter
 
             // Map dimensions and player position available
 
-            // Initialize tile nodes array if needed
-            if tileNodes.count != mapState.height || (tileNodes.first?.count ?? 0) != mapState.width {
+            // Initialize tile nodes array if needed (new node grid or renderer switch starts from a full pass)
+            let dirty = mapState.takeDirtyCells()
+            var fullPass = dirty.all
+            let useAtlas = TileAtlasRenderer.isEnabled
+            if tileNodes.count != mapState.height || (tileNodes.first?.count ?? 0) != mapState.width
+                || useAtlas != (atlas != nil) {
                 clearTiles()
                 tileNodes = Array(repeating: Array(repeating: nil, count: mapState.width), count: mapState.height)
-            }
-
-            // FIX: Invalidate nodes where tile content changed
-            // Node name format: "tile_x_y_CHAR" - compare CHAR with current tile
-            for y in 0..<tileNodes.count {
-                for x in 0..<(tileNodes[y].count) {
-                    guard let node = tileNodes[y][x] else { continue }
-                    let tile = mapState.tiles[safe: y]?[safe: x] ?? nil
-                    let currentChar: Character = tile?.character ?? " "
-
-                    // Extract cached character from node name (last component after _)
-                    let cachedChar: Character = {
-                        guard let name = node.name,
-                              let lastPart = name.split(separator: "_").last,
-                              let char = lastPart.first else { return "\0" }
-                        return char
-                    }()
-
-                    // If character changed, invalidate node
-                    if cachedChar != currentChar {
-                        node.removeFromParentNode()
-                        tileNodes[y][x] = nil
-                    }
+                tileKeys = Array(repeating: Array(repeating: Self.emptyTileKey, count: mapState.width), count: mapState.height)
+                if useAtlas {
+                    let renderer = TileAtlasRenderer(tileSize: tileSize)
+                    renderer.resize(width: mapState.width, height: mapState.height)
+                    scene.rootNode.addChildNode(renderer.node)
+                    atlas = renderer
                 }
+                fullPass = true
             }
 
-            // Update tiles
-            var tilesCreated = 0
-            var firstTilePos: SCNVector3?
-            for y in 0..<mapState.height {
-                for x in 0..<mapState.width {
-                    updateTile(x: x, y: y, mapState: mapState, scene: scene)
-                    if let node = tileNodes[y][x] {
-                        tilesCreated += 1
-                        if firstTilePos == nil {
-                            firstTilePos = node.position
-                        }
+            // Touch only the cells the render queue changed since the last update
+            var changed = false
+            if fullPass {
+                for y in 0..<mapState.height {
+                    for x in 0..<mapState.width {
+                        changed = updateTile(x: x, y: y, mapState: mapState, scene: scene) || changed
                     }
                 }
+            } else {
+                for index in dirty.cells {
+                    changed = updateTile(x: index % mapState.width, y: index / mapState.width,
+                                         mapState: mapState, scene: scene) || changed
+                }
             }
-            // Tile nodes created and positioned
+            atlas?.commit()
 
             // Update camera to follow player
-            updateCameraPosition(mapState: mapState)
+            changed = updateCameraPosition(mapState: mapState) || changed
 
             // Update player light position
-            updatePlayerLight(mapState: mapState)
+            changed = updatePlayerLight(mapState: mapState) || changed
+
+            // On demand: ask for the frame that shows this turn (animations keep drawing on their own)
+            if changed, let scnView, !scnView.rendersContinuously {
+                scnView.setNeedsDisplay()
+            }
         }
 
-        private func updateTile(x: Int, y: Int, mapState: MapState, scene: SCNScene) {
+        /// No node: nil tile or blank space
+        static let emptyTileKey = -1
+
+        /// What a tile node shows: glyph, character and pet marker packed in one Int
+        static func tileKey(_ tile: MapTile?) -> Int {
+            guard let tile, tile.character != " " else { return emptyTileKey }
+            let scalar = Int(tile.character.unicodeScalars.first?.value ?? 0)
+            return (Int(tile.glyph) << 22) | (scalar << 1) | (tile.isPet ? 1 : 0)
+        }
+
+        /// Returns true if the cell's content changed
+        @discardableResult
+        private func updateTile(x: Int, y: Int, mapState: MapState, scene: SCNScene) -> Bool {
             let tile = mapState.tiles[safe: y]?[safe: x] ?? nil
 
-            // PERF FIX: Only recreate if node was invalidated (set to nil in first pass)
-            // Valid nodes already exist and don't need recreation
-            if tileNodes[y][x] != nil {
-                return  // Node still valid from cache, skip recreation
+            // PERF FIX: Node still shows this content - nothing to rebuild
+            let key = Self.tileKey(tile)
+            if key == tileKeys[y][x] {
+                return false
             }
+            tileKeys[y][x] = key
 
-            // For now, just render any tile that exists (ignore visibility system)
-            guard let tileToRender = tile else { return }
-
-            // Skip empty spaces for now
-            if tileToRender.character == " " {
-                return
+            // Atlas mode: the cell is a quad in the shared mesh, no node of its own
+            if let atlas {
+                atlas.setCell(x: x, y: y, tile: tile)
+                return true
             }
+            tileNodes[y][x]?.removeFromParentNode()
+            tileNodes[y][x] = nil
+
+            // For now, just render any tile that exists (ignore visibility system)
+            // Blank spaces get no node
+            guard key != Self.emptyTileKey, let tileToRender = tile else { return true }
 
             // Create tile node (use visible for now)
             let node = createTileNode(tile: tileToRender, visibility: .visible, x: x, y: y)
@@ -270,7 +317,7 @@ struct SceneKitMapView: UIViewRepresentable {
             guard CoordinateConverter.makeSwift(x: x, y: y) != nil else {
                 let timestamp = String(format: "%.3f", CACurrentMediaTime())
                 print("[\(timestamp)] [COORD] ERROR: Invalid coordinate [SW:\(x),\(y)]")
-                return
+                return true
             }
             // Convert to SceneKit 3D position
             let sceneKitPos = SCNVector3(
@@ -281,18 +328,71 @@ struct SceneKitMapView: UIViewRepresentable {
             node.position = sceneKitPos
             scene.rootNode.addChildNode(node)
             tileNodes[y][x] = node
+            return true
+        }
+
+        /// Gruvbox color based on tile type (shared with TileAtlasRenderer)
+        static func tileColor(for tile: MapTile) -> UIColor {
+            if let color = typeColor(tile.type, isPet: tile.isPet) {
+                return color
+            }
+            // Use the original foreground color
+            return UIColor(
+                red: CGFloat(tile.foreground.r) / 255.0,
+                green: CGFloat(tile.foreground.g) / 255.0,
+                blue: CGFloat(tile.foreground.b) / 255.0,
+                alpha: 1.0
+            )
+        }
+
+        /// Palette color for terrain/creature types; nil = use the tile's own foreground
+        static func typeColor(_ type: TileType, isPet: Bool = false) -> UIColor? {
+            switch type {
+            case .wall:
+                return GruvboxColors.white  // Light walls
+            case .floor:
+                return GruvboxColors.black  // Dark floors
+            case .corridor:
+                return UIColor(white: 0.3, alpha: 1.0)  // Lighter corridors/tunnels
+            case .player:
+                return GruvboxColors.foreground  // Player in foreground color
+            case .door, .doorOpen, .doorClosed:
+                return GruvboxColors.yellow  // Doors in yellow/brown
+            case .stairs:
+                return GruvboxColors.yellow  // Stairs also yellow
+            case .water:
+                return GruvboxColors.blue  // Water in blue
+            case .monster:
+                return isPet ? GruvboxColors.green : GruvboxColors.red  // Pets green, monsters red
+            default:
+                return nil
+            }
         }
 
         private func createTileNode(tile: MapTile, visibility: TileVisibility, x: Int, y: Int) -> SCNNode {
             let node = SCNNode()
-            // Set node name for hit-testing AND cache invalidation
-            // Format: tile_x_y_CHAR - allows checking if tile content changed
+            // Set node name for hit-testing (content identity lives in tileKeys)
             node.name = "tile_\(x)_\(y)_\(tile.character)"
             
             // PERFORMANCE: CategoryBitMask = 1 for hitTest filtering
             // This allows hitTest to ONLY check tile nodes (ignores UI, lights, etc.)
             node.categoryBitMask = 1
 
+            // PERF: Plane + glyph material shared with every node showing the same glyph
+            node.geometry = GlyphTileCache.shared.geometry(for: tile, tileSize: tileSize)
+
+            // Add subtle animation for living creatures
+            if tile.type == .player || tile.type == .monster {
+                if visibility == .visible {
+                    addPulseAnimation(to: node)
+                }
+            }
+
+            return node
+        }
+
+        /// Build the tile plane for a glyph (called by GlyphTileCache on a miss)
+        static func makeTileGeometry(character: Character, color: UIColor, isPet: Bool, tileSize: Float) -> SCNGeometry {
             // Create plane geometry for tile
             let plane = SCNPlane(width: CGFloat(tileSize), height: CGFloat(tileSize))
 
@@ -301,42 +401,13 @@ struct SceneKitMapView: UIViewRepresentable {
             material.lightingModel = .constant  // No lighting calculations
             material.isDoubleSided = true  // Visible from both sides
 
-            // Gruvbox color based on tile type
-            let tileColor: UIColor
-            switch tile.type {
-            case .wall:
-                tileColor = GruvboxColors.white  // Light walls
-            case .floor:
-                tileColor = GruvboxColors.black  // Dark floors
-            case .corridor:
-                tileColor = UIColor(white: 0.3, alpha: 1.0)  // Lighter corridors/tunnels
-            case .player:
-                tileColor = GruvboxColors.foreground  // Player in foreground color
-            case .door, .doorOpen, .doorClosed:
-                tileColor = GruvboxColors.yellow  // Doors in yellow/brown
-            case .stairs:
-                tileColor = GruvboxColors.yellow  // Stairs also yellow
-            case .water:
-                tileColor = GruvboxColors.blue  // Water in blue
-            case .monster:
-                tileColor = tile.isPet ? GruvboxColors.green : GruvboxColors.red  // Pets green, monsters red
-            default:
-                // Use the original foreground color
-                tileColor = UIColor(
-                    red: CGFloat(tile.foreground.r) / 255.0,
-                    green: CGFloat(tile.foreground.g) / 255.0,
-                    blue: CGFloat(tile.foreground.b) / 255.0,
-                    alpha: 1.0
-                )
-            }
-
             // Render NetHack glyphs (ASCII characters)
-            if tile.character != " " {
+            if character != " " {
                 let glyphImage = createTextImage(
-                    text: String(tile.character),
-                    color: tileColor,
+                    text: String(character),
+                    color: color,
                     size: CGSize(width: 64, height: 64),
-                    isPet: tile.isPet
+                    isPet: isPet
                 )
                 material.emission.contents = glyphImage
                 material.diffuse.contents = UIColor.black
@@ -347,19 +418,10 @@ struct SceneKitMapView: UIViewRepresentable {
             }
 
             plane.materials = [material]
-            node.geometry = plane
-
-            // Add subtle animation for living creatures
-            if tile.type == .player || tile.type == .monster {
-                if visibility == .visible {
-                    addPulseAnimation(to: node)
-                }
-            }
-
-            return node
+            return plane
         }
 
-        private func createTextImage(text: String, color: UIColor, size: CGSize, isPet: Bool = false) -> UIImage? {
+        private static func createTextImage(text: String, color: UIColor, size: CGSize, isPet: Bool = false) -> UIImage? {
             // For now, keep ASCII but we can switch to tile images
             let renderer = UIGraphicsImageRenderer(size: size)
             return renderer.image { context in
@@ -633,7 +695,8 @@ struct SceneKitMapView: UIViewRepresentable {
             pulseAnimation.toValue = SCNVector3(1.05, 1.05, 1.0)
             pulseAnimation.duration = 2.0
             pulseAnimation.autoreverses = true
-            pulseAnimation.repeatCount = .infinity
+            // An endless pulse would keep the view drawing every frame while idle
+            pulseAnimation.repeatCount = Self.rendersOnDemand ? Self.onDemandPulseCycles : .infinity
             node.addAnimation(pulseAnimation, forKey: "pulse")
         }
 
@@ -688,8 +751,10 @@ struct SceneKitMapView: UIViewRepresentable {
             return node
         }
 
-        private func updateCameraPosition(mapState: MapState) {
-            guard let camera = scene?.rootNode.childNode(withName: "camera", recursively: false) else { return }
+        /// Returns true if the camera moved
+        @discardableResult
+        private func updateCameraPosition(mapState: MapState) -> Bool {
+            guard let camera = scene?.rootNode.childNode(withName: "camera", recursively: false) else { return false }
 
             // Convert player position to SceneKit 3D position
             let targetPos = SCNVector3(
@@ -697,6 +762,7 @@ struct SceneKitMapView: UIViewRepresentable {
                 y: -Float(mapState.playerY) * tileSize + Float(mapState.height) * tileSize / 2,
                 z: camera.position.z  // Keep current Z
             )
+            guard lastPlayerX != mapState.playerX || lastPlayerY != mapState.playerY else { return false }
 
             if lastPlayerX == -1 {
                 // First update - snap to position
@@ -714,10 +780,13 @@ struct SceneKitMapView: UIViewRepresentable {
 
             lastPlayerX = mapState.playerX
             lastPlayerY = mapState.playerY
+            return true
         }
 
-        private func updatePlayerLight(mapState: MapState) {
-            guard let playerLight = scene?.rootNode.childNode(withName: "playerLight", recursively: false) else { return }
+        /// Returns true if the light moved
+        @discardableResult
+        private func updatePlayerLight(mapState: MapState) -> Bool {
+            guard let playerLight = scene?.rootNode.childNode(withName: "playerLight", recursively: false) else { return false }
 
             // Convert player position to SceneKit 3D position
             let targetPos = SCNVector3(
@@ -725,6 +794,7 @@ struct SceneKitMapView: UIViewRepresentable {
                 y: -Float(mapState.playerY) * tileSize + Float(mapState.height) * tileSize / 2,
                 z: playerLight.position.z  // Keep current Z
             )
+            guard playerLight.position.x != targetPos.x || playerLight.position.y != targetPos.y else { return false }
 
             SCNTransaction.begin()
             SCNTransaction.animationDuration = 0.15  // Match camera movement
@@ -732,6 +802,7 @@ struct SceneKitMapView: UIViewRepresentable {
             playerLight.position.x = targetPos.x
             playerLight.position.y = targetPos.y
             SCNTransaction.commit()
+            return true
         }
 
         private func clearTiles() {
@@ -741,6 +812,9 @@ struct SceneKitMapView: UIViewRepresentable {
                 }
             }
             tileNodes.removeAll()
+            tileKeys.removeAll()
+            atlas?.node.removeFromParentNode()
+            atlas = nil
 
             // CRITICAL FIX: Reset player tracking state for new games
             // RCA: MapUpdateCoordinator persists across game sessions in SwiftUI
@@ -810,7 +884,7 @@ struct SceneKitMapView: UIViewRepresentable {
                 // Commented out debug logging for performance
 
                 let extractStart = CFAbsoluteTimeGetCurrent()
-                if let coords = extractTileCoordinates(from: node) {
+                if let coords = extractTileCoordinates(from: hit) {
                     let extractEnd = CFAbsoluteTimeGetCurrent()
                     let timestamp = String(format: "%.3f", CACurrentMediaTime())
                     print("[\(timestamp)] [PERF] Extract coords took: \((extractEnd - extractStart) * 1000)ms")
@@ -832,7 +906,14 @@ struct SceneKitMapView: UIViewRepresentable {
         }
 
 
-        private func extractTileCoordinates(from node: SCNNode) -> (x: Int, y: Int)? {
+        private func extractTileCoordinates(from hit: SCNHitTestResult) -> (x: Int, y: Int)? {
+            let node = hit.node
+
+            // ATLAS: one node for the whole map - the cell comes from the hit point
+            if node.name == TileAtlasRenderer.nodeName, let atlas = mapUpdater?.atlas {
+                return atlas.cell(atLocal: hit.localCoordinates)
+            }
+
             // PRIMARY: Extract from node name (format: "tile_x_y") - most reliable
             if let name = node.name {
                 let parts = name.split(separator: "_")
@@ -0,0 +1,245 @@
+//
+//  TileAtlasRenderer.swift
+//  nethack
+//
+//  Whole map as one SceneKit mesh textured from a baked glyph atlas
+//
+
+import SceneKit
+import UIKit
+
+/// Draws the map as a single geometry instead of one SCNNode per tile.
+///
+/// The glyph atlas (printable ASCII in white, plus the pet badge) is baked
+/// once. Every cell owns a glyph quad and a badge quad at fixed positions;
+/// a cell change rewrites that cell's texture coordinates and vertex colour
+/// in the Swift-side arrays, and `commit()` hands SceneKit fresh sources.
+/// The material multiplies the white glyph by the vertex colour, so one
+/// material and one draw call cover the whole map.
+final class TileAtlasRenderer {
+    /// UserDefaults key switching SceneKitMapView to this renderer
+    static let enabledDefaultsKey = "render.tileAtlas"
+    static let nodeName = "tileAtlas"
+
+    static var isEnabled: Bool {
+        UserDefaults.standard.bool(forKey: enabledDefaultsKey)
+    }
+
+    // Atlas layout: 16 x 6 cells for ASCII 32...127, slot 127 (DEL) holds the pet badge
+    private static let atlasColumns = 16
+    private static let atlasRows = 6
+    private static let firstScalar: UInt32 = 32
+    private static let badgeSlot = 127 - 32
+    private static let fallbackSlot = Int(("?" as UnicodeScalar).value - 32)
+    private static let cellPixels: CGFloat = 64
+    private static let badgeFraction: Float = 18.0 / 64.0  // Heart size + margin in the node renderer
+
+    private static let atlasImage: UIImage = bakeAtlas()
+
+    let node = SCNNode()
+    private let material: SCNMaterial
+    private let tileSize: Float
+    private(set) var width = 0
+    private(set) var height = 0
+
+    private var vertexSource: SCNGeometrySource?
+    private var element: SCNGeometryElement?
+    private var texcoords: [Float] = []   // 2 per vertex
+    private var colors: [Float] = []      // 4 per vertex
+    private var changed = false
+
+    init(tileSize: Float) {
+        self.tileSize = tileSize
+
+        material = SCNMaterial()
+        material.lightingModel = .constant
+        material.isDoubleSided = true
+        material.diffuse.contents = Self.atlasImage
+        material.diffuse.minificationFilter = .linear
+        material.diffuse.magnificationFilter = .linear
+        material.diffuse.mipFilter = .linear
+        material.blendMode = .alpha
+        material.writesToDepthBuffer = false
+
+        node.name = Self.nodeName
+        node.categoryBitMask = 1  // Same hit-test layer as tile nodes
+    }
+
+    // MARK: - Grid
+
+    /// Lay out a blank grid; positions and indices stay fixed until the next resize
+    func resize(width: Int, height: Int) {
+        self.width = width
+        self.height = height
+
+        let cells = width * height
+        var positions = [Float]()
+        positions.reserveCapacity(cells * 2 * 4 * 3)
+        let originX = -Float(width) * tileSize / 2
+        let originY = Float(height) * tileSize / 2
+        let half = tileSize / 2
+        let badge = tileSize * Self.badgeFraction
+
+        // Glyph quads first, then badge quads, both in cell order
+        for y in 0..<height {
+            for x in 0..<width {
+                let cx = Float(x) * tileSize + originX
+                let cy = -Float(y) * tileSize + originY
+                appendQuad(&positions, left: cx - half, right: cx + half, bottom: cy - half, top: cy + half)
+            }
+        }
+        for y in 0..<height {
+            for x in 0..<width {
+                let cx = Float(x) * tileSize + originX
+                let cy = -Float(y) * tileSize + originY
+                appendQuad(&positions, left: cx + half - badge, right: cx + half,
+                           bottom: cy - half, top: cy - half + badge)
+            }
+        }
+
+        let quadCount = cells * 2
+        var indices = [UInt32]()
+        indices.reserveCapacity(quadCount * 6)
+        for quad in 0..<quadCount {
+            let base = UInt32(quad * 4)  // TL, TR, BL, BR
+            indices += [base + 2, base + 3, base + 1, base + 2, base + 1, base]
+        }
+
+        vertexSource = SCNGeometrySource(
+            data: positions.withUnsafeBytes { Data($0) },
+            semantic: .vertex, vectorCount: quadCount * 4,
+            usesFloatComponents: true, componentsPerVector: 3,
+            bytesPerComponent: MemoryLayout<Float>.size, dataOffset: 0,
+            dataStride: MemoryLayout<Float>.size * 3)
+        element = SCNGeometryElement(
+            data: indices.withUnsafeBytes { Data($0) },
+            primitiveType: .triangles, primitiveCount: quadCount * 2,
+            bytesPerIndex: MemoryLayout<UInt32>.size)
+
+        texcoords = Array(repeating: 0, count: quadCount * 4 * 2)
+        colors = Array(repeating: 0, count: quadCount * 4 * 4)  // Alpha 0: blank
+        changed = true
+    }
+
+    private func appendQuad(_ positions: inout [Float], left: Float, right: Float, bottom: Float, top: Float) {
+        positions += [left, top, 0, right, top, 0, left, bottom, 0, right, bottom, 0]
+    }
+
+    // MARK: - Cells
+
+    /// Show `tile` at (x, y); nil or blank space clears the cell
+    func setCell(x: Int, y: Int, tile: MapTile?) {
+        guard x >= 0, x < width, y >= 0, y < height else { return }
+        let cell = y * width + x
+        let badgeQuad = width * height + cell
+
+        guard let tile, tile.character != " " else {
+            setQuad(cell, slot: Self.fallbackSlot, color: nil)
+            setQuad(badgeQuad, slot: Self.badgeSlot, color: nil)
+            return
+        }
+
+        let scalar = tile.character.unicodeScalars.first?.value ?? 0
+        let slot = (Self.firstScalar..<127).contains(scalar) ? Int(scalar - Self.firstScalar) : Self.fallbackSlot
+        setQuad(cell, slot: slot, color: SceneKitMapView.MapUpdateCoordinator.tileColor(for: tile))
+        setQuad(badgeQuad, slot: Self.badgeSlot, color: tile.isPet ? GruvboxColors.green : nil)
+    }
+
+    private func setQuad(_ quad: Int, slot: Int, color: UIColor?) {
+        let column = slot % Self.atlasColumns
+        let row = slot / Self.atlasColumns
+        let u0 = Float(column) / Float(Self.atlasColumns)
+        let u1 = Float(column + 1) / Float(Self.atlasColumns)
+        let v0 = Float(row) / Float(Self.atlasRows)
+        let v1 = Float(row + 1) / Float(Self.atlasRows)
+
+        let uv = [u0, v0, u1, v0, u0, v1, u1, v1]
+        let t = quad * 8
+        for i in 0..<8 { texcoords[t + i] = uv[i] }
+
+        var r: CGFloat = 0, g: CGFloat = 0, b: CGFloat = 0, a: CGFloat = 0
+        color?.getRed(&r, green: &g, blue: &b, alpha: &a)
+        let c = quad * 16
+        for vertex in 0..<4 {
+            colors[c + vertex * 4 + 0] = Float(r)
+            colors[c + vertex * 4 + 1] = Float(g)
+            colors[c + vertex * 4 + 2] = Float(b)
+            colors[c + vertex * 4 + 3] = Float(a)
+        }
+        changed = true
+    }
+
+    // MARK: - Geometry
+
+    /// Rebuild the geometry from the attribute arrays if any cell changed
+    func commit() {
+        guard changed, let vertexSource, let element else { return }
+        changed = false
+
+        let vertexCount = width * height * 2 * 4
+        let texcoordSource = SCNGeometrySource(
+            data: texcoords.withUnsafeBytes { Data($0) },
+            semantic: .texcoord, vectorCount: vertexCount,
+            usesFloatComponents: true, componentsPerVector: 2,
+            bytesPerComponent: MemoryLayout<Float>.size, dataOffset: 0,
+            dataStride: MemoryLayout<Float>.size * 2)
+        let colorSource = SCNGeometrySource(
+            data: colors.withUnsafeBytes { Data($0) },
+            semantic: .color, vectorCount: vertexCount,
+            usesFloatComponents: true, componentsPerVector: 4,
+            bytesPerComponent: MemoryLayout<Float>.size, dataOffset: 0,
+            dataStride: MemoryLayout<Float>.size * 4)
+
+        let geometry = SCNGeometry(sources: [vertexSource, texcoordSource, colorSource], elements: [element])
+        geometry.materials = [material]
+        node.geometry = geometry
+    }
+
+    // MARK: - Hit Testing
+
+    /// Map cell under a hit in the atlas node's local space
+    func cell(atLocal point: SCNVector3) -> (x: Int, y: Int)? {
+        let x = Int(((point.x + Float(width) * tileSize / 2) / tileSize).rounded())
+        let y = Int(((-point.y + Float(height) * tileSize / 2) / tileSize).rounded())
+        guard x >= 0, x < width, y >= 0, y < height else { return nil }
+        return (x: x, y: y)
+    }
+
+    // MARK: - Atlas
+
+    private static func bakeAtlas() -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.opaque = false
+        format.scale = 1
+        let size = CGSize(width: cellPixels * CGFloat(atlasColumns), height: cellPixels * CGFloat(atlasRows))
+
+        return UIGraphicsImageRenderer(size: size, format: format).image { _ in
+            let glyphAttrs: [NSAttributedString.Key: Any] = [
+                .font: UIFont.monospacedSystemFont(ofSize: cellPixels * 0.7, weight: .medium),
+                .foregroundColor: UIColor.white
+            ]
+            for slot in 0..<(atlasColumns * atlasRows) {
+                let origin = CGPoint(x: CGFloat(slot % atlasColumns) * cellPixels,
+                                     y: CGFloat(slot / atlasColumns) * cellPixels)
+                let cellRect = CGRect(origin: origin, size: CGSize(width: cellPixels, height: cellPixels))
+
+                if slot == badgeSlot {
+                    let heartAttrs: [NSAttributedString.Key: Any] = [
+                        .font: UIFont.systemFont(ofSize: cellPixels * 0.75, weight: .bold),
+                        .foregroundColor: UIColor.white
+                    ]
+                    draw("♥", centeredIn: cellRect, attributes: heartAttrs)
+                } else if let scalar = UnicodeScalar(firstScalar + UInt32(slot)) {
+                    draw(String(Character(scalar)), centeredIn: cellRect, attributes: glyphAttrs)
+                }
+            }
+        }
+    }
+
+    private static func draw(_ text: String, centeredIn rect: CGRect, attributes: [NSAttributedString.Key: Any]) {
+        let textSize = text.size(withAttributes: attributes)
+        text.draw(in: CGRect(x: rect.midX - textSize.width / 2, y: rect.midY - textSize.height / 2,
+                             width: textSize.width, height: textSize.height),
+                  withAttributes: attributes)
+    }
+}
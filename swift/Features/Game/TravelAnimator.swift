@@ -0,0 +1,152 @@
+import Foundation
+import QuartzCore
+
+// =============================================================================
+// TravelAnimator - Display-Paced Travel/Run Animation
+// =============================================================================
+//
+// The engine runs travel at full speed and records the hero's path
+// (NetHackBridge+TravelSteps). By the time the map update arrives the tiles
+// already show the end state; this replays the hero marker along the path on
+// a CADisplayLink, so travel time is path length / animation speed on every
+// device, at up to 120Hz on ProMotion displays, with no game-thread sleeps.
+//
+// Tiles under the marker are restored from what the map showed when playback
+// started; finish() snaps to the real end state before the next queue drain.
+// =============================================================================
+
+@MainActor
+final class TravelAnimator: NSObject {
+
+    /// Steps per second; 0 turns the animation off (hero jumps to the end)
+    static let speedDefaultsKey = "travel.animationStepsPerSecond"
+    static let defaultStepsPerSecond: Double = 30
+
+    private weak var mapState: MapState?
+    private var path: [(x: Int, y: Int)] = []          // Swift coordinates, end excluded
+    private var savedTiles: [MapTile?] = []             // Map tile under each path position
+    private var heroTile: MapTile?
+    private var end: (x: Int, y: Int) = (0, 0)
+    private var endTile: MapTile?                       // Terrain at the end while the marker travels
+    private var index = 0
+    private var progress: Double = 0
+    private var stepsPerSecond: Double = TravelAnimator.defaultStepsPerSecond
+    private var displayLink: CADisplayLink?
+    private var lastTimestamp: CFTimeInterval = 0
+
+    var isAnimating: Bool { displayLink != nil }
+
+    // MARK: - Playback
+
+    /// Replay `steps` ending at the map's current hero position
+    func play(_ steps: [TravelStep], on mapState: MapState) {
+        finish()
+
+        let speed = UserDefaults.standard.object(forKey: Self.speedDefaultsKey) as? Double
+            ?? Self.defaultStepsPerSecond
+        guard speed > 0, steps.count > 1 else { return }
+
+        let end = (x: mapState.playerX, y: mapState.playerY)
+        guard let hero = mapState.tiles[safe: end.y]?[safe: end.x] ?? nil, hero.type == .player else { return }
+
+        // NetHack -> Swift coordinates, dropping repeats and the end square
+        var path: [(x: Int, y: Int)] = []
+        for step in steps {
+            guard let nh = CoordinateConverter.makeNetHack(x: step.x, y: step.y) else { continue }
+            let (x, y) = CoordinateConverter.nethackToSwift(nh).arrayIndices
+            guard x >= 0, x < mapState.width, y >= 0, y < mapState.height else { continue }
+            if let last = path.last, last == (x, y) { continue }
+            path.append((x, y))
+        }
+        while let last = path.last, last == end { path.removeLast() }
+        guard !path.isEmpty else { return }
+
+        self.mapState = mapState
+        self.path = path
+        self.end = end
+        self.heroTile = hero
+        self.endTile = mapState.underlyingTile
+        self.savedTiles = path.map { pos in
+            pos == end ? mapState.underlyingTile : (mapState.tiles[safe: pos.y]?[safe: pos.x] ?? nil)
+        }
+        self.stepsPerSecond = speed
+        self.index = 0
+        self.progress = 0
+
+        mapState.tiles[end.y][end.x] = endTile
+        mapState.markDirty(x: end.x, y: end.y)
+        placeHero(at: path[0])
+
+        let link = CADisplayLink(target: self, selector: #selector(tick(_:)))
+        link.preferredFrameRateRange = CAFrameRateRange(minimum: 30, maximum: 120, preferred: 120)
+        link.add(to: .main, forMode: .common)
+        lastTimestamp = 0
+        displayLink = link
+        mapState.isAnimatingTravel = true
+    }
+
+    /// Stop and put the map back in the engine's end state
+    func finish() {
+        displayLink?.invalidate()
+        displayLink = nil
+
+        guard let mapState, !path.isEmpty else { return }
+        if index < path.count {
+            restoreTile(at: index)
+        }
+        mapState.tiles[end.y][end.x] = heroTile
+        mapState.markDirty(x: end.x, y: end.y)
+        mapState.playerX = end.x
+        mapState.playerY = end.y
+        mapState.isAnimatingTravel = false
+        mapState.tileUpdateCounter += 1
+
+        path = []
+        savedTiles = []
+        heroTile = nil
+        endTile = nil
+        self.mapState = nil
+    }
+
+    @objc private func tick(_ link: CADisplayLink) {
+        if lastTimestamp == 0 {
+            lastTimestamp = link.timestamp
+        }
+        progress += (link.targetTimestamp - lastTimestamp) * stepsPerSecond
+        lastTimestamp = link.targetTimestamp
+
+        // One step per refresh at the default speed; several if the speed outruns the display
+        while progress >= 1 {
+            progress -= 1
+            restoreTile(at: index)
+            index += 1
+            guard index < path.count else {
+                finish()
+                return
+            }
+            placeHero(at: path[index])
+        }
+    }
+
+    // MARK: - Tiles
+
+    private func placeHero(at pos: (x: Int, y: Int)) {
+        guard let mapState, let hero = heroTile else { return }
+        mapState.tiles[pos.y][pos.x] = MapTile(
+            x: pos.x, y: pos.y, glyph: hero.glyph, character: hero.character,
+            foreground: hero.foreground, background: hero.background,
+            type: hero.type, glyphflags: hero.glyphflags
+        )
+        mapState.markDirty(x: pos.x, y: pos.y)
+        mapState.playerX = pos.x
+        mapState.playerY = pos.y
+        mapState.tileUpdateCounter += 1
+    }
+
+    private func restoreTile(at i: Int) {
+        guard let mapState, i < path.count else { return }
+        let pos = path[i]
+        mapState.tiles[pos.y][pos.x] = savedTiles[i]
+        mapState.markDirty(x: pos.x, y: pos.y)
+    }
+}
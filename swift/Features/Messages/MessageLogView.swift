@@ -76,6 +76,9 @@ struct MessageLogView: View {
                 .padding(.vertical, 8)
             }
             .onAppear {
+                // Pick up anything logged since the last refresh (new messages only)
+                historyManager.refresh()
+
                 // Auto-scroll to newest message (at bottom)
                 if let lastMessage = historyManager.messages.last {
                     proxy.scrollTo(lastMessage.id, anchor: .bottom)
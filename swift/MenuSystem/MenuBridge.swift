@@ -10,23 +10,11 @@ private let IOS_PICK_ANY: Int32 = 2
 private let IOS_MAX_MENU_ITEMS = 256
 private let IOS_MAX_MENU_TEXT = 256
 
-// MARK: - C Struct Offsets (from struct_size_test)
-
-// IOSMenuItem (276 bytes total)
-private let MENUITEM_SELECTOR_OFFSET = 0
-private let MENUITEM_GLYPH_OFFSET = 4
-private let MENUITEM_TEXT_OFFSET = 8
-private let MENUITEM_ATTRIBUTES_OFFSET = 264
-private let MENUITEM_IDENTIFIER_OFFSET = 268
-private let MENUITEM_ITEMFLAGS_OFFSET = 272
-private let MENUITEM_SIZE = 276
-
-// IOSMenuContext
-private let CONTEXT_HOW_OFFSET = 0
-private let CONTEXT_PROMPT_OFFSET = 4
-private let CONTEXT_ITEMCOUNT_OFFSET = 260
-private let CONTEXT_WINDOWID_OFFSET = 264
-private let CONTEXT_ITEMS_OFFSET = 268
+// MARK: - C Struct Offsets
+
+// IOSMenuContext: header, packed IOSMenuItem records, then the text arena
+private let CONTEXT_ITEMS_OFFSET = MemoryLayout<IOSMenuContext>.offset(of: \IOSMenuContext.items)!
+private let CONTEXT_TEXT_OFFSET = MemoryLayout<IOSMenuContext>.offset(of: \IOSMenuContext.text)!
 
 // MARK: - C Type Mirror for Selection Result
 
@@ -414,29 +402,31 @@ final class MenuBridge: ObservableObject {
     // MARK: - Parsing
     
     /// Parse IOSMenuContext from C pointer into Swift NHMenuContext
+    ///
+    /// The context is the C menu store itself: every item and string is
+    /// already in place, so the whole menu is read in this one crossing.
     private func parseContext(_ ptr: UnsafeRawPointer) -> NHMenuContext {
-        // Read header fields using known offsets
-        let how = ptr.load(fromByteOffset: CONTEXT_HOW_OFFSET, as: Int32.self)
-        
-        let promptPtr = ptr.advanced(by: CONTEXT_PROMPT_OFFSET).assumingMemoryBound(to: CChar.self)
-        let prompt = String(cString: promptPtr)
-        
-        let itemCount = Int(ptr.load(fromByteOffset: CONTEXT_ITEMCOUNT_OFFSET, as: Int32.self))
-        let windowId = Int(ptr.load(fromByteOffset: CONTEXT_WINDOWID_OFFSET, as: Int32.self))
-        
+        let ctx = ptr.assumingMemoryBound(to: IOSMenuContext.self)
+        let how = ctx.pointee.how
+        let prompt = withUnsafeBytes(of: ctx.pointee.prompt) { raw in
+            String(cString: raw.baseAddress!.assumingMemoryBound(to: CChar.self))
+        }
+        let itemCount = Int(ctx.pointee.item_count)
+        let windowId = Int(ctx.pointee.window_id)
+
         print("[MenuBridge] Parsing context: how=\(how), itemCount=\(itemCount), windowId=\(windowId)")
         print("[MenuBridge] Prompt: '\(prompt)'")
-        
-        // Parse items
+
+        // Parse items; text is referenced by offset into the arena
+        let records = (ptr + CONTEXT_ITEMS_OFFSET).assumingMemoryBound(to: IOSMenuItem.self)
+        let text = (ptr + CONTEXT_TEXT_OFFSET).assumingMemoryBound(to: CChar.self)
         var items: [NHMenuItem] = []
-        let itemsBasePtr = ptr.advanced(by: CONTEXT_ITEMS_OFFSET)
-        
+        items.reserveCapacity(min(itemCount, IOS_MAX_MENU_ITEMS))
+
         for i in 0..<min(itemCount, IOS_MAX_MENU_ITEMS) {
-            let itemPtr = itemsBasePtr.advanced(by: i * MENUITEM_SIZE)
-            let item = parseMenuItem(itemPtr, index: i)
-            items.append(item)
+            items.append(parseMenuItem(records[i], text: text, index: i))
         }
-        
+
         // Determine pick mode
         let pickMode: NHPickMode
         switch how {
@@ -445,7 +435,7 @@ final class MenuBridge: ObservableObject {
         case IOS_PICK_ANY: pickMode = .any
         default: pickMode = .one
         }
-        
+
         return NHMenuContext(
             windowID: windowId,
             prompt: prompt.isEmpty ? "Menu" : prompt,
@@ -453,29 +443,27 @@ final class MenuBridge: ObservableObject {
             items: items
         )
     }
-    
-    /// Parse single menu item from C pointer
-    private func parseMenuItem(_ ptr: UnsafeRawPointer, index: Int) -> NHMenuItem {
-        // Read fields using known offsets
-        let selectorByte = ptr.load(fromByteOffset: MENUITEM_SELECTOR_OFFSET, as: CChar.self)
+
+    /// Parse single menu item record
+    private func parseMenuItem(_ record: IOSMenuItem, text: UnsafePointer<CChar>, index: Int) -> NHMenuItem {
+        let selectorByte = record.selector
         let selector: Character? = selectorByte != 0 ? Character(UnicodeScalar(UInt8(bitPattern: selectorByte))) : nil
-        
-        let glyph = Int(ptr.load(fromByteOffset: MENUITEM_GLYPH_OFFSET, as: Int32.self))
-        
-        let textPtr = ptr.advanced(by: MENUITEM_TEXT_OFFSET).assumingMemoryBound(to: CChar.self)
-        let text = String(cString: textPtr)
-        
-        let attributes = MenuItemAttributes(rawValue: UInt32(ptr.load(fromByteOffset: MENUITEM_ATTRIBUTES_OFFSET, as: Int32.self)))
-        
+
+        let glyph = Int(record.glyph)
+
+        // Length is known, so no strlen over the arena
+        let bytes = UnsafeRawBufferPointer(start: text + Int(record.text_offset), count: Int(record.text_length))
+        let itemText = String(decoding: bytes, as: UTF8.self)
+
+        let attributes = MenuItemAttributes(rawValue: UInt32(bitPattern: record.attributes))
+
         // identifier and itemflags available but not used in Swift model currently
-        // let identifier = ptr.load(fromByteOffset: MENUITEM_IDENTIFIER_OFFSET, as: Int32.self)
-        // let itemflags = ptr.load(fromByteOffset: MENUITEM_ITEMFLAGS_OFFSET, as: UInt32.self)
-        
+
         return NHMenuItem(
             id: "\(index)",
             selector: selector,
             glyph: glyph != 0 ? glyph : nil,
-            text: text,
+            text: itemText,
             attributes: attributes
         )
     }
@@ -3,8 +3,10 @@ import Foundation
 // MARK: - Player Stats Structure
 // Extracted from NetHackBridge.swift for better organization
 
-/// Player statistics from the game engine
-struct PlayerStats: Codable {
+/// Player statistics from the game engine.
+/// Equatable so an unchanged status is not re-assigned (which would
+/// invalidate every HUD view reading it).
+struct PlayerStats: Codable, Equatable {
     let hp: Int
     let hpmax: Int
     let pw: Int
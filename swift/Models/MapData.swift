@@ -175,6 +175,15 @@ class MapState {
     // This counter increments on each tile update, triggering SwiftUI re-render
     var tileUpdateCounter: Int = 0
 
+    // TravelAnimator is replaying the hero along a path (tiles change every refresh)
+    var isAnimatingTravel = false
+
+    // Cells changed since the renderer last looked (y * width + x), fed by the
+    // render queue's coalesced glyph deltas. dirtyAll after a reset.
+    @ObservationIgnored private var dirtyCells: [Int] = []
+    @ObservationIgnored private var dirtyFlags: [Bool] = []
+    @ObservationIgnored private var dirtyAll = true
+
     // Current dungeon environment for visual theming
     var currentEnvironment: DungeonEnvironment = .standard
 
@@ -191,6 +200,28 @@ class MapState {
         remembered = Array(repeating: Array(repeating: nil, count: width), count: height)
         lightLevel = Array(repeating: Array(repeating: 0.0, count: width), count: height)
         underlyingTile = nil
+        dirtyCells.removeAll(keepingCapacity: true)
+        dirtyFlags = Array(repeating: false, count: width * height)
+        dirtyAll = true
+    }
+
+    /// Record that the tile at Swift (x, y) changed (renderer picks it up)
+    func markDirty(x: Int, y: Int) {
+        guard !dirtyAll, x >= 0, x < width, y >= 0, y < height else { return }
+        let index = y * width + x
+        if !dirtyFlags[index] {
+            dirtyFlags[index] = true
+            dirtyCells.append(index)
+        }
+    }
+
+    /// Cells changed since the last call (all: redraw everything)
+    func takeDirtyCells() -> (all: Bool, cells: [Int]) {
+        let result = (all: dirtyAll, cells: dirtyCells)
+        for index in dirtyCells { dirtyFlags[index] = false }
+        dirtyCells.removeAll(keepingCapacity: true)
+        dirtyAll = false
+        return result
     }
 
     /// Update tile at Swift coordinates (0-based)
@@ -200,13 +231,16 @@ class MapState {
     ///   - glyph: NetHack glyph ID
     ///   - character: ASCII character to display
     ///   - glyphflags: NetHack glyph flags (MG_PET, MG_RIDDEN etc.)
-    func updateTile(x: Int, y: Int, glyph: Int32, character: Character, glyphflags: UInt32 = 0) {
+    /// - Parameter tileType: Type from the C glyph table; falls back to the character
+    func updateTile(x: Int, y: Int, glyph: Int32, character: Character, glyphflags: UInt32 = 0,
+                    tileType: TileType? = nil) {
         guard x >= 0 && x < width && y >= 0 && y < height else {
             print("[MapData] ERROR: Tile coordinate [SW:\(x),\(y)] out of bounds (width:\(width), height:\(height))")
             return
         }
 
-        let type = TileType.fromCharacter(character)
+        // Hero glyph is a monster glyph in the table - '@' still marks the player
+        let type = character == "@" ? .player : (tileType ?? TileType.fromCharacter(character))
         let foreground = colorForTileType(type)
         let background = MapColor.black
 
@@ -242,6 +276,7 @@ class MapState {
             // FIX: Force @Observable notification for nested array mutation
             // Without this, SwiftUI doesn't know tiles changed (subscript mutation not detected)
             tileUpdateCounter += 1
+            markDirty(x: x, y: y)
         }
     }
 
@@ -364,28 +399,21 @@ class MapState {
     /// This is called from the notification handler when ios_notify_map_changed() is triggered
     /// - Returns: Updated PlayerStats if status update was received, nil otherwise
     func consumeRenderQueue(from bridge: NetHackBridge) -> PlayerStats? {
-        let updates = bridge.consumeRenderQueue()
-
-        guard !updates.isEmpty else {
-            return nil
-        }
-
-        print("[MapData] Processing \(updates.count) render queue updates")
-
         var updatedStats: PlayerStats? = nil
 
-        for (type, data) in updates {
-            switch type {
-            case .updateGlyph:
-                guard let update = data as? NetHackBridge.MapUpdateData else {
-                    continue
-                }
+        let drainStart = DispatchTime.now().uptimeNanoseconds
+        defer {
+            bridge.recordFrameTiming(FRAME_STAGE_DRAIN, nanoseconds: DispatchTime.now().uptimeNanoseconds - drainStart)
+        }
 
+        let processed = bridge.drainRenderQueue { event in
+            switch event {
+            case .glyph(let update):
                 // Convert NetHack coordinates from render queue to Swift coordinates
                 // Uses single source of truth: CoordinateConverter
                 guard let swiftCoord = CoordinateConverter.fromRenderUpdate(x: Int32(update.x), y: Int32(update.y)) else {
                     print("[MapData] ERROR: Queue update out of bounds - NH(\(update.x),\(update.y))")
-                    continue
+                    return
                 }
 
                 let (swiftX, swiftY) = swiftCoord.arrayIndices
@@ -394,29 +422,18 @@ class MapState {
                 let character = Character(UnicodeScalar(UInt8(bitPattern: update.ch)))
 
                 // Update tile with glyph flags (pet, ridden, detected etc.)
-                updateTile(x: swiftX, y: swiftY, glyph: update.glyph, character: character, glyphflags: update.glyphflags)
+                updateTile(x: swiftX, y: swiftY, glyph: update.glyph, character: character,
+                           glyphflags: update.glyphflags, tileType: bridge.tileType(forGlyph: update.glyph))
 
-            case .updateMessage:
-                guard let messageData = data as? NetHackBridge.MessageUpdateData else {
-                    continue
-                }
-                // Message text and category are strdup'd in C - we must free them after use
-                let text = String(cString: messageData.text)
-                let category = String(cString: messageData.category)
+            case .message(let messageData):
+                // Text was copied out of the queue's arena - nothing to free
+                let text = messageData.text
 
                 // Add to message history
                 messages.append(text)
-                print("[MapData] Message [\(category)]: \(text)")
-
-                // Free C strings
-                free(messageData.text)
-                free(messageData.category)
-
-            case .updateStatus:
-                guard let statusData = data as? NetHackBridge.StatusUpdateData else {
-                    continue
-                }
+                print("[MapData] Message [\(messageData.category)]: \(text)")
 
+            case .status(let statusData):
                 // Convert align tuple to String
                 let alignBytes = [statusData.align.0, statusData.align.1, statusData.align.2, statusData.align.3,
                                 statusData.align.4, statusData.align.5, statusData.align.6, statusData.align.7,
@@ -451,13 +468,13 @@ class MapState {
                     hunger: Int(statusData.hunger),
                     conditions: statusData.conditions
                 )
-                print("[MapData] ✅ Status updated: HP=\(statusData.hp)/\(statusData.hpmax) Turn=\(statusData.moves)")
+                print("[MapData] ✅ Status updated: HP=\(statusData.hp)/\(statusData.hpmax) Turn=\(statusData.moves) changed=0x\(String(statusData.changed, radix: 16))")
 
-            case .cmdFlushMap:
+            case .flushMap:
                 // @Observable handles updates automatically
                 break
 
-            case .cmdClearMap:
+            case .clearMap:
                 // Clear ALL map data on level change - not just tiles!
                 // This fixes ghost tile bug where stairs from previous level remained visible
                 reset(width: width, height: height)
@@ -470,19 +487,18 @@ class MapState {
                 tileUpdateCounter += 1  // Force SwiftUI re-render
                 print("[MapData] Map fully reset via queue (tiles, remembered, visibility)")
 
-            case .cmdTurnComplete:
-                if let turnNum = data as? Int {
-                    print("[MapData] Turn \(turnNum) complete")
-                }
+            case .turnComplete(let turnNum):
+                print("[MapData] Turn \(turnNum) complete")
                 // Update visibility after turn completes
                 updateVisibilityAroundPlayer()
-
-            default:
-                break
             }
         }
 
-        print("[MapData] Render queue consumption complete")
+        guard processed > 0 else {
+            return nil
+        }
+
+        print("[MapData] Render queue consumption complete (\(processed) updates)")
         return updatedStats
     }
 
@@ -18,32 +18,38 @@ final class DungeonOverviewService: ObservableObject {
 
     // MARK: - Public API
 
+    /// Overview generation the published levels belong to (nil = never fetched)
+    private var generation: UInt32?
+
     /// Refresh dungeon overview from NetHack bridge
-    /// Call this when opening dungeon overview or after level change
+    /// Call this when opening dungeon overview or after level change.
+    /// The game thread keeps the records current (ios_dungeon_overview.h), so
+    /// this is one generation check, and one packed copy when it moved.
+    /// The refresh call first recalcs state no glyph shows (quest, shops, bones).
     func refreshOverview() {
-        // First refresh the data in C
         ios_refresh_dungeon_overview()
+        let current = ios_dungeon_overview_generation()
+        guard current != generation else { return }
 
-        let count = Int(ios_get_visited_level_count())
+        let count = Int(ios_dungeon_overview_count())
         guard count > 0 else {
             levels = []
             groups = []
+            generation = current
             lastUpdate = Date()
             return
         }
 
-        // Fetch all levels
-        var fetchedLevels: [DungeonLevel] = []
-        for i in 0..<count {
-            // Use the C struct type directly (DungeonLevelInfo from RealNetHackBridge.h)
-            var cInfo = DungeonLevelInfo()
-            guard ios_get_dungeon_level_info(Int32(i), &cInfo) else { continue }
-
-            let level = convertToDungeonLevel(cInfo)
-            fetchedLevels.append(level)
+        // All records in one copy (room for a level added since the count)
+        var records = [DungeonLevelInfo](repeating: DungeonLevelInfo(), count: count + 8)
+        var copied: UInt32 = 0
+        let fetched = records.withUnsafeMutableBufferPointer { buffer in
+            Int(ios_dungeon_overview_copy(buffer.baseAddress, Int32(buffer.count), &copied))
         }
+        let fetchedLevels = records.prefix(fetched).map(convertToDungeonLevel)
 
         levels = fetchedLevels
+        generation = copied
 
         // Group by dungeon
         let grouped = Dictionary(grouping: fetchedLevels) { $0.dungeonNumber }
@@ -55,7 +61,7 @@ final class DungeonOverviewService: ObservableObject {
         }.sorted { $0.id < $1.id }
 
         lastUpdate = Date()
-        print("[DungeonOverviewService] Refreshed \(levels.count) levels in \(groups.count) dungeons")
+        print("[DungeonOverviewService] Refreshed \(levels.count) levels in \(groups.count) dungeons (generation \(copied))")
     }
 
     /// Get current level info
@@ -224,6 +224,8 @@ final class GameOverlayManager: ObservableObject {
     // PERF: Debounce inventory updates - multiple notifications can fire per action
     private var lastInventoryUpdate: CFTimeInterval = 0
     private let inventoryDebounceInterval: CFTimeInterval = 0.1  // 100ms
+    /// Generation of the C inventory cache `items` was built from (0 = none)
+    private var inventoryCacheGeneration: UInt32 = 0
 
     init() {
         // Subscribe to hand selection notification from C bridge
@@ -463,11 +465,8 @@ final class GameOverlayManager: ObservableObject {
         // Send "#" to trigger extended command mode, then "loot\n"
         // ESC is NOT correct here - '#' triggers doextcmd() then ios_get_ext_cmd reads name
         print("[LOOT_OPTIONS] Queuing '#' + 'loot' + newline")
-        ios_queue_input(Int8(Character("#").asciiValue!))  // '#' - triggers extended command
-        for char in "loot" {
-            ios_queue_input(Int8(char.asciiValue!))
-        }
-        ios_queue_input(Int8(Character("\n").asciiValue!))  // newline - end of command
+        // One batch: '#' triggers extended command, newline ends it
+        sendCommandKeys("#loot\n")
         print("[LOOT_OPTIONS] Sent command sequence: #loot (native mode)")
         print("[LOOT_OPTIONS] ==============================")
     }
@@ -639,13 +638,8 @@ final class GameOverlayManager: ObservableObject {
         // User confirmed escape - send the climb up command to NetHack
         // The "<" command will trigger y_n("Beware, there will be no return! Still climb?")
         // We must also send 'y' to confirm that prompt!
-        let lessThan = Int8(Character("<").asciiValue!)
-        let yChar = Int8(Character("y").asciiValue!)
-        print("[ESCAPE_WARNING] 🚨 About to queue '<' (0x\(String(format: "%02x", UInt8(bitPattern: lessThan)))) and 'y' (0x\(String(format: "%02x", UInt8(bitPattern: yChar))))")
-        ios_queue_input(lessThan)
-        print("[ESCAPE_WARNING] ✓ Queued '<'")
-        ios_queue_input(yChar)
-        print("[ESCAPE_WARNING] ✓ Queued 'y' - Both commands sent to NetHack")
+        sendCommandKeys("<y")
+        print("[ESCAPE_WARNING] ✓ Queued '<' + 'y' - Both commands sent to NetHack")
     }
 
     // MARK: - Text Input (for getlin() actions)
@@ -669,12 +663,8 @@ final class GameOverlayManager: ObservableObject {
             showTextInput = false
         }
 
-        // Queue text to NetHack character by character, then newline
-        for char in text {
-            guard let ascii = char.asciiValue else { continue }
-            ios_queue_input(Int8(ascii))
-        }
-        ios_queue_input(Int8(Character("\n").asciiValue!))
+        // Queue text plus newline to NetHack as one batch (ASCII only)
+        _ = ios_queue_input_string(String(text.filter { $0.isASCII }) + "\n")
 
         print("[TEXT_INPUT] Queued text '\(text)' + newline to NetHack")
 
@@ -762,6 +752,7 @@ final class GameOverlayManager: ObservableObject {
         guard NetHackBridge.shared.gameStarted else {
             print("[INVENTORY] ⚠️ Game not running - skipping inventory update")
             items = []
+            inventoryCacheGeneration = 0
             return
         }
 
@@ -772,24 +763,26 @@ final class GameOverlayManager: ObservableObject {
         }
         lastInventoryUpdate = now
 
-        let count = Int(nethack_get_inventory_count())
-        guard count > 0 else {
-            items = []
+        // Turn-boundary read model: no serial queue hop, names already built
+        if let model = NetHackBridge.shared.readModel(), model.inventoryVersion > 0 {
+            items = model.inventory
             return
         }
 
-        // Allocate array for C inventory items
-        var cItems = Array(repeating: InventoryItem(), count: count)
-        let actualCount = Int(nethack_get_inventory_items(&cItems, Int32(count)))
-
-        defer {
-            // CRITICAL: Free allocated C strings
-            nethack_free_inventory_items(&cItems, Int32(actualCount))
+        // Inventory cache: a copy only when its generation moved, no per-name frees
+        let cache = UnsafeMutablePointer<InventoryCache>.allocate(capacity: 1)  // ~18KB
+        defer { cache.deallocate() }
+        guard ios_get_inventory_cache_if_newer(cache, &inventoryCacheGeneration) else {
+            return  // Unchanged since last update
         }
 
-        // Convert C items to Swift NetHackItem
-        items = (0..<actualCount).map { i in
-            let cItem = cItems[i]
+        let base = UnsafeRawPointer(cache)
+        let names = (base + MemoryLayout<InventoryCache>.offset(of: \.names)!).assumingMemoryBound(to: CChar.self)
+        let records = (base + MemoryLayout<InventoryCache>.offset(of: \.records)!).assumingMemoryBound(to: InventoryCacheRecord.self)
+
+        // Convert C records to Swift NetHackItem
+        items = (0..<Int(cache.pointee.count)).map { i in
+            let cItem = records[i]
 
             // Convert BUC status
             let bucStatus: ItemBUCStatus
@@ -803,12 +796,12 @@ final class GameOverlayManager: ObservableObject {
             // Convert object class to category
             let category = ItemCategory.fromOclass(cItem.oclass)
 
-            // Get item name (already allocated by C bridge)
-            let nameStr = String(cString: cItem.name, encoding: .utf8) ?? ""
+            // Item name lives in the cache's string pool
+            let nameStr = String(cString: names + Int(cItem.name_offset))
 
             // Create NetHackItem (use default init with only essential params)
             var item = NetHackItem(
-                invlet: Character(UnicodeScalar(UInt8(cItem.invlet))),
+                invlet: Character(UnicodeScalar(UInt8(bitPattern: cItem.invlet))),
                 name: nameStr,
                 fullName: nameStr,
                 category: category,
@@ -818,6 +811,7 @@ final class GameOverlayManager: ObservableObject {
             item.bucStatus = bucStatus
             item.bucKnown = cItem.buc_known  // Only show BUC if player knows it!
             item.enchantment = Int(cItem.enchantment)
+            item.weight = Int(cItem.weight)
 
             // Parse equipment status from C struct
             item.properties.isWorn = cItem.is_equipped
@@ -847,6 +841,7 @@ final class GameOverlayManager: ObservableObject {
         activeOverlay = .none
         showAsPanel = false
         items = []
+        inventoryCacheGeneration = 0
         draggedItem = nil
         isDraggingToHotbar = false
         showItemSelection = false
@@ -1007,13 +1002,12 @@ final class GameOverlayManager: ObservableObject {
             // NetHack expects: t<item><direction> or z<item><direction>
             print("[ACTION_DIRECTION] Item+Direction flow: '\(pendingCommand)\(pendingItem)\(direction)'")
 
-            for char in pendingCommand {
-                if let ascii = char.asciiValue {
-                    ios_queue_input(Int8(ascii))
-                }
+            let keys = "\(pendingCommand)\(pendingItem)\(direction)"
+            if let macroAction = Self.macroAction(for: pendingCommand), let delta = Self.directionDelta(direction) {
+                sendCommand(.action(macroAction, dx: delta.dx, dy: delta.dy, item: pendingItem), fallback: keys)
+            } else {
+                sendCommandKeys(keys)
             }
-            ios_queue_input(Int8(pendingItem.asciiValue!))
-            ios_queue_input(Int8(direction.asciiValue!))
 
             // Clear pending state
             pendingItemForDirection = nil
@@ -1022,43 +1016,14 @@ final class GameOverlayManager: ObservableObject {
         }
 
         // Regular direction flow (kick, open, close, etc.)
-        // Build command string based on prefix type
-        if command.hasPrefix("#") {
-                // Extended command: # + name + \n + direction
-                let extCmd = String(command.dropFirst())
-                ios_queue_input(Int8(Character("#").asciiValue!))
-                for char in extCmd {
-                    if let ascii = char.asciiValue {
-                        ios_queue_input(Int8(ascii))
-                    }
-                }
-                ios_queue_input(Int8(Character("\n").asciiValue!))
-                ios_queue_input(Int8(direction.asciiValue!))
-            } else if command.hasPrefix("M-") {
-                // Meta command: ESC + char + direction
-                let cmd = String(command.dropFirst(2))
-                ios_queue_input(0x1b) // ESC
-                if let cmdChar = cmd.first, let ascii = cmdChar.asciiValue {
-                    ios_queue_input(Int8(ascii))
-                }
-                ios_queue_input(Int8(direction.asciiValue!))
-            } else if command.hasPrefix("C-") {
-                // Control command: control char + direction
-                let cmd = String(command.dropFirst(2))
-                if let char = cmd.first, let asciiValue = char.asciiValue {
-                    let controlChar = Int8(Int(asciiValue) - 96)
-                    ios_queue_input(controlChar)
-                }
-                ios_queue_input(Int8(direction.asciiValue!))
-            } else {
-                // Regular command: command + direction
-                for char in command {
-                    if let ascii = char.asciiValue {
-                        ios_queue_input(Int8(ascii))
-                    }
-                }
-                ios_queue_input(Int8(direction.asciiValue!))
-            }
+        // Registry actions go through the macro runner, which resolves the
+        // command key and direction key in the game's own key bindings
+        if let macroAction = Self.macroAction(for: command), let delta = Self.directionDelta(direction) {
+            sendCommand(.action(macroAction, dx: delta.dx, dy: delta.dy),
+                        fallback: Self.commandKeys(command) + String(direction))
+        } else {
+            sendCommandKeys(Self.commandKeys(command) + String(direction))
+        }
 
         print("[ACTION_DIRECTION] Sent command '\(command)' with direction '\(direction)'")
 
@@ -1068,6 +1033,66 @@ final class GameOverlayManager: ObservableObject {
         }
     }
 
+    /// Keys that start command (an NetHackAction.command) at a fresh prompt
+    private static func commandKeys(_ command: String) -> String {
+        if command.hasPrefix("#") {
+            // Extended command: # + name + \n
+            return "\(command)\n"
+        } else if command.hasPrefix("M-") {
+            // Meta command: ESC + char
+            return "\u{1b}" + String(command.dropFirst(2).prefix(1))
+        } else if command.hasPrefix("C-") {
+            // Control keys are the low 5 bits (C-a = 0x01); works for either case
+            var keys = ""
+            if let char = command.dropFirst(2).first, let asciiValue = char.asciiValue, char.isLetter {
+                keys.unicodeScalars.append(Unicode.Scalar(asciiValue & 0x1f))
+            }
+            return keys
+        }
+        return command
+    }
+
+    /// The registry action behind a directional command, if it has one
+    private static func macroAction(for command: String) -> NetHackBridge.MacroAction? {
+        switch command {
+        case "C-d": return .kick
+        case "o": return .open
+        case "c": return .close
+        case "f": return .fire
+        case "t": return .throw
+        default: return nil
+        }
+    }
+
+    /// (dx, dy) for a direction picker key: number pad digits or vi-keys
+    private static func directionDelta(_ direction: Character) -> (dx: Int, dy: Int)? {
+        switch direction {
+        case "7", "y": return (-1, -1)
+        case "8", "k": return (0, -1)
+        case "9", "u": return (1, -1)
+        case "4", "h": return (-1, 0)
+        case "6", "l": return (1, 0)
+        case "1", "b": return (-1, 1)
+        case "2", "j": return (0, 1)
+        case "3", "n": return (1, 1)
+        default: return nil   // '.', '<', '>' stay plain keys
+        }
+    }
+
+    /// Send one command as a one-step macro, so answers it never asks for
+    /// are dropped instead of running as commands. Plain keys when no macro
+    /// can start (another is running, or the bridge is not up).
+    private func sendCommand(_ step: NetHackBridge.MacroStep, fallback keys: String) {
+        // A single command the player asked for runs even with a hostile adjacent
+        if NetHackBridge.shared.runActionMacro([step], stopOnHostile: false) == nil {
+            _ = ios_queue_input_string(keys)
+        }
+    }
+
+    private func sendCommandKeys(_ keys: String) {
+        sendCommand(.keys(keys), fallback: keys)
+    }
+
     /// Cancel action direction selection
     func cancelActionDirection() {
         withAnimation(.spring(duration: 0.2, bounce: 0.05)) {
@@ -0,0 +1,55 @@
+//
+//  MemoryPressureMonitor.swift
+//  nethack
+//
+//  Sheds caches when iOS asks for memory back
+//
+
+import Foundation
+import UIKit
+
+/// Listens for memory warnings and releases what can be rebuilt.
+///
+/// Two sources: the dispatch memory-pressure source (warning and critical
+/// tiers) and `didReceiveMemoryWarningNotification` (treated as critical,
+/// it usually arrives right before jetsam). Each event purges the Swift
+/// caches (glyph tile geometry) and forwards the level to the C side,
+/// which trims the heap and the Lua pool (see ios_memory_pressure.h).
+final class MemoryPressureMonitor {
+    static let shared = MemoryPressureMonitor()
+
+    private var source: DispatchSourceMemoryPressure?
+    private var warningObserver: NSObjectProtocol?
+
+    private(set) var events = 0
+
+    private init() {}
+
+    /// Start listening (idempotent; call once at launch)
+    func start() {
+        guard source == nil else { return }
+
+        let source = DispatchSource.makeMemoryPressureSource(eventMask: [.warning, .critical], queue: .main)
+        source.setEventHandler { [weak self, weak source] in
+            guard let event = source?.data else { return }
+            self?.handle(event.contains(.critical) ? .critical : .warning)
+        }
+        source.resume()
+        self.source = source
+
+        warningObserver = NotificationCenter.default.addObserver(
+            forName: UIApplication.didReceiveMemoryWarningNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            self?.handle(.critical)
+        }
+    }
+
+    private func handle(_ level: NetHackBridge.MemoryPressureLevel) {
+        events += 1
+        print("[MemoryPressure] Level \(level) - purging caches")
+        GlyphTileCache.shared.purge()
+        NetHackBridge.shared.notifyMemoryPressure(level: level)
+    }
+}
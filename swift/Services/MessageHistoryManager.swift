@@ -5,6 +5,8 @@ import Combine
 
 /// Singleton manager for storing game message history.
 /// Persists messages across view updates for fullscreen log display.
+/// Pulls from the C message log by sequence id, so a refresh only costs the messages
+/// logged since the last one.
 @MainActor
 final class MessageHistoryManager: ObservableObject {
     static let shared = MessageHistoryManager()
@@ -13,10 +15,37 @@ final class MessageHistoryManager: ObservableObject {
 
     private let maxMessages = 500
 
+    /// Sequence id of the newest C log message already in `messages`
+    private var lastSeq: UInt64 = 0
+
     private init() {}
 
     // MARK: - Public API
 
+    /// Append messages logged in C since the last refresh
+    func refresh() {
+        let bridge = NetHackBridge.shared
+        if bridge.messageLogLastSeq() < lastSeq {
+            lastSeq = 0  // Dylib reloaded: its sequence ids restarted
+        }
+
+        let entries = bridge.fetchMessages(since: lastSeq)
+        guard let newest = entries.last else { return }
+        lastSeq = newest.seq
+
+        for entry in entries.suffix(maxMessages) {
+            messages.append(GameMessage(
+                text: entry.text,
+                turnNumber: entry.turn,
+                attributes: GameMessage.MessageAttributes(fromBitmask: entry.attr),
+                category: entry.category
+            ))
+        }
+        if messages.count > maxMessages {
+            messages.removeFirst(messages.count - maxMessages)
+        }
+    }
+
     func addMessage(_ message: GameMessage) {
         messages.append(message)
 
@@ -46,6 +46,10 @@ final class NetHackGameManager {
     // Set by NetHackGameView during initialization
     weak var overlayManager: GameOverlayManager?
 
+    // Replays travel/run paths at display rate (engine no longer sleeps per step)
+    @ObservationIgnored private let travelAnimator = TravelAnimator()
+    @ObservationIgnored private var travelStepsDropped: UInt32 = 0
+
     private let bridge = NetHackBridge.shared  // ✅ USE SINGLETON!
     private let memoryManager = NetHackMemoryManager.shared
     private let saveLoadCoordinator = SimplifiedSaveLoadCoordinator.shared
@@ -234,11 +238,17 @@ final class NetHackGameManager {
         // PHASE 2 MIGRATION: Consume render queue instead of parsing ASCII map
         // Bug #4/#8 Fix: Consume callback for status updates
         let oldStats = self.playerStats  // Store for feedback detection
+        // Queue deltas apply to the real map, not a travel animation in progress
+        travelAnimator.finish()
+        // The queue only carries a status when a field changed; assigning an
+        // equal value would still invalidate every HUD view
         if let updatedStats = self.mapState.consumeRenderQueue(from: self.bridge) {
-            self.playerStats = updatedStats
-            // Trigger feedback based on state change
-            FeedbackEngine.shared.processStateChange(old: oldStats, new: updatedStats)
-        } else {
+            if updatedStats != oldStats {
+                self.playerStats = updatedStats
+                // Trigger feedback based on state change
+                FeedbackEngine.shared.processStateChange(old: oldStats, new: updatedStats)
+            }
+        } else if newPlayerStats != oldStats {
             // Fallback: Use polling if no status update in queue
             self.playerStats = newPlayerStats
             // Trigger feedback for fallback path too
@@ -261,6 +271,15 @@ final class NetHackGameManager {
             self.mapState.updateUnderlyingTile(terrainChar)
         }
 
+        // Animate the hero along this update's travel/run path (none: no-op).
+        // If the engine had to drop steps the path has gaps - jump instead.
+        let steps = bridge.drainTravelSteps()
+        let dropped = bridge.travelStepsDropped()
+        if dropped == travelStepsDropped {
+            travelAnimator.play(steps, on: mapState)
+        }
+        travelStepsDropped = dropped
+
         // turnCount now comes from playerStats.moves
         self.turnCount = newPlayerStats?.moves ?? 0
 
@@ -19,13 +19,39 @@ import Foundation
         // Call C function to get stats
         nethack_zone_stats(&bytesAllocated, &numAllocations)
 
+        let detail = allocatorStats()
+
         return [
             "bytesAllocated": bytesAllocated,
             "numAllocations": numAllocations,
-            "formattedSize": formatBytes(bytesAllocated)
+            "formattedSize": formatBytes(bytesAllocated),
+            "liveBytes": detail.live_bytes,
+            "peakLiveBytes": detail.peak_live_bytes,
+            "peakUsedBytes": detail.peak_used_bytes,
+            "freeBlocks": detail.free_blocks,
+            "largestFreeBlock": detail.largest_free_block,
+            "fragmentation": detail.fragmentation
         ]
     }
 
+    /// Detailed allocator statistics (size classes, free space, peaks, phases)
+    /// Cheap enough to poll every few seconds.
+    func allocatorStats() -> NhAllocStats {
+        var stats = NhAllocStats()
+        nethack_zone_get_stats(&stats)
+        return stats
+    }
+
+    /// Live block counts per size class (class i: 2^(i+4) ..< 2^(i+5) bytes)
+    func sizeClassHistogram(_ stats: NhAllocStats) -> [UInt32] {
+        withUnsafeBytes(of: stats.size_class_live) { Array($0.bindMemory(to: UInt32.self)) }
+    }
+
+    /// Per-phase counters, indexed by ZoneType (0 = character creation, 1 = game)
+    func phaseStats(_ stats: NhAllocStats) -> [NhAllocPhaseStats] {
+        withUnsafeBytes(of: stats.phases) { Array($0.bindMemory(to: NhAllocPhaseStats.self)) }
+    }
+
     /// Print detailed memory statistics to console
     @objc func printMemoryStats() {
         nethack_zone_print_stats()
@@ -82,12 +108,17 @@ import Foundation
     @objc func monitorMemory() {
         guard showMemoryDebugInfo else { return }
 
-        let stats = getMemoryStats()
-        let allocations = stats["numAllocations"] as? size_t ?? 0
+        let stats = allocatorStats()
 
         // Warn if memory usage seems excessive
-        if allocations > 100000 {
-            print("⚠️ High memory allocation count: \(allocations)")
+        if stats.live_allocations > 100000 {
+            print("⚠️ High memory allocation count: \(stats.live_allocations)")
+        }
+        if stats.capacity > 0 && stats.used_bytes > stats.capacity / 10 * 9 {
+            print("⚠️ Heap nearly full: \(formatBytes(stats.used_bytes)) of \(formatBytes(stats.capacity))")
+        }
+        if stats.free_bytes > 8 * 1024 * 1024 && stats.fragmentation > 0.8 {
+            print("⚠️ Heap fragmented: \(formatBytes(stats.free_bytes)) free, largest hole \(formatBytes(stats.largest_free_block))")
         }
     }
 
@@ -100,6 +131,28 @@ import Foundation
         report += "Total Size: \(stats["formattedSize"] ?? "0 bytes")\n"
         report += "Zone System: Active\n"
 
+        let detail = allocatorStats()
+        report += "Used: \(formatBytes(detail.used_bytes)) (peak \(formatBytes(detail.peak_used_bytes)))\n"
+        report += "Live: \(formatBytes(detail.live_bytes)) (peak \(formatBytes(detail.peak_live_bytes)))\n"
+        report += "Free: \(formatBytes(detail.free_bytes)) in \(detail.free_blocks) blocks, "
+        report += "largest \(formatBytes(detail.largest_free_block))\n"
+        report += String(format: "Fragmentation: %.1f%%\n", detail.fragmentation * 100)
+        if detail.arena_chunks > 0 {
+            report += "Level arena: \(detail.arena_chunks) chunks, \(formatBytes(detail.arena_bytes))\n"
+        }
+
+        let classes = sizeClassHistogram(detail)
+        for (index, count) in classes.enumerated() where count > 0 {
+            let low = index == 0 ? 0 : 1 << (index + 4)
+            report += "  \(low)B+: \(count)\n"
+        }
+
+        let phaseNames = ["Character creation", "Game"]
+        for (index, phase) in phaseStats(detail).enumerated() where phase.alloc_calls > 0 {
+            report += "\(phaseNames[index]): \(phase.alloc_calls) allocs, \(phase.free_calls) frees, "
+            report += "\(formatBytes(size_t(phase.bytes_requested))) requested, peak \(formatBytes(phase.peak_live_bytes))\n"
+        }
+
         #if DEBUG
         report += "Debug Mode: Enabled\n"
         #else
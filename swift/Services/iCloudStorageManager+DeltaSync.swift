@@ -0,0 +1,220 @@
+import Foundation
+
+// =============================================================================
+// iCloudStorageManager+DeltaSync - Upload and Download Changed Files Only
+// =============================================================================
+//
+// A late-game character directory is mostly level chunks that did not change
+// since the last save. Instead of replacing the whole directory, both
+// directions diff an iCloudSyncManifest against the other side and move only
+// the files whose hash differs. The cloud manifest is written last on upload
+// and checked first on download, so it is the unit of atomic commit.
+// =============================================================================
+
+extension iCloudStorageManager {
+
+    // MARK: - Upload
+
+    /// Upload the files of `localURL` that differ from the cloud manifest of
+    /// `cloudURL` (an existing cloud character directory), then commit the
+    /// new manifest and remove cloud files it no longer lists.
+    func uploadChanges(from localURL: URL, manifest local: iCloudSyncManifest, to cloudURL: URL) async throws {
+        let manifestURL = cloudURL.appendingPathComponent(iCloudSyncManifest.fileName)
+        if cloudFileExists(manifestURL) {
+            try? await waitForCloudFile(manifestURL)  // Last written by another device
+        }
+        let remote = coordinatedRead(manifestURL, { iCloudSyncManifest.read(from: $0) }) ?? legacyManifest(of: cloudURL)
+
+        let changed = local.changedPaths(since: remote)
+        let removed = local.removedPaths(since: remote)
+        let bytes = changed.reduce(Int64(0)) { $0 + (local.files[$1]?.size ?? 0) }
+        print("[iCloud] Δ upload: \(changed.count)/\(local.files.count) files changed (\(bytes) bytes), \(removed.count) removed")
+
+        let stagingRoot = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: stagingRoot, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: stagingRoot) }
+
+        // 1. Data files the new manifest will reference
+        for (index, path) in changed.enumerated() {
+            let staged = stagingRoot.appendingPathComponent(UUID().uuidString)
+            try FileManager.default.copyItem(at: localURL.appendingPathComponent(path), to: staged)
+            try placeInCloud(staged, at: cloudURL.appendingPathComponent(path))
+
+            let progress = Double(index + 1) / Double(changed.count + 1)
+            await MainActor.run { syncProgress = progress }
+        }
+
+        // 2. Commit point: the manifest now describes the uploaded files
+        let stagedManifest = stagingRoot.appendingPathComponent(iCloudSyncManifest.fileName)
+        try local.encoded().write(to: stagedManifest, options: .atomic)
+        try placeInCloud(stagedManifest, at: manifestURL)
+
+        // 3. Files only the previous manifest referenced (old chunks, deleted slots)
+        for path in removed {
+            try? removeCloudItem(cloudURL.appendingPathComponent(path))
+        }
+        print("[iCloud] ✅ Δ upload committed")
+    }
+
+    /// Move `staged` into the ubiquity container at `destination`.
+    /// setUbiquitous() registers the file with the sync daemon (a plain copy
+    /// does not) but throws if the destination exists, so replace by removing.
+    private func placeInCloud(_ staged: URL, at destination: URL) throws {
+        try FileManager.default.createDirectory(
+            at: destination.deletingLastPathComponent(),
+            withIntermediateDirectories: true
+        )
+        if FileManager.default.fileExists(atPath: destination.path) {
+            try removeCloudItem(destination)
+        }
+        try FileManager.default.setUbiquitous(true, itemAt: staged, destinationURL: destination)
+    }
+
+    private func removeCloudItem(_ url: URL) throws {
+        let coordinator = NSFileCoordinator()
+        var coordinationError: NSError?
+        var capturedError: Error?
+
+        coordinator.coordinate(writingItemAt: url, options: .forDeleting, error: &coordinationError) { deleteURL in
+            do {
+                try FileManager.default.removeItem(at: deleteURL)
+            } catch {
+                capturedError = error
+            }
+        }
+
+        if let error = coordinationError ?? capturedError {
+            throw error
+        }
+    }
+
+    /// A cloud directory uploaded before manifests existed: every file it
+    /// holds (downloaded or placeholder) with no hash, so each is re-sent
+    /// and leftovers are removed after the commit.
+    private func legacyManifest(of cloudURL: URL) -> iCloudSyncManifest {
+        var manifest = iCloudSyncManifest()
+        guard let enumerator = FileManager.default.enumerator(at: cloudURL, includingPropertiesForKeys: [.isDirectoryKey]) else {
+            return manifest
+        }
+        let base = cloudURL.standardizedFileURL.resolvingSymlinksInPath().pathComponents
+        for case let url as URL in enumerator {
+            if (try? url.resourceValues(forKeys: [.isDirectoryKey]).isDirectory) == true { continue }
+            var components = Array(url.standardizedFileURL.resolvingSymlinksInPath().pathComponents.dropFirst(base.count))
+            guard var name = components.last else { continue }
+            if name.hasPrefix(".") {
+                guard name.hasSuffix(".icloud") else { continue }
+                name = String(name.dropFirst().dropLast(".icloud".count))  // Placeholder for a file not downloaded
+            }
+            components[components.count - 1] = name
+            let path = components.joined(separator: "/")
+            if iCloudSyncManifest.isSyncable(path) {
+                manifest.files[path] = iCloudSyncManifest.Entry(size: -1, hash: "")
+            }
+        }
+        return manifest
+    }
+
+    // MARK: - Download
+
+    /// Bring `localURL` in line with the cloud manifest of `cloudURL`, fetching
+    /// only files whose hash differs locally. Returns false if the cloud copy
+    /// has no manifest (uploaded by an older build); the caller copies it whole.
+    func downloadChanges(from cloudURL: URL, to localURL: URL) async throws -> Bool {
+        let manifestURL = cloudURL.appendingPathComponent(iCloudSyncManifest.fileName)
+        guard cloudFileExists(manifestURL) else { return false }
+        try await waitForCloudFile(manifestURL)
+
+        guard let remote = coordinatedRead(manifestURL, { iCloudSyncManifest.read(from: $0) }) else {
+            print("[iCloud] ❌ Unreadable sync manifest at \(manifestURL.path)")
+            throw iCloudError.downloadFailed
+        }
+        let local = (try? iCloudSyncManifest.scan(localURL)) ?? iCloudSyncManifest()
+
+        let needed = remote.changedPaths(since: local)
+        let removed = remote.removedPaths(since: local)
+        print("[iCloud] Δ download: \(needed.count)/\(remote.files.count) files needed, \(removed.count) removed")
+
+        // 1. Stage and verify everything before touching the local save
+        let stagingRoot = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: stagingRoot, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: stagingRoot) }
+
+        for (index, path) in needed.enumerated() {
+            let source = cloudURL.appendingPathComponent(path)
+            let staged = stagingRoot.appendingPathComponent(path)
+            try await waitForCloudFile(source)
+            try FileManager.default.createDirectory(at: staged.deletingLastPathComponent(), withIntermediateDirectories: true)
+            let copied: Bool = coordinatedRead(source) { readURL in
+                (try? FileManager.default.copyItem(at: readURL, to: staged)) != nil
+            } ?? false
+
+            // A file that doesn't match is from an upload the manifest hasn't committed
+            guard copied, try matches(staged, remote.files[path], relativePath: path) else {
+                print("[iCloud] ❌ \(path) does not match the sync manifest - cloud copy still settling")
+                throw iCloudError.downloadFailed
+            }
+
+            let progress = Double(index + 1) / Double(needed.count + 1)
+            await MainActor.run { syncProgress = progress }
+        }
+
+        // 2. Apply: replace changed files, drop files the cloud no longer has
+        for path in needed {
+            let destination = localURL.appendingPathComponent(path)
+            try FileManager.default.createDirectory(at: destination.deletingLastPathComponent(), withIntermediateDirectories: true)
+            if FileManager.default.fileExists(atPath: destination.path) {
+                try FileManager.default.removeItem(at: destination)
+            }
+            try FileManager.default.moveItem(at: stagingRoot.appendingPathComponent(path), to: destination)
+        }
+        for path in removed {
+            try? FileManager.default.removeItem(at: localURL.appendingPathComponent(path))
+        }
+        print("[iCloud] ✅ Δ download applied")
+        return true
+    }
+
+    private func matches(_ url: URL, _ entry: iCloudSyncManifest.Entry?, relativePath: String) throws -> Bool {
+        guard let entry else { return false }
+        let size = Int64(try url.resourceValues(forKeys: [.fileSizeKey]).fileSize ?? -1)
+        // Chunk contents are verified against their name when the level store restores them
+        guard size == entry.size else { return false }
+        return try iCloudSyncManifest.hash(of: url, relativePath: relativePath) == entry.hash
+    }
+
+    /// The file, or its `.name.icloud` placeholder, is in the container
+    private func cloudFileExists(_ url: URL) -> Bool {
+        let placeholder = url.deletingLastPathComponent().appendingPathComponent(".\(url.lastPathComponent).icloud")
+        return FileManager.default.fileExists(atPath: url.path) ||
+            FileManager.default.fileExists(atPath: placeholder.path)
+    }
+
+    /// Trigger the download of one cloud file and wait until the current version is local
+    private func waitForCloudFile(_ url: URL) async throws {
+        let maxAttempts = 120  // 60 seconds, as for whole-directory downloads
+        for attempt in 0..<maxAttempts {
+            if FileManager.default.fileExists(atPath: url.path) {
+                let status = downloadStatus(for: url)
+                if status == nil || status == URLUbiquitousItemDownloadingStatus.current.rawValue {
+                    return
+                }
+            }
+            if attempt == 0 {
+                try? FileManager.default.startDownloadingUbiquitousItem(at: url)
+            }
+            try await Task.sleep(nanoseconds: 500_000_000)  // 0.5s
+        }
+        print("[iCloud] ❌ Download timeout for \(url.lastPathComponent)")
+        throw iCloudError.downloadFailed
+    }
+
+    private func coordinatedRead<T>(_ url: URL, _ body: (URL) -> T?) -> T? {
+        let coordinator = NSFileCoordinator()
+        var coordinationError: NSError?
+        var result: T?
+        coordinator.coordinate(readingItemAt: url, options: [], error: &coordinationError) { readURL in
+            result = body(readURL)
+        }
+        return coordinationError == nil ? result : nil
+    }
+}
@@ -281,6 +281,21 @@ class iCloudStorageManager: ObservableObject {
             }
         }
 
+        let manifest = try iCloudSyncManifest.scan(localURL)
+
+        // Already in iCloud: send only the files whose hash changed
+        // (iCloudStorageManager+DeltaSync.swift)
+        if FileManager.default.fileExists(atPath: iCloudURL.path) {
+            do {
+                try await uploadChanges(from: localURL, manifest: manifest, to: iCloudURL)
+            } catch {
+                print("[iCloud] ❌ Upload failed: \(error)")
+                throw error
+            }
+            return
+        }
+
+        // First upload: move the whole directory, manifest included.
         // CRITICAL: Must use setUbiquitous() to trigger iCloud sync!
         // copyItem() does NOT register files with iCloud sync daemon.
         // setUbiquitous() MOVES the file, so we copy to temp first.
@@ -296,18 +311,13 @@ class iCloudStorageManager: ObservableObject {
                 withIntermediateDirectories: true
             )
             try FileManager.default.copyItem(at: localURL, to: tempURL)
+            try manifest.encoded().write(
+                to: tempURL.appendingPathComponent(iCloudSyncManifest.fileName),
+                options: .atomic
+            )
             print("[iCloud] 📁 Copied to temp: \(tempURL.path)")
 
-            // Step 2: Remove existing iCloud version if present
-            // NOTE: setUbiquitous() throws if destination exists, so we must remove first
-            // Risk: If setUbiquitous fails after remove, old version is lost
-            // Mitigation: We still have local copy, can re-upload on next save
-            if FileManager.default.fileExists(atPath: iCloudURL.path) {
-                try FileManager.default.removeItem(at: iCloudURL)
-                print("[iCloud] 🗑️ Removed existing iCloud version")
-            }
-
-            // Step 3: Move temp to iCloud using setUbiquitous (triggers sync!)
+            // Step 2: Move temp to iCloud using setUbiquitous (triggers sync!)
             // MUST be called from background thread (we're already async)
             try FileManager.default.setUbiquitous(true, itemAt: tempURL, destinationURL: iCloudURL)
 
@@ -367,6 +377,15 @@ class iCloudStorageManager: ObservableObject {
         }
     }
 
+    /// Apply only what changed when the cloud copy has a sync manifest,
+    /// otherwise (uploaded by an older build) copy the directory whole
+    private func syncFromCloud(from cloudURL: URL, to localURL: URL) async throws {
+        if try await downloadChanges(from: cloudURL, to: localURL) {
+            return
+        }
+        try await copyFromCloud(from: cloudURL, to: localURL)
+    }
+
     // MARK: - Download Character Save
 
     /// Download a character save from iCloud to local storage
@@ -435,7 +454,7 @@ class iCloudStorageManager: ObservableObject {
                         if FileManager.default.fileExists(atPath: correctedURL.path) {
                             print("[iCloud]   Using corrected path (directory)")
                             // Copy from corrected path
-                            try await copyFromCloud(from: correctedURL, to: localURL)
+                            try await syncFromCloud(from: correctedURL, to: localURL)
                             return
                         } else if FileManager.default.fileExists(atPath: correctedPlaceholder.path) {
                             print("[iCloud]   Using corrected path (placeholder)")
@@ -453,7 +472,7 @@ class iCloudStorageManager: ObservableObject {
         // If actual directory exists, copy it directly
         if actualExists {
             print("[iCloud]   Directory exists, copying directly...")
-            try await copyFromCloud(from: iCloudURL, to: localURL)
+            try await syncFromCloud(from: iCloudURL, to: localURL)
             return
         }
 
@@ -491,7 +510,7 @@ class iCloudStorageManager: ObservableObject {
             }
 
             // Now copy the downloaded file
-            try await copyFromCloud(from: iCloudURL, to: localURL)
+            try await syncFromCloud(from: iCloudURL, to: localURL)
         }
     }
 
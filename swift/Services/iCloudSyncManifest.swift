@@ -0,0 +1,134 @@
+import Foundation
+
+// MARK: - iCloud Sync Manifest
+
+/// Content hashes of every file in a character save directory.
+///
+/// The cloud copy of a character keeps one of these next to the save
+/// (`sync.manifest.json`). Uploads send only files whose entry changed and
+/// then replace the manifest, which is the commit point: a download trusts
+/// a file only if it matches the manifest, so a half-synced directory is
+/// refused instead of restored.
+///
+/// Level chunks (`levels/<hash>-<length>.lvl`, see ios_level_store.h) are
+/// content-addressed, so their name is their hash and they are never read.
+/// Everything else (savegame, manifests, metadata, snapshots) is hashed with
+/// the same FNV-1a the level store uses.
+struct iCloudSyncManifest: Codable, Equatable {
+    static let fileName = "sync.manifest.json"
+    static let currentVersion = 1
+
+    struct Entry: Codable, Equatable {
+        let size: Int64
+        let hash: String
+    }
+
+    var version: Int = iCloudSyncManifest.currentVersion
+    /// Relative path ("savegame", "slot_00001/levels/….lvl") -> entry
+    var files: [String: Entry] = [:]
+
+    // MARK: - Diffing
+
+    /// Paths whose entry here differs from (or is missing in) `other`
+    func changedPaths(since other: iCloudSyncManifest) -> [String] {
+        files.compactMap { path, entry in other.files[path] == entry ? nil : path }
+            .sorted(by: Self.uploadOrder)
+    }
+
+    /// Paths in `other` that are gone here
+    func removedPaths(since other: iCloudSyncManifest) -> [String] {
+        other.files.keys.filter { files[$0] == nil }.sorted()
+    }
+
+    /// Chunks first and metadata.json last: metadata is what cloud discovery
+    /// watches, so it should land after the data it describes
+    private static func uploadOrder(_ a: String, _ b: String) -> Bool {
+        func rank(_ path: String) -> Int {
+            if isLevelChunk(path) { return 0 }
+            return (path as NSString).lastPathComponent == "metadata.json" ? 2 : 1
+        }
+        return (rank(a), a) < (rank(b), b)
+    }
+
+    // MARK: - Scanning
+
+    /// Hash every syncable file under `directory` (empty if it doesn't exist)
+    static func scan(_ directory: URL) throws -> iCloudSyncManifest {
+        var manifest = iCloudSyncManifest()
+        for (path, url) in try syncableFiles(in: directory) {
+            let size = Int64(try url.resourceValues(forKeys: [.fileSizeKey]).fileSize ?? 0)
+            manifest.files[path] = Entry(size: size, hash: try hash(of: url, relativePath: path))
+        }
+        return manifest
+    }
+
+    /// Relative path -> URL of the files a character sync carries
+    static func syncableFiles(in directory: URL) throws -> [(String, URL)] {
+        let base = directory.standardizedFileURL.resolvingSymlinksInPath().pathComponents
+        guard let enumerator = FileManager.default.enumerator(
+            at: directory,
+            includingPropertiesForKeys: [.isRegularFileKey],
+            options: [.skipsHiddenFiles]
+        ) else {
+            return []
+        }
+
+        var result: [(String, URL)] = []
+        for case let url as URL in enumerator {
+            guard (try? url.resourceValues(forKeys: [.isRegularFileKey]).isRegularFile) == true else { continue }
+            let components = url.standardizedFileURL.resolvingSymlinksInPath().pathComponents
+            let path = components.dropFirst(base.count).joined(separator: "/")
+            if isSyncable(path) {
+                result.append((path, url))
+            }
+        }
+        return result
+    }
+
+    /// Writer temp files and the manifest itself never sync as data
+    static func isSyncable(_ path: String) -> Bool {
+        path != fileName && !path.hasSuffix(".tmp") && !path.isEmpty
+    }
+
+    static func isLevelChunk(_ path: String) -> Bool {
+        let components = path.split(separator: "/")
+        return components.count >= 2 && components[components.count - 2] == "levels" && path.hasSuffix(".lvl")
+    }
+
+    /// Chunk name for level chunks, FNV-1a of the contents otherwise
+    static func hash(of url: URL, relativePath: String) throws -> String {
+        if isLevelChunk(relativePath) {
+            return (relativePath as NSString).lastPathComponent
+        }
+        let data = try Data(contentsOf: url, options: .mappedIfSafe)
+        return String(format: "%016llx", fnv1a(data))
+    }
+
+    static func fnv1a(_ data: Data) -> UInt64 {
+        data.withUnsafeBytes { raw in
+            var h: UInt64 = 0xcbf29ce484222325
+            for byte in raw {
+                h ^= UInt64(byte)
+                h = h &* 0x100000001b3
+            }
+            return h
+        }
+    }
+
+    // MARK: - Encoding
+
+    static func read(from url: URL) -> iCloudSyncManifest? {
+        guard let data = try? Data(contentsOf: url),
+              let manifest = try? JSONDecoder().decode(iCloudSyncManifest.self, from: data),
+              manifest.version == currentVersion else {
+            return nil
+        }
+        return manifest
+    }
+
+    func encoded() throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.sortedKeys]
+        return try encoder.encode(self)
+    }
+}
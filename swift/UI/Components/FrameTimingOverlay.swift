@@ -0,0 +1,62 @@
+//
+//  FrameTimingOverlay.swift
+//  nethack
+//
+//  Debug overlay: per-stage turn latency (p50/p90/p99/max) from the
+//  C-side histograms. Enable with the "debug.frameTimingOverlay" default.
+//
+
+import SwiftUI
+
+#if DEBUG
+struct FrameTimingOverlay: View {
+    @State private var rows: [FrameTimingStageStats] = []
+
+    var body: some View {
+        TimelineView(.periodic(from: .now, by: 1.0)) { context in
+            VStack(alignment: .leading, spacing: 2) {
+                Text(Self.header)
+                    .fontWeight(.semibold)
+                ForEach(rows) { row in
+                    Text(line(for: row))
+                }
+            }
+            .font(.system(size: 10, design: .monospaced))
+            .foregroundStyle(.white)
+            .padding(6)
+            .background(.black.opacity(0.6), in: RoundedRectangle(cornerRadius: 6))
+            .onChange(of: context.date) { _, _ in
+                rows = NetHackBridge.shared.frameTimingStats()
+            }
+        }
+        .onTapGesture(count: 2) {
+            NetHackBridge.shared.resetFrameTiming()
+            rows = NetHackBridge.shared.frameTimingStats()
+        }
+        .allowsHitTesting(true)
+    }
+
+    private static let header = "stage".padding(toLength: 12, withPad: " ", startingAt: 0)
+        + rightAligned("n", 5) + ["p50", "p90", "p99", "max"].map { rightAligned($0, 7) }.joined()
+
+    private func line(for row: FrameTimingStageStats) -> String {
+        let s = row.stats
+        let values = [s.p50_us, s.p90_us, s.p99_us, s.max_us].map { Self.rightAligned(Self.format($0), 7) }
+        return row.name.padding(toLength: 12, withPad: " ", startingAt: 0)
+            + Self.rightAligned("\(s.count)", 5) + values.joined()
+    }
+
+    private static func rightAligned(_ text: String, _ width: Int) -> String {
+        String(repeating: " ", count: max(0, width - text.count)) + text
+    }
+
+    /// Microseconds as "850us" / "12.3ms" / "1.2s"
+    private static func format(_ us: UInt32) -> String {
+        switch us {
+        case ..<1000: return "\(us)us"
+        case ..<1_000_000: return String(format: "%.1fms", Double(us) / 1000)
+        default: return String(format: "%.1fs", Double(us) / 1_000_000)
+        }
+    }
+}
+#endif
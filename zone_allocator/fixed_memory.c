@@ -5,6 +5,7 @@
  */
 
 #include "fixed_memory.h"
+#include "nh_alloc_stats.h"
 #include <sys/mman.h>
 #include <stdio.h>
 #include <string.h>
@@ -28,6 +29,21 @@ void* memory_base = NULL;  // Removed static to allow access from zone code
 static size_t memory_used = 0;
 static size_t allocation_count = 0;
 static size_t actual_memory_size = NETHACK_MEMORY_SIZE;  // Track actual allocated size
+static NhAllocStats stats = { .allocator = NH_ALLOCATOR_FIXED_REGION };
+
+// Replace [base, base+size) with fresh zero pages. Anonymous pages are only
+// backed when touched, so this drops resident memory instead of memset()
+// faulting in the whole region.
+static int discard_region(void* base, size_t size) {
+    void* addr = mmap(base, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON | MAP_FIXED, -1, 0);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "[FIXED_MEM] Cannot discard region: %s\n", strerror(errno));
+        memset(base, 0, size);
+        return -1;
+    }
+    return 0;
+}
 
 // Align size to boundary
 static inline size_t align_up(size_t size, size_t alignment) {
@@ -100,8 +116,7 @@ int fixed_memory_init(void) {
     memory_used = 0;
     allocation_count = 0;
 
-    // Clear the memory
-    memset(memory_base, 0, actual_memory_size);
+    // Fresh anonymous mapping is already zero (and not yet resident)
 
     fprintf(stderr, "[FIXED_MEM] Initialized %zu MB at %p %s\n",
             actual_memory_size / (1024*1024), memory_base,
@@ -110,6 +125,15 @@ int fixed_memory_init(void) {
     return 0;
 }
 
+// Mark block free (holes are never reused, so the largest only grows)
+static void mark_free(block_header* block) {
+    block->is_free = 1;
+    nh_alloc_stats_on_free(&stats, block->size);
+    stats.free_bytes += block->size;
+    stats.free_blocks++;
+    if (block->size > stats.largest_free_block) stats.largest_free_block = block->size;
+}
+
 // Simple bump allocator with headers
 void* fixed_alloc(size_t size) {
     if (!memory_base) {
@@ -139,6 +163,8 @@ void* fixed_alloc(size_t size) {
     // Update counters
     memory_used += total_size;
     allocation_count++;
+    nh_alloc_stats_on_alloc(&stats, total_size, size);
+    nh_alloc_stats_note_used(&stats, memory_used);
 
     // Return pointer after header
     return (uint8_t*)block + sizeof(block_header);
@@ -178,7 +204,7 @@ void* fixed_realloc(void* ptr, size_t new_size) {
         memcpy(new_ptr, ptr, copy_size);
 
         // Mark old block as free (simple marking, no coalescing)
-        block->is_free = 1;
+        mark_free(block);
     }
 
     return new_ptr;
@@ -196,8 +222,10 @@ void fixed_free(void* ptr) {
         return;
     }
 
+    if (block->is_free) return;
+
     // Mark as free (simple implementation - no actual reclamation)
-    block->is_free = 1;
+    mark_free(block);
 }
 
 // Complete restart - clear everything but keep the address
@@ -211,11 +239,13 @@ void fixed_memory_restart(void) {
             memory_used, memory_base);
 
     // Clear all used memory
-    memset(memory_base, 0, actual_memory_size);
+    discard_region(memory_base, actual_memory_size);
 
     // Reset counters
     memory_used = 0;
     allocation_count = 0;
+    memset(&stats, 0, sizeof(stats));
+    stats.allocator = NH_ALLOCATOR_FIXED_REGION;
 }
 
 // Save the entire memory region
@@ -349,7 +379,7 @@ int fixed_memory_load(const char* filepath) {
     }
 
     // Clear current memory
-    memset(memory_base, 0, actual_memory_size);
+    discard_region(memory_base, actual_memory_size);
 
     // Load the memory content
     if (read(fd, memory_base, header.used) != (ssize_t)header.used) {
@@ -375,6 +405,19 @@ int fixed_memory_load(const char* filepath) {
 
     close(fd);
 
+    // Recount statistics from the loaded blocks
+    memset(&stats, 0, sizeof(stats));
+    stats.allocator = NH_ALLOCATOR_FIXED_REGION;
+    for (size_t offset = 0; offset < memory_used; ) {
+        block_header* block = (block_header*)((uint8_t*)memory_base + offset);
+        if (block->magic != BLOCK_MAGIC || block->size == 0) break;
+        nh_alloc_stats_on_alloc(&stats, block->size, 0);
+        if (block->is_free) mark_free(block);
+        offset += block->size;
+    }
+    memset(stats.phases, 0, sizeof(stats.phases));
+    nh_alloc_stats_note_used(&stats, memory_used);
+
     fprintf(stderr, "[FIXED_MEM] Successfully loaded %zu bytes (%zu allocations)\n",
             memory_used, allocation_count);
 
@@ -387,6 +430,14 @@ void fixed_memory_stats(size_t* used, size_t* allocations) {
     if (allocations) *allocations = allocation_count;
 }
 
+void fixed_memory_get_stats(NhAllocStats* out) {
+    if (!out) return;
+    *out = stats;
+    out->capacity = actual_memory_size;
+    out->used_bytes = memory_used;
+    nh_alloc_stats_finish(out);
+}
+
 // Check integrity of all blocks
 int fixed_memory_check_integrity(void) {
     if (!memory_base) return -1;
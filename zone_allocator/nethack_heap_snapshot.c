@@ -0,0 +1,493 @@
+/*
+ * nethack_heap_snapshot.c - Base + delta heap snapshots (see nethack_heap_snapshot.h)
+ *
+ * Base file and delta file hold the same records; the base has one (seq 0,
+ * every page), the delta file appends seq 1, 2, ...:
+ *
+ *   [SnapRecordHeader][meta][count x uint32 page id][count x page][SnapRecordTrailer]
+ *
+ * Page ids below SNAP_HEAP_PAGES are heap pages; the rest are region pages
+ * (id - SNAP_HEAP_PAGES). A region's last page is stored padded to a full
+ * page and loaded back to the region's end only.
+ */
+
+#include "nethack_heap_snapshot.h"
+#include "nethack_memory_final.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define SNAP_HEAP_PAGES (NH_HEAP_SIZE / NH_SNAP_PAGE_SIZE)
+#define SNAP_REGION_PAGES 1024                 // Region up to 16MB
+#define SNAP_MAX_PAGES (SNAP_HEAP_PAGES + SNAP_REGION_PAGES)
+#define SNAP_MAGIC "NHSNAPR"
+#define SNAP_TRAILER_MAGIC 0x444E4550414E534EULL  // "NSNAPEND"
+
+typedef struct {
+    char magic[8];           // SNAP_MAGIC
+    uint64_t chain_id;       // Pairs deltas with their base
+    uint32_t seq;            // 0 = base, then 1, 2, ...
+    uint32_t count;          // Pages in this record
+    uint64_t heap_base;      // Address the heap was at
+    uint64_t heap_used;      // heap_used after applying
+    uint64_t region_size;
+    uint32_t meta_size;
+    uint32_t page_size;
+} SnapRecordHeader;
+
+typedef struct {
+    uint64_t chain_id;
+    uint32_t seq;
+    uint32_t count;
+    uint64_t magic;          // SNAP_TRAILER_MAGIC - record is complete
+} SnapRecordTrailer;
+
+struct NhSnapshot {
+    SnapRecordHeader header;
+    uint8_t meta[NH_SNAP_META_MAX];
+    uint32_t* ids;           // In the mapping, then the pages
+    uint8_t* pages;
+    void* mapping;
+    size_t mapping_size;
+};
+
+// Chain state: hashes of the pages as last staged
+static uint64_t heap_hash[SNAP_HEAP_PAGES];
+static uint64_t region_hash[SNAP_REGION_PAGES];
+static uint32_t dirty_ids[SNAP_MAX_PAGES];
+static uint8_t bounce[NH_SNAP_PAGE_SIZE];      // A region's partial last page on load
+static size_t hashed_heap_pages = 0;
+static size_t chain_region_size = 0;
+static uint64_t chain_used = 0;                // heap_used of the newest record
+static uint64_t chain_id = 0;                  // 0 = no chain
+static uint32_t chain_next_seq = 0;
+static uint32_t chain_generation = 0;          // nh_heap_generation() the hashes belong to
+static off_t chain_delta_bytes = 0;            // Valid length of the delta file
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 4-lane multiply-xor hash (lanes break the multiply dependency chain)
+static uint64_t hash_page(const uint8_t* page, size_t len) {
+    uint64_t h0 = 0x9E3779B97F4A7C15ULL, h1 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t h2 = 0x165667B19E3779F9ULL, h3 = 0x27D4EB2F165667C5ULL;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint64_t w[4];
+        memcpy(w, page + i, sizeof(w));
+        h0 = (h0 ^ w[0]) * 0x100000001B3ULL;
+        h1 = (h1 ^ w[1]) * 0x100000001B3ULL;
+        h2 = (h2 ^ w[2]) * 0x100000001B3ULL;
+        h3 = (h3 ^ w[3]) * 0x100000001B3ULL;
+    }
+    for (; i < len; i++) {
+        h0 = (h0 ^ page[i]) * 0x100000001B3ULL;
+    }
+    uint64_t h = h0 ^ (h1 << 1 | h1 >> 63) ^ (h2 << 2 | h2 >> 62) ^ (h3 << 3 | h3 >> 61);
+    return h ^ (h >> 29);
+}
+
+static size_t pages_for(size_t bytes) {
+    return (bytes + NH_SNAP_PAGE_SIZE - 1) / NH_SNAP_PAGE_SIZE;
+}
+
+static int write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void* buf, size_t len) {
+    uint8_t* p = (uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+void nh_snapshot_invalidate(void) {
+    chain_id = 0;
+    hashed_heap_pages = 0;
+    chain_region_size = 0;
+}
+
+static size_t record_bytes(const SnapRecordHeader* header) {
+    return sizeof(*header) + header->meta_size +
+           (size_t)header->count * (sizeof(uint32_t) + NH_SNAP_PAGE_SIZE) +
+           sizeof(SnapRecordTrailer);
+}
+
+// --- Staging ---
+
+static const uint8_t* page_source(uint32_t id, const uint8_t* region, size_t region_size,
+                                  size_t* len) {
+    if (id < SNAP_HEAP_PAGES) {
+        *len = NH_SNAP_PAGE_SIZE;  // Committed in 1MB steps, so whole pages read
+        return nethack_heap + (size_t)id * NH_SNAP_PAGE_SIZE;
+    }
+    size_t offset = (size_t)(id - SNAP_HEAP_PAGES) * NH_SNAP_PAGE_SIZE;
+    *len = region_size - offset < NH_SNAP_PAGE_SIZE ? region_size - offset : NH_SNAP_PAGE_SIZE;
+    return region + offset;
+}
+
+int nh_snapshot_stage(const uint8_t* region, size_t region_size,
+                      NhSnapshot** out, NhSnapshotResult* result) {
+    uint64_t start = now_ns();
+    *out = NULL;
+    if (result) memset(result, 0, sizeof(*result));
+
+    size_t heap_pages = pages_for(heap_used);
+    size_t region_pages = pages_for(region_size);
+    if (!nethack_heap || region_pages > SNAP_REGION_PAGES) {
+        fprintf(stderr, "[NH_SNAPSHOT] Cannot stage a %zu byte region\n", region_size);
+        return -1;
+    }
+
+    // No chain, a replaced heap, or deltas that outgrew a full image: base
+    int base = chain_id == 0 || chain_generation != nh_heap_generation() ||
+               chain_region_size != region_size ||
+               chain_delta_bytes > (off_t)(heap_used + region_size);
+
+    uint32_t count = 0;
+    for (size_t i = 0; i < heap_pages; i++) {
+        uint64_t h = hash_page(nethack_heap + i * NH_SNAP_PAGE_SIZE, NH_SNAP_PAGE_SIZE);
+        if (base || i >= hashed_heap_pages || h != heap_hash[i]) {
+            heap_hash[i] = h;
+            dirty_ids[count++] = (uint32_t)i;
+        }
+    }
+    for (size_t j = 0; j < region_pages; j++) {
+        size_t len;
+        const uint8_t* src = page_source((uint32_t)(SNAP_HEAP_PAGES + j), region, region_size, &len);
+        uint64_t h = hash_page(src, len);
+        if (base || h != region_hash[j]) {
+            region_hash[j] = h;
+            dirty_ids[count++] = (uint32_t)(SNAP_HEAP_PAGES + j);
+        }
+    }
+    if (result) result->pages_scanned = heap_pages + region_pages;
+
+    if (!base && count == 0 && chain_used == heap_used) {
+        hashed_heap_pages = heap_pages;
+        if (result) result->duration_ns = now_ns() - start;
+        return 0;  // Nothing changed
+    }
+
+    NhSnapshot* snap = calloc(1, sizeof(*snap));
+    size_t mapping_size = (size_t)count * (sizeof(uint32_t) + NH_SNAP_PAGE_SIZE);
+    void* mapping = mapping_size ? mmap(NULL, mapping_size, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANON, -1, 0) : NULL;
+    if (!snap || mapping == MAP_FAILED) {
+        fprintf(stderr, "[NH_SNAPSHOT] Cannot stage %u pages: %s\n", count, strerror(errno));
+        if (mapping && mapping != MAP_FAILED) munmap(mapping, mapping_size);
+        free(snap);
+        nh_snapshot_invalidate();  // The hashes already moved on
+        return -1;
+    }
+
+    if (base) {
+        chain_id = ((uint64_t)time(NULL) << 20) ^ start;
+        if (chain_id == 0) chain_id = 1;
+        chain_next_seq = 0;
+        chain_generation = nh_heap_generation();
+        chain_region_size = region_size;
+    }
+    hashed_heap_pages = heap_pages;
+    chain_used = heap_used;
+
+    memcpy(snap->header.magic, SNAP_MAGIC, sizeof(snap->header.magic));
+    snap->header.chain_id = chain_id;
+    snap->header.seq = chain_next_seq;
+    snap->header.count = count;
+    snap->header.heap_base = (uint64_t)(uintptr_t)nethack_heap;
+    snap->header.heap_used = heap_used;
+    snap->header.region_size = region_size;
+    snap->header.page_size = NH_SNAP_PAGE_SIZE;
+    snap->mapping = mapping;
+    snap->mapping_size = mapping_size;
+    snap->ids = mapping;
+    snap->pages = mapping ? (uint8_t*)mapping + (size_t)count * sizeof(uint32_t) : NULL;
+
+    if (count) memcpy(snap->ids, dirty_ids, (size_t)count * sizeof(uint32_t));
+    for (uint32_t k = 0; k < count; k++) {
+        size_t len;
+        const uint8_t* src = page_source(dirty_ids[k], region, region_size, &len);
+        memcpy(snap->pages + (size_t)k * NH_SNAP_PAGE_SIZE, src, len);  // Mapping is zeroed past len
+    }
+
+    *out = snap;
+    if (result) {
+        result->was_base = (uint32_t)base;
+        result->seq = snap->header.seq;
+        result->pages_written = count;
+        result->bytes_written = (size_t)count * NH_SNAP_PAGE_SIZE;  // Copied, not yet written
+        result->duration_ns = now_ns() - start;
+    }
+    return 0;
+}
+
+static void free_snapshot(NhSnapshot* snap) {
+    if (snap->mapping) munmap(snap->mapping, snap->mapping_size);
+    free(snap);
+}
+
+void nh_snapshot_drop(NhSnapshot* snap) {
+    if (!snap) return;
+    free_snapshot(snap);
+    nh_snapshot_invalidate();
+}
+
+// --- Commit ---
+
+static int write_record(int fd, const NhSnapshot* snap) {
+    const SnapRecordHeader* header = &snap->header;
+    SnapRecordTrailer trailer = { header->chain_id, header->seq, header->count, SNAP_TRAILER_MAGIC };
+    size_t body = (size_t)header->count * (sizeof(uint32_t) + NH_SNAP_PAGE_SIZE);
+
+    return write_all(fd, header, sizeof(*header)) == 0 &&
+           write_all(fd, snap->meta, header->meta_size) == 0 &&
+           (body == 0 || write_all(fd, snap->mapping, body) == 0) &&
+           write_all(fd, &trailer, sizeof(trailer)) == 0 ? 0 : -1;
+}
+
+static int commit_base(const NhSnapshot* snap, const char* base_path, const char* delta_path) {
+    char tmp_path[1040];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", base_path);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "[NH_SNAPSHOT] Cannot create %s: %s\n", tmp_path, strerror(errno));
+        return -1;
+    }
+    int failed = write_record(fd, snap) != 0 || fsync(fd) != 0;
+    close(fd);
+    if (failed || rename(tmp_path, base_path) != 0) {
+        fprintf(stderr, "[NH_SNAPSHOT] Base write failed: %s\n", strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
+    unlink(delta_path);  // Old records belong to the previous base
+
+    chain_delta_bytes = 0;
+    return 0;
+}
+
+static int commit_delta(const NhSnapshot* snap, const char* delta_path) {
+    int fd = open(delta_path, O_WRONLY | O_CREAT, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "[NH_SNAPSHOT] Cannot open %s: %s\n", delta_path, strerror(errno));
+        return -1;
+    }
+
+    // Append after the last valid record (drops a torn tail from a crash)
+    int ok = ftruncate(fd, chain_delta_bytes) == 0 &&
+             lseek(fd, chain_delta_bytes, SEEK_SET) == chain_delta_bytes &&
+             write_record(fd, snap) == 0 && fsync(fd) == 0;
+    close(fd);
+    if (!ok) {
+        fprintf(stderr, "[NH_SNAPSHOT] Delta write failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    chain_delta_bytes += (off_t)record_bytes(&snap->header);
+    return 0;
+}
+
+int nh_snapshot_commit(NhSnapshot* snap, const void* meta, size_t meta_size,
+                       const char* base_path, const char* delta_path, NhSnapshotResult* result) {
+    uint64_t start = now_ns();
+    if (!snap) return 0;
+    if (meta_size > NH_SNAP_META_MAX) {
+        nh_snapshot_drop(snap);
+        return -1;
+    }
+    snap->header.meta_size = (uint32_t)meta_size;
+    if (meta_size) memcpy(snap->meta, meta, meta_size);
+
+    // Staged for another chain (invalidated since): its pages are not a delta of anything on disk
+    int stale = snap->header.chain_id != chain_id || snap->header.seq != chain_next_seq;
+    int failed = stale ||
+                 (snap->header.seq == 0 ? commit_base(snap, base_path, delta_path)
+                                        : commit_delta(snap, delta_path)) != 0;
+    if (failed) {
+        free_snapshot(snap);
+        nh_snapshot_invalidate();  // Hashes already moved on - the next stage must be a base
+        return -1;
+    }
+
+    chain_next_seq++;
+    if (result) {
+        memset(result, 0, sizeof(*result));
+        result->was_base = snap->header.seq == 0;
+        result->seq = snap->header.seq;
+        result->pages_written = snap->header.count;
+        result->bytes_written = record_bytes(&snap->header);
+        result->duration_ns = now_ns() - start;
+    }
+    free_snapshot(snap);
+    return 0;
+}
+
+// --- Load ---
+
+// Check the record at pos belongs to chain_id and is complete; its end in *end
+static int read_record_header(int fd, off_t pos, uint64_t id, uint32_t seq,
+                              SnapRecordHeader* header, off_t* end) {
+    if (lseek(fd, pos, SEEK_SET) != pos || read_all(fd, header, sizeof(*header)) != 0) return -1;
+    if (memcmp(header->magic, SNAP_MAGIC, sizeof(header->magic)) != 0 ||
+        (id && header->chain_id != id) || header->seq != seq ||
+        header->page_size != NH_SNAP_PAGE_SIZE || header->count > SNAP_MAX_PAGES ||
+        header->heap_used > NH_HEAP_SIZE || header->meta_size > NH_SNAP_META_MAX ||
+        pages_for((size_t)header->region_size) > SNAP_REGION_PAGES) {
+        return -1;
+    }
+
+    // Check the trailer before anything is applied
+    off_t trailer_pos = pos + (off_t)record_bytes(header) - (off_t)sizeof(SnapRecordTrailer);
+    SnapRecordTrailer trailer;
+    if (lseek(fd, trailer_pos, SEEK_SET) != trailer_pos ||
+        read_all(fd, &trailer, sizeof(trailer)) != 0 ||
+        trailer.magic != SNAP_TRAILER_MAGIC || trailer.chain_id != header->chain_id ||
+        trailer.seq != seq || trailer.count != header->count) {
+        if (seq) fprintf(stderr, "[NH_SNAPSHOT] Dropping incomplete delta #%u\n", seq);
+        return -1;
+    }
+    *end = trailer_pos + (off_t)sizeof(trailer);
+    return 0;
+}
+
+int nh_snapshot_peek(const char* base_path, const char* delta_path, void* meta, size_t meta_size) {
+    SnapRecordHeader header, base;
+    uint8_t newer[NH_SNAP_META_MAX];
+    off_t end;
+
+    int fd = open(base_path, O_RDONLY);
+    if (fd < 0) return -1;
+    int failed = read_record_header(fd, 0, 0, 0, &base, &end) != 0 || base.meta_size > meta_size ||
+                 lseek(fd, sizeof(base), SEEK_SET) != (off_t)sizeof(base) ||
+                 read_all(fd, meta, base.meta_size) != 0;
+    close(fd);
+    if (failed) return -1;
+    int size = (int)base.meta_size;
+
+    int dfd = open(delta_path, O_RDONLY);
+    if (dfd < 0) return size;
+    off_t pos = 0;
+    for (uint32_t seq = 1; read_record_header(dfd, pos, base.chain_id, seq, &header, &end) == 0; seq++) {
+        if (header.region_size != base.region_size || header.meta_size > meta_size) break;
+        off_t meta_pos = pos + (off_t)sizeof(header);
+        if (lseek(dfd, meta_pos, SEEK_SET) != meta_pos ||
+            read_all(dfd, newer, header.meta_size) != 0) {
+            break;
+        }
+        memcpy(meta, newer, header.meta_size);
+        size = (int)header.meta_size;
+        pos = end;
+    }
+    close(dfd);
+    return size;
+}
+
+// Read one record's pages into the heap (committing as needed) and region
+static int apply_record(int fd, off_t pos, const SnapRecordHeader* header,
+                        uint8_t* region, size_t region_size) {
+    off_t ids_pos = pos + (off_t)sizeof(*header) + header->meta_size;
+    if (lseek(fd, ids_pos, SEEK_SET) != ids_pos ||
+        read_all(fd, dirty_ids, (size_t)header->count * sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+
+    size_t need = pages_for((size_t)header->heap_used) * NH_SNAP_PAGE_SIZE;
+    for (uint32_t k = 0; k < header->count; k++) {
+        uint32_t id = dirty_ids[k];
+        if (id >= SNAP_HEAP_PAGES + pages_for(region_size)) return -1;
+        size_t end = ((size_t)id + 1) * NH_SNAP_PAGE_SIZE;
+        if (id < SNAP_HEAP_PAGES && end > need) need = end;
+    }
+    if (need > NH_HEAP_SIZE || nh_heap_commit_range(need) != 0) return -1;
+
+    for (uint32_t k = 0; k < header->count; k++) {
+        uint32_t id = dirty_ids[k];
+        size_t len;
+        uint8_t* dst = (uint8_t*)page_source(id, region, region_size, &len);
+        if (len == NH_SNAP_PAGE_SIZE) {
+            if (read_all(fd, dst, len) != 0) return -1;
+        } else {
+            if (read_all(fd, bounce, sizeof(bounce)) != 0) return -1;
+            memcpy(dst, bounce, len);
+        }
+    }
+    return 0;
+}
+
+int nh_snapshot_load(const char* base_path, const char* delta_path,
+                     uint8_t* region, size_t region_size) {
+    uint64_t start = now_ns();
+    SnapRecordHeader base, header;
+    off_t end;
+    nh_snapshot_invalidate();
+
+    int fd = open(base_path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[NH_SNAPSHOT] Cannot open %s: %s\n", base_path, strerror(errno));
+        return -1;
+    }
+    if (read_record_header(fd, 0, 0, 0, &base, &end) != 0 || base.region_size != region_size) {
+        fprintf(stderr, "[NH_SNAPSHOT] Invalid base %s\n", base_path);
+        close(fd);
+        return -1;
+    }
+
+    // From here the heap is being replaced: any failure resets it
+    if (nh_heap_prepare_load((size_t)base.heap_used) != 0 ||
+        apply_record(fd, 0, &base, region, region_size) != 0) {
+        fprintf(stderr, "[NH_SNAPSHOT] Failed to read base image\n");
+        close(fd);
+        nh_restart();
+        return -1;
+    }
+    close(fd);
+
+    size_t used = (size_t)base.heap_used;
+    uint32_t seq = 1;
+    int dfd = open(delta_path, O_RDONLY);
+    if (dfd >= 0) {
+        off_t pos = 0;
+        for (; read_record_header(dfd, pos, base.chain_id, seq, &header, &end) == 0; seq++) {
+            if (header.region_size != region_size) break;
+            if (apply_record(dfd, pos, &header, region, region_size) != 0) {
+                // The trailer was there, so this is a read error - heap is mixed
+                fprintf(stderr, "[NH_SNAPSHOT] Read error in delta #%u\n", seq);
+                close(dfd);
+                nh_restart();
+                return -1;
+            }
+            used = (size_t)header.heap_used;
+            pos = end;
+        }
+        close(dfd);
+    }
+
+    nh_heap_finish_load(used, (void*)(uintptr_t)base.heap_base);
+    fprintf(stderr, "[NH_SNAPSHOT] Loaded base + %u deltas (%zu KB heap) in %.1f ms\n",
+            seq - 1, used / 1024, (now_ns() - start) / 1e6);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * nethack_heap_snapshot.h - Incremental heap snapshots (base + deltas)
+ *
+ * A snapshot chain is a base file holding every page of the used heap and
+ * of one caller region (NetHack's globals, see ios_hibernate.h), plus an
+ * append-only delta file of the 16KB pages that changed since the
+ * previous snapshot. Each record also carries a small caller blob (the
+ * hibernation header) describing the state it completes. Autosaving after
+ * every level change or every few turns then writes only the pages the
+ * game touched.
+ *
+ * DIRTY TRACKING:
+ * - The chain keeps a 64-bit hash of every page as last written; a page
+ *   is dirty when its hash differs. Write-protecting the heap is not an
+ *   option: kernel writes into protected pages (read(2) into NetHack
+ *   buffers) fail with EFAULT instead of faulting, and game writes never
+ *   pass through the allocator, so it cannot keep a dirty map either.
+ * - Hashing reads the used heap and the region (a few MB, ~1-2ms).
+ *
+ * TWO STEPS:
+ * - nh_snapshot_stage() hashes and copies the dirty pages into a private
+ *   buffer. The heap and the region must not change while it runs (the
+ *   game thread is stopped).
+ * - nh_snapshot_commit() adds the blob, writes the record and fsyncs,
+ *   from any thread, while the game runs on.
+ *
+ * CRASH SAFETY:
+ * - Base: written to <base>.tmp, fsync'd, renamed over <base>, then the old
+ *   delta file is removed (a stale delta carries the old chain id and is
+ *   ignored)
+ * - Delta records end with a trailer; a torn last record is dropped on load
+ *   and truncated away before the next append
+ * - The delta file is compacted into a new base once it outgrows the heap
+ *
+ * THREAD SAFETY: none of its own. Calls are serialized by the caller, and
+ * stage and commit alternate (ios_hibernate.c holds its autosave mutex
+ * across both).
+ */
+
+#ifndef NETHACK_HEAP_SNAPSHOT_H
+#define NETHACK_HEAP_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NH_SNAP_PAGE_SIZE (16 * 1024)
+#define NH_SNAP_META_MAX (4 * 1024)    // Largest caller blob per record
+
+typedef struct NhSnapshot NhSnapshot;  // A staged record
+
+typedef struct {
+    uint32_t was_base;       // 1 = full base written, 0 = delta record
+    uint32_t seq;            // Delta sequence number (0 for a base)
+    size_t pages_written;
+    size_t pages_scanned;
+    size_t bytes_written;
+    uint64_t duration_ns;    // This step only (stage or commit)
+} NhSnapshotResult;
+
+// Stage what changed since the last staged snapshot: a delta, or a base
+// when there is no usable chain. *out is NULL if nothing changed.
+// Returns 0 on success, -1 if out of memory or the region is too big.
+int nh_snapshot_stage(const uint8_t* region, size_t region_size,
+                      NhSnapshot** out, NhSnapshotResult* result);
+
+// Write a staged record with its blob (up to NH_SNAP_META_MAX) and free
+// it. On failure the chain is dropped (the next stage is a base).
+// Returns 0 on success, -1 on I/O error.
+int nh_snapshot_commit(NhSnapshot* snap, const void* meta, size_t meta_size,
+                       const char* base_path, const char* delta_path, NhSnapshotResult* result);
+
+// Free a staged record without writing it (the chain is dropped)
+void nh_snapshot_drop(NhSnapshot* snap);
+
+// Copy the blob of the newest complete record into meta, without touching
+// the heap. Returns its size, or -1 if there is no usable base.
+int nh_snapshot_peek(const char* base_path, const char* delta_path,
+                     void* meta, size_t meta_size);
+
+// Load base + complete delta records into the heap, and the region pages
+// into region (a scratch buffer of the size staged). The loaded chain is
+// not continued: the next stage is a base. Returns 0 on success, -1 if
+// the base is unusable (the heap is reset if it was already overwritten).
+int nh_snapshot_load(const char* base_path, const char* delta_path,
+                     uint8_t* region, size_t region_size);
+
+// Forget the current chain (next stage is a base)
+void nh_snapshot_invalidate(void);
+
+#endif // NETHACK_HEAP_SNAPSHOT_H
@@ -1,125 +1,570 @@
 /*
- * nethack_memory_final.c - Simple static array memory allocator for NetHack iOS
+ * nethack_memory_final.c - Simple fixed-region memory allocator for NetHack iOS
  *
- * Uses a single static array with bump allocation.
- * The array ALWAYS has the same address, guaranteeing pointer validity!
+ * Uses a single reserved region: bump allocation plus size-class free lists
+ * with boundary-tag coalescing. The region base never changes while the
+ * process runs and blocks never move, guaranteeing pointer validity!
+ *
+ * The region is reserved (PROT_NONE) once and committed in 1MB steps as
+ * heap_used grows, so resident memory follows actual use instead of the
+ * 128MB worst case. Pages are given back when the bump top drops well below
+ * the committed end, and the interior pages of large free blocks are
+ * madvise()d away while they sit in a bin.
  */
 
 #include "nethack_memory_final.h"
+#include "nh_alloc_stats.h"
+#include "nh_image_codec.h"
+#include "nh_io_stats.h"
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-// THE magic array - this has a fixed address in the binary!
-uint8_t nethack_heap[NH_HEAP_SIZE] = {0};
+// THE heap region - reserved once, same address for the whole process
+uint8_t* nethack_heap = NULL;
 size_t heap_used = 0;
-static size_t allocation_count = 0;
+static size_t heap_committed = 0;    // Bytes from base that are read/write
+static size_t heap_page_size = 0;
+static uint32_t heap_generation = 0; // Bumped whenever the heap is replaced
+static size_t allocation_count = 0;  // Live allocations
+static NhAllocStats stats = { .allocator = NH_ALLOCATOR_STATIC_HEAP };
 
-// Simple block header for tracking
+/*
+ * Block layout (boundary tags). Blocks tile [nethack_heap, heap_used) with
+ * no gaps; allocated blocks never move (pointers stay valid across saves).
+ *
+ *   allocated: [header | payload ...................... ]
+ *   free:      [header | prev-free ptr | ...  | size_t size]  <- footer
+ *
+ * Invariants:
+ * - No two physically adjacent blocks are both free (free coalesces)
+ * - The block ending at heap_used is never free (it returns to the bump area)
+ * - prev_free mirrors the physically previous block's is_free; when set,
+ *   the size_t just before this header is that block's footer
+ *
+ * The header is the same 24-byte layout older snapshots used (prev_free sits
+ * in former padding), so nh_load_state() can still read them.
+ */
 typedef struct block_header {
     size_t size;               // Total size including header
     uint32_t magic;            // Magic number for integrity
     uint8_t is_free;           // 0 = allocated, 1 = free
-    uint8_t padding[3];        // Alignment
-    struct block_header* next; // Free list pointer
+    uint8_t prev_free;         // Physically previous block is free
+    uint8_t padding[2];        // Alignment
+    struct block_header* next; // Size-class bin: next free block
 } block_header;
 
 #define BLOCK_MAGIC 0xFEEDBEEF
 #define ALIGN_SIZE 16
 
-// Free list for reusing freed blocks
-static block_header* free_list_head = NULL;
+// Smallest block: header + prev-free link + footer, aligned
+#define MIN_BLOCK_SIZE 48
+
+/*
+ * Size-class bins (by total block size):
+ * - Small: one bin per 16-byte size up to 1024 (exact fit, O(1) pop)
+ * - Large: one bin per power of two above that (first fit inside the bin,
+ *   any block in a higher bin fits)
+ * A bitmap of non-empty bins finds the next usable bin in O(1).
+ */
+#define SMALL_BIN_LIMIT 1024
+#define SMALL_BINS (SMALL_BIN_LIMIT / ALIGN_SIZE + 1)   // 0..64 (0-2 unused)
+#define LARGE_BINS 18                                   // 2^10 .. 2^27+
+#define NUM_BINS (SMALL_BINS + LARGE_BINS)
+#define BIN_WORDS ((NUM_BINS + 63) / 64)
+
+static block_header* bins[NUM_BINS];
+static uint64_t bin_map[BIN_WORDS];
+static size_t bin_free_bytes = 0;    // Sum of binned block sizes
+static size_t bin_free_blocks = 0;
 
 // Align size to boundary
 static inline size_t align_up(size_t size, size_t alignment) {
     return (size + alignment - 1) & ~(alignment - 1);
 }
 
-void* nh_malloc(size_t size) {
-    if (size == 0) return NULL;
+/*
+ * Region management. Reserving with a hint keeps the base stable between
+ * launches in practice; nh_load_state() still relocates if it is not.
+ */
+#define NH_HEAP_BASE_HINT 0x280000000ULL     // Below fixed_memory.c's region
+#define NH_COMMIT_STEP (1024 * 1024)         // Commit granularity
+#define NH_DECOMMIT_SLACK (8 * 1024 * 1024)  // Committed-but-unused before trimming
+#define NH_RELEASE_MIN (64 * 1024)           // Free blocks this big drop their pages
+#define NH_MAP_ALIGN (16 * 1024)             // Image offset in "NHSAVEM" files (any page size)
+
+#ifndef MADV_FREE
+#define MADV_FREE MADV_DONTNEED
+#endif
+
+static int heap_reserve(void) {
+    if (nethack_heap) return 1;
+
+    heap_page_size = (size_t)sysconf(_SC_PAGESIZE);
+    void* addr = mmap((void*)NH_HEAP_BASE_HINT, NH_HEAP_SIZE, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "[NH_MEMORY] Cannot reserve %d MB: %s\n",
+                NH_HEAP_SIZE / (1024 * 1024), strerror(errno));
+        return 0;
+    }
+    nethack_heap = (uint8_t*)addr;
+    heap_committed = 0;
+    fprintf(stderr, "[NH_MEMORY] Reserved %d MB at %p%s\n", NH_HEAP_SIZE / (1024 * 1024),
+            addr, addr == (void*)NH_HEAP_BASE_HINT ? " (preferred base)" : "");
+    return 1;
+}
 
-    // Calculate total size with header
-    size_t total_size = align_up(sizeof(block_header) + size, ALIGN_SIZE);
+// Make [0, end) read/write
+static int heap_commit(size_t end) {
+    if (end <= heap_committed) return 1;
+    if (!nethack_heap || end > NH_HEAP_SIZE) return 0;
+
+    size_t target = align_up(end, NH_COMMIT_STEP);
+    if (target > NH_HEAP_SIZE) target = NH_HEAP_SIZE;
+    if (mprotect(nethack_heap + heap_committed, target - heap_committed,
+                 PROT_READ | PROT_WRITE) != 0) {
+        fprintf(stderr, "[NH_MEMORY] Cannot commit %zu bytes: %s\n", target, strerror(errno));
+        return 0;
+    }
+    heap_committed = target;
+    return 1;
+}
 
-    // CRITICAL FIX: Try to reuse a freed block first
-    block_header* prev = NULL;
-    block_header* current = free_list_head;
+// Drop [from, committed): replace with fresh reserved pages (zero on recommit)
+static void heap_decommit(size_t from) {
+    from = align_up(from, NH_COMMIT_STEP);
+    if (from >= heap_committed) return;
+    void* addr = mmap(nethack_heap + from, heap_committed - from, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANON | MAP_FIXED, -1, 0);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "[NH_MEMORY] Cannot decommit at %zu: %s\n", from, strerror(errno));
+        return;
+    }
+    heap_committed = from;
+}
 
-    while (current) {
-        if (current->is_free && current->size >= total_size) {
-            // Found a suitable free block - REUSE it!
+// Bump top moved down: trim committed pages once enough are unused
+static inline void heap_maybe_trim(void) {
+    if (heap_committed - heap_used > NH_DECOMMIT_SLACK) {
+        heap_decommit(heap_used + NH_DECOMMIT_SLACK / 2);
+    }
+}
 
-            // CRITICAL: Save next pointer BEFORE we modify current!
-            // Bug was: setting current->next = NULL before using it to unlink
-            // This lost the entire rest of the free list!
-            block_header* next_block = current->next;
+// Let the kernel reclaim whole pages inside a free block. Header, bin link
+// (start) and footer (end) stay resident; the payload is zeroed on reuse.
+// Returns the bytes given back.
+static size_t release_pages_inside(uint8_t* block, size_t size) {
+    uintptr_t start = align_up((uintptr_t)block + 64, heap_page_size);
+    uintptr_t end = ((uintptr_t)block + size - sizeof(size_t)) & ~(uintptr_t)(heap_page_size - 1);
+    if (end <= start) return 0;
+    madvise((void*)start, end - start, MADV_FREE);
+    return end - start;
+}
 
-            // Remove from free list FIRST (using saved next_block)
-            if (prev) {
-                prev->next = next_block;
-            } else {
-                free_list_head = next_block;
-            }
+// Binned blocks this big drop their pages right away
+static void release_free_pages(uint8_t* block, size_t size) {
+    if (size >= NH_RELEASE_MIN) release_pages_inside(block, size);
+}
+
+static inline void* payload_of(block_header* block) {
+    return (uint8_t*)block + sizeof(block_header);
+}
+
+// Free blocks keep their bin back-link in the first payload word
+static inline block_header** prev_link(block_header* block) {
+    return (block_header**)payload_of(block);
+}
+
+static inline void write_footer(block_header* block) {
+    *(size_t*)((uint8_t*)block + block->size - sizeof(size_t)) = block->size;
+}
+
+static inline block_header* next_physical(block_header* block) {
+    uint8_t* next = (uint8_t*)block + block->size;
+    return next < nethack_heap + heap_used ? (block_header*)next : NULL;
+}
 
-            // NOW mark as allocated and clear next pointer
-            current->is_free = 0;
-            current->next = NULL;
+static inline block_header* prev_physical(block_header* block) {
+    if (!block->prev_free) return NULL;
+    size_t prev_size = *(size_t*)((uint8_t*)block - sizeof(size_t));
+    return (block_header*)((uint8_t*)block - prev_size);
+}
+
+static inline unsigned bin_index(size_t total_size) {
+    if (total_size <= SMALL_BIN_LIMIT) {
+        return (unsigned)(total_size / ALIGN_SIZE);
+    }
+    unsigned log2 = 63 - (unsigned)__builtin_clzll((unsigned long long)total_size);
+    unsigned large = log2 - 10;  // 1025..2047 -> 0
+    if (large >= LARGE_BINS) large = LARGE_BINS - 1;
+    return SMALL_BINS + large;
+}
+
+static void bin_insert(block_header* block) {
+    unsigned idx = bin_index(block->size);
+    block->next = bins[idx];
+    *prev_link(block) = NULL;
+    if (bins[idx]) *prev_link(bins[idx]) = block;
+    bins[idx] = block;
+    bin_map[idx / 64] |= 1ull << (idx % 64);
+    bin_free_bytes += block->size;
+    bin_free_blocks++;
+}
+
+static void bin_remove(block_header* block) {
+    unsigned idx = bin_index(block->size);
+    block_header* prev = *prev_link(block);
+    if (prev) {
+        prev->next = block->next;
+    } else {
+        bins[idx] = block->next;
+        if (!bins[idx]) bin_map[idx / 64] &= ~(1ull << (idx % 64));
+    }
+    if (block->next) *prev_link(block->next) = prev;
+    block->next = NULL;
+    bin_free_bytes -= block->size;
+    bin_free_blocks--;
+}
 
-            // Get user pointer
-            void* user_ptr = (uint8_t*)current + sizeof(block_header);
+// First non-empty bin with index >= from, or NUM_BINS
+static unsigned next_nonempty_bin(unsigned from) {
+    for (unsigned w = from / 64; w < BIN_WORDS; w++) {
+        uint64_t bits = bin_map[w];
+        if (w == from / 64) bits &= ~0ull << (from % 64);
+        if (bits) return w * 64 + (unsigned)__builtin_ctzll(bits);
+    }
+    return NUM_BINS;
+}
 
-            // CRITICAL FIX: Clear ENTIRE block, not just requested size!
-            // BUG: If we reuse a 256-byte block for a 64-byte request,
-            // only 64 bytes were zeroed, leaving 192 bytes of STALE DATA!
-            // This caused "64 touchstones" corruption in Game 2+
-            // ROOT CAUSE: Object allocated at same address had stale quan values
-            size_t block_size = current->size - sizeof(block_header);
-            memset(user_ptr, 0, block_size);
+// Find and unlink a free block of at least total_size bytes
+static block_header* take_free_block(size_t total_size) {
+    unsigned idx = bin_index(total_size);
 
-            return user_ptr;
+    // Large bins hold mixed sizes - first fit within the request's own bin
+    if (idx >= SMALL_BINS) {
+        for (block_header* b = bins[idx]; b; b = b->next) {
+            if (b->size >= total_size) {
+                bin_remove(b);
+                return b;
+            }
         }
-        prev = current;
-        current = current->next;
+        idx++;
     }
 
-    // No free block found - bump allocate new one
-    if (heap_used + total_size > NH_HEAP_SIZE) {
-        fprintf(stderr, "[NH_MEMORY] Out of memory! Used: %zu, Requested: %zu\n",
-                heap_used, total_size);
-        return NULL;
+    // Small bins are exact; every block in a higher bin fits
+    idx = next_nonempty_bin(idx);
+    if (idx >= NUM_BINS) return NULL;
+    block_header* b = bins[idx];
+    bin_remove(b);
+    return b;
+}
+
+// Mark block free: coalesce with free neighbours, then bin it or give it back
+// to the bump area if it is the top block
+static void release_block(block_header* block) {
+    block_header* next = next_physical(block);
+    if (next && next->is_free) {
+        bin_remove(next);
+        block->size += next->size;
+        next->magic = 0;
     }
 
-    // Get pointer to new block
-    block_header* block = (block_header*)(nethack_heap + heap_used);
+    block_header* prev = prev_physical(block);
+    if (prev) {
+        bin_remove(prev);
+        prev->size += block->size;
+        block->magic = 0;
+        block = prev;
+    }
+
+    if ((uint8_t*)block + block->size == nethack_heap + heap_used) {
+        // Top block: shrink the bump pointer instead of binning
+        heap_used = (size_t)((uint8_t*)block - nethack_heap);
+        block->magic = 0;
+        heap_maybe_trim();
+        return;
+    }
+
+    block->is_free = 1;
+    write_footer(block);
+    bin_insert(block);
+    release_free_pages((uint8_t*)block, block->size);
+    next = next_physical(block);
+    if (next) next->prev_free = 1;
+}
+
+// Trim block to total_size, releasing the tail if it is big enough to stand alone
+static void split_block(block_header* block, size_t total_size) {
+    if (block->size - total_size < MIN_BLOCK_SIZE) return;
+
+    block_header* rest = (block_header*)((uint8_t*)block + total_size);
+    rest->size = block->size - total_size;
+    rest->magic = BLOCK_MAGIC;
+    rest->is_free = 0;
+    rest->prev_free = 0;  // block stays allocated
+    rest->next = NULL;
+    block->size = total_size;
+    release_block(rest);
+}
+
+static inline size_t block_size_for(size_t size) {
+    size_t total_size = align_up(sizeof(block_header) + size, ALIGN_SIZE);
+    return total_size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : total_size;
+}
+
+/*
+ * Level arena. While a level is current (nh_arena_enter_level), small
+ * requests are bump-allocated from 64KB chunks - ordinary heap blocks whose
+ * payload starts with an arena_chunk header. Freeing a sub-block only drops
+ * the chunk's live count; at zero the whole chunk is recycled in place (the
+ * current chunk) or goes back to the heap as one block (older chunks).
+ *
+ * savelev() frees the departing level's monsters/objects/traps, so its
+ * chunks empty out and return in one step each instead of releasing and
+ * coalescing hundreds of small blocks. Survivors (pets, carried objects)
+ * only pin the used part of a chunk: it is trimmed when the level changes.
+ *
+ * Chunk state lives in the heap, so chunks survive nh_save_state() and
+ * nh_load_state(); only the current-chunk pointer is process state.
+ */
+typedef struct arena_chunk {
+    uint32_t magic;      // ARENA_CHUNK_MAGIC
+    uint32_t live;       // Live sub-blocks
+    int32_t level;       // Level (ledger) the chunk was opened for
+    uint32_t reserved;
+    size_t used;         // Bump offset from chunk start
+    size_t capacity;     // Usable bytes from chunk start
+} arena_chunk;
+
+// Sub-block header: same size as block_header, magic at the same offset
+typedef struct arena_block {
+    size_t size;         // Total size including header
+    uint32_t magic;      // ARENA_BLOCK_MAGIC / ARENA_FREED_MAGIC
+    uint32_t chunk_off;  // Bytes back to the owning arena_chunk
+    uint64_t reserved;
+} arena_block;
+
+_Static_assert(sizeof(arena_block) == sizeof(block_header), "arena_block must mirror block_header");
+_Static_assert(offsetof(arena_block, magic) == offsetof(block_header, magic), "magic offsets must match");
+
+#define ARENA_CHUNK_MAGIC 0xA4E7C400
+#define ARENA_BLOCK_MAGIC 0xA4E7B10C
+#define ARENA_FREED_MAGIC 0xA4E7DEAD
+#define ARENA_CHUNK_SIZE (64 * 1024)   // Payload bytes per chunk
+#define ARENA_MAX_REQUEST 1024         // Larger requests use the heap directly
+
+static int arena_level = -1;                // -1 = arena off
+static arena_chunk* arena_current = NULL;   // Chunk being bump-allocated
+
+static inline block_header* block_of_chunk(arena_chunk* chunk) {
+    return (block_header*)((uint8_t*)chunk - sizeof(block_header));
+}
+
+static inline arena_chunk* chunk_of(arena_block* sub) {
+    return (arena_chunk*)((uint8_t*)sub - sub->chunk_off);
+}
 
-    // Initialize header
+// Take a block of total_size from the bins or the bump area (not zeroed)
+static block_header* heap_take_block(size_t total_size) {
+    block_header* block = take_free_block(total_size);
+    if (block) {
+        block->is_free = 0;
+        split_block(block, total_size);
+        block_header* next = next_physical(block);
+        if (next) next->prev_free = 0;
+        return block;
+    }
+
+    if (heap_used + total_size > NH_HEAP_SIZE || !heap_commit(heap_used + total_size)) {
+        return NULL;
+    }
+    block = (block_header*)(nethack_heap + heap_used);
     block->size = total_size;
     block->magic = BLOCK_MAGIC;
     block->is_free = 0;
+    block->prev_free = 0;  // Block below heap_used is never free
     block->next = NULL;
-
-    // Update counters
     heap_used += total_size;
+    nh_alloc_stats_note_used(&stats, heap_used);
+    return block;
+}
+
+// Return an empty chunk's block to the heap
+static void arena_release_chunk(arena_chunk* chunk) {
+    chunk->magic = 0;
+    if (allocation_count > 0) allocation_count--;
+    stats.arena_chunks--;
+    stats.arena_bytes -= block_of_chunk(chunk)->size;
+    release_block(block_of_chunk(chunk));
+}
+
+// Stop bump-allocating from chunk: free it if empty, else trim the unused tail
+static void arena_retire(arena_chunk* chunk) {
+    if (chunk->live == 0) {
+        arena_release_chunk(chunk);
+        return;
+    }
+    size_t old_size = block_of_chunk(chunk)->size;
+    split_block(block_of_chunk(chunk), block_size_for(chunk->used));
+    stats.arena_bytes -= old_size - block_of_chunk(chunk)->size;
+    chunk->capacity = block_of_chunk(chunk)->size - sizeof(block_header);
+}
+
+static arena_chunk* arena_open_chunk(void) {
+    block_header* block = heap_take_block(block_size_for(ARENA_CHUNK_SIZE));
+    if (!block) return NULL;
     allocation_count++;
+    stats.arena_chunks++;
+    stats.arena_bytes += block->size;
+
+    arena_chunk* chunk = (arena_chunk*)payload_of(block);
+    chunk->magic = ARENA_CHUNK_MAGIC;
+    chunk->live = 0;
+    chunk->level = arena_level;
+    chunk->reserved = 0;
+    chunk->used = align_up(sizeof(arena_chunk), ALIGN_SIZE);
+    chunk->capacity = block->size - sizeof(block_header);
+    return chunk;
+}
 
-    // Get user pointer
-    void* user_ptr = (uint8_t*)block + sizeof(block_header);
+static void* arena_alloc(size_t size) {
+    size_t total_size = align_up(sizeof(arena_block) + size, ALIGN_SIZE);
 
-    // CRITICAL: Clear the allocated memory to prevent garbage bytes
-    memset(user_ptr, 0, size);
+    if (!arena_current || arena_current->used + total_size > arena_current->capacity) {
+        if (arena_current) arena_retire(arena_current);
+        arena_current = arena_open_chunk();
+        if (!arena_current) return NULL;
+    }
 
+    arena_block* sub = (arena_block*)((uint8_t*)arena_current + arena_current->used);
+    sub->size = total_size;
+    sub->magic = ARENA_BLOCK_MAGIC;
+    sub->chunk_off = (uint32_t)arena_current->used;
+    sub->reserved = 0;
+    arena_current->used += total_size;
+    arena_current->live++;
+    nh_alloc_stats_on_alloc(&stats, total_size, size);
+
+    void* user_ptr = (uint8_t*)sub + sizeof(arena_block);
+    memset(user_ptr, 0, total_size - sizeof(arena_block));
     return user_ptr;
 }
 
-void* nh_calloc(size_t nmemb, size_t size) {
-    size_t total = nmemb * size;
-    void* ptr = nh_malloc(total);
-    if (ptr) {
-        memset(ptr, 0, total);
+static void arena_free(arena_block* sub) {
+    arena_chunk* chunk = chunk_of(sub);
+    if (chunk->magic != ARENA_CHUNK_MAGIC || chunk->live == 0) {
+        fprintf(stderr, "[NH_MEMORY] free: Corrupt arena chunk for %p\n", (void*)sub);
+        return;
+    }
+
+    nh_alloc_stats_on_free(&stats, sub->size);
+    sub->magic = ARENA_FREED_MAGIC;
+    if (sub->chunk_off + sub->size == chunk->used) {
+        chunk->used = sub->chunk_off;  // LIFO free: give the space back
+    }
+    if (--chunk->live > 0) return;
+
+    if (chunk == arena_current) {
+        chunk->used = align_up(sizeof(arena_chunk), ALIGN_SIZE);  // Recycle in place
+        chunk->level = arena_level;
+    } else {
+        arena_release_chunk(chunk);
+    }
+}
+
+static void* arena_realloc(arena_block* sub, void* ptr, size_t new_size) {
+    size_t total_size = align_up(sizeof(arena_block) + new_size, ALIGN_SIZE);
+    if (total_size <= sub->size) return ptr;  // Shrink: keep the slack
+
+    // Grow in place if this is the newest sub-block of the current chunk
+    arena_chunk* chunk = chunk_of(sub);
+    if (chunk == arena_current && sub->chunk_off + sub->size == chunk->used &&
+        sub->chunk_off + total_size <= chunk->capacity) {
+        memset((uint8_t*)sub + sub->size, 0, total_size - sub->size);
+        chunk->used = sub->chunk_off + total_size;
+        nh_alloc_stats_on_resize(&stats, sub->size, total_size, new_size);
+        sub->size = total_size;
+        return ptr;
+    }
+
+    void* new_ptr = nh_malloc(new_size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, sub->size - sizeof(arena_block));
+        arena_free(sub);
+    }
+    return new_ptr;
+}
+
+// Drop process-side arena state (heap itself is reset or reloaded by caller)
+static void arena_forget(void) {
+    arena_current = NULL;
+    arena_level = -1;
+}
+
+void nh_arena_enter_level(int level) {
+    if (arena_current) {
+        if (arena_current->live == 0) {
+            // Everything from the previous level was freed: reuse the chunk
+            arena_current->used = align_up(sizeof(arena_chunk), ALIGN_SIZE);
+            arena_current->level = level;
+        } else {
+            arena_retire(arena_current);
+            arena_current = NULL;
+        }
+    }
+    arena_level = level;
+    if (level < 0 && arena_current) {
+        arena_release_chunk(arena_current);
+        arena_current = NULL;
+    }
+}
+
+void* nh_malloc(size_t size) {
+    if (size == 0) return NULL;
+    if (!nethack_heap && !heap_reserve()) return NULL;
+    if (size > NH_HEAP_SIZE) {
+        fprintf(stderr, "[NH_MEMORY] Out of memory! Used: %zu, Requested: %zu\n",
+                heap_used, size);
+        return NULL;
+    }
+
+    if (arena_level >= 0 && size <= ARENA_MAX_REQUEST) {
+        void* ptr = arena_alloc(size);
+        if (ptr) return ptr;
+        // Chunk could not be opened - fall back to a plain block
+    }
+
+    size_t total_size = block_size_for(size);
+
+    // Reuse a freed block first (O(1) bin pop; split off any excess),
+    // else bump allocate a new one
+    block_header* block = heap_take_block(total_size);
+    if (!block) {
+        fprintf(stderr, "[NH_MEMORY] Out of memory! Used: %zu, Requested: %zu\n",
+                heap_used, total_size);
+        return NULL;
     }
-    return ptr;
+
+    allocation_count++;
+    nh_alloc_stats_on_alloc(&stats, block->size, size);
+
+    // CRITICAL: Clear the whole payload, not just the request - a reused
+    // block at the same address with stale data caused the "64 touchstones"
+    // corruption in Game 2+. Splitting keeps this close to the request size.
+    void* user_ptr = payload_of(block);
+    memset(user_ptr, 0, block->size - sizeof(block_header));
+
+    return user_ptr;
+}
+
+void* nh_calloc(size_t nmemb, size_t size) {
+    if (size && nmemb > SIZE_MAX / size) return NULL;
+    return nh_malloc(nmemb * size);  // nh_malloc already zero-fills
 }
 
 void* nh_realloc(void* ptr, size_t new_size) {
@@ -132,21 +577,55 @@ void* nh_realloc(void* ptr, size_t new_size) {
     // Get block header
     block_header* block = (block_header*)((uint8_t*)ptr - sizeof(block_header));
 
+    if (block->magic == ARENA_BLOCK_MAGIC) {
+        return arena_realloc((arena_block*)block, ptr, new_size);
+    }
+
     // Check magic
-    if (block->magic != BLOCK_MAGIC) {
+    if (block->magic != BLOCK_MAGIC || block->is_free) {
         fprintf(stderr, "[NH_MEMORY] realloc: Invalid magic at %p\n", ptr);
         return NULL;
     }
+    if (new_size > NH_HEAP_SIZE) return NULL;
 
-    // Get old size
-    size_t old_size = block->size - sizeof(block_header);
+    size_t total_size = block_size_for(new_size);
+    size_t old_size = block->size;
+
+    // Shrink in place
+    if (total_size <= old_size) {
+        split_block(block, total_size);
+        nh_alloc_stats_on_resize(&stats, old_size, block->size, new_size);
+        return ptr;
+    }
+
+    // Grow in place into a free neighbour or the bump area (address unchanged)
+    block_header* next = next_physical(block);
+    if (next && next->is_free && old_size + next->size >= total_size) {
+        bin_remove(next);
+        block->size += next->size;
+        next->magic = 0;
+        split_block(block, total_size);
+        block_header* after = next_physical(block);
+        if (after) after->prev_free = 0;
+        memset((uint8_t*)block + old_size, 0, block->size - old_size);
+        nh_alloc_stats_on_resize(&stats, old_size, block->size, new_size);
+        return ptr;
+    }
+    if (!next && heap_used + (total_size - old_size) <= NH_HEAP_SIZE &&
+        heap_commit(heap_used + (total_size - old_size))) {
+        heap_used += total_size - old_size;
+        block->size = total_size;
+        memset((uint8_t*)block + old_size, 0, total_size - old_size);
+        nh_alloc_stats_note_used(&stats, heap_used);
+        nh_alloc_stats_on_resize(&stats, old_size, total_size, new_size);
+        return ptr;
+    }
 
     // Allocate new block
     void* new_ptr = nh_malloc(new_size);
     if (new_ptr) {
         // Copy old data
-        size_t copy_size = (old_size < new_size) ? old_size : new_size;
-        memcpy(new_ptr, ptr, copy_size);
+        memcpy(new_ptr, ptr, old_size - sizeof(block_header));
 
         // CRITICAL FIX: Use nh_free() to properly add old block to free_list
         // Before: block->is_free = 1 leaked memory (not in free_list!)
@@ -160,7 +639,7 @@ void nh_free(void* ptr) {
     if (!ptr) return;
 
     // Check if this is our memory
-    if ((uint8_t*)ptr < nethack_heap || (uint8_t*)ptr >= nethack_heap + NH_HEAP_SIZE) {
+    if (!nethack_heap || (uint8_t*)ptr < nethack_heap || (uint8_t*)ptr >= nethack_heap + heap_used) {
         // Not our memory - might be system allocated
         // Just ignore it (or could call system free if needed)
         return;
@@ -169,66 +648,221 @@ void nh_free(void* ptr) {
     // Get block header
     block_header* block = (block_header*)((uint8_t*)ptr - sizeof(block_header));
 
+    // Arena sub-blocks only touch their chunk's live count
+    if (block->magic == ARENA_BLOCK_MAGIC) {
+        arena_free((arena_block*)block);
+        return;
+    }
+    if (block->magic == ARENA_FREED_MAGIC) {
+        fprintf(stderr, "[NH_MEMORY] free: Double free at %p (arena)\n", ptr);
+        return;
+    }
+
     // Check magic
     if (block->magic != BLOCK_MAGIC) {
         fprintf(stderr, "[NH_MEMORY] free: Invalid magic at %p\n", ptr);
         return;
     }
+    if (block->is_free) {
+        fprintf(stderr, "[NH_MEMORY] free: Double free at %p\n", ptr);
+        return;
+    }
 
-    // CRITICAL FIX: Add to free list for reuse
-    block->is_free = 1;
-    block->next = free_list_head;
-    free_list_head = block;
+    if (allocation_count > 0) allocation_count--;
+    nh_alloc_stats_on_free(&stats, block->size);
+    release_block(block);
+}
+
+size_t nh_heap_release_free_pages(void) {
+    if (!nethack_heap) return 0;
+    size_t released = 0;
+    for (unsigned idx = 0; idx < NUM_BINS; idx++) {
+        for (block_header* b = bins[idx]; b; b = b->next) {
+            if (b->size < NH_RELEASE_MIN) released += release_pages_inside((uint8_t*)b, b->size);
+        }
+    }
+    size_t committed = heap_committed;
+    heap_decommit(heap_used);
+    return released + (committed - heap_committed);
+}
+
+// Drop all bins (heap contents are reset or rebuilt by the caller)
+static void clear_bins(void) {
+    memset(bins, 0, sizeof(bins));
+    memset(bin_map, 0, sizeof(bin_map));
+    bin_free_bytes = 0;
+    bin_free_blocks = 0;
+}
+
+// Zero all statistics (new heap); the phase marker is kept
+static void stats_reset(void) {
+    uint32_t phase = stats.phase;
+    memset(&stats, 0, sizeof(stats));
+    stats.allocator = NH_ALLOCATOR_STATIC_HEAP;
+    stats.phase = phase;
+}
+
+// Recount live blocks after nh_load_state() (call counters start at zero)
+static void stats_rebuild(void) {
+    stats_reset();
+    uint8_t* scan = nethack_heap;
+    while (scan < nethack_heap + heap_used) {
+        block_header* block = (block_header*)scan;
+        scan += block->size;
+        if (block->is_free) continue;
+
+        arena_chunk* chunk = (arena_chunk*)payload_of(block);
+        if (block->size >= sizeof(block_header) + sizeof(arena_chunk) &&
+            chunk->magic == ARENA_CHUNK_MAGIC) {
+            stats.arena_chunks++;
+            stats.arena_bytes += block->size;
+            size_t off = align_up(sizeof(arena_chunk), ALIGN_SIZE);
+            while (off < chunk->used) {
+                arena_block* sub = (arena_block*)((uint8_t*)chunk + off);
+                if (sub->size == 0) break;
+                if (sub->magic == ARENA_BLOCK_MAGIC) nh_alloc_stats_on_alloc(&stats, sub->size, 0);
+                off += sub->size;
+            }
+            continue;
+        }
+        nh_alloc_stats_on_alloc(&stats, block->size, 0);
+    }
+    for (unsigned i = 0; i < NH_ALLOC_PHASES; i++) stats.phases[i].alloc_calls = 0;
+    nh_alloc_stats_note_used(&stats, heap_used);
+}
+
+void nh_memory_set_phase(int phase) {
+    stats.phase = (phase >= 0 && phase < NH_ALLOC_PHASES) ? (uint32_t)phase : 0;
+}
+
+void nh_memory_get_stats(NhAllocStats* out) {
+    if (!out) return;
+    *out = stats;
+    out->capacity = NH_HEAP_SIZE;
+    out->used_bytes = heap_used;
+    out->free_bytes = bin_free_bytes;
+    out->free_blocks = bin_free_blocks;
+
+    // Largest free block: highest non-empty bin (small bins are exact)
+    out->largest_free_block = 0;
+    for (int idx = NUM_BINS - 1; idx >= 0; idx--) {
+        if (!(bin_map[idx / 64] & (1ull << (idx % 64)))) continue;
+        for (block_header* b = bins[idx]; b; b = b->next) {
+            if (b->size > out->largest_free_block) out->largest_free_block = b->size;
+            if (idx < SMALL_BINS) break;
+        }
+        break;
+    }
+    nh_alloc_stats_finish(out);
 }
 
 void nh_restart(void) {
     fprintf(stderr, "[NH_MEMORY] Restarting - clearing %zu bytes\n", heap_used);
 
-    // Clear everything
-    memset(nethack_heap, 0, NH_HEAP_SIZE);
+    // Clear everything: dropping the committed pages zeroes them and
+    // returns them to the system (no 128MB memset touching every page)
+    if (!heap_reserve()) return;
+    heap_decommit(0);
+    heap_generation++;
     heap_used = 0;
     allocation_count = 0;
-    free_list_head = NULL;  // Clear free list
+    clear_bins();
+    arena_forget();
+    stats_reset();
 
-    fprintf(stderr, "[NH_MEMORY] Heap at %p (static array - always same address!)\n",
+    fprintf(stderr, "[NH_MEMORY] Heap at %p (reserved region - same address all session!)\n",
             (void*)nethack_heap);
 }
 
+// write(2) until done; 0 on success
+static int write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        nh_io_note_write((size_t)n);
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/*
+ * Save file header. The image that follows is:
+ * - "NHSAVEZ": an nh_image container (block-compressed)
+ * - "NHSAVEM": raw, at offset NH_MAP_ALIGN so nh_load_state can map it
+ * - "NHSAVE":  raw, right after the header (older saves)
+ */
+typedef struct {
+    char magic[8];
+    size_t used;
+    size_t count;
+    void* heap_addr;  // For verification
+} save_header;
+
 int nh_save_state(const char* filename) {
-    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    // Written aside and renamed: a previous image may still be mapped
+    // MAP_PRIVATE into the heap, and truncating it in place would change
+    // (or SIGBUS) the pages not yet copied
+    char tmp_path[1040];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
     if (fd < 0) {
         fprintf(stderr, "[NH_MEMORY] Cannot create save file: %s\n", strerror(errno));
         return -1;
     }
 
-    // Simple header
-    struct {
-        char magic[8];
-        size_t used;
-        size_t count;
-        void* heap_addr;  // For verification
-    } header = {0};
-
-    strcpy(header.magic, "NHSAVE");
+    NhImageCodec codec = nh_image_default_codec();
+    save_header header = {0};
+    strcpy(header.magic, codec != NH_IMAGE_NONE ? "NHSAVEZ" : "NHSAVEM");
     header.used = heap_used;
     header.count = allocation_count;
     header.heap_addr = nethack_heap;
 
-    write(fd, &header, sizeof(header));
-
     // Save only used portion
-    write(fd, nethack_heap, heap_used);
+    size_t image_bytes = heap_used;
+    int failed = write_all(fd, &header, sizeof(header)) != 0;
+    if (!failed && codec != NH_IMAGE_NONE) {
+        failed = nh_image_write(fd, nethack_heap, heap_used, codec, &image_bytes) != 0;
+    } else if (!failed) {
+        failed = lseek(fd, NH_MAP_ALIGN, SEEK_SET) != NH_MAP_ALIGN ||
+                 write_all(fd, nethack_heap, heap_used) != 0;
+    }
+    if (failed || nh_io_fsync(fd) != 0) {
+        fprintf(stderr, "[NH_MEMORY] Save write failed: %s\n", strerror(errno));
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
 
     close(fd);
+    if (rename(tmp_path, filename) != 0) {
+        fprintf(stderr, "[NH_MEMORY] Cannot publish save file: %s\n", strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
 
-    fprintf(stderr, "[NH_MEMORY] Saved %zu bytes (%zu allocations)\n",
-            heap_used, allocation_count);
-    fprintf(stderr, "[NH_MEMORY] Heap address: %p (will be same on load!)\n",
+    fprintf(stderr, "[NH_MEMORY] Saved %zu bytes as %zu (%s, %zu allocations)\n",
+            heap_used, image_bytes, nh_image_codec_name(codec), allocation_count);
+    fprintf(stderr, "[NH_MEMORY] Heap address: %p (relocated on load if it differs)\n",
             (void*)nethack_heap);
 
     return 0;
 }
 
+int nh_heap_commit_range(size_t end) {
+    return heap_commit(end) ? 0 : -1;
+}
+
+size_t nh_heap_committed(void) {
+    return heap_committed;
+}
+
+uint32_t nh_heap_generation(void) {
+    return heap_generation;
+}
+
 // Helper function to relocate a pointer if it points into the old heap
 static void* relocate_pointer(void* old_ptr, void* old_heap_base, void* new_heap_base, size_t heap_size) {
     if (!old_ptr) return NULL;
@@ -246,65 +880,64 @@ static void* relocate_pointer(void* old_ptr, void* old_heap_base, void* new_heap
     return old_ptr;
 }
 
-int nh_load_state(const char* filename) {
-    int fd = open(filename, O_RDONLY);
-    if (fd < 0) {
-        fprintf(stderr, "[NH_MEMORY] Cannot open save file: %s\n", strerror(errno));
-        return -1;
-    }
-
-    // Read header
-    struct {
-        char magic[8];
-        size_t used;
-        size_t count;
-        void* heap_addr;
-    } header;
+// Used by ios_hibernate: pointers in the heap into a binary that moved
+size_t nh_heap_rebase(uintptr_t old_start, size_t old_size, ptrdiff_t delta) {
+    size_t rewritten = 0;
+    if (!nethack_heap || delta == 0) return 0;
 
-    if (read(fd, &header, sizeof(header)) != sizeof(header)) {
-        fprintf(stderr, "[NH_MEMORY] Invalid save file header\n");
-        close(fd);
-        return -1;
+    for (uint8_t* scan = nethack_heap; scan < nethack_heap + heap_used;) {
+        block_header* block = (block_header*)scan;
+        if (block->magic != BLOCK_MAGIC || block->size < sizeof(block_header)) break;
+        if (!block->is_free) {
+            uintptr_t* word = (uintptr_t*)(scan + sizeof(block_header));
+            uintptr_t* end = (uintptr_t*)(scan + block->size);
+            for (; word < end; word++) {
+                if (*word - old_start < old_size) {
+                    *word += (uintptr_t)delta;
+                    rewritten++;
+                }
+            }
+        }
+        scan += block->size;
     }
+    return rewritten;
+}
 
-    // Check magic
-    if (strcmp(header.magic, "NHSAVE") != 0) {
-        fprintf(stderr, "[NH_MEMORY] Invalid save file format\n");
-        close(fd);
+// Empty the heap and commit [0, used) for an image about to be read in
+// (loaded arena chunks are no longer current; they are released as their
+// last sub-block is freed)
+int nh_heap_prepare_load(size_t used) {
+    if (!heap_reserve() || used > NH_HEAP_SIZE) {
+        fprintf(stderr, "[NH_MEMORY] Cannot load %zu bytes\n", used);
         return -1;
     }
+    heap_decommit(0);
+    heap_generation++;
+    arena_forget();
+    return heap_commit(used) ? 0 : -1;
+}
 
-    // Calculate relocation delta
-    ptrdiff_t relocation_delta = (uint8_t*)nethack_heap - (uint8_t*)header.heap_addr;
+// Rebuild allocator state for an image just read into [0, used): relocate
+// block links if the base moved, rebuild bins and counters
+void nh_heap_finish_load(size_t used, void* saved_base) {
+    ptrdiff_t relocation_delta = (uint8_t*)nethack_heap - (uint8_t*)saved_base;
     int needs_relocation = (relocation_delta != 0);
 
     if (needs_relocation) {
         fprintf(stderr, "[NH_MEMORY] Heap relocated by ASLR: %p → %p (delta=%ld bytes)\n",
-                header.heap_addr, (void*)nethack_heap, (long)relocation_delta);
+                saved_base, (void*)nethack_heap, (long)relocation_delta);
         fprintf(stderr, "[NH_MEMORY] Performing pointer relocation...\n");
     }
 
-    // Clear heap
-    memset(nethack_heap, 0, NH_HEAP_SIZE);
-
-    // Load memory content
-    if (read(fd, nethack_heap, header.used) != (ssize_t)header.used) {
-        fprintf(stderr, "[NH_MEMORY] Failed to read memory content\n");
-        close(fd);
-        return -1;
-    }
-
-    close(fd);
-
     // CRITICAL: If heap was relocated, we must fix ALL pointers in the heap!
     if (needs_relocation) {
-        fprintf(stderr, "[NH_MEMORY] Relocating pointers in %zu bytes of heap...\n", header.used);
+        fprintf(stderr, "[NH_MEMORY] Relocating pointers in %zu bytes of heap...\n", used);
 
         size_t pointers_relocated = 0;
 
         // Walk through all allocated blocks and relocate their pointers
         uint8_t* current = nethack_heap;
-        while (current < nethack_heap + header.used) {
+        while (current < nethack_heap + used) {
             block_header* block = (block_header*)current;
 
             // Validate block magic
@@ -317,7 +950,7 @@ int nh_load_state(const char* filename) {
             // Relocate the block's next pointer if it points into the heap
             if (block->next) {
                 void* old_next = block->next;
-                block->next = (block_header*)relocate_pointer(old_next, header.heap_addr,
+                block->next = (block_header*)relocate_pointer(old_next, saved_base,
                                                               nethack_heap, NH_HEAP_SIZE);
                 if (block->next != old_next) {
                     pointers_relocated++;
@@ -333,35 +966,181 @@ int nh_load_state(const char* filename) {
         fprintf(stderr, "[NH_MEMORY]          cannot be automatically relocated and may cause crashes!\n");
     }
 
-    // Restore counters
-    heap_used = header.used;
-    allocation_count = header.count;
-
-    // Rebuild free list from scratch by scanning allocated blocks
-    free_list_head = NULL;
+    // Restore counters (allocation count is recounted below)
+    heap_used = used;
+
+    // Rebuild bins from scratch by scanning blocks. Older snapshots have no
+    // footers / prev_free bits and may hold adjacent free blocks, so merge
+    // free runs and restore the boundary tags as we go. They also have free
+    // blocks below MIN_BLOCK_SIZE (32 bytes), where the bin back-link and
+    // the footer would overlap: such a run is never binned but absorbed
+    // into the allocated block before it, or kept as an allocated pad when
+    // it starts the heap.
+    clear_bins();
+    allocation_count = 0;
     uint8_t* scan = nethack_heap;
+    uint8_t* end = nethack_heap + heap_used;
+    block_header* run = NULL;  // Current free run being merged
+    block_header* last_allocated = NULL;
     size_t free_blocks = 0;
+    size_t absorbed = 0;
+    uint8_t prev_was_free = 0;
 
-    while (scan < nethack_heap + heap_used) {
+    while (scan < end) {
         block_header* block = (block_header*)scan;
 
-        if (block->magic != BLOCK_MAGIC) break;
+        if (block->magic != BLOCK_MAGIC || block->size < sizeof(block_header)) {
+            fprintf(stderr, "[NH_MEMORY] WARNING: Invalid block at offset %zu, truncating heap\n",
+                    (size_t)(scan - nethack_heap));
+            end = scan;
+            break;
+        }
+        scan += block->size;
 
         if (block->is_free) {
-            // Add to free list
-            block->next = free_list_head;
-            free_list_head = block;
+            if (run) {
+                run->size += block->size;
+                block->magic = 0;
+            } else {
+                run = block;
+                if (run->prev_free != prev_was_free) {
+                    run->prev_free = prev_was_free;  // 0: run starts after an allocated block
+                }
+            }
+            prev_was_free = 1;
+            continue;
+        }
+
+        if (run && run->size < MIN_BLOCK_SIZE) {
+            if (last_allocated) {
+                last_allocated->size += run->size;  // Slack at the end of its payload
+                run->magic = 0;
+            } else {
+                run->is_free = 0;                   // Pad at the heap start, never freed
+                run->next = NULL;
+                allocation_count++;
+                last_allocated = run;
+            }
+            absorbed++;
+            run = NULL;
+            prev_was_free = 0;
+        }
+        if (run) {
+            write_footer(run);
+            bin_insert(run);
             free_blocks++;
+            run = NULL;
         }
+        // Only store on change: a mapped image keeps untouched pages clean
+        if (block->prev_free != prev_was_free) block->prev_free = prev_was_free;
+        if (block->next) block->next = NULL;
+        prev_was_free = 0;
+        allocation_count++;
+        last_allocated = block;
+    }
 
-        scan += block->size;
+    // A trailing free run goes back to the bump area
+    if (run) {
+        end = (uint8_t*)run;
+        run->magic = 0;
     }
+    heap_used = (size_t)(end - nethack_heap);
 
-    fprintf(stderr, "[NH_MEMORY] Rebuilt free list with %zu free blocks\n", free_blocks);
+    fprintf(stderr, "[NH_MEMORY] Rebuilt bins with %zu free blocks\n", free_blocks);
+    if (absorbed) {
+        fprintf(stderr, "[NH_MEMORY] Absorbed %zu free blocks below %d bytes\n",
+                absorbed, MIN_BLOCK_SIZE);
+    }
+    stats_rebuild();
 
     fprintf(stderr, "[NH_MEMORY] Loaded %zu bytes (%zu allocations)\n",
             heap_used, allocation_count);
+}
+
+/*
+ * Map a raw image at offset in fd over [0, used) of the heap, MAP_PRIVATE:
+ * pages fault in from the file on first touch and are copied on first write,
+ * so the file stays intact. Only valid when the image was saved at this base
+ * (no relocation pass). Returns 0 if mapped.
+ */
+static int heap_map_image(int fd, off_t offset, size_t used) {
+    struct stat st;
+    if (used == 0 || fstat(fd, &st) != 0 || st.st_size < offset + (off_t)used ||
+        offset % (off_t)heap_page_size != 0) {
+        return -1;  // Short file would SIGBUS on touch
+    }
+
+    size_t length = align_up(used, heap_page_size);
+    void* addr = mmap(nethack_heap, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_FIXED, fd, offset);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "[NH_MEMORY] Cannot map image: %s\n", strerror(errno));
+        // MAP_FIXED may have dropped the old pages: restore committed memory
+        mmap(nethack_heap, length, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANON | MAP_FIXED, -1, 0);
+        return -1;
+    }
+    if (heap_committed < length) heap_committed = length;
+    return 0;
+}
 
+int nh_load_state(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[NH_MEMORY] Cannot open save file: %s\n", strerror(errno));
+        return -1;
+    }
+
+    // Read header
+    save_header header;
+    if (read(fd, &header, sizeof(header)) != sizeof(header)) {
+        fprintf(stderr, "[NH_MEMORY] Invalid save file header\n");
+        close(fd);
+        return -1;
+    }
+
+    // Check magic
+    int compressed = strcmp(header.magic, "NHSAVEZ") == 0;
+    int mappable = strcmp(header.magic, "NHSAVEM") == 0;
+    if (!compressed && !mappable && strcmp(header.magic, "NHSAVE") != 0) {
+        fprintf(stderr, "[NH_MEMORY] Invalid save file format\n");
+        close(fd);
+        return -1;
+    }
+
+    if (nh_heap_prepare_load(header.used) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Fast path: same base, raw image - map instead of reading
+    if (mappable && header.heap_addr == nethack_heap &&
+        heap_map_image(fd, NH_MAP_ALIGN, header.used) == 0) {
+        close(fd);
+        fprintf(stderr, "[NH_MEMORY] Mapped %zu byte image (pages load on demand)\n",
+                header.used);
+        nh_heap_finish_load(header.used, header.heap_addr);
+        return 0;
+    }
+
+    // Load memory content (compressed images decode straight into the heap)
+    int failed;
+    if (compressed) {
+        failed = nh_image_read(fd, nethack_heap, header.used) != 0;
+    } else {
+        failed = (mappable && lseek(fd, NH_MAP_ALIGN, SEEK_SET) != NH_MAP_ALIGN) ||
+                 read(fd, nethack_heap, header.used) != (ssize_t)header.used;
+    }
+    if (failed) {
+        fprintf(stderr, "[NH_MEMORY] Failed to read memory content\n");
+        close(fd);
+        nh_restart();
+        return -1;
+    }
+
+    close(fd);
+
+    nh_heap_finish_load(header.used, header.heap_addr);
     return 0;
 }
 
@@ -371,7 +1150,7 @@ void nh_memory_stats(size_t* used, size_t* allocations) {
 
     fprintf(stderr, "[NH_MEMORY] Stats: %zu bytes used, %zu allocations\n",
             heap_used, allocation_count);
-    fprintf(stderr, "[NH_MEMORY] Heap at %p (static array)\n", (void*)nethack_heap);
+    fprintf(stderr, "[NH_MEMORY] Heap at %p (%zu bytes committed)\n", (void*)nethack_heap, heap_committed);
 }
 
 // Get current memory usage
@@ -387,9 +1166,15 @@ void nh_reset(void) {
     // Reset counters
     heap_used = 0;
     allocation_count = 0;
+    heap_generation++;
+
+    // Clear size-class bins, arena state and statistics
+    clear_bins();
+    arena_forget();
+    stats_reset();
 
-    // Clear free list
-    free_list_head = NULL;
+    // Give back committed pages beyond the slack
+    if (nethack_heap) heap_maybe_trim();
 
     // DON'T memset the heap - let it be reused
     // The heap address stays the same, which is critical
@@ -1,8 +1,13 @@
 /*
  * nethack_memory_final.h - Simple static array memory allocator for NetHack iOS
  *
- * Uses a single static array that ALWAYS has the same address!
- * This guarantees pointer validity across saves/restarts.
+ * Uses a single reserved region whose address never changes while running.
+ * This guarantees pointer validity across saves/restarts. Pages are
+ * committed as the heap grows, so only the used part is resident.
+ *
+ * Freed blocks go to size-class bins (O(1) reuse) and coalesce with free
+ * neighbours via boundary tags; a free block at the top returns to the
+ * bump area. Allocated blocks never move.
  */
 
 #ifndef NH_MEMORY_FINAL_H
@@ -11,13 +16,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
-// 128MB heap size - reasonable size with working free list allocator
+// 128MB reserved heap size - reasonable size with size-class free lists
 // Previous bugs (linked list corruption, realloc leak, tile reuse, dispatch throttle) are now fixed
 // Memory now properly reuses freed blocks instead of only growing
 #define NH_HEAP_SIZE (128 * 1024 * 1024)
 
-// Global array - ALWAYS has the same address!
-extern uint8_t nethack_heap[NH_HEAP_SIZE];
+// Heap base - reserved on first use, same address for the whole process
+// (NULL until the first allocation / nh_restart)
+extern uint8_t* nethack_heap;
 extern size_t heap_used;
 
 // Our allocation functions
@@ -26,9 +32,40 @@ void nh_free(void* ptr);
 void* nh_calloc(size_t nmemb, size_t size);
 void* nh_realloc(void* ptr, size_t size);
 void nh_restart(void);
+
+// Heap image files. Compressed with nh_image_default_codec(); with
+// NH_IMAGE_NONE the raw image is page-aligned and nh_load_state maps it
+// copy-on-write instead of reading it when the saved base matches.
 int nh_save_state(const char* filename);
 int nh_load_state(const char* filename);
 
+// Level arena: small allocations made while a level is current are grouped
+// into chunks that return to the heap as a unit once their contents are
+// freed. Called on level change (goto_level, ios_level_arena.patch) with the
+// new level's ledger number; a negative level turns the arena off.
+void nh_arena_enter_level(int level);
+
+// Image loading (nh_load_state, nh_snapshot_load): prepare empties
+// the heap and commits [0, used); read the image, then finish rebuilds bins,
+// counters and relocates block links if saved_base differs
+int nh_heap_prepare_load(size_t used);
+void nh_heap_finish_load(size_t used, void* saved_base);
+int nh_heap_commit_range(size_t end);   // Grow the committed prefix to end
+size_t nh_heap_committed(void);
+uint32_t nh_heap_generation(void);   // Changes on restart/reset/load
+
+// Memory pressure: give back the whole pages inside every free block (large
+// ones already did when freed) and every committed page above heap_used.
+// Returns the bytes released. Game thread, like every other call here.
+size_t nh_heap_release_free_pages(void);
+
+// Rebase: add delta to every aligned word in the live blocks whose value
+// falls in [old_start, old_start + old_size) - pointers into a binary image
+// that loaded at another address than when the heap image was taken. Only
+// matching words are written, so a mapped image stays clean elsewhere.
+// Returns the words rewritten.
+size_t nh_heap_rebase(uintptr_t old_start, size_t old_size, ptrdiff_t delta);
+
 // Debug functions
 void nh_memory_stats(size_t* used, size_t* allocations);
 
@@ -6,6 +6,8 @@
 
 #include "nethack_memory_final.h"
 #include "nethack_zone.h"  // For ZoneType
+#include "nh_alloc_stats.h"
+#include "nh_alloc_trace.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -31,6 +33,7 @@ long* alloc(unsigned int lth) {
         panic("alloc: out of memory");
     }
 
+    nh_alloc_trace_record(NH_TRACE_ALLOC, ptr, NULL, lth);
     return (long*)ptr;
 }
 
@@ -44,6 +47,7 @@ long* re_alloc(long* oldptr, unsigned int newlth) {
         return result;
     }
     if (newlth == 0) {
+        nh_alloc_trace_record(NH_TRACE_FREE, oldptr, NULL, 0);
         nh_free(oldptr);
         return NULL;
     }
@@ -54,16 +58,18 @@ long* re_alloc(long* oldptr, unsigned int newlth) {
         panic("re_alloc: out of memory");
     }
 
+    nh_alloc_trace_record(NH_TRACE_REALLOC, newptr, oldptr, newlth);
     return (long*)newptr;
 }
 
 void zone_free(void* ptr) {
+    if (ptr) nh_alloc_trace_record(NH_TRACE_FREE, ptr, NULL, 0);
     nh_free(ptr);
 }
 
 // For compatibility
 void dealloc(void* ptr) {
-    nh_free(ptr);
+    zone_free(ptr);
 }
 
 char* dupstr(const char* string) {
@@ -73,6 +79,7 @@ char* dupstr(const char* string) {
     char* newstr = (char*)nh_malloc(len);
 
     if (newstr) {
+        nh_alloc_trace_record(NH_TRACE_ALLOC, newstr, NULL, len);
         memcpy(newstr, string, len);
     } else {
         panic("dupstr: out of memory");
@@ -118,8 +125,8 @@ void nethack_zone_restart(void) {
 }
 
 void nethack_zone_shutdown(void) {
-    // Nothing to shutdown with static array
-    fprintf(stderr, "[STATIC_ALLOC] Shutdown called (no-op for static array)\n");
+    // The reservation lives for the whole process (nh_restart() reuses it)
+    fprintf(stderr, "[STATIC_ALLOC] Shutdown called (no-op, heap stays reserved)\n");
 }
 
 void nethack_zone_stats(size_t* bytes_allocated, size_t* num_allocations) {
@@ -131,12 +138,19 @@ void nethack_zone_print_stats(void) {
     nh_memory_stats(&bytes, &allocations);
     fprintf(stderr, "[STATIC_ALLOC] Stats: %zu bytes used, %zu allocations\n",
             bytes, allocations);
-    fprintf(stderr, "[STATIC_ALLOC] Heap at %p (static array)\n", (void*)nethack_heap);
+    fprintf(stderr, "[STATIC_ALLOC] Heap at %p (%d MB reserved, %zu KB committed)\n",
+            (void*)nethack_heap, NH_HEAP_SIZE / (1024 * 1024), nh_heap_committed() / 1024);
 }
 
 void nethack_zone_switch(ZoneType type) {
-    // No-op for static allocator - we don't have separate zones
-    fprintf(stderr, "[STATIC_ALLOC] Zone switch to type %d (no-op)\n", type);
+    // No separate zones with the static array - only tag the stats phase
+    fprintf(stderr, "[STATIC_ALLOC] Zone switch to type %d (stats phase only)\n", type);
+    nh_memory_set_phase((int)type);
+    nh_alloc_trace_record(NH_TRACE_PHASE, NULL, NULL, (size_t)type);
+}
+
+void nethack_zone_get_stats(NhAllocStats* out) {
+    nh_memory_get_stats(out);
 }
 
 void nethack_zone_get_metadata(char* buffer, size_t bufsize) {
@@ -158,7 +172,8 @@ int nethack_zone_snapshot_save(const char* filepath) {
 void nethack_memory_init(void) {
     nh_restart();
     fprintf(stderr, "[STATIC_ALLOC] NetHack memory initialized\n");
-    fprintf(stderr, "[STATIC_ALLOC] Static heap at %p (100MB)\n", (void*)nethack_heap);
+    fprintf(stderr, "[STATIC_ALLOC] Heap at %p (%d MB reserved, committed on demand)\n",
+            (void*)nethack_heap, NH_HEAP_SIZE / (1024 * 1024));
 }
 
 void nethack_memory_shutdown(void) {
@@ -196,7 +211,7 @@ long* nhrealloc(long* oldptr, unsigned int newlth, const char* file, int line) {
 }
 
 void nhfree(void* ptr, const char* file, int line) {
-    nh_free(ptr);
+    zone_free(ptr);
 }
 
 char* nhdupstr(const char* string, const char* file, int line) {
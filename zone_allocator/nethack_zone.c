@@ -17,6 +17,7 @@
 #define EXTERN_H  // Prevent duplicate declarations
 #include "../NetHack/include/hack.h"
 #include "nethack_zone.h"  // Include our header for ZoneType
+#include "nh_alloc_stats.h"
 
 // Forward declarations that NetHack expects
 long *alloc(unsigned int) NONNULL;
@@ -42,15 +43,24 @@ static ZoneType current_zone_type = ZONE_TYPE_CHARACTER_CREATION;
 // Statistics tracking
 static size_t total_allocated = 0;
 static size_t allocation_count = 0;
+static NhAllocStats zone_stats = { .allocator = NH_ALLOCATOR_MALLOC_ZONE };
 
 // Allocation tracking for iOS snapshots
-typedef struct allocation_node {
-    void* ptr;
+// Open-addressing hash table (linear probing, backward-shift delete) keyed
+// by pointer. The slot array is the only storage - one calloc per resize,
+// no per-allocation node - so track/untrack are O(1) on average.
+typedef struct allocation_record {
+    void* ptr;      // NULL = empty slot
     size_t size;
-    struct allocation_node* next;
-} allocation_node;
+} allocation_record;
 
-static allocation_node* allocation_list = NULL;
+#define TRACK_INITIAL_CAPACITY 4096   // Power of 2
+#define TRACK_MAX_LOAD_NUM 7          // Grow above 70% load
+#define TRACK_MAX_LOAD_DEN 10
+
+static allocation_record* track_slots = NULL;
+static size_t track_capacity = 0;     // Power of 2 (0 = not allocated)
+static size_t track_count = 0;
 
 // Forward declarations for internal zone functions
 static long* zone_alloc(unsigned int lth);
@@ -124,42 +134,105 @@ char* dupstr(const char* string) {
     return zone_dupstr(string);
 }
 
+// Helper: Slot for pointer hash (low bits are alignment - mix them out)
+static inline size_t track_slot_for(const void* ptr) {
+    uint64_t h = (uint64_t)(uintptr_t)ptr;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (size_t)h & (track_capacity - 1);
+}
+
+// Helper: Insert without resizing (slot array has room)
+static void track_insert_slot(void* ptr, size_t size) {
+    size_t i = track_slot_for(ptr);
+    while (track_slots[i].ptr && track_slots[i].ptr != ptr) {
+        i = (i + 1) & (track_capacity - 1);
+    }
+    if (!track_slots[i].ptr) track_count++;
+    track_slots[i].ptr = ptr;
+    track_slots[i].size = size;
+}
+
+// Helper: Grow slot array to new_capacity and rehash
+static int track_resize(size_t new_capacity) {
+    allocation_record* old_slots = track_slots;
+    size_t old_capacity = track_capacity;
+
+    allocation_record* slots = (allocation_record*)calloc(new_capacity, sizeof(allocation_record));
+    if (!slots) return 0;
+
+    track_slots = slots;
+    track_capacity = new_capacity;
+    track_count = 0;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].ptr) track_insert_slot(old_slots[i].ptr, old_slots[i].size);
+    }
+    free(old_slots);
+    ZONE_LOG("Tracking table resized to %zu slots (%zu live)", new_capacity, track_count);
+    return 1;
+}
+
 // Helper: Track allocation for iOS snapshots
 static void track_allocation(void* ptr, size_t size) {
     if (!ptr) return;
 
-    allocation_node* node = (allocation_node*)malloc(sizeof(allocation_node));
-    if (!node) return;  // Silent fail, tracking is optional
-
-    node->ptr = ptr;
-    node->size = size;
-    node->next = allocation_list;
-    allocation_list = node;
+    if ((track_count + 1) * TRACK_MAX_LOAD_DEN > track_capacity * TRACK_MAX_LOAD_NUM) {
+        size_t grow = track_capacity ? track_capacity * 2 : TRACK_INITIAL_CAPACITY;
+        if (!track_resize(grow)) return;  // Silent fail, tracking is optional
+    }
+    size_t before = track_count;
+    track_insert_slot(ptr, size);
+    if (track_count != before) nh_alloc_stats_on_alloc(&zone_stats, size, size);
 }
 
 // Helper: Remove allocation from tracking
 static void untrack_allocation(void* ptr) {
-    if (!ptr) return;
+    if (!ptr || !track_capacity) return;
 
-    allocation_node** current = &allocation_list;
-    while (*current) {
-        if ((*current)->ptr == ptr) {
-            allocation_node* to_remove = *current;
-            *current = (*current)->next;
-            free(to_remove);
-            return;
+    size_t mask = track_capacity - 1;
+    size_t i = track_slot_for(ptr);
+    while (track_slots[i].ptr != ptr) {
+        if (!track_slots[i].ptr) return;  // Not tracked
+        i = (i + 1) & mask;
+    }
+
+    size_t freed_size = track_slots[i].size;
+
+    // Backward-shift delete: pull later entries of the probe run into the
+    // hole so lookups never need tombstones
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; track_slots[j].ptr; j = (j + 1) & mask) {
+        size_t home = track_slot_for(track_slots[j].ptr);
+        // Entry at j may move to hole if its home is not in (hole, j]
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            track_slots[hole] = track_slots[j];
+            hole = j;
         }
-        current = &(*current)->next;
     }
+    nh_alloc_stats_on_free(&zone_stats, freed_size);
+    track_slots[hole].ptr = NULL;
+    track_slots[hole].size = 0;
+    track_count--;
 }
 
-// Helper: Clear all allocation tracking
+// Helper: Clear all allocation tracking (keeps the slot array for reuse)
 static void clear_allocation_tracking(void) {
-    while (allocation_list) {
-        allocation_node* next = allocation_list->next;
-        free(allocation_list);
-        allocation_list = next;
-    }
+    if (track_slots) memset(track_slots, 0, track_capacity * sizeof(allocation_record));
+    track_count = 0;
+
+    // New zone: live figures restart, phase counters and peaks are kept
+    zone_stats.live_bytes = 0;
+    zone_stats.live_allocations = 0;
+    memset(zone_stats.size_class_live, 0, sizeof(zone_stats.size_class_live));
+}
+
+// Helper: Release the slot array entirely
+static void release_allocation_tracking(void) {
+    free(track_slots);
+    track_slots = NULL;
+    track_capacity = 0;
+    track_count = 0;
 }
 
 // Zone-based allocation functions that replace NetHack's alloc()
@@ -201,6 +274,10 @@ static long* zone_realloc(long* oldptr, unsigned int newlth) {
         panic("Memory allocation failure; cannot extend to %u bytes", newlth);
     }
 
+    // Keep snapshot tracking pointing at the live block and its new size
+    if (newptr != oldptr) untrack_allocation(oldptr);
+    if (newptr) track_allocation(newptr, newlth);
+
     ZONE_LOG("Reallocated %p to %u bytes at %p", oldptr, newlth, newptr);
 
     return (long*)newptr;
@@ -259,6 +336,7 @@ void nethack_zone_switch(ZoneType type) {
              type == ZONE_TYPE_CHARACTER_CREATION ? "CHARACTER_CREATION" : "GAME");
 
     current_zone_type = type;
+    zone_stats.phase = (uint32_t)type;
 
     switch (type) {
         case ZONE_TYPE_CHARACTER_CREATION:
@@ -326,8 +404,8 @@ void nethack_zone_restart(void) {
 void nethack_zone_shutdown(void) {
     ZONE_LOG("=== ZONE SHUTDOWN BEGIN ===");
 
-    // Clear allocation tracking
-    clear_allocation_tracking();
+    // Release allocation tracking
+    release_allocation_tracking();
 
     if (nethack_zone) {
         malloc_destroy_zone(nethack_zone);
@@ -361,6 +439,27 @@ void nethack_zone_stats(size_t* bytes_allocated, size_t* num_allocations) {
     if (num_allocations) *num_allocations = allocation_count;
 }
 
+// Detailed statistics. malloc_zone keeps its own free lists, so the free
+// space is only known in aggregate (allocated - in use).
+void nethack_zone_get_stats(NhAllocStats* out) {
+    if (!out) return;
+    *out = zone_stats;
+    out->capacity = 0;
+
+    // Read-only: the zone's footprint is only known when asked, so its
+    // high-water mark is the live-bytes peak kept on the alloc path (a
+    // lower bound) or the footprint now, whichever is larger
+    out->peak_used_bytes = zone_stats.peak_live_bytes;
+    if (nethack_zone) {
+        malloc_statistics_t ms = {0};
+        malloc_zone_statistics(nethack_zone, &ms);
+        out->used_bytes = ms.size_allocated;
+        if (ms.size_allocated > out->peak_used_bytes) out->peak_used_bytes = ms.size_allocated;
+        out->free_bytes = ms.size_allocated > ms.size_in_use ? ms.size_allocated - ms.size_in_use : 0;
+    }
+    out->fragmentation = 0.0;  // Largest hole unknown - not measurable here
+}
+
 // Print detailed zone statistics (for debugging)
 void nethack_zone_print_stats(void) {
     if (!nethack_zone) {
@@ -514,26 +613,22 @@ int nethack_zone_snapshot_save(const char* filepath) {
     fwrite(magic, 1, 8, file);
 
     // Count allocations
-    size_t block_count = 0;
+    size_t block_count = track_count;
     size_t total_size = 0;
-    allocation_node* node = allocation_list;
-    while (node) {
-        block_count++;
-        total_size += node->size;
-        node = node->next;
+    for (size_t i = 0; i < track_capacity; i++) {
+        if (track_slots[i].ptr) total_size += track_slots[i].size;
     }
 
     // Write metadata
     fwrite(&block_count, sizeof(size_t), 1, file);
     fwrite(&total_size, sizeof(size_t), 1, file);
 
-    // Write all allocations
-    node = allocation_list;
-    while (node) {
+    // Write all allocations (slot order)
+    for (size_t i = 0; i < track_capacity; i++) {
+        if (!track_slots[i].ptr) continue;
         // Write size and data
-        fwrite(&node->size, sizeof(size_t), 1, file);
-        fwrite(node->ptr, node->size, 1, file);
-        node = node->next;
+        fwrite(&track_slots[i].size, sizeof(size_t), 1, file);
+        fwrite(track_slots[i].ptr, track_slots[i].size, 1, file);
     }
 
     fclose(file);
@@ -0,0 +1,118 @@
+/*
+ * nh_alloc_stats.h - Shared statistics record for the NetHack allocators
+ *
+ * Each allocator (nethack_memory_final.c, nethack_zone.c, fixed_memory.c)
+ * keeps one NhAllocStats up to date on every alloc/free (a few adds), and
+ * fills the free-space fields on query from its free lists. Polling is cheap
+ * enough to do every few seconds from Swift.
+ *
+ * Sizes are block sizes (request + header, aligned) unless noted.
+ */
+
+#ifndef NH_ALLOC_STATS_H
+#define NH_ALLOC_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Size classes: class i holds blocks of [2^(i+4), 2^(i+5)) bytes, the first
+// class also everything smaller, the last everything larger (<32B .. >=512KB)
+#define NH_ALLOC_SIZE_CLASSES 16
+
+// Phases, indexed by ZoneType (nethack_zone.h)
+#define NH_ALLOC_PHASES 2
+
+typedef enum {
+    NH_ALLOCATOR_STATIC_HEAP = 0,  // nethack_memory_final.c
+    NH_ALLOCATOR_MALLOC_ZONE,      // nethack_zone.c
+    NH_ALLOCATOR_FIXED_REGION      // fixed_memory.c
+} NhAllocatorKind;
+
+typedef struct {
+    uint64_t alloc_calls;
+    uint64_t free_calls;
+    uint64_t bytes_requested;      // Sum of request sizes
+    size_t peak_live_bytes;        // High-water mark while in this phase
+} NhAllocPhaseStats;
+
+typedef struct {
+    uint32_t allocator;            // NhAllocatorKind
+    uint32_t phase;                // Current phase (ZoneType)
+
+    size_t capacity;               // Reserved region size (0 = unbounded)
+    size_t used_bytes;             // Region in use incl. free holes (bump top)
+    size_t peak_used_bytes;
+
+    size_t live_bytes;             // Blocks handed out
+    size_t live_allocations;
+    size_t peak_live_bytes;
+
+    size_t free_bytes;             // Free holes below used_bytes
+    size_t free_blocks;            // Free-list length
+    size_t largest_free_block;
+    double fragmentation;          // 1 - largest_free / free_bytes (0 = none)
+
+    size_t arena_chunks;           // Level arena chunks (static heap only)
+    size_t arena_bytes;
+
+    uint32_t size_class_live[NH_ALLOC_SIZE_CLASSES];  // Live blocks per class
+    NhAllocPhaseStats phases[NH_ALLOC_PHASES];
+} NhAllocStats;
+
+static inline unsigned nh_alloc_size_class(size_t block_size) {
+    if (block_size < 32) return 0;
+    unsigned log2 = 63 - (unsigned)__builtin_clzll((unsigned long long)block_size);
+    return log2 - 4 < NH_ALLOC_SIZE_CLASSES ? log2 - 4 : NH_ALLOC_SIZE_CLASSES - 1;
+}
+
+// Incremental bookkeeping shared by the allocators
+static inline void nh_alloc_stats_on_alloc(NhAllocStats* s, size_t block_size, size_t request) {
+    NhAllocPhaseStats* p = &s->phases[s->phase < NH_ALLOC_PHASES ? s->phase : 0];
+    s->live_bytes += block_size;
+    s->live_allocations++;
+    s->size_class_live[nh_alloc_size_class(block_size)]++;
+    if (s->live_bytes > s->peak_live_bytes) s->peak_live_bytes = s->live_bytes;
+    if (s->live_bytes > p->peak_live_bytes) p->peak_live_bytes = s->live_bytes;
+    p->alloc_calls++;
+    p->bytes_requested += request;
+}
+
+static inline void nh_alloc_stats_on_free(NhAllocStats* s, size_t block_size) {
+    unsigned c = nh_alloc_size_class(block_size);
+    s->live_bytes = s->live_bytes > block_size ? s->live_bytes - block_size : 0;
+    if (s->live_allocations > 0) s->live_allocations--;
+    if (s->size_class_live[c] > 0) s->size_class_live[c]--;
+    s->phases[s->phase < NH_ALLOC_PHASES ? s->phase : 0].free_calls++;
+}
+
+// Block resized in place (realloc)
+static inline void nh_alloc_stats_on_resize(NhAllocStats* s, size_t old_size, size_t new_size, size_t request) {
+    nh_alloc_stats_on_free(s, old_size);
+    nh_alloc_stats_on_alloc(s, new_size, request);
+    // A resize is one call, not a free + alloc
+    NhAllocPhaseStats* p = &s->phases[s->phase < NH_ALLOC_PHASES ? s->phase : 0];
+    p->free_calls--;
+}
+
+static inline void nh_alloc_stats_note_used(NhAllocStats* s, size_t used) {
+    s->used_bytes = used;
+    if (used > s->peak_used_bytes) s->peak_used_bytes = used;
+}
+
+static inline void nh_alloc_stats_finish(NhAllocStats* s) {
+    s->fragmentation = s->free_bytes
+        ? 1.0 - (double)s->largest_free_block / (double)s->free_bytes : 0.0;
+}
+
+// Active NetHack allocator (static heap in the dylib build; exported for Swift)
+#include "../src/nethack_export.h"
+NETHACK_EXPORT void nethack_zone_get_stats(NhAllocStats* out);
+
+// Per-allocator queries
+void nh_memory_get_stats(NhAllocStats* out);
+void fixed_memory_get_stats(NhAllocStats* out);
+
+// Static heap phase marker (nethack_zone_switch)
+void nh_memory_set_phase(int phase);
+
+#endif // NH_ALLOC_STATS_H
@@ -0,0 +1,122 @@
+/*
+ * nh_alloc_trace.c - Buffered allocation trace writer (see nh_alloc_trace.h)
+ *
+ * Records collect in a 64KB buffer that is written out when full, so
+ * tracing costs a clock read and a copy per call. A 50k-turn game makes a
+ * few GB of trace; the bench reads it back in one pass.
+ */
+
+#include "nh_alloc_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#define TRACE_BUFFER_RECORDS 2048
+
+int nh_alloc_tracing = 0;
+
+static int trace_fd = -1;
+static uint64_t trace_start_ns = 0;
+static uint64_t trace_records = 0;
+static uint16_t trace_phase = 0;
+static size_t buffered = 0;
+static NhAllocTraceRecord buffer[TRACE_BUFFER_RECORDS];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void flush_buffer(void) {
+    if (buffered == 0) return;
+    if (write_all(trace_fd, buffer, buffered * sizeof(NhAllocTraceRecord)) != 0) {
+        // Disk full or similar: stop rather than leave gaps in the trace
+        fprintf(stderr, "[ALLOC_TRACE] Write failed (%s), tracing stopped\n", strerror(errno));
+        nh_alloc_tracing = 0;
+    }
+    buffered = 0;
+}
+
+void nh_alloc_trace_record_slow(NhAllocTraceOp op, const void* ptr, const void* old_ptr, size_t size) {
+    if (op == NH_TRACE_PHASE) trace_phase = (uint16_t)size;
+
+    NhAllocTraceRecord* r = &buffer[buffered++];
+    r->time_ns = now_ns() - trace_start_ns;
+    r->ptr = (uint64_t)(uintptr_t)ptr;
+    r->old_ptr = (uint64_t)(uintptr_t)old_ptr;
+    r->size = size > UINT32_MAX ? UINT32_MAX : (uint32_t)size;
+    r->op = (uint16_t)op;
+    r->phase = trace_phase;
+    trace_records++;
+
+    if (buffered == TRACE_BUFFER_RECORDS) flush_buffer();
+}
+
+NETHACK_EXPORT int nethack_alloc_trace_begin(const char* path) {
+    if (trace_fd >= 0) nethack_alloc_trace_end();
+
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (trace_fd < 0) {
+        fprintf(stderr, "[ALLOC_TRACE] Cannot create %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    NhAllocTraceHeader header = {0};
+    strcpy(header.magic, NH_ALLOC_TRACE_MAGIC);
+    header.version = NH_ALLOC_TRACE_VERSION;
+    header.record_size = sizeof(NhAllocTraceRecord);
+    header.start_ns = trace_start_ns = now_ns();
+    if (write_all(trace_fd, &header, sizeof(header)) != 0) {
+        close(trace_fd);
+        trace_fd = -1;
+        return -1;
+    }
+
+    trace_records = 0;
+    buffered = 0;
+    nh_alloc_tracing = 1;
+    fprintf(stderr, "[ALLOC_TRACE] Tracing allocations to %s\n", path);
+    return 0;
+}
+
+NETHACK_EXPORT uint64_t nethack_alloc_trace_end(void) {
+    if (trace_fd < 0) return 0;
+
+    if (nh_alloc_tracing) flush_buffer();
+    nh_alloc_tracing = 0;
+    close(trace_fd);
+    trace_fd = -1;
+    fprintf(stderr, "[ALLOC_TRACE] Trace closed: %llu records\n",
+            (unsigned long long)trace_records);
+    return trace_records;
+}
+
+static void trace_at_exit(void) {
+    nethack_alloc_trace_end();
+}
+
+// NETHACK_ALLOC_TRACE=<path>: trace from dylib load (bot runs, CI)
+__attribute__((constructor))
+static void trace_from_environment(void) {
+    const char* path = getenv("NETHACK_ALLOC_TRACE");
+    if (path && *path && nethack_alloc_trace_begin(path) == 0) {
+        atexit(trace_at_exit);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * nh_alloc_trace.h - Allocation trace recording for allocator benchmarks
+ *
+ * When tracing is on, every alloc/re_alloc/zone_free/dupstr call through
+ * nethack_static_alloc.c appends one fixed-size record (op, size, pointer,
+ * timestamp) to a trace file. bench/alloc_trace_bench.c replays a trace
+ * against each allocator so changes can be judged on real game workloads.
+ *
+ * Off by default: the hooks cost one predictable branch. Start with
+ * nethack_alloc_trace_begin() or by setting NETHACK_ALLOC_TRACE=<path>
+ * before the dylib loads. Game thread only (same as the allocator).
+ *
+ * File: [NhAllocTraceHeader] [NhAllocTraceRecord]*  (native byte order)
+ */
+
+#ifndef NH_ALLOC_TRACE_H
+#define NH_ALLOC_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../src/nethack_export.h"
+
+#define NH_ALLOC_TRACE_MAGIC "NHATRC1"
+#define NH_ALLOC_TRACE_VERSION 1
+
+typedef enum {
+    NH_TRACE_ALLOC = 1,      // ptr = result, size = request
+    NH_TRACE_REALLOC = 2,    // old_ptr -> ptr, size = new request
+    NH_TRACE_FREE = 3,       // ptr freed
+    NH_TRACE_PHASE = 4       // Zone switch: size = new ZoneType
+} NhAllocTraceOp;
+
+typedef struct {
+    char magic[8];           // NH_ALLOC_TRACE_MAGIC
+    uint32_t version;
+    uint32_t record_size;    // sizeof(NhAllocTraceRecord)
+    uint64_t start_ns;       // CLOCK_MONOTONIC at begin
+} NhAllocTraceHeader;
+
+typedef struct {
+    uint64_t time_ns;        // Since start_ns
+    uint64_t ptr;
+    uint64_t old_ptr;
+    uint32_t size;
+    uint16_t op;             // NhAllocTraceOp
+    uint16_t phase;          // ZoneType at the time of the call
+} NhAllocTraceRecord;
+
+extern int nh_alloc_tracing;
+
+void nh_alloc_trace_record_slow(NhAllocTraceOp op, const void* ptr, const void* old_ptr, size_t size);
+
+static inline void nh_alloc_trace_record(NhAllocTraceOp op, const void* ptr, const void* old_ptr, size_t size) {
+    if (__builtin_expect(nh_alloc_tracing, 0)) {
+        nh_alloc_trace_record_slow(op, ptr, old_ptr, size);
+    }
+}
+
+// Start tracing to path (truncates). Returns 0 on success.
+NETHACK_EXPORT int nethack_alloc_trace_begin(const char* path);
+
+// Flush and close the trace; returns records written
+NETHACK_EXPORT uint64_t nethack_alloc_trace_end(void);
+
+#endif // NH_ALLOC_TRACE_H
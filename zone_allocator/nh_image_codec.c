@@ -0,0 +1,299 @@
+/*
+ * nh_image_codec.c - Block-compressed heap image container (see nh_image_codec.h)
+ *
+ * Container: [ImageHeader] { [BlockHeader][stored_len payload bytes] } x block_count
+ *
+ * Compression uses libcompression's one-shot buffer API per block; the
+ * encoder is given a destination one byte smaller than the block, so a
+ * block that does not shrink fails to encode and is stored instead.
+ * Without libcompression (non-Apple builds) only ZERO/STORED blocks are
+ * written and PACKED blocks cannot be read.
+ */
+
+#include "nh_image_codec.h"
+#include "nh_io_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifdef __APPLE__
+#include <compression.h>
+#define HAVE_LIBCOMPRESSION 1
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#define IMAGE_VERSION 1
+#define IMAGE_MAX_BLOCK (4 * 1024 * 1024)   // Largest block_size a reader accepts
+
+typedef struct {
+    char magic[8];           // "NHIMGZ"
+    uint32_t version;
+    uint32_t codec;          // NhImageCodec of PACKED blocks
+    uint64_t raw_len;
+    uint32_t block_size;
+    uint32_t block_count;
+} ImageHeader;
+
+enum { BLOCK_ZERO = 0, BLOCK_STORED = 1, BLOCK_PACKED = 2 };
+
+typedef struct {
+    uint32_t raw_len;
+    uint32_t stored_len;     // Payload bytes following this header
+    uint32_t kind;           // BLOCK_*
+    uint32_t crc;            // CRC32C of the raw bytes
+} BlockHeader;
+
+static NhImageCodec default_codec = NH_IMAGE_LZ4;
+
+NhImageCodec nh_image_default_codec(void) {
+    return default_codec;
+}
+
+void nh_image_set_default_codec(NhImageCodec codec) {
+    default_codec = codec;
+}
+
+const char* nh_image_codec_name(NhImageCodec codec) {
+    switch (codec) {
+        case NH_IMAGE_NONE: return "none";
+        case NH_IMAGE_LZ4: return "lz4";
+        case NH_IMAGE_LZFSE: return "lzfse";
+    }
+    return "?";
+}
+
+// CRC32C (Castagnoli): hardware instructions where available
+#if defined(__ARM_FEATURE_CRC32)
+static uint32_t crc32c(const uint8_t* p, size_t n) {
+    uint32_t crc = ~0u;
+    while (n >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = __crc32cb(crc, *p++);
+    return ~crc;
+}
+#else
+static uint32_t crc_table[256];
+
+static uint32_t crc32c(const uint8_t* p, size_t n) {
+    if (!crc_table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            crc_table[i] = c;
+        }
+    }
+    uint32_t crc = ~0u;
+    while (n--) crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+#endif
+
+static int is_zero(const uint8_t* p, size_t n) {
+    uint64_t acc = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        acc |= v;
+        if (acc) return 0;
+    }
+    for (; i < n; i++) acc |= p[i];
+    return acc == 0;
+}
+
+#ifdef HAVE_LIBCOMPRESSION
+static compression_algorithm algorithm_for(NhImageCodec codec) {
+    return codec == NH_IMAGE_LZFSE ? COMPRESSION_LZFSE : COMPRESSION_LZ4;
+}
+#endif
+
+static int write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        nh_io_note_write((size_t)n);
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void* buf, size_t len) {
+    uint8_t* p = (uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+int nh_image_write(int fd, const void* src, size_t len, NhImageCodec codec, size_t* written) {
+    const uint8_t* in = (const uint8_t*)src;
+    size_t blocks = (len + NH_IMAGE_BLOCK_SIZE - 1) / NH_IMAGE_BLOCK_SIZE;
+
+#ifndef HAVE_LIBCOMPRESSION
+    codec = NH_IMAGE_NONE;
+#endif
+
+    ImageHeader header = {0};
+    strcpy(header.magic, "NHIMGZ");
+    header.version = IMAGE_VERSION;
+    header.codec = codec;
+    header.raw_len = len;
+    header.block_size = NH_IMAGE_BLOCK_SIZE;
+    header.block_count = (uint32_t)blocks;
+    if (write_all(fd, &header, sizeof(header)) != 0) return -1;
+    size_t total = sizeof(header);
+
+    uint8_t* packed = NULL;
+#ifdef HAVE_LIBCOMPRESSION
+    void* scratch = NULL;
+    if (codec != NH_IMAGE_NONE) {
+        packed = malloc(NH_IMAGE_BLOCK_SIZE);
+        scratch = malloc(compression_encode_scratch_buffer_size(algorithm_for(codec)));
+        if (!packed || !scratch) {
+            free(packed);
+            free(scratch);
+            return -1;
+        }
+    }
+#endif
+
+    int result = 0;
+    for (size_t off = 0; off < len; off += NH_IMAGE_BLOCK_SIZE) {
+        size_t n = len - off < NH_IMAGE_BLOCK_SIZE ? len - off : NH_IMAGE_BLOCK_SIZE;
+        BlockHeader block = { .raw_len = (uint32_t)n };
+        const void* payload = in + off;
+
+        if (is_zero(in + off, n)) {
+            block.kind = BLOCK_ZERO;
+            block.crc = crc32c(in + off, n);
+        } else {
+            block.kind = BLOCK_STORED;
+            block.stored_len = (uint32_t)n;
+            block.crc = crc32c(in + off, n);
+#ifdef HAVE_LIBCOMPRESSION
+            if (packed) {
+                size_t size = compression_encode_buffer(packed, n - 1, in + off, n,
+                                                        scratch, algorithm_for(codec));
+                if (size > 0) {
+                    block.kind = BLOCK_PACKED;
+                    block.stored_len = (uint32_t)size;
+                    payload = packed;
+                }
+            }
+#endif
+        }
+
+        if (write_all(fd, &block, sizeof(block)) != 0 ||
+            (block.stored_len && write_all(fd, payload, block.stored_len) != 0)) {
+            result = -1;
+            break;
+        }
+        total += sizeof(block) + block.stored_len;
+    }
+
+    free(packed);
+#ifdef HAVE_LIBCOMPRESSION
+    free(scratch);
+#endif
+    if (result == 0 && written) *written = total;
+    return result;
+}
+
+int nh_image_read(int fd, void* dst, size_t len) {
+    uint8_t* out = (uint8_t*)dst;
+
+    ImageHeader header;
+    if (read_all(fd, &header, sizeof(header)) != 0 || strcmp(header.magic, "NHIMGZ") != 0 ||
+        header.version != IMAGE_VERSION || header.raw_len != len ||
+        header.block_size == 0 || header.block_size > IMAGE_MAX_BLOCK) {
+        fprintf(stderr, "[NH_IMAGE] Invalid container header\n");
+        return -1;
+    }
+
+    uint8_t* staging = NULL;
+#ifdef HAVE_LIBCOMPRESSION
+    void* scratch = NULL;
+    if (header.codec != NH_IMAGE_NONE) {
+        staging = malloc(header.block_size);
+        scratch = malloc(compression_decode_scratch_buffer_size(algorithm_for(header.codec)));
+        if (!staging || !scratch) {
+            free(staging);
+            free(scratch);
+            return -1;
+        }
+    }
+#endif
+
+    int result = 0;
+    size_t off = 0;
+    for (uint32_t i = 0; i < header.block_count; i++) {
+        BlockHeader block;
+        if (read_all(fd, &block, sizeof(block)) != 0 ||
+            block.raw_len > header.block_size || block.raw_len > len - off) {
+            fprintf(stderr, "[NH_IMAGE] Bad block header %u\n", i);
+            result = -1;
+            break;
+        }
+        uint8_t* target = out + off;
+
+        if (block.kind == BLOCK_ZERO && block.stored_len == 0) {
+            // Freshly committed pages are already zero: only write if needed
+            // so untouched pages stay non-resident
+            if (!is_zero(target, block.raw_len)) memset(target, 0, block.raw_len);
+        } else if (block.kind == BLOCK_STORED && block.stored_len == block.raw_len) {
+            if (read_all(fd, target, block.raw_len) != 0) {
+                result = -1;
+                break;
+            }
+        } else if (block.kind == BLOCK_PACKED && staging && block.stored_len <= header.block_size) {
+#ifdef HAVE_LIBCOMPRESSION
+            if (read_all(fd, staging, block.stored_len) != 0 ||
+                compression_decode_buffer(target, block.raw_len, staging, block.stored_len,
+                                          scratch, algorithm_for(header.codec)) != block.raw_len) {
+                fprintf(stderr, "[NH_IMAGE] Block %u failed to decode\n", i);
+                result = -1;
+                break;
+            }
+#endif
+        } else {
+            fprintf(stderr, "[NH_IMAGE] Unsupported block %u (kind %u)\n", i, block.kind);
+            result = -1;
+            break;
+        }
+
+        if (crc32c(target, block.raw_len) != block.crc) {
+            fprintf(stderr, "[NH_IMAGE] Checksum mismatch in block %u\n", i);
+            result = -1;
+            break;
+        }
+        off += block.raw_len;
+    }
+
+    if (result == 0 && off != len) {
+        fprintf(stderr, "[NH_IMAGE] Container ends at %zu of %zu bytes\n", off, len);
+        result = -1;
+    }
+
+    free(staging);
+#ifdef HAVE_LIBCOMPRESSION
+    free(scratch);
+#endif
+    return result;
+}
@@ -0,0 +1,49 @@
+/*
+ * nh_image_codec.h - Block-compressed container for heap images
+ *
+ * Heap images (nh_save_state, snapshot bases) are mostly zero padding and
+ * repeated structures. The container splits an image into 256KB blocks and
+ * stores each one as:
+ * - ZERO:   all-zero block, no payload
+ * - STORED: raw bytes (block did not shrink, or no codec available)
+ * - PACKED: compressed with the container's codec (libcompression LZ4 or
+ *           LZFSE on Apple platforms)
+ *
+ * Every block carries its raw length and a CRC32C of the raw bytes, so
+ * corruption is caught before the image is used. Encoding and decoding
+ * stream one block at a time: the reader decompresses straight into the
+ * destination (the heap) with only one block of staging.
+ */
+
+#ifndef NH_IMAGE_CODEC_H
+#define NH_IMAGE_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NH_IMAGE_BLOCK_SIZE (256 * 1024)
+
+typedef enum {
+    NH_IMAGE_NONE = 0,   // No container: callers write the legacy raw image
+    NH_IMAGE_LZ4,        // Fast, default for saves
+    NH_IMAGE_LZFSE       // Smaller, slower encode
+} NhImageCodec;
+
+// Codec used when the caller has no preference (NH_IMAGE_LZ4)
+NhImageCodec nh_image_default_codec(void);
+void nh_image_set_default_codec(NhImageCodec codec);
+
+// Write src[0, len) to fd as a container at the current offset. codec may
+// be NH_IMAGE_NONE (zero/stored blocks only). Returns 0 on success and
+// stores the container's size in *written if given.
+int nh_image_write(int fd, const void* src, size_t len, NhImageCodec codec, size_t* written);
+
+// Read a container from fd's current offset into dst, which must hold
+// exactly len bytes. Returns 0 on success, -1 on I/O error, bad checksum,
+// or a container of a different length.
+int nh_image_read(int fd, void* dst, size_t len);
+
+// Short codec name for logs ("none", "lz4", "lzfse")
+const char* nh_image_codec_name(NhImageCodec codec);
+
+#endif // NH_IMAGE_CODEC_H
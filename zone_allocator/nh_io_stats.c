@@ -0,0 +1,27 @@
+/*
+ * nh_io_stats.c - Write and fsync counters (see nh_io_stats.h)
+ */
+
+#include "nh_io_stats.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+static _Atomic uint64_t io_write_calls;
+static _Atomic uint64_t io_bytes_written;
+static _Atomic uint64_t io_fsync_calls;
+
+void nh_io_note_write(size_t n) {
+    atomic_fetch_add_explicit(&io_write_calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&io_bytes_written, n, memory_order_relaxed);
+}
+
+int nh_io_fsync(int fd) {
+    atomic_fetch_add_explicit(&io_fsync_calls, 1, memory_order_relaxed);
+    return fsync(fd);
+}
+
+void nh_io_stats_get(NhIoStats* out) {
+    out->write_calls = atomic_load_explicit(&io_write_calls, memory_order_relaxed);
+    out->bytes_written = atomic_load_explicit(&io_bytes_written, memory_order_relaxed);
+    out->fsync_calls = atomic_load_explicit(&io_fsync_calls, memory_order_relaxed);
+}
@@ -0,0 +1,32 @@
+/*
+ * nh_io_stats.h - Write and fsync counters for the save paths
+ *
+ * Every write_all() and fsync() on the save paths (heap images, level
+ * chunks, the save manifest, file copies) goes through these, so a
+ * benchmark can diff two snapshots around one operation. NetHack's own
+ * bwrite() into savegame is not counted; callers add the file size.
+ *
+ * Relaxed atomics: saves commit on a background queue.
+ */
+
+#ifndef NH_IO_STATS_H
+#define NH_IO_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t write_calls;          // write(2) calls that moved data
+    uint64_t bytes_written;
+    uint64_t fsync_calls;
+} NhIoStats;
+
+// Count one write(2) of n bytes
+void nh_io_note_write(size_t n);
+
+// fsync(2) that counts itself; same result and errno
+int nh_io_fsync(int fd);
+
+void nh_io_stats_get(NhIoStats* out);
+
+#endif /* NH_IO_STATS_H */